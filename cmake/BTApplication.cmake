@@ -31,6 +31,7 @@ pkg_search_module(Sword REQUIRED IMPORTED_TARGET sword>=1.8.1)
 MESSAGE(STATUS "Found Sword: ${Sword_VERSION}")
 pkg_search_module(CLucene REQUIRED IMPORTED_TARGET libclucene-core>=2.3.3.4)
 MESSAGE(STATUS "Found CLucene: ${CLucene_VERSION}")
+FIND_PACKAGE(ZLIB REQUIRED)
 
 ######################################################
 # Build options, definitions, linker flags etc for all targets:
@@ -48,78 +49,54 @@ IF("${CMAKE_BUILD_TYPE}" STREQUAL "Release")
     SET(CMAKE_AUTOMOC_MOC_OPTIONS "-DNDEBUG")
 ENDIF()
 
+FILE(GLOB_RECURSE bibletime_backend_SOURCES CONFIGURE_DEPENDS
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/backend/*.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/backend/*.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/util/*.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/util/*.h"
+)
 FILE(GLOB_RECURSE bibletime_SOURCES CONFIGURE_DEPENDS
-    "${CMAKE_CURRENT_SOURCE_DIR}/src/*.cpp"
-    "${CMAKE_CURRENT_SOURCE_DIR}/src/*.h"
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/frontend/*.cpp"
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/frontend/*.h"
 )
 FILE(GLOB_RECURSE bibletime_QML_FILES CONFIGURE_DEPENDS
     "${CMAKE_CURRENT_SOURCE_DIR}/src/*.qml"
 )
+
+# The backend and utilities, which the application and other tools link:
+ADD_LIBRARY("bibletime_backend" STATIC ${bibletime_backend_SOURCES})
 IF(MSVC)
     ADD_EXECUTABLE("bibletime" WIN32 ${bibletime_SOURCES} "cmake/BTWinIcon.rc")
 ELSE()
     ADD_EXECUTABLE("bibletime" ${bibletime_SOURCES})
 ENDIF()
-TARGET_COMPILE_FEATURES("bibletime" PRIVATE cxx_std_17)
-TARGET_COMPILE_DEFINITIONS("bibletime" PRIVATE
-    "BT_RUNTIME_DOCDIR=\"${BT_RUNTIME_DOCDIR}\""
-    "BT_VERSION=\"${PROJECT_VERSION}\""
-    "BT_HOMEPAGE=\"${PROJECT_HOMEPAGE}\""
-    "QT_NO_KEYWORDS"
-    "QT_DISABLE_DEPRECATED_UP_TO=0x060500"
-    "$<$<CXX_COMPILER_ID:MSVC>:SWUSINGDLL>"
-    "$<$<CXX_COMPILER_ID:MSVC>:_UNICODE>"
-    "$<$<CXX_COMPILER_ID:MSVC>:UNICODE>"
-    "$<$<CONFIG:Release>:NDEBUG>"
-    "$<$<CONFIG:Release>:QT_NO_DEBUG>"
-)
-IF(BUILD_TEXT_TO_SPEECH)
-    TARGET_COMPILE_DEFINITIONS("bibletime" PRIVATE "BUILD_TEXT_TO_SPEECH")
-ENDIF()
-TARGET_COMPILE_OPTIONS("bibletime" PRIVATE
-    "$<$<CXX_COMPILER_ID:MSVC>:/W1>"
-    "$<$<CXX_COMPILER_ID:MSVC>:/Zi>"
-    "$<$<CXX_COMPILER_ID:MSVC>:/Zc:wchar_t>"
-    "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Release>>:/MD>"
-    "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Debug>>:/MDd>"
-    "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Debug>>:/Od>"
-    "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-Wall>"
-    "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-Wextra>"
-    "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-fPIE>"
-    "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-fexceptions>"
-)
-TARGET_INCLUDE_DIRECTORIES("bibletime" PRIVATE
-    ${CMAKE_CURRENT_BINARY_DIR}
+SET(bibletime_TARGETS "bibletime_backend" "bibletime")
 
-    # work around QTBUG-87221/QTBUG-93443:
-    "${CMAKE_CURRENT_SOURCE_DIR}/src/frontend/display/modelview/"
-)
-TARGET_LINK_LIBRARIES("bibletime" PRIVATE
-    PkgConfig::CLucene
-    PkgConfig::Sword
-    Qt::Network
-    Qt::PrintSupport
-    Qt::Quick
-    Qt::QuickWidgets
-    Qt::Svg
-    Qt::Widgets
-    Qt::Xml
-)
-IF(BUILD_TEXT_TO_SPEECH)
-    TARGET_LINK_LIBRARIES("bibletime" PRIVATE Qt::TextToSpeech)
+# The benchmarks, which link the backend without the frontend:
+IF(BUILD_BENCHMARKS)
+    SET(bibletime_benchmark_environment_SOURCES
+        "${CMAKE_CURRENT_SOURCE_DIR}/src/benchmarks/btbenchmarkenvironment.cpp"
+        "${CMAKE_CURRENT_SOURCE_DIR}/src/benchmarks/btbenchmarkenvironment.h"
+    )
+    ADD_EXECUTABLE("bibletime_benchmark_search"
+        "${CMAKE_CURRENT_SOURCE_DIR}/src/benchmarks/btsearchbenchmark.cpp"
+        ${bibletime_benchmark_environment_SOURCES})
+    ADD_EXECUTABLE("bibletime_benchmark_rendering"
+        "${CMAKE_CURRENT_SOURCE_DIR}/src/benchmarks/btrenderingbenchmark.cpp"
+        ${bibletime_benchmark_environment_SOURCES})
+    LIST(APPEND bibletime_TARGETS
+        "bibletime_benchmark_search"
+        "bibletime_benchmark_rendering"
+    )
 ENDIF()
-SET_TARGET_PROPERTIES("bibletime" PROPERTIES CXX_EXTENSIONS NO)
 
 SET(CMAKE_REQUIRED_QUIET TRUE)
 INCLUDE(CheckIPOSupported)
 CHECK_IPO_SUPPORTED(RESULT HAVE_IPO)
 MESSAGE(STATUS "Using interprocedural optimization: ${HAVE_IPO}")
-IF(HAVE_IPO)
-    SET_TARGET_PROPERTIES("bibletime" PROPERTIES
-        INTERPROCEDURAL_OPTIMIZATION TRUE)
-ENDIF()
 
 INCLUDE(CheckCXXCompilerFlag)
+SET(BT_CXX_FLAGS)
 FOREACH(flag IN ITEMS
     "-Walloca"
     "-Wextra-semi"
@@ -145,13 +122,91 @@ FOREACH(flag IN ITEMS
     STRING(SHA512 flag_id "${flag}")
     CHECK_CXX_COMPILER_FLAG("${flag}" "cxx_compiler_has_flag_${flag_id}")
     IF("${cxx_compiler_has_flag_${flag_id}}")
-        TARGET_COMPILE_OPTIONS("bibletime" PRIVATE "${flag}")
+        LIST(APPEND BT_CXX_FLAGS "${flag}")
         MESSAGE(STATUS "Using C++ compiler flag: ${flag}")
     ELSE()
         MESSAGE(STATUS "Flag not supported by C++ compiler: ${flag}")
     ENDIF()
 ENDFOREACH()
 
+FOREACH(target IN LISTS bibletime_TARGETS)
+    TARGET_COMPILE_FEATURES("${target}" PRIVATE cxx_std_17)
+    TARGET_COMPILE_DEFINITIONS("${target}" PRIVATE
+        "BT_RUNTIME_DOCDIR=\"${BT_RUNTIME_DOCDIR}\""
+        "BT_VERSION=\"${PROJECT_VERSION}\""
+        "BT_HOMEPAGE=\"${PROJECT_HOMEPAGE}\""
+        "QT_NO_KEYWORDS"
+        "QT_DISABLE_DEPRECATED_UP_TO=0x060500"
+        "$<$<CXX_COMPILER_ID:MSVC>:SWUSINGDLL>"
+        "$<$<CXX_COMPILER_ID:MSVC>:_UNICODE>"
+        "$<$<CXX_COMPILER_ID:MSVC>:UNICODE>"
+        "$<$<CONFIG:Release>:NDEBUG>"
+        "$<$<CONFIG:Release>:QT_NO_DEBUG>"
+    )
+    IF(BUILD_TEXT_TO_SPEECH)
+        TARGET_COMPILE_DEFINITIONS("${target}" PRIVATE "BUILD_TEXT_TO_SPEECH")
+    ENDIF()
+    IF(BUILD_TRACING)
+        TARGET_COMPILE_DEFINITIONS("${target}" PRIVATE "BUILD_TRACING")
+    ENDIF()
+    TARGET_COMPILE_OPTIONS("${target}" PRIVATE
+        "$<$<CXX_COMPILER_ID:MSVC>:/W1>"
+        "$<$<CXX_COMPILER_ID:MSVC>:/Zi>"
+        "$<$<CXX_COMPILER_ID:MSVC>:/Zc:wchar_t>"
+        "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Release>>:/MD>"
+        "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Debug>>:/MDd>"
+        "$<$<AND:$<CXX_COMPILER_ID:MSVC>,$<CONFIG:Debug>>:/Od>"
+        "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-Wall>"
+        "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-Wextra>"
+        "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-fPIE>"
+        "$<$<NOT:$<CXX_COMPILER_ID:MSVC>>:-fexceptions>"
+        ${BT_CXX_FLAGS}
+    )
+    SET_TARGET_PROPERTIES("${target}" PROPERTIES CXX_EXTENSIONS NO)
+    IF(HAVE_IPO)
+        SET_TARGET_PROPERTIES("${target}" PROPERTIES
+            INTERPROCEDURAL_OPTIMIZATION TRUE)
+    ENDIF()
+ENDFOREACH()
+
+TARGET_LINK_LIBRARIES("bibletime_backend" PUBLIC
+    PkgConfig::CLucene
+    PkgConfig::Sword
+    Qt::Widgets
+    Qt::Xml
+    ZLIB::ZLIB
+)
+
+TARGET_INCLUDE_DIRECTORIES("bibletime" PRIVATE
+    ${CMAKE_CURRENT_BINARY_DIR}
+
+    # work around QTBUG-87221/QTBUG-93443:
+    "${CMAKE_CURRENT_SOURCE_DIR}/src/frontend/display/modelview/"
+)
+TARGET_LINK_LIBRARIES("bibletime" PRIVATE
+    "bibletime_backend"
+    Qt::Network
+    Qt::PrintSupport
+    Qt::Quick
+    Qt::QuickWidgets
+    Qt::Svg
+    Qt::Widgets
+    Qt::Xml
+)
+IF(BUILD_TEXT_TO_SPEECH)
+    TARGET_LINK_LIBRARIES("bibletime" PRIVATE Qt::TextToSpeech)
+ENDIF()
+
+IF(BUILD_BENCHMARKS)
+    TARGET_LINK_LIBRARIES("bibletime_benchmark_search" PRIVATE
+        "bibletime_backend"
+    )
+    TARGET_LINK_LIBRARIES("bibletime_benchmark_rendering" PRIVATE
+        "bibletime_backend"
+        Qt::Test
+    )
+ENDIF()
+
 FOREACH(file IN LISTS bibletime_QML_FILES)
     STRING(REGEX REPLACE "^.*/([^/]+)$" "\\1" filename "${file}")
     SET_SOURCE_FILES_PROPERTIES("${file}" PROPERTIES
@@ -173,7 +228,7 @@ FILE(GLOB BT_TS_FILES CONFIGURE_DEPENDS
     "${CMAKE_CURRENT_SOURCE_DIR}/i18n/messages/bibletime_ui_*.ts"
 )
 qt_add_translations("bibletime"
-  SOURCE_TARGETS "bibletime"
+  SOURCE_TARGETS "bibletime" "bibletime_backend"
   TS_FILES ${BT_TS_FILES}
   QM_FILES_OUTPUT_VARIABLE BT_QM_FILES
   LUPDATE_TARGET "lupdate"
@@ -186,6 +241,13 @@ INSTALL(FILES ${BT_QM_FILES} DESTINATION "${BT_LOCALEDIR}/")
 # Installation:
 #
 INSTALL(TARGETS "bibletime" DESTINATION "${BT_BINDIR}")
+IF(BUILD_BENCHMARKS)
+    # Like the application, the benchmarks find their data files relative to
+    # the installation prefix:
+    INSTALL(TARGETS "bibletime_benchmark_search"
+                    "bibletime_benchmark_rendering"
+            DESTINATION "${BT_BINDIR}")
+ENDIF()
 FILE(GLOB INSTALL_ICONS_LIST CONFIGURE_DEPENDS
         "${CMAKE_CURRENT_SOURCE_DIR}/pics/icons/*.svg")
 INSTALL(FILES ${INSTALL_ICONS_LIST}
@@ -14,7 +14,9 @@
 
 #include <QAbstractItemModel>
 #include <QVariant>
+#include <utility>
 #include "../../util/btassert.h"
+#include "../../util/btconnect.h"
 #include "btbookshelfmodel.h"
 
 
@@ -43,28 +45,42 @@ void BtBookshelfFilterModel::setNameFilterRole(int const role) {
     if (m_nameFilterRole == role)
         return;
     m_nameFilterRole = role;
-    invalidateFilter();
+    invalidateFilterKeys();
 }
 
 void BtBookshelfFilterModel::setNameFilterKeyColumn(int const column) {
     if (m_nameFilterColumn == column)
         return;
     m_nameFilterColumn = column;
-    invalidateFilter();
+    invalidateFilterKeys();
 }
 
 void BtBookshelfFilterModel::setNameFilterFixedString(QString const & filter) {
     if (m_nameFilter == filter)
         return;
+    auto foldedFilter(filter.toCaseFolded());
+    // A filter containing the previous one, e.g. while typing, only narrows:
+    bool const narrowed =
+            (m_nameFilterCase == Qt::CaseSensitive)
+            ? filter.contains(m_nameFilter)
+            : foldedFilter.contains(m_foldedNameFilter);
     m_nameFilter = filter;
-    invalidateFilter();
+    m_foldedNameFilter = std::move(foldedFilter);
+    nameFilterChanged(narrowed);
 }
 
 void BtBookshelfFilterModel::setNameFilterCase(Qt::CaseSensitivity const value){
     if (m_nameFilterCase == value)
         return;
     m_nameFilterCase = value;
-    invalidateFilter();
+    nameFilterChanged(value == Qt::CaseSensitive);
+}
+
+void BtBookshelfFilterModel::nameFilterChanged(bool const narrowed) {
+    ++m_nameFilterGeneration;
+    if (!narrowed)
+        m_nameFilterNarrowedSince = m_nameFilterGeneration;
+    invalidateRowsFilter();
 }
 
 // Hidden filter:
@@ -73,14 +89,14 @@ void BtBookshelfFilterModel::setHiddenFilterRole(int const role) {
     if (m_hiddenFilterRole == role)
         return;
     m_hiddenFilterRole = role;
-    invalidateFilter();
+    invalidateFilterKeys();
 }
 
 void BtBookshelfFilterModel::setHiddenFilterKeyColumn(int const column) {
     if (m_hiddenFilterColumn == column)
         return;
     m_hiddenFilterColumn = column;
-    invalidateFilter();
+    invalidateFilterKeys();
 }
 
 void BtBookshelfFilterModel::setShowHidden(bool const show) {
@@ -99,63 +115,114 @@ void BtBookshelfFilterModel::setShowShown(bool const show) {
 
 // Filtering:
 
-bool BtBookshelfFilterModel::filterAcceptsRow(int row,
-                                              QModelIndex const & parent) const
+void BtBookshelfFilterModel::setSourceModel(
+        QAbstractItemModel * const sourceModel)
 {
-    if (!m_enabled)
-        return true;
+    for (auto & connection : m_sourceConnections)
+        disconnect(connection);
+    m_filterKeys.clear();
+
+    /* Connect before the base class does, so the cached filter data is
+       updated before the rows are filtered again: */
+    if (sourceModel) {
+        using M = QAbstractItemModel;
+        m_sourceConnections = {
+            BT_CONNECT(sourceModel, &M::dataChanged,
+                       this, &BtBookshelfFilterModel::sourceDataChanged),
+            BT_CONNECT(sourceModel, &M::rowsRemoved,
+                       this, &BtBookshelfFilterModel::sourceRowsRemoved),
+            BT_CONNECT(sourceModel, &M::modelAboutToBeReset,
+                       this, [this]{ m_filterKeys.clear(); }),
+            BT_CONNECT(sourceModel, &M::layoutAboutToBeChanged,
+                       this, [this]{ m_filterKeys.clear(); }),
+            BT_CONNECT(sourceModel, &M::columnsRemoved,
+                       this, [this]{ m_filterKeys.clear(); })};
+    }
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
 
-    if (!hiddenFilterAcceptsRow(row, parent))
-        return false;
-    if (!nameFilterAcceptsRow(row, parent))
-        return false;
-    return true;
+void BtBookshelfFilterModel::invalidateFilterKeys() {
+    m_filterKeys.clear();
+    invalidateFilter();
 }
 
-bool BtBookshelfFilterModel::nameFilterAcceptsRow(
-        int const row,
-        QModelIndex const & parent) const
+void BtBookshelfFilterModel::sourceDataChanged(
+        QModelIndex const & topLeft,
+        QModelIndex const & bottomRight)
 {
-    if (m_nameFilter.isEmpty())
-        return true;
+    if (m_filterKeys.isEmpty() || !topLeft.isValid())
+        return;
+    auto const * const m = sourceModel();
+    auto const parent(topLeft.parent());
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+        m_filterKeys.remove(m->index(row, m_nameFilterColumn, parent));
+}
+
+void BtBookshelfFilterModel::sourceRowsRemoved() {
+    m_filterKeys.removeIf([](auto const & it) { return !it.key().isValid(); });
+}
 
+BtBookshelfFilterModel::FilterKey &
+BtBookshelfFilterModel::filterKey(int const row,
+                                  QModelIndex const & parent) const
+{
     auto const * const m = sourceModel();
     BT_ASSERT(m);
 
-    auto const itemIndex = m->index(row, m_nameFilterColumn, parent);
-    auto const numChildren = m->rowCount(itemIndex);
-    if (numChildren == 0) {
-        auto const data = m->data(itemIndex, m_nameFilterRole);
-        return data.toString().contains(m_nameFilter, m_nameFilterCase);
+    QPersistentModelIndex const itemIndex(
+                m->index(row, m_nameFilterColumn, parent));
+    auto it = m_filterKeys.find(itemIndex);
+    if (it == m_filterKeys.end()) {
+        auto const hiddenIndex = m->index(row, m_hiddenFilterColumn, parent);
+        auto name(m->data(itemIndex, m_nameFilterRole).toString());
+        auto foldedName(name.toCaseFolded());
+        it = m_filterKeys.insert(
+                 itemIndex,
+                 FilterKey{std::move(name),
+                           std::move(foldedName),
+                           m->data(hiddenIndex,
+                                   m_hiddenFilterRole).toBool()});
     }
+    return *it;
+}
 
-    for (int i = 0; i < numChildren; ++i)
-        if (filterAcceptsRow(i, itemIndex))
-            return true;
-    return false;
+bool BtBookshelfFilterModel::nameFilterAccepts(FilterKey & key) const {
+    if (m_nameFilter.isEmpty())
+        return true;
+
+    /* Rows rejected since the filter only narrowed stay rejected, so only the
+       rows accepted before are compared again while typing: */
+    if (key.nameRejectedGeneration >= m_nameFilterNarrowedSince)
+        return false;
+    bool const accepted =
+            (m_nameFilterCase == Qt::CaseSensitive)
+            ? key.name.contains(m_nameFilter)
+            : key.foldedName.contains(m_foldedNameFilter);
+    if (!accepted)
+        key.nameRejectedGeneration = m_nameFilterGeneration;
+    return accepted;
 }
 
-bool BtBookshelfFilterModel::hiddenFilterAcceptsRow(
-        int const row,
-        QModelIndex const & parent) const
+bool BtBookshelfFilterModel::filterAcceptsRow(int row,
+                                              QModelIndex const & parent) const
 {
-    if (m_showHidden && m_showShown)
+    if (!m_enabled || (m_showHidden && m_showShown && m_nameFilter.isEmpty()))
         return true;
 
     auto const * const m = sourceModel();
     BT_ASSERT(m);
 
-    auto const itemIndex = m->index(row, m_hiddenFilterColumn, parent);
-    auto const numChildren = m->rowCount(itemIndex);
-    if (numChildren == 0) {
-        if (static_cast<Qt::CheckState>(m->data(itemIndex,
-                                                m_hiddenFilterRole).toBool()))
-            return m_showHidden;
-        return m_showShown;
+    // Groups are accepted if any of their children is accepted:
+    auto const itemIndex = m->index(row, m_nameFilterColumn, parent);
+    if (auto const numChildren = m->rowCount(itemIndex)) {
+        for (int i = 0; i < numChildren; ++i)
+            if (filterAcceptsRow(i, itemIndex))
+                return true;
+        return false;
     }
 
-    for (int i = 0; i < numChildren; ++i)
-        if (filterAcceptsRow(i, itemIndex))
-            return true;
-    return false;
+    auto & key = filterKey(row, parent);
+    if (!(key.hidden ? m_showHidden : m_showShown))
+        return false;
+    return nameFilterAccepts(key);
 }
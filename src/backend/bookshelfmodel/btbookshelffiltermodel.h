@@ -14,11 +14,17 @@
 
 #include <QSortFilterProxyModel>
 
+#include <array>
+#include <cstdint>
+#include <QHash>
+#include <QMetaObject>
 #include <QObject>
+#include <QPersistentModelIndex>
 #include <QString>
 #include <Qt>
 
 
+class QAbstractItemModel;
 class QModelIndex;
 
 class BtBookshelfFilterModel: public QSortFilterProxyModel {
@@ -33,6 +39,8 @@ public: // methods:
 
     bool filterAcceptsRow(int row, QModelIndex const & parent) const override;
 
+    void setSourceModel(QAbstractItemModel * sourceModel) override;
+
     int nameFilterRole() const noexcept { return m_nameFilterRole; }
     int nameFilterKeyColumn() const noexcept { return m_nameFilterColumn; }
     QString const & nameFilter() const noexcept { return m_nameFilter; }
@@ -60,17 +68,54 @@ public Q_SLOTS:
     void setShowHidden(bool show);
     void setShowShown(bool show);
 
+private: // types:
+
+    /** The data of a source row without children which the filters use. */
+    struct FilterKey {
+        QString name;
+        QString foldedName; ///< For case insensitive filtering
+        bool hidden;
+
+        /** The generation of the name filter which last rejected the row. */
+        std::uint64_t nameRejectedGeneration = 0u;
+    };
+
 private: // methods:
 
-    bool nameFilterAcceptsRow(int row, QModelIndex const & parent) const;
-    bool hiddenFilterAcceptsRow(int row, QModelIndex const & parent) const;
+    /** \returns the cached filter data of the given source item. */
+    FilterKey & filterKey(int row, QModelIndex const & parent) const;
+
+    /** \returns whether the name filter accepts the given row. */
+    bool nameFilterAccepts(FilterKey & key) const;
+
+    /**
+      \brief Refilters the rows after the name filter changed.
+      \param[in] narrowed Whether every name the filter accepts now was
+                          accepted by the filter before.
+    */
+    void nameFilterChanged(bool narrowed);
+
+    /** \brief Drops the cached filter data and refilters all rows. */
+    void invalidateFilterKeys();
+
+    void sourceDataChanged(QModelIndex const & topLeft,
+                           QModelIndex const & bottomRight);
+    void sourceRowsRemoved();
 
 private: // fields:
 
+    /** Keyed by the source index of the name filter column of the row. */
+    mutable QHash<QPersistentModelIndex, FilterKey> m_filterKeys;
+    std::array<QMetaObject::Connection, 5u> m_sourceConnections;
+
     bool m_enabled;
 
     // Name filter:
     QString m_nameFilter;
+    QString m_foldedNameFilter;
+    std::uint64_t m_nameFilterGeneration = 1u;
+    /** The first generation since which the name filter only narrowed. */
+    std::uint64_t m_nameFilterNarrowedSince = 1u;
     int m_nameFilterRole;
     int m_nameFilterColumn;
     Qt::CaseSensitivity  m_nameFilterCase;
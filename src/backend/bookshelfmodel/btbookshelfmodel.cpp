@@ -12,8 +12,10 @@
 
 #include "btbookshelfmodel.h"
 
+#include <chrono>
 #include <QIcon>
 #include <QSet>
+#include <QString>
 #include <QtAlgorithms>
 #include <QtCompilerDetection>
 #include <QtGlobal>
@@ -63,10 +65,28 @@ QVariant BtBookshelfModel::data(CSwordModuleInfo * module, int const role) const
             return module->indexSize();
         case ModuleDescriptionRole:
             return module->config(CSwordModuleInfo::Description);
-        case Qt::ToolTipRole:
-            return QStringLiteral("<b>%1:</b><br/>%2")
-                       .arg(module->name())
-                       .arg(module->config(CSwordModuleInfo::Description));
+        case Qt::ToolTipRole: {
+            auto r = QStringLiteral("<b>%1:</b><br/>%2")
+                         .arg(module->name())
+                         .arg(module->config(CSwordModuleInfo::Description));
+            if (auto const times = module->renderTimes().summary();
+                times.samples > 0u)
+            {
+                auto const toMs =
+                        [](std::chrono::microseconds const us)
+                        {
+                            return QString::number(
+                                    static_cast<double>(us.count()) / 1000.0,
+                                    'f',
+                                    1);
+                        };
+                r += QStringLiteral("<br/>")
+                     + tr("Rendering: %1 ms per entry on average, %2 ms at "
+                          "the 95th percentile")
+                           .arg(toMs(times.mean), toMs(times.p95));
+            }
+            return r;
+        }
         default:
             return QVariant();
     }
@@ -130,21 +150,39 @@ void BtBookshelfModel::clear(bool const destroy) {
     endRemoveRows();
 }
 
-void BtBookshelfModel::addModule(CSwordModuleInfo * const module) {
-    BT_ASSERT(module);
+void BtBookshelfModel::addModule(CSwordModuleInfo * const module)
+{ addModules({module}); }
 
-    if (m_data.contains(module))
+void BtBookshelfModel::addModules(QList<CSwordModuleInfo *> const & modules) {
+    QList<CSwordModuleInfo *> newModules;
+    newModules.reserve(modules.size());
+    {
+        QSet<CSwordModuleInfo *> seenModules(m_data.begin(), m_data.end());
+        for (auto * const module : modules) {
+            BT_ASSERT(module);
+            if (!seenModules.contains(module)) {
+                seenModules.insert(module);
+                newModules.append(module);
+            }
+        }
+    }
+    if (newModules.isEmpty())
         return;
 
+    // Emit the signals once for all modules, e.g. when loading the backend:
     const int index(m_data.size());
-    beginInsertRows(QModelIndex(), index, index);
-    m_data.append(module);
-    BT_CONNECT(module, &CSwordModuleInfo::hiddenChanged,
-               this,   &BtBookshelfModel::moduleHidden);
-    BT_CONNECT(module, &CSwordModuleInfo::hasIndexChanged,
-               this,   &BtBookshelfModel::moduleIndexed);
-    BT_CONNECT(module, &CSwordModuleInfo::unlockedChanged,
-               this,   &BtBookshelfModel::moduleUnlocked);
+    beginInsertRows(QModelIndex(), index, index + newModules.size() - 1);
+    m_data.append(newModules);
+    for (auto * const module : newModules) {
+        BT_CONNECT(module, &CSwordModuleInfo::hiddenChanged,
+                   this,   &BtBookshelfModel::moduleHidden);
+        BT_CONNECT(module, &CSwordModuleInfo::hasIndexChanged,
+                   this,   &BtBookshelfModel::moduleIndexed);
+        BT_CONNECT(module, &CSwordModuleInfo::indexingProgress,
+                   this,   &BtBookshelfModel::moduleIndexingProgress);
+        BT_CONNECT(module, &CSwordModuleInfo::unlockedChanged,
+                   this,   &BtBookshelfModel::moduleUnlocked);
+    }
     endInsertRows();
 }
 
@@ -159,6 +197,8 @@ void BtBookshelfModel::removeModule(CSwordModuleInfo * const module,
                this,   &BtBookshelfModel::moduleHidden);
     disconnect(module, &CSwordModuleInfo::hasIndexChanged,
                this,   &BtBookshelfModel::moduleIndexed);
+    disconnect(module, &CSwordModuleInfo::indexingProgress,
+               this,   &BtBookshelfModel::moduleIndexingProgress);
     disconnect(module, &CSwordModuleInfo::unlockedChanged,
                this,   &BtBookshelfModel::moduleUnlocked);
     m_data.removeAt(index);
@@ -203,6 +243,12 @@ void BtBookshelfModel::moduleIndexed(bool) {
     moduleDataChanged(static_cast<CSwordModuleInfo *>(sender()));
 }
 
+void BtBookshelfModel::moduleIndexingProgress(int) {
+    BT_ASSERT(qobject_cast<CSwordModuleInfo *>(sender()));
+
+    moduleDataChanged(static_cast<CSwordModuleInfo *>(sender()));
+}
+
 void BtBookshelfModel::moduleUnlocked(bool) {
     BT_ASSERT(qobject_cast<CSwordModuleInfo *>(sender()));
 
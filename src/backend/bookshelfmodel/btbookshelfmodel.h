@@ -106,6 +106,12 @@ public: // methods:
     */
     void addModule(CSwordModuleInfo * const module);
 
+    /**
+      Appends the given modules to this model at once.
+      \param[in] modules Modules to add.
+    */
+    void addModules(QList<CSwordModuleInfo *> const & modules);
+
     /**
       Removes the given module from this model and optionally destroys it.
       \param[in] module The module to remove from this model.
@@ -159,6 +165,13 @@ protected Q_SLOTS:
     */
     void moduleIndexed(bool indexed);
 
+    /**
+      Slot called by CSwordModuleInfo when the respective module is being
+      indexed in the background, to update the displayed indexing status.
+      \param[in] percentage The indexing progress in percent.
+    */
+    void moduleIndexingProgress(int percentage);
+
     /**
       Slot DIRECTLY called by CSwordModuleInfo when the locked status of the respective
       module changes.
@@ -566,10 +566,8 @@ void BtBookshelfTreeModel::moduleDataChanged(QModelIndex const & topLeft,
           Also emit signals for parent items because the change might alter them
           as well, e.g. isHidden()
         */
-        do {
-            itemIndex = itemIndex.parent();
+        while ((itemIndex = itemIndex.parent()).isValid())
             Q_EMIT dataChanged(itemIndex, itemIndex);
-        } while (itemIndex.isValid());
     }
 }
 
@@ -14,6 +14,8 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
+#include "../btindexingscheduler.h"
 
 
 namespace BookshelfModel {
@@ -22,9 +24,18 @@ QVariant IndexingItem::data(int const role) const {
     if (role != Qt::DisplayRole)
         return Item::data(role);
 
-    return m_indexed
-           ? QObject::tr("Indexed works")
-           : QObject::tr("Unindexed works");
+    if (m_indexed)
+        return QObject::tr("Indexed works");
+
+    // Show the live status of the background indexing:
+    auto const activeJobs(BtIndexingScheduler::instance().activeJobs());
+    if (activeJobs.empty())
+        return QObject::tr("Unindexed works");
+    QStringList status;
+    for (auto const & [name, progress] : activeJobs)
+        status.append(QStringLiteral("%1 %2%").arg(name).arg(progress));
+    return QObject::tr("Unindexed works (indexing %1)")
+            .arg(status.join(QStringLiteral(", ")));
 }
 
 } // namespace BookshelfModel
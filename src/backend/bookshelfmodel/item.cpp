@@ -12,6 +12,7 @@
 
 #include "item.h"
 
+#include <algorithm>
 #include <QtAlgorithms>
 #include <QString>
 #include "../../util/btassert.h"
@@ -25,20 +26,22 @@ Item::~Item() {
 }
 
 int Item::indexFor(Item const & newItem) {
-    if (m_children.empty())
-        return 0;
-
-    int i = 0;
-    for (;;) {
-        auto const & nextItem = *m_children.at(i);
-        BT_ASSERT(nextItem.type() == newItem.type());
-        if (newItem < nextItem)
-            return i;
-
-        i++;
-        if (i >= m_children.size())
-            return i;
-    }
+    // The children are kept sorted, so insert after all items not greater:
+    auto const it =
+            std::upper_bound(m_children.cbegin(),
+                             m_children.cend(),
+                             &newItem,
+                             [](Item const * const a, Item const * const b) {
+                                 BT_ASSERT(a->type() == b->type());
+                                 return *a < *b;
+                             });
+    return static_cast<int>(it - m_children.cbegin());
+}
+
+QString const & Item::sortKey() const {
+    if (m_sortKey.isNull())
+        m_sortKey = data(Qt::DisplayRole).toString().toLower();
+    return m_sortKey;
 }
 
 QVariant Item::data(int const role) const {
@@ -66,9 +69,7 @@ bool Item::operator<(Item const & other) const {
     if (m_type != other.type())
         return m_type < other.type();
 
-    auto const first(data(Qt::DisplayRole).toString().toLower());
-    auto const second(other.data(Qt::DisplayRole).toString().toLower());
-    return first.localeAwareCompare(second) < 0;
+    return sortKey().localeAwareCompare(other.sortKey()) < 0;
 }
 
 bool RootItem::fitFor(CSwordModuleInfo const &) const { return true; }
@@ -14,6 +14,7 @@
 
 #include <Qt>
 #include <QList>
+#include <QString>
 #include <QVariant>
 #include "../../util/btassert.h"
 
@@ -131,6 +132,14 @@ public: // methods:
     */
     virtual bool operator<(Item const & other) const;
 
+protected: // methods:
+
+    /**
+      \brief Returns the lower-case display text of this item, which is cached
+             since the items are compared on every insertion.
+    */
+    QString const & sortKey() const;
+
 private: // methods:
 
     void setParent(Item * const parent) noexcept
@@ -142,6 +151,7 @@ private: // fields:
     Item * m_parent;
     QList<Item *> m_children;
     Qt::CheckState m_checkState;
+    mutable QString m_sortKey;
 
 };
 
@@ -0,0 +1,223 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btbatchjobs.h"
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QVariant>
+#include <utility>
+#include <vector>
+#include "cswordmodulesearch.h"
+#include "drivers/btmodulelist.h"
+#include "drivers/cswordmoduleinfo.h"
+#include "managers/cswordbackend.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <listkey.h>
+#include <swkey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+namespace {
+
+/**
+  \brief Writes a record with the given fields in the given format.
+  \note Tabs and line breaks in the values are replaced by spaces in TSV.
+*/
+void writeRecord(std::ostream & out,
+                 BtBatchOutputFormat const format,
+                 std::vector<std::pair<QString, QJsonValue>> const & fields)
+{
+    if (format == BtBatchOutputFormat::Json) {
+        QJsonObject record;
+        for (auto const & field : fields)
+            record.insert(field.first, field.second);
+        out << QJsonDocument(record).toJson(QJsonDocument::Compact)
+                   .constData() << '\n';
+    } else {
+        bool first = true;
+        for (auto const & field : fields) {
+            if (!first)
+                out << '\t';
+            first = false;
+            auto value(field.second.toVariant().toString());
+            value.replace('\t', ' ').replace('\n', ' ').replace('\r', ' ');
+            out << value.toUtf8().constData();
+        }
+        out << '\n';
+    }
+    out.flush();
+}
+
+} // anonymous namespace
+
+bool batchBuildIndices(QStringList const & moduleNames,
+                       int const threads,
+                       BtBatchOutputFormat const format,
+                       std::ostream & out)
+{
+    auto & backend = CSwordBackend::instance();
+    bool r = true;
+    for (auto const & moduleName : moduleNames) {
+        auto * const module = backend.findModuleByName(moduleName);
+        QString error;
+        QElapsedTimer timer;
+        timer.start();
+        if (!module) {
+            error = QStringLiteral("Module not found");
+        } else {
+            try {
+                if (threads > 0) {
+                    module->buildIndex(threads);
+                } else {
+                    module->buildIndex();
+                }
+            } catch (std::exception const & e) {
+                error = QString::fromUtf8(e.what());
+            } catch (...) {
+                error = QStringLiteral("Unknown exception");
+            }
+        }
+        auto const ms = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+        if (error.isEmpty()) {
+            writeRecord(out,
+                        format,
+                        {{QStringLiteral("module"), moduleName},
+                         {QStringLiteral("indexed"), true},
+                         {QStringLiteral("buildIndexMs"), ms},
+                         {QStringLiteral("indexSize"), module->indexSize()}});
+        } else {
+            writeRecord(out,
+                        format,
+                        {{QStringLiteral("module"), moduleName},
+                         {QStringLiteral("indexed"), false},
+                         {QStringLiteral("error"), error}});
+            r = false;
+        }
+    }
+    return r;
+}
+
+bool batchSearch(QStringList const & moduleNames,
+                 QStringList const & queries,
+                 BtBatchOutputFormat const format,
+                 std::ostream & out)
+{
+    auto & backend = CSwordBackend::instance();
+    bool r = true;
+    BtConstModuleList modules;
+    for (auto const & moduleName : moduleNames) {
+        if (auto * const module = backend.findModuleByName(moduleName)) {
+            /* Build missing indices here, since the scheduler would block this
+               thread, which usually is the GUI thread, to wait for them: */
+            QString error;
+            if (!module->hasIndex()) {
+                try {
+                    module->buildIndex();
+                } catch (std::exception const & e) {
+                    error = QString::fromUtf8(e.what());
+                } catch (...) {
+                    error = QStringLiteral("Unknown exception");
+                }
+            }
+            if (error.isEmpty()) {
+                modules.append(module);
+            } else {
+                writeRecord(out,
+                            format,
+                            {{QStringLiteral("module"), moduleName},
+                             {QStringLiteral("error"), error}});
+                r = false;
+            }
+        } else {
+            writeRecord(out,
+                        format,
+                        {{QStringLiteral("module"), moduleName},
+                         {QStringLiteral("error"),
+                          QStringLiteral("Module not found")}});
+            r = false;
+        }
+    }
+    if (modules.isEmpty())
+        return r;
+
+    // The results of the modules are handed over by several threads at once:
+    std::mutex outMutex;
+    for (auto const & query : queries) {
+        try {
+            CSwordModuleSearch::search(
+                        query,
+                        modules,
+                        sword::ListKey(),
+                        [&](std::size_t const moduleIndex,
+                            CSwordModuleSearch::ModuleResultList results)
+                        {
+                            auto const & moduleName =
+                                    modules.at(static_cast<qsizetype>(
+                                                   moduleIndex))->name();
+                            std::lock_guard<std::mutex> const guard(outMutex);
+                            for (std::size_t i = 0u;; ++i) {
+                                if (i == results.size()) {
+                                    if (!results.hasMore())
+                                        break;
+                                    results.fetchMore();
+                                }
+                                auto const key(results.keyAt(i));
+                                writeRecord(
+                                        out,
+                                        format,
+                                        {{QStringLiteral("query"), query},
+                                         {QStringLiteral("module"),
+                                          moduleName},
+                                         {QStringLiteral("key"),
+                                          QString::fromUtf8(
+                                              key->getText())}});
+                            }
+                        },
+                        {});
+        } catch (std::exception const & e) {
+            writeRecord(out,
+                        format,
+                        {{QStringLiteral("query"), query},
+                         {QStringLiteral("error"),
+                          QString::fromUtf8(e.what())}});
+            r = false;
+        } catch (...) {
+            writeRecord(out,
+                        format,
+                        {{QStringLiteral("query"), query},
+                         {QStringLiteral("error"),
+                          QStringLiteral("Search failed")}});
+            r = false;
+        }
+    }
+    return r;
+}
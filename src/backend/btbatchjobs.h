@@ -0,0 +1,63 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <iosfwd>
+#include <QStringList>
+
+
+/** \brief The formats of the output of the batch jobs. */
+enum class BtBatchOutputFormat {
+    Json, ///< One JSON object per line
+    Tsv ///< Tab-separated values, one record per line
+};
+
+/**
+  \brief Rebuilds the indices of the given modules without user interface.
+
+  The modules are indexed one after another, each by the given number of
+  threads. A record with the module, whether indexing succeeded, the build time
+  and the size of the index is written to the given stream as soon as its
+  module has been indexed. The modules are loaded by the regular CSwordBackend,
+  so the indices of other module directories can be built by setting
+  SWORD_PATH.
+  \param[in] moduleNames The names of the modules to index.
+  \param[in] threads The number of threads indexing each module, or zero for
+                     the configured number.
+  \param[in] format The format of the records.
+  \param[in] out The stream to write the records to.
+  \returns whether all modules were found and indexed.
+*/
+bool batchBuildIndices(QStringList const & moduleNames,
+                       int threads,
+                       BtBatchOutputFormat format,
+                       std::ostream & out);
+
+/**
+  \brief Searches the given queries in the given modules without user
+         interface.
+
+  Modules without an index are indexed first. For every hit a record with the
+  query, the module and the key of the hit is written to the given stream, as
+  soon as the results of the module are available.
+  \param[in] moduleNames The names of the modules to search in.
+  \param[in] queries The queries to search, in the syntax of the search dialog.
+  \param[in] format The format of the records.
+  \param[in] out The stream to write the records to.
+  \returns whether all modules were found and indexed and all queries were
+           searched.
+*/
+bool batchSearch(QStringList const & moduleNames,
+                 QStringList const & queries,
+                 BtBatchOutputFormat format,
+                 std::ostream & out);
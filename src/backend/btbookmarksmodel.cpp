@@ -23,38 +23,72 @@
 #include "btbookmarksmodel.h"
 
 #include <algorithm>
-#include <memory>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <QByteArray>
+#include <QDataStream>
+#include <QDebug>
 #include <QDir>
 #include <QDomElement>
 #include <QDomNode>
 #include <QFile>
+#include <QFileInfo>
+#include <QHash>
 #include <QIODevice>
 #include <QList>
+#include <QSaveFile>
 #include <QString>
 #include <QTextStream>
 #include <QTime>
 #include <QTimer>
+#include <string>
 #include <utility>
+#include <vector>
 #include "../util/btassert.h"
 #include "../util/btconnect.h"
 #include "../util/cresmgr.h"
 #include "../util/directory.h"
 #include "../util/tool.h"
 #include "btglobal.h"
-#include "config/btconfig.h"
 #include "drivers/cswordmoduleinfo.h"
 #include "keys/cswordversekey.h"
 #include "managers/cswordbackend.h"
 
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <listkey.h>
+#include <versekey.h>
+#pragma GCC diagnostic pop
+
 
 #define CURRENT_SYNTAX_VERSION 1
 
+//Increment this, if the format of the binary bookmarks file changes
+constexpr static quint32 const BT_BOOKMARKS_BINARY_VERSION = 1u;
+
 
 namespace {
 
 inline QString toHeader(QString const & key, QString const & moduleName)
 { return QStringLiteral("%1 (%2)").arg(key).arg(moduleName); }
 
+/** \returns a counter incremented whenever the modules are reloaded. */
+std::uint64_t swordSetupGeneration() {
+    struct Generation {
+        Generation() {
+            QObject::connect(&CSwordBackend::instance(),
+                             &CSwordBackend::sigSwordSetupChanged,
+                             [this]{ ++value; });
+        }
+        std::uint64_t value = 0u;
+    };
+    static Generation generation;
+    return generation.value;
+}
+
 class BookmarkFolder;
 
 class BookmarkItemBase {
@@ -124,7 +158,10 @@ public:
     /** Returns the used key. */
     QString key() const;
 
-    void setKey(QString const & key) { m_key = key; }
+    void setKey(QString const & key) {
+        m_key = key;
+        m_cache.reset();
+    }
 
     /** Returns the used description. */
     QString const & description() const { return m_description; }
@@ -138,15 +175,37 @@ public:
     /** Returns the english key.*/
     QString const & englishKey() const { return m_key; }
 
-    void setModule(QString const & moduleName)
-    { m_moduleName = moduleName; }
+    void setModule(QString const & moduleName) {
+        m_moduleName = moduleName;
+        m_cache.reset();
+    }
 
     QString const & moduleName() const { return m_moduleName; }
 
-private:
+private: // types:
+
+    /**
+      The module and the localized key, which are resolved when needed, e.g.
+      when painting, and kept until the modules are reloaded or the language of
+      the book names changes.
+    */
+    struct Cache {
+        std::uint64_t swordSetupGeneration;
+        QString booknameLanguage;
+        CSwordModuleInfo * module;
+        QString key;
+    };
+
+private: // methods:
+
+    Cache const & cache() const;
+
+private: // fields:
+
     QString m_key;
     QString m_description;
     QString m_moduleName;
+    mutable std::optional<Cache> m_cache;
 
 };
 
@@ -184,8 +243,12 @@ public:
     }
 
     void insertChildren(int index, QList<BookmarkItemBase *> children) {
-        for (auto * const c : children)
-            insertChild(index++, c);
+        // Make room for all children at once instead of one by one:
+        m_children.insert(index, children.size(), nullptr);
+        for (auto * const c : children) {
+            c->setParent(this);
+            m_children[index++] = c;
+        }
     }
 
     void removeChild(int index) {
@@ -239,6 +302,16 @@ public: // methods:
                 + QStringLiteral("/bookmarks.xml");
     }
 
+    /**
+      \returns the name of the binary copy of the default bookmarks file,
+                which is written on the periodic saves and loaded at startup
+                unless the XML file is newer.
+    */
+    static QString defaultBinaryBookmarksFile() {
+        return util::directory::getUserBaseDir().absolutePath()
+                + QStringLiteral("/bookmarks.dat");
+    }
+
     BookmarkItemBase * item(const QModelIndex & index) const {
         if (index.isValid())
             return static_cast<BookmarkItemBase *>(index.internalPointer());
@@ -249,6 +322,18 @@ public: // methods:
     T * itemAs(QModelIndex const & index) const
     { return dynamic_cast<T *>(item(index)); }
 
+    /**
+      \brief Drops the cached scopes of the given item and of the folders
+             containing it.
+    */
+    void invalidateFolderScopes(QModelIndex const & index) {
+        for (BookmarkItemBase const * i = item(index); i; i = i->parent()) {
+            auto it = m_folderScopes.lower_bound(std::pair(i, std::string()));
+            while (it != m_folderScopes.end() && it->first.first == i)
+                it = m_folderScopes.erase(it);
+        }
+    }
+
     void needSave(){
         if(m_defaultModel == q_ptr){
             if(!m_saveTimer.isActive())
@@ -259,6 +344,10 @@ public: // methods:
     /** Loads a list of items (with subitem trees) from a named file
     * or from the default bookmarks file. */
     QList<BookmarkItemBase *> loadTree(QString fileName = QString()) {
+        if (fileName.isEmpty())
+            if (auto items = loadBinaryTree())
+                return std::move(*items);
+
         QList<BookmarkItemBase*> itemList;
 
         QDomDocument doc;
@@ -329,6 +418,113 @@ public: // methods:
         return nullptr;
     }
 
+    /**
+      \brief Loads the items from the binary copy of the default bookmarks file
+             unless the XML file has been modified after it.
+      \returns the items or std::nullopt if the binary file could not be used.
+    */
+    static std::optional<QList<BookmarkItemBase *>> loadBinaryTree() {
+        QFileInfo const binaryInfo(defaultBinaryBookmarksFile());
+        QFileInfo const xmlInfo(defaultBookmarksFile());
+        if (!binaryInfo.exists()
+            || (xmlInfo.exists()
+                && xmlInfo.lastModified() > binaryInfo.lastModified()))
+            return {};
+
+        QFile file(binaryInfo.filePath());
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        auto const data(file.readAll());
+        QDataStream s(data);
+        s.setVersion(QDataStream::Qt_6_5);
+        quint32 version;
+        s >> version;
+        if (s.status() != QDataStream::Ok
+            || version != BT_BOOKMARKS_BINARY_VERSION)
+            return {};
+
+        BookmarkFolder root(QString{});
+        if (!readBinaryChildren(s, root) || !s.atEnd()) {
+            qWarning() << "Ignoring invalid" << file.fileName();
+            return {};
+        }
+        auto items(std::move(root.children()));
+        root.children().clear();
+        for (auto * const item : items)
+            item->setParent(nullptr);
+        return items;
+    }
+
+    /** Reads the children of the given folder from a binary stream. */
+    static bool readBinaryChildren(QDataStream & s, BookmarkFolder & folder) {
+        qint32 numChildren;
+        s >> numChildren;
+        if (s.status() != QDataStream::Ok || numChildren < 0)
+            return false;
+        for (qint32 i = 0; i < numChildren; ++i) {
+            quint8 isFolder;
+            QString text;
+            s >> isFolder >> text;
+            if (s.status() != QDataStream::Ok)
+                return false;
+            if (isFolder) {
+                if (!readBinaryChildren(s, *new BookmarkFolder(text, &folder)))
+                    return false;
+            } else {
+                QString moduleName;
+                QString key;
+                QString description;
+                s >> moduleName >> key >> description;
+                if (s.status() != QDataStream::Ok)
+                    return false;
+                auto * const bookmark = new BookmarkItem(&folder);
+                bookmark->setModule(moduleName);
+                bookmark->setKey(key);
+                bookmark->setDescription(description);
+                bookmark->setText(text);
+            }
+        }
+        return true;
+    }
+
+    /** Writes the children of the given folder to a binary stream. */
+    static void writeBinaryChildren(QDataStream & s,
+                                    BookmarkFolder const & folder)
+    {
+        s << static_cast<qint32>(folder.children().size());
+        for (auto const * const item : folder.children()) {
+            if (auto const * const f =
+                        dynamic_cast<BookmarkFolder const *>(item))
+            {
+                s << static_cast<quint8>(1u) << f->text();
+                writeBinaryChildren(s, *f);
+            } else {
+                auto const & b = *static_cast<BookmarkItem const *>(item);
+                s << static_cast<quint8>(0u) << b.text() << b.moduleName()
+                  << b.englishKey() << b.description();
+            }
+        }
+    }
+
+    /** Writes all bookmarks to the binary copy of the default file. */
+    bool saveBinaryTree() const {
+        QByteArray data;
+        {
+            QDataStream s(&data, QIODevice::WriteOnly);
+            s.setVersion(QDataStream::Qt_6_5);
+            s << BT_BOOKMARKS_BINARY_VERSION;
+            writeBinaryChildren(s, *m_rootItem);
+        }
+        QSaveFile file(defaultBinaryBookmarksFile());
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(data);
+            if (file.commit())
+                return true;
+        }
+        qWarning() << "Failed to write" << file.fileName();
+        return false;
+    }
+
     /** Loads a bookmark XML document from a named file or from the default bookmarks file. */
     QString loadXmlFromFile(QString fileName = QString()) {
         if (fileName.isEmpty())
@@ -414,6 +610,12 @@ public: // fields:
 
     BookmarkFolder * m_rootItem;
     QTimer m_saveTimer;
+    /** Whether the XML file lacks changes saved to the binary file only. */
+    bool m_xmlOutdated = false;
+
+    /** The merged verse intervals of folders, by folder and versification. */
+    mutable std::map<std::pair<BookmarkItemBase const *, std::string>,
+                     std::vector<std::pair<long, long>>> m_folderScopes;
     static BtBookmarksModel * m_defaultModel;
 
     Q_DECLARE_PUBLIC(BtBookmarksModel)
@@ -468,11 +670,13 @@ BookmarkItem::BookmarkItem(CSwordModuleInfo const & module,
 
     if (((module.type() == CSwordModuleInfo::Bible) || (module.type() == CSwordModuleInfo::Commentary))) {
         /// here we only translate \param key into english
-        sword::VerseKey vk(key.toUtf8().constData(), key.toUtf8().constData(),
+        auto const keyText(key.toUtf8());
+        sword::VerseKey vk(keyText.constData(), keyText.constData(),
             static_cast<sword::VerseKey *>(module.swordModule().getKey())->getVersificationSystem());
-        CSwordVerseKey k(&vk, &module);
-        k.setLocale("en");
-        m_key = k.key();
+        vk.setLocale("en");
+        m_key = QString::fromUtf8(vk.isBoundSet()
+                                  ? vk.getRangeText()
+                                  : vk.getText());
     }
     else {
         m_key = key;
@@ -491,30 +695,40 @@ BookmarkItem::BookmarkItem(const BookmarkItem & other)
         , m_key(other.m_key)
         , m_description(other.m_description)
         , m_moduleName(other.m_moduleName)
-{
-    setText(toHeader(key(), module() ? module()->name() : QObject::tr("unknown")));
-}
-
-CSwordModuleInfo * BookmarkItem::module() const
-{ return CSwordBackend::instance().findModuleByName(m_moduleName); }
-
-QString BookmarkItem::key() const {
-    const QString englishKeyName = englishKey();
-    if (!module()) {
-        return englishKeyName;
-    }
-
-    QString returnKeyName = englishKeyName;
-    if ((module()->type() == CSwordModuleInfo::Bible) || (module()->type() == CSwordModuleInfo::Commentary)) {
+        , m_cache(other.m_cache)
+{}
+
+CSwordModuleInfo * BookmarkItem::module() const { return cache().module; }
+
+QString BookmarkItem::key() const { return cache().key; }
+
+BookmarkItem::Cache const & BookmarkItem::cache() const {
+    auto const generation = swordSetupGeneration();
+    auto & backend = CSwordBackend::instance();
+    auto language(backend.booknameLanguage());
+    if (m_cache
+        && m_cache->swordSetupGeneration == generation
+        && m_cache->booknameLanguage == language)
+        return *m_cache;
+
+    auto * const m = backend.findModuleByName(m_moduleName);
+    QString key(m_key);
+    if (m && (m->type() == CSwordModuleInfo::Bible
+              || m->type() == CSwordModuleInfo::Commentary))
+    {
         /// here we only translate \param key into current book name language
-        sword::VerseKey vk(englishKeyName.toUtf8().constData(), englishKeyName.toUtf8().constData(),
-            static_cast<sword::VerseKey *>(module()->swordModule().getKey())->getVersificationSystem());
-        CSwordVerseKey k(&vk, module());
-        k.setLocale(CSwordBackend::instance().booknameLanguage().toLatin1());
-        returnKeyName = k.key();
+        auto const englishKeyName(m_key.toUtf8());
+        sword::VerseKey vk(
+                englishKeyName.constData(),
+                englishKeyName.constData(),
+                static_cast<sword::VerseKey *>(
+                    m->swordModule().getKey())->getVersificationSystem());
+        CSwordVerseKey k(&vk, m);
+        k.setLocale(language.toLatin1());
+        key = k.key();
     }
-
-    return returnKeyName;
+    return m_cache.emplace(
+                Cache{generation, std::move(language), m, std::move(key)});
 }
 
 QString BookmarkItem::toolTip() const {
@@ -522,18 +736,6 @@ QString BookmarkItem::toolTip() const {
     if (!m)
         return QString();
 
-    FilterOptions filterOptions = btConfig().getFilterOptions();
-    filterOptions.footnotes = false;
-    filterOptions.scriptureReferences = false;
-    CSwordBackend::instance().setFilterOptions(filterOptions);
-
-    std::unique_ptr<CSwordKey> k(m->createKey());
-    BT_ASSERT(k);
-    k->setKey(key());
-
-    // Language const * lang = m->language();
-    // BtConfig::FontSettingsPair fontPair = getBtConfig().getFontForLanguage(lang);
-
     auto const header = toHeader(key(), m->name());
     auto const & txt = text();
     if (txt == header)
@@ -544,26 +746,48 @@ QString BookmarkItem::toolTip() const {
 
 
 BtBookmarksModel::BtBookmarksModel(QObject * parent)
-    : QAbstractItemModel(parent)
-    , d_ptr(new BtBookmarksModelPrivate(this))
-{
-    load();
-}
+    : BtBookmarksModel(QString(), parent)
+{}
 
 BtBookmarksModel::BtBookmarksModel(QString const & fileName, QObject * parent)
     : QAbstractItemModel(parent)
     , d_ptr(new BtBookmarksModelPrivate(this))
-{ load(fileName); }
+{
+    Q_D(BtBookmarksModel);
+
+    // Sorting keeps the bookmarks of folders, but other changes don't:
+    BT_CONNECT(this, &BtBookmarksModel::rowsInserted,
+               this,
+               [d](QModelIndex const & parent)
+               { d->invalidateFolderScopes(parent); });
+    BT_CONNECT(this, &BtBookmarksModel::rowsAboutToBeRemoved,
+               this,
+               [d] { d->m_folderScopes.clear(); }); // Also of removed folders
+    BT_CONNECT(this, &BtBookmarksModel::dataChanged,
+               this,
+               [d](QModelIndex const & topLeft)
+               { d->invalidateFolderScopes(topLeft.parent()); });
+    BT_CONNECT(this, &BtBookmarksModel::modelReset,
+               this,
+               [d] { d->m_folderScopes.clear(); });
+
+    load(fileName);
+}
 
 BtBookmarksModel::~BtBookmarksModel() {
     Q_D(BtBookmarksModel);
 
-    if(d->m_saveTimer.isActive())
+    if (d->m_saveTimer.isActive() || d->m_xmlOutdated)
         save();
+    if (d->m_defaultModel == this)
+        d->m_defaultModel = nullptr;
 
     delete d_ptr;
 }
 
+BtBookmarksModel * BtBookmarksModel::defaultModel() noexcept
+{ return BtBookmarksModelPrivate::m_defaultModel; }
+
 int BtBookmarksModel::rowCount(const QModelIndex & parent) const {
     Q_D(const BtBookmarksModel);
 
@@ -689,12 +913,32 @@ bool BtBookmarksModel::save(QString fileName, const QModelIndex & rootItem) {
 
     util::tool::savePlainFile(fileName, serializedTree);
 
+    if (d->m_defaultModel == this
+        && !rootItem.isValid()
+        && fileName == BtBookmarksModelPrivate::defaultBookmarksFile())
+    {
+        // Write the binary file after the XML file to keep it the newer one:
+        d->saveBinaryTree();
+        d->m_xmlOutdated = false;
+    }
+
     if(d->m_saveTimer.isActive())
         d->m_saveTimer.stop();
 
     return true;
 }
 
+bool BtBookmarksModel::slotSave() {
+    Q_D(BtBookmarksModel);
+    BT_ASSERT(d->m_defaultModel == this);
+    /* Only write the compact binary file periodically, the XML file is written
+       when the model is destroyed: */
+    if (!d->saveBinaryTree())
+        return save();
+    d->m_xmlOutdated = true;
+    return true;
+}
+
 bool BtBookmarksModel::load(QString fileName, const QModelIndex & rootItem) {
     Q_D(BtBookmarksModel);
     BT_ASSERT(dynamic_cast<BookmarkFolder *>(d->item(rootItem)));
@@ -718,6 +962,95 @@ bool BtBookmarksModel::load(QString fileName, const QModelIndex & rootItem) {
     return true;
 }
 
+QModelIndexList BtBookmarksModel::folders(QModelIndex const & parent) const {
+    QModelIndexList r;
+    for (int row = 0; row < rowCount(parent); ++row) {
+        auto const child = index(row, 0, parent);
+        if (isFolder(child)) {
+            r.append(child);
+            r.append(folders(child));
+        }
+    }
+    return r;
+}
+
+sword::ListKey BtBookmarksModel::folderScope(QModelIndex const & folder,
+                                             sword::VerseKey const & key) const
+{
+    Q_D(const BtBookmarksModel);
+    auto const * const f = d->itemAs<BookmarkFolder const>(folder);
+    if (!f || !folder.isValid())
+        return {};
+
+    sword::VerseKey vk(key);
+    vk.setIntros(true);
+    auto [it, inserted] =
+            d->m_folderScopes.try_emplace(
+                std::pair(static_cast<BookmarkItemBase const *>(f),
+                          std::string(vk.getVersificationSystem())));
+    auto & intervals = it->second;
+    if (inserted) {
+        // The bookmarks keep their keys in english:
+        vk.setLocale("en");
+        auto const addVerses =
+                [&vk, &intervals](BookmarkFolder const & folder,
+                                  auto const & addVerses) -> void
+                {
+                    for (auto const * const child : folder.children()) {
+                        if (auto const * const subfolder =
+                                dynamic_cast<BookmarkFolder const *>(child))
+                        {
+                            addVerses(*subfolder, addVerses);
+                            continue;
+                        }
+                        auto const * const bookmark =
+                                static_cast<BookmarkItem const *>(child);
+                        auto const * const module = bookmark->module();
+                        if (!module
+                            || (module->type() != CSwordModuleInfo::Bible
+                                && module->type()
+                                   != CSwordModuleInfo::Commentary))
+                            continue;
+                        vk.setText(bookmark->englishKey().toUtf8().constData());
+                        if (!vk.popError())
+                            intervals.emplace_back(vk.getIndex(),
+                                                   vk.getIndex());
+                    }
+                };
+        addVerses(*f, addVerses);
+
+        // Merge overlapping and adjacent intervals:
+        std::sort(intervals.begin(), intervals.end());
+        std::size_t numMerged = 0u;
+        for (auto const & interval : intervals) {
+            if (numMerged > 0u
+                && interval.first <= intervals[numMerged - 1u].second + 1)
+            {
+                auto & last = intervals[numMerged - 1u].second;
+                last = std::max(last, interval.second);
+            } else {
+                intervals[numMerged++] = interval;
+            }
+        }
+        intervals.resize(numMerged);
+        intervals.shrink_to_fit();
+    }
+
+    sword::ListKey r;
+    sword::VerseKey bound(key);
+    bound.setIntros(true);
+    for (auto const & interval : intervals) {
+        sword::VerseKey range(bound);
+        bound.setIndex(interval.first);
+        range.setLowerBound(bound);
+        bound.setIndex(interval.second);
+        range.setUpperBound(bound);
+        range.setPosition(sword::TOP);
+        r.add(range);
+    }
+    return r;
+}
+
 bool BtBookmarksModel::isFolder(const QModelIndex &index) const
 {
     Q_D(const BtBookmarksModel);
@@ -845,6 +1178,45 @@ QModelIndex BtBookmarksModel::addBookmark(int const row,
     return QModelIndex();
 }
 
+void BtBookmarksModel::addBookmarks(int const row,
+                                    QModelIndex const & parent,
+                                    QList<NewBookmark> const & bookmarks)
+{
+    Q_D(BtBookmarksModel);
+
+    auto * const folder = d->itemAs<BookmarkFolder>(parent);
+    if (!folder)
+        return;
+
+    /* Look up every module only once. Bookmarks of modules which are not
+       installed are skipped. The tooltips are only generated when shown: */
+    auto & backend = CSwordBackend::instance();
+    QHash<QString, CSwordModuleInfo const *> modules;
+    QList<BookmarkItemBase *> newItems;
+    newItems.reserve(bookmarks.size());
+    for (auto const & bookmark : bookmarks) {
+        auto it = modules.constFind(bookmark.moduleName);
+        if (it == modules.constEnd())
+            it = modules.insert(
+                     bookmark.moduleName,
+                     backend.findModuleByName(bookmark.moduleName));
+        if (*it)
+            newItems.append(new BookmarkItem(**it,
+                                             bookmark.key,
+                                             bookmark.description,
+                                             QString()));
+    }
+    if (newItems.isEmpty())
+        return;
+
+    int const r = row < 0 ? row + rowCount(parent) + 1 : row;
+    beginInsertRows(parent, r, r + static_cast<int>(newItems.size()) - 1);
+    folder->insertChildren(r, std::move(newItems));
+    endInsertRows();
+
+    d->needSave();
+}
+
 QModelIndex BtBookmarksModel::addFolder(int row, const QModelIndex &parent, const QString &name)
 {
     Q_D(BtBookmarksModel);
@@ -14,19 +14,37 @@
 
 #include <QAbstractItemModel>
 
+#include <QList>
+#include <QString>
+
 
 class BtBookmarksModelPrivate;
 class CSwordModuleInfo;
+namespace sword {
+class ListKey;
+class VerseKey;
+} // namespace sword
 
 /**
   Model to load and display bookmarks. It is saved periodically if it was loaded
-  from default bookmarks file. No more one such model allowed at time.
+  from default bookmarks file. No more one such model allowed at time. The
+  periodic saves only write a compact binary copy of the default bookmarks
+  file, which is also preferred when loading unless the XML file is newer.
 */
 class BtBookmarksModel: public QAbstractItemModel {
 
     Q_OBJECT
 
 
+public: // types:
+
+    /** The data of a bookmark to add. */
+    struct NewBookmark {
+        QString moduleName;
+        QString key;
+        QString description;
+    };
+
 public: // methods:
 
     enum BookmarksRoles {
@@ -46,6 +64,9 @@ public: // methods:
                      QObject * parent = nullptr);
     ~BtBookmarksModel() override;
 
+    /** \returns the model of the default bookmarks file, if loaded. */
+    static BtBookmarksModel * defaultModel() noexcept;
+
     /** Reimplemented from QAbstractItemModel */
     int rowCount(const QModelIndex & parent = QModelIndex()) const override;
     int columnCount(const QModelIndex & parent = QModelIndex()) const override;
@@ -69,6 +90,19 @@ public: // methods:
                             QString const & description = QString(),
                             QString const & title = QString());
 
+    /**
+      \brief Adds the given bookmarks as a single batch of rows.
+
+      Bookmarks of works which are not installed are skipped. As for
+      addBookmark(), a negative row counts from the end.
+
+      \param[in] row the row of the first new item.
+      \param[in] parent if invalid the new items are placed on top level.
+    */
+    void addBookmarks(int row,
+                      QModelIndex const & parent,
+                      QList<NewBookmark> const & bookmarks);
+
     /**
       \brief add new folder.
     */
@@ -93,6 +127,18 @@ public: // methods:
      */
     bool isBookmark(const QModelIndex & index) const;
 
+    /** \returns the indexes of all folders below the given one, depth first. */
+    QModelIndexList folders(QModelIndex const & parent = QModelIndex()) const;
+
+    /**
+      \returns the verses bookmarked in the given folder and its subfolders as
+               merged verse ranges in the versification of the given key, e.g.
+               to search in them. The ranges are cached until the bookmarks in
+               the folder change.
+    */
+    sword::ListKey folderScope(QModelIndex const & folder,
+                               sword::VerseKey const & key) const;
+
     /**
       \returns true if the testIndex is baseIndex or a direct or indirect subitem of baseIndex.
     */
@@ -155,7 +201,7 @@ public Q_SLOTS:
 
 private:
 
-    bool slotSave() { return save(); }
+    bool slotSave();
 
 private: // fields:
     Q_DECLARE_PRIVATE(BtBookmarksModel)
@@ -0,0 +1,98 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btcorpusstatistics.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QSaveFile>
+#include <utility>
+
+
+//Increment this, if the file format changes
+constexpr static quint32 const BT_CORPUS_STATISTICS_VERSION = 1u;
+
+std::optional<BtCorpusStatistics> BtCorpusStatistics::load(
+        QString const & fileName,
+        QString const & indexStamp)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    quint32 version;
+    QString stamp;
+    BtCorpusStatistics r;
+    quint32 numEntries;
+    s >> version >> stamp >> numEntries >> r.m_books;
+    if (s.status() != QDataStream::Ok
+        || version != BT_CORPUS_STATISTICS_VERSION
+        || stamp != indexStamp)
+        return {};
+    r.m_numEntries = numEntries;
+
+    auto const numBooks = static_cast<std::size_t>(r.m_books.size());
+    for (auto & terms : r.m_terms) {
+        quint32 numTerms;
+        s >> numTerms;
+        if (s.status() != QDataStream::Ok)
+            return {};
+        terms.reserve(numTerms);
+        for (quint32 i = 0u; i < numTerms; ++i) {
+            Term term;
+            quint64 occurrences;
+            quint32 entries;
+            s >> term.text >> occurrences >> entries;
+            term.occurrences = occurrences;
+            term.entries = entries;
+            if (numBooks > 0u) {
+                term.bookEntries.resize(numBooks);
+                for (auto & bookEntries : term.bookEntries) {
+                    quint32 n;
+                    s >> n;
+                    bookEntries = n;
+                }
+            }
+            if (s.status() != QDataStream::Ok)
+                return {};
+            terms.emplace_back(std::move(term));
+        }
+    }
+    return r;
+}
+
+bool BtCorpusStatistics::save(QString const & fileName,
+                              QString const & indexStamp) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write" << file.fileName();
+        return false;
+    }
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    s << BT_CORPUS_STATISTICS_VERSION << indexStamp
+      << static_cast<quint32>(m_numEntries) << m_books;
+    for (auto const & terms : m_terms) {
+        s << static_cast<quint32>(terms.size());
+        for (auto const & term : terms) {
+            s << term.text << static_cast<quint64>(term.occurrences)
+              << static_cast<quint32>(term.entries);
+            for (auto const bookEntries : term.bookEntries)
+                s << static_cast<quint32>(bookEntries);
+        }
+    }
+    return s.status() == QDataStream::Ok && file.commit();
+}
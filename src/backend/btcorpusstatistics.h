@@ -0,0 +1,85 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+
+/**
+  \brief The frequencies of the terms in the search index of a module.
+
+  The statistics are computed by CSwordModuleInfo::corpusStatistics() in a
+  single pass over the term dictionary and the postings of the index, and
+  saved next to the index.
+*/
+class BtCorpusStatistics {
+
+    friend class CSwordModuleInfo;
+
+public: // types:
+
+    enum class Field : std::uint8_t {
+        Content,
+        Strong,
+        Morph
+    };
+
+    struct Term {
+        QString text;
+        std::uint64_t occurrences; ///< The sum of the frequencies in entries
+        std::uint32_t entries; ///< The number of entries containing the term
+
+        /**
+          The number of entries containing the term per book of books(), or
+          empty unless the module is verse keyed.
+        */
+        std::vector<std::uint32_t> bookEntries;
+    };
+
+public: // methods:
+
+    /** \returns the terms of the given field ordered by their text. */
+    std::vector<Term> const & terms(Field const field) const noexcept
+    { return m_terms[static_cast<std::size_t>(field)]; }
+
+    /**
+      \returns the names of the books of the entries in the order of the
+               versification, or an empty list unless the module is verse
+               keyed.
+    */
+    QStringList const & books() const noexcept { return m_books; }
+
+    /** \returns the number of entries in the index. */
+    std::uint32_t numEntries() const noexcept { return m_numEntries; }
+
+    /**
+      \returns the statistics stored in the given file, if it is valid and was
+               saved with the given index stamp.
+    */
+    static std::optional<BtCorpusStatistics> load(QString const & fileName,
+                                                  QString const & indexStamp);
+
+    /** \returns whether the statistics were saved to the given file. */
+    bool save(QString const & fileName, QString const & indexStamp) const;
+
+private: // fields:
+
+    std::vector<Term> m_terms[3];
+    QStringList m_books;
+    std::uint32_t m_numEntries = 0u;
+
+}; /* class BtCorpusStatistics */
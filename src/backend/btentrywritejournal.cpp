@@ -0,0 +1,186 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btentrywritejournal.h"
+
+#include <chrono>
+#include <memory>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <utility>
+#include "../util/btconnect.h"
+#include "../util/directory.h"
+#include "btindexingscheduler.h"
+#include "btrawentrycache.h"
+#include "config/btconfig.h"
+#include "drivers/cswordmoduleinfo.h"
+#include "keys/cswordkey.h"
+#include "managers/cswordbackend.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <swmodule.h>
+#pragma GCC diagnostic pop
+
+
+//Increment this, if the format of the journal changes
+constexpr static quint32 const BT_ENTRY_WRITE_JOURNAL_VERSION = 1u;
+
+BtEntryWriteJournal::BtEntryWriteJournal()
+    : m_deferred(
+          btConfig().value<bool>(
+              QStringLiteral("settings/behaviour/deferEntryWrites"),
+              false))
+{
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setInterval(std::chrono::seconds(5));
+    BT_CONNECT(&m_commitTimer, &QTimer::timeout,
+               this, &BtEntryWriteJournal::commit);
+}
+
+BtEntryWriteJournal & BtEntryWriteJournal::instance() {
+    static BtEntryWriteJournal journal;
+    return journal;
+}
+
+QString BtEntryWriteJournal::journalFileName() {
+    return util::directory::getUserBaseDir().filePath(
+                QStringLiteral("entrywrites.journal"));
+}
+
+void BtEntryWriteJournal::write(CSwordModuleInfo & module,
+                                QByteArray key,
+                                QByteArray entry)
+{
+    if (!m_deferred) {
+        commitEntries(module, Entries{{std::move(key), std::move(entry)}});
+        return;
+    }
+
+    QFile file(journalFileName());
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        QDataStream s(&file);
+        s.setVersion(QDataStream::Qt_6_5);
+        if (file.size() == 0)
+            s << BT_ENTRY_WRITE_JOURNAL_VERSION;
+        s << module.name() << key << entry;
+        if (s.status() != QDataStream::Ok)
+            qWarning() << "Failed to append to" << file.fileName();
+    } else {
+        qWarning() << "Failed to open" << file.fileName();
+    }
+
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_pending[module.name()].insert_or_assign(std::move(key),
+                                                  std::move(entry));
+        m_hasPending.store(true, std::memory_order_release);
+    }
+    if (!m_commitTimer.isActive())
+        m_commitTimer.start();
+}
+
+std::optional<QByteArray> BtEntryWriteJournal::pendingEntry(
+        QString const & moduleName,
+        QByteArray const & key) const
+{
+    if (!m_hasPending.load(std::memory_order_acquire))
+        return {};
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (auto const it = m_pending.find(moduleName); it != m_pending.end())
+        if (auto const jt = it->second.find(key); jt != it->second.end())
+            return jt->second;
+    return {};
+}
+
+void BtEntryWriteJournal::commit() {
+    m_commitTimer.stop();
+    if (!m_hasPending.load(std::memory_order_acquire))
+        return;
+
+    /* The entries stay pending until committed, so that they are found by
+       the keys of other threads meanwhile: */
+    for (auto const & [moduleName, entries] : m_pending) {
+        if (auto * const module =
+                CSwordBackend::instance().findModuleByName(moduleName))
+        {
+            commitEntries(*module, entries);
+        } else {
+            qWarning() << "Dropping the entries written to the missing module"
+                       << moduleName;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_pending.clear();
+        m_hasPending.store(false, std::memory_order_release);
+    }
+    QFile::remove(journalFileName());
+}
+
+void BtEntryWriteJournal::recover() {
+    QFile file(journalFileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    quint32 version;
+    s >> version;
+    if (s.status() == QDataStream::Ok
+        && version == BT_ENTRY_WRITE_JOURNAL_VERSION)
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        int records = 0;
+        // A record cut off by a crash ends the journal:
+        while (!s.atEnd()) {
+            QString moduleName;
+            QByteArray key;
+            QByteArray entry;
+            s >> moduleName >> key >> entry;
+            if (s.status() != QDataStream::Ok)
+                break;
+            m_pending[std::move(moduleName)].insert_or_assign(
+                        std::move(key),
+                        std::move(entry));
+            m_hasPending.store(true, std::memory_order_release);
+            ++records;
+        }
+        if (records > 0)
+            qDebug() << "Recovering" << records
+                     << "entries written in the previous session";
+    }
+    file.close();
+    commit();
+    QFile::remove(journalFileName()); // Even if empty or unreadable
+}
+
+void BtEntryWriteJournal::commitEntries(CSwordModuleInfo & module,
+                                        Entries const & entries)
+{
+    for (auto const & [key, entry] : entries)
+        module.writeEntry(key, entry);
+
+    // Other backends, e.g. of the indexing threads, shall read the new texts:
+    module.swordModule().flush();
+    BtRawEntryCache::instance().removeModule(module.name());
+
+    std::unique_ptr<CSwordKey> const k(module.createKey());
+    for (auto const & [key, entry] : entries) {
+        k->setKey(QString::fromUtf8(key));
+        BtIndexingScheduler::instance().enqueueEntryUpdate(&module,
+                                                           module.indexKey(*k));
+    }
+}
@@ -0,0 +1,99 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QObject>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+
+
+class CSwordModuleInfo;
+
+/**
+  \brief Writes the entries of writable modules, i.e. of personal commentaries.
+
+  If "settings/behaviour/deferEntryWrites" is set, write() just appends the
+  entry to a journal file and keeps it pending in memory, where the keys
+  reading the module find it by pendingEntry(). The pending entries are
+  committed to the Sword modules together a few seconds later, after which the
+  journal file is removed. Entries left in the journal by a crash are committed
+  by recover() on the next start. Otherwise write() commits every entry at
+  once.
+
+  The search index entries of the committed entries are updated by the
+  BtIndexingScheduler. Except for pendingEntry(), which may be called by any
+  thread, the journal must only be used by the main thread.
+*/
+class BtEntryWriteJournal: public QObject {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtEntryWriteJournal(BtEntryWriteJournal const &) = delete;
+    BtEntryWriteJournal & operator=(BtEntryWriteJournal const &) = delete;
+
+    static BtEntryWriteJournal & instance();
+
+    /**
+      \brief Writes the given entry of the given module.
+      \param[in] module A module of CSwordBackend::instance().
+      \param[in] key The text of the key as set to the Sword module.
+      \param[in] entry The entry in the encoding of the module.
+    */
+    void write(CSwordModuleInfo & module, QByteArray key, QByteArray entry);
+
+    /**
+      \returns the entry of the given key of the given module which was written
+               but not yet committed, if any.
+    */
+    std::optional<QByteArray> pendingEntry(QString const & moduleName,
+                                           QByteArray const & key) const;
+
+    /**
+      \brief Commits the pending entries, e.g. before the modules are reloaded.
+    */
+    void commit();
+
+    /** \brief Commits the entries left in the journal by a previous session. */
+    void recover();
+
+private: // types:
+
+    using Entries = std::map<QByteArray, QByteArray>; ///< By key
+
+private: // methods:
+
+    BtEntryWriteJournal();
+
+    static QString journalFileName();
+
+    /** \brief Writes the given entries to the given module. */
+    static void commitEntries(CSwordModuleInfo & module,
+                              Entries const & entries);
+
+private: // fields:
+
+    bool const m_deferred;
+    QTimer m_commitTimer;
+    mutable std::mutex m_mutex;
+    std::map<QString, Entries> m_pending; ///< By module name
+    std::atomic<bool> m_hasPending{false};
+
+}; /* class BtEntryWriteJournal */
@@ -0,0 +1,407 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btheadwordindex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <QChar>
+#include <QDebug>
+#include <QDir>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtEndian>
+#include <tuple>
+#include <utility>
+#include "../util/btassert.h"
+#include "../util/directory.h"
+#include "bttaskscheduler.h"
+#include "drivers/cswordlexiconmoduleinfo.h"
+
+
+namespace {
+
+// Change it once the format changed to make all systems rebuild the index
+constexpr quint32 const indexFormat = 1u;
+
+/* The index file consists of little-endian 32-bit integers and UTF-8 data in
+   the following order, so that it can be memory-mapped as is:
+     - the 4 bytes of indexMagic and the indexFormat
+     - the number of modules M and the number of rows N
+     - M + N + 1 offsets into the blob, of the M modules followed by the N
+       headwords of the rows
+     - the N rows of a module and an entry index, ordered by their headwords
+     - the blob of the modules, i.e. their names and versions separated by a
+       zero byte, and of the folded headwords */
+constexpr char const indexMagic[4] = {'B', 'T', 'H', 'W'};
+
+quint32 readUInt32(char const * const data) noexcept
+{ return qFromLittleEndian<quint32>(data); }
+
+void appendUInt32(QByteArray & data, quint32 const value) {
+    auto const v = qToLittleEndian(value);
+    data.append(reinterpret_cast<char const *>(&v), sizeof(v));
+}
+
+QString indexFileName() {
+    return util::directory::getUserCacheDir().absoluteFilePath(
+                QStringLiteral("headwords.index"));
+}
+
+/**
+  \returns the files the index is loaded from, the more recently written one
+           first. The prebuilt index of the shared cache directory is mapped
+           by all users, unless a user's lexicons differ from it and their
+           own index was written since.
+*/
+QStringList indexFileNames() {
+    QStringList r{indexFileName()};
+    if (auto const & sharedDir = util::directory::getSharedCacheDir()) {
+        auto sharedFileName(
+                    sharedDir->absoluteFilePath(
+                        QStringLiteral("headwords.index")));
+        if (QFileInfo(sharedFileName).lastModified()
+            >= QFileInfo(r.front()).lastModified())
+        {
+            r.prepend(std::move(sharedFileName));
+        } else {
+            r.append(std::move(sharedFileName));
+        }
+    }
+    return r;
+}
+
+struct CurrentIndex {
+    std::mutex mutex;
+    bool loaded = false;
+    std::shared_ptr<BtHeadwordIndex const> index;
+
+    /** Held while updating the index, so that updates do not overlap. */
+    std::mutex updateMutex;
+};
+
+CurrentIndex & currentIndex() {
+    static CurrentIndex current;
+    return current;
+}
+
+} // anonymous namespace
+
+BtHeadwordIndex::BtHeadwordIndex() noexcept = default;
+
+BtHeadwordIndex::BtHeadwordIndex(BtHeadwordIndex &&) noexcept = default;
+
+BtHeadwordIndex::~BtHeadwordIndex() = default;
+
+BtHeadwordIndex &
+BtHeadwordIndex::operator=(BtHeadwordIndex &&) noexcept = default;
+
+std::vector<BtHeadwordIndex::Match>
+BtHeadwordIndex::find(QString const & headword) const {
+    std::vector<Match> r;
+    auto const folded(foldedHeadword(headword).toUtf8());
+    for (auto row = lowerBound(folded);
+         row < m_numRows && headwordAt(row) == folded;
+         ++row)
+        r.push_back({QString::fromUtf8(moduleNameAt(moduleAt(row))),
+                     entryAt(row)});
+    return r;
+}
+
+bool BtHeadwordIndex::contains(QString const & moduleName,
+                               QString const & headword) const
+{
+    auto const folded(foldedHeadword(headword).toUtf8());
+    auto const name(moduleName.toUtf8());
+    for (auto row = lowerBound(folded);
+         row < m_numRows && headwordAt(row) == folded;
+         ++row)
+        if (moduleNameAt(moduleAt(row)) == name)
+            return true;
+    return false;
+}
+
+QString BtHeadwordIndex::foldedHeadword(QString const & headword) {
+    auto const decomposed(
+                headword.trimmed().normalized(QString::NormalizationForm_D));
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (auto const c : decomposed)
+        if (c.category() != QChar::Mark_NonSpacing)
+            folded.append(c);
+    return folded.toCaseFolded();
+}
+
+std::shared_ptr<BtHeadwordIndex const> BtHeadwordIndex::instance() {
+    auto & current = currentIndex();
+    std::lock_guard const guard(current.mutex);
+    if (!current.loaded) {
+        current.loaded = true;
+        for (auto const & fileName : indexFileNames()) {
+            if (auto index = load(fileName)) {
+                current.index =
+                        std::make_shared<BtHeadwordIndex const>(
+                            *std::move(index));
+                break;
+            }
+        }
+    }
+    return current.index;
+}
+
+void BtHeadwordIndex::update(std::vector<Module> lexicons) {
+    BtTaskScheduler::instance().submit(
+                [lexicons = std::move(lexicons)](BtTaskToken &) {
+                    auto & current = currentIndex();
+                    std::lock_guard const updateGuard(current.updateMutex);
+                    auto const previous = instance();
+                    auto index = previous
+                                 ? previous->updated(lexicons)
+                                 : BtHeadwordIndex().updated(lexicons);
+                    if (!index)
+                        return;
+                    qDebug() << "Indexed" << index->size()
+                             << "headwords of lexicons";
+                    std::lock_guard const guard(current.mutex);
+                    current.index =
+                            std::make_shared<BtHeadwordIndex const>(
+                                *std::move(index));
+                },
+                BtTaskScheduler::Priority::Idle);
+}
+
+bool BtHeadwordIndex::setData(char const * const data,
+                              qsizetype const size) noexcept
+{
+    if (size < 16
+        || std::memcmp(data, indexMagic, sizeof(indexMagic)) != 0
+        || readUInt32(data + 4) != indexFormat)
+        return false;
+    qsizetype const numModules = readUInt32(data + 8);
+    qsizetype const numRows = readUInt32(data + 12);
+    auto const numStrings = numModules + numRows;
+    qsizetype pos = 16;
+    if ((size - pos) / 4 < numStrings + 1 + 2 * numRows)
+        return false;
+    auto const * const offsets = data + pos;
+    pos += 4 * (numStrings + 1);
+    auto const * const rows = data + pos;
+    pos += 8 * numRows;
+
+    // Validate the index once, so that lookups need no checks:
+    quint32 previous = 0u;
+    for (qsizetype i = 0; i <= numStrings; ++i) {
+        auto const offset = readUInt32(offsets + 4 * i);
+        if (offset < previous || (i == 0 && offset != 0u))
+            return false;
+        previous = offset;
+    }
+    if (previous != static_cast<quint64>(size - pos))
+        return false;
+    for (qsizetype row = 0; row < numRows; ++row)
+        if (readUInt32(rows + 8 * row) >= static_cast<quint64>(numModules))
+            return false;
+
+    m_offsets = offsets;
+    m_rows = rows;
+    m_blob = data + pos;
+    m_numModules = numModules;
+    m_numRows = numRows;
+    return true;
+}
+
+QByteArrayView BtHeadwordIndex::stringAt(qsizetype const i) const noexcept {
+    BT_ASSERT(i >= 0 && i < m_numModules + m_numRows);
+    auto const begin = readUInt32(m_offsets + 4 * i);
+    auto const end = readUInt32(m_offsets + 4 * (i + 1));
+    return QByteArrayView(m_blob + begin, end - begin);
+}
+
+qsizetype BtHeadwordIndex::moduleAt(qsizetype const row) const noexcept
+{ return readUInt32(m_rows + 8 * row); }
+
+qsizetype BtHeadwordIndex::entryAt(qsizetype const row) const noexcept
+{ return readUInt32(m_rows + 8 * row + 4); }
+
+QByteArrayView
+BtHeadwordIndex::moduleNameAt(qsizetype const module) const noexcept {
+    auto const str = stringAt(module);
+    auto const separator = str.indexOf('\0');
+    return separator < 0 ? str : str.first(separator);
+}
+
+QByteArrayView
+BtHeadwordIndex::moduleVersionAt(qsizetype const module) const noexcept {
+    auto const str = stringAt(module);
+    auto const separator = str.indexOf('\0');
+    return separator < 0 ? QByteArrayView() : str.sliced(separator + 1);
+}
+
+qsizetype
+BtHeadwordIndex::lowerBound(QByteArrayView const foldedUtf8) const noexcept {
+    qsizetype first = 0;
+    for (auto count = m_numRows; count > 0;) {
+        auto const step = count / 2;
+        if (headwordAt(first + step) < foldedUtf8) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+std::optional<BtHeadwordIndex>
+BtHeadwordIndex::updated(std::vector<Module> const & lexicons) const {
+    struct Row {
+        QByteArrayView headword;
+        quint32 module;
+        quint32 entry;
+    };
+    std::vector<Row> rows;
+    std::deque<QByteArray> newHeadwords; // Referred to by the rows
+
+    // The new indices of the modules of this index, or -1 if not reused:
+    std::vector<qsizetype> reusedModules(
+                static_cast<std::size_t>(m_numModules),
+                -1);
+    QHash<QString, qsizetype> oldModules;
+    for (qsizetype module = 0; module < m_numModules; ++module)
+        oldModules.insert(QString::fromUtf8(moduleNameAt(module)), module);
+
+    std::vector<Module const *> modules;
+    for (auto const & lexicon : lexicons) {
+        auto const newModule = static_cast<quint32>(modules.size());
+        if (auto const it = oldModules.constFind(lexicon.name);
+            it != oldModules.cend()
+            && moduleVersionAt(*it) == lexicon.version)
+        {
+            reusedModules[static_cast<std::size_t>(*it)] = newModule;
+            modules.push_back(&lexicon);
+            continue;
+        }
+
+        auto const entries =
+                CSwordLexiconModuleInfo::cachedEntries(lexicon.name,
+                                                       lexicon.version);
+        if (!entries)
+            continue; // Added when its cache is built
+        modules.push_back(&lexicon);
+        for (qsizetype i = 0; i < entries->size(); ++i) {
+            auto const & headword =
+                    newHeadwords.emplace_back(
+                        foldedHeadword(entries->at(i)).toUtf8());
+            if (!headword.isEmpty())
+                rows.push_back({headword, newModule, static_cast<quint32>(i)});
+        }
+    }
+    if (newHeadwords.empty()
+        && static_cast<qsizetype>(modules.size()) == m_numModules)
+        return {};
+
+    for (qsizetype row = 0; row < m_numRows; ++row)
+        if (auto const module =
+                    reusedModules[static_cast<std::size_t>(moduleAt(row))];
+            module >= 0)
+            rows.push_back({headwordAt(row),
+                            static_cast<quint32>(module),
+                            static_cast<quint32>(entryAt(row))});
+    std::sort(rows.begin(),
+              rows.end(),
+              [](Row const & a, Row const & b) {
+                  if (a.headword != b.headword)
+                      return a.headword < b.headword;
+                  return std::tie(a.module, a.entry)
+                         < std::tie(b.module, b.entry);
+              });
+
+    qsizetype blobSize = 0;
+    std::vector<QByteArray> moduleStrings;
+    moduleStrings.reserve(modules.size());
+    for (auto const * const module : modules) {
+        auto & str = moduleStrings.emplace_back(module->name.toUtf8());
+        str.append('\0').append(module->version);
+        blobSize += str.size();
+    }
+    for (auto const & row : rows)
+        blobSize += row.headword.size();
+
+    QByteArray data;
+    data.reserve(20 + 4 * static_cast<qsizetype>(modules.size())
+                 + 12 * static_cast<qsizetype>(rows.size()) + blobSize);
+    data.append(indexMagic, sizeof(indexMagic));
+    appendUInt32(data, indexFormat);
+    appendUInt32(data, static_cast<quint32>(modules.size()));
+    appendUInt32(data, static_cast<quint32>(rows.size()));
+    quint32 offset = 0u;
+    appendUInt32(data, offset);
+    for (auto const & str : moduleStrings) {
+        offset += static_cast<quint32>(str.size());
+        appendUInt32(data, offset);
+    }
+    for (auto const & row : rows) {
+        offset += static_cast<quint32>(row.headword.size());
+        appendUInt32(data, offset);
+    }
+    for (auto const & row : rows) {
+        appendUInt32(data, row.module);
+        appendUInt32(data, row.entry);
+    }
+    for (auto const & str : moduleStrings)
+        data.append(str);
+    for (auto const & row : rows)
+        data.append(row.headword);
+
+    /* Map the saved index, or keep it in memory if saving failed, e.g. since
+       the previous index is still mapped on some platforms: */
+    QSaveFile file(indexFileName());
+    if (file.open(QIODevice::WriteOnly)
+        && file.write(data) == data.size()
+        && file.commit())
+        if (auto saved = load(file.fileName()))
+            return saved;
+    qWarning() << "Failed to write" << file.fileName();
+    BtHeadwordIndex r;
+    [[maybe_unused]] auto const valid =
+            r.setData(data.constData(), data.size());
+    BT_ASSERT(valid);
+    r.m_buffer = std::move(data);
+    return r;
+}
+
+std::optional<BtHeadwordIndex>
+BtHeadwordIndex::load(QString const & fileName) {
+    auto file = std::make_unique<QFile>(fileName);
+    if (!file->open(QIODevice::ReadOnly))
+        return {};
+    BtHeadwordIndex r;
+    auto const size = file->size();
+    if (auto const * const data = file->map(0, size)) {
+        if (!r.setData(reinterpret_cast<char const *>(data), size))
+            return {};
+        r.m_file = std::move(file);
+    } else { // Fall back to reading the file, e.g. if mmap is unsupported:
+        auto buffer(file->readAll());
+        if (!r.setData(buffer.constData(), buffer.size()))
+            return {};
+        r.m_buffer = std::move(buffer);
+    }
+    return r;
+}
@@ -0,0 +1,130 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <vector>
+
+
+class QFile;
+
+/**
+  \brief A sorted table of the headwords of all lexicon modules, for looking up
+         a word in all lexicons at once.
+
+  The headwords are folded by foldedHeadword(), i.e. compared ignoring case and
+  diacritics, and map to the modules and the indices of their entries (see
+  CSwordLexiconModuleInfo::Entries). The index is built from the key caches of
+  the lexicons and saved to the user cache directory, from where it is
+  memory-mapped, unless a prebuilt index of the shared cache directory (see
+  util::directory::getSharedCacheDir()) is more recent. When the installed
+  lexicons change, update() only reads the keys of the lexicons added or
+  updated.
+*/
+class BtHeadwordIndex {
+
+public: // types:
+
+    /** A lexicon module by its name and version. */
+    struct Module {
+        QString name;
+        QByteArray version;
+    };
+
+    struct Match {
+        QString moduleName;
+        qsizetype entryIndex;
+    };
+
+public: // methods:
+
+    BtHeadwordIndex(BtHeadwordIndex &&) noexcept;
+    ~BtHeadwordIndex();
+
+    BtHeadwordIndex & operator=(BtHeadwordIndex &&) noexcept;
+
+    /** \returns the number of headwords of all lexicons. */
+    qsizetype size() const noexcept { return m_numRows; }
+
+    /** \returns the entries of all lexicons with the given headword. */
+    std::vector<Match> find(QString const & headword) const;
+
+    /** \returns whether the given lexicon has the given headword. */
+    bool contains(QString const & moduleName, QString const & headword) const;
+
+    /** \returns the given headword without case and diacritics. */
+    static QString foldedHeadword(QString const & headword);
+
+    /**
+      \returns the current index, loading it from the cache directories
+               when called for the first time, or nullptr if no index was
+               built yet.
+    */
+    static std::shared_ptr<BtHeadwordIndex const> instance();
+
+    /**
+      \brief Updates the index to contain the given lexicons in the background,
+             and makes the updated index the instance().
+
+      Lexicons without an up to date key cache are left out, hence this needs
+      to be called again when their caches were built.
+    */
+    static void update(std::vector<Module> lexicons);
+
+private: // methods:
+
+    BtHeadwordIndex() noexcept;
+
+    /**
+      \brief Sets up the view of the given index data.
+      \returns whether the data was valid.
+    */
+    bool setData(char const * data, qsizetype size) noexcept;
+
+    QByteArrayView stringAt(qsizetype i) const noexcept;
+    QByteArrayView headwordAt(qsizetype row) const noexcept
+    { return stringAt(m_numModules + row); }
+    qsizetype moduleAt(qsizetype row) const noexcept;
+    qsizetype entryAt(qsizetype row) const noexcept;
+    QByteArrayView moduleNameAt(qsizetype module) const noexcept;
+    QByteArrayView moduleVersionAt(qsizetype module) const noexcept;
+
+    /** \returns the first row whose headword is not less than the given one. */
+    qsizetype lowerBound(QByteArrayView foldedUtf8) const noexcept;
+
+    /**
+      \returns the index of the given lexicons, reusing the rows of the
+               lexicons unchanged in this one, or nothing if the index would
+               be the same.
+    */
+    std::optional<BtHeadwordIndex> updated(
+            std::vector<Module> const & lexicons) const;
+
+    /** \returns the index saved to the given file, if it is valid. */
+    static std::optional<BtHeadwordIndex> load(QString const & fileName);
+
+private: // fields:
+
+    std::unique_ptr<QFile> m_file;
+    QByteArray m_buffer;
+    char const * m_offsets = nullptr;
+    char const * m_rows = nullptr;
+    char const * m_blob = nullptr;
+    qsizetype m_numModules = 0;
+    qsizetype m_numRows = 0;
+
+}; /* class BtHeadwordIndex */
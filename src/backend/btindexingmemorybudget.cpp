@@ -0,0 +1,98 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btindexingmemorybudget.h"
+
+#include <algorithm>
+#include <QString>
+#include <QtGlobal>
+#include "config/btconfig.h"
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+
+constexpr static std::uint64_t const BT_MIB = 1024u * 1024u;
+
+//Budget used if the physical memory can not be determined
+constexpr static std::uint64_t const BT_DEFAULT_INDEXING_MEMORY_BUDGET =
+        1024u * BT_MIB;
+
+//Memory of an indexing job besides the documents buffered by its writer
+constexpr static std::uint64_t const BT_INDEXING_JOB_MEMORY = 96u * BT_MIB;
+
+//Least memory a writer buffers documents in, even if over the budget
+constexpr static std::uint64_t const BT_MIN_INDEX_WRITER_BUFFER = 4u * BT_MIB;
+
+namespace {
+
+std::uint64_t physicalMemory() {
+#ifdef Q_OS_UNIX
+    auto const pages = ::sysconf(_SC_PHYS_PAGES);
+    auto const pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0)
+        return static_cast<std::uint64_t>(pages)
+               * static_cast<std::uint64_t>(pageSize);
+#endif
+    return 0u;
+}
+
+std::uint64_t configuredBudget() {
+    auto const mib =
+            btConfig().value<int>(
+                QStringLiteral("settings/behaviour/indexingMemoryBudget"),
+                0);
+    if (mib > 0)
+        return static_cast<std::uint64_t>(mib) * BT_MIB;
+    if (auto const memory = physicalMemory())
+        return memory / 4u;
+    return BT_DEFAULT_INDEXING_MEMORY_BUDGET;
+}
+
+} // anonymous namespace
+
+BtIndexingMemoryBudget::Share::Share(BtIndexingMemoryBudget & budget) noexcept
+    : m_budget(budget)
+{ m_budget.m_writers.fetch_add(1u, std::memory_order_relaxed); }
+
+BtIndexingMemoryBudget::Share::~Share() noexcept
+{ m_budget.m_writers.fetch_sub(1u, std::memory_order_relaxed); }
+
+std::uint64_t BtIndexingMemoryBudget::Share::bufferSize() const noexcept {
+    auto const writers = static_cast<std::uint64_t>(
+                std::max(m_budget.m_writers.load(std::memory_order_relaxed),
+                         static_cast<std::size_t>(1u)));
+    auto const share = m_budget.m_size / writers;
+    return (share > BT_INDEXING_JOB_MEMORY + BT_MIN_INDEX_WRITER_BUFFER)
+           ? share - BT_INDEXING_JOB_MEMORY
+           : BT_MIN_INDEX_WRITER_BUFFER;
+}
+
+BtIndexingMemoryBudget::BtIndexingMemoryBudget()
+    : m_size(configuredBudget())
+{}
+
+BtIndexingMemoryBudget & BtIndexingMemoryBudget::instance() {
+    static BtIndexingMemoryBudget budget;
+    return budget;
+}
+
+std::size_t BtIndexingMemoryBudget::maxConcurrentJobs(std::size_t const cores)
+        const noexcept
+{
+    auto const jobs = static_cast<std::size_t>(
+            m_size / (BT_INDEXING_JOB_MEMORY + BT_MIN_INDEX_WRITER_BUFFER));
+    return std::clamp(jobs,
+                      static_cast<std::size_t>(1u),
+                      std::max(cores, static_cast<std::size_t>(1u)));
+}
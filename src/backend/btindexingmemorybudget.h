@@ -0,0 +1,80 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+  \brief The memory shared by all index writers building indices concurrently.
+
+  The budget is a quarter of the physical memory, or the number of MiB set by
+  "settings/behaviour/indexingMemoryBudget". Each writer registers a Share for
+  its lifetime and flushes its buffered documents to disk when its buffer
+  exceeds Share::bufferSize(), which is the budget split evenly among all
+  registered writers less the fixed memory of each indexing job, like its
+  worker backend and field buffers. BtIndexingScheduler runs only as many jobs
+  concurrently as fit into the budget.
+*/
+class BtIndexingMemoryBudget {
+
+public: // types:
+
+    /** The registration of an index writer with the budget. */
+    class Share {
+
+    public: // methods:
+
+        explicit Share(BtIndexingMemoryBudget & budget = instance()) noexcept;
+        Share(Share const &) = delete;
+        Share & operator=(Share const &) = delete;
+        ~Share() noexcept;
+
+        /**
+          \returns the size in bytes the writer may buffer documents up to
+                   before flushing them, given the writers currently
+                   registered.
+        */
+        std::uint64_t bufferSize() const noexcept;
+
+    private: // fields:
+
+        BtIndexingMemoryBudget & m_budget;
+
+    };
+
+public: // methods:
+
+    static BtIndexingMemoryBudget & instance();
+
+    /** \returns the size of the budget in bytes. */
+    std::uint64_t size() const noexcept { return m_size; }
+
+    /**
+      \returns the number of indexing jobs fitting into the budget, but at
+               least one and at most the given number of cores.
+    */
+    std::size_t maxConcurrentJobs(std::size_t cores) const noexcept;
+
+private: // methods:
+
+    BtIndexingMemoryBudget();
+
+private: // fields:
+
+    std::uint64_t const m_size;
+    std::atomic<std::size_t> m_writers{0u};
+
+}; /* class BtIndexingMemoryBudget */
@@ -0,0 +1,421 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btindexingscheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QThread>
+#include <Qt>
+#include "btindexingmemorybudget.h"
+#include "btindexingthread.h"
+
+
+//Interval in milliseconds of polling whether to stop waiting for indices
+constexpr static int const BT_INDEXING_WAIT_POLL_INTERVAL = 100;
+
+BtIndexingScheduler * BtIndexingScheduler::m_instance = nullptr;
+
+BtIndexingScheduler::BtIndexingScheduler(QObject * const parent)
+    : QObject(parent)
+{
+    BT_ASSERT(!m_instance);
+    m_instance = this;
+}
+
+BtIndexingScheduler::~BtIndexingScheduler() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+        for (auto & activeJob : m_activeJobs) {
+            activeJob.cancelled = true;
+            if (activeJob.workerModule)
+                activeJob.workerModule->cancelIndexing();
+        }
+    }
+    m_condition.notify_all();
+    m_jobFinishedCondition.notify_all();
+    for (auto const & thread : m_threads)
+        thread->wait();
+
+    BT_ASSERT(m_instance == this);
+    m_instance = nullptr;
+}
+
+void BtIndexingScheduler::enqueue(CSwordModuleInfo const * const module,
+                                  Priority const priority)
+{
+    BT_ASSERT(module);
+    if (!module->hasIndex())
+        enqueue(module->name(), priority, false);
+}
+
+void BtIndexingScheduler::enqueueInstalled(QString const & moduleName)
+{ enqueue(moduleName, Priority::RecentlyInstalled, true); }
+
+void BtIndexingScheduler::enqueue(QString const & moduleName,
+                                  Priority const priority,
+                                  bool const reloadBackend)
+{
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_stopping)
+            return;
+        for (auto const & activeJob : m_activeJobs)
+            if (activeJob.job.moduleName == moduleName
+                && !activeJob.cancelled
+                && !reloadBackend)
+                return;
+        auto const it =
+                std::find_if(m_queue.begin(),
+                             m_queue.end(),
+                             [&moduleName](Job const & job)
+                             { return job.moduleName == moduleName; });
+        if (it != m_queue.end()) {
+            it->priority = std::max(it->priority, priority);
+            it->reloadBackend = it->reloadBackend || reloadBackend;
+            it->entryKeys.clear(); // Build the whole index instead
+            it->optimize = false;
+            return;
+        }
+        m_queue.emplace_back(Job{moduleName,
+                                 priority,
+                                 m_nextSequence++,
+                                 reloadBackend});
+        startThreads();
+    }
+    m_condition.notify_one();
+}
+
+void BtIndexingScheduler::enqueueEntryUpdate(
+        CSwordModuleInfo const * const module,
+        QString key)
+{
+    BT_ASSERT(module);
+    if (!module->hasIndex())
+        return;
+    auto const & moduleName = module->name();
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_stopping)
+            return;
+
+        /* If the module is being indexed, the entry might have been indexed
+           already, hence another job is queued even then: */
+        auto const it =
+                std::find_if(m_queue.begin(),
+                             m_queue.end(),
+                             [&moduleName](Job const & job) {
+                                 return job.moduleName == moduleName
+                                        && !job.optimize;
+                             });
+        if (it != m_queue.end()) {
+            if (!it->entryKeys.isEmpty() && !it->entryKeys.contains(key))
+                it->entryKeys.append(std::move(key));
+            return;
+        }
+        m_queue.emplace_back(Job{moduleName,
+                                 Priority::Default,
+                                 m_nextSequence++,
+                                 false,
+                                 {std::move(key)}});
+        startThreads();
+    }
+    m_condition.notify_one();
+}
+
+void BtIndexingScheduler::enqueueOptimization(QString const & moduleName) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_stopping)
+            return;
+        // Queued jobs of the module enqueue the optimization when done:
+        if (std::any_of(m_queue.begin(),
+                        m_queue.end(),
+                        [&moduleName](Job const & job)
+                        { return job.moduleName == moduleName; }))
+            return;
+        m_queue.emplace_back(Job{moduleName,
+                                 Priority::Idle,
+                                 m_nextSequence++,
+                                 false,
+                                 {},
+                                 true});
+        startThreads();
+    }
+    m_condition.notify_one();
+}
+
+void BtIndexingScheduler::enqueueRebuild(QString const & moduleName) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_stopping)
+            return;
+        auto const it =
+                std::find_if(m_queue.begin(),
+                             m_queue.end(),
+                             [&moduleName](Job const & job)
+                             { return job.moduleName == moduleName; });
+        if (it != m_queue.end()) {
+            it->priority = std::max(it->priority, Priority::Default);
+            it->entryKeys.clear();
+            it->optimize = false;
+            return;
+        }
+        m_queue.emplace_back(Job{moduleName,
+                                 Priority::Default,
+                                 m_nextSequence++,
+                                 false});
+        startThreads();
+    }
+    m_condition.notify_one();
+}
+
+void BtIndexingScheduler::startThreads() {
+    // Start the worker threads lazily:
+    if (m_threadsRequested)
+        return;
+    m_threadsRequested = true;
+
+    /* Jobs are also queued by other threads, e.g. by searches, which the
+       worker threads must not belong to: */
+    if (QThread::currentThread() == thread()) {
+        createThreads();
+    } else {
+        QMetaObject::invokeMethod(
+                    this,
+                    [this] {
+                        std::lock_guard<std::mutex> const guard(m_mutex);
+                        if (!m_stopping)
+                            createThreads();
+                    },
+                    Qt::QueuedConnection);
+    }
+}
+
+void BtIndexingScheduler::createThreads() {
+    // Run only as many jobs at once as there are cores and memory for:
+    m_threads.resize(
+            BtIndexingMemoryBudget::instance().maxConcurrentJobs(
+                static_cast<std::size_t>(
+                    std::max(QThread::idealThreadCount(), 1))));
+    for (auto & thread : m_threads) {
+        thread = std::make_unique<BtIndexingThread>(*this);
+        thread->start(QThread::LowestPriority);
+    }
+}
+
+void BtIndexingScheduler::cancel(CSwordModuleInfo const * const module) {
+    BT_ASSERT(module);
+    auto const & moduleName = module->name();
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_queue.erase(std::remove_if(m_queue.begin(),
+                                 m_queue.end(),
+                                 [&moduleName](Job const & job)
+                                 { return job.moduleName == moduleName; }),
+                  m_queue.end());
+    for (auto & activeJob : m_activeJobs) {
+        if (activeJob.job.moduleName != moduleName)
+            continue;
+        activeJob.cancelled = true;
+        if (activeJob.workerModule)
+            activeJob.workerModule->cancelIndexing();
+    }
+}
+
+bool BtIndexingScheduler::isScheduled(CSwordModuleInfo const * const module)
+        const
+{
+    BT_ASSERT(module);
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return isScheduled(module->name());
+}
+
+bool BtIndexingScheduler::isScheduled(QString const & moduleName) const {
+    return std::any_of(m_queue.begin(),
+                       m_queue.end(),
+                       [&moduleName](Job const & job) {
+                           return job.moduleName == moduleName
+                                  && !job.optimize;
+                       })
+           || std::any_of(m_activeJobs.begin(),
+                          m_activeJobs.end(),
+                          [&moduleName](ActiveJob const & activeJob) {
+                              return activeJob.job.moduleName == moduleName
+                                     && !activeJob.job.optimize;
+                          });
+}
+
+bool BtIndexingScheduler::runUnlessScheduled(
+        QString const & moduleName,
+        std::function<void()> const & function)
+{
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (std::any_of(m_queue.begin(),
+                    m_queue.end(),
+                    [&moduleName](Job const & job)
+                    { return job.moduleName == moduleName; })
+        || std::any_of(m_activeJobs.begin(),
+                       m_activeJobs.end(),
+                       [&moduleName](ActiveJob const & activeJob)
+                       { return activeJob.job.moduleName == moduleName; }))
+        return false;
+    function();
+    return true;
+}
+
+std::vector<std::pair<QString, int>> BtIndexingScheduler::activeJobs() const {
+    std::vector<std::pair<QString, int>> r;
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    r.reserve(m_activeJobs.size());
+    for (auto const & activeJob : m_activeJobs)
+        if (!activeJob.cancelled)
+            r.emplace_back(activeJob.job.moduleName, activeJob.progress);
+    return r;
+}
+
+bool BtIndexingScheduler::waitForIndices(
+        BtConstModuleList const & modules,
+        std::function<bool()> const & shouldStop)
+{
+    for (auto const * const m : modules)
+        enqueue(m, Priority::Search);
+
+    // Wait until finishJob() has taken the last job of the modules:
+    {
+        auto const done =
+                [this, &modules] {
+                    return m_stopping
+                           || std::none_of(
+                                   modules.begin(),
+                                   modules.end(),
+                                   [this](CSwordModuleInfo const * const m)
+                                   { return isScheduled(m->name()); });
+                };
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!done()) {
+            // The GUI thread would not deliver the events of the jobs:
+            BT_ASSERT(QThread::currentThread() != qApp->thread());
+            if (!shouldStop) {
+                m_jobFinishedCondition.wait(lock, done);
+            } else {
+                while (!m_jobFinishedCondition.wait_for(
+                           lock,
+                           std::chrono::milliseconds(
+                               BT_INDEXING_WAIT_POLL_INTERVAL),
+                           done))
+                {
+                    lock.unlock();
+                    if (shouldStop())
+                        return false;
+                    lock.lock();
+                }
+            }
+        }
+    }
+
+    /* The index states of the modules are refreshed by events of this thread
+       otherwise, which are not processed while waiting: */
+    return std::all_of(modules.begin(),
+                       modules.end(),
+                       [](CSwordModuleInfo const * const m) {
+                           if (m->hasIndex())
+                               return true;
+                           m->refreshIndexState();
+                           return m->hasIndex();
+                       });
+}
+
+std::vector<BtIndexingScheduler::Job>::iterator
+BtIndexingScheduler::nextJob() {
+    auto r = m_queue.end();
+    for (auto it = m_queue.begin(); it != m_queue.end(); ++it) {
+        // Indices can not be written by several threads at once:
+        if (std::any_of(m_activeJobs.begin(),
+                        m_activeJobs.end(),
+                        [it](ActiveJob const & activeJob)
+                        { return activeJob.job.moduleName == it->moduleName; }))
+            continue;
+        if (r == m_queue.end()
+            || (it->priority != r->priority
+                ? (it->priority > r->priority)
+                : (it->sequence < r->sequence)))
+            r = it;
+    }
+    return r;
+}
+
+std::optional<BtIndexingScheduler::Job>
+BtIndexingScheduler::takeJob(BtIndexingThread const & thread, bool const block)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (block) {
+        m_condition.wait(
+                    lock,
+                    [this] { return m_stopping || nextJob() != m_queue.end(); });
+    }
+    if (m_stopping)
+        return {};
+    auto const it = nextJob();
+    if (it == m_queue.end())
+        return {};
+    auto job(std::move(*it));
+    m_queue.erase(it);
+    m_activeJobs.emplace_back(ActiveJob{&thread, job});
+    return job;
+}
+
+bool BtIndexingScheduler::startJob(BtIndexingThread const & thread,
+                                   CSwordModuleInfo * const workerModule)
+{
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    auto * const activeJob = this->activeJob(thread);
+    BT_ASSERT(activeJob);
+    if (activeJob->cancelled)
+        return false;
+    activeJob->workerModule = workerModule;
+    return true;
+}
+
+void BtIndexingScheduler::setJobProgress(BtIndexingThread const & thread,
+                                         int const progress)
+{
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (auto * const activeJob = this->activeJob(thread))
+        activeJob->progress = progress;
+}
+
+void BtIndexingScheduler::finishJob(BtIndexingThread const & thread) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_activeJobs.erase(
+                    std::remove_if(m_activeJobs.begin(),
+                                   m_activeJobs.end(),
+                                   [&thread](ActiveJob const & activeJob)
+                                   { return activeJob.thread == &thread; }),
+                    m_activeJobs.end());
+    }
+    // Queued jobs of the same module can be taken now:
+    m_condition.notify_all();
+    m_jobFinishedCondition.notify_all();
+}
+
+BtIndexingScheduler::ActiveJob *
+BtIndexingScheduler::activeJob(BtIndexingThread const & thread) {
+    for (auto & activeJob : m_activeJobs)
+        if (activeJob.thread == &thread)
+            return &activeJob;
+    return nullptr;
+}
@@ -0,0 +1,237 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QObject>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <QString>
+#include <QStringList>
+#include <utility>
+#include <vector>
+#include "../util/btassert.h"
+#include "drivers/btmodulelist.h"
+#include "drivers/cswordmoduleinfo.h"
+
+
+class BtIndexingThread;
+
+/**
+  \brief A persistent background service which builds search indices.
+
+  Modules are queued by name and priority and indexed by a set of low priority
+  worker threads (see BtIndexingThread). Among modules of the same priority,
+  the ones queued first are indexed first. The indexingProgress(),
+  indexingFinished() and hasIndexChanged() signals of the respective modules of
+  CSwordBackend::instance() are emitted as they are being indexed. Indices
+  built by fast builds are optimized afterwards with Priority::Idle, see
+  CSwordModuleInfo::fastIndexBuildsEnabled().
+*/
+class BtIndexingScheduler: public QObject {
+
+    Q_OBJECT
+
+    friend class BtIndexingThread;
+
+public: // types:
+
+    enum class Priority {
+        Idle,
+        Default,
+        RecentlyInstalled,
+        Search
+    };
+
+    struct Job {
+        QString moduleName;
+        Priority priority;
+        std::uint64_t sequence;
+        bool reloadBackend;
+
+        /** The keys of the entries to update, or empty to build the index. */
+        QStringList entryKeys = {};
+
+        /** Whether to only optimize the index, see enqueueOptimization(). */
+        bool optimize = false;
+    };
+
+public: // methods:
+
+    BtIndexingScheduler(QObject * parent = nullptr);
+    ~BtIndexingScheduler() override;
+
+    /** \returns the singleton instance. */
+    static BtIndexingScheduler & instance() noexcept {
+        BT_ASSERT(m_instance);
+        return *m_instance;
+    }
+
+    /**
+      \brief Queues the given module for indexing unless it already has an
+             index. If the module is already queued with a lower priority, its
+             priority is raised.
+    */
+    void enqueue(CSwordModuleInfo const * module,
+                 Priority priority = Priority::Default);
+
+    /**
+      \brief Queues a freshly installed module with Priority::RecentlyInstalled.
+      \note The module does not need to be loaded by CSwordBackend::instance()
+            yet, the worker thread reloads its own backend to find it.
+      \param[in] moduleName The name of the installed module.
+    */
+    void enqueueInstalled(QString const & moduleName);
+
+    /**
+      \brief Queues an update of the indexed document of the given entry, e.g.
+             after it was changed by CSwordModuleInfo::write(), unless the
+             module has no index.
+      \param[in] module The module of the entry.
+      \param[in] key The key of the entry as returned by
+                     CSwordModuleInfo::indexKey().
+    */
+    void enqueueEntryUpdate(CSwordModuleInfo const * module, QString key);
+
+    /**
+      \brief Queues the optimization of the index of the given module with
+             Priority::Idle, i.e. once no other indices are to be built.
+      \param[in] moduleName The name of the module.
+    */
+    void enqueueOptimization(QString const & moduleName);
+
+    /**
+      \brief Queues a complete rebuild of the index of the given module, e.g.
+             after updating its index failed, even if it has an index or is
+             being indexed. Other queued jobs of the module are replaced.
+      \param[in] moduleName The name of the module.
+    */
+    void enqueueRebuild(QString const & moduleName);
+
+    /**
+      \brief Removes the given module from the queue or cancels its indexing
+             if it is currently being indexed.
+    */
+    void cancel(CSwordModuleInfo const * module);
+
+    /**
+      \returns whether the given module is queued or being indexed, not
+               counting optimizations of its index.
+    */
+    bool isScheduled(CSwordModuleInfo const * module) const;
+
+    /**
+      \brief Calls the given function unless any job of the given module is
+             queued or running, including optimizations. No job starts while
+             the function runs, e.g. while it deletes the index of the module.
+      \warning The function must not use this scheduler.
+      \returns whether the function was called.
+    */
+    bool runUnlessScheduled(QString const & moduleName,
+                            std::function<void()> const & function);
+
+    /**
+      \returns the names and the progress percentages of the modules currently
+               being indexed.
+    */
+    std::vector<std::pair<QString, int>> activeJobs() const;
+
+    /**
+      \brief Queues the given modules with Priority::Search and blocks until
+             none of them is scheduled any more.
+      \note Since the calling thread processes no events while blocked, this
+            must only block worker threads. The GUI thread waits with an event
+            loop for jobFinished() instead, see BtModuleIndexDialog, before
+            calling this for the result.
+      \param[in] modules The modules to wait for.
+      \param[in] shouldStop If given, it is polled regularly and waiting is
+                            aborted once it returns true.
+      \returns whether all of the given modules have an index.
+    */
+    bool waitForIndices(BtConstModuleList const & modules,
+                        std::function<bool()> const & shouldStop = nullptr);
+
+Q_SIGNALS:
+
+    /** \brief Emitted from a worker thread whenever a job has ended. */
+    void jobFinished();
+
+    /** \brief Emitted from a worker thread if building an index failed. */
+    void indexingFailed(QString const & moduleName, QString const & message);
+
+private: // types:
+
+    struct ActiveJob {
+        BtIndexingThread const * thread;
+        Job job;
+        CSwordModuleInfo * workerModule = nullptr;
+        int progress = 0;
+        bool cancelled = false;
+    };
+
+private: // methods:
+
+    void enqueue(QString const & moduleName,
+                 Priority priority,
+                 bool reloadBackend);
+
+    /**
+      \brief Starts the worker threads in the thread of the scheduler unless
+             started. Needs m_mutex.
+    */
+    void startThreads();
+
+    /** \brief Creates and starts the worker threads. Needs m_mutex. */
+    void createThreads();
+
+    /**
+      \returns whether the given module is queued or being indexed, not
+               counting optimizations of its index. Needs m_mutex.
+    */
+    bool isScheduled(QString const & moduleName) const;
+
+    /**
+      \returns the next job to take, which is the oldest job with the highest
+               priority among the ones whose module is not being indexed by
+               another thread, or m_queue.end() if there is none. Needs
+               m_mutex.
+    */
+    std::vector<Job>::iterator nextJob();
+
+    std::optional<Job> takeJob(BtIndexingThread const & thread, bool block);
+    bool startJob(BtIndexingThread const & thread,
+                  CSwordModuleInfo * workerModule);
+    void setJobProgress(BtIndexingThread const & thread, int progress);
+    void finishJob(BtIndexingThread const & thread);
+
+    ActiveJob * activeJob(BtIndexingThread const & thread);
+
+private: // fields:
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_jobFinishedCondition;
+    std::vector<Job> m_queue;
+    std::vector<ActiveJob> m_activeJobs;
+    std::uint64_t m_nextSequence = 0u;
+    bool m_stopping = false;
+    bool m_threadsRequested = false;
+    std::vector<std::unique_ptr<BtIndexingThread>> m_threads;
+
+    static BtIndexingScheduler * m_instance;
+
+}; /* class BtIndexingScheduler */
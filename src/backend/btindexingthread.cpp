@@ -0,0 +1,154 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btindexingthread.h"
+
+#include <array>
+#include <exception>
+#include <memory>
+#include <QMetaObject>
+#include <QScopeGuard>
+#include <Qt>
+#include "btindexingscheduler.h"
+#include "drivers/cswordmoduleinfo.h"
+#include "managers/cswordbackend.h"
+
+
+void BtIndexingThread::run() {
+    /* The filter options are global to the SWMgr of the modules, hence each
+       thread needs its own backend. It is only kept while there are jobs in
+       the queue: */
+    std::unique_ptr<CSwordBackend> backend;
+
+    for (;;) {
+        auto job(m_scheduler.takeJob(*this, false));
+        if (!job) {
+            backend.reset();
+            job = m_scheduler.takeJob(*this, true);
+            if (!job)
+                return;
+        }
+        auto const finishJob =
+                qScopeGuard(
+                    [this]() noexcept {
+                        m_scheduler.finishJob(*this);
+                        Q_EMIT m_scheduler.jobFinished();
+                    });
+
+        setPriority(job->priority == BtIndexingScheduler::Priority::Search
+                    ? QThread::LowPriority
+                    : QThread::LowestPriority);
+
+        if (job->reloadBackend || !backend)
+            backend = CSwordBackend::createWorkerInstance();
+        auto * workerModule = backend->findModuleByName(job->moduleName);
+        if (!workerModule) { // The module might have been installed recently:
+            backend = CSwordBackend::createWorkerInstance();
+            workerModule = backend->findModuleByName(job->moduleName);
+            if (!workerModule) {
+                Q_EMIT m_scheduler.indexingFailed(
+                            job->moduleName,
+                            tr("The work %1 was not found by the indexing "
+                               "thread.").arg(job->moduleName));
+                continue;
+            }
+        }
+
+        if (!m_scheduler.startJob(*this, workerModule))
+            continue; // Cancelled before it was started
+
+        /* Relay the signals to the respective module of the main backend, which
+           might have been reloaded in the meantime: */
+        auto const relay =
+                [this, moduleName = job->moduleName](bool const indexChanged,
+                                                     auto const signal,
+                                                     auto const ... args)
+                {
+                    QMetaObject::invokeMethod(
+                                &m_scheduler,
+                                [moduleName, indexChanged, signal, args...] {
+                                    auto * const m =
+                                            CSwordBackend::instance()
+                                                .findModuleByName(moduleName);
+                                    if (!m)
+                                        return;
+                                    /* The index state cached by the module
+                                       was not changed by the worker module: */
+                                    if (indexChanged)
+                                        m->refreshIndexState();
+                                    Q_EMIT (m->*signal)(args...);
+                                },
+                                Qt::QueuedConnection);
+                };
+        std::array<QMetaObject::Connection, 4u> connections{
+            connect(workerModule, &CSwordModuleInfo::indexingProgress,
+                    [this, &relay](int const percentage) {
+                        m_scheduler.setJobProgress(*this, percentage);
+                        relay(false,
+                              &CSwordModuleInfo::indexingProgress,
+                              percentage);
+                    }),
+            connect(workerModule, &CSwordModuleInfo::indexingStatistics,
+                    [&relay](CSwordModuleInfo::IndexingStatistics const & s)
+                    {
+                        relay(false,
+                              &CSwordModuleInfo::indexingStatistics,
+                              s);
+                    }),
+            connect(workerModule, &CSwordModuleInfo::indexingFinished,
+                    [&relay]
+                    { relay(true, &CSwordModuleInfo::indexingFinished); }),
+            connect(workerModule, &CSwordModuleInfo::hasIndexChanged,
+                    [&relay](bool const hasIndex)
+                    {
+                        relay(true,
+                              &CSwordModuleInfo::hasIndexChanged,
+                              hasIndex);
+                    })};
+        auto const cleanup =
+                qScopeGuard(
+                    [&connections]() noexcept {
+                        for (auto & connection : connections)
+                            disconnect(connection);
+                    });
+
+        try {
+            if (job->optimize) {
+                workerModule->optimizeIndex();
+                QMetaObject::invokeMethod(
+                            &m_scheduler,
+                            [moduleName = job->moduleName] {
+                                if (auto * const m =
+                                        CSwordBackend::instance()
+                                            .findModuleByName(moduleName))
+                                    m->refreshIndexState();
+                            },
+                            Qt::QueuedConnection);
+            } else if (job->entryKeys.isEmpty()) {
+                workerModule->buildIndex();
+            } else {
+                workerModule->updateIndexEntries(job->entryKeys);
+            }
+            if (workerModule->hasUnoptimizedIndex())
+                m_scheduler.enqueueOptimization(job->moduleName);
+        } catch (std::exception const & e) {
+            Q_EMIT m_scheduler.indexingFailed(job->moduleName,
+                                              QString::fromUtf8(e.what()));
+        } catch (...) {
+            Q_EMIT m_scheduler.indexingFailed(job->moduleName,
+                                              tr("<UNKNOWN EXCEPTION>"));
+        }
+        // The index kept after failing to update it is rebuilt instead:
+        if (workerModule->indexNeedsRebuild())
+            m_scheduler.enqueueRebuild(job->moduleName);
+    }
+}
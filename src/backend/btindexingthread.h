@@ -0,0 +1,51 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QThread>
+
+#include <QObject>
+
+
+class BtIndexingScheduler;
+
+/**
+  \brief A worker thread of BtIndexingScheduler which builds search indices.
+
+  Each thread uses a private CSwordBackend, so that every module is indexed
+  through its own sword::SWModule instance with its own key and filter state.
+  The indexingProgress(), indexingFinished() and hasIndexChanged() signals of
+  the private module instances are relayed to the respective signals of the
+  queued modules in the main thread.
+*/
+class BtIndexingThread: public QThread {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtIndexingThread(BtIndexingScheduler & scheduler,
+                     QObject * parent = nullptr)
+        : QThread(parent)
+        , m_scheduler(scheduler)
+    {}
+
+protected: // methods:
+
+    void run() override;
+
+private: // fields:
+
+    BtIndexingScheduler & m_scheduler;
+
+}; /* class BtIndexingThread */
@@ -12,9 +12,18 @@
 
 #include "btinstallbackend.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <QByteArray>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
 #include <type_traits>
 #include <utility>
 #include "../util/btassert.h"
@@ -37,6 +46,135 @@ using namespace sword;
 
 namespace BtInstallBackend {
 
+namespace {
+
+struct CachedCatalogue {
+    QString stamp;
+    std::shared_ptr<Catalogue const> catalogue;
+};
+
+std::mutex catalogueCacheMutex;
+std::map<QString, CachedCatalogue> catalogueCache; // By module config path
+
+QString moduleConfigPath(sword::InstallSource const & is) {
+    return QString::fromLocal8Bit(isRemote(is)
+                                  ? is.localShadow.c_str()
+                                  : is.directory.c_str())
+           + QStringLiteral("/mods.d");
+}
+
+/**
+  \returns a string which changes whenever module configurations are added to,
+           changed in or removed from the given directory.
+*/
+QString catalogueStamp(QDir const & dir) {
+    auto const files(dir.entryInfoList({QStringLiteral("*.conf")},
+                                       QDir::Files | QDir::Readable));
+    qint64 newest = QFileInfo(dir.absolutePath())
+                    .lastModified().toMSecsSinceEpoch();
+    for (auto const & file : files)
+        newest = std::max(newest, file.lastModified().toMSecsSinceEpoch());
+    return QStringLiteral("%1:%2").arg(files.size()).arg(newest);
+}
+
+QString categoryOfDriver(QByteArray const & driver) {
+    if (driver.contains("Text"))
+        return QStringLiteral("Biblical Texts");
+    if (driver.contains("Com") || driver == "RawFiles")
+        return QStringLiteral("Commentaries");
+    if (driver.contains("LD"))
+        return QStringLiteral("Lexicons / Dictionaries");
+    return QStringLiteral("Generic Books");
+}
+
+/**
+  \brief Parses the first section of a module configuration file, following
+         the continuation lines of Sword.
+*/
+std::optional<CatalogueEntry> parseModuleConfig(QString const & fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    std::optional<QByteArray> name;
+    QByteArray driver;
+    QByteArray version;
+    QByteArray language;
+    QByteArray category;
+    QByteArray glossaryFrom;
+    QByteArray installSize;
+    QByteArray description;
+    bool utf8 = false;
+    bool glossary = false;
+
+    QByteArray line;
+    while (!file.atEnd()) {
+        line += file.readLine().trimmed();
+        if (line.endsWith('\\')) { // Continued on the next line
+            line.chop(1);
+            continue;
+        }
+        if (line.startsWith('[')) {
+            if (name)
+                break;
+            name.emplace(line.mid(1, line.indexOf(']') - 1));
+        } else if (auto const i = line.indexOf('='); name && i > 0) {
+            auto const key(line.left(i).trimmed());
+            auto value(line.mid(i + 1).trimmed());
+            if (key == "ModDrv") {
+                driver = std::move(value);
+            } else if (key == "Version") {
+                version = std::move(value);
+            } else if (key == "Lang") {
+                language = std::move(value);
+            } else if (key == "Category") {
+                category = std::move(value);
+            } else if (key == "GlossaryFrom") {
+                glossaryFrom = std::move(value);
+            } else if (key == "InstallSize") {
+                installSize = std::move(value);
+            } else if (key == "Description") {
+                description = std::move(value);
+            } else if (key == "Encoding") {
+                utf8 = (value == "UTF-8");
+            } else if (key == "Feature" && value == "Glossary") {
+                glossary = true;
+            }
+        }
+        line.clear();
+    }
+    if (!name || name->isEmpty())
+        return {};
+
+    auto const decode =
+            [utf8](QByteArray const & value) {
+                return utf8 ? QString::fromUtf8(value)
+                            : QString::fromLatin1(value);
+            };
+    CatalogueEntry entry;
+    entry.name = QString::fromUtf8(*name);
+    entry.version = version.isEmpty()
+                    ? QStringLiteral("1.0")
+                    : QString::fromLatin1(version);
+    entry.category = category.isEmpty()
+                     ? categoryOfDriver(driver)
+                     : decode(category);
+    /* Like CSwordModuleInfo, use the "from" language as the language of
+       glossaries: */
+    glossary = glossary || entry.category == QStringLiteral("Glossaries");
+    entry.language =
+            QString::fromLatin1(glossary
+                                ? glossaryFrom
+                                : (language.isEmpty() ? "en" : language));
+    bool ok = false;
+    if (auto const size = installSize.toLongLong(&ok); ok)
+        entry.installSize = size;
+    entry.description = decode(description);
+    return entry;
+}
+
+} // anonymous namespace
+
 /** Adds the source described by Source to the backend. */
 bool addSource(sword::InstallSource& source) {
     SWConfig config(configFilename().toLatin1());
@@ -184,6 +322,8 @@ QStringList sourceNameList() {
 }
 
 std::unique_ptr<CSwordBackend> backend(sword::InstallSource const & is) {
+    // This is also called by BtInstallThread, see lockSwordFiles():
+    auto const lock(CSwordBackend::lockSwordFiles());
     /// \anchor BackendNotSingleton
     auto ret(std::make_unique<CSwordBackend>(isRemote(is)
                                              ? is.localShadow.c_str()
@@ -193,4 +333,53 @@ std::unique_ptr<CSwordBackend> backend(sword::InstallSource const & is) {
     return ret;
 }
 
+std::shared_ptr<Catalogue const> catalogue(sword::InstallSource const & is) {
+    QDir const dir(moduleConfigPath(is));
+    auto stamp(catalogueStamp(dir));
+    {
+        std::lock_guard const guard(catalogueCacheMutex);
+        auto const it = catalogueCache.find(dir.absolutePath());
+        if (it != catalogueCache.end() && it->second.stamp == stamp)
+            return it->second.catalogue;
+    }
+
+    auto result(std::make_shared<Catalogue>());
+    for (auto const & fileName
+         : dir.entryList({QStringLiteral("*.conf")},
+                         QDir::Files | QDir::Readable,
+                         QDir::Name))
+        if (auto entry = parseModuleConfig(dir.filePath(fileName)))
+            result->emplace_back(std::move(*entry));
+
+    std::lock_guard const guard(catalogueCacheMutex);
+    catalogueCache[dir.absolutePath()] = {std::move(stamp), result};
+    return result;
+}
+
+std::vector<std::shared_ptr<Catalogue const>>
+catalogues(QStringList const & sourceNames) {
+    std::vector<std::shared_ptr<Catalogue const>> result(
+                static_cast<std::size_t>(sourceNames.size()));
+    if (sourceNames.size() == 1) {
+        result.front() = catalogue(source(sourceNames.front()));
+        return result;
+    }
+
+    // The sources are looked up here, since BtInstallMgr is not thread-safe:
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (std::size_t i = 0u; i < result.size(); ++i) {
+        threads.emplace_back(
+                    QThread::create(
+                        [&result,
+                         i,
+                         is = source(sourceNames.at(
+                                         static_cast<qsizetype>(i)))]
+                        { result[i] = catalogue(is); }));
+        threads.back()->start();
+    }
+    for (auto const & thread : threads)
+        thread->wait();
+    return result;
+}
+
 } // namespace BtInstallBackend
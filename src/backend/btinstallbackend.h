@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <QString>
 #include <QStringList>
+#include <vector>
 
 
 class CSwordBackend;
@@ -45,4 +47,34 @@ QString configFilename();
 /** Returns backend Sword manager for the source. */
 std::unique_ptr<CSwordBackend> backend(sword::InstallSource const & is);
 
+/** \brief The metadata of a module offered by a source. */
+struct CatalogueEntry {
+    QString name;
+    QString version; ///< "1.0" unless given
+    QString language; ///< The abbreviation, "from" language of glossaries
+    QString category; ///< As in the module configuration or by its driver
+    std::int64_t installSize = -1; ///< In bytes, -1 if unknown
+    QString description;
+};
+
+using Catalogue = std::vector<CatalogueEntry>;
+
+/**
+  \brief Parses the module configurations of the source, without loading the
+         modules into a backend like backend() does.
+
+  The catalogue is cached until the configurations of the source change,
+  e.g. when the source is refreshed.
+  \returns the catalogue of the modules offered by the source.
+*/
+std::shared_ptr<Catalogue const> catalogue(sword::InstallSource const & is);
+
+/**
+  \brief Like catalogue(), but parses the catalogues of several sources in
+         parallel.
+  \returns the catalogues of the sources with the given names, in order.
+*/
+std::vector<std::shared_ptr<Catalogue const>>
+catalogues(QStringList const & sourceNames);
+
 } // namespace BtInstallBackend
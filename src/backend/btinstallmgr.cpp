@@ -12,17 +12,22 @@
 
 #include "btinstallmgr.h"
 
+#include <memory>
 #include <QByteArray>
+#include <QDir>
+#include <QTemporaryDir>
 #include <QtGlobal>
 #include <type_traits>
 #include <utility>
 #include "../util/btassert.h"
+#include "../util/zip.h"
 #include "btinstallbackend.h"
 
 
 // Sword includes:
 #include <defs.h>
 #include <installmgr.h>
+#include <swmgr.h>
 
 
 namespace {
@@ -91,6 +96,65 @@ bool BtInstallMgr::isUserDisclaimerConfirmed() const {
     return true;
 }
 
+bool BtInstallMgr::installPackage(SWMgr & destination,
+                                  InstallSource const & source,
+                                  QString const & moduleName)
+{
+    QString urlPrefix;
+    if (source.type == "FTP") {
+        urlPrefix = QStringLiteral("ftp://");
+    } else if (source.type == "HTTP") {
+        urlPrefix = QStringLiteral("http://");
+    } else if (source.type == "HTTPS") {
+        urlPrefix = QStringLiteral("https://");
+    } else {
+        return false;
+    }
+    auto directory(QString::fromUtf8(source.directory.c_str()));
+    while (directory.endsWith('/'))
+        directory.chop(1);
+    auto const slash = directory.lastIndexOf('/');
+    if (slash < 0)
+        return false;
+    auto const url(urlPrefix + QString::fromUtf8(source.source.c_str())
+                   + directory.left(slash)
+                   + QStringLiteral("/packages/rawzip/") + moduleName
+                   + QStringLiteral(".zip"));
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid())
+        return false;
+    auto const packageFile(tempDir.filePath(QStringLiteral("package.zip")));
+    {
+        std::unique_ptr<RemoteTransport> transport(
+                    (source.type == "FTP")
+                    ? createFTPTransport(source.source.c_str(), this)
+                    : createHTTPTransport(source.source.c_str(), this));
+        if (!transport)
+            return false;
+        transport->setPassive(isFTPPassive());
+        if (!source.u.empty()) {
+            transport->setUser(source.u.c_str());
+            transport->setPasswd(source.p.c_str());
+        }
+        TrySetTimeoutMillis<RemoteTransport>::setTimeoutMillis(*transport, 0);
+
+        // The size of the package is only known from the download itself:
+        m_totalBytes = 0;
+        m_completedBytes = 0;
+        Q_EMIT downloadStarted();
+        if (transport->getURL(packageFile.toLocal8Bit().constData(),
+                              url.toUtf8().constData()))
+            return false;
+    }
+
+    if (!util::zip::extract(packageFile,
+                            QString::fromLocal8Bit(destination.prefixPath)))
+        return false;
+    destination.load();
+    return destination.getModule(moduleName.toUtf8().constData());
+}
+
 void BtInstallMgr::statusUpdate(double dltotal, double dlnow) {
     /**
       \warning Note that these *might be* rough measures due to the double data
@@ -104,8 +168,10 @@ void BtInstallMgr::statusUpdate(double dltotal, double dlnow) {
     if (dlnow < 0.0) // Special care (see warning above)
         dlnow = 0.0;
 
-    const int totalPercent = calculateIntPercentage<double>(dlnow + m_completedBytes,
-                                                            m_totalBytes);
+    const int totalPercent =
+            calculateIntPercentage<double>(
+                dlnow + m_completedBytes,
+                (m_totalBytes > 0) ? m_totalBytes : dltotal);
     const int filePercent  = calculateIntPercentage(dlnow, dltotal);
 
     //qApp->processEvents();
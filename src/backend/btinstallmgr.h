@@ -43,6 +43,22 @@ public: // methods:
 
     bool isUserDisclaimerConfirmed() const override;
 
+    /**
+      \brief Installs a module from its zip package in a remote source.
+
+      Remote sources like CrossWire provide a zip package of every module in
+      packages/rawzip next to the directory of the modules. Downloading it is
+      much faster than fetching the files of the module one by one.
+
+      \param[in] destination the manager for the destination path.
+      \param[in] source the remote source.
+      \param[in] moduleName the name of the module.
+      \returns whether the module has been installed.
+    */
+    bool installPackage(sword::SWMgr & destination,
+                        sword::InstallSource const & source,
+                        QString const & moduleName);
+
 Q_SIGNALS:
 
     /**
@@ -12,12 +12,23 @@
 
 #include "btinstallthread.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <memory>
 #include <QDebug>
 #include <QByteArray>
 #include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
 #include <QString>
+#include <QStringList>
+#include <QTemporaryDir>
 #include <QVariant>
+#include <system_error>
+#include <utility>
+#include "btindexingscheduler.h"
 #include "btinstallbackend.h"
 #include "drivers/cswordmoduleinfo.h"
 #include "managers/cswordbackend.h"
@@ -25,8 +36,16 @@
 // Sword includes:
 #include <installmgr.h>
 #include <swbuf.h>
+#include <swconfig.h>
 #include <swmgr.h>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
 
 namespace {
 
@@ -41,8 +60,118 @@ inline bool runMkdir(QDir & dir, const QString & dirName) {
     return true;
 }
 
+/**
+  \brief Copies the given file, sharing its data by a reflink where the file
+         system supports it, e.g. on Btrfs and XFS. Otherwise the data is
+         copied by the kernel where possible, which also lets network file
+         systems copy it on the server.
+*/
+bool copyFile(QString const & from, QString const & to) {
+#ifdef Q_OS_LINUX
+    auto const fromPath(QFile::encodeName(from));
+    auto const toPath(QFile::encodeName(to));
+    if (int const in = ::open(fromPath.constData(), O_RDONLY | O_CLOEXEC);
+        in >= 0)
+    {
+        bool cloned = false;
+        if (int const out = ::open(toPath.constData(),
+                                   O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                   0644);
+            out >= 0)
+        {
+            cloned = (::ioctl(out, FICLONE, in) == 0);
+            ::close(out);
+        }
+        ::close(in);
+        if (cloned)
+            return true;
+    }
+#endif
+    std::error_code error;
+    std::filesystem::copy_file(
+                std::filesystem::path(from.toStdU16String()),
+                std::filesystem::path(to.toStdU16String()),
+                std::filesystem::copy_options::overwrite_existing,
+                error);
+    return !error;
+}
+
+/** The files of a module in a local source. */
+struct LocalModule {
+    QString confFile;
+    QString dataDir; ///< Relative to the source directory
+};
+
+/**
+  \returns the files of the given module in the given local source, or nothing
+           if the module is not simply made up of its data directory.
+*/
+std::optional<LocalModule> findLocalModule(QString const & sourceDir,
+                                           QString const & moduleName)
+{
+    auto const name(moduleName.toLatin1());
+    auto const confFiles(
+            QDir(sourceDir + QStringLiteral("/mods.d")).entryInfoList(
+                {QStringLiteral("*.conf")},
+                QDir::Files));
+    for (auto const & info : confFiles) {
+        sword::SWConfig conf(
+                    QFile::encodeName(info.absoluteFilePath()).constData());
+        auto const & sections = conf.getSections();
+        auto const section = sections.find(name.constData());
+        if (section == sections.end())
+            continue;
+        auto const & entries = section->second;
+
+        // Modules listing their files individually are left to InstallMgr:
+        if (entries.find("File") != entries.end())
+            return {};
+        auto const dataPath = entries.find("DataPath");
+        if (dataPath == entries.end())
+            return {};
+        auto dataDir(QDir::cleanPath(
+                         QString::fromUtf8(dataPath->second.c_str())));
+
+        // The data paths of these drivers end with a file name prefix:
+        static QStringList const prefixDrivers{QStringLiteral("RawLD"),
+                                               QStringLiteral("RawLD4"),
+                                               QStringLiteral("zLD"),
+                                               QStringLiteral("RawGenBook")};
+        if (auto const driver = entries.find("ModDrv");
+            driver != entries.end()
+            && prefixDrivers.contains(
+                QString::fromUtf8(driver->second.c_str())))
+            dataDir = QFileInfo(dataDir).path();
+
+        if (dataDir.isEmpty()
+            || dataDir == QStringLiteral(".")
+            || dataDir.startsWith(QStringLiteral(".."))
+            || QDir::isAbsolutePath(dataDir))
+            return {};
+        return LocalModule{info.absoluteFilePath(), std::move(dataDir)};
+    }
+    return {};
+}
+
+/* Hands the installed module over to background indexing, which runs while the
+   next module of the batch is being downloaded: */
+void scheduleIndexing(QString const & moduleName) {
+    auto & scheduler = BtIndexingScheduler::instance();
+    QMetaObject::invokeMethod(
+                &scheduler,
+                [&scheduler, moduleName]
+                { scheduler.enqueueInstalled(moduleName); },
+                Qt::QueuedConnection);
+}
+
 }
 
+//Maximum number of modules downloaded from remote sources concurrently
+constexpr static int const BT_MAX_CONCURRENT_DOWNLOADS = 4;
+
+//Maximum number of files copied from local sources concurrently
+constexpr static std::size_t const BT_MAX_CONCURRENT_COPIES = 4u;
+
 void BtInstallThread::run() {
     // Make sure target/mods.d and target/modules exist
     /// \todo move this to some common precondition
@@ -54,37 +183,144 @@ void BtInstallThread::run() {
         return;
     }
 
+    /* Modules from remote sources are downloaded concurrently into a staging
+       directory and copied from there to the destination in order: */
+    QTemporaryDir stagingDir;
+    int numRemoteModules = 0;
+    m_downloads.assign(static_cast<std::size_t>(m_modules.size()),
+                       Download::None);
+    for (int i = 0; i < m_modules.size(); ++i) {
+        auto const * const module = m_modules.at(i);
+        m_moduleNames.append(module->name());
+        m_sourceNames.append(module->property("installSourceName").toString());
+        if (stagingDir.isValid()
+            && BtInstallBackend::isRemote(
+                BtInstallBackend::source(m_sourceNames.back())))
+        {
+            m_downloads[static_cast<std::size_t>(i)] = Download::Pending;
+            ++numRemoteModules;
+        }
+    }
+    std::vector<std::unique_ptr<QThread>> downloaders;
+    auto const stagingPath(stagingDir.path());
+    for (int i = 0;
+         i < std::min(numRemoteModules, BT_MAX_CONCURRENT_DOWNLOADS);
+         ++i)
+    {
+        downloaders.emplace_back(
+                QThread::create(
+                    [this, stagingPath]{ downloadModules(stagingPath); }));
+        downloaders.back()->start();
+    }
+
     for (m_currentModuleIndex = 0;
          m_currentModuleIndex < m_modules.size();
          ++m_currentModuleIndex)
     {
-        installModule();
+        installModule(stagingPath);
         if (m_stopRequested.load(std::memory_order_relaxed))
             break;
     }
+
+    m_stopRequested.store(true, std::memory_order_relaxed);
+    for (auto const & downloader : downloaders)
+        downloader->wait();
+}
+
+void BtInstallThread::downloadModules(QString const & stagingPath) {
+    for (;;) {
+        std::size_t i;
+        {
+            std::lock_guard<std::mutex> const guard(m_downloadMutex);
+            while (m_nextDownload < m_downloads.size()
+                   && m_downloads[m_nextDownload] != Download::Pending)
+                ++m_nextDownload;
+            if (m_nextDownload >= m_downloads.size()
+                || m_stopRequested.load(std::memory_order_relaxed))
+            {
+                // Wake up run() in case it waits for a skipped download:
+                m_downloadCondition.notify_all();
+                return;
+            }
+            i = m_nextDownload++;
+            m_downloads[i] = Download::Running;
+        }
+
+        auto const moduleIndex = static_cast<int>(i);
+        Q_EMIT preparingInstall(moduleIndex);
+        QDir dir(stagingPath);
+        auto const moduleDir(QString::number(moduleIndex));
+        bool success = false;
+        if (dir.mkpath(moduleDir + QStringLiteral("/mods.d"))
+            && dir.mkpath(moduleDir + QStringLiteral("/modules")))
+        {
+            BtInstallMgr iMgr;
+            QObject::connect(&iMgr, &BtInstallMgr::percentCompleted,
+                             [this, moduleIndex](int const totalProgress, int)
+                             { Q_EMIT statusUpdated(moduleIndex,
+                                                    totalProgress); });
+            QObject::connect(&iMgr, &BtInstallMgr::downloadStarted,
+                             [this, moduleIndex]
+                             { Q_EMIT downloadStarted(moduleIndex); });
+            auto installSource(BtInstallBackend::source(m_sourceNames[i]));
+            sword::SWMgr lMgr(dir.filePath(moduleDir).toLocal8Bit());
+            auto const status =
+                    iMgr.installPackage(lMgr, installSource, m_moduleNames[i])
+                    ? 0
+                    : iMgr.installModule(&lMgr,
+                                         nullptr,
+                                         m_moduleNames[i].toLatin1(),
+                                         &installSource);
+            if (status == 0) {
+                success = true;
+            } else {
+                qWarning() << "Error with download: " << status
+                           << "module:" << m_moduleNames[i];
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> const guard(m_downloadMutex);
+            m_downloads[i] = success ? Download::Succeeded : Download::Failed;
+        }
+        m_downloadCondition.notify_all();
+    }
 }
 
-void BtInstallThread::installModule() {
+void BtInstallThread::installModule(QString const & stagingPath) {
+    bool downloaded;
+    {
+        std::lock_guard<std::mutex> const guard(m_downloadMutex);
+        downloaded = m_downloads[static_cast<std::size_t>(m_currentModuleIndex)]
+                     != Download::None;
+    }
+    if (downloaded) {
+        installDownloadedModule(stagingPath);
+        return;
+    }
+
     Q_EMIT preparingInstall(m_currentModuleIndex);
 
     const CSwordModuleInfo * const module = m_modules.at(m_currentModuleIndex);
 
-    QVariant vModuleName = module->property("installSourceName");
-    QString moduleName = vModuleName.toString();
-    sword::InstallSource installSource = BtInstallBackend::source(moduleName);
+    sword::InstallSource installSource =
+            BtInstallBackend::source(m_sourceNames[m_currentModuleIndex]);
 
     // Check whether it's an update. If yes, remove existing module first:
     /// \todo silently removing without undo if the user cancels the update is WRONG!!!
     if (!removeModule() && m_stopRequested.load(std::memory_order_relaxed))
         return;
 
-    // manager for the destination path
-    sword::SWMgr lMgr(m_destination.toLatin1());
     if (BtInstallBackend::isRemote(installSource)) {
-        int status = m_iMgr.installModule(&lMgr,
-                                          nullptr,
-                                          module->name().toLatin1(),
-                                          &installSource);
+        // manager for the destination path
+        sword::SWMgr lMgr(m_destination.toLatin1());
+        int status =
+                m_iMgr.installPackage(lMgr, installSource, module->name())
+                ? 0
+                : m_iMgr.installModule(&lMgr,
+                                       nullptr,
+                                       module->name().toLatin1(),
+                                       &installSource);
         if (status == 0) {
             Q_EMIT statusUpdated(m_currentModuleIndex, 100);
         } else {
@@ -92,10 +328,27 @@ void BtInstallThread::installModule() {
                        << "module:" << module->name();
         }
         Q_EMIT installCompleted(m_currentModuleIndex, status == 0);
+        if (status == 0 && m_indexAfterInstall)
+            scheduleIndexing(module->name());
     } else { // Local source
-        int status = m_iMgr.installModule(&lMgr,
+        /* Copying the files directly also spares loading all modules of the
+           destination for each module installed: */
+        int status;
+        if (auto const copied =
+                    copyLocalModule(
+                        QFile::decodeName(installSource.directory.c_str())))
+        {
+            status = *copied
+                     ? 0
+                     : (m_stopRequested.load(std::memory_order_relaxed)
+                        ? -1
+                        : 1);
+        } else {
+            sword::SWMgr lMgr(m_destination.toLatin1());
+            status = m_iMgr.installModule(&lMgr,
                                           installSource.directory.c_str(),
                                           module->name().toLatin1());
+        }
         if (status == 0) {
             Q_EMIT statusUpdated(m_currentModuleIndex, 100);
         } else if (status != -1) {
@@ -103,7 +356,168 @@ void BtInstallThread::installModule() {
                        << "module:" << module->name();
         }
         Q_EMIT installCompleted(m_currentModuleIndex, status == 0);
+        if (status == 0 && m_indexAfterInstall)
+            scheduleIndexing(module->name());
+    }
+}
+
+void BtInstallThread::installDownloadedModule(QString const & stagingPath) {
+    auto const i = static_cast<std::size_t>(m_currentModuleIndex);
+    Download download;
+    {
+        std::unique_lock<std::mutex> lock(m_downloadMutex);
+        m_downloadCondition.wait(
+                    lock,
+                    [this, i] {
+                        switch (m_downloads[i]) {
+                        case Download::Pending:
+                            return m_stopRequested.load(
+                                        std::memory_order_relaxed);
+                        case Download::Running:
+                            return false;
+                        default:
+                            return true;
+                        }
+                    });
+        download = m_downloads[i];
+    }
+    if (download == Download::Pending) // Skipped, since stopped
+        return;
+
+    auto const & moduleName = m_moduleNames[m_currentModuleIndex];
+    auto const moduleDir(QDir(stagingPath).filePath(QString::number(
+                                                        m_currentModuleIndex)));
+    int status = -1;
+    if (download == Download::Succeeded) {
+        // Check whether it's an update. If yes, remove existing module first:
+        removeModule();
+
+        sword::SWMgr lMgr(m_destination.toLatin1());
+        status = m_iMgr.installModule(&lMgr,
+                                      moduleDir.toLocal8Bit().constData(),
+                                      moduleName.toLatin1());
+        if (status == 0) {
+            Q_EMIT statusUpdated(m_currentModuleIndex, 100);
+        } else {
+            qWarning() << "Error with install: " << status
+                       << "module:" << moduleName;
+        }
+    }
+    QDir(moduleDir).removeRecursively();
+    Q_EMIT installCompleted(m_currentModuleIndex, status == 0);
+    if (status == 0 && m_indexAfterInstall)
+        scheduleIndexing(moduleName);
+}
+
+std::optional<bool> BtInstallThread::copyLocalModule(
+        QString const & sourceDir)
+{
+    auto const moduleIndex = m_currentModuleIndex;
+    auto const module(findLocalModule(sourceDir,
+                                      m_moduleNames[moduleIndex]));
+    if (!module)
+        return {};
+
+    struct File {
+        QString from;
+        QString to;
+        qint64 size;
+        bool written = false; ///< Whether copying the file was started
+    };
+    std::vector<File> files;
+    qint64 totalSize = 0;
+    QDir const source(sourceDir);
+    QDir const destination(m_destination);
+    for (QDirIterator it(source.filePath(module->dataDir),
+                         QDir::Files | QDir::Hidden,
+                         QDirIterator::Subdirectories);
+         it.hasNext();)
+    {
+        auto const info = it.nextFileInfo();
+        auto const relativePath(
+                    source.relativeFilePath(info.absoluteFilePath()));
+        if (!destination.mkpath(QFileInfo(relativePath).path()))
+            return false;
+        files.emplace_back(File{info.absoluteFilePath(),
+                                destination.filePath(relativePath),
+                                info.size()});
+        totalSize += info.size();
+    }
+    if (files.empty()) // Let InstallMgr report the missing data
+        return {};
+
+    std::atomic<std::size_t> nextFile{0u};
+    std::atomic<qint64> copiedSize{0};
+    std::atomic<bool> failed{false};
+    auto const copyFiles =
+            [&] {
+                for (auto i = nextFile.fetch_add(1u);
+                     i < files.size()
+                     && !failed.load(std::memory_order_relaxed)
+                     && !m_stopRequested.load(std::memory_order_relaxed);
+                     i = nextFile.fetch_add(1u))
+                {
+                    auto & file = files[i];
+                    file.written = true;
+                    if (!copyFile(file.from, file.to)) {
+                        qWarning() << "Failed to copy" << file.from;
+                        failed.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                    auto const copied = copiedSize.fetch_add(file.size)
+                                        + file.size;
+                    Q_EMIT statusUpdated(
+                            moduleIndex,
+                            static_cast<int>(
+                                (100 * copied)
+                                / std::max(totalSize, static_cast<qint64>(1))));
+                }
+            };
+    std::vector<std::unique_ptr<QThread>> copiers;
+    for (std::size_t i = 1u;
+         i < std::min(files.size(), BT_MAX_CONCURRENT_COPIES);
+         ++i)
+    {
+        copiers.emplace_back(QThread::create(copyFiles));
+        copiers.back()->start();
+    }
+    copyFiles();
+    for (auto const & copier : copiers)
+        copier->wait();
+
+    // The module is only found in the destination once its conf is there:
+    if (!failed.load(std::memory_order_relaxed)
+        && !m_stopRequested.load(std::memory_order_relaxed)
+        && copyFile(module->confFile,
+                    destination.filePath(
+                        QStringLiteral("mods.d/%1").arg(
+                            QFileInfo(module->confFile).fileName()))))
+        return true;
+
+    /* The data directory of modules whose data path is a file name prefix
+       might be shared with other modules, hence only the files written here
+       and the directories left empty are removed: */
+    auto const dataDir(QDir::cleanPath(destination.filePath(module->dataDir)));
+    QStringList directories;
+    for (auto const & file : files) {
+        if (!file.written)
+            continue;
+        QFile::remove(file.to);
+        auto const directory(QDir::cleanPath(QFileInfo(file.to).path()));
+        if (!directories.contains(directory))
+            directories.append(directory);
     }
+    // Remove the deepest directories first:
+    std::sort(directories.begin(),
+              directories.end(),
+              [](QString const & a, QString const & b)
+              { return a.size() > b.size(); });
+    for (auto directory : std::as_const(directories))
+        while ((directory == dataDir
+                || directory.startsWith(dataDir + QLatin1Char('/')))
+               && QDir().rmdir(directory)) // Fails unless empty
+            directory = QFileInfo(directory).path();
+    return false;
 }
 
 void BtInstallThread::slotManagerStatusUpdated(int totalProgress, int /*fileProgress*/) {
@@ -15,11 +15,17 @@
 #include <QThread>
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <Qt>
+#include <vector>
 #include "btinstallmgr.h"
+#include "config/btconfig.h"
 #include "../util/btconnect.h"
 
 
@@ -37,6 +43,10 @@ class BtInstallThread: public QThread {
             : QThread(parent)
             , m_modules(modules)
             , m_destination(destination)
+            , m_indexAfterInstall(
+                  btConfig().value<bool>(
+                      QStringLiteral("settings/behaviour/indexAfterInstall"),
+                      false))
             , m_stopRequested(false)
         {
             BT_CONNECT(&m_iMgr, &BtInstallMgr::percentCompleted,
@@ -68,9 +78,33 @@ class BtInstallThread: public QThread {
 
         void run() override;
 
+    private: // types:
+
+        enum class Download { None, Pending, Running, Succeeded, Failed };
+
     private: // methods:
 
-        void installModule();
+        /**
+          \brief Downloads the pending modules from remote sources into
+                 subdirectories of the given staging directory.
+
+          Several threads run this concurrently, whereas the downloaded modules
+          are installed to the destination one after another by run().
+        */
+        void downloadModules(QString const & stagingPath);
+
+        void installModule(QString const & stagingPath);
+        void installDownloadedModule(QString const & stagingPath);
+
+        /**
+          \brief Installs the current module from the given local source by
+                 copying its conf file and data directory to the destination,
+                 several files at once.
+          \returns whether the module was copied, or nothing if it can not be
+                   installed this way and needs sword::InstallMgr.
+        */
+        std::optional<bool> copyLocalModule(QString const & sourceDir);
+
         bool removeModule();
 
     private Q_SLOTS:
@@ -84,6 +118,14 @@ class BtInstallThread: public QThread {
         const QString m_destination;
         BtInstallMgr m_iMgr;
         int m_currentModuleIndex = 0;
+        bool const m_indexAfterInstall;
         std::atomic<bool> m_stopRequested;
 
+        QStringList m_moduleNames;
+        QStringList m_sourceNames;
+        std::mutex m_downloadMutex;
+        std::condition_variable m_downloadCondition;
+        std::vector<Download> m_downloads;
+        std::size_t m_nextDownload = 0u;
+
 };
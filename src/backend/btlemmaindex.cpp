@@ -0,0 +1,248 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btlemmaindex.h"
+
+#include <algorithm>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+#include <QStringList>
+#include <utility>
+
+
+//Increment this, if the file format changes
+constexpr static quint32 const BT_LEMMA_INDEX_VERSION = 1u;
+
+namespace {
+
+void finishPostings(BtLemmaIndex::Postings & postings) {
+    if (!std::is_sorted(postings.begin(), postings.end()))
+        std::sort(postings.begin(), postings.end());
+    postings.erase(std::unique(postings.begin(), postings.end()),
+                   postings.end());
+    postings.shrink_to_fit();
+}
+
+void removeFromPostings(BtLemmaIndex::Postings & postings,
+                        BtLemmaIndex::Postings const & sortedVerseIndices)
+{
+    postings.erase(
+                std::remove_if(
+                    postings.begin(),
+                    postings.end(),
+                    [&sortedVerseIndices](std::uint32_t const verseIndex) {
+                        return std::binary_search(sortedVerseIndices.begin(),
+                                                  sortedVerseIndices.end(),
+                                                  verseIndex);
+                    }),
+                postings.end());
+}
+
+void writePostings(QDataStream & s, BtLemmaIndex::Postings const & postings) {
+    s << static_cast<quint32>(postings.size());
+    for (auto const verseIndex : postings)
+        s << static_cast<quint32>(verseIndex);
+}
+
+bool readPostings(QDataStream & s, BtLemmaIndex::Postings & postings) {
+    quint32 size;
+    s >> size;
+    if (s.status() != QDataStream::Ok)
+        return false;
+    postings.resize(size);
+    for (auto & verseIndex : postings) {
+        quint32 v;
+        s >> v;
+        verseIndex = v;
+    }
+    return s.status() == QDataStream::Ok;
+}
+
+} // anonymous namespace
+
+void BtLemmaIndex::add(Kind const kind,
+                       QString const & value,
+                       std::uint32_t const verseIndex,
+                       QString const & wordText)
+{
+    static QRegularExpression const spaceRe(QStringLiteral("\\s+"));
+    for (auto const & part : value.split(spaceRe, Qt::SkipEmptyParts)) {
+        // Lemmas of other kinds, e.g. "lemma.TR:...", are no Strong's numbers:
+        if (kind == Kind::Lemma) {
+            auto const colon = part.lastIndexOf(':');
+            if (colon >= 0
+                && !part.left(colon).endsWith(QStringLiteral("strong"),
+                                              Qt::CaseInsensitive))
+                continue;
+        }
+        auto term(normalizedTerm(kind, part));
+        if (term.isEmpty())
+            continue;
+        if (kind == Kind::Lemma && !wordText.isEmpty())
+            m_lemmaTexts[term][wordText].push_back(verseIndex);
+        m_terms[static_cast<int>(kind)][std::move(term)].push_back(verseIndex);
+    }
+}
+
+void BtLemmaIndex::remove(std::vector<std::uint32_t> verseIndices) {
+    if (verseIndices.empty())
+        return;
+    std::sort(verseIndices.begin(), verseIndices.end());
+    for (auto & terms : m_terms)
+        for (auto & postings : terms)
+            removeFromPostings(postings, verseIndices);
+    for (auto & texts : m_lemmaTexts)
+        for (auto & postings : texts)
+            removeFromPostings(postings, verseIndices);
+}
+
+void BtLemmaIndex::merge(BtLemmaIndex const & other) {
+    for (int i = 0; i < 2; ++i) {
+        for (auto it = other.m_terms[i].cbegin();
+             it != other.m_terms[i].cend();
+             ++it)
+        {
+            auto & postings = m_terms[i][it.key()];
+            postings.insert(postings.end(), it->begin(), it->end());
+        }
+    }
+    for (auto it = other.m_lemmaTexts.cbegin();
+         it != other.m_lemmaTexts.cend();
+         ++it)
+    {
+        auto & texts = m_lemmaTexts[it.key()];
+        for (auto jt = it->cbegin(); jt != it->cend(); ++jt) {
+            auto & postings = texts[jt.key()];
+            postings.insert(postings.end(), jt->begin(), jt->end());
+        }
+    }
+}
+
+void BtLemmaIndex::finish() {
+    for (auto & terms : m_terms) {
+        for (auto & postings : terms)
+            finishPostings(postings);
+        terms.removeIf([](auto const & it) { return it.value().empty(); });
+    }
+    for (auto & texts : m_lemmaTexts) {
+        for (auto & postings : texts)
+            finishPostings(postings);
+        texts.removeIf([](auto const & it) { return it.value().empty(); });
+    }
+    m_lemmaTexts.removeIf([](auto const & it) { return it.value().isEmpty(); });
+}
+
+BtLemmaIndex::Postings const *
+BtLemmaIndex::postings(Kind const kind, QString const & term) const {
+    auto const & terms = m_terms[static_cast<int>(kind)];
+    auto const it = terms.constFind(normalizedTerm(kind, term));
+    return (it != terms.cend()) ? &*it : nullptr;
+}
+
+QHash<QString, BtLemmaIndex::Postings>
+BtLemmaIndex::wordTexts(QString const & lemma) const
+{ return m_lemmaTexts.value(normalizedTerm(Kind::Lemma, lemma)); }
+
+QString BtLemmaIndex::normalizedTerm(Kind const kind, QString term) {
+    // Strip prefixes like "strong:" or "robinson:":
+    if (auto const colon = term.lastIndexOf(':'); colon >= 0)
+        term.remove(0, colon + 1);
+    if (kind == Kind::Morph)
+        return term;
+
+    // Strip leading zeros of Strong's numbers, e.g. "H0430" becomes "H430":
+    term = term.toUpper();
+    static QRegularExpression const strongsRe(
+                QStringLiteral("^([A-Z]+)0*(\\d+)(.*)$"));
+    if (auto const match = strongsRe.match(term); match.hasMatch())
+        return match.captured(1) + match.captured(2) + match.captured(3);
+    return term;
+}
+
+std::optional<BtLemmaIndex> BtLemmaIndex::load(QString const & fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    quint32 version;
+    s >> version;
+    if (s.status() != QDataStream::Ok || version != BT_LEMMA_INDEX_VERSION)
+        return {};
+
+    BtLemmaIndex r;
+    for (auto & terms : r.m_terms) {
+        quint32 numTerms;
+        s >> numTerms;
+        for (quint32 i = 0u; i < numTerms && s.status() == QDataStream::Ok; ++i)
+        {
+            QString term;
+            s >> term;
+            if (!readPostings(s, terms[term]))
+                return {};
+        }
+    }
+    quint32 numLemmas;
+    s >> numLemmas;
+    for (quint32 i = 0u; i < numLemmas && s.status() == QDataStream::Ok; ++i) {
+        QString lemma;
+        quint32 numTexts;
+        s >> lemma >> numTexts;
+        auto & texts = r.m_lemmaTexts[lemma];
+        for (quint32 j = 0u; j < numTexts && s.status() == QDataStream::Ok; ++j)
+        {
+            QString text;
+            s >> text;
+            if (!readPostings(s, texts[text]))
+                return {};
+        }
+    }
+    if (s.status() != QDataStream::Ok)
+        return {};
+    return r;
+}
+
+bool BtLemmaIndex::save(QString const & fileName) const {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write" << file.fileName();
+        return false;
+    }
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    s << BT_LEMMA_INDEX_VERSION;
+    for (auto const & terms : m_terms) {
+        s << static_cast<quint32>(terms.size());
+        for (auto it = terms.cbegin(); it != terms.cend(); ++it) {
+            s << it.key();
+            writePostings(s, *it);
+        }
+    }
+    s << static_cast<quint32>(m_lemmaTexts.size());
+    for (auto it = m_lemmaTexts.cbegin(); it != m_lemmaTexts.cend(); ++it) {
+        s << it.key() << static_cast<quint32>(it->size());
+        for (auto jt = it->cbegin(); jt != it->cend(); ++jt) {
+            s << jt.key();
+            writePostings(s, *jt);
+        }
+    }
+    file.close();
+    if (s.status() != QDataStream::Ok) {
+        file.remove();
+        return false;
+    }
+    return true;
+}
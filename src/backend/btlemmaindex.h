@@ -0,0 +1,102 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <QHash>
+#include <QString>
+#include <vector>
+
+
+/**
+  \brief An inverted index from Strong's numbers and morphological codes to the
+         verse indices of the entries they occur in.
+
+  The index is built from the "Word" entry attributes of verse keyed modules
+  alongside their search index. For Strong's numbers, it also keeps the verse
+  indices per word text (i.e. per translation of the lemma), if the module
+  provides the word texts in its entry attributes.
+
+  Terms are normalized by normalizedTerm(), so that e.g. "strong:H0430" and
+  "H430" refer to the same lemma.
+*/
+class BtLemmaIndex {
+
+public: // types:
+
+    enum class Kind : std::uint8_t {
+        Lemma,
+        Morph
+    };
+
+    /** Sorted verse indices without duplicates. */
+    using Postings = std::vector<std::uint32_t>;
+
+public: // methods:
+
+    /**
+      \brief Adds the given attribute value to the index.
+      \param[in] kind The kind of the attribute value.
+      \param[in] value The attribute value, possibly a space separated list of
+                       terms with prefixes like "strong:".
+      \param[in] verseIndex The verse index of the entry.
+      \param[in] wordText The text of the word in the entry, if known.
+    */
+    void add(Kind kind,
+             QString const & value,
+             std::uint32_t verseIndex,
+             QString const & wordText = QString());
+
+    /** \brief Removes the given entries from all postings. */
+    void remove(std::vector<std::uint32_t> verseIndices);
+
+    /** \brief Adds the contents of the given index to this one. */
+    void merge(BtLemmaIndex const & other);
+
+    /**
+      \brief Sorts all postings and removes duplicates. Needs to be called
+             after adding entries and before looking up or saving the index.
+    */
+    void finish();
+
+    bool isEmpty() const noexcept
+    { return m_terms[0].isEmpty() && m_terms[1].isEmpty(); }
+
+    /**
+      \returns the postings of the given term, or nullptr if the term does not
+               occur in the module.
+    */
+    Postings const * postings(Kind kind, QString const & term) const;
+
+    /**
+      \returns the postings of the given Strong's number per word text, which
+               is empty if no word texts were known.
+    */
+    QHash<QString, Postings> wordTexts(QString const & lemma) const;
+
+    /** \returns the normalized form of the given single term. */
+    static QString normalizedTerm(Kind kind, QString term);
+
+    /** \returns the index stored in the given file, if it is valid. */
+    static std::optional<BtLemmaIndex> load(QString const & fileName);
+
+    /** \returns whether the index was saved to the given file. */
+    bool save(QString const & fileName) const;
+
+private: // fields:
+
+    QHash<QString, Postings> m_terms[2];
+    QHash<QString, QHash<QString, Postings>> m_lemmaTexts;
+
+}; /* class BtLemmaIndex */
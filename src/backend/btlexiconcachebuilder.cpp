@@ -0,0 +1,107 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btlexiconcachebuilder.h"
+
+#include <algorithm>
+#include <QDebug>
+#include <QString>
+#include <QThread>
+#include "drivers/cswordlexiconmoduleinfo.h"
+#include "drivers/cswordmoduleinfo.h"
+#include "managers/cswordbackend.h"
+
+
+BtLexiconCacheBuilder::BtLexiconCacheBuilder(QObject * const parent)
+    : QObject(parent)
+{}
+
+BtLexiconCacheBuilder::~BtLexiconCacheBuilder() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+    }
+    for (auto const & thread : m_threads)
+        thread->wait();
+}
+
+void BtLexiconCacheBuilder::buildCaches(QStringList const & moduleNames,
+                                        bool const first)
+{
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (m_stopping)
+        return;
+    if (first) {
+        for (auto it = moduleNames.crbegin(); it != moduleNames.crend(); ++it) {
+            m_queue.removeAll(*it);
+            m_queue.prepend(*it);
+        }
+    } else {
+        for (auto const & moduleName : moduleNames)
+            if (!m_queue.contains(moduleName))
+                m_queue.append(moduleName);
+    }
+
+    // Clean up finished threads:
+    m_threads.erase(
+                std::remove_if(m_threads.begin(),
+                               m_threads.end(),
+                               [](std::unique_ptr<QThread> const & thread)
+                               { return thread->isFinished(); }),
+                m_threads.end());
+
+    // Use the spare cores, leaving one to the GUI thread:
+    auto const maxThreads =
+            static_cast<std::size_t>(
+                std::max(QThread::idealThreadCount() - 1, 1));
+    while (m_runningThreads < std::min(maxThreads,
+                                       static_cast<std::size_t>(
+                                           m_queue.size())))
+    {
+        ++m_runningThreads;
+        m_threads.emplace_back(QThread::create([this]{ work(); }));
+        m_threads.back()->start(QThread::LowestPriority);
+    }
+}
+
+void BtLexiconCacheBuilder::work() {
+    // The modules of the regular backend are used by the GUI thread meanwhile:
+    std::unique_ptr<CSwordBackend> backend;
+    for (;;) {
+        QString moduleName;
+        {
+            std::lock_guard<std::mutex> const guard(m_mutex);
+            if (m_stopping || m_queue.isEmpty()) {
+                --m_runningThreads;
+                return;
+            }
+            moduleName = m_queue.takeFirst();
+        }
+
+        if (!backend)
+            backend = CSwordBackend::createWorkerInstance();
+        auto const * module = backend->findModuleByName(moduleName);
+        if (!module || module->type() != CSwordModuleInfo::Lexicon) {
+            // The module might have been installed after creating the backend:
+            backend = CSwordBackend::createWorkerInstance();
+            module = backend->findModuleByName(moduleName);
+            if (!module || module->type() != CSwordModuleInfo::Lexicon) {
+                qDebug() << "Lexicon" << moduleName
+                         << "not found for building its cache.";
+                continue;
+            }
+        }
+        static_cast<CSwordLexiconModuleInfo const *>(module)->entries();
+        Q_EMIT cacheBuilt(moduleName);
+    }
+}
@@ -0,0 +1,72 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QObject>
+
+#include <memory>
+#include <mutex>
+#include <QStringList>
+#include <vector>
+
+
+class QThread;
+
+/**
+  \brief Builds the key caches of lexicon modules in background threads.
+
+  Building the cache walks through all entries of a lexicon, which would
+  otherwise block its first use by CSwordLexiconModuleInfo::entries(). Every
+  thread uses its own CSwordBackend (see CSwordBackend::createWorkerInstance())
+  and builds the caches by loading the entries of its module instances. The
+  threads run at the lowest priority, leaving one core to the GUI thread.
+*/
+class BtLexiconCacheBuilder: public QObject {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtLexiconCacheBuilder(QObject * parent = nullptr);
+    ~BtLexiconCacheBuilder() override;
+
+    /**
+      \brief Queues the given lexicon modules for building their caches unless
+             already queued.
+      \param[in] moduleNames The names of the lexicon modules.
+      \param[in] first Whether to build the given caches before the ones
+                       queued already, e.g. because a window waits for them.
+    */
+    void buildCaches(QStringList const & moduleNames, bool first = false);
+
+Q_SIGNALS:
+
+    /**
+      \brief Emitted by the building thread after the cache of the given module
+             was built.
+    */
+    void cacheBuilt(QString const & moduleName);
+
+private: // methods:
+
+    void work();
+
+private: // fields:
+
+    std::mutex m_mutex;
+    QStringList m_queue;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+    std::size_t m_runningThreads = 0u;
+    bool m_stopping = false;
+
+}; /* class BtLexiconCacheBuilder */
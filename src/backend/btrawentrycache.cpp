@@ -0,0 +1,87 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btrawentrycache.h"
+
+#include <algorithm>
+#include <QChar>
+#include "config/btconfig.h"
+
+
+BtRawEntryCache::BtRawEntryCache() {
+    auto const sizeInKiB =
+            btConfig().value<int>(
+                QStringLiteral("settings/behaviour/rawEntryCacheSize"),
+                defaultSizeInKiB);
+    m_entries.setMaxCost(static_cast<qsizetype>(std::max(sizeInKiB, 0))
+                         * 1024);
+}
+
+BtRawEntryCache & BtRawEntryCache::instance() {
+    static BtRawEntryCache cache;
+    return cache;
+}
+
+QString BtRawEntryCache::cacheKey(QString const & moduleName,
+                                  QByteArray const & key)
+{ return moduleName + QChar(u'\x1f') + QString::fromUtf8(key); }
+
+QByteArray BtRawEntryCache::entry(QString const & moduleName,
+                                  QByteArray const & key,
+                                  std::function<QByteArray()> const & read)
+{
+    auto const k(cacheKey(moduleName, key));
+    {
+        std::lock_guard const guard(m_mutex);
+        if (m_entries.maxCost() <= 0)
+            return read();
+        if (auto const * const cached = m_entries.object(k)) {
+            ++m_hits;
+            return *cached;
+        }
+        ++m_misses;
+    }
+
+    /* The entry is read without holding the lock of the cache, since reading
+       Sword modules is locked by CSwordBackend::lockSwordFiles() instead: */
+    auto entry(read());
+    {
+        std::lock_guard const guard(m_mutex);
+        m_entries.insert(k,
+                         new QByteArray(entry),
+                         std::max(entry.size(), qsizetype(1)));
+    }
+    return entry;
+}
+
+void BtRawEntryCache::removeModule(QString const & moduleName) {
+    auto const prefix(moduleName + QChar(u'\x1f'));
+    std::lock_guard const guard(m_mutex);
+    for (auto const & k : m_entries.keys())
+        if (k.startsWith(prefix))
+            m_entries.remove(k);
+}
+
+void BtRawEntryCache::clear() {
+    std::lock_guard const guard(m_mutex);
+    m_entries.clear();
+}
+
+std::uint64_t BtRawEntryCache::hits() const {
+    std::lock_guard const guard(m_mutex);
+    return m_hits;
+}
+
+std::uint64_t BtRawEntryCache::misses() const {
+    std::lock_guard const guard(m_mutex);
+    return m_misses;
+}
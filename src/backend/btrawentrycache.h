@@ -0,0 +1,85 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <QByteArray>
+#include <QCache>
+#include <QString>
+
+
+/**
+  \brief A cache of the raw, i.e. decompressed and deciphered, entries of
+         modules which is shared by all backends and threads.
+
+  Sword only keeps the most recently decompressed block of each module object,
+  which is evicted whenever another consumer of the same module reads another
+  part of it. Since the cache is keyed by the names of the modules, the worker
+  backends of render contexts share the entries with the regular backend.
+
+  The size of the cache is set by "settings/behaviour/rawEntryCacheSize" in
+  KiB, zero disables it.
+*/
+class BtRawEntryCache {
+
+public: // fields:
+
+    /** The default size of the cache in KiB. */
+    constexpr static int const defaultSizeInKiB = 4096;
+
+public: // methods:
+
+    BtRawEntryCache(BtRawEntryCache const &) = delete;
+    BtRawEntryCache & operator=(BtRawEntryCache const &) = delete;
+
+    /** \returns the cache shared by all backends. */
+    static BtRawEntryCache & instance();
+
+    /**
+      \returns the cached raw entry of the given key of the given module, which
+               is read by the given function and cached unless already cached.
+      \param[in] key The text of the key as set to the Sword module.
+    */
+    QByteArray entry(QString const & moduleName,
+                     QByteArray const & key,
+                     std::function<QByteArray()> const & read);
+
+    /** \brief Drops the cached entries of the given module. */
+    void removeModule(QString const & moduleName);
+
+    /** \brief Drops all cached entries, e.g. after reloading the modules. */
+    void clear();
+
+    /** \returns the number of lookups which found a cached entry. */
+    std::uint64_t hits() const;
+
+    /** \returns the number of lookups which had to read the entry. */
+    std::uint64_t misses() const;
+
+private: // methods:
+
+    BtRawEntryCache();
+
+    static QString cacheKey(QString const & moduleName,
+                            QByteArray const & key);
+
+private: // fields:
+
+    mutable std::mutex m_mutex;
+    QCache<QString, QByteArray> m_entries; ///< With costs in bytes
+    std::uint64_t m_hits = 0u;
+    std::uint64_t m_misses = 0u;
+
+}; /* class BtRawEntryCache */
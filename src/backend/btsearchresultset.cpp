@@ -0,0 +1,181 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#include "btsearchresultset.h"
+
+#include <memory>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QIODevice>
+#include <utility>
+#include "../util/directory.h"
+#include "drivers/cswordmoduleinfo.h"
+#include "managers/cswordbackend.h"
+
+// Sword includes:
+#include <swkey.h>
+#include <swmodule.h>
+#include <versekey.h>
+
+
+//Increment this, if the file format changes
+constexpr static quint32 const BT_SEARCH_RESULT_SET_VERSION = 1u;
+
+BtSearchResultSet::BtSearchResultSet(
+        QString searchText,
+        QString scopeName,
+        CSwordModuleSearch::Results const & results)
+    : m_searchText(std::move(searchText))
+    , m_scopeName(std::move(scopeName))
+    , m_searchTime(QDateTime::currentDateTimeUtc())
+{
+    m_moduleResults.reserve(results.size());
+    for (auto const & result : results) {
+        auto const complete(result.results.complete());
+        auto const verseIndices = complete.verseIndices();
+        ModuleResult moduleResult{result.module->name(),
+                                  result.module->indexStamp(),
+                                  !verseIndices.empty(),
+                                  {verseIndices.begin(), verseIndices.end()},
+                                  {}};
+        moduleResult.keyTexts.reserve(complete.keyTexts().size());
+        for (auto const & keyText : complete.keyTexts())
+            moduleResult.keyTexts.emplace_back(
+                        QByteArray::fromStdString(keyText));
+        m_moduleResults.emplace_back(std::move(moduleResult));
+    }
+}
+
+CSwordModuleSearch::Results BtSearchResultSet::results() const {
+    CSwordModuleSearch::Results r;
+    r.reserve(m_moduleResults.size());
+    for (auto const & moduleResult : m_moduleResults) {
+        auto const * const module =
+                CSwordBackend::instance().findModuleByName(
+                    moduleResult.moduleName);
+        if (!module)
+            continue;
+        std::unique_ptr<sword::SWKey> key(module->swordModule().createKey());
+        auto * const vk = dynamic_cast<sword::VerseKey *>(key.get());
+        if (vk)
+            vk->setIntros(true);
+        CSwordModuleSearch::ModuleResultList results(*key);
+        if (vk) {
+            for (auto const verseIndex : moduleResult.verseIndices) {
+                vk->setIndex(verseIndex);
+                results.append(*vk);
+            }
+        } else {
+            for (auto const & keyText : moduleResult.keyTexts) {
+                key->setText(keyText.constData());
+                results.append(*key);
+            }
+        }
+        r.emplace_back(
+                CSwordModuleSearch::ModuleSearchResult{module,
+                                                       std::move(results)});
+    }
+    return r;
+}
+
+bool BtSearchResultSet::isStale() const {
+    for (auto const & moduleResult : m_moduleResults) {
+        auto const * const module =
+                CSwordBackend::instance().findModuleByName(
+                    moduleResult.moduleName);
+        if (!module || module->indexStamp() != moduleResult.indexStamp)
+            return true;
+    }
+    return false;
+}
+
+bool BtSearchResultSet::save(QString const & fileName) const {
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write" << file.fileName();
+        return false;
+    }
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    s << BT_SEARCH_RESULT_SET_VERSION << m_searchText << m_scopeName
+      << m_searchTime << static_cast<quint32>(m_moduleResults.size());
+    for (auto const & moduleResult : m_moduleResults) {
+        s << moduleResult.moduleName << moduleResult.indexStamp
+          << moduleResult.verseBased;
+        if (moduleResult.verseBased) {
+            s << static_cast<quint32>(moduleResult.verseIndices.size());
+            for (auto const verseIndex : moduleResult.verseIndices)
+                s << static_cast<quint32>(verseIndex);
+        } else {
+            s << static_cast<quint32>(moduleResult.keyTexts.size());
+            for (auto const & keyText : moduleResult.keyTexts)
+                s << keyText;
+        }
+    }
+    file.close();
+    if (s.status() != QDataStream::Ok) {
+        file.remove();
+        return false;
+    }
+    return true;
+}
+
+std::optional<BtSearchResultSet>
+BtSearchResultSet::load(QString const & fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    quint32 version;
+    s >> version;
+    if (s.status() != QDataStream::Ok
+        || version != BT_SEARCH_RESULT_SET_VERSION)
+        return {};
+
+    BtSearchResultSet r;
+    quint32 numModules;
+    s >> r.m_searchText >> r.m_scopeName >> r.m_searchTime >> numModules;
+    for (quint32 i = 0u; i < numModules && s.status() == QDataStream::Ok; ++i)
+    {
+        ModuleResult moduleResult;
+        quint32 size;
+        s >> moduleResult.moduleName >> moduleResult.indexStamp
+          >> moduleResult.verseBased >> size;
+        if (s.status() != QDataStream::Ok)
+            return {};
+        if (moduleResult.verseBased) {
+            moduleResult.verseIndices.resize(size);
+            for (auto & verseIndex : moduleResult.verseIndices) {
+                quint32 v;
+                s >> v;
+                verseIndex = v;
+            }
+        } else {
+            moduleResult.keyTexts.resize(size);
+            for (auto & keyText : moduleResult.keyTexts)
+                s >> keyText;
+        }
+        r.m_moduleResults.emplace_back(std::move(moduleResult));
+    }
+    if (s.status() != QDataStream::Ok)
+        return {};
+    return r;
+}
+
+QString BtSearchResultSet::defaultDirectory() {
+    return util::directory::getUserBaseDir().absoluteFilePath(
+                QStringLiteral("searchresults"));
+}
@@ -0,0 +1,96 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <vector>
+#include "cswordmodulesearch.h"
+
+
+/**
+  \brief A set of search results which can be saved to a binary file and
+         loaded again, so that expensive searches need not be repeated.
+
+  Besides the keys of the hits, i.e. verse indices for verse based modules, a
+  set records the search text, the name of the search scope and the index
+  stamp (see CSwordModuleInfo::indexStamp()) of every searched module. A set
+  whose modules were indexed again since is stale, see isStale().
+*/
+class BtSearchResultSet {
+
+public: // types:
+
+    struct ModuleResult {
+        QString moduleName;
+        QString indexStamp;
+        bool verseBased;
+        std::vector<std::uint32_t> verseIndices;
+        std::vector<QByteArray> keyTexts;
+    };
+
+public: // methods:
+
+    /**
+      \param[in] searchText The search text as entered by the user.
+      \param[in] scopeName The name of the search scope, if any.
+      \param[in] results The results, whose pending hits are fetched.
+    */
+    BtSearchResultSet(QString searchText,
+                      QString scopeName,
+                      CSwordModuleSearch::Results const & results);
+
+    QString const & searchText() const noexcept { return m_searchText; }
+    QString const & scopeName() const noexcept { return m_scopeName; }
+    QDateTime const & searchTime() const noexcept { return m_searchTime; }
+
+    std::vector<ModuleResult> const & moduleResults() const noexcept
+    { return m_moduleResults; }
+
+    /**
+      \returns the results of the modules which are installed, in the order
+               they were searched in.
+    */
+    CSwordModuleSearch::Results results() const;
+
+    /**
+      \returns whether any of the modules is no longer installed or its index
+               changed since the results were found.
+    */
+    bool isStale() const;
+
+    /** \returns whether the set was saved successfully. */
+    bool save(QString const & fileName) const;
+
+    /** \returns the set loaded from the given file, if successful. */
+    static std::optional<BtSearchResultSet> load(QString const & fileName);
+
+    /** \returns the directory to save sets in by default. */
+    static QString defaultDirectory();
+
+private: // methods:
+
+    BtSearchResultSet() = default;
+
+private: // fields:
+
+    QString m_searchText;
+    QString m_scopeName;
+    QDateTime m_searchTime;
+    std::vector<ModuleResult> m_moduleResults;
+
+}; /* class BtSearchResultSet */
@@ -0,0 +1,123 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btsearchthread.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "drivers/cswordmoduleinfo.h"
+
+
+namespace {
+
+// The searches not yet deleted, see BtSearchThread::stopAllSearches():
+std::mutex searchesMutex;
+std::vector<BtSearchThread *> searches;
+
+} // anonymous namespace
+
+BtSearchThread::BtSearchThread(QString searchText,
+                               BtConstModuleList modules,
+                               sword::ListKey scope,
+                               QObject * const parent)
+    : QThread(parent)
+    , m_searchText(std::move(searchText))
+    , m_modules(std::move(modules))
+    , m_scope(std::move(scope))
+{
+    std::lock_guard<std::mutex> const guard(searchesMutex);
+    searches.push_back(this);
+}
+
+BtSearchThread::~BtSearchThread() {
+    {
+        std::lock_guard<std::mutex> const guard(searchesMutex);
+        searches.erase(std::find(searches.begin(), searches.end(), this));
+    }
+    stopSearch();
+    wait();
+}
+
+void BtSearchThread::stopAllSearches() {
+    /* The searches are deleted by the GUI thread only, hence they are not
+       deleted while waiting for them: */
+    decltype(searches) running;
+    {
+        std::lock_guard<std::mutex> const guard(searchesMutex);
+        running = searches;
+    }
+    for (auto * const search : running)
+        search->stopSearch();
+    for (auto * const search : running)
+        search->wait();
+}
+
+void BtSearchThread::run() {
+    try {
+        auto const emitResults =
+                [this](std::size_t const moduleIndex,
+                       CSwordModuleSearch::ModuleResultList results)
+                {
+                    if (!m_cancellation.cancelled())
+                        Q_EMIT moduleSearched(static_cast<int>(moduleIndex),
+                                              std::move(results));
+                };
+        if (!m_scanQuery) {
+            CSwordModuleSearch::search(m_searchText,
+                                       m_modules,
+                                       m_scope,
+                                       emitResults,
+                                       m_cancellation);
+            return;
+        }
+
+        // Scan the modules without an index, and search the others as usual:
+        BtConstModuleList indexedModules;
+        std::vector<std::size_t> indexedModuleIndices;
+        for (qsizetype i = 0; i < m_modules.size(); ++i) {
+            auto const & module = *m_modules.at(i);
+            auto const moduleIndex = static_cast<std::size_t>(i);
+            if (module.hasIndex()) {
+                indexedModules.append(&module);
+                indexedModuleIndices.push_back(moduleIndex);
+                continue;
+            }
+            emitResults(moduleIndex,
+                        CSwordModuleSearch::scanModule(module,
+                                                       *m_scanQuery,
+                                                       m_scope,
+                                                       m_cancellation));
+            if (m_cancellation.cancelled())
+                return;
+        }
+        if (!indexedModules.isEmpty())
+            CSwordModuleSearch::search(
+                        m_searchText,
+                        indexedModules,
+                        m_scope,
+                        [&](std::size_t const moduleIndex,
+                            CSwordModuleSearch::ModuleResultList results)
+                        {
+                            emitResults(indexedModuleIndices[moduleIndex],
+                                        std::move(results));
+                        },
+                        m_cancellation);
+    } catch (std::exception const & e) {
+        Q_EMIT searchFailed(QString::fromUtf8(e.what()));
+    } catch (...) {
+        Q_EMIT searchFailed(tr("<UNKNOWN EXCEPTION>"));
+    }
+}
@@ -0,0 +1,89 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QThread>
+
+#include <optional>
+#include <QObject>
+#include <QString>
+#include <utility>
+#include "../util/btcancellationtoken.h"
+#include "cswordmodulesearch.h"
+#include "drivers/btmodulelist.h"
+
+
+/**
+  \brief Runs a search off the GUI thread and emits the results of each module
+         as soon as they are ready.
+*/
+class BtSearchThread: public QThread {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtSearchThread(QString searchText,
+                   BtConstModuleList modules,
+                   sword::ListKey scope,
+                   QObject * parent = nullptr);
+
+    ~BtSearchThread() override;
+
+    /**
+      \brief Stops all searches and waits for them to finish, so that the
+             modules they search can be deleted, e.g. when the modules are
+             reloaded. Must be called from the GUI thread.
+    */
+    static void stopAllSearches();
+
+    BtConstModuleList const & modules() const noexcept { return m_modules; }
+
+    /**
+      \brief Makes the modules without an index be searched by scanning their
+             text for the given query instead, see
+             CSwordModuleSearch::scanModule(). Must be called before start().
+    */
+    void setScanQuery(CSwordModuleSearch::ScanQuery query)
+    { m_scanQuery.emplace(std::move(query)); }
+
+    /**
+      \brief Makes the search stop as soon as possible. The results of the
+             module currently being searched are dropped.
+    */
+    void stopSearch() noexcept { m_cancellation.cancel(); }
+
+    bool stopRequested() const noexcept { return m_cancellation.cancelled(); }
+
+Q_SIGNALS:
+
+    /** Emitted when the module at the given index has been searched. */
+    void moduleSearched(int moduleIndex,
+                        CSwordModuleSearch::ModuleResultList results);
+
+    /** Emitted when the search failed. */
+    void searchFailed(QString const & message);
+
+protected: // methods:
+
+    void run() override;
+
+private: // fields:
+
+    QString const m_searchText;
+    BtConstModuleList const m_modules;
+    sword::ListKey const m_scope;
+    std::optional<CSwordModuleSearch::ScanQuery> m_scanQuery;
+    BtCancellationToken const m_cancellation{BtCancellationToken::create()};
+
+}; /* class BtSearchThread */
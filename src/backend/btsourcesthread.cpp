@@ -12,12 +12,15 @@
 
 #include "btsourcesthread.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <QDebug>
 #include <QString>
 #include <QStringList>
-#include <memory>
 #include <utility>
+#include <vector>
 #include "../util/btassert.h"
 #include "btinstallbackend.h"
 #include "btinstallmgr.h"
@@ -26,6 +29,11 @@
 #include <installmgr.h>
 
 
+/* Maximum number of remote sources refreshed concurrently. Refreshing is
+   dominated by network round trips, hence this does not depend on the number
+   of processors: */
+constexpr static int const BT_MAX_SOURCE_REFRESH_THREADS = 8;
+
 void BtSourcesThread::run() {
     Q_EMIT percentComplete(0);
     Q_EMIT showMessage(tr("Getting Library List"));
@@ -41,41 +49,73 @@ void BtSourcesThread::run() {
     QStringList const sourceNames = BtInstallBackend::sourceNameList();
     auto const sourceCount = sourceNames.count();
     BT_ASSERT(sourceCount >= 0);
-    auto const failedSources(std::make_unique<int[]>(sourceCount));
-    std::size_t numFailedSources = 0u;
-    BtInstallMgr iMgr;
-    for (int i = 0; i < sourceCount; ++i) {
-        if (shouldStop()) {
-            Q_EMIT showMessage(tr("Updating stopped"));
-            return;
-        }
-        QString const & sourceName = sourceNames[i];
-        Q_EMIT showMessage(
-                    tr("Updating remote library \"%1\"").arg(sourceName));
-        {
-            sword::InstallSource source = BtInstallBackend::source(sourceName);
-            if (iMgr.refreshRemoteSource(&source)) {
-                failedSources[numFailedSources] = i;
-                ++numFailedSources;
-            }
-        }
-        Q_EMIT percentComplete(
-                    static_cast<int>(10 + 90 * ((i + 1.0) / sourceCount)));
+
+    /* Every source is refreshed by its own BtInstallMgr in one of several
+       threads, so that a slow or failing mirror does not delay the others: */
+    std::mutex mutex;
+    int nextSource = 0;
+    int numFinishedSources = 0;
+    QStringList updatingSources;
+    std::vector<bool> failedSources(static_cast<std::size_t>(sourceCount));
+    auto const work =
+            [&] {
+                for (;;) {
+                    int i;
+                    {
+                        std::lock_guard<std::mutex> const guard(mutex);
+                        if (nextSource >= sourceCount || shouldStop())
+                            return;
+                        i = nextSource++;
+                        updatingSources.append(sourceNames[i]);
+                        Q_EMIT showMessage(
+                                    tr("Updating remote library \"%1\"")
+                                        .arg(updatingSources.join(
+                                                 QStringLiteral(", "))));
+                    }
+                    bool failed;
+                    {
+                        BtInstallMgr iMgr;
+                        sword::InstallSource source =
+                                BtInstallBackend::source(sourceNames[i]);
+                        failed = iMgr.refreshRemoteSource(&source);
+                    }
+                    std::lock_guard<std::mutex> const guard(mutex);
+                    failedSources[static_cast<std::size_t>(i)] = failed;
+                    updatingSources.removeOne(sourceNames[i]);
+                    ++numFinishedSources;
+                    Q_EMIT percentComplete(
+                                static_cast<int>(
+                                    10 + 90 * (numFinishedSources
+                                               / double(sourceCount))));
+                }
+            };
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 1;
+         i < std::min(sourceCount, BT_MAX_SOURCE_REFRESH_THREADS);
+         ++i)
+    {
+        threads.emplace_back(QThread::create(work));
+        threads.back()->start();
+    }
+    work();
+    for (auto const & thread : threads)
+        thread->wait();
+
+    if (shouldStop()) {
+        Q_EMIT showMessage(tr("Updating stopped"));
+        return;
     }
     Q_EMIT percentComplete(100);
-    if (numFailedSources <= 0) {
+    QStringList failedSourceNames;
+    for (int i = 0; i < sourceCount; ++i)
+        if (failedSources[static_cast<std::size_t>(i)])
+            failedSourceNames.append(sourceNames[i]);
+    if (failedSourceNames.isEmpty()) {
         Q_EMIT showMessage(tr("Remote libraries have been updated."));
-        m_finishedSuccessfully.store(true, std::memory_order_release);
     } else {
-        QString msg = tr("The following remote libraries failed to update: ");
-        for (std::size_t i = 0;;) {
-            msg += sourceNames[failedSources[i]];
-            if (++i >= numFailedSources)
-                break;
-            static auto const separator = QStringLiteral(", ");
-            msg.append(separator);
-        }
-        Q_EMIT showMessage(std::move(msg));
-        m_finishedSuccessfully.store(true, std::memory_order_release);
+        Q_EMIT showMessage(
+                    tr("The following remote libraries failed to update: ")
+                    + failedSourceNames.join(QStringLiteral(", ")));
     }
+    m_finishedSuccessfully.store(true, std::memory_order_release);
 }
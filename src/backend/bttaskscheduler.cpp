@@ -0,0 +1,151 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "bttaskscheduler.h"
+
+#include <algorithm>
+#include <QThread>
+#include <type_traits>
+#include <utility>
+
+
+namespace {
+
+/** The index of the worker running in the current thread, if any. */
+thread_local std::size_t currentWorker = static_cast<std::size_t>(-1);
+
+} // anonymous namespace
+
+bool BtTaskToken::finished() const {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return m_finished;
+}
+
+void BtTaskToken::wait() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]{ return m_finished; });
+}
+
+void BtTaskToken::finish() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_finished = true;
+    }
+    m_condition.notify_all();
+}
+
+BtTaskScheduler::BtTaskScheduler() {
+    auto const numWorkers =
+            static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+    m_workers.reserve(numWorkers);
+    for (std::size_t i = 0u; i < numWorkers; ++i)
+        m_workers.emplace_back(std::make_unique<Worker>());
+    for (std::size_t i = 0u; i < numWorkers; ++i) {
+        auto & thread = m_workers[i]->thread;
+        thread.reset(QThread::create([this, i]{ work(i); }));
+        thread->start(QThread::LowPriority);
+    }
+}
+
+BtTaskScheduler::~BtTaskScheduler() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto const & worker : m_workers)
+        worker->thread->wait();
+
+    // Release anyone waiting for tasks never run:
+    for (auto const & worker : m_workers)
+        for (auto & queue : worker->queues)
+            for (auto & queued : queue)
+                queued.token->finish();
+}
+
+BtTaskScheduler & BtTaskScheduler::instance() {
+    static BtTaskScheduler scheduler;
+    return scheduler;
+}
+
+std::shared_ptr<BtTaskToken> BtTaskScheduler::submit(Task task,
+                                                     Priority const priority)
+{
+    auto token(std::make_shared<BtTaskToken>());
+    auto const workerIndex =
+            (currentWorker < m_workers.size())
+            ? currentWorker
+            : (m_nextWorker.fetch_add(1u, std::memory_order_relaxed)
+               % m_workers.size());
+    {
+        auto & worker = *m_workers[workerIndex];
+        std::lock_guard<std::mutex> const guard(worker.mutex);
+        worker.queues[static_cast<std::size_t>(priority)].push_back(
+                    {std::move(task), token});
+    }
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        ++m_queuedTasks;
+    }
+    m_condition.notify_one();
+    return token;
+}
+
+bool BtTaskScheduler::takeTask(std::size_t const workerIndex,
+                               QueuedTask & task)
+{
+    auto const numWorkers = m_workers.size();
+    for (auto p = std::extent_v<decltype(Worker::queues)>; p-- > 0u;) {
+        { // The most recent task of the own queue is likely still cached:
+            auto & worker = *m_workers[workerIndex];
+            std::lock_guard<std::mutex> const guard(worker.mutex);
+            if (auto & queue = worker.queues[p]; !queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t i = 1u; i < numWorkers; ++i) {
+            auto & victim = *m_workers[(workerIndex + i) % numWorkers];
+            std::lock_guard<std::mutex> const guard(victim.mutex);
+            if (auto & queue = victim.queues[p]; !queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void BtTaskScheduler::work(std::size_t const workerIndex) {
+    currentWorker = workerIndex;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock,
+                             [this]{ return m_stopping || m_queuedTasks; });
+            if (m_stopping)
+                return;
+            --m_queuedTasks;
+        }
+
+        /* A task is queued for every decrement above, though it might be
+           taken by another worker between the decrement and taking it: */
+        QueuedTask task;
+        while (!takeTask(workerIndex, task))
+            QThread::yieldCurrentThread();
+        if (!task.token->cancelled())
+            task.task(*task.token);
+        task.token->finish();
+    }
+}
@@ -0,0 +1,146 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+class QThread;
+
+/**
+  \brief The handle of a task submitted to BtTaskScheduler, by which the task
+         reports its progress and the submitter cancels it or waits for it.
+*/
+class BtTaskToken {
+
+    friend class BtTaskScheduler;
+
+public: // methods:
+
+    /** \brief Asks the task to stop, or not to start at all. */
+    void cancel() noexcept
+    { m_cancelled.store(true, std::memory_order_relaxed); }
+
+    bool cancelled() const noexcept
+    { return m_cancelled.load(std::memory_order_relaxed); }
+
+    /** \brief Reports the progress of the task, called by the task. */
+    void setProgress(std::size_t const done, std::size_t const total) noexcept {
+        m_total.store(total, std::memory_order_relaxed);
+        m_done.store(done, std::memory_order_relaxed);
+    }
+
+    std::size_t done() const noexcept
+    { return m_done.load(std::memory_order_relaxed); }
+
+    std::size_t total() const noexcept
+    { return m_total.load(std::memory_order_relaxed); }
+
+    /** \returns whether the task has finished or was skipped when cancelled. */
+    bool finished() const;
+
+    /**
+      \brief Waits until the task has finished.
+      \warning Tasks must not wait for other tasks, since all workers might
+               end up waiting.
+    */
+    void wait() const;
+
+private: // methods:
+
+    void finish();
+
+private: // fields:
+
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<std::size_t> m_done{0u};
+    std::atomic<std::size_t> m_total{0u};
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_condition;
+    bool m_finished = false;
+
+}; /* class BtTaskToken */
+
+/**
+  \brief Runs backend tasks on a worker thread per hardware thread.
+
+  Every worker has a queue of tasks per priority. Tasks submitted by a worker
+  are queued to its own queues, and other tasks to the queues of the workers
+  in turn. Workers run the most recent task of their own queues of the highest
+  priority first, and steal the oldest tasks of other workers when their own
+  queues of a priority are empty, so that all workers are kept busy.
+*/
+class BtTaskScheduler {
+
+public: // types:
+
+    enum class Priority : unsigned char { Idle, Background, Interactive };
+
+    using Task = std::function<void (BtTaskToken & token)>;
+
+public: // methods:
+
+    ~BtTaskScheduler();
+
+    static BtTaskScheduler & instance();
+
+    std::size_t numWorkers() const noexcept { return m_workers.size(); }
+
+    /**
+      \brief Queues the given task.
+      \returns the token of the task.
+    */
+    std::shared_ptr<BtTaskToken> submit(
+            Task task,
+            Priority priority = Priority::Background);
+
+private: // types:
+
+    struct QueuedTask {
+        Task task;
+        std::shared_ptr<BtTaskToken> token;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedTask> queues[3]; ///< Indexed by priority
+        std::unique_ptr<QThread> thread;
+    };
+
+private: // methods:
+
+    BtTaskScheduler();
+
+    /** \brief Takes the next task for the given worker, if any. */
+    bool takeTask(std::size_t workerIndex, QueuedTask & task);
+
+    void work(std::size_t workerIndex);
+
+private: // fields:
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_nextWorker{0u};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::size_t m_queuedTasks = 0u;
+    bool m_stopping = false;
+
+}; /* class BtTaskScheduler */
@@ -0,0 +1,346 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btverseattributestore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <QByteArray>
+#include <QDebug>
+#include <QIODevice>
+#include <QSaveFile>
+#include <utility>
+
+
+/* The file starts with the magic number (which also tells the byte order), the
+   version and the sizes of the columns, followed by the columns themselves: */
+constexpr static std::uint32_t const BT_VERSE_ATTRIBUTE_STORE_MAGIC =
+        0x41565442u; // "BTVA"
+
+//Increment this, if the file format changes
+constexpr static std::uint32_t const BT_VERSE_ATTRIBUTE_STORE_VERSION = 1u;
+
+namespace {
+
+enum HeaderField {
+    Magic,
+    Version,
+    NumVerses,
+    NumWords,
+    NumFootnotes,
+    NumHeadings,
+    NumStrings,
+    StringDataSize,
+    HeaderSize
+};
+
+bool attributesEmpty(BtVerseAttributeStore::Attributes const & attributes) {
+    return attributes.words.empty()
+           && attributes.footnotes.empty()
+           && attributes.headings.isEmpty();
+}
+
+bool writeColumn(QSaveFile & file, std::vector<std::uint32_t> const & column) {
+    auto const size =
+            static_cast<qint64>(column.size() * sizeof(std::uint32_t));
+    return file.write(reinterpret_cast<char const *>(column.data()), size)
+           == size;
+}
+
+} // anonymous namespace
+
+void BtVerseAttributeStore::Builder::add(std::uint32_t const verseIndex,
+                                         Attributes const & attributes)
+{
+    if (attributesEmpty(attributes)) {
+        m_records.erase(verseIndex);
+        return;
+    }
+    Record record;
+    record.words.reserve(attributes.words.size());
+    for (auto const & word : attributes.words)
+        record.words.push_back({intern(word.lemma),
+                                intern(word.morph),
+                                intern(word.text)});
+    record.footnotes.reserve(attributes.footnotes.size());
+    for (auto const & footnote : attributes.footnotes)
+        record.footnotes.push_back({intern(footnote.id),
+                                    intern(footnote.body)});
+    record.headings.reserve(static_cast<std::size_t>(
+                                attributes.headings.size()));
+    for (auto const & heading : attributes.headings)
+        record.headings.push_back(intern(heading));
+    m_records.insert_or_assign(verseIndex, std::move(record));
+}
+
+void BtVerseAttributeStore::Builder::remove(
+        std::vector<std::uint32_t> const & verseIndices)
+{
+    for (auto const verseIndex : verseIndices)
+        m_records.erase(verseIndex);
+}
+
+void BtVerseAttributeStore::Builder::merge(Builder const & other) {
+    auto const remap =
+            [this, &other](std::uint32_t const id)
+            { return intern(other.m_strings[id]); };
+    for (auto const & [verseIndex, otherRecord] : other.m_records) {
+        Record record;
+        record.words.reserve(otherRecord.words.size());
+        for (auto const & word : otherRecord.words)
+            record.words.push_back({remap(word[0]),
+                                    remap(word[1]),
+                                    remap(word[2])});
+        record.footnotes.reserve(otherRecord.footnotes.size());
+        for (auto const & footnote : otherRecord.footnotes)
+            record.footnotes.push_back({remap(footnote[0]),
+                                        remap(footnote[1])});
+        record.headings.reserve(otherRecord.headings.size());
+        for (auto const heading : otherRecord.headings)
+            record.headings.push_back(remap(heading));
+        m_records.insert_or_assign(verseIndex, std::move(record));
+    }
+}
+
+std::optional<BtVerseAttributeStore::Builder>
+BtVerseAttributeStore::Builder::load(QString const & fileName) {
+    auto const store(BtVerseAttributeStore::load(fileName));
+    if (!store)
+        return {};
+    Builder r;
+    for (auto const verseIndex : store->verseIndices())
+        if (auto const attributes = store->attributes(verseIndex))
+            r.add(verseIndex, *attributes);
+    return r;
+}
+
+bool BtVerseAttributeStore::Builder::save(QString const & fileName) const {
+    /* Only the strings still referred to are written, in the order of their
+       first use: */
+    static constexpr auto const unused =
+            std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> newIds(m_strings.size(), unused);
+    std::vector<std::uint32_t> stringOffsets{0u};
+    QByteArray stringData;
+    auto const id =
+            [this, &newIds, &stringOffsets, &stringData](
+                    std::uint32_t const oldId)
+            {
+                auto & newId = newIds[oldId];
+                if (newId == unused) {
+                    newId = static_cast<std::uint32_t>(
+                                stringOffsets.size() - 1u);
+                    stringData.append(m_strings[oldId].toUtf8());
+                    stringOffsets.push_back(
+                                static_cast<std::uint32_t>(stringData.size()));
+                }
+                return newId;
+            };
+
+    std::vector<std::uint32_t> verses;
+    std::vector<std::uint32_t> wordOffsets{0u};
+    std::vector<std::uint32_t> footnoteOffsets{0u};
+    std::vector<std::uint32_t> headingOffsets{0u};
+    std::vector<std::uint32_t> words;
+    std::vector<std::uint32_t> footnotes;
+    std::vector<std::uint32_t> headings;
+    verses.reserve(m_records.size());
+    for (auto const & [verseIndex, record] : m_records) {
+        verses.push_back(verseIndex);
+        for (auto const & word : record.words)
+            for (auto const part : word)
+                words.push_back(id(part));
+        wordOffsets.push_back(static_cast<std::uint32_t>(words.size() / 3u));
+        for (auto const & footnote : record.footnotes)
+            for (auto const part : footnote)
+                footnotes.push_back(id(part));
+        footnoteOffsets.push_back(
+                    static_cast<std::uint32_t>(footnotes.size() / 2u));
+        for (auto const heading : record.headings)
+            headings.push_back(id(heading));
+        headingOffsets.push_back(static_cast<std::uint32_t>(headings.size()));
+    }
+
+    std::vector<std::uint32_t> const header{
+        BT_VERSE_ATTRIBUTE_STORE_MAGIC,
+        BT_VERSE_ATTRIBUTE_STORE_VERSION,
+        static_cast<std::uint32_t>(verses.size()),
+        wordOffsets.back(),
+        footnoteOffsets.back(),
+        headingOffsets.back(),
+        static_cast<std::uint32_t>(stringOffsets.size() - 1u),
+        stringOffsets.back()};
+    static_assert(HeaderSize == 8);
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)
+        || !writeColumn(file, header)
+        || !writeColumn(file, verses)
+        || !writeColumn(file, wordOffsets)
+        || !writeColumn(file, footnoteOffsets)
+        || !writeColumn(file, headingOffsets)
+        || !writeColumn(file, words)
+        || !writeColumn(file, footnotes)
+        || !writeColumn(file, headings)
+        || !writeColumn(file, stringOffsets)
+        || file.write(stringData) != stringData.size()
+        || !file.commit())
+    {
+        qWarning() << "Failed to write" << fileName;
+        return false;
+    }
+    return true;
+}
+
+std::uint32_t BtVerseAttributeStore::Builder::intern(QString const & string) {
+    auto const it = m_stringIds.constFind(string);
+    if (it != m_stringIds.cend())
+        return *it;
+    auto const id = static_cast<std::uint32_t>(m_strings.size());
+    m_strings.push_back(string);
+    m_stringIds.insert(string, id);
+    return id;
+}
+
+std::unique_ptr<BtVerseAttributeStore const>
+BtVerseAttributeStore::load(QString const & fileName) {
+    std::unique_ptr<BtVerseAttributeStore> r(new BtVerseAttributeStore);
+    r->m_file.setFileName(fileName);
+    if (!r->m_file.open(QIODevice::ReadOnly))
+        return nullptr;
+    auto const fileSize = static_cast<std::uint64_t>(r->m_file.size());
+    if (fileSize < HeaderSize * sizeof(std::uint32_t))
+        return nullptr;
+    // The mapping is kept until the file is closed by the destructor:
+    auto const * const data =
+            r->m_file.map(0, static_cast<qint64>(fileSize));
+    if (!data)
+        return nullptr;
+
+    std::uint32_t header[HeaderSize];
+    std::memcpy(header, data, sizeof(header));
+    if (header[Magic] != BT_VERSE_ATTRIBUTE_STORE_MAGIC
+        || header[Version] != BT_VERSE_ATTRIBUTE_STORE_VERSION)
+        return nullptr;
+
+    std::uint64_t offset = sizeof(header);
+    auto const column =
+            [data, fileSize, &offset](Column & c, std::uint64_t const size) {
+                if (size > std::numeric_limits<std::uint32_t>::max()
+                    || size > (fileSize - offset) / sizeof(std::uint32_t))
+                    return false;
+                // The offsets are multiples of 4 from the mapped page:
+                c.data = reinterpret_cast<std::uint32_t const *>(
+                             data + offset);
+                c.size = static_cast<std::uint32_t>(size);
+                offset += size * sizeof(std::uint32_t);
+                return true;
+            };
+    std::uint64_t const numVerses = header[NumVerses];
+    if (!column(r->m_verses, numVerses)
+        || !column(r->m_wordOffsets, numVerses + 1u)
+        || !column(r->m_footnoteOffsets, numVerses + 1u)
+        || !column(r->m_headingOffsets, numVerses + 1u)
+        || !column(r->m_words,
+                   static_cast<std::uint64_t>(header[NumWords]) * 3u)
+        || !column(r->m_footnotes,
+                   static_cast<std::uint64_t>(header[NumFootnotes]) * 2u)
+        || !column(r->m_headings, header[NumHeadings])
+        || !column(r->m_stringOffsets,
+                   static_cast<std::uint64_t>(header[NumStrings]) + 1u)
+        || fileSize - offset < header[StringDataSize])
+        return nullptr;
+    r->m_stringData = reinterpret_cast<char const *>(data + offset);
+    r->m_stringDataSize = header[StringDataSize];
+
+    // The offsets need to end at the sizes of the columns they refer to:
+    if (r->m_wordOffsets.at(header[NumVerses]) != header[NumWords]
+        || r->m_footnoteOffsets.at(header[NumVerses]) != header[NumFootnotes]
+        || r->m_headingOffsets.at(header[NumVerses]) != header[NumHeadings]
+        || r->m_stringOffsets.at(header[NumStrings])
+           != header[StringDataSize])
+        return nullptr;
+    return r;
+}
+
+std::optional<BtVerseAttributeStore::Attributes>
+BtVerseAttributeStore::attributes(std::uint32_t const verseIndex) const {
+    auto const pos = findVerse(verseIndex);
+    if (!pos)
+        return {};
+    Attributes r;
+    for (auto i = m_wordOffsets.at(*pos);
+         i < m_wordOffsets.at(*pos + 1u);
+         ++i)
+        r.words.emplace_back(Word{string(m_words.at(3u * i)),
+                                  string(m_words.at(3u * i + 1u)),
+                                  string(m_words.at(3u * i + 2u))});
+    for (auto i = m_footnoteOffsets.at(*pos);
+         i < m_footnoteOffsets.at(*pos + 1u);
+         ++i)
+        r.footnotes.emplace_back(
+                    Footnote{string(m_footnotes.at(2u * i)),
+                             string(m_footnotes.at(2u * i + 1u))});
+    r.headings = headings(verseIndex);
+    return r;
+}
+
+std::optional<QString>
+BtVerseAttributeStore::footnote(std::uint32_t const verseIndex,
+                                QString const & id) const
+{
+    auto const pos = findVerse(verseIndex);
+    if (!pos)
+        return {};
+    for (auto i = m_footnoteOffsets.at(*pos);
+         i < m_footnoteOffsets.at(*pos + 1u);
+         ++i)
+        if (string(m_footnotes.at(2u * i)) == id)
+            return string(m_footnotes.at(2u * i + 1u));
+    return {};
+}
+
+QStringList BtVerseAttributeStore::headings(std::uint32_t const verseIndex)
+        const
+{
+    QStringList r;
+    if (auto const pos = findVerse(verseIndex))
+        for (auto i = m_headingOffsets.at(*pos);
+             i < m_headingOffsets.at(*pos + 1u);
+             ++i)
+            r.append(string(m_headings.at(i)));
+    return r;
+}
+
+std::vector<std::uint32_t> BtVerseAttributeStore::verseIndices() const
+{ return {m_verses.data, m_verses.data + m_verses.size}; }
+
+std::optional<std::uint32_t>
+BtVerseAttributeStore::findVerse(std::uint32_t const verseIndex) const {
+    auto const * const end = m_verses.data + m_verses.size;
+    auto const * const it = std::lower_bound(m_verses.data, end, verseIndex);
+    if (it == end || *it != verseIndex)
+        return {};
+    return static_cast<std::uint32_t>(it - m_verses.data);
+}
+
+QString BtVerseAttributeStore::string(std::uint32_t const id) const {
+    if (id + 1u >= m_stringOffsets.size)
+        return {};
+    auto const begin = m_stringOffsets.at(id);
+    auto const end = m_stringOffsets.at(id + 1u);
+    if (begin > end || end > m_stringDataSize)
+        return {};
+    return QString::fromUtf8(m_stringData + begin,
+                             static_cast<qsizetype>(end - begin));
+}
@@ -0,0 +1,174 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+
+/**
+  \brief A memory-mapped store of the entry attributes of the verses of a
+         module, i.e. of their words with Strong's numbers and morphological
+         codes, their footnotes and their preverse headings.
+
+  The store is built from the entry attributes of verse keyed modules alongside
+  their search index (see Builder), so that the attributes of a verse can be
+  read without running the filters of Sword again. The file is laid out in
+  columns of 32 bit integers which refer to a pool of interned strings, hence
+  the lemmas and morphological codes shared by many words are stored once.
+*/
+class BtVerseAttributeStore {
+
+public: // types:
+
+    struct Word {
+        QString lemma; ///< The lemmas of all parts, separated by spaces
+        QString morph;
+        QString text;
+    };
+
+    struct Footnote {
+        QString id; ///< The key of the footnote in the entry attributes
+        QString body;
+    };
+
+    struct Attributes {
+        std::vector<Word> words;
+        std::vector<Footnote> footnotes;
+        QStringList headings; ///< The preverse headings
+    };
+
+    /** \brief Collects the attributes of verses and writes the store. */
+    class Builder {
+
+    public: // methods:
+
+        /**
+          \brief Sets the attributes of the given verse, or removes them if
+                 all of them are empty.
+        */
+        void add(std::uint32_t verseIndex, Attributes const & attributes);
+
+        /** \brief Removes the attributes of the given verses. */
+        void remove(std::vector<std::uint32_t> const & verseIndices);
+
+        /** \brief Adds the attributes of the given builder to this one. */
+        void merge(Builder const & other);
+
+        /**
+          \returns a builder with the contents of the store in the given file,
+                   e.g. to update it, if the file is valid.
+        */
+        static std::optional<Builder> load(QString const & fileName);
+
+        /**
+          \brief Writes the store to the given file, replacing it atomically
+                 so that stores already mapped keep their data.
+          \returns whether the store was saved.
+        */
+        bool save(QString const & fileName) const;
+
+    private: // types:
+
+        struct Record {
+            std::vector<std::array<std::uint32_t, 3u>> words;
+            std::vector<std::array<std::uint32_t, 2u>> footnotes;
+            std::vector<std::uint32_t> headings;
+        };
+
+    private: // methods:
+
+        std::uint32_t intern(QString const & string);
+
+    private: // fields:
+
+        std::map<std::uint32_t, Record> m_records;
+        std::vector<QString> m_strings;
+        QHash<QString, std::uint32_t> m_stringIds;
+
+    }; /* class Builder */
+
+public: // methods:
+
+    BtVerseAttributeStore(BtVerseAttributeStore const &) = delete;
+    BtVerseAttributeStore & operator=(BtVerseAttributeStore const &) = delete;
+
+    /** \returns the store mapped from the given file, if it is valid. */
+    static std::unique_ptr<BtVerseAttributeStore const>
+    load(QString const & fileName);
+
+    /**
+      \returns the attributes of the verse with the given index, or nothing if
+               the verse has none.
+    */
+    std::optional<Attributes> attributes(std::uint32_t verseIndex) const;
+
+    /**
+      \returns the body of the footnote with the given key in the entry
+               attributes of the verse with the given index, if any.
+    */
+    std::optional<QString> footnote(std::uint32_t verseIndex,
+                                    QString const & id) const;
+
+    /** \returns the preverse headings of the verse with the given index. */
+    QStringList headings(std::uint32_t verseIndex) const;
+
+    /** \returns the indices of the verses with attributes, ascending. */
+    std::vector<std::uint32_t> verseIndices() const;
+
+private: // types:
+
+    /** A column of the file, which is an array of 32 bit integers. */
+    struct Column {
+        std::uint32_t const * data = nullptr;
+        std::uint32_t size = 0u;
+
+        std::uint32_t at(std::uint32_t const i) const noexcept
+        { return (i < size) ? data[i] : 0u; }
+    };
+
+private: // methods:
+
+    BtVerseAttributeStore() = default;
+
+    /**
+      \returns the position of the verse with the given index in the verse
+               column, if it has any attributes.
+    */
+    std::optional<std::uint32_t> findVerse(std::uint32_t verseIndex) const;
+
+    QString string(std::uint32_t id) const;
+
+private: // fields:
+
+    QFile m_file;
+    Column m_verses;
+    Column m_wordOffsets;
+    Column m_footnoteOffsets;
+    Column m_headingOffsets;
+    Column m_words; ///< Lemma, morph and text of each word
+    Column m_footnotes; ///< Id and body of each footnote
+    Column m_headings;
+    Column m_stringOffsets;
+    char const * m_stringData = nullptr;
+    std::uint32_t m_stringDataSize = 0u;
+
+}; /* class BtVerseAttributeStore */
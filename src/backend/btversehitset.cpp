@@ -0,0 +1,135 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btversehitset.h"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <utility>
+#include "../util/btassert.h"
+#include "keys/btversificationmapping.h"
+#include "keys/btversificationtable.h"
+
+
+namespace {
+
+constexpr std::size_t const wordBits = 64u;
+
+} // anonymous namespace
+
+BtVerseHitSet::BtVerseHitSet(QString versification)
+    : m_versification(std::move(versification))
+{
+    auto const size = static_cast<std::size_t>(
+            BtVersificationTable::forVersification(m_versification)->size());
+    m_words.resize((size + wordBits - 1u) / wordBits, 0u);
+}
+
+std::optional<BtVerseHitSet> BtVerseHitSet::fromResults(
+        CSwordModuleSearch::ModuleResultList const & results,
+        QString const & versification)
+{
+    auto const sourceVersification(results.versification());
+    if (sourceVersification.isNull())
+        return {};
+
+    BtVerseHitSet r(versification);
+    auto const insertAll =
+            [&r](CSwordModuleSearch::ModuleResultList const & complete) {
+                if (complete.versification() == r.m_versification) {
+                    for (auto const verseIndex : complete.verseIndices())
+                        r.insert(verseIndex);
+                    return;
+                }
+                auto const mapping(
+                        BtVersificationMapping::forVersifications(
+                            complete.versification(),
+                            r.m_versification));
+                for (auto const verseIndex : complete.verseIndices())
+                    if (auto const mapped = mapping->mappedIndex(verseIndex);
+                        mapped >= 0)
+                        r.insert(mapped);
+            };
+    if (results.hasMore()) {
+        insertAll(results.complete());
+    } else {
+        insertAll(results);
+    }
+    return r;
+}
+
+bool BtVerseHitSet::contains(long const verseIndex) const noexcept {
+    auto const i = static_cast<std::size_t>(verseIndex);
+    return verseIndex >= 0
+           && i / wordBits < m_words.size()
+           && (m_words[i / wordBits] >> (i % wordBits)) & 1u;
+}
+
+void BtVerseHitSet::insert(long const verseIndex) noexcept {
+    auto const i = static_cast<std::size_t>(verseIndex);
+    if (verseIndex >= 0 && i / wordBits < m_words.size())
+        m_words[i / wordBits] |= std::uint64_t(1u) << (i % wordBits);
+}
+
+std::size_t BtVerseHitSet::count() const noexcept {
+    std::size_t r = 0u;
+    for (auto const word : m_words)
+        r += static_cast<std::size_t>(std::popcount(word));
+    return r;
+}
+
+bool BtVerseHitSet::empty() const noexcept {
+    return std::all_of(m_words.begin(),
+                       m_words.end(),
+                       [](std::uint64_t const word) { return !word; });
+}
+
+std::vector<std::uint32_t> BtVerseHitSet::verseIndices() const {
+    std::vector<std::uint32_t> r;
+    r.reserve(count());
+    for (std::size_t i = 0u; i < m_words.size(); ++i) {
+        for (auto word = m_words[i]; word; word &= word - 1u)
+            r.emplace_back(static_cast<std::uint32_t>(
+                               i * wordBits
+                               + static_cast<std::size_t>(
+                                   std::countr_zero(word))));
+    }
+    return r;
+}
+
+BtVerseHitSet & BtVerseHitSet::operator|=(BtVerseHitSet const & other)
+        noexcept
+{
+    BT_ASSERT(m_versification == other.m_versification);
+    for (std::size_t i = 0u; i < m_words.size(); ++i)
+        m_words[i] |= other.m_words[i];
+    return *this;
+}
+
+BtVerseHitSet & BtVerseHitSet::operator&=(BtVerseHitSet const & other)
+        noexcept
+{
+    BT_ASSERT(m_versification == other.m_versification);
+    for (std::size_t i = 0u; i < m_words.size(); ++i)
+        m_words[i] &= other.m_words[i];
+    return *this;
+}
+
+BtVerseHitSet & BtVerseHitSet::operator-=(BtVerseHitSet const & other)
+        noexcept
+{
+    BT_ASSERT(m_versification == other.m_versification);
+    for (std::size_t i = 0u; i < m_words.size(); ++i)
+        m_words[i] &= ~other.m_words[i];
+    return *this;
+}
@@ -0,0 +1,88 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <QString>
+#include <vector>
+#include "cswordmodulesearch.h"
+
+
+/**
+  \brief A set of verses stored as a bitset over the verse indices (including
+         intros) of a versification system.
+
+  The hits of modules with different versification systems are compared by
+  mapping them to a common versification system first, after which the set
+  operations process 64 verses at a time.
+*/
+class BtVerseHitSet {
+
+public: // methods:
+
+    BtVerseHitSet() = default;
+
+    /** \brief Creates an empty set over the given versification system. */
+    explicit BtVerseHitSet(QString versification);
+
+    /**
+      \returns the set of the hits of the given verse based results, mapped to
+               the given versification system if needed, or nothing if the
+               results are not verse based. Verses which are not part of or map
+               to a range of verses of that versification system are dropped.
+    */
+    static std::optional<BtVerseHitSet> fromResults(
+            CSwordModuleSearch::ModuleResultList const & results,
+            QString const & versification);
+
+    QString const & versification() const noexcept { return m_versification; }
+
+    bool contains(long verseIndex) const noexcept;
+
+    void insert(long verseIndex) noexcept;
+
+    /** \returns the number of verses in the set. */
+    std::size_t count() const noexcept;
+
+    bool empty() const noexcept;
+
+    /** \returns the verse indices in the set in ascending order. */
+    std::vector<std::uint32_t> verseIndices() const;
+
+    /** \pre Both sets are of the same versification system. */
+    BtVerseHitSet & operator|=(BtVerseHitSet const & other) noexcept;
+    BtVerseHitSet & operator&=(BtVerseHitSet const & other) noexcept;
+
+    /**
+      \brief Removes the verses of the given set from this one.
+      \pre Both sets are of the same versification system.
+    */
+    BtVerseHitSet & operator-=(BtVerseHitSet const & other) noexcept;
+
+    friend BtVerseHitSet operator|(BtVerseHitSet lhs, BtVerseHitSet const & rhs)
+    { return lhs |= rhs; }
+
+    friend BtVerseHitSet operator&(BtVerseHitSet lhs, BtVerseHitSet const & rhs)
+    { return lhs &= rhs; }
+
+    friend BtVerseHitSet operator-(BtVerseHitSet lhs, BtVerseHitSet const & rhs)
+    { return lhs -= rhs; }
+
+private: // fields:
+
+    QString m_versification;
+    std::vector<std::uint64_t> m_words;
+
+}; /* class BtVerseHitSet */
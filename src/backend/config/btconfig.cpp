@@ -16,13 +16,21 @@
 #include <limits>
 #include <QByteArray>
 #include <QDir>
+#include <QEvent>
 #include <QFile>
+#include <QHash>
 #include <QKeySequence>
 #include <QLocale>
+#include <QObject>
 #include <QSettings>
+#include <QStringBuilder>
+#include <QTimer>
 #include <QVariant>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <utility>
+#include <vector>
 #include "../../util/btassert.h"
 #include "../../util/directory.h"
 #include "../btglobal.h"
@@ -57,6 +65,104 @@ auto const GROUP_SESSIONS = QStringLiteral("sessions");
 auto const GROUP_SESSIONS_PREFIX = QStringLiteral("sessions/");
 auto const KEY_CURRENT_SESSION = QStringLiteral("sessions/currentSession");
 auto const KEY_SESSION_NAME = QStringLiteral("sessions/%1/name");
+
+//Delay in milliseconds after the first unsaved change to write the changes
+constexpr static int const BT_CONFIG_SYNC_DELAY = 3000;
+
+/**
+  \brief Coalesces the writes of the configuration file.
+
+  QSettings writes the whole file on the next iteration of the event loop after
+  every change. This filter swallows these update requests and instead writes
+  all changes made since the first request after BT_CONFIG_SYNC_DELAY. Pending
+  changes are still written by QSettings::sync() and when the settings are
+  destroyed, and QSettings replaces the file atomically.
+*/
+class DelayedSync final : public QObject {
+
+public: // methods:
+
+    DelayedSync(QSettings & settings)
+        : QObject(&settings)
+        , m_settings(settings)
+    {
+        m_timer.setSingleShot(true);
+        m_timer.setInterval(BT_CONFIG_SYNC_DELAY);
+        QObject::connect(&m_timer, &QTimer::timeout,
+                         &m_settings, &QSettings::sync);
+        settings.installEventFilter(this);
+    }
+
+    bool eventFilter(QObject * const watched, QEvent * const event) override {
+        if (watched == &m_settings && event->type() == QEvent::UpdateRequest) {
+            if (!m_timer.isActive())
+                m_timer.start();
+            return true;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private: // fields:
+
+    QSettings & m_settings;
+    QTimer m_timer;
+
+};
+
+std::shared_ptr<QSettings> createSettings(QString const & settingsFile) {
+    auto settings =
+            std::make_shared<QSettings>(settingsFile, QSettings::IniFormat);
+    new DelayedSync(*settings);
+    return settings;
+}
+
+/** The verse ranges of a parsed verse list as intervals of verse indices. */
+using VerseIntervals = std::vector<std::pair<long, long>>;
+
+/**
+  \brief Parses the verse list like sword::VerseKey::parseVerseList(), caching
+         the results by versification, locale and text for the session.
+  \returns the parsed verse list, or std::nullopt if it contains other than
+           verse keys which can not be cached.
+*/
+std::optional<VerseIntervals> parseVerseIntervals(QString const & data,
+                                                  sword::VerseKey & vk)
+{
+    static std::mutex mutex;
+    static QHash<QString, VerseIntervals> cache;
+
+    QString cacheKey(QString::fromUtf8(vk.getVersificationSystem()) % u'\n'
+                     % QString::fromUtf8(vk.getLocale()) % u'\n' % data);
+    {
+        std::lock_guard<std::mutex> const guard(mutex);
+        auto const it = cache.constFind(cacheKey);
+        if (it != cache.cend())
+            return *it;
+    }
+
+    sword::ListKey const list(
+                vk.parseVerseList(data.toUtf8(), "Genesis 1:1", true));
+    VerseIntervals r;
+    r.reserve(static_cast<std::size_t>(list.getCount()));
+    for (int i = 0; i < list.getCount(); ++i) {
+        auto const * const verse =
+                dynamic_cast<sword::VerseKey const *>(list.getElement(i));
+        if (!verse)
+            return {};
+        if (verse->isBoundSet()) {
+            r.emplace_back(verse->getLowerBound().getIndex(),
+                           verse->getUpperBound().getIndex());
+        } else {
+            r.emplace_back(verse->getIndex(), verse->getIndex());
+        }
+    }
+    r.shrink_to_fit();
+
+    std::lock_guard<std::mutex> const guard(mutex);
+    cache.insert(std::move(cacheKey), r);
+    return r;
+}
+
 } // anonymous namespace
 
 /*
@@ -69,8 +175,7 @@ BtConfig::StringMap BtConfig::m_defaultSearchScopes;
 
 
 BtConfig::BtConfig(const QString & settingsFile)
-    : BtConfigCore(
-          std::make_shared<QSettings>(settingsFile, QSettings::IniFormat))
+    : BtConfigCore(createSettings(settingsFile))
 {
     BT_ASSERT(!m_instance && "BtConfig already initialized!");
     m_instance = this;
@@ -135,6 +240,8 @@ BtConfig::BtConfig(const QString & settingsFile)
             m_currentSessionKey = m_sessionNames.keys().first();
         }
     }
+
+    resetOptionsSnapshot();
 }
 
 BtConfig::InitState BtConfig::initBtConfig() {
@@ -171,6 +278,7 @@ void BtConfig::setCurrentSession(QString const & key) {
     m_currentSessionKey = key;
 
     setValue(KEY_CURRENT_SESSION, key);
+    resetOptionsSnapshot();
 }
 
 QString BtConfig::addSession(QString const & name) {
@@ -230,6 +338,10 @@ QString BtConfig::getModuleEncryptionKey(const QString & name) {
 }
 
 BtConfig::ShortcutsMap BtConfig::getShortcuts(QString const & shortcutGroup) {
+    if (auto const it = m_shortcutsCache.constFind(shortcutGroup);
+        it != m_shortcutsCache.constEnd())
+        return *it;
+
     ShortcutsMap allShortcuts;
     auto shortcutsConf = group(shortcutGroup);
     for (QString const & key : shortcutsConf.childKeys()) {
@@ -251,12 +363,14 @@ BtConfig::ShortcutsMap BtConfig::getShortcuts(QString const & shortcutGroup) {
 
         allShortcuts.insert(key, shortcuts);
     }
+    m_shortcutsCache.insert(shortcutGroup, allShortcuts);
     return allShortcuts;
 }
 
 void BtConfig::setShortcuts(QString const & shortcutGroup,
                             ShortcutsMap const  & shortcuts)
 {
+    m_shortcutsCache.remove(shortcutGroup);
     auto shortcutsConf = group(shortcutGroup);
     for (auto it = shortcuts.begin(); it != shortcuts.end(); ++it) {
         // Write beautiful string lists (since 2.9):
@@ -304,6 +418,8 @@ void BtConfig::storeFilterOptionsToGroup(FilterOptions const & os,
     subConf.setValue(QStringLiteral("textualVariants"), static_cast<bool>(os.textualVariants));
     subConf.setValue(QStringLiteral("scriptureReferences"), static_cast<bool>(os.scriptureReferences));
     subConf.setValue(QStringLiteral("morphSegmentation"), static_cast<bool>(os.morphSegmentation));
+    if (m_instance)
+        m_instance->resetOptionsSnapshot();
 }
 
 DisplayOptions
@@ -323,6 +439,28 @@ void BtConfig::storeDisplayOptionsToGroup(DisplayOptions const & os,
                      static_cast<bool>(os.lineBreaks));
     subConf.setValue(QStringLiteral("verseNumbers"),
                      static_cast<bool>(os.verseNumbers));
+    if (m_instance)
+        m_instance->resetOptionsSnapshot();
+}
+
+std::shared_ptr<BtConfig::OptionsSnapshot const>
+BtConfig::optionsSnapshot() const {
+    std::lock_guard<std::mutex> const guard(m_optionsSnapshotMutex);
+    return m_optionsSnapshot;
+}
+
+void BtConfig::resetOptionsSnapshot() {
+    /* The options are read by the thread changing them, so that worker threads
+       reading the snapshot do not access the settings: */
+    auto const group = session();
+    auto filterOptions(loadFilterOptionsFromGroup(group));
+    auto displayOptions(loadDisplayOptionsFromGroup(group));
+    std::lock_guard<std::mutex> const guard(m_optionsSnapshotMutex);
+    m_optionsSnapshot =
+            std::make_shared<OptionsSnapshot const>(
+                OptionsSnapshot{std::move(filterOptions),
+                                std::move(displayOptions),
+                                ++m_optionsGeneration});
 }
 
 void BtConfig::setFontForLanguage(Language const & language,
@@ -347,12 +485,15 @@ void BtConfig::setFontForLanguage(Language const & language,
              fontSettings.first);
 
     // Update cache:
+    std::lock_guard<std::mutex> const guard(m_fontCacheMutex);
     m_fontCache[&language] = fontSettings;
+    m_fontGeneration.fetch_add(1u, std::memory_order_acq_rel);
 }
 
 BtConfig::FontSettingsPair
 BtConfig::getFontForLanguage(Language const & language) {
     // Check the cache first:
+    std::lock_guard<std::mutex> const guard(m_fontCacheMutex);
     auto it(m_fontCache.find(&language));
     if (it != m_fontCache.end())
         return *it;
@@ -479,9 +620,31 @@ sword::ListKey BtConfig::parseVerseListWithModules(const QString& data, const QS
         if (module == nullptr)
             continue;
         sword::VerseKey vk = module->swordModule().getKey();
-        sword::ListKey list(vk.parseVerseList(data.toUtf8(), "Genesis 1:1", true));
-        if (list.getCount() > 0)
-            return list;
+        auto const intervals = parseVerseIntervals(data, vk);
+        if (!intervals) {
+            sword::ListKey list(
+                        vk.parseVerseList(data.toUtf8(), "Genesis 1:1", true));
+            if (list.getCount() > 0)
+                return list;
+            continue;
+        }
+        if (intervals->empty())
+            continue;
+
+        // Recreate the verse ranges from the cached intervals:
+        sword::ListKey list;
+        sword::VerseKey bound(vk);
+        bound.setIntros(true);
+        for (auto const & interval : *intervals) {
+            sword::VerseKey range(bound);
+            bound.setIndex(interval.first);
+            range.setLowerBound(bound);
+            bound.setIndex(interval.second);
+            range.setUpperBound(bound);
+            range.setPosition(sword::TOP);
+            list.add(range);
+        }
+        return list;
     }
     return sword::ListKey();
 }
@@ -14,6 +14,10 @@
 
 #include "btconfigcore.h"
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <QCoreApplication>
 #include <QFont>
 #include <QHash>
@@ -37,6 +41,7 @@ class BtConfig: public BtConfigCore {
     Q_DECLARE_TR_FUNCTIONS(BtConfig)
 
     friend class BibleTimeApp;
+    friend class BtBenchmarkEnvironment;
 
 public: // types:
 
@@ -48,6 +53,13 @@ public: // types:
     using StringMap = QMap<QString, QString>;
     using ShortcutsMap = QHash<QString, QList<QKeySequence> >;
 
+    /** \brief An immutable snapshot of the options of the current session. */
+    struct OptionsSnapshot {
+        FilterOptions filterOptions;
+        DisplayOptions displayOptions;
+        std::uint64_t generation;
+    };
+
 private: // types:
 
     enum InitState {
@@ -137,7 +149,8 @@ public: // methods:
      * \brief Gets the shortcuts for the given group.
      *
      * Returns a hash of shortcuts for strings for the respective
-     * shortcut group.
+     * shortcut group. The groups are only read once from the configuration,
+     * as every new window reads the shortcuts of its group.
      * \param[in] shortcutGroup The group to retrieve shortcuts for.
      * \returns Hash of strings and lists of shortcuts.
      */
@@ -157,10 +170,8 @@ public: // methods:
     /** \returns FilterOptions structure containing filter settings. */
     static FilterOptions loadFilterOptionsFromGroup(BtConfigCore const & group);
 
-    FilterOptions getFilterOptions() const {
-        auto const group = const_cast<BtConfig *>(this)->session();
-        return loadFilterOptionsFromGroup(group);
-    }
+    FilterOptions getFilterOptions() const
+    { return optionsSnapshot()->filterOptions; }
 
     /**
        \brief Saves the current filter options.
@@ -173,10 +184,8 @@ public: // methods:
     static DisplayOptions loadDisplayOptionsFromGroup(
             BtConfigCore const & group);
 
-    DisplayOptions getDisplayOptions() const {
-        auto const group = const_cast<BtConfig *>(this)->session();
-        return loadDisplayOptionsFromGroup(group);
-    }
+    DisplayOptions getDisplayOptions() const
+    { return optionsSnapshot()->displayOptions; }
 
     /**
        \brief Saves the current display options.
@@ -185,6 +194,20 @@ public: // methods:
     static void storeDisplayOptionsToGroup(DisplayOptions const & options,
                                            BtConfigCore & group);
 
+    /**
+      \returns the filter and display options of the current session, which
+               are read from the settings whenever they are changed, so that
+               this may be called from any thread.
+    */
+    std::shared_ptr<OptionsSnapshot const> optionsSnapshot() const;
+
+    /**
+      \brief Reads the snapshot of the options again, needed after changing the
+             options of the session without storeFilterOptionsToGroup() and
+             storeDisplayOptionsToGroup().
+    */
+    void resetOptionsSnapshot();
+
     /*!
      * Returns a default font that is suitable for the current language.
      * \returns QFont suitable for current language.
@@ -206,12 +229,20 @@ public: // methods:
      * \brief Get font for a language.
      *
      * Gets a FontSettingsPair for the language given. If no font has been saved
-     * a default font is returned.
+     * a default font is returned. This is thread-safe and the fonts are read
+     * from the settings only once.
      * \param[in] language pointer to a language to get the font for.
      * \returns FontSettingsPair for given language
      */
     FontSettingsPair getFontForLanguage(Language const & language);
 
+    /*!
+     * \returns a number which changes whenever setFontForLanguage() is called,
+     *          so that derived data like style sheets can be cached.
+     */
+    std::uint64_t fontGeneration() const noexcept
+    { return m_fontGeneration.load(std::memory_order_acquire); }
+
     /// \todo: unit test these functions
     /*!
      * Returns the searchScopes for the current locale.
@@ -285,13 +316,20 @@ private: // fields:
     static BtConfig * m_instance; //!< singleton instance
 
     QFont m_defaultFont; //!< default font used when no special one is set
+    std::mutex m_fontCacheMutex;
     QHash<Language const *, FontSettingsPair> m_fontCache; //!< a cache for the fonts saved in the configuration file for speed
+    std::atomic<std::uint64_t> m_fontGeneration{0u};
+    mutable std::mutex m_optionsSnapshotMutex;
+    mutable std::shared_ptr<OptionsSnapshot const> m_optionsSnapshot;
+    std::uint64_t m_optionsGeneration = 0u;
 
     static StringMap m_defaultSearchScopes;
 
     QHash<QString, QString> m_sessionNames;
     QString m_currentSessionKey;
 
+    QHash<QString, ShortcutsMap> m_shortcutsCache; ///< By shortcut group
+
 }; /* class BtConfig */
 
 // declare types used in configuration as metatype so they can be saved directly into the configuration
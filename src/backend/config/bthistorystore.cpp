@@ -0,0 +1,99 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "bthistorystore.h"
+
+#include <algorithm>
+#include <utility>
+#include "../../util/btassert.h"
+#include "btconfig.h"
+
+
+namespace {
+auto const NextKey = QStringLiteral("next");
+} // anonymous namespace
+
+BtHistoryStore::BtHistoryStore(QString group,
+                               std::size_t const capacity,
+                               QString const & legacyKey)
+    : m_group(std::move(group))
+    , m_slots(capacity)
+{
+    BT_ASSERT(capacity > 0u);
+    auto const conf(btConfig().group(m_group));
+    if (conf.qVariantValue(NextKey).isValid()) {
+        m_next = conf.value<qulonglong>(NextKey);
+        for (std::size_t i = 0u; i < capacity; ++i)
+            m_slots[i] = conf.value<QString>(QString::number(i));
+        return;
+    }
+
+    if (legacyKey.isEmpty())
+        return;
+    auto const legacy(btConfig().value<QStringList>(legacyKey));
+    if (legacy.isEmpty())
+        return;
+    for (auto i = legacy.size(); i > 0; --i)
+        add(legacy.at(i - 1));
+    btConfig().remove(legacyKey);
+}
+
+BtHistoryStore BtHistoryStore::searchTexts()
+{ return {QStringLiteral("history/searchTexts"), 25u,
+          QStringLiteral("properties/searchTexts")}; }
+
+BtHistoryStore BtHistoryStore::searchModules()
+{ return {QStringLiteral("history/searchModules"), 11u,
+          QStringLiteral("history/searchModuleHistory")}; }
+
+void BtHistoryStore::add(QString const & text) {
+    if (text.isEmpty())
+        return;
+    auto const slot = static_cast<std::size_t>(m_next % capacity());
+    if (m_slots[slot] != text) {
+        for (std::size_t i = 0u; i < capacity(); ++i) {
+            if (m_slots[i] == text) {
+                m_slots[i].clear();
+                writeSlot(i);
+                break;
+            }
+        }
+        m_slots[slot] = text;
+        writeSlot(slot);
+    }
+    ++m_next;
+    writeNext();
+}
+
+QStringList BtHistoryStore::items() const {
+    QStringList r;
+    auto const used = std::min<std::uint64_t>(m_next, capacity());
+    for (std::uint64_t i = 1u; i <= used; ++i) {
+        auto const & text =
+                m_slots[static_cast<std::size_t>((m_next - i) % capacity())];
+        if (!text.isEmpty())
+            r.append(text);
+    }
+    return r;
+}
+
+void BtHistoryStore::writeSlot(std::size_t const slot) {
+    auto conf(btConfig().group(m_group));
+    if (m_slots[slot].isEmpty()) {
+        conf.remove(QString::number(slot));
+    } else {
+        conf.setValue(QString::number(slot), m_slots[slot]);
+    }
+}
+
+void BtHistoryStore::writeNext()
+{ btConfig().group(m_group).setValue(NextKey, qulonglong(m_next)); }
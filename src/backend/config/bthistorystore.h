@@ -0,0 +1,74 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+
+/**
+  \brief A history of texts of a fixed capacity, which is persisted in the
+         configuration incrementally.
+
+  The texts are kept in a ring of slots, each of which is a separate key of the
+  configuration group of the history. Adding a text writes only its slot, the
+  slot it was moved from, if any, and the position of the next slot, instead of
+  writing the whole history as a list.
+*/
+class BtHistoryStore {
+
+public: // methods:
+
+    /**
+      \param[in] group The configuration group of the history.
+      \param[in] capacity The number of texts kept.
+      \param[in] legacyKey A key of a string list holding the texts with the
+                           most recent first, which is moved to the group if
+                           the group is empty.
+    */
+    BtHistoryStore(QString group,
+                   std::size_t capacity,
+                   QString const & legacyKey = QString());
+
+    /** \returns the history of the texts searched for. */
+    static BtHistoryStore searchTexts();
+
+    /** \returns the history of the comma-separated names of searched works. */
+    static BtHistoryStore searchModules();
+
+    std::size_t capacity() const noexcept { return m_slots.size(); }
+
+    /**
+      \brief Adds the given text as the most recent one, dropping the least
+             recent one if needed. Empty texts are ignored.
+    */
+    void add(QString const & text);
+
+    /** \returns the texts with the most recent first. */
+    QStringList items() const;
+
+private: // methods:
+
+    void writeSlot(std::size_t slot);
+    void writeNext();
+
+private: // fields:
+
+    QString m_group;
+    std::vector<QString> m_slots; ///< Empty slots are unused
+    std::uint64_t m_next = 0u; ///< The number of texts ever added
+
+}; /* class BtHistoryStore */
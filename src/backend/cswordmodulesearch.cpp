@@ -13,40 +13,973 @@
 #include "cswordmodulesearch.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <QChar>
 #include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QStringList>
+#include <QStringMatcher>
+#include <QStringView>
+#include <QTemporaryFile>
+#include <QThread>
 #include <QtCore>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #include "../util/btassert.h"
+#include "../util/bttrace.h"
+#include "btindexingscheduler.h"
+#include "btlemmaindex.h"
 #include "config/btconfig.h"
 #include "drivers/cswordmoduleinfo.h"
+#include "keys/btbooknametable.h"
+#include "keys/btversificationtable.h"
+#include "keys/cswordversekey.h"
 #include "managers/cswordbackend.h"
+#include "rendering/btrendercontext.h"
+#include "rendering/btrendercontextpool.h"
 
 // Sword includes:
 #include <listkey.h>
+#include <swkey.h>
+#include <swmodule.h>
+#include <versekey.h>
 
 
 namespace CSwordModuleSearch {
 
+ScopeIntervals::ScopeIntervals(sword::ListKey const & scope,
+                               sword::VerseKey & key)
+{
+    for (int j = 0; j < scope.getCount(); j++) {
+        if (auto const * const vkey =
+                    dynamic_cast<sword::VerseKey const *>(scope.getElement(j)))
+        {
+            key.positionFrom(vkey->getLowerBound());
+            auto const lowerIndex = key.getIndex();
+            key.positionFrom(vkey->getUpperBound());
+            auto const upperIndex = key.getIndex();
+            if (lowerIndex <= upperIndex)
+                m_intervals.emplace_back(lowerIndex, upperIndex);
+        }
+    }
+
+    // Merge overlapping and adjacent intervals:
+    std::sort(m_intervals.begin(), m_intervals.end());
+    std::size_t numMerged = 0u;
+    for (auto const & interval : m_intervals) {
+        if (numMerged > 0u
+            && interval.first <= m_intervals[numMerged - 1u].second + 1)
+        {
+            auto & last = m_intervals[numMerged - 1u].second;
+            last = std::max(last, interval.second);
+        } else {
+            m_intervals[numMerged++] = interval;
+        }
+    }
+    m_intervals.resize(numMerged);
+}
+
+bool ScopeIntervals::contains(long const verseIndex) const noexcept {
+    auto const it =
+            std::upper_bound(m_intervals.begin(),
+                             m_intervals.end(),
+                             verseIndex,
+                             [](long const i, std::pair<long, long> const & p)
+                             { return i < p.first; });
+    return it != m_intervals.begin() && std::prev(it)->second >= verseIndex;
+}
+
+PendingHits::~PendingHits() noexcept = default;
+
+ModuleResultList::const_iterator::reference
+ModuleResultList::const_iterator::operator*() const {
+    if (!m_key)
+        m_key.reset(m_list->m_prototype->clone());
+    m_list->positionKey(*m_key, m_index);
+    return *m_key;
+}
+
+ModuleResultList::ModuleResultList(sword::SWKey const & prototype)
+    : m_prototype(prototype.clone())
+    , m_verseBased(dynamic_cast<sword::VerseKey const *>(&prototype))
+{}
+
+void ModuleResultList::append(sword::SWKey const & key) {
+    BT_ASSERT(m_prototype);
+    if (m_spillFile)
+        unspill();
+    if (m_verseBased) {
+        auto const index = static_cast<sword::VerseKey const &>(key).getIndex();
+        BT_ASSERT(index >= 0);
+        m_verseIndices.emplace_back(static_cast<std::uint32_t>(index));
+    } else {
+        m_keyTexts.emplace_back(key.getText());
+    }
+}
+
+void ModuleResultList::sortVerses() {
+    auto const indices = verseIndices();
+    if (!std::is_sorted(indices.begin(), indices.end())) {
+        unspill();
+        std::sort(m_verseIndices.begin(), m_verseIndices.end());
+    }
+}
+
+void ModuleResultList::fetchMore() {
+    if (auto const n = nextPageSize()) {
+        bool const wasSpilled = spilled();
+        m_pendingHits->fetch(size(), size() + n, *this);
+        if (wasSpilled)
+            spill();
+    }
+}
+
+std::size_t ModuleResultList::nextPageSize() const {
+    if (!m_pendingHits)
+        return 0u;
+    auto const begin = size();
+    auto const end =
+            std::min(begin + std::max(m_pendingHits->pageSize(), std::size_t(1u)),
+                     m_pendingHits->size());
+    return (begin < end) ? (end - begin) : 0u;
+}
+
+std::size_t ModuleResultList::memoryUsage() const noexcept {
+    auto r = m_verseIndices.capacity() * sizeof(std::uint32_t)
+             + m_keyTexts.capacity() * sizeof(std::string);
+    for (auto const & keyText : m_keyTexts)
+        if (keyText.capacity() >= sizeof(std::string)) // Not stored inline
+            r += keyText.capacity() + 1u;
+    return r;
+}
+
+bool ModuleResultList::spill() {
+    if (m_spillFile || !m_verseBased || m_verseIndices.empty())
+        return false;
+    auto file =
+            std::make_shared<QTemporaryFile>(
+                QDir::temp().filePath(
+                    QStringLiteral("bibletime-results-XXXXXX")));
+    auto const bytes =
+            static_cast<qint64>(m_verseIndices.size() * sizeof(std::uint32_t));
+    if (!file->open()
+        || file->write(reinterpret_cast<char const *>(m_verseIndices.data()),
+                       bytes) != bytes
+        || !file->flush())
+        return false;
+    // The mapping is page aligned and kept until the file is closed:
+    auto const * const data = file->map(0, bytes);
+    if (!data)
+        return false;
+    m_spilledVerseIndices =
+            std::span<std::uint32_t const>(
+                reinterpret_cast<std::uint32_t const *>(data),
+                m_verseIndices.size());
+    m_spillFile = std::move(file);
+    std::vector<std::uint32_t>().swap(m_verseIndices);
+    return true;
+}
+
+void ModuleResultList::unspill() {
+    if (!m_spillFile)
+        return;
+    m_verseIndices.assign(m_spilledVerseIndices.begin(),
+                          m_spilledVerseIndices.end());
+    m_spilledVerseIndices = {};
+    m_spillFile.reset();
+}
+
+ModuleResultList ModuleResultList::complete() const {
+    ModuleResultList r(*this);
+    if (r.hasMore()) {
+        r.m_pendingHits->fetch(r.size(), r.totalSize(), r);
+        r.sortVerses();
+        if (spilled())
+            r.spill();
+    }
+    r.m_pendingHits.reset();
+    return r;
+}
+
+std::optional<ModuleResultList>
+ModuleResultList::filtered(sword::ListKey const & scope) const {
+    if (!m_prototype || !m_verseBased)
+        return {};
+    if (hasMore())
+        return complete().filtered(scope);
+
+    std::unique_ptr<sword::SWKey> key(m_prototype->clone());
+    ScopeIntervals const intervals(scope,
+                                   static_cast<sword::VerseKey &>(*key));
+    ModuleResultList r;
+    r.m_prototype = m_prototype;
+    r.m_verseBased = true;
+    r.m_queryTerms = m_queryTerms;
+    auto const indices = verseIndices();
+    std::copy_if(indices.begin(),
+                 indices.end(),
+                 std::back_inserter(r.m_verseIndices),
+                 [&intervals](std::uint32_t const index)
+                 { return intervals.contains(index); });
+    return r;
+}
+
+std::optional<ModuleResultList>
+ModuleResultList::intersected(ModuleResultList const & other) const {
+    if (!m_prototype || !other.m_prototype
+        || m_verseBased != other.m_verseBased)
+        return {};
+    if (hasMore())
+        return complete().intersected(other);
+    if (other.hasMore())
+        return intersected(other.complete());
+
+    auto const intersect =
+            [](auto const & values, auto otherValues, auto & result) {
+                std::sort(otherValues.begin(), otherValues.end());
+                std::copy_if(values.begin(),
+                             values.end(),
+                             std::back_inserter(result),
+                             [&otherValues](auto const & value) {
+                                 return std::binary_search(otherValues.begin(),
+                                                           otherValues.end(),
+                                                           value);
+                             });
+            };
+    ModuleResultList r;
+    r.m_prototype = m_prototype;
+    r.m_verseBased = m_verseBased;
+    if (m_queryTerms && other.m_queryTerms) { // Both queries were searched for
+        auto queryTerms(*m_queryTerms);
+        queryTerms.terms.unite(other.m_queryTerms->terms);
+        queryTerms.phrases.insert(queryTerms.phrases.end(),
+                                  other.m_queryTerms->phrases.begin(),
+                                  other.m_queryTerms->phrases.end());
+        r.m_queryTerms =
+                std::make_shared<QueryTerms const>(std::move(queryTerms));
+    }
+    if (m_verseBased) {
+        auto const otherIndices = other.verseIndices();
+        intersect(verseIndices(),
+                  std::vector<std::uint32_t>(otherIndices.begin(),
+                                             otherIndices.end()),
+                  r.m_verseIndices);
+    } else {
+        intersect(m_keyTexts, other.m_keyTexts, r.m_keyTexts);
+    }
+    return r;
+}
+
+QString ModuleResultList::versification() const {
+    if (!m_prototype || !m_verseBased)
+        return {};
+    return QString::fromUtf8(static_cast<sword::VerseKey const &>(*m_prototype)
+                             .getVersificationSystem());
+}
+
+ModuleResultList ModuleResultList::withVerseIndices(
+        std::vector<std::uint32_t> verseIndices) const
+{
+    BT_ASSERT(m_prototype && m_verseBased);
+    ModuleResultList r;
+    r.m_prototype = m_prototype;
+    r.m_verseBased = true;
+    r.m_verseIndices = std::move(verseIndices);
+    r.m_queryTerms = m_queryTerms;
+    return r;
+}
+
+std::unique_ptr<sword::SWKey> ModuleResultList::keyAt(std::size_t index) const
+{
+    BT_ASSERT(index < size());
+    std::unique_ptr<sword::SWKey> key(m_prototype->clone());
+    positionKey(*key, index);
+    return key;
+}
+
+QString ModuleResultList::keyText(std::size_t const index) const {
+    BT_ASSERT(index < size());
+    if (m_verseBased) {
+        auto const & vk = static_cast<sword::VerseKey const &>(*m_prototype);
+        auto const p(BtVersificationTable::forVersification(versification())
+                     ->position(verseIndices()[index]));
+        auto text(BtBookNameTable::forLocale(vk.getLocale(),
+                                             vk.getVersificationSystem())
+                  ->keyText(p.testament, p.book, p.chapter, p.verse));
+        if (!text.isNull())
+            return text;
+    }
+    return QString::fromUtf8(keyAt(index)->getText());
+}
+
+void ModuleResultList::positionKey(sword::SWKey & key, std::size_t index) const
+{
+    if (m_verseBased) {
+        static_cast<sword::VerseKey &>(key).setIndex(verseIndices()[index]);
+    } else {
+        key.setText(m_keyTexts[index].c_str());
+    }
+}
+
+void retainResults(Results & results, std::size_t const first) {
+    static auto const budgetKey =
+            QStringLiteral("settings/behaviour/searchResultsMemoryBudget");
+    auto const budget =
+            static_cast<std::size_t>(
+                std::max(btConfig().value<int>(budgetKey, 0), 0)) * 1024u;
+    if (!budget)
+        return;
+
+    std::size_t total = 0u;
+    std::vector<ModuleResultList *> lists;
+    for (std::size_t i = 0u; i < results.size(); ++i) {
+        total += results[i].results.memoryUsage();
+        if (i >= first)
+            lists.emplace_back(&results[i].results);
+    }
+    std::sort(lists.begin(),
+              lists.end(),
+              [](ModuleResultList const * const a,
+                 ModuleResultList const * const b)
+              { return a->memoryUsage() > b->memoryUsage(); });
+    for (auto * const list : lists) {
+        if (total <= budget)
+            break;
+        auto const usage = list->memoryUsage();
+        if (list->spill())
+            total -= usage;
+    }
+}
+
+namespace {
+
+//Maximum number of module search results kept for repeated searches
+constexpr static std::size_t const BT_MAX_CACHED_SEARCH_RESULTS = 32u;
+
+//Default number of hits fetched at once from searches with very many hits
+constexpr static int const BT_DEFAULT_SEARCH_RESULT_PAGE_SIZE = 1000;
+
+/**
+  \returns the term by which the given search text narrows the given previous
+           search text, i.e. if it is the previous search text followed by
+           another AND term, or nothing otherwise.
+*/
+std::optional<QString> narrowingTerm(QString const & searchText,
+                                     QString const & previousText)
+{
+    static auto const andOperator = QStringLiteral(" AND ");
+    if (previousText.isEmpty()
+        || !searchText.startsWith(previousText)
+        || !QStringView(searchText).sliced(previousText.size())
+                                   .startsWith(andOperator))
+        return {};
+    auto const term(searchText.sliced(previousText.size()
+                                      + andOperator.size()).trimmed());
+
+    /* Any other operator might make the terms of the previous search optional,
+       and the terms need to be complete on their own: */
+    static QRegularExpression const otherOperatorRe(
+                QStringLiteral(R"PCRE(\b(OR|NOT)\b|\|\||(^|[\s(])[-!])PCRE"));
+    auto const isComplete =
+            [](QString const & text) {
+                return text.count('(') == text.count(')')
+                       && text.count('"') % 2 == 0;
+            };
+    if (term.isEmpty()
+        || previousText.contains(otherOperatorRe)
+        || term.contains(otherOperatorRe)
+        || !isComplete(previousText)
+        || !isComplete(term))
+        return {};
+    return term;
+}
+
+/**
+  \brief A bounded cache of the most recent search results of single modules.
+*/
+class ResultCache {
+
+public: // types:
+
+    struct Key {
+        QString moduleName;
+        QString indexStamp;
+        QString searchText;
+        QString scope;
+
+        bool operator==(Key const & other) const {
+            return moduleName == other.moduleName
+                   && indexStamp == other.indexStamp
+                   && searchText == other.searchText
+                   && scope == other.scope;
+        }
+    };
+
+public: // methods:
+
+    static ResultCache & instance() {
+        static ResultCache cache;
+        return cache;
+    }
+
+    std::optional<ModuleResultList> find(Key const & key) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        auto const it =
+                std::find_if(m_entries.begin(),
+                             m_entries.end(),
+                             [&key](Entry const & entry)
+                             { return entry.first == key; });
+        if (it == m_entries.end())
+            return {};
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        return it->second;
+    }
+
+    /**
+      \returns the results of the longest cached search of the same module and
+               scope which the search of the given key narrows by another AND
+               term, and that term.
+    */
+    std::optional<std::pair<ModuleResultList, QString>>
+    findNarrowed(Key const & key) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        auto best = m_entries.end();
+        QString bestTerm;
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            auto const & k = it->first;
+            if (k.moduleName != key.moduleName
+                || k.indexStamp != key.indexStamp
+                || k.scope != key.scope
+                || (best != m_entries.end()
+                    && k.searchText.size() <= best->first.searchText.size()))
+                continue;
+            if (auto term = narrowingTerm(key.searchText, k.searchText)) {
+                best = it;
+                bestTerm = std::move(*term);
+            }
+        }
+        if (best == m_entries.end())
+            return {};
+        m_entries.splice(m_entries.begin(), m_entries, best);
+        return std::pair(best->second, std::move(bestTerm));
+    }
+
+    void insert(Key key, ModuleResultList results) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.remove_if([&key](Entry const & entry)
+                            { return entry.first.moduleName == key.moduleName
+                                     && entry.first.indexStamp
+                                        != key.indexStamp; });
+        m_entries.emplace_front(std::move(key), std::move(results));
+        if (m_entries.size() > BT_MAX_CACHED_SEARCH_RESULTS)
+            m_entries.pop_back();
+    }
+
+    void countHit() noexcept
+    { m_hits.fetch_add(1u, std::memory_order_relaxed); }
+
+    void countMiss() noexcept
+    { m_misses.fetch_add(1u, std::memory_order_relaxed); }
+
+    std::uint64_t hits() const noexcept
+    { return m_hits.load(std::memory_order_relaxed); }
+
+    std::uint64_t misses() const noexcept
+    { return m_misses.load(std::memory_order_relaxed); }
+
+private: // types:
+
+    using Entry = std::pair<Key, ModuleResultList>;
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::list<Entry> m_entries;
+    std::atomic<std::uint64_t> m_hits{0u};
+    std::atomic<std::uint64_t> m_misses{0u};
+
+};
+
+QRegularExpressionMatch matchLemmaSearch(QString const & searchText) {
+    static QRegularExpression const lemmaSearchRe(
+                QStringLiteral(
+                    R"PCRE(^\s*(strong|morph):([^\s"*?\\]+)\s*$)PCRE"),
+                QRegularExpression::CaseInsensitiveOption);
+    return lemmaSearchRe.match(searchText);
+}
+
+/**
+  \brief Answers searches for a single Strong's number or morphological code,
+         e.g. "strong:H430", from the lemma index of the module.
+  \returns the results, or nothing if the search can not be answered this way.
+*/
+std::optional<ModuleResultList>
+searchLemmaIndex(CSwordModuleInfo const & module,
+                 QString const & searchText,
+                 sword::ListKey const & scope)
+{
+    auto const match = matchLemmaSearch(searchText);
+    if (!match.hasMatch())
+        return {};
+    auto const lemmaIndex(module.lemmaIndex());
+    if (!lemmaIndex)
+        return {};
+
+    std::unique_ptr<sword::SWKey> key(module.swordModule().createKey());
+    auto * const vk = dynamic_cast<sword::VerseKey *>(key.get());
+    if (!vk)
+        return {};
+    vk->setIntros(true);
+
+    ModuleResultList r(*vk);
+    auto const * const postings =
+            lemmaIndex->postings(
+                match.captured(1).compare(QStringLiteral("strong"),
+                                          Qt::CaseInsensitive) == 0
+                ? BtLemmaIndex::Kind::Lemma
+                : BtLemmaIndex::Kind::Morph,
+                match.captured(2));
+    if (!postings)
+        return r;
+
+    std::optional<ScopeIntervals> scopeIntervals;
+    if (scope.getCount() > 0) {
+        std::unique_ptr<sword::SWKey> scratchKey(vk->clone());
+        scopeIntervals.emplace(scope,
+                               static_cast<sword::VerseKey &>(*scratchKey));
+    }
+    for (auto const verseIndex : *postings) {
+        if (scopeIntervals && !scopeIntervals->contains(verseIndex))
+            continue;
+        vk->setIndex(verseIndex);
+        r.append(*vk);
+    }
+    return r;
+}
+
+ResultCache::Key resultCacheKey(CSwordModuleInfo const & module,
+                                QString const & searchText,
+                                sword::ListKey const & scope)
+{
+    return ResultCache::Key{module.name(),
+                            module.indexStamp(),
+                            searchText,
+                            (scope.getCount() > 0)
+                            ? QString::fromUtf8(scope.getRangeText())
+                            : QString()};
+}
+
+ModuleResultList searchModule(CSwordModuleInfo const & module,
+                              QString const & searchText,
+                              sword::ListKey const & scope,
+                              std::size_t const pageSize,
+                              int const maxThreads,
+                              BtCancellationToken const & cancellation)
+{
+    auto & cache = ResultCache::instance();
+    auto key(resultCacheKey(module, searchText, scope));
+    if (auto r = cache.find(key)) {
+        cache.countHit();
+        return std::move(*r);
+    }
+
+    // A scoped search can be done by filtering the results of an unscoped one:
+    if (!key.scope.isEmpty()) {
+        auto unscopedKey(key);
+        unscopedKey.scope.clear();
+        if (auto const unscoped = cache.find(unscopedKey)) {
+            if (auto r = unscoped->filtered(scope)) {
+                cache.countHit();
+                cache.insert(std::move(key), *r);
+                return std::move(*r);
+            }
+        }
+    }
+
+    /* A search narrowing a cached one by another AND term, e.g. while typing,
+       is answered by intersecting the cached results with those of the term: */
+    if (auto narrowed = cache.findNarrowed(key)) {
+        auto & [previous, term] = *narrowed;
+        if (previous.totalSize() == 0u) {
+            cache.countHit();
+            cache.insert(std::move(key), previous);
+            return std::move(previous);
+        }
+        auto const termResults(
+                searchModule(module,
+                             term,
+                             scope,
+                             pageSize,
+                             maxThreads,
+                             cancellation));
+        if (cancellation.cancelled())
+            return ModuleResultList();
+        if (auto r = previous.intersected(termResults)) {
+            cache.countHit();
+            cache.insert(std::move(key), *r);
+            return std::move(*r);
+        }
+    }
+
+    cache.countMiss();
+    auto r(searchLemmaIndex(module, searchText, scope));
+    if (!r)
+        r = module.searchIndexed(searchText,
+                                 scope,
+                                 pageSize,
+                                 cancellation,
+                                 maxThreads);
+    if (!cancellation.cancelled()) // Don't cache incomplete results
+        cache.insert(std::move(key), *r);
+    return std::move(*r);
+}
+
+/**
+  \brief Searches the modules in the combined index, unless the search can be
+         answered from the lemma indices.
+  \returns whether the modules were searched in the combined index.
+*/
+bool searchCombinedIndex(QString const & searchText,
+                         BtConstModuleList const & modules,
+                         sword::ListKey const & scope,
+                         ResultHandler const & handleResult)
+{
+    if (matchLemmaSearch(searchText).hasMatch())
+        return false;
+    auto results(CSwordModuleInfo::searchCombinedIndex(searchText,
+                                                       modules,
+                                                       scope));
+    if (!results)
+        return false;
+    auto & cache = ResultCache::instance();
+    for (std::size_t i = 0u; i < results->size(); ++i) {
+        auto & r = (*results)[i];
+        cache.insert(resultCacheKey(*modules.at(static_cast<int>(i)),
+                                    searchText,
+                                    scope),
+                     r);
+        handleResult(i, std::move(r));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+std::uint64_t resultCacheHits() noexcept
+{ return ResultCache::instance().hits(); }
+
+std::uint64_t resultCacheMisses() noexcept
+{ return ResultCache::instance().misses(); }
+
 Results search(QString const & searchText,
                BtConstModuleList const & modules,
                sword::ListKey scope)
 {
-    BT_ASSERT(std::all_of(modules.begin(),
-                          modules.end(),
-                          [](auto const * const m) { return m->hasIndex(); }));
-
     /// \todo What is the purpose of the following statement?
     CSwordBackend::instance().setFilterOptions(btConfig().getFilterOptions());
 
-    // Search module-by-module:
     Results r;
     r.reserve(modules.size());
     for (auto const * const m : modules)
-        r.emplace_back(
-                    ModuleSearchResult{m, m->searchIndexed(searchText, scope)});
+        r.emplace_back(ModuleSearchResult{m, {}});
+    search(searchText,
+           modules,
+           std::move(scope),
+           [&r](std::size_t const moduleIndex, ModuleResultList results)
+           { r[moduleIndex].results = std::move(results); },
+           {});
+    return r;
+}
+
+void search(QString const & searchText,
+            BtConstModuleList const & modules,
+            sword::ListKey scope,
+            ResultHandler const & handleResult,
+            BtCancellationToken const & cancellation)
+{
+    auto const stopRequested =
+            [&cancellation] { return cancellation.cancelled(); };
+
+    /* Queue the unindexed modules in search order, so that searching can start
+       as soon as the index of the first module is ready: */
+    auto & scheduler = BtIndexingScheduler::instance();
+    for (auto const * const m : modules)
+        scheduler.enqueue(m, BtIndexingScheduler::Priority::Search);
+
+    auto const waitForIndex =
+            [&scheduler, &stopRequested](CSwordModuleInfo const * const m) {
+                if (!scheduler.waitForIndices({m}, stopRequested)
+                    && !stopRequested())
+                    throw std::runtime_error(
+                            QObject::tr("Failed to create the index for work "
+                                        "%1.").arg(m->name()).toStdString());
+            };
+
+    auto const pageSize =
+            static_cast<std::size_t>(
+                std::max(btConfig().value<int>(
+                             QStringLiteral(
+                                 "settings/behaviour/searchResultPageSize"),
+                             BT_DEFAULT_SEARCH_RESULT_PAGE_SIZE),
+                         0));
+
+    /* Searching every module in a single pass of the combined index is faster
+       than opening and querying their indices one by one: */
+    if (modules.size() > 1
+        && QFileInfo(CSwordModuleInfo::getCombinedIndexLocation()).isDir())
+    {
+        for (auto const * const m : modules) {
+            waitForIndex(m);
+            if (stopRequested())
+                return;
+        }
+        if (searchCombinedIndex(searchText, modules, scope, handleResult))
+            return;
+    }
+
+    /* The configured number of search threads is shared by the modules searched
+       concurrently and the ranges of large indices searched concurrently by
+       each of them: */
+    auto const searchThreads =
+            std::max(btConfig().value<int>(
+                         QStringLiteral("settings/behaviour/searchThreads"),
+                         QThread::idealThreadCount()),
+                     1);
+    auto const numThreads =
+            std::min(searchThreads, static_cast<int>(modules.size()));
+    auto const rangeThreads = std::max(searchThreads / std::max(numThreads, 1),
+                                       1);
+    if (numThreads <= 1) { // Search module-by-module:
+        for (int i = 0; i < modules.size(); ++i) {
+            auto const * const m = modules.at(i);
+            waitForIndex(m);
+            if (stopRequested())
+                return;
+            handleResult(static_cast<std::size_t>(i),
+                         searchModule(*m,
+                                      searchText,
+                                      scope,
+                                      pageSize,
+                                      rangeThreads,
+                                      cancellation));
+        }
+        return;
+    }
+
+    // Wait for the indices in search order:
+    for (auto const * const m : modules) {
+        waitForIndex(m);
+        if (stopRequested())
+            return;
+    }
+
+    /* The modules of the regular backend are used by the GUI thread meanwhile,
+       hence each thread searches the modules of a borrowed render context,
+       with its own copy of the scope: */
+    struct Searcher {
+        std::unique_ptr<QThread> thread;
+        std::exception_ptr error;
+    };
+    std::vector<Searcher> searchers(static_cast<std::size_t>(numThreads));
+    std::atomic<std::size_t> next(0u);
+    auto const numModules = static_cast<std::size_t>(modules.size());
+    for (auto & searcher : searchers) {
+        searcher.thread.reset(QThread::create(
+            [&, scope, numModules, pageSize, rangeThreads] {
+                try {
+                    auto const context(
+                            Rendering::BtRenderContextPool::instance()
+                            .acquire());
+                    for (;;) {
+                        auto const i =
+                                next.fetch_add(1u, std::memory_order_relaxed);
+                        if (i >= numModules || stopRequested())
+                            return;
+                        auto const & name =
+                                modules.at(static_cast<int>(i))->name();
+                        auto const * const module = context->findModule(name);
+                        if (!module)
+                            throw std::runtime_error(
+                                    QObject::tr("The work %1 was not found.")
+                                    .arg(name).toStdString());
+                        handleResult(
+                                i,
+                                searchModule(
+                                    *module,
+                                    searchText,
+                                    scope,
+                                    pageSize,
+                                    rangeThreads,
+                                    cancellation));
+                    }
+                } catch (...) {
+                    searcher.error = std::current_exception();
+                }
+            }));
+        searcher.thread->start();
+    }
+    for (auto & searcher : searchers)
+        searcher.thread->wait();
+    for (auto & searcher : searchers)
+        if (searcher.error)
+            std::rethrow_exception(searcher.error);
+}
+
+ScanQuery::ScanQuery(QString const & searchText, SearchType const searchType)
+{
+    if (searchType == FullType) {
+        m_regex.emplace(searchText,
+                        QRegularExpression::CaseInsensitiveOption
+                        | QRegularExpression::UseUnicodePropertiesOption);
+        m_regex->optimize();
+        return;
+    }
+    m_matchAllWords = (searchType == AndType);
+    for (auto const & word : searchText.split(u' ', Qt::SkipEmptyParts))
+        m_words.emplace_back(word, Qt::CaseInsensitive);
+}
+
+bool ScanQuery::isValid() const {
+    if (m_regex)
+        return m_regex->isValid() && !m_regex->pattern().isEmpty();
+    return !m_words.empty();
+}
+
+bool ScanQuery::matches(QString const & plainText) const {
+    if (m_regex)
+        return m_regex->match(plainText).hasMatch();
+    auto const found =
+            [&plainText](QStringMatcher const & word)
+            { return word.indexIn(plainText) >= 0; };
+    return m_matchAllWords
+           ? std::all_of(m_words.begin(), m_words.end(), found)
+           : std::any_of(m_words.begin(), m_words.end(), found);
+}
+
+ModuleResultList scanModule(CSwordModuleInfo const & module,
+                            ScanQuery const & query,
+                            sword::ListKey const & scope,
+                            BtCancellationToken const & cancellation)
+{
+    auto & pool = Rendering::BtRenderContextPool::instance();
+    QStringList const moduleNames{module.name()};
+
+    std::unique_ptr<sword::SWKey> key(module.swordModule().createKey());
+    auto * const vk = dynamic_cast<sword::VerseKey *>(key.get());
+    if (!vk) {
+        // Other modules can only be iterated in order:
+        std::vector<QByteArray> keyTexts;
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        pool.submit(
+            [&](Rendering::BtRenderContext & context) {
+                auto const modules(context.findModules(moduleNames));
+                if (!modules.isEmpty()) {
+                    auto & m = modules.front()->swordModule();
+                    QString text;
+                    for (m.setPosition(sword::TOP);
+                         !m.popError() && !cancellation.cancelled();
+                         m.increment())
+                    {
+                        {
+                            auto const lock(CSwordBackend::lockSwordFiles());
+                            text = QString::fromUtf8(m.stripText());
+                        }
+                        if (query.matches(text))
+                            keyTexts.emplace_back(m.getKeyText());
+                    }
+                }
+                std::lock_guard<std::mutex> const guard(mutex);
+                done = true;
+                finished.notify_one();
+            },
+            Rendering::BtRenderContextPool::Priority::Interactive);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&done]{ return done; });
+
+        ModuleResultList r(*key);
+        for (auto const & keyText : keyTexts) {
+            key->setText(keyText.constData());
+            r.append(*key);
+        }
+        return r;
+    }
+
+    vk->setIntros(true);
+    vk->setPosition(sword::TOP);
+    auto const first = vk->getIndex();
+    vk->setPosition(sword::BOTTOM);
+    auto const last = vk->getIndex();
+
+    std::optional<ScopeIntervals> scopeIntervals;
+    if (scope.getCount() > 0) {
+        std::unique_ptr<sword::SWKey> scratchKey(vk->clone());
+        scopeIntervals.emplace(scope,
+                               static_cast<sword::VerseKey &>(*scratchKey));
+    }
+
+    // Scan consecutive chunks of the verses concurrently:
+    auto const numChunks = std::max(static_cast<long>(pool.size()), 1L);
+    auto const chunkSize = (last - first) / numChunks + 1;
+    std::vector<std::vector<long>> chunkResults(
+                static_cast<std::size_t>(numChunks));
+    std::mutex mutex;
+    std::condition_variable finished;
+    auto remaining = numChunks;
+    for (long chunk = 0; chunk < numChunks; ++chunk) {
+        pool.submit(
+            [&, chunk](Rendering::BtRenderContext & context) {
+                auto const modules(context.findModules(moduleNames));
+                if (!modules.isEmpty()) {
+                    auto & indices =
+                            chunkResults[static_cast<std::size_t>(chunk)];
+                    auto const begin = first + chunk * chunkSize;
+                    auto const end = std::min(begin + chunkSize, last + 1);
+                    CSwordVerseKey chunkKey(modules.front());
+                    chunkKey.setIntros(true);
+                    QString text;
+                    for (auto i = begin;
+                         i < end && !cancellation.cancelled();
+                         ++i)
+                    {
+                        if (scopeIntervals && !scopeIntervals->contains(i))
+                            continue;
+                        chunkKey.setIndex(i);
+                        chunkKey.strippedTextInto(text);
+                        if (query.matches(text))
+                            indices.push_back(i);
+                    }
+                }
+                std::lock_guard<std::mutex> const guard(mutex);
+                if (--remaining == 0)
+                    finished.notify_one();
+            },
+            Rendering::BtRenderContextPool::Priority::Interactive);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&remaining]{ return remaining == 0; });
+    }
+
+    ModuleResultList r(*vk);
+    for (auto const & indices : chunkResults) {
+        for (auto const verseIndex : indices) {
+            vk->setIndex(verseIndex);
+            r.append(*vk);
+        }
+    }
     return r;
 }
 
@@ -151,169 +1084,321 @@ QStringList queryParser(QString const & queryString) {
 static auto const spaceRegexpString(QStringLiteral(R"PCRE(\s+)PCRE"));
 static QRegularExpression const spaceRegexp(spaceRegexpString);
 
+/** \returns the Strong's numbers searched for by strong:.. terms. */
+QStringList searchedStrongsNumbers(QString const & searchedText) {
+    QStringList r;
+    for (auto const & word : searchedText.split(spaceRegexp,
+                                                Qt::SkipEmptyParts))
+    {
+        auto const sstIndex = word.indexOf(QStringLiteral("strong:"));
+        if (sstIndex != -1)
+            r.append(word.mid(sstIndex + 7));
+    }
+    return r;
+}
+
+/** \returns the given word with its accents folded as in the index. */
+QString foldedAccents(QString const & word) {
+    if (std::all_of(word.cbegin(),
+                    word.cend(),
+                    [](QChar const c) { return c.unicode() < 0x80; }))
+        return word;
+    auto const decomposed(word.normalized(QString::NormalizationForm_D));
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (auto const c : decomposed)
+        if (c.category() != QChar::Mark_NonSpacing)
+            folded.append(c);
+    return folded.normalized(QString::NormalizationForm_C);
+}
+
+template <typename Str>
+qsizetype skipIndexToTagEnd(Str const & str, qsizetype i) {
+    static QRegularExpression const re(QStringLiteral(R"PCRE(["'>])PCRE"));
+    for (;;) {
+        i = str.indexOf(re, i);
+        if (i < 0)
+            return i;
+
+        auto const match = str.at(i);
+        if (match == QLatin1Char('>'))
+            return i + 1;
+
+        // Skip to end of quoted attribute value:
+        i = str.indexOf(match, ++i);
+        if (i < 0)
+            return i;
+        ++i;
+    }
+}
+
 } // anonymous namespace
 
-QString highlightSearchedText(QString const & content,
-                              QString const & searchedText,
-                              bool plainSearchedText)
+Highlighter::Highlighter(QString const & searchedText,
+                         bool const plainSearchedText)
 {
-    static Qt::CaseSensitivity const cs = Qt::CaseInsensitive;
+    if (plainSearchedText) {
+        auto words = searchedText.split(spaceRegexp, Qt::SkipEmptyParts);
+        if (words.isEmpty())
+            return;
+        for (auto & word : words)
+            word = QRegularExpression::escape(word);
+        m_regex = QRegularExpression(words.join(spaceRegexpString));
+        m_regex.optimize();
+        m_hasRegex = true;
+        return;
+    }
 
-    static auto const skipIndexToTagEnd =
-        [](auto const & str, auto i) {
-            static QRegularExpression const re(
-                    QStringLiteral(R"PCRE(["'>])PCRE"));
-            for (;;) {
-                i = str.indexOf(re, i);
-                if (i < 0)
-                    return i;
-
-                auto const match = str.at(i);
-                if (match == QLatin1Char('>'))
-                    return i + 1;
-
-                // Skip to end of quoted attribute value:
-                i = str.indexOf(match, ++i);
-                if (i < 0)
-                    return i;
-                ++i;
+    // Collect the Strong's numbers to highlight by their lemma=".." attributes:
+    m_strongsNumbers = searchedStrongsNumbers(searchedText);
+
+    auto const query = queryParser(searchedText);
+    if (query.isEmpty())
+        return;
+    QString wordsRegexString;
+    for (auto const & word : query) {
+        QString wordRegexString;
+        auto const wordSize = word.size();
+        wordRegexString.reserve(wordSize + 3);
+
+        static QRegularExpression const wildCardRegex(
+            QStringLiteral(R"PCRE([*?])PCRE"));
+        auto fragmentEnd = word.indexOf(wildCardRegex);
+        decltype(fragmentEnd) fragmentStart = 0;
+        while (fragmentEnd >= 0) {
+            if (auto const fragmentSize = fragmentEnd - fragmentStart)
+                wordRegexString.append(
+                    QRegularExpression::escape(
+                        word.mid(fragmentStart, fragmentSize)));
+            wordRegexString.append(word.at(fragmentEnd) == QLatin1Char('*')
+                                   ? QStringLiteral(R"PCRE(\S*?)PCRE")
+                                   : QStringLiteral(R"PCRE(\S)PCRE"));
+            fragmentStart = fragmentEnd + 1;
+            fragmentEnd = word.indexOf(wildCardRegex, fragmentStart);
+        }
+        wordRegexString.append(
+            QRegularExpression::escape(word.mid(fragmentStart)));
+
+        if (!wordsRegexString.isEmpty())
+            wordsRegexString.append(QLatin1Char('|'));
+        wordsRegexString.append(wordRegexString);
+    }
+    m_regex =
+        QRegularExpression(
+            QStringLiteral(R"PCRE(\b(%1)\b)PCRE").arg(wordsRegexString),
+            QRegularExpression::CaseInsensitiveOption);
+    m_regex.optimize();
+    m_hasRegex = true;
+}
+
+Highlighter::Highlighter(QString const & searchedText,
+                         std::shared_ptr<QueryTerms const> queryTerms)
+{
+    if (!queryTerms) {
+        *this = Highlighter(searchedText);
+        return;
+    }
+    m_strongsNumbers = searchedStrongsNumbers(searchedText);
+    if (!queryTerms->empty())
+        m_queryTerms = std::move(queryTerms);
+}
+
+bool Highlighter::hasMatch(QString const & plainText) const {
+    if (m_queryTerms)
+        return !matchedWords(plainText, false).empty();
+    return m_hasRegex && m_regex.match(plainText).hasMatch();
+}
+
+std::vector<std::pair<qsizetype, qsizetype>>
+Highlighter::matchedWords(QStringView const text, bool const html) const {
+    BT_ASSERT(m_queryTerms);
+
+    // Split the text into words as the tokenizer of the index does:
+    struct Word {
+        qsizetype begin;
+        qsizetype end;
+        QString text;
+        QString folded;
+    };
+    std::vector<Word> words;
+    auto const isWordChar =
+            [](QChar const c)
+            { return c.isLetterOrNumber() || c.isMark() || c.isSurrogate(); };
+    for (qsizetype i = 0; i < text.size();) {
+        auto const c = text[i];
+        if (html && c == QLatin1Char('<')) {
+            i = skipIndexToTagEnd(text, i + 1);
+            if (i < 0)
+                break;
+            continue;
+        }
+        if (html && c == QLatin1Char('&')) { // Skip entities like &amp;
+            auto const end = text.indexOf(QLatin1Char(';'), i + 1);
+            if (end > i && end - i <= 10) {
+                i = end + 1;
+                continue;
             }
-        };
-
-    auto const bodyIndex =
-        [&content]{
-            static QRegularExpression const tagRe(
-                    QStringLiteral(R"PCRE(<body(>|\\s))PCRE"));
-            auto const i = content.indexOf(tagRe);
-            return (i < 0) ? 0 : skipIndexToTagEnd(content, i + 5);
-        }();
-    if (bodyIndex < 0)
-        return content;
+        }
+        if (!isWordChar(c)) {
+            ++i;
+            continue;
+        }
+        auto end = i + 1;
+        while (end < text.size() && isWordChar(text[end]))
+            ++end;
+        auto word(text.mid(i, end - i).toString().toLower());
+        auto folded(foldedAccents(word));
+        words.emplace_back(Word{i, end, std::move(word), std::move(folded)});
+        i = end;
+    }
 
-    auto ret = content.mid(bodyIndex);
+    auto const isTerm =
+            [&words](qsizetype const i, QString const & term) {
+                if (i < 0 || i >= static_cast<qsizetype>(words.size()))
+                    return false;
+                auto const & word = words[static_cast<std::size_t>(i)];
+                return word.text == term || word.folded == term;
+            };
+    std::vector<bool> matched(words.size(), false);
+    auto const & terms = m_queryTerms->terms;
+    for (std::size_t i = 0u; i < words.size(); ++i)
+        matched[i] = terms.contains(words[i].text)
+                     || terms.contains(words[i].folded);
 
-    if (!plainSearchedText) {
-        // find the strongs search lemma and highlight it
-        for (auto const & newSearchText
-             : searchedText.split(spaceRegexp, Qt::SkipEmptyParts))
-        {
-            // strong search text index for finding "strong:"
-            int sstIndex = newSearchText.indexOf(QStringLiteral("strong:"));
-            if (sstIndex == -1)
+    /* A phrase occurs where each of its terms is found near its position
+       relative to the first term, with the shifts of the terms differing by
+       at most the slop, like the sloppy phrase matching of the index: */
+    for (auto const & phrase : m_queryTerms->phrases) {
+        auto const & first = phrase.terms.front();
+        for (std::size_t i = 0u; i < words.size(); ++i) {
+            if (!isTerm(static_cast<qsizetype>(i), first.text))
                 continue;
+            auto const start = static_cast<qsizetype>(i) - first.position;
+            std::vector<qsizetype> found{static_cast<qsizetype>(i)};
+            qsizetype minShift = 0;
+            qsizetype maxShift = 0;
+            for (std::size_t k = 1u; k < phrase.terms.size(); ++k) {
+                auto const & term = phrase.terms[k];
+                auto const at = start + term.position;
+                std::optional<qsizetype> shift;
+                for (qsizetype d = 0; d <= phrase.slop && !shift; ++d) {
+                    if (isTerm(at - d, term.text)) {
+                        shift = -d;
+                    } else if (isTerm(at + d, term.text)) {
+                        shift = d;
+                    }
+                }
+                if (!shift) {
+                    found.clear();
+                    break;
+                }
+                found.emplace_back(at + *shift);
+                minShift = std::min(minShift, *shift);
+                maxShift = std::max(maxShift, *shift);
+            }
+            if (maxShift - minShift > phrase.slop)
+                continue;
+            for (auto const j : found)
+                matched[static_cast<std::size_t>(j)] = true;
+        }
+    }
 
-            // Get the strongs number from the search text.
-            // First, find the first space after "strong:"
-            sstIndex = sstIndex + 7;
+    std::vector<std::pair<qsizetype, qsizetype>> r;
+    for (std::size_t i = 0u; i < words.size(); ++i)
+        if (matched[i])
+            r.emplace_back(words[i].begin, words[i].end);
+    return r;
+}
 
-            // set the start index to the start of <body>
-            int strongIndex = 0;
+QString Highlighter::apply(QString const & content) const {
+    if (isEmpty())
+        return content;
+    BT_TRACE_SPAN("highlight searched text");
 
-            // get the strongs number -> the text following "strong:" to the end
-            // of the string. find all the "lemma=" inside the the content
-            while ((strongIndex =
-                    ret.indexOf(QStringLiteral("lemma="), strongIndex, cs))
-                   != -1)
-            {
-                // get the strongs number after the lemma and compare it with
-                // the strongs number we are looking for
-                int const idx1 = ret.indexOf('"', strongIndex) + 1;
-                int const idx2 = ret.indexOf('"', idx1 + 1);
-
-                // this is interesting because we could have a strongs number
-                // like G3218|G300. To handle this we will use some extra cpu
-                // cycles and do a partial match against the lemmaText
-                if (ret.mid(idx1, idx2 - idx1)
-                       .contains(newSearchText.mid(sstIndex, -1)))
-                {
-                    static auto const rep3 =
-                        QStringLiteral(R"HTML(class="highlightwords" )HTML");
-                    // strongs number is found now we need to highlight it
-                    // I believe the easiest way is to insert rep3 just before
-                    // "lemma="
-                    ret = ret.insert(strongIndex, rep3); /// \bug ?
-                    strongIndex += rep3.length();
+    static QRegularExpression const tagRe(
+            QStringLiteral(R"PCRE(<body(>|\s))PCRE"));
+    auto bodyIndex = content.indexOf(tagRe);
+    bodyIndex = (bodyIndex < 0) ? 0 : skipIndexToTagEnd(content, bodyIndex + 5);
+    if (bodyIndex < 0)
+        return content;
+
+    QStringView ret(content);
+    ret = ret.mid(bodyIndex);
+
+    /* Highlight the elements of the Strong's numbers, which are found by their
+       lemma attributes: */
+    QString withStrongs;
+    if (!m_strongsNumbers.isEmpty()) {
+        static Qt::CaseSensitivity const cs = Qt::CaseInsensitive;
+        static auto const rep3 =
+            QStringLiteral(R"HTML(class="highlightwords" )HTML");
+        decltype(ret.size()) copied = 0;
+        decltype(ret.size()) strongIndex = 0;
+        while ((strongIndex = ret.indexOf(u"lemma=", strongIndex, cs)) != -1) {
+            auto const idx1 = ret.indexOf(u'"', strongIndex) + 1;
+            auto const idx2 = ret.indexOf(u'"', idx1 + 1);
+
+            /* We could have a Strong's number like G3218|G300, hence the lemma
+               is partially matched against the Strong's numbers: */
+            auto const lemma = ret.mid(idx1, idx2 - idx1);
+            for (auto const & strongsNumber : m_strongsNumbers) {
+                if (lemma.contains(strongsNumber)) {
+                    /// \bug ? inserted once per matching Strong's number
+                    withStrongs.append(ret.mid(copied, strongIndex - copied));
+                    withStrongs.append(rep3);
+                    copied = strongIndex;
                 }
-                strongIndex += 6; // 6 is the length of "lemma="
             }
+            strongIndex += 6; // 6 is the length of "lemma="
+        }
+        if (copied > 0) {
+            withStrongs.append(ret.mid(copied));
+            ret = withStrongs;
         }
-        //---------------------------------------------------------------------
-        // now that the strong: stuff is out of the way continue with
-        // other search options
-        //---------------------------------------------------------------------
     }
 
-    QRegularExpression highlightRegex; // Construct highLightRegex:
-    if (plainSearchedText) {
-        auto words = searchedText.split(spaceRegexp, Qt::SkipEmptyParts);
-        if (words.isEmpty())
-            return content.left(bodyIndex) + ret;
-        for (auto & word : words)
-            word = QRegularExpression::escape(word);
-        highlightRegex = QRegularExpression(words.join(spaceRegexpString));
-    } else {
-        auto const query = queryParser(searchedText);
-        if (query.isEmpty())
-            return content.left(bodyIndex) + ret;
-        QString wordsRegexString;
-        for (auto const & word : query) {
-            QString wordRegexString;
-            auto const wordSize = word.size();
-            wordRegexString.reserve(wordSize + 3);
-
-            static QRegularExpression const wildCardRegex(
-                QStringLiteral(R"PCRE([*?])PCRE"));
-            auto fragmentEnd = word.indexOf(wildCardRegex);
-            decltype(fragmentEnd) fragmentStart = 0;
-            while (fragmentEnd >= 0) {
-                if (auto const fragmentSize = fragmentEnd - fragmentStart)
-                    wordRegexString.append(
-                        QRegularExpression::escape(
-                            word.mid(fragmentStart, fragmentSize)));
-                wordRegexString.append(word.at(fragmentEnd) == QLatin1Char('*')
-                                       ? QStringLiteral(R"PCRE(\S*?)PCRE")
-                                       : QStringLiteral(R"PCRE(\S)PCRE"));
-                fragmentStart = fragmentEnd + 1;
-                fragmentEnd = word.indexOf(wildCardRegex, fragmentStart);
-            }
-            wordRegexString.append(
-                QRegularExpression::escape(word.mid(fragmentStart)));
+    if (!m_hasRegex && !m_queryTerms)
+        return content.left(bodyIndex) + ret.toString();
+
+    QString r(content.left(bodyIndex));
+    r.reserve(content.size() + content.size() / 4);
 
-            if (!wordsRegexString.isEmpty())
-                wordsRegexString.append(QLatin1Char('|'));
-            wordsRegexString.append(wordRegexString);
+    if (m_queryTerms) {
+        qsizetype copied = 0;
+        for (auto const & [begin, end] : matchedWords(ret, true)) {
+            r.append(ret.mid(copied, begin - copied));
+            r.append(
+                    QStringLiteral(R"HTML(<span class="highlightwords">)HTML"));
+            r.append(ret.mid(begin, end - begin));
+            r.append(QStringLiteral(R"HTML(</span>)HTML"));
+            copied = end;
         }
-        highlightRegex =
-            QRegularExpression(
-                QStringLiteral(R"PCRE(\b(%1)\b)PCRE").arg(wordsRegexString),
-                QRegularExpression::CaseInsensitiveOption);
+        r.append(ret.mid(copied));
+        return r;
     }
 
-    QStringList r(content.left(bodyIndex));
-
     // Iterate over HTML text fragments:
-    auto fragmentStart = 0;
+    decltype(ret.size()) fragmentStart = 0;
     auto fragmentEnd = ret.indexOf(QLatin1Char('<'), fragmentStart);
     decltype(ret.size()) fragmentSize =
         (fragmentEnd < 0 ? ret.size() : fragmentEnd) - fragmentStart;
     for (QRegularExpressionMatch match;;) {
         if (fragmentSize > 0) {
-            QStringView const fragment(ret.constData() + fragmentStart,
-                                       fragmentSize);
+            auto const fragment = ret.mid(fragmentStart, fragmentSize);
             decltype(fragmentStart) searchStart = 0;
             for (;;) {
-                auto i = fragment.indexOf(highlightRegex, searchStart, &match);
+                auto i = fragment.indexOf(m_regex, searchStart, &match);
                 if (i < 0) {
-                    r << fragment.mid(searchStart).toString();
+                    r.append(fragment.mid(searchStart));
                     break;
                 }
 
-                if (auto const noMatchSize = i - searchStart) {
-                    r << fragment.mid(searchStart, noMatchSize).toString();
-                }
-                r << QStringLiteral(R"HTML(<span class="highlightwords">)HTML")
-                  << match.captured()
-                  << QStringLiteral(R"HTML(</span>)HTML");
+                if (auto const noMatchSize = i - searchStart)
+                    r.append(fragment.mid(searchStart, noMatchSize));
+                r.append(
+                        QStringLiteral(R"HTML(<span class="highlightwords">)HTML"));
+                r.append(match.capturedView());
+                r.append(QStringLiteral(R"HTML(</span>)HTML"));
                 searchStart = i + match.capturedLength();
             }
         }
@@ -321,15 +1406,24 @@ QString highlightSearchedText(QString const & content,
         if (fragmentEnd < 0)
             break;
         fragmentStart = skipIndexToTagEnd(ret, fragmentEnd + 1);
-        r << ret.mid(fragmentEnd, fragmentStart - fragmentEnd);
+        if (fragmentStart < 0) { // Unterminated tag
+            r.append(ret.mid(fragmentEnd));
+            break;
+        }
+        r.append(ret.mid(fragmentEnd, fragmentStart - fragmentEnd));
         fragmentEnd = ret.indexOf(QLatin1Char('<'), fragmentStart);
         fragmentSize =
-            (fragmentEnd < -1) ? ret.size() : (fragmentEnd - fragmentStart);
+            (fragmentEnd < 0 ? ret.size() : fragmentEnd) - fragmentStart;
     }
 
-    return r.join(QString());
+    return r;
 }
 
+QString highlightSearchedText(QString const & content,
+                              QString const & searchedText,
+                              bool plainSearchedText)
+{ return Highlighter(searchedText, plainSearchedText).apply(content); }
+
 QString prepareSearchText(QString const & orig, SearchType const searchType) {
     if (searchType == FullType)
         return orig;
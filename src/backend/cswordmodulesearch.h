@@ -12,10 +12,23 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <QMetaType>
+#include <QRegularExpression>
+#include <QSet>
 #include <QString>
+#include <QStringList>
+#include <QStringMatcher>
+#include <span>
+#include <string>
+#include <utility>
 #include <vector>
+#include "../util/btcancellationtoken.h"
 #include "drivers/btmodulelist.h"
 
 // Sword includes:
@@ -36,11 +49,330 @@
 
 class CSwordModuleInfo;
 class QDataStream;
-namespace sword { class SWKey; }
+class QTemporaryFile;
+namespace sword {
+class SWKey;
+class VerseKey;
+} // namespace sword
 
 namespace CSwordModuleSearch {
 
-using ModuleResultList = std::vector<std::shared_ptr<sword::SWKey const>>;
+/**
+  \brief The verse based elements of a search scope, compiled into a sorted
+         table of disjoint intervals of verse indices.
+*/
+class ScopeIntervals {
+
+public: // methods:
+
+    /**
+      \param[in] scope The search scope.
+      \param[in] key A key in the versification of the intervals, used as
+                     scratch space.
+    */
+    ScopeIntervals(sword::ListKey const & scope, sword::VerseKey & key);
+
+    /** \returns whether the verse index is within the scope. */
+    bool contains(long verseIndex) const noexcept;
+
+private: // fields:
+
+    std::vector<std::pair<long, long>> m_intervals;
+
+};
+
+class ModuleResultList;
+
+/**
+  \brief The terms of the index matched by a search query, lowercased as in
+         the index and with accents folded if matched in the unaccented field.
+*/
+struct QueryTerms {
+
+    /** The terms of a phrase or proximity query, e.g. "in the beginning"~3. */
+    struct Phrase {
+
+        struct Term {
+            QString text;
+            std::int32_t position; ///< The position relative to the phrase
+        };
+
+        std::vector<Term> terms;
+
+        /** How far the terms may be moved from their positions in total. */
+        std::int32_t slop = 0;
+
+    };
+
+    bool empty() const noexcept { return terms.isEmpty() && phrases.empty(); }
+
+    QSet<QString> terms; ///< The terms matched wherever they occur
+    std::vector<Phrase> phrases; ///< The terms matched only as phrases
+
+};
+
+/**
+  \brief The hits of a search which have not been fetched into a
+         ModuleResultList yet.
+  \note Implementations need to be thread-safe, since lists sharing the same
+        pending hits might be used from different threads.
+*/
+class PendingHits {
+
+public: // methods:
+
+    virtual ~PendingHits() noexcept;
+
+    /** \returns the total number of hits. */
+    virtual std::size_t size() const = 0;
+
+    /** \returns the number of hits fetched by ModuleResultList::fetchMore(). */
+    virtual std::size_t pageSize() const noexcept = 0;
+
+    /** \brief Appends the hits in the range [begin, end) to the given list. */
+    virtual void fetch(std::size_t begin,
+                       std::size_t end,
+                       ModuleResultList & results) const = 0;
+
+};
+
+/**
+  \brief The search results of a single module.
+
+  Instead of a cloned key per hit, only the verse indices of the hits are
+  stored for verse keyed modules, and the key texts of the hits otherwise. The
+  list keeps a single prototype key of the module, which carries its locale
+  and versification. Keys are only materialized when iterating over the list.
+
+  For searches with very many hits, the list might only contain the first page
+  of hits (see CSwordModuleInfo::searchIndexed()). The remaining hits are
+  fetched on demand by fetchMore() or complete(), while totalSize() reports the
+  number of all hits up front. Iteration only covers the fetched hits.
+
+  The verse indices of large results can be spilled to a memory-mapped
+  temporary file by spill(), which is shared by the copies of the list.
+*/
+class ModuleResultList {
+
+public: // types:
+
+    /**
+      \brief An iterator which materializes the keys of the list.
+      \note The referenced key is only valid until the iterator is advanced.
+    */
+    class const_iterator {
+
+        friend class ModuleResultList;
+
+    public: // types:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = sword::SWKey;
+        using difference_type = std::ptrdiff_t;
+        using pointer = sword::SWKey const *;
+        using reference = sword::SWKey const &;
+
+    public: // methods:
+
+        const_iterator(const_iterator const & copy)
+            : m_list(copy.m_list)
+            , m_index(copy.m_index)
+        {}
+
+        const_iterator & operator=(const_iterator const & copy) {
+            m_list = copy.m_list;
+            m_index = copy.m_index;
+            return *this;
+        }
+
+        reference operator*() const;
+        pointer operator->() const { return &**this; }
+
+        const_iterator & operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        bool operator==(const_iterator const & other) const noexcept
+        { return m_index == other.m_index; }
+
+        bool operator!=(const_iterator const & other) const noexcept
+        { return m_index != other.m_index; }
+
+    private: // methods:
+
+        const_iterator(ModuleResultList const & list, std::size_t index)
+            : m_list(&list)
+            , m_index(index)
+        {}
+
+    private: // fields:
+
+        ModuleResultList const * m_list;
+        std::size_t m_index;
+        mutable std::unique_ptr<sword::SWKey> m_key;
+
+    };
+
+public: // methods:
+
+    ModuleResultList() = default;
+
+    /**
+      \param[in] prototype A key of the module searched in. If it is a
+                           sword::VerseKey, verse indices are stored.
+    */
+    explicit ModuleResultList(sword::SWKey const & prototype);
+
+    /** \brief Appends the current position of the given key of the module. */
+    void append(sword::SWKey const & key);
+
+    /** \brief Sorts verse based results in verse order. */
+    void sortVerses();
+
+    /**
+      \returns the verse based results within the given scope, or nothing if
+               the results are not verse based.
+    */
+    std::optional<ModuleResultList> filtered(sword::ListKey const & scope)
+            const;
+
+    /**
+      \returns the results which are also in the given results of the same
+               module, in the order of this list, or nothing if the lists are
+               not comparable.
+    */
+    std::optional<ModuleResultList> intersected(ModuleResultList const & other)
+            const;
+
+    /**
+      \returns the versification system of verse based results, or a null
+               string if the results are not verse based.
+    */
+    QString versification() const;
+
+    /**
+      \returns a list of the same module with the given verse indices as hits.
+      \pre The results are verse based.
+    */
+    ModuleResultList withVerseIndices(std::vector<std::uint32_t> verseIndices)
+            const;
+
+    /**
+      \brief Makes the rest of the hits to be fetched on demand from the given
+             pending hits, of which all before size() are already in the list.
+    */
+    void setPendingHits(std::shared_ptr<PendingHits const> pendingHits) noexcept
+    { m_pendingHits = std::move(pendingHits); }
+
+    /**
+      \brief Keeps the terms matched by the query searched for, for
+             highlighting them by a Highlighter.
+    */
+    void setQueryTerms(std::shared_ptr<QueryTerms const> queryTerms) noexcept
+    { m_queryTerms = std::move(queryTerms); }
+
+    /**
+      \returns the terms matched by the query searched for, or nullptr if they
+               are unknown.
+    */
+    std::shared_ptr<QueryTerms const> const & queryTerms() const noexcept
+    { return m_queryTerms; }
+
+    /** \returns whether there are hits which have not been fetched yet. */
+    bool hasMore() const noexcept { return size() < totalSize(); }
+
+    /** \brief Fetches the next page of hits, if any. */
+    void fetchMore();
+
+    /** \returns the number of hits the next call to fetchMore() fetches. */
+    std::size_t nextPageSize() const;
+
+    /** \returns a copy of this list with all hits fetched. */
+    ModuleResultList complete() const;
+
+    /** \returns the number of fetched hits. */
+    std::size_t size() const noexcept {
+        return m_prototype
+               ? (m_verseBased ? verseIndices().size() : m_keyTexts.size())
+               : 0u;
+    }
+
+    /** \returns the number of all hits, including those not fetched yet. */
+    std::size_t totalSize() const
+    { return m_pendingHits ? m_pendingHits->size() : size(); }
+
+    bool empty() const noexcept { return size() == 0u; }
+
+    /**
+      \returns the number of bytes of memory used by the fetched hits, not
+               counting the memory-mapped hits spilled by spill().
+    */
+    std::size_t memoryUsage() const noexcept;
+
+    /**
+      \brief Moves the fetched verse indices to a memory-mapped temporary file,
+             which is removed with the last copy of the list.
+
+      Fetching more hits into a spilled list spills them as well, while other
+      changes read the verse indices back into memory first.
+      \returns whether the verse indices were spilled.
+    */
+    bool spill();
+
+    /** \returns whether the verse indices were spilled by spill(). */
+    bool spilled() const noexcept { return static_cast<bool>(m_spillFile); }
+
+    /** \returns a new key for the result at the given position. */
+    std::unique_ptr<sword::SWKey> keyAt(std::size_t index) const;
+
+    /**
+      \returns the text of the key of the result at the given position, which
+               is formatted from the book name tables for verse based results.
+    */
+    QString keyText(std::size_t index) const;
+
+    /**
+      \returns the verse indices of the fetched hits, which are empty unless
+               the results are verse based.
+    */
+    std::span<std::uint32_t const> verseIndices() const noexcept {
+        return m_spillFile
+               ? m_spilledVerseIndices
+               : std::span<std::uint32_t const>(m_verseIndices);
+    }
+
+    /**
+      \returns the key texts of the fetched hits, which are empty if the
+               results are verse based.
+    */
+    std::vector<std::string> const & keyTexts() const noexcept
+    { return m_keyTexts; }
+
+    const_iterator begin() const { return const_iterator(*this, 0u); }
+    const_iterator end() const { return const_iterator(*this, size()); }
+
+private: // methods:
+
+    void positionKey(sword::SWKey & key, std::size_t index) const;
+
+    /** \brief Reads the spilled verse indices back into memory, if any. */
+    void unspill();
+
+private: // fields:
+
+    std::shared_ptr<sword::SWKey const> m_prototype;
+    bool m_verseBased = false;
+    std::vector<std::uint32_t> m_verseIndices;
+    std::vector<std::string> m_keyTexts;
+    std::shared_ptr<PendingHits const> m_pendingHits;
+    std::shared_ptr<QueryTerms const> m_queryTerms;
+
+    /** The file mapping m_spilledVerseIndices, if spilled. */
+    std::shared_ptr<QTemporaryFile> m_spillFile;
+    std::span<std::uint32_t const> m_spilledVerseIndices;
+
+};
 
 struct ModuleSearchResult {
     CSwordModuleInfo const * module;
@@ -49,18 +381,179 @@ struct ModuleSearchResult {
 
 using Results = std::vector<ModuleSearchResult>;
 
+/**
+  \brief Spills the largest verse based results (see ModuleResultList::spill())
+         until the fetched hits of the given results use at most the memory
+         budget set by "settings/behaviour/searchResultsMemoryBudget" in KiB,
+         unless the budget is zero.
+  \param[in] first the index of the first result which may be spilled, e.g.
+                   when the earlier results were already copied elsewhere.
+*/
+void retainResults(Results & results, std::size_t first = 0u);
+
+/**
+  \returns the number of searches of single modules so far which were answered
+           from the cache of recent search results, including those narrowing
+           or filtering cached results.
+*/
+std::uint64_t resultCacheHits() noexcept;
+
+/**
+  \returns the number of searches of single modules so far which had to search
+           their index.
+*/
+std::uint64_t resultCacheMisses() noexcept;
+
 enum SearchType { /* Values provided for serialization */
     AndType = 0,
     OrType = 1,
     FullType = 2
 };
 
+using ResultHandler =
+        std::function<void(std::size_t moduleIndex, ModuleResultList results)>;
+
+/**
+  \brief Searches the given modules, indexing them first if needed.
+  \returns the results of all modules in the order of the given modules.
+*/
 Results search(QString const & searchText,
                BtConstModuleList const & modules,
                sword::ListKey scope);
 
+/**
+  \brief Searches the given modules and hands the results of each module to
+         the given handler as soon as they are ready.
+  \note The handler might be called in any order of the modules and from
+        several threads at once.
+  \param[in] cancellation Searching stops as soon as possible once this is
+                          cancelled. The results of the modules being searched
+                          then are incomplete and should be dropped.
+*/
+void search(QString const & searchText,
+            BtConstModuleList const & modules,
+            sword::ListKey scope,
+            ResultHandler const & handleResult,
+            BtCancellationToken const & cancellation);
+
+/**
+  \brief A query for scanning the text of modules without their indices (see
+         scanModule()).
+
+  Words are matched case-insensitively as substrings of the text, and a
+  FullType query is matched as a regular expression.
+*/
+class ScanQuery {
+
+public: // methods:
+
+    /**
+      \param[in] searchText The words to search for, or the regular expression
+                            to search for with FullType.
+      \param[in] searchType Whether all or any of the words need to match.
+    */
+    ScanQuery(QString const & searchText, SearchType searchType);
+
+    /** \returns whether the query is not empty and a valid expression. */
+    bool isValid() const;
+
+    /** \returns whether the given plain text matches the query. */
+    bool matches(QString const & plainText) const;
+
+private: // fields:
+
+    std::vector<QStringMatcher> m_words;
+    bool m_matchAllWords = false;
+    std::optional<QRegularExpression> m_regex;
+
+};
+
+/**
+  \brief Searches the given module without its index, by matching the stripped
+         text of all its entries with the given query.
+
+  The entries of verse based modules are scanned in chunks concurrently, each
+  on a render context of Rendering::BtRenderContextPool. Other modules are
+  scanned in order on a single render context.
+  \warning Must not be called by a thread holding a render context.
+*/
+ModuleResultList scanModule(CSwordModuleInfo const & module,
+                            ScanQuery const & query,
+                            sword::ListKey const & scope,
+                            BtCancellationToken const & cancellation);
+
+/**
+  \brief Highlights the searched text in HTML content. The search text is
+         parsed and compiled into a regular expression only once, hence a
+         highlighter should be kept and reused for all content to highlight.
+
+  Given the terms of the index matched by the query (see
+  ModuleResultList::queryTerms()), only the words of the content which are
+  any of these terms are highlighted instead, which are looked up in a hash
+  set instead of matching a regular expression. The terms of phrases are only
+  highlighted where they occur as the phrase, within the slop of proximity
+  queries, which is verified on the positions of the words in the content.
+*/
+class Highlighter {
+
+public: // methods:
+
+    /** Constructs a highlighter which highlights nothing. */
+    Highlighter() = default;
+
+    /**
+      \param[in] searchedText The search query, or plain words if
+                              plainSearchedText is set.
+    */
+    explicit Highlighter(QString const & searchedText,
+                         bool plainSearchedText = false);
+
+    /**
+      \param[in] searchedText The search query, which Strong's numbers are
+                              highlighted.
+      \param[in] queryTerms The terms matched by the query, or nullptr to
+                            highlight the words of the query instead.
+    */
+    Highlighter(QString const & searchedText,
+                std::shared_ptr<QueryTerms const> queryTerms);
+
+    bool isEmpty() const noexcept {
+        return !m_hasRegex && !m_queryTerms && m_strongsNumbers.isEmpty();
+    }
+
+    /** \returns the given content with the searched text highlighted. */
+    QString apply(QString const & content) const;
+
+    /**
+      \returns whether the searched text occurs in the given plain text.
+      \note Strong's numbers are not matched, since they are not part of plain
+            text.
+    */
+    bool hasMatch(QString const & plainText) const;
+
+private: // methods:
+
+    /**
+      \returns the [begin, end) ranges of the words of the given text which
+               are matched by the query terms, in order.
+      \param[in] html Whether to skip the tags and entities of HTML text.
+    */
+    std::vector<std::pair<qsizetype, qsizetype>> matchedWords(
+            QStringView text,
+            bool html) const;
+
+private: // fields:
+
+    QStringList m_strongsNumbers;
+    QRegularExpression m_regex;
+    bool m_hasRegex = false;
+    std::shared_ptr<QueryTerms const> m_queryTerms;
+
+};
+
 /**
 * This function highlights the searched text in the content using the search type given by search flags
+* \note Use a Highlighter when highlighting several contents.
 */
 QString highlightSearchedText(QString const & content,
                               QString const & searchedText,
@@ -76,3 +569,4 @@ QString prepareSearchText(QString const & orig, SearchType const searchType);
 QDataStream &operator<<(QDataStream &out, const CSwordModuleSearch::SearchType &searchType);
 QDataStream &operator>>(QDataStream &in, CSwordModuleSearch::SearchType &searchType);
 Q_DECLARE_METATYPE(CSwordModuleSearch::SearchType)
+Q_DECLARE_METATYPE(CSwordModuleSearch::ModuleResultList)
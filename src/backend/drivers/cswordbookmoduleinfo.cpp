@@ -13,7 +13,16 @@
 #include "cswordbookmoduleinfo.h"
 
 #include <QByteArray>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QIODevice>
+#include <QSaveFile>
+#include <utility>
 #include "../../util/btassert.h"
+#include "../../util/cp1252.h"
+#include "../../util/directory.h"
 #include "../keys/cswordtreekey.h"
 
 // Sword includes:
@@ -34,32 +43,151 @@
 #pragma GCC diagnostic pop
 
 
+//Increment this, if the format of the table of contents cache changes
+constexpr static quint32 const BT_BOOK_TOC_VERSION = 1u;
+
+namespace {
+
+QString tableOfContentsFileName(QString const & moduleName) {
+    return QStringLiteral("%1/%2.toc").arg(
+                util::directory::getUserCacheDir().absolutePath(),
+                moduleName);
+}
+
+} // anonymous namespace
+
+std::vector<int> CSwordBookModuleInfo::TableOfContents::children(
+        int const node) const
+{
+    std::vector<int> r;
+    for (auto i = m_nodes[node].firstChild; i >= 0; i = m_nodes[i].nextSibling)
+        r.push_back(i);
+    return r;
+}
+
+void CSwordBookModuleInfo::TableOfContents::append(quint32 const offset,
+                                                   int const parent,
+                                                   QString name)
+{
+    auto const i = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back(Node{offset, parent, -1, -1, std::move(name)});
+    m_lastChildren.push_back(-1);
+    if (offset > m_maxOffset)
+        m_maxOffset = offset;
+
+    int depth = 0;
+    if (parent >= 0) {
+        if (auto const previous = m_lastChildren[parent]; previous >= 0) {
+            m_nodes[previous].nextSibling = i;
+        } else {
+            m_nodes[parent].firstChild = i;
+        }
+        m_lastChildren[parent] = i;
+        for (auto p = parent; p >= 0; p = m_nodes[p].parent)
+            ++depth;
+    }
+    if (depth > m_depth)
+        m_depth = depth;
+}
+
 CSwordBookModuleInfo::CSwordBookModuleInfo(sword::SWModule & module,
                                            CSwordBackend & backend)
     : CSwordModuleInfo(module, backend, CSwordModuleInfo::GenericBook)
-    , m_depth(
-        [this]{
-            if (auto * const key = tree()) {
-                key->root();
-                int maxDepth = 0;
-                for (int depth = 0;;) {
-                    do {
-                        while (key->firstChild()) {
-                            ++depth;
-                        }
-                    } while (key->nextSibling());
-                    if (depth > maxDepth)
-                        maxDepth = depth;
-                    do {
-                        if (!key->parent())
-                            return maxDepth;
-                        --depth;
-                    } while (!key->nextSibling());
+{}
+
+CSwordBookModuleInfo::TableOfContents const &
+CSwordBookModuleInfo::tableOfContents() const {
+    if (m_tableOfContents)
+        return *m_tableOfContents;
+    m_tableOfContents = std::make_unique<TableOfContents>();
+    auto & toc = *m_tableOfContents;
+
+    auto const * const treeKey = tree();
+    if (!treeKey)
+        return toc;
+
+    auto const moduleVersion(config(CSwordModuleInfo::ModuleVersion).toUtf8());
+    QFile cacheFile(tableOfContentsFileName(name()));
+    if (cacheFile.open(QIODevice::ReadOnly)) {
+        QDataStream s(&cacheFile);
+        s.setVersion(QDataStream::Qt_6_5);
+        quint32 version;
+        QByteArray cachedModuleVersion;
+        quint32 numNodes;
+        s >> version >> cachedModuleVersion >> numNodes;
+        if (s.status() == QDataStream::Ok
+            && version == BT_BOOK_TOC_VERSION
+            && cachedModuleVersion == moduleVersion)
+        {
+            for (quint32 i = 0u;
+                 i < numNodes && s.status() == QDataStream::Ok;
+                 ++i)
+            {
+                quint32 offset;
+                qint32 parent;
+                QString nodeName;
+                s >> offset >> parent >> nodeName;
+                if (parent >= static_cast<qint32>(i)
+                    || (parent < 0) != (i == 0u))
+                    s.setStatus(QDataStream::ReadCorruptData);
+                else
+                    toc.append(offset, parent, std::move(nodeName));
+            }
+            if (s.status() == QDataStream::Ok && !toc.m_nodes.empty()) {
+                toc.m_lastChildren = {};
+                return toc;
+            }
+        }
+        qDebug() << "Rebuilding the table of contents cache of" << name();
+        toc = TableOfContents();
+        cacheFile.close();
+    }
+
+    // Walk the tree depth-first, appending the nodes in their order:
+    sword::TreeKeyIdx key(*treeKey);
+    auto const localName =
+            [this, &key] {
+                return isUnicode()
+                       ? QString::fromUtf8(key.getLocalName())
+                       : util::cp1252::toUnicode(key.getLocalName());
+            };
+    key.root();
+    toc.append(key.getOffset(), -1, localName());
+    for (int current = 0; current >= 0;) {
+        if (key.firstChild()) {
+            toc.append(key.getOffset(), current, localName());
+        } else {
+            // Ascend until there is a next sibling, ending at the root:
+            while (!key.nextSibling()) {
+                if (!key.parent()) {
+                    current = -1;
+                    break;
                 }
+                current = toc.m_nodes[current].parent;
             }
-            return -1;
-        }())
-{}
+            if (current < 0)
+                break;
+            toc.append(key.getOffset(),
+                       toc.m_nodes[current].parent,
+                       localName());
+        }
+        current = static_cast<int>(toc.m_nodes.size()) - 1;
+    }
+    toc.m_lastChildren = {};
+
+    QSaveFile saveFile(cacheFile.fileName());
+    if (saveFile.open(QIODevice::WriteOnly)) {
+        QDataStream s(&saveFile);
+        s.setVersion(QDataStream::Qt_6_5);
+        s << BT_BOOK_TOC_VERSION << moduleVersion
+          << static_cast<quint32>(toc.m_nodes.size());
+        for (auto const & node : toc.m_nodes)
+            s << node.offset << static_cast<qint32>(node.parent) << node.name;
+        if (s.status() != QDataStream::Ok || !saveFile.commit())
+            qWarning() << "Failed to write" << saveFile.fileName();
+    }
+    return toc;
+}
 
 sword::TreeKeyIdx * CSwordBookModuleInfo::tree() const {
     auto * const currentKey = swordModule().getKey();
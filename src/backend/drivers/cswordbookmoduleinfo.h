@@ -14,8 +14,11 @@
 
 #include "cswordmoduleinfo.h"
 
+#include <memory>
 #include <QObject>
 #include <QString>
+#include <QtGlobal>
+#include <vector>
 
 
 class CSwordBackend;
@@ -29,6 +32,56 @@ class CSwordBookModuleInfo final: public CSwordModuleInfo {
 
     Q_OBJECT
 
+public: // Types:
+
+    /**
+      \brief The tree of contents of a book module.
+
+      The tree is built once per module by walking its sword::TreeKeyIdx and is
+      cached in the user cache directory, so the key chooser and the text model
+      do not need to walk the tree of big books again. Node 0 is the root node.
+    */
+    class TableOfContents {
+
+        friend class CSwordBookModuleInfo;
+
+    public: // types:
+
+        struct Node {
+            quint32 offset;
+            int parent;
+            int firstChild;
+            int nextSibling;
+            QString name;
+        };
+
+    public: // methods:
+
+        /** \returns the maximal depth of sections and subsections. */
+        int depth() const noexcept { return m_depth; }
+
+        Node const & node(int i) const noexcept { return m_nodes[i]; }
+
+        /** \returns the child nodes of the given node in their order. */
+        std::vector<int> children(int node) const;
+
+        /** \returns the highest offset of all nodes in the index. */
+        quint32 maxOffset() const noexcept { return m_maxOffset; }
+
+    private: // methods:
+
+        /** \brief Appends a node as the last child of the given parent. */
+        void append(quint32 offset, int parent, QString name);
+
+    private: // fields:
+
+        std::vector<Node> m_nodes;
+        std::vector<int> m_lastChildren;
+        int m_depth = -1;
+        quint32 m_maxOffset = 0u;
+
+    }; /* class TableOfContents */
+
 public: // Methods:
 
     /**
@@ -37,8 +90,17 @@ public: // Methods:
     */
     CSwordBookModuleInfo(sword::SWModule & module, CSwordBackend & usedBackend);
 
-    /** \returns the maximal depth of sections and subsections. */
-    int depth() const noexcept { return m_depth; }
+    /**
+      \returns the maximal depth of sections and subsections, which is taken
+               from the tree of contents and thus only computed on first use.
+    */
+    int depth() const { return tableOfContents().depth(); }
+
+    /**
+      \returns the tree of contents of this module, which is loaded from its
+               cache file or built on the first call.
+    */
+    TableOfContents const & tableOfContents() const;
 
     /**
       \returns A treekey filled with the structure of this module. Don't delete
@@ -50,6 +112,6 @@ public: // Methods:
 
 private: // Fields:
 
-    int const m_depth;
+    mutable std::unique_ptr<TableOfContents> m_tableOfContents;
 
 };
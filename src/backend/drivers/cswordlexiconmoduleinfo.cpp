@@ -12,17 +12,27 @@
 
 #include "cswordlexiconmoduleinfo.h"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <QChar>
-#include <QDataStream>
+#include <QDate>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QIODevice>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtEndian>
+#include <utility>
+#include <vector>
+#include "../../util/btassert.h"
 #include "../../util/cp1252.h"
 #include "../../util/directory.h"
 #include "../keys/cswordldkey.h"
+#include "../managers/cswordbackend.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -44,10 +54,230 @@
 namespace {
 
 // Change it once the format changed to make all systems rebuild their caches
-constexpr quint8 const cacheFormat = 4;
+constexpr quint8 const cacheFormat = 6;
+
+/* The cache file consists of little-endian 32-bit integers and UTF-8 data in
+   the following order, so that it can be memory-mapped as is:
+     - the 4 bytes of cacheMagic and the cacheFormat
+     - the size of the module version, followed by the module version padded to
+       a multiple of 4 bytes
+     - the number of entries N, followed by N + 1 offsets into the blob
+     - the N entry indices ordered by their case-insensitively compared keys
+     - the blob of all keys, each key i ranging from offset i to offset i + 1 */
+constexpr char const cacheMagic[4] = {'B', 'T', 'L', 'X'};
+
+quint32 readUInt32(char const * const data) noexcept
+{ return qFromLittleEndian<quint32>(data); }
+
+void appendUInt32(QByteArray & data, quint32 const value) {
+    auto const v = qToLittleEndian(value);
+    data.append(reinterpret_cast<char const *>(&v), sizeof(v));
+}
+
+/**
+  \returns the size of the header of the given cache data up to and including
+           the padded module version, or -1 if the header is not valid for the
+           current cacheFormat and the given module version.
+*/
+qsizetype headerSize(char const * const data,
+                     qsizetype const size,
+                     QByteArray const & moduleVersion) noexcept
+{
+    if (size < 12
+        || std::memcmp(data, cacheMagic, sizeof(cacheMagic)) != 0
+        || readUInt32(data + 4) != cacheFormat)
+        return -1;
+    qsizetype const versionSize = readUInt32(data + 8);
+    if (versionSize > size - 12
+        || QByteArrayView(data + 12, versionSize) != moduleVersion)
+        return -1;
+    return 12 + ((versionSize + 3) & ~qsizetype(3));
+}
+
+QString cacheFileName(QString const & moduleName) {
+    return QStringLiteral("%1/%2").arg(
+                util::directory::getUserCacheDir().absolutePath(),
+                moduleName);
+}
+
+/**
+  \returns the files the keys of the given module are read from, the prebuilt
+           one of the shared cache directory first, so that all users map the
+           same file if it is up to date.
+*/
+QStringList cacheFileNames(QString const & moduleName) {
+    QStringList r;
+    if (auto const & sharedDir = util::directory::getSharedCacheDir())
+        r.append(sharedDir->absoluteFilePath(moduleName));
+    r.append(cacheFileName(moduleName));
+    return r;
+}
+
+QByteArray serializeEntries(QByteArray const & moduleVersion,
+                            std::vector<QByteArray> const & keys)
+{
+    qsizetype blobSize = 0;
+    for (auto const & key : keys)
+        blobSize += key.size();
+    auto const paddedVersionSize = (moduleVersion.size() + 3) & ~qsizetype(3);
+
+    std::vector<quint32> order(keys.size());
+    {
+        std::vector<QString> decodedKeys;
+        decodedKeys.reserve(keys.size());
+        for (auto const & key : keys)
+            decodedKeys.emplace_back(QString::fromUtf8(key));
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(),
+                         order.end(),
+                         [&decodedKeys](quint32 const a, quint32 const b) {
+                             return QString::compare(decodedKeys[a],
+                                                     decodedKeys[b],
+                                                     Qt::CaseInsensitive) < 0;
+                         });
+    }
+
+    QByteArray r;
+    r.reserve(16 + paddedVersionSize
+              + 8 * static_cast<qsizetype>(keys.size()) + blobSize);
+    r.append(cacheMagic, sizeof(cacheMagic));
+    appendUInt32(r, cacheFormat);
+    appendUInt32(r, static_cast<quint32>(moduleVersion.size()));
+    r.append(moduleVersion);
+    r.append(paddedVersionSize - moduleVersion.size(), '\0');
+    appendUInt32(r, static_cast<quint32>(keys.size()));
+    quint32 offset = 0u;
+    appendUInt32(r, offset);
+    for (auto const & key : keys) {
+        offset += static_cast<quint32>(key.size());
+        appendUInt32(r, offset);
+    }
+    for (auto const index : order)
+        appendUInt32(r, index);
+    for (auto const & key : keys)
+        r.append(key);
+    return r;
+}
 
 } // Anonymous namespace
 
+CSwordLexiconModuleInfo::Entries::Entries() noexcept = default;
+
+CSwordLexiconModuleInfo::Entries::Entries(Entries &&) noexcept = default;
+
+CSwordLexiconModuleInfo::Entries::~Entries() = default;
+
+CSwordLexiconModuleInfo::Entries &
+CSwordLexiconModuleInfo::Entries::operator=(Entries &&) noexcept = default;
+
+QByteArrayView
+CSwordLexiconModuleInfo::Entries::utf8At(qsizetype const i) const noexcept {
+    BT_ASSERT(i >= 0 && i < m_size);
+    auto const begin = readUInt32(m_offsets + 4 * i);
+    auto const end = readUInt32(m_offsets + 4 * (i + 1));
+    return QByteArrayView(m_blob + begin, end - begin);
+}
+
+qsizetype CSwordLexiconModuleInfo::Entries::indexOf(QString const & key) const
+{
+    // Keys equal but for their case are consecutive in the sorted order:
+    auto const needle(key.toUtf8());
+    for (auto position = lowerBound(key); position < m_size; ++position) {
+        auto const i = sortedIndex(position);
+        auto const entry = utf8At(i);
+        if (entry == needle)
+            return i;
+        if (QString::compare(QString::fromUtf8(entry),
+                             key,
+                             Qt::CaseInsensitive) != 0)
+            break;
+    }
+    return -1;
+}
+
+qsizetype CSwordLexiconModuleInfo::Entries::sortedIndex(
+        qsizetype const position) const noexcept
+{
+    BT_ASSERT(position >= 0 && position < m_size);
+    return readUInt32(m_order + 4 * position);
+}
+
+qsizetype
+CSwordLexiconModuleInfo::Entries::lowerBound(QString const & key) const {
+    qsizetype first = 0;
+    for (auto count = m_size; count > 0;) {
+        auto const step = count / 2;
+        if (QString::compare(at(sortedIndex(first + step)),
+                             key,
+                             Qt::CaseInsensitive) < 0)
+        {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+qsizetype CSwordLexiconModuleInfo::Entries::nearest(QString const & key) const
+{
+    if (auto const i = indexOf(key); i >= 0)
+        return i;
+    if (!m_size)
+        return -1;
+    return sortedIndex(std::min(lowerBound(key), m_size - 1));
+}
+
+QStringList CSwordLexiconModuleInfo::Entries::toStringList() const {
+    QStringList r;
+    r.reserve(m_size);
+    for (qsizetype i = 0; i < m_size; ++i)
+        r.append(at(i));
+    return r;
+}
+
+std::size_t CSwordLexiconModuleInfo::Entries::mappedBytes() const noexcept
+{ return m_file ? static_cast<std::size_t>(m_file->size()) : 0u; }
+
+bool CSwordLexiconModuleInfo::Entries::setData(
+        char const * const data,
+        qsizetype const size,
+        QByteArray const & moduleVersion) noexcept
+{
+    auto pos = headerSize(data, size, moduleVersion);
+    if (pos < 0 || pos > size - 4)
+        return false;
+    qsizetype const numEntries = readUInt32(data + pos);
+    pos += 4;
+    if (size - pos < 4 + 8 * numEntries)
+        return false;
+    auto const * const offsets = data + pos;
+    pos += 4 * (numEntries + 1);
+    auto const * const order = data + pos;
+    pos += 4 * numEntries;
+
+    // Validate the offsets once, so that utf8At() needs no checks:
+    quint32 previous = 0u;
+    for (qsizetype i = 0; i <= numEntries; ++i) {
+        auto const offset = readUInt32(offsets + 4 * i);
+        if (offset < previous || (i == 0 && offset != 0u))
+            return false;
+        previous = offset;
+    }
+    if (previous != static_cast<quint64>(size - pos))
+        return false;
+    for (qsizetype i = 0; i < numEntries; ++i)
+        if (readUInt32(order + 4 * i) >= static_cast<quint64>(numEntries))
+            return false;
+
+    m_offsets = offsets;
+    m_order = order;
+    m_blob = data + pos;
+    m_size = numEntries;
+    return true;
+}
+
 CSwordLexiconModuleInfo::CSwordLexiconModuleInfo(sword::SWModule & module,
                                                  CSwordBackend & backend)
         : CSwordModuleInfo(module, backend, Lexicon)
@@ -74,90 +304,22 @@ CSwordLexiconModuleInfo::CSwordLexiconModuleInfo(sword::SWModule & module,
     }
 }
 
-const QStringList &CSwordLexiconModuleInfo::entries() const {
-    namespace DU = util::directory;
-
+CSwordLexiconModuleInfo::Entries const &
+CSwordLexiconModuleInfo::entries() const {
     // If cache is ok, just return it:
-    if (!m_entries.empty()) {
+    if (m_entriesLoaded)
         return m_entries;
-    }
+    m_entriesLoaded = true;
 
-    QFile cacheFile(QStringLiteral("%1/%2")
-                    .arg(DU::getUserCacheDir().absolutePath(), name()));
-
-    QString const moduleVersion = config(CSwordModuleInfo::ModuleVersion);
-
-    auto const writeCache = [this,&cacheFile,&moduleVersion]{
-        qDebug() << "Writing cache file" << cacheFile.fileName();
-        if (cacheFile.open(QIODevice::WriteOnly)) {
-            QDataStream s(&cacheFile);
-            s.setVersion(QDataStream::Qt_5_15);
-            s << moduleVersion
-              << QString::number(cacheFormat)
-              << QString::number(QDataStream::Qt_DefaultCompiledVersion);
-            s.setVersion(QDataStream::Qt_DefaultCompiledVersion);
-            s << m_entries;
-            cacheFile.close();
-
-            if (s.status() == QDataStream::Ok) {
-                qDebug() << "Cache file written successfully!";
-            } else {
-                qDebug() << "Failed to write cache file! Attempting to remove.";
-                if (cacheFile.remove()) {
-                    qDebug() << "Removed potentially corrupt cache.";
-                } else {
-                    qDebug() << "Failed to remove potentially corrupt cache!";
-                }
-            }
-        } else {
-            qDebug() << "Failed to open cache file for writing!";
-        }
-    };
+    auto const moduleVersion(
+                config(CSwordModuleInfo::ModuleVersion).toUtf8());
 
     /*
      * Try the module's cache
      */
-    if (cacheFile.open(QIODevice::ReadOnly)) {
-        qDebug() << "Reading lexicon cache for module" << name() << "...";
-        QDataStream s(&cacheFile);
-        s.setVersion(QDataStream::Qt_5_15);
-        QString str;
-        s >> str;
-        qDebug() << "  module version:" << str;
-        if (str == moduleVersion) {
-            s >> str;
-            qDebug() << "  cache version:" << str;
-            bool isNumber = false;
-            auto const cacheVersion = str.toInt(&isNumber);
-            if (isNumber && cacheVersion <= cacheFormat) {
-                s >> str;
-                qDebug() << "  QDataStream version:" << str;
-                auto const dataStreamVersion = str.toInt(&isNumber);
-                if (isNumber
-                    && dataStreamVersion
-                        <= QDataStream::Qt_DefaultCompiledVersion)
-                {
-                    auto const resetVersion = cacheVersion >= 4;
-                    qDebug() << "  QDataStream version reset:" << resetVersion;
-                    if (resetVersion)
-                        s.setVersion(dataStreamVersion);
-                    s >> m_entries;
-                    if (s.status() == QDataStream::Ok) {
-                        qDebug() << "  entries read:" << m_entries.size();
-                        cacheFile.close();
-
-                        // Update cache format:
-                        if (cacheVersion != cacheFormat)
-                            writeCache();
-
-                        return m_entries;
-                    }
-                    m_entries.clear();
-                }
-            }
-        }
-
-        cacheFile.close();
+    if (auto cached = cachedEntries(name(), moduleVersion)) {
+        m_entries = *std::move(cached);
+        return m_entries;
     }
 
     /*
@@ -165,6 +327,8 @@ const QStringList &CSwordLexiconModuleInfo::entries() const {
      */
     qDebug() << "Read all entries of lexicon" << name();
 
+    std::vector<QByteArray> keys;
+    prefetchDataFiles(); // All keys are read in order
     auto & m = swordModule();
     m.setSkipConsecutiveLinks(true);
     m.setPosition(sword::TOP);
@@ -172,12 +336,12 @@ const QStringList &CSwordLexiconModuleInfo::entries() const {
 
     if (isUnicode()) {
         do {
-            m_entries.append(QString::fromUtf8(m.getKeyText()));
+            keys.emplace_back(m.getKeyText());
             m.increment();
         } while (!m.popError());
     } else {
         do {
-            m_entries.append(util::cp1252::toUnicode(m.getKeyText()));
+            keys.emplace_back(util::cp1252::toUtf8(m.getKeyText()));
             m.increment();
         } while (!m.popError());
     }
@@ -186,16 +350,92 @@ const QStringList &CSwordLexiconModuleInfo::entries() const {
     m.setSkipConsecutiveLinks(false);
 
     /// \todo Document why the following code is here:
-    if (!m_entries.empty() && m_entries.front().simplified().isEmpty())
-        m_entries.pop_front();
+    if (!keys.empty()
+        && QString::fromUtf8(keys.front()).simplified().isEmpty())
+        keys.erase(keys.begin());
 
-    writeCache();
+    auto buffer(serializeEntries(moduleVersion, keys));
+    keys.clear();
+
+    /* The cache might be read or built by other threads (see
+       BtLexiconCacheBuilder) at the same time, hence replace it atomically: */
+    QSaveFile saveFile(cacheFileName(name()));
+    qDebug() << "Writing cache file" << saveFile.fileName();
+    if (saveFile.open(QIODevice::WriteOnly)) {
+        saveFile.write(buffer);
+        if (saveFile.commit()) {
+            qDebug() << "Cache file written successfully!";
+        } else {
+            qDebug() << "Failed to write cache file!";
+        }
+    } else {
+        qDebug() << "Failed to open cache file for writing!";
+    }
+
+    [[maybe_unused]] auto const valid =
+            m_entries.setData(buffer.constData(), buffer.size(), moduleVersion);
+    BT_ASSERT(valid);
+    m_entries.m_buffer = std::move(buffer);
 
     return m_entries;
 }
 
-bool CSwordLexiconModuleInfo::snap() const
-{ return swordModule().getRawEntry(); }
+auto CSwordLexiconModuleInfo::cachedEntries(QString const & moduleName,
+                                            QByteArray const & moduleVersion)
+        -> std::optional<Entries>
+{
+    for (auto const & fileName : cacheFileNames(moduleName)) {
+        auto cacheFile = std::make_unique<QFile>(fileName);
+        if (!cacheFile->open(QIODevice::ReadOnly))
+            continue;
+
+        qDebug() << "Reading lexicon cache" << fileName << "...";
+        Entries r;
+        auto const size = cacheFile->size();
+        if (auto const * const data = cacheFile->map(0, size)) {
+            if (r.setData(reinterpret_cast<char const *>(data),
+                          size,
+                          moduleVersion))
+            {
+                qDebug() << "  entries mapped:" << r.size();
+                r.m_file = std::move(cacheFile);
+                return r;
+            }
+        } else { // Fall back to reading the file, e.g. if mmap is unsupported:
+            auto buffer(cacheFile->readAll());
+            if (r.setData(buffer.constData(), buffer.size(), moduleVersion)) {
+                qDebug() << "  entries read:" << r.size();
+                r.m_buffer = std::move(buffer);
+                return r;
+            }
+        }
+    }
+    return {};
+}
+
+bool CSwordLexiconModuleInfo::hasEntriesCache() const {
+    if (m_entriesLoaded)
+        return true;
+    auto const moduleVersion(
+                config(CSwordModuleInfo::ModuleVersion).toUtf8());
+    for (auto const & fileName : cacheFileNames(name())) {
+        QFile cacheFile(fileName);
+        if (!cacheFile.open(QIODevice::ReadOnly))
+            continue;
+        auto const header(cacheFile.read(12 + moduleVersion.size() + 3));
+        if (headerSize(header.constData(), header.size(), moduleVersion) >= 0)
+            return true;
+    }
+    return false;
+}
+
+QString CSwordLexiconModuleInfo::dateKey(QDate const & date)
+{ return date.toString(QStringLiteral("MM.dd")); }
+
+bool CSwordLexiconModuleInfo::snap() const {
+    auto const lock(CSwordBackend::lockSwordFiles());
+    return swordModule().getRawEntry();
+}
 
 bool CSwordLexiconModuleInfo:: hasStrongsKeys() const {
     return m_hasStrongsKeys;
@@ -14,12 +14,19 @@
 
 #include "cswordmoduleinfo.h"
 
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 
 
 class CSwordBackend;
+class QDate;
+class QFile;
 namespace sword { class SWModule; }
 
 /**
@@ -28,6 +35,93 @@ namespace sword { class SWModule; }
 class CSwordLexiconModuleInfo final: public CSwordModuleInfo {
         Q_OBJECT
 
+    public: // types:
+
+        /**
+          \brief A read-only view of the entries of a lexicon module.
+
+          The entries are stored as a table of offsets into a blob of UTF-8
+          encoded keys, which is usually memory-mapped from the cache file of
+          the module. The keys are only decoded when accessed. The cache file
+          also contains the order of the entries by their case-insensitively
+          compared keys, so that keys can be looked up in O(log n).
+        */
+        class Entries {
+
+            friend class CSwordLexiconModuleInfo;
+
+        public: // methods:
+
+            Entries() noexcept;
+            Entries(Entries &&) noexcept;
+            ~Entries();
+
+            Entries & operator=(Entries &&) noexcept;
+
+            qsizetype size() const noexcept { return m_size; }
+            bool empty() const noexcept { return m_size == 0; }
+
+            /** \returns the UTF-8 encoded key of the given entry. */
+            QByteArrayView utf8At(qsizetype i) const noexcept;
+
+            QString at(qsizetype i) const
+            { return QString::fromUtf8(utf8At(i)); }
+
+            QString operator[](qsizetype i) const { return at(i); }
+
+            /** \returns the index of the given key, or -1 if not found. */
+            qsizetype indexOf(QString const & key) const;
+
+            /**
+              \returns the index of the entry at the given position in the
+                       case-insensitive order of the keys.
+            */
+            qsizetype sortedIndex(qsizetype position) const noexcept;
+
+            /**
+              \returns the first position in the case-insensitive order of
+                       the keys whose key is not less than the given one.
+            */
+            qsizetype lowerBound(QString const & key) const;
+
+            /**
+              \returns the index of the given key, or if not found, the index
+                       of the key following it case-insensitively, or of the
+                       last one, or -1 if there are no entries.
+            */
+            qsizetype nearest(QString const & key) const;
+
+            /** \returns a copy of all keys, e.g. for populating widgets. */
+            QStringList toStringList() const;
+
+            /** \returns the number of bytes of the entries read into memory. */
+            std::size_t heapBytes() const noexcept
+            { return static_cast<std::size_t>(m_buffer.capacity()); }
+
+            /** \returns the number of bytes mapped from the cache file. */
+            std::size_t mappedBytes() const noexcept;
+
+        private: // methods:
+
+            /**
+              \brief Sets up the view of the given cache data.
+              \returns whether the data was valid for the given version.
+            */
+            bool setData(char const * data,
+                         qsizetype size,
+                         QByteArray const & moduleVersion) noexcept;
+
+        private: // fields:
+
+            std::unique_ptr<QFile> m_file;
+            QByteArray m_buffer;
+            char const * m_offsets = nullptr;
+            char const * m_order = nullptr;
+            char const * m_blob = nullptr;
+            qsizetype m_size = 0;
+
+        }; /* class Entries */
+
     public: // methods:
         CSwordLexiconModuleInfo(sword::SWModule & module,
                                 CSwordBackend & backend);
@@ -45,13 +139,52 @@ class CSwordLexiconModuleInfo final: public CSwordModuleInfo {
 
         /**
           This method returns the entries of the modules represented by this
-          object. If this function is called for the first time the list is load
-          from disk and stored in a list which cahes it. If the function is
-          called again, the cached list is returned so we have a major speed
-          improvement.
-          \returns the list of lexicon entries in the module.
+          object. If this function is called for the first time the entries are
+          memory-mapped from the cache file on disk, which is (re)built from
+          the module if needed. If the function is called again, the already
+          mapped entries are returned.
+          \returns the lexicon entries in the module.
+        */
+        Entries const & entries() const;
+
+        /**
+          \returns whether the entries are loaded already or the cache file of
+                   the module is up to date, so that entries() needs not read
+                   all entries of the module.
+        */
+        bool hasEntriesCache() const;
+
+        /**
+          \returns the entries of the given module memory-mapped from its cache
+                   file, if the cache is valid for the given module version.
+                   The module itself is not accessed, so this can be used by
+                   any thread.
+        */
+        static std::optional<Entries> cachedEntries(
+                QString const & moduleName,
+                QByteArray const & moduleVersion);
+
+        /** \returns the entries if entries() has loaded them already. */
+        Entries const * loadedEntries() const noexcept
+        { return m_entriesLoaded ? &m_entries : nullptr; }
+
+        /**
+          \returns whether this is a daily devotional without hasEntriesCache().
+                   The entries of such a module are looked up by seeking
+                   directly to their keys, e.g. to dateKey(), while the cache is
+                   built by CSwordBackend::buildLexiconCache(), instead of
+                   blocking on entries().
+        */
+        bool seeksDirectly() const {
+            return category() == Category::DailyDevotionals
+                   && !hasEntriesCache();
+        }
+
+        /**
+          \returns the key of the entry of the given date in daily devotionals,
+                   i.e. "MM.DD".
         */
-        const QStringList &entries() const;
+        static QString dateKey(QDate const & date);
 
         /** Jumps to the closest entry in the module. */
         bool snap() const final override;
@@ -65,7 +198,8 @@ class CSwordLexiconModuleInfo final: public CSwordModuleInfo {
         int m_strongsDigitsLength = 0;
 
         /**
-          This is the list which caches the entres of the module.
+          The cached entries of the module.
         */
-        mutable QStringList m_entries;
+        mutable Entries m_entries;
+        mutable bool m_entriesLoaded = false;
 };
@@ -12,29 +12,59 @@
 
 #include "cswordmoduleinfo.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <cassert>
+#include <chrono>
 #include <CLucene.h>
+#include <cstdint>
+#include <cwchar>
+#include <exception>
+#include <filesystem>
 #include <optional>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QIODevice>
 #include <QLocale>
 #include <QScopeGuard>
 #include <QSettings>
+#include <QStringList>
 #include <QTextDocument>
+#include <QThread>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <stdexcept>
+#include <system_error>
 #include <type_traits>
+#include <vector>
 #include "../../util/btassert.h"
+#include "../../util/bttrace.h"
+#include "../../util/cp1252.h"
 #include "../../util/cresmgr.h"
 #include "../../util/directory.h"
 #include "../../util/tool.h"
+#include "../../util/utf8.h"
 #include "../config/btconfig.h"
 #include "../keys/cswordkey.h"
 #include "../managers/cswordbackend.h"
+#include "../btcorpusstatistics.h"
+#include "../btentrywritejournal.h"
+#include "../btindexingmemorybudget.h"
+#include "../btlemmaindex.h"
+#include "../btrawentrycache.h"
 #include "../cswordmodulesearch.h"
 #include "cswordbiblemoduleinfo.h"
 #include "cswordlexiconmoduleinfo.h"
@@ -53,17 +83,732 @@
 #include <versekey.h>
 #pragma GCC diagnostic pop
 
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 //Increment this, if the index format changes
 //Then indices on the user's systems will be rebuilt
-constexpr static unsigned const INDEX_VERSION = 7;
+constexpr static unsigned const INDEX_VERSION = 10;
+
+//Increment this, if the format of the index state snapshot changes
+constexpr static quint32 const BT_INDEX_STATE_SNAPSHOT_VERSION = 1u;
 
 //Maximum index entry size, 1MiB for now
 //Lucene default is too small
 constexpr static unsigned long const BT_MAX_LUCENE_FIELD_LENGTH = 1024 * 1024;
 
+//Minimum number of entries per shard when indexing in parallel shards
+constexpr static unsigned long const BT_MIN_INDEX_SHARD_SIZE = 2000;
+
+//Maximum number of opened index searchers kept for repeated searches
+constexpr static std::size_t const BT_MAX_CACHED_INDEX_SEARCHERS = 8u;
+
+//Number of hits collected between polls of the cancellation of a search
+constexpr static std::size_t const BT_SEARCH_CANCELLATION_INTERVAL = 256u;
+
+//Minimum number of documents per range when searching an index in parallel
+constexpr static std::int32_t const BT_MIN_SEARCH_RANGE_SIZE = 8000;
+
+struct CSwordModuleInfo::IndexingCounters {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+      \brief Adds the time passed since the given time to the given counter.
+      \returns the current time.
+    */
+    static Clock::time_point addTimeSince(std::atomic<std::int64_t> & counter,
+                                          Clock::time_point const since)
+            noexcept
+    {
+        auto const now = Clock::now();
+        counter.fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        now - since).count(),
+                    std::memory_order_relaxed);
+        return now;
+    }
+
+    IndexingStatistics statistics(std::uint64_t const entriesTotal) const {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        auto const load =
+                [](std::atomic<std::int64_t> const & counter) {
+                    return duration_cast<milliseconds>(
+                                std::chrono::nanoseconds(
+                                    counter.load(std::memory_order_relaxed)));
+                };
+        return {entries.load(std::memory_order_relaxed),
+                entriesTotal,
+                bytes.load(std::memory_order_relaxed),
+                duration_cast<milliseconds>(Clock::now() - start),
+                load(renderTime),
+                load(tokenizeTime),
+                load(writeTime)};
+    }
+
+    Clock::time_point const start = Clock::now();
+    std::atomic<std::uint64_t> entries{0u};
+    std::atomic<std::uint64_t> bytes{0u};
+    std::atomic<std::int64_t> renderTime{0}; ///< In nanoseconds, as all times
+    std::atomic<std::int64_t> tokenizeTime{0};
+    std::atomic<std::int64_t> writeTime{0};
+
+};
+
 namespace {
 
+/**
+  \brief Reads the verse indices of the documents of verse keyed modules from
+         the terms of their "index" field.
+  \returns the verse index by document number, or -1 for the documents
+           without one.
+*/
+std::vector<std::int32_t> readVerseIndices(lucene::index::IndexReader & reader)
+{
+    BT_TRACE_SPAN("read verse indices");
+    std::vector<std::int32_t> r(static_cast<std::size_t>(reader.maxDoc()), -1);
+    lucene::index::Term first(static_cast<TCHAR const *>(_T("index")),
+                              static_cast<TCHAR const *>(_T("")));
+    std::unique_ptr<lucene::index::TermEnum> termEnum(reader.terms(&first));
+    std::unique_ptr<lucene::index::TermDocs> termDocs(reader.termDocs());
+    auto const cleanup =
+            qScopeGuard(
+                [&termEnum, &termDocs]() noexcept {
+                    termDocs->close();
+                    termEnum->close();
+                });
+    do {
+        auto * const term = termEnum->term(false);
+        if (!term || _tcscmp(term->field(), _T("index")))
+            break;
+        auto const verseIndex = static_cast<std::int32_t>(
+                std::wcstol(static_cast<wchar_t const *>(term->text()),
+                            nullptr,
+                            10));
+        termDocs->seek(termEnum.get());
+        while (termDocs->next())
+            if (auto const doc = static_cast<std::size_t>(termDocs->doc());
+                doc < r.size())
+                r[doc] = verseIndex;
+    } while (termEnum->next());
+    return r;
+}
+
+/**
+  \brief An index searcher which also caches the verse indices of the
+         documents, so that the hits of verse keyed modules are resolved
+         without loading their documents and parsing their keys.
+*/
+class CachedIndexSearcher: public lucene::search::IndexSearcher {
+
+public: // methods:
+
+    using lucene::search::IndexSearcher::IndexSearcher;
+
+    /** \returns the verse indices read by readVerseIndices() once. */
+    std::vector<std::int32_t> const & verseIndices() {
+        std::call_once(m_verseIndicesRead,
+                       [this]
+                       { m_verseIndices = readVerseIndices(*getReader()); });
+        return m_verseIndices;
+    }
+
+private: // fields:
+
+    std::once_flag m_verseIndicesRead;
+    std::vector<std::int32_t> m_verseIndices;
+
+};
+
+/**
+  \brief Sets the given key of a module to the entry of the given hit.
+  \param[in] verseIndices The verse indices of the documents if the key is a
+                          sword::VerseKey, otherwise nullptr.
+  \param[in] utfBuffer A buffer for BT_MAX_LUCENE_FIELD_LENGTH characters.
+*/
+void setKeyToHit(sword::SWKey & key,
+                 lucene::search::Hits & hits,
+                 std::size_t const i,
+                 std::vector<std::int32_t> const * const verseIndices,
+                 char * const utfBuffer)
+{
+    if (verseIndices) {
+        auto const doc = static_cast<std::size_t>(hits.id(i));
+        if (doc < verseIndices->size() && (*verseIndices)[doc] >= 0) {
+            static_cast<sword::VerseKey &>(key).setIndex((*verseIndices)[doc]);
+            return;
+        }
+    }
+    util::utf8::fromWide(
+                utfBuffer,
+                BT_MAX_LUCENE_FIELD_LENGTH,
+                static_cast<const wchar_t *>(
+                    hits.doc(i).get(static_cast<const TCHAR *>(_T("key")))));
+    key.setText(utfBuffer);
+}
+
+/**
+  \brief Sets the given key of a module to the entry of the given document.
+  \param[in] verseIndices The verse indices of the documents if the key is a
+                          sword::VerseKey, otherwise nullptr.
+  \param[in] utfBuffer A buffer for BT_MAX_LUCENE_FIELD_LENGTH characters.
+*/
+void setKeyToDocument(sword::SWKey & key,
+                      lucene::search::IndexSearcher & searcher,
+                      std::int32_t const doc,
+                      std::vector<std::int32_t> const * const verseIndices,
+                      char * const utfBuffer)
+{
+    if (verseIndices) {
+        auto const i = static_cast<std::size_t>(doc);
+        if (i < verseIndices->size() && (*verseIndices)[i] >= 0) {
+            static_cast<sword::VerseKey &>(key).setIndex((*verseIndices)[i]);
+            return;
+        }
+    }
+    lucene::document::Document document;
+    searcher.doc(doc, document);
+    util::utf8::fromWide(
+                utfBuffer,
+                BT_MAX_LUCENE_FIELD_LENGTH,
+                static_cast<const wchar_t *>(
+                    document.get(static_cast<const TCHAR *>(_T("key")))));
+    key.setText(utfBuffer);
+}
+
+/**
+  \brief Sorts the given documents of a verse based module in verse order.
+  \param[in] verseIndices The verse indices of the documents.
+  \returns whether all documents have verse indices. Otherwise the documents
+           are left unsorted.
+*/
+bool sortDocumentsByVerse(std::vector<std::int32_t> & docs,
+                          std::vector<std::int32_t> const & verseIndices)
+{
+    auto const verseOf =
+            [&verseIndices](std::int32_t const doc)
+            { return verseIndices[static_cast<std::size_t>(doc)]; };
+    for (auto const doc : docs)
+        if (static_cast<std::size_t>(doc) >= verseIndices.size()
+            || verseOf(doc) < 0)
+            return false;
+    auto const verseOrder =
+            [&verseOf](std::int32_t const a, std::int32_t const b)
+            { return verseOf(a) < verseOf(b); };
+    if (!std::is_sorted(docs.begin(), docs.end(), verseOrder))
+        std::stable_sort(docs.begin(), docs.end(), verseOrder);
+    return true;
+}
+
+/**
+  \brief Finds the documents matching the given query by scoring consecutive
+         ranges of the documents of the index concurrently.
+
+  Each range is scored in its own thread, which skips to the start of its
+  range by the skip lists of the postings, so that a complex query against a
+  large index is answered by several cores. No scores are computed for the
+  ranking of the hits, since the results are in index order anyway.
+  \returns the matching documents in index order, or nothing if the search was
+           cancelled.
+*/
+std::optional<std::vector<std::int32_t>>
+searchRangesInParallel(lucene::search::IndexSearcher & searcher,
+                       lucene::search::Query & query,
+                       std::int32_t const numRanges,
+                       BtCancellationToken const & cancellation)
+{
+    BT_TRACE_SPAN("search indexed: parallel search");
+    BT_ASSERT(numRanges > 1);
+    auto * const reader = searcher.getReader();
+    auto const maxDoc = reader->maxDoc();
+
+    /* The scorers are created up front, since only running them is safe in
+       parallel, each with postings of its own: */
+    std::unique_ptr<lucene::search::Weight> const weight(
+                query.weight(&searcher));
+    struct Range {
+        std::int32_t begin;
+        std::int32_t end;
+        std::unique_ptr<lucene::search::Scorer> scorer;
+        std::vector<std::int32_t> docs;
+        std::unique_ptr<QThread> thread;
+        std::exception_ptr error;
+    };
+    std::vector<Range> ranges(static_cast<std::size_t>(numRanges));
+    for (std::int32_t i = 0; i < numRanges; ++i) {
+        auto & range = ranges[static_cast<std::size_t>(i)];
+        range.begin = static_cast<std::int32_t>(
+                          (static_cast<std::int64_t>(maxDoc) * i) / numRanges);
+        range.end = static_cast<std::int32_t>(
+                        (static_cast<std::int64_t>(maxDoc) * (i + 1))
+                        / numRanges);
+        range.scorer.reset(weight->scorer(reader));
+        if (!range.scorer) // Nothing matches at all
+            return std::vector<std::int32_t>();
+    }
+
+    for (auto & range : ranges) {
+        range.thread.reset(QThread::create(
+            [&range, &cancellation] {
+                try {
+                    auto & scorer = *range.scorer;
+                    auto & docs = range.docs;
+                    if (!scorer.skipTo(range.begin))
+                        return;
+                    do {
+                        auto const doc = scorer.doc();
+                        if (doc >= range.end)
+                            break;
+                        docs.push_back(doc);
+                        if (docs.size() % BT_SEARCH_CANCELLATION_INTERVAL == 0u
+                            && cancellation.cancelled())
+                            return;
+                    } while (scorer.next());
+                } catch (...) {
+                    range.error = std::current_exception();
+                }
+            }));
+        range.thread->start();
+    }
+    for (auto & range : ranges)
+        range.thread->wait();
+    for (auto & range : ranges)
+        if (range.error)
+            std::rethrow_exception(range.error);
+    if (cancellation.cancelled())
+        return {};
+
+    // The ranges are consecutive, hence merging them keeps the index order:
+    std::vector<std::int32_t> r;
+    std::size_t size = 0u;
+    for (auto const & range : ranges)
+        size += range.docs.size();
+    r.reserve(size);
+    for (auto const & range : ranges)
+        r.insert(r.end(), range.docs.begin(), range.docs.end());
+    return r;
+}
+
+class IndexPendingHits;
+
+/**
+  \brief A pool of the most recently used index searchers, keyed by the index
+         location, so that repeated searches need not reopen all segment
+         files.
+*/
+class IndexSearcherCache {
+
+public: // methods:
+
+    static IndexSearcherCache & instance() {
+        static IndexSearcherCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<CachedIndexSearcher> searcher(QString const & location) {
+        {
+            std::lock_guard<std::mutex> const guard(m_mutex);
+            auto const it =
+                    std::find_if(m_entries.begin(),
+                                 m_entries.end(),
+                                 [&location](Entry const & entry)
+                                 { return entry.first == location; });
+            if (it != m_entries.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return it->second;
+            }
+        }
+
+        // Open the index without blocking searches in other indices:
+        auto r(std::make_shared<CachedIndexSearcher>(
+                   location.toLatin1().constData()));
+
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.emplace_front(location, r);
+        if (m_entries.size() > BT_MAX_CACHED_INDEX_SEARCHERS)
+            m_entries.pop_back();
+        return r;
+    }
+
+    void invalidate(QString const & location) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.remove_if([&location](Entry const & entry)
+                            { return entry.first == location; });
+    }
+
+    /**
+      \brief Registers pending hits which keep a searcher of the index at the
+             given location open, see release().
+    */
+    void addPendingHits(QString location,
+                        std::shared_ptr<IndexPendingHits> const & hits)
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_pendingHits.remove_if([](PendingHitsEntry const & entry)
+                                { return entry.second.expired(); });
+        m_pendingHits.emplace_back(std::move(location), hits);
+    }
+
+    /**
+      \brief Closes all searchers of the index at the given location, e.g.
+             before its directory is renamed, which fails on some platforms
+             while files in it are open. The hits pending are resolved first.
+    */
+    void release(QString const & location);
+
+    void clear() {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.clear();
+    }
+
+private: // types:
+
+    using Entry = std::pair<QString, std::shared_ptr<CachedIndexSearcher>>;
+    using PendingHitsEntry =
+            std::pair<QString, std::weak_ptr<IndexPendingHits>>;
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::list<Entry> m_entries;
+    std::list<PendingHitsEntry> m_pendingHits;
+
+};
+
+/**
+  \brief The results of probing the indices of the modules by hasIndex(), which
+         are kept across sessions in a snapshot file. An entry is valid as long
+         as the module version and the modification times of the index files
+         have not changed.
+*/
+class IndexStateCache {
+
+public: // types:
+
+    struct Stamp {
+        QString moduleVersion;
+        qint64 configModified;
+        qint64 indexModified;
+
+        bool operator==(Stamp const & other) const noexcept {
+            return configModified == other.configModified
+                   && indexModified == other.indexModified
+                   && moduleVersion == other.moduleVersion;
+        }
+    };
+
+public: // methods:
+
+    static IndexStateCache & instance() {
+        static IndexStateCache cache;
+        return cache;
+    }
+
+    std::optional<bool> hasIndex(QString const & moduleName,
+                                 Stamp const & stamp)
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        auto const it = m_entries.constFind(moduleName);
+        if (it == m_entries.cend() || !(it->stamp == stamp))
+            return {};
+        return it->hasIndex;
+    }
+
+    void store(QString const & moduleName, Stamp stamp, bool const hasIndex) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.insert(moduleName, Entry{std::move(stamp), hasIndex});
+        m_modified = true;
+    }
+
+    void invalidate(QString const & moduleName) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_entries.remove(moduleName))
+            m_modified = true;
+    }
+
+    void load(QString const & fileName) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        QDataStream s(&file);
+        s.setVersion(QDataStream::Qt_6_5);
+        quint32 version;
+        quint32 size;
+        s >> version >> size;
+        if (s.status() != QDataStream::Ok
+            || version != BT_INDEX_STATE_SNAPSHOT_VERSION)
+            return;
+
+        QHash<QString, Entry> entries;
+        for (quint32 i = 0u; i < size && s.status() == QDataStream::Ok; ++i) {
+            QString moduleName;
+            Entry entry;
+            s >> moduleName
+              >> entry.stamp.moduleVersion
+              >> entry.stamp.configModified
+              >> entry.stamp.indexModified
+              >> entry.hasIndex;
+            entries.insert(std::move(moduleName), std::move(entry));
+        }
+        if (s.status() != QDataStream::Ok)
+            return;
+
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        entries.insert(m_entries); // Keep the entries of this session
+        m_entries = std::move(entries);
+    }
+
+    void save(QString const & fileName) {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (!m_modified)
+            return;
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write" << file.fileName();
+            return;
+        }
+        QDataStream s(&file);
+        s.setVersion(QDataStream::Qt_6_5);
+        s << BT_INDEX_STATE_SNAPSHOT_VERSION
+          << static_cast<quint32>(m_entries.size());
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+            s << it.key()
+              << it->stamp.moduleVersion
+              << it->stamp.configModified
+              << it->stamp.indexModified
+              << it->hasIndex;
+        file.close();
+        if (s.status() != QDataStream::Ok) {
+            file.remove();
+            return;
+        }
+        m_modified = false;
+    }
+
+private: // types:
+
+    struct Entry {
+        Stamp stamp;
+        bool hasIndex;
+    };
+
+private: // fields:
+
+    std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_modified = false;
+
+};
+
+QString indexStateSnapshotFile() {
+    return util::directory::getUserCacheDir().absoluteFilePath(
+                QStringLiteral("bibletime-index-states"));
+}
+
+/**
+  \brief The hits of an unscoped search, which are resolved to keys on demand
+         while the index searcher is kept open. Before the index is replaced,
+         the searcher is released by releaseSearcher(), see
+         IndexSearcherCache::release().
+*/
+class IndexPendingHits: public CSwordModuleSearch::PendingHits {
+
+public: // methods:
+
+    std::size_t size() const override { return m_size; }
+
+    std::size_t pageSize() const noexcept override { return m_pageSize; }
+
+    void fetch(std::size_t const begin,
+               std::size_t const end,
+               CSwordModuleSearch::ModuleResultList & results) const override
+    {
+        auto const utfBuffer =
+                std::make_unique<char[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        for (auto i = begin; i < end && i < m_size; ++i) {
+            if (m_searcher) {
+                resolveHit(i, utfBuffer.get());
+            } else if (auto * const vk =
+                               dynamic_cast<sword::VerseKey *>(m_key.get()))
+            {
+                vk->setIndex(m_resolvedVerseIndices[i]);
+            } else {
+                m_key->setText(m_resolvedKeyTexts[i].constData());
+            }
+            results.append(*m_key);
+        }
+    }
+
+    /**
+      \brief Resolves all hits to keys and releases the searcher, so that the
+             files of the index are closed.
+    */
+    void releaseSearcher() {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (!m_searcher)
+            return;
+        auto const utfBuffer =
+                std::make_unique<char[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
+        auto * const vk = dynamic_cast<sword::VerseKey *>(m_key.get());
+        for (std::size_t i = 0u; i < m_size; ++i) {
+            resolveHit(i, utfBuffer.get());
+            if (vk) {
+                m_resolvedVerseIndices.emplace_back(vk->getIndex());
+            } else {
+                m_resolvedKeyTexts.emplace_back(m_key->getText());
+            }
+        }
+        releaseHits();
+        m_verseIndices = nullptr;
+        m_searcher.reset();
+    }
+
+protected: // methods:
+
+    IndexPendingHits(std::shared_ptr<CachedIndexSearcher> searcher,
+                     sword::SWKey const & prototype,
+                     std::size_t const pageSize,
+                     std::size_t const size)
+        : m_searcher(std::move(searcher))
+        , m_key(prototype.clone())
+        , m_verseIndices(dynamic_cast<sword::VerseKey *>(m_key.get())
+                         ? &m_searcher->verseIndices()
+                         : nullptr)
+        , m_pageSize(pageSize)
+        , m_size(size)
+    {}
+
+    /** Sets m_key to the hit with the given number. Needs m_mutex. */
+    virtual void resolveHit(std::size_t i, char * utfBuffer) const = 0;
+
+    /** Releases the hits, after the searcher. Needs m_mutex. */
+    virtual void releaseHits() = 0;
+
+protected: // fields:
+
+    std::shared_ptr<CachedIndexSearcher> m_searcher;
+    std::unique_ptr<sword::SWKey> const m_key;
+    std::vector<std::int32_t> const * m_verseIndices;
+
+private: // fields:
+
+    std::size_t const m_pageSize;
+    std::size_t const m_size;
+    std::vector<long> m_resolvedVerseIndices;
+    std::vector<QByteArray> m_resolvedKeyTexts;
+    mutable std::mutex m_mutex;
+
+};
+
+/**
+  \brief The hits of an unscoped search, which are fetched from the Hits object
+         on demand. The query is kept alive for the Hits.
+*/
+class LucenePendingHits final: public IndexPendingHits {
+
+public: // methods:
+
+    LucenePendingHits(
+            std::shared_ptr<CachedIndexSearcher> searcher,
+            std::unique_ptr<lucene::search::Query> query,
+            std::unique_ptr<lucene::search::Hits> hits,
+            sword::SWKey const & prototype,
+            std::size_t const pageSize)
+        : IndexPendingHits(std::move(searcher),
+                           prototype,
+                           pageSize,
+                           hits->length())
+        , m_query(std::move(query))
+        , m_hits(std::move(hits))
+    {}
+
+protected: // methods:
+
+    void resolveHit(std::size_t const i, char * const utfBuffer)
+            const override
+    { setKeyToHit(*m_key, *m_hits, i, m_verseIndices, utfBuffer); }
+
+    void releaseHits() override {
+        m_hits.reset();
+        m_query.reset();
+    }
+
+private: // fields:
+
+    std::unique_ptr<lucene::search::Query> m_query;
+    std::unique_ptr<lucene::search::Hits> m_hits;
+
+};
+
+/**
+  \brief The documents of an unscoped search, e.g. those found by
+         searchRangesInParallel() or sorted in verse order, which are resolved
+         to keys on demand.
+*/
+class DocumentPendingHits final: public IndexPendingHits {
+
+public: // methods:
+
+    DocumentPendingHits(std::shared_ptr<CachedIndexSearcher> searcher,
+                        std::vector<std::int32_t> docs,
+                        sword::SWKey const & prototype,
+                        std::size_t const pageSize)
+        : IndexPendingHits(std::move(searcher),
+                           prototype,
+                           pageSize,
+                           docs.size())
+        , m_docs(std::move(docs))
+    {}
+
+protected: // methods:
+
+    void resolveHit(std::size_t const i, char * const utfBuffer)
+            const override
+    {
+        setKeyToDocument(*m_key,
+                         *m_searcher,
+                         m_docs[i],
+                         m_verseIndices,
+                         utfBuffer);
+    }
+
+    void releaseHits() override {
+        m_docs.clear();
+        m_docs.shrink_to_fit();
+    }
+
+private: // fields:
+
+    std::vector<std::int32_t> m_docs;
+
+};
+
+void IndexSearcherCache::release(QString const & location) {
+    std::vector<std::shared_ptr<IndexPendingHits>> pendingHits;
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_entries.remove_if([&location](Entry const & entry)
+                            { return entry.first == location; });
+        for (auto it = m_pendingHits.begin(); it != m_pendingHits.end();) {
+            if (it->first == location) {
+                if (auto hits = it->second.lock())
+                    pendingHits.emplace_back(std::move(hits));
+                it = m_pendingHits.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (auto const & hits : pendingHits)
+        hits->releaseSearcher();
+}
+
 inline CSwordModuleInfo::Category retrieveCategory(
     CSwordModuleInfo::ModuleType const type,
     CSwordModuleInfo::Features const features,
@@ -129,16 +874,1184 @@ inline CSwordModuleInfo::Features retrieveFeatures(
     return features;
 }
 
+/** The filter options which could be supported by modules, see has(). */
+constexpr CSwordModuleInfo::FilterOption const * const allFilterOptions[] = {
+    &CSwordModuleInfo::footnotes,
+    &CSwordModuleInfo::strongNumbers,
+    &CSwordModuleInfo::headings,
+    &CSwordModuleInfo::morphTags,
+    &CSwordModuleInfo::lemmas,
+    &CSwordModuleInfo::hebrewPoints,
+    &CSwordModuleInfo::hebrewCantillation,
+    &CSwordModuleInfo::greekAccents,
+    &CSwordModuleInfo::scriptureReferences,
+    &CSwordModuleInfo::redLetterWords,
+    &CSwordModuleInfo::textualVariants,
+    &CSwordModuleInfo::morphSegmentation,
+};
+
+/**
+  \returns the mask of the bits of the filter options of the global option
+           filters of the module, which are named by the options optionally
+           prefixed by the markup they filter, e.g. "OSISStrongs".
+*/
+std::uint32_t retrieveFilterOptions(sword::SWModule const & module) {
+    std::uint32_t r = 0u;
+    for (auto [it, end] = module.getConfig().equal_range("GlobalOptionFilter");
+         it != end;
+         ++it)
+    {
+        std::string_view value(it->second.c_str(), it->second.size());
+        for (std::string_view const prefix : {"OSIS", "GBF", "ThML", "UTF8"}) {
+            if (value.starts_with(prefix)) {
+                value.remove_prefix(prefix.size());
+                break;
+            }
+        }
+        for (auto const * const option : allFilterOptions)
+            if (value == option->configOptionName)
+                r |= 1u << option->bit;
+    }
+    return r;
+}
+
 static const TCHAR * stop_words[] = { nullptr };
 
+/** The field with the content of entries with accents and diacritics folded: */
+static TCHAR const * const unaccentedFieldName = _T("unaccented");
+
+/**
+  Removes the accents, vowel points and other diacritics of tokens by removing
+  the non-spacing marks from their canonical decomposition.
+*/
+class AccentFoldingFilter : public lucene::analysis::TokenFilter {
+
+public: // Methods:
+
+    AccentFoldingFilter(lucene::analysis::TokenStream * const input,
+                        bool const deleteTokenStream)
+        : lucene::analysis::TokenFilter(input, deleteTokenStream)
+    {}
+
+    lucene::analysis::TokenStream * inputStream() const noexcept
+    { return input; }
+
+    lucene::analysis::Token * next(lucene::analysis::Token * const token)
+            override
+    {
+        if (!input->next(token))
+            return nullptr;
+
+        // ASCII tokens have no marks, which spares their normalization:
+        auto const * const termText = token->termBuffer();
+        auto const termLength = token->termLength();
+        if (std::all_of(termText,
+                        termText + termLength,
+                        [](TCHAR const c) { return c < 0x80; }))
+            return token;
+
+        auto const decomposed(
+                    QString::fromWCharArray(termText,
+                                            static_cast<qsizetype>(termLength))
+                    .normalized(QString::NormalizationForm_D));
+        QString folded;
+        folded.reserve(decomposed.size());
+        for (auto const c : decomposed)
+            if (c.category() != QChar::Mark_NonSpacing)
+                folded.append(c);
+        auto const text(folded.normalized(QString::NormalizationForm_C)
+                        .toStdWString());
+        token->setText(text.c_str(), static_cast<std::int32_t>(text.size()));
+        return token;
+    }
+
+};
+
+/**
+  The optional field with all rotations of the content tokens, see
+  PermutermFilter and ContentQueryParser:
+*/
+static TCHAR const * const permutermFieldName = _T("permuterm");
+
+/** Marks the end of a token in its rotations in the permuterm field: */
+static TCHAR const permutermEndMarker = _T('$');
+
+/**
+  Replaces every token with all rotations of the token followed by
+  permutermEndMarker at the same position, e.g. "abc" with "abc$", "bc$a",
+  "c$ab" and "$abc". Any wildcard term is then matched by a term starting with
+  a part of the term without wildcards, see ContentQueryParser.
+*/
+class PermutermFilter : public lucene::analysis::TokenFilter {
+
+public: // Methods:
+
+    PermutermFilter(lucene::analysis::TokenStream * const input,
+                    bool const deleteTokenStream)
+        : lucene::analysis::TokenFilter(input, deleteTokenStream)
+    {}
+
+    lucene::analysis::TokenStream * inputStream() const noexcept
+    { return input; }
+
+    lucene::analysis::Token * next(lucene::analysis::Token * const token)
+            override
+    {
+        if (m_rotation >= m_term.size()) {
+            if (!input->next(token))
+                return nullptr;
+            m_term.assign(token->termBuffer(), token->termLength());
+            m_term.push_back(permutermEndMarker);
+            m_rotation = 0u;
+            m_startOffset = token->startOffset();
+            m_endOffset = token->endOffset();
+        } else {
+            token->setPositionIncrement(0);
+            token->setStartOffset(m_startOffset);
+            token->setEndOffset(m_endOffset);
+        }
+        m_rotated.assign(m_term, m_rotation, std::wstring::npos);
+        m_rotated.append(m_term, 0u, m_rotation);
+        ++m_rotation;
+        token->setText(m_rotated.c_str(),
+                       static_cast<std::int32_t>(m_rotated.size()));
+        return token;
+    }
+
+private: // Fields:
+
+    std::wstring m_term;
+    std::wstring m_rotated;
+    std::size_t m_rotation = 0u;
+    std::int32_t m_startOffset = 0;
+    std::int32_t m_endOffset = 0;
+
+};
+
+/**
+  How the text of modules is split into the tokens of their index. The words
+  of most languages are separated by spaces and punctuation, but Chinese,
+  Japanese, Thai and some other scripts are written without spaces, hence
+  overlapping pairs of their characters are indexed instead, see BigramFilter.
+*/
+enum class Tokenization { Words, Bigrams };
+
+/** \returns whether the given character is of a script indexed by bigrams. */
+bool isBigramChar(TCHAR const c) noexcept {
+    return (c >= 0x0e00 && c <= 0x0eff)  // Thai and Lao
+        || (c >= 0x1000 && c <= 0x109f)  // Myanmar
+        || (c >= 0x1780 && c <= 0x17ff)  // Khmer
+        || (c >= 0x3040 && c <= 0x30ff)  // Hiragana and Katakana
+        || (c >= 0x3400 && c <= 0x4dbf)  // CJK Unified Ideographs Extension A
+        || (c >= 0x4e00 && c <= 0x9fff)  // CJK Unified Ideographs
+        || (c >= 0xac00 && c <= 0xd7af)  // Hangul Syllables
+        || (c >= 0xf900 && c <= 0xfaff); // CJK Compatibility Ideographs
+}
+
+/** \returns the tokenization for indexing the given module. */
+Tokenization moduleTokenization(CSwordModuleInfo const & module) {
+    auto const & language = module.language();
+    if (!language)
+        return Tokenization::Words;
+    auto const & abbrev = language->abbrev();
+    auto const primary(abbrev.section(QLatin1Char('-'), 0, 0)
+                       .section(QLatin1Char('_'), 0, 0));
+    static QStringList const bigramLanguages{
+        QStringLiteral("zh"), QStringLiteral("cmn"), QStringLiteral("yue"),
+        QStringLiteral("ja"), QStringLiteral("ko"), QStringLiteral("th"),
+        QStringLiteral("lo"), QStringLiteral("km"), QStringLiteral("my"),
+    };
+    return bigramLanguages.contains(primary, Qt::CaseInsensitive)
+           ? Tokenization::Bigrams
+           : Tokenization::Words;
+}
+
+/**
+  \returns the versification of the keys of the given module, which the verse
+           indices stored in its index depend on, or an empty string if the
+           module is not keyed by verses.
+*/
+QString moduleVersification(CSwordModuleInfo const & module) {
+    std::unique_ptr<sword::SWKey> const key(module.swordModule().createKey());
+    auto const * const vk = dynamic_cast<sword::VerseKey const *>(key.get());
+    return vk ? QString::fromUtf8(vk->getVersificationSystem()) : QString();
+}
+
+/**
+  \returns a hash of the entries of the configuration of the given module which
+           the documents rendered from its entries depend on. An update of the
+           module changing these without changing the raw entries needs the
+           index to be rebuilt instead of updated.
+*/
+QString renderingConfigHash(CSwordModuleInfo const & module) {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    auto const & config = module.swordModule().getConfig();
+    for (char const * const name
+         : {"GlobalOptionFilter", "SourceType", "Encoding", "CipherKey"})
+    {
+        for (auto [it, end] = config.equal_range(name); it != end; ++it) {
+            hash.addData(QByteArrayView(name));
+            hash.addData(QByteArrayView("=", 1));
+            hash.addData(QByteArrayView(it->second.c_str(),
+                                        it->second.size()));
+            hash.addData(QByteArrayView("\n", 1));
+        }
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString tokenizationName(Tokenization const tokenization) {
+    return (tokenization == Tokenization::Bigrams)
+           ? QStringLiteral("bigrams")
+           : QStringLiteral("words");
+}
+
+/**
+  \returns the tokenization recorded for the index with the given base
+           location, which queries on that index need to use as well.
+*/
+Tokenization indexTokenization(QString const & baseIndexLocation) {
+    QSettings config(baseIndexLocation
+                     + QStringLiteral("/bibletime-index.conf"),
+                     QSettings::IniFormat);
+    return (config.value(QStringLiteral("tokenization")).toString()
+            == tokenizationName(Tokenization::Bigrams))
+           ? Tokenization::Bigrams
+           : Tokenization::Words;
+}
+
+/**
+  Splits text into runs of letters, digits and marks, and lowercases them,
+  for BigramFilter. Unlike the tokenizer of lucene's StandardAnalyzer, this
+  also keeps runs of Thai letters and their vowel signs together.
+*/
+class WordTokenizer : public lucene::analysis::CharTokenizer {
+
+public: // Methods:
+
+    WordTokenizer(lucene::util::Reader * const reader)
+        : lucene::analysis::CharTokenizer(reader)
+    {}
+
+protected: // Methods:
+
+    bool isTokenChar(TCHAR const c) const override {
+        auto const ucs4 = static_cast<char32_t>(c);
+        return QChar::isLetterOrNumber(ucs4) || QChar::isMark(ucs4)
+               || isBigramChar(c);
+    }
+
+    TCHAR normalize(TCHAR const c) const override
+    { return static_cast<TCHAR>(QChar::toLower(static_cast<char32_t>(c))); }
+
+};
+
+/**
+  Replaces the runs of characters for which isBigramChar() holds in every
+  token with overlapping pairs of characters, e.g. "ABC" with "AB" and "BC",
+  at consecutive positions. Queries for words and phrases of these scripts
+  are therefore term and phrase lookups, which would otherwise need wildcard
+  queries. The other parts of tokens are kept as they are.
+*/
+class BigramFilter : public lucene::analysis::TokenFilter {
+
+public: // Methods:
+
+    BigramFilter(lucene::analysis::TokenStream * const input,
+                 bool const deleteTokenStream)
+        : lucene::analysis::TokenFilter(input, deleteTokenStream)
+    {}
+
+    lucene::analysis::Token * next(lucene::analysis::Token * const token)
+            override
+    {
+        if (m_pos >= m_word.size()) {
+            if (!input->next(token))
+                return nullptr;
+            m_word.assign(token->termBuffer(), token->termLength());
+            m_pos = 0u;
+            m_runEnd = 0u;
+            m_startOffset = token->startOffset();
+            if (std::none_of(m_word.cbegin(), m_word.cend(), isBigramChar)) {
+                m_pos = m_word.size();
+                return token;
+            }
+        } else {
+            token->setPositionIncrement(1);
+        }
+
+        auto const begin = m_pos;
+        std::size_t end;
+        if (begin < m_runEnd || isBigramChar(m_word[begin])) {
+            if (begin >= m_runEnd) { // The start of a run
+                m_runEnd = begin + 1u;
+                while (m_runEnd < m_word.size()
+                       && isBigramChar(m_word[m_runEnd]))
+                    ++m_runEnd;
+            }
+            // Runs of single characters are kept, longer runs become pairs:
+            end = std::min(begin + 2u, m_runEnd);
+            m_pos = (end == m_runEnd) ? m_runEnd : begin + 1u;
+        } else {
+            end = begin + 1u;
+            while (end < m_word.size() && !isBigramChar(m_word[end]))
+                ++end;
+            m_pos = end;
+        }
+        token->setText(m_word.c_str() + begin,
+                       static_cast<std::int32_t>(end - begin));
+        token->setStartOffset(
+                    m_startOffset + static_cast<std::int32_t>(begin));
+        token->setEndOffset(m_startOffset + static_cast<std::int32_t>(end));
+        return token;
+    }
+
+private: // Fields:
+
+    std::wstring m_word;
+    std::size_t m_pos = 0u;
+    std::size_t m_runEnd = 0u;
+    std::int32_t m_startOffset = 0;
+
+};
+
+/**
+  The analyzer used for indexing and searching. It uses no stop words and folds
+  the accents of the tokens of the unaccented field, in both the indexed
+  entries and the queries, so accent-insensitive searches are plain term
+  lookups instead of wildcard expansions. The tokens of the permuterm field are
+  replaced by their rotations. The text fields of modules tokenized by bigrams
+  are split by WordTokenizer and BigramFilter instead of the tokenizer of the
+  StandardAnalyzer, which is still used for Strong's numbers and morph codes.
+*/
 class Analyzer : public lucene::analysis::standard::StandardAnalyzer {
 
 public: // Methods:
 
-    Analyzer() : lucene::analysis::standard::StandardAnalyzer(stop_words) {}
+    explicit Analyzer(Tokenization const tokenization = Tokenization::Words)
+        : lucene::analysis::standard::StandardAnalyzer(stop_words)
+        , m_tokenization(tokenization)
+    {}
+
+    lucene::analysis::TokenStream * tokenStream(
+            TCHAR const * const fieldName,
+            lucene::util::Reader * const reader) override
+    {
+        auto * const stream =
+                usesBigrams(fieldName)
+                ? new BigramFilter(new WordTokenizer(reader), true)
+                : lucene::analysis::standard::StandardAnalyzer::tokenStream(
+                      fieldName,
+                      reader);
+        if (isField(fieldName, unaccentedFieldName))
+            return new AccentFoldingFilter(stream, true);
+        if (isField(fieldName, permutermFieldName))
+            return new PermutermFilter(stream, true);
+        return stream;
+    }
+
+    lucene::analysis::TokenStream * reusableTokenStream(
+            TCHAR const * const fieldName,
+            lucene::util::Reader * const reader) override
+    {
+        lucene::analysis::TokenStream * stream;
+        if (usesBigrams(fieldName)) {
+            if (m_wordTokenizer) {
+                m_wordTokenizer->reset(reader);
+            } else {
+                m_wordTokenizer = std::make_unique<WordTokenizer>(reader);
+                m_bigramFilter =
+                        std::make_unique<BigramFilter>(m_wordTokenizer.get(),
+                                                       false);
+            }
+            stream = m_bigramFilter.get();
+        } else {
+            stream = lucene::analysis::standard::StandardAnalyzer
+                     ::reusableTokenStream(fieldName, reader);
+        }
+        // The reused streams are owned by the analyzer:
+        if (isField(fieldName, unaccentedFieldName))
+            return reusableFilter(m_foldingFilter, stream);
+        if (isField(fieldName, permutermFieldName))
+            return reusableFilter(m_permutermFilter, stream);
+        return stream;
+    }
+
+private: // Methods:
+
+    static bool isField(TCHAR const * const fieldName,
+                        TCHAR const * const name) noexcept
+    { return fieldName && !_tcscmp(fieldName, name); }
+
+    bool usesBigrams(TCHAR const * const fieldName) const noexcept {
+        return m_tokenization == Tokenization::Bigrams
+               && !isField(fieldName, _T("strong"))
+               && !isField(fieldName, _T("morph"));
+    }
+
+    template <typename Filter>
+    static Filter * reusableFilter(std::unique_ptr<Filter> & filter,
+                                   lucene::analysis::TokenStream * const stream)
+    {
+        if (!filter || filter->inputStream() != stream)
+            filter = std::make_unique<Filter>(stream, false);
+        return filter.get();
+    }
+
+private: // Fields:
+
+    Tokenization const m_tokenization;
+    std::unique_ptr<WordTokenizer> m_wordTokenizer;
+    std::unique_ptr<BigramFilter> m_bigramFilter;
+    std::unique_ptr<AccentFoldingFilter> m_foldingFilter;
+    std::unique_ptr<PermutermFilter> m_permutermFilter;
+
+};
+
+/**
+  Parses queries with the content field as the default field. If the index has
+  the permuterm field, wildcard terms of the content field which start with a
+  wildcard are looked up in the rotated terms of the permuterm field, starting
+  with a part of the term without wildcards, instead of enumerating every term
+  of the content field. For example "*ness" becomes the prefix query "ness$*"
+  and "*phil*" becomes the wildcard query "phil*$*".
+*/
+class ContentQueryParser : public lucene::queryParser::QueryParser {
+
+public: // Methods:
+
+    ContentQueryParser(lucene::analysis::Analyzer * const analyzer,
+                       bool const permuterm)
+        : lucene::queryParser::QueryParser(_T("content"), analyzer)
+        , m_permuterm(permuterm)
+    {}
+
+protected: // Methods:
+
+    lucene::search::Query * getWildcardQuery(TCHAR const * const field,
+                                             TCHAR * const termStr) override
+    {
+        if (!m_permuterm || _tcscmp(field, _T("content"))
+            || !isWildcard(termStr[0]))
+            return lucene::queryParser::QueryParser::getWildcardQuery(field,
+                                                                      termStr);
+
+        auto const pattern(QString::fromWCharArray(termStr).toLower()
+                           .toStdWString() + permutermEndMarker);
+
+        // Pick the rotation of the pattern with the longest literal prefix:
+        std::wstring best;
+        std::size_t bestPrefixSize = 0u;
+        for (std::size_t i = 0u; i < pattern.size(); ++i) {
+            auto rotated(pattern.substr(i) + pattern.substr(0u, i));
+            auto const prefixSize =
+                    static_cast<std::size_t>(
+                        std::find_if(rotated.cbegin(),
+                                     rotated.cend(),
+                                     isWildcard) - rotated.cbegin());
+            if (prefixSize > bestPrefixSize) {
+                best = std::move(rotated);
+                bestPrefixSize = prefixSize;
+            }
+        }
+
+        // A single trailing * is a prefix query, which needs no matching:
+        bool const isPrefix = (bestPrefixSize + 1u == best.size()
+                               && best.back() == _T('*'));
+        if (isPrefix)
+            best.pop_back();
+        auto * const term =
+                _CLNEW lucene::index::Term(permutermFieldName, best.c_str());
+        lucene::search::Query * const query =
+                isPrefix
+                ? static_cast<lucene::search::Query *>(
+                      _CLNEW lucene::search::PrefixQuery(term))
+                : _CLNEW lucene::search::WildcardQuery(term);
+        _CLDECDELETE(term);
+        return query;
+    }
+
+private: // Methods:
+
+    static bool isWildcard(TCHAR const c) noexcept
+    { return c == _T('*') || c == _T('?'); }
+
+private: // Fields:
+
+    bool const m_permuterm;
+
+};
+
+/**
+  \returns the text of the given term of a text field, with the rotations of
+           the permuterm field turned back into their terms, or nothing if
+           the term is of another field.
+*/
+std::optional<QString> queryTermText(lucene::index::Term const & term) {
+    std::wstring_view const text(term.text(), term.textLength());
+    if (!_tcscmp(term.field(), _T("content"))
+        || !_tcscmp(term.field(), unaccentedFieldName))
+        return QString::fromWCharArray(text.data(),
+                                       static_cast<qsizetype>(text.size()));
+    if (_tcscmp(term.field(), permutermFieldName))
+        return {};
+    auto const marker = text.find(permutermEndMarker);
+    if (marker == std::wstring_view::npos)
+        return {};
+    return QString::fromStdWString(std::wstring(text.substr(marker + 1u))
+                                   .append(text.substr(0u, marker)));
+}
+
+/**
+  \brief Collects the terms of the given rewritten query, except those of its
+         prohibited clauses, keeping the terms of phrase queries as phrases.
+*/
+void collectQueryTerms(lucene::search::Query & query,
+                       CSwordModuleSearch::QueryTerms & queryTerms)
+{
+    if (auto * const booleanQuery =
+            dynamic_cast<lucene::search::BooleanQuery *>(&query))
+    {
+        std::vector<lucene::search::BooleanClause *> clauses(
+                    booleanQuery->getClauseCount());
+        booleanQuery->getClauses(clauses.data());
+        for (auto const * const clause : clauses)
+            if (!clause->isProhibited())
+                collectQueryTerms(*clause->getQuery(), queryTerms);
+    } else if (auto * const phraseQuery =
+                   dynamic_cast<lucene::search::PhraseQuery *>(&query))
+    {
+        auto ** const terms = phraseQuery->getTerms();
+        auto const cleanup = qScopeGuard([terms] { delete[] terms; });
+        lucene::util::ValueArray<std::int32_t> positions;
+        phraseQuery->getPositions(positions);
+        CSwordModuleSearch::QueryTerms::Phrase phrase;
+        phrase.slop = phraseQuery->getSlop();
+        for (std::size_t i = 0u; terms[i]; ++i)
+            if (auto text = queryTermText(*terms[i]))
+                phrase.terms.emplace_back(
+                            CSwordModuleSearch::QueryTerms::Phrase::Term{
+                                std::move(*text),
+                                positions[i]});
+        if (phrase.terms.empty())
+            return;
+        auto const firstPosition =
+                std::min_element(
+                    phrase.terms.cbegin(),
+                    phrase.terms.cend(),
+                    [](auto const & a, auto const & b)
+                    { return a.position < b.position; })->position;
+        for (auto & term : phrase.terms)
+            term.position -= firstPosition;
+        queryTerms.phrases.emplace_back(std::move(phrase));
+    } else {
+        lucene::search::TermSet terms;
+        auto const cleanup =
+                qScopeGuard(
+                    [&terms] {
+                        for (auto * term : terms)
+                            _CLDECDELETE(term);
+                    });
+        query.extractTerms(&terms);
+        for (auto const * const term : terms)
+            if (auto text = queryTermText(*term))
+                queryTerms.terms.insert(std::move(*text));
+    }
+}
+
+/**
+  \returns the terms of the text fields matched by the given query in the
+           given index, e.g. every term a wildcard term expands to, or
+           nullptr if the terms can not be extracted.
+*/
+std::shared_ptr<CSwordModuleSearch::QueryTerms const>
+extractQueryTerms(lucene::search::Query * const query,
+                  lucene::index::IndexReader * const reader)
+{
+    BT_TRACE_SPAN("search indexed: extract query terms");
+    auto r = std::make_shared<CSwordModuleSearch::QueryTerms>();
+    lucene::search::Query * rewritten = query;
+    auto const cleanup =
+            qScopeGuard(
+                [&] {
+                    if (rewritten != query)
+                        _CLDELETE(rewritten);
+                });
+    try {
+        // Rewrite the query as by the searcher, until it is primitive:
+        for (auto * next = rewritten->rewrite(reader);
+             next != rewritten;
+             next = rewritten->rewrite(reader))
+        {
+            if (rewritten != query)
+                _CLDELETE(rewritten);
+            rewritten = next;
+        }
+        collectQueryTerms(*rewritten, *r);
+    } catch (CLuceneError const &) { // E.g. too many clauses
+        return {};
+    }
+    return r;
+}
+
+/**
+  \returns the file name of the configuration of a new index, which is written
+           into the directory of the index until its other files are saved,
+           see installStagedIndexConfig().
+*/
+QString stagedIndexConfigFile(QString const & indexLocation)
+{ return indexLocation + QStringLiteral("/bibletime-index.conf"); }
+
+/**
+  \brief Moves the configuration staged in the directory of the standard index
+         in the given base location over the configuration of the index.
+  \returns whether successful.
+*/
+bool installStagedIndexConfig(QString const & baseIndexLocation) {
+    std::error_code error;
+    std::filesystem::rename( // Replaces the old configuration atomically
+                std::filesystem::path(
+                    stagedIndexConfigFile(
+                        baseIndexLocation + QStringLiteral("/standard"))
+                    .toStdU16String()),
+                std::filesystem::path(
+                    (baseIndexLocation
+                     + QStringLiteral("/bibletime-index.conf"))
+                    .toStdU16String()),
+                error);
+    return !error;
+}
+
+/**
+  Replaces the index directory at the given location with the directory of a
+  new index, by renaming the directories instead of writing into the index
+  searched, so that a complete index is always in place. Where supported, the
+  directories are exchanged atomically. Otherwise the old index is moved aside
+  first and restored by CSwordModuleInfo::recoverIndexDirectories() if
+  BibleTime is interrupted before the new index is in place. The searchers of
+  the old index are closed first, since renaming a directory fails on some
+  platforms while its files are open.
+  \throws std::runtime_error if the directories can not be renamed.
+*/
+void replaceIndexDirectory(QString const & newLocation,
+                           QString const & location)
+{
+    IndexSearcherCache::instance().release(location);
+    auto const oldLocation(location + QStringLiteral(".old"));
+    QDir(oldLocation).removeRecursively();
+#if defined(Q_OS_LINUX) && defined(RENAME_EXCHANGE)
+    if (QFileInfo::exists(location)
+        && ::renameat2(AT_FDCWD,
+                       QFile::encodeName(newLocation).constData(),
+                       AT_FDCWD,
+                       QFile::encodeName(location).constData(),
+                       RENAME_EXCHANGE) == 0)
+    {
+        QDir(newLocation).removeRecursively(); // The old index now
+        return;
+    } // Otherwise the file system does not support exchanging them
+#endif
+    QDir dir;
+    if (QFileInfo::exists(location) && !dir.rename(location, oldLocation))
+        throw std::runtime_error("Failed to move the old index aside!");
+    if (!dir.rename(newLocation, location)) {
+        dir.rename(oldLocation, location); // Restore the old index
+        throw std::runtime_error("Failed to move the new index in place!");
+    }
+    QDir(oldLocation).removeRecursively();
+}
+
+/**
+  \returns whether the index with the given base location has the permuterm
+           field, see CSwordModuleInfo::permutermIndexEnabled().
+*/
+bool indexHasPermuterm(QString const & baseIndexLocation) {
+    QSettings config(baseIndexLocation
+                     + QStringLiteral("/bibletime-index.conf"),
+                     QSettings::IniFormat);
+    return config.value(QStringLiteral("permuterm"), false).toBool();
+}
+
+/**
+  \returns whether the index with the given base location has been merged into
+           a single segment, see CSwordModuleInfo::fastIndexBuildsEnabled().
+*/
+bool indexIsOptimized(QString const & baseIndexLocation) {
+    QSettings config(baseIndexLocation
+                     + QStringLiteral("/bibletime-index.conf"),
+                     QSettings::IniFormat);
+    return config.value(QStringLiteral("optimized"), true).toBool();
+}
+
+bool indexMarkedForRebuild(QString const & baseIndexLocation) {
+    QSettings config(baseIndexLocation
+                     + QStringLiteral("/bibletime-index.conf"),
+                     QSettings::IniFormat);
+    return config.value(QStringLiteral("needs-rebuild"), false).toBool();
+}
+
+/**
+  The merge policy of index writers, which trades indexing time against the
+  number of segments to search ("settings/behaviour/indexMergeFactor" and
+  "settings/behaviour/indexMaxBufferedDocs"). Values below 2 keep the defaults
+  of CLucene.
+*/
+struct IndexMergePolicy {
+
+    static IndexMergePolicy fromConfig() {
+        return {btConfig().value<int>(
+                    QStringLiteral("settings/behaviour/indexMergeFactor"),
+                    0),
+                btConfig().value<int>(
+                    QStringLiteral("settings/behaviour/indexMaxBufferedDocs"),
+                    0)};
+    }
+
+    void applyTo(lucene::index::IndexWriter & writer) const {
+        if (mergeFactor >= 2)
+            writer.setMergeFactor(mergeFactor);
+        if (maxBufferedDocs >= 2)
+            writer.setMaxBufferedDocs(maxBufferedDocs);
+    }
+
+    int mergeFactor;
+    int maxBufferedDocs;
 
 };
 
+/**
+  Makes the given writer flush its buffered documents to disk when they exceed
+  its share of the memory budget of all concurrent writers. This is applied
+  again while indexing, since the share shrinks as other writers start.
+*/
+void applyMemoryShare(lucene::index::IndexWriter & writer,
+                      BtIndexingMemoryBudget::Share const & share)
+{
+    writer.setRAMBufferSizeMB(static_cast<float>(share.bufferSize())
+                              / (1024.0f * 1024.0f));
+}
+
+void setImportantFilterOptions(CSwordBackend & backend, bool const enable) {
+    backend.setOption(CSwordModuleInfo::strongNumbers, enable);
+    backend.setOption(CSwordModuleInfo::morphTags, enable);
+    backend.setOption(CSwordModuleInfo::footnotes, enable);
+    backend.setOption(CSwordModuleInfo::headings, enable);
+}
+
+void prepareIndexingFilterOptions(CSwordBackend & backend) {
+    // Without this we don't get strongs, lemmas, etc.
+    backend.setFilterOptions(btConfig().getFilterOptions());
+    /* Make sure we reset all important filter options which influcence the
+       plain filters. Turn on these options, they are needed for the
+       EntryAttributes population */
+    setImportantFilterOptions(backend, true);
+
+    /* We don't want the following in the text, the do not carry searchable
+       information. */
+    backend.setOption(CSwordModuleInfo::morphSegmentation, false);
+    backend.setOption(CSwordModuleInfo::scriptureReferences, false);
+    backend.setOption(CSwordModuleInfo::redLetterWords, false);
+}
+
+sword::VerseKey * prepareIndexingKey(sword::SWModule & module) {
+    auto * const vk = dynamic_cast<sword::VerseKey *>(module.getKey());
+    if (vk) {
+        /* We have to be sure to insert the english key into the index,
+           otherwise we'd be in trouble if the language changes. */
+        vk->setLocale("en_US");
+        /* If we have a verse based module, we want to include the pre-
+           chapter etc. headings in the search. */
+        vk->setIntros(true);
+    }
+
+    // we start with the first module entry, key is automatically updated
+    // because key is a pointer to the modules key
+    module.setSkipConsecutiveLinks(true);
+    return vk;
+}
+
+/**
+  \returns the raw current entry of the given module, which is read under
+           CSwordBackend::lockSwordFiles().
+*/
+sword::SWBuf readRawEntry(sword::SWModule & module) {
+    auto const lock(CSwordBackend::lockSwordFiles());
+    return module.getRawEntry();
+}
+
+QByteArray entryHash(sword::SWBuf const & rawEntry) {
+    return QCryptographicHash::hash(QByteArrayView(rawEntry.c_str()),
+                                    QCryptographicHash::Md5);
+}
+
+QString entryHashesFile(QString const & moduleBaseIndexLocation)
+{ return moduleBaseIndexLocation + QStringLiteral("/bibletime-index-hashes"); }
+
+QString lemmaIndexFile(QString const & moduleBaseIndexLocation)
+{ return moduleBaseIndexLocation + QStringLiteral("/bibletime-lemma-index"); }
+
+QString corpusStatisticsFile(QString const & moduleBaseIndexLocation) {
+    return moduleBaseIndexLocation
+           + QStringLiteral("/bibletime-corpus-statistics");
+}
+
+QString verseAttributeStoreFile(QString const & moduleBaseIndexLocation) {
+    return moduleBaseIndexLocation
+           + QStringLiteral("/bibletime-verse-attributes");
+}
+
+std::optional<CSwordModuleInfo::EntryHashes>
+loadEntryHashes(QString const & moduleBaseIndexLocation) {
+    QFile file(entryHashesFile(moduleBaseIndexLocation));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    quint32 version;
+    CSwordModuleInfo::EntryHashes hashes;
+    s >> version;
+    if (version != INDEX_VERSION)
+        return {};
+    s >> hashes;
+    if (s.status() != QDataStream::Ok)
+        return {};
+    return hashes;
+}
+
+void saveEntryHashes(QString const & moduleBaseIndexLocation,
+                     CSwordModuleInfo::EntryHashes const & hashes)
+{
+    QFile file(entryHashesFile(moduleBaseIndexLocation));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write" << file.fileName();
+        return;
+    }
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_6_5);
+    s << static_cast<quint32>(INDEX_VERSION) << hashes;
+    file.close();
+    if (s.status() != QDataStream::Ok)
+        file.remove();
+}
+
+/**
+  Builds the Lucene documents for module entries. Instead of allocating a new
+  document and a new field for the key, both content variants and every
+  footnote, heading, lemma and morph of every entry, a single document is
+  reused for all entries and all text of a field name is merged into a single
+  field. Since Lucene indexes multiple fields of the same name as if their text
+  were concatenated, this does not change the index. The content is indexed a
+  second time into the unaccented field and optionally a third time into the
+  permuterm field, see Analyzer. The text buffers keep
+  their capacity between entries, hence after some entries only the fields
+  handed over to the document (which owns them) are allocated.
+*/
+class DocumentBuilder {
+
+public: // types:
+
+    enum FieldName {
+        Key,
+        Index,
+        Content,
+        Footnote,
+        Heading,
+        Strong,
+        Morph,
+        Count
+    };
+
+public: // methods:
+
+    DocumentBuilder(bool const permuterm)
+        : m_wcharBuffer(
+              std::make_unique<wchar_t[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1))
+        , m_permuterm(permuterm)
+    {}
+
+    void appendText(FieldName const field, char const * const utf8Text) {
+        auto const size = util::utf8::toWide(m_wcharBuffer.get(),
+                                             BT_MAX_LUCENE_FIELD_LENGTH,
+                                             utf8Text);
+        auto & text = m_texts[field];
+        if (!text.empty())
+            text.push_back(L' ');
+        text.append(m_wcharBuffer.get(), size);
+        ++m_numUnmergedFields;
+    }
+
+    /** \brief Sets the verse index of the entry of a verse keyed module. */
+    void setVerseIndex(long const verseIndex) {
+        m_texts[Index] = std::to_wstring(verseIndex);
+        ++m_numUnmergedFields;
+    }
+
+    void addDocument(lucene::index::IndexWriter & writer) {
+        static TCHAR const * const names[] = {
+            _T("key"),
+            _T("index"),
+            _T("content"),
+            _T("footnote"),
+            _T("heading"),
+            _T("strong"),
+            _T("morph"),
+        };
+        static_assert(std::size(names) == Count);
+
+        m_document.clear();
+        for (int i = 0; i < Count; ++i) {
+            auto & text = m_texts[i];
+            if (text.empty())
+                continue;
+            m_document.add(
+                *(new lucene::document::Field(
+                      names[i],
+                      static_cast<const TCHAR *>(text.c_str()),
+                      (i == Key || i == Index)
+                      ? (lucene::document::Field::STORE_YES
+                         | lucene::document::Field::INDEX_UNTOKENIZED)
+                      : (lucene::document::Field::STORE_NO
+                         | lucene::document::Field::INDEX_TOKENIZED))));
+            ++m_numFields;
+            if (i == Content) { // Also indexed with its accents folded
+                m_document.add(
+                    *(new lucene::document::Field(
+                          unaccentedFieldName,
+                          static_cast<const TCHAR *>(text.c_str()),
+                          lucene::document::Field::STORE_NO
+                          | lucene::document::Field::INDEX_TOKENIZED)));
+                ++m_numFields;
+                if (m_permuterm) { // and rotated
+                    m_document.add(
+                        *(new lucene::document::Field(
+                              permutermFieldName,
+                              static_cast<const TCHAR *>(text.c_str()),
+                              lucene::document::Field::STORE_NO
+                              | lucene::document::Field::INDEX_TOKENIZED)));
+                    ++m_numFields;
+                }
+            }
+            text.clear(); // Keeps the capacity
+        }
+        writer.addDocument(&m_document);
+        ++m_numDocuments;
+    }
+
+    void logStatistics(QString const & moduleName) const {
+        qDebug() << moduleName << "indexed" << m_numDocuments << "entries"
+                 << "with 1 document and" << m_numFields
+                 << "field allocations instead of" << m_numDocuments
+                 << "document and" << m_numUnmergedFields
+                 << "field allocations.";
+    }
+
+private: // fields:
+
+    std::unique_ptr<wchar_t[]> const m_wcharBuffer;
+    bool const m_permuterm;
+    std::wstring m_texts[Count];
+    lucene::document::Document m_document;
+    unsigned long m_numDocuments = 0u;
+    unsigned long m_numFields = 0u;
+    unsigned long m_numUnmergedFields = 0u;
+
+};
+
+/**
+  Adds a document for the current entry of the given module to the index. The
+  Strong's numbers and morphological codes of verse keyed entries are also
+  added to the given lemma index, if any, and their entry attributes to the
+  given verse attribute store. The raw entry is the one returned by
+  getRawEntry() for the current entry, which is read only once per entry.
+*/
+void indexCurrentEntry(sword::SWModule & module,
+                       sword::SWBuf const & rawEntry,
+                       CSwordBackend & backend,
+                       bool const importantFilterOption,
+                       lucene::index::IndexWriter & writer,
+                       DocumentBuilder & builder,
+                       BtLemmaIndex * const lemmaIndex,
+                       BtVerseAttributeStore::Builder * const verseAttributes,
+                       CSwordModuleInfo::IndexingCounters & counters)
+{
+    using Counters = CSwordModuleInfo::IndexingCounters;
+    BT_TRACE_SPAN("index entry");
+    auto const started = Counters::Clock::now();
+    counters.bytes.fetch_add(rawEntry.length(), std::memory_order_relaxed);
+    /* Also index Chapter 0 and Verse 0, because they might have information in
+       the entry attributes. We used to just put their content into the
+       textBuffer and continue to the next verse, but with entry attributes
+       this doesn't work any more. Hits in the search dialog will show up as
+       1:1 (instead of 0). */
+
+    //index the key
+    builder.appendText(DocumentBuilder::Key, module.getKey()->getText());
+    auto const * const verseKey =
+            dynamic_cast<sword::VerseKey const *>(module.getKey());
+    if (verseKey)
+        builder.setVerseIndex(verseKey->getIndex());
+
+    /* Run the filters of both passes on copies of the raw entry, instead of
+       letting stripText() read and decode it again for every pass: */
+    auto const * const key = module.getKey();
+    auto const strip =
+            [&module, &rawEntry, key] {
+                sword::SWBuf text(rawEntry);
+                if (text.length()) {
+                    module.optionFilter(text, key);
+                    module.stripFilter(text, key);
+                }
+                return text;
+            };
+
+    if (importantFilterOption) {
+        // Index text including strongs, morph, footnotes, and headings.
+        setImportantFilterOptions(backend, true);
+        // The entry attributes are taken from the second pass only:
+        auto const processEntryAttributes = module.isProcessEntryAttributes();
+        module.setProcessEntryAttributes(false);
+        builder.appendText(DocumentBuilder::Content, strip().c_str());
+        module.setProcessEntryAttributes(processEntryAttributes);
+    }
+
+    // Index text without strongs, morph, footnotes, and headings.
+    setImportantFilterOptions(backend, false);
+    module.getEntryAttributes().clear();
+    builder.appendText(DocumentBuilder::Content, strip().c_str());
+
+    auto const * const vk = lemmaIndex ? verseKey : nullptr;
+    BtVerseAttributeStore::Attributes attributes;
+    bool const storeAttributes = vk && verseAttributes;
+
+    for (auto & vp : module.getEntryAttributes()["Footnote"]) {
+        builder.appendText(DocumentBuilder::Footnote, vp.second["body"]);
+        if (storeAttributes)
+            attributes.footnotes.emplace_back(
+                    BtVerseAttributeStore::Footnote{
+                        QString::fromUtf8(vp.first.c_str()),
+                        QString::fromUtf8(vp.second["body"].c_str())});
+    }
+
+    // Headings
+    for (auto & vp : module.getEntryAttributes()["Heading"]["Preverse"]) {
+        builder.appendText(DocumentBuilder::Heading, vp.second);
+        if (storeAttributes)
+            attributes.headings.append(QString::fromUtf8(vp.second.c_str()));
+    }
+
+    // Strongs/Morphs
+    auto const verseIndex =
+            vk ? static_cast<std::uint32_t>(vk->getIndex()) : 0u;
+    for (auto const & vp : module.getEntryAttributes()["Word"]) {
+        auto const & attrs = vp.second;
+        QString wordText;
+        if (vk) {
+            auto const textIter(attrs.find("Text"));
+            if (textIter != attrs.end())
+                wordText = QString::fromUtf8(textIter->second.c_str())
+                           .simplified();
+        }
+        auto const partCountIter(attrs.find("PartCount"));
+        int partCount = (partCountIter != attrs.end())
+                        ? QString(partCountIter->second).toInt()
+                        : 0;
+        BtVerseAttributeStore::Word word;
+        for (int i=0; i<partCount; i++) {
+
+            sword::SWBuf lemmaKey = "Lemma";
+            if (partCount > 1)
+                lemmaKey.appendFormatted(".%d", i+1);
+            auto const lemmaIter(attrs.find(lemmaKey));
+            if (lemmaIter != attrs.end()) {
+                builder.appendText(DocumentBuilder::Strong, lemmaIter->second);
+                if (storeAttributes) {
+                    if (!word.lemma.isEmpty())
+                        word.lemma.append(u' ');
+                    word.lemma.append(
+                                QString::fromUtf8(lemmaIter->second.c_str()));
+                }
+                if (vk)
+                    lemmaIndex->add(
+                                BtLemmaIndex::Kind::Lemma,
+                                QString::fromUtf8(lemmaIter->second.c_str()),
+                                verseIndex,
+                                wordText);
+            }
+
+        }
+
+        auto const morphIter(attrs.find("Morph"));
+        if (morphIter != attrs.end()) {
+            builder.appendText(DocumentBuilder::Morph, morphIter->second);
+            if (storeAttributes)
+                word.morph = QString::fromUtf8(morphIter->second.c_str());
+            if (vk)
+                lemmaIndex->add(BtLemmaIndex::Kind::Morph,
+                                QString::fromUtf8(morphIter->second.c_str()),
+                                verseIndex);
+        }
+        if (storeAttributes) {
+            word.text = std::move(wordText);
+            attributes.words.emplace_back(std::move(word));
+        }
+    }
+    if (storeAttributes)
+        verseAttributes->add(verseIndex, attributes);
+
+    // Lucene analyzes the document and inverts it in memory while adding it:
+    auto const rendered = Counters::addTimeSince(counters.renderTime, started);
+    builder.addDocument(writer);
+    Counters::addTimeSince(counters.tokenizeTime, rendered);
+}
+
+void logIndexingStatistics(QString const & moduleName,
+                           CSwordModuleInfo::IndexingStatistics const & s)
+{
+    qDebug().nospace()
+            << moduleName << " indexed " << s.entriesDone << " of "
+            << s.entriesTotal << " entries (" << s.bytesProcessed
+            << " bytes) in " << s.elapsed.count() << " ms: rendering "
+            << s.renderTime.count() << " ms, tokenizing "
+            << s.tokenizeTime.count() << " ms, writing "
+            << s.writeTime.count() << " ms.";
+}
+
+/**
+  \brief The part of the documents of a module in the combined index. Since
+         the module documents have no module field, merging keeps them in
+         consecutive ranges of document numbers.
+*/
+struct CombinedIndexPart {
+    QString moduleName;
+    QString indexStamp;
+    std::int32_t docBase;
+    std::int32_t docCount;
+};
+
+QString combinedIndexConfigFile()
+{ return CSwordModuleInfo::getCombinedIndexLocation()
+         + QStringLiteral("/bibletime-index.conf"); }
+
+std::vector<CombinedIndexPart> loadCombinedIndexParts() {
+    std::vector<CombinedIndexPart> r;
+    QSettings config(combinedIndexConfigFile(), QSettings::IniFormat);
+    if (config.value(QStringLiteral("index-version")).toUInt()
+        != INDEX_VERSION)
+        return r;
+    auto const size = config.beginReadArray(QStringLiteral("modules"));
+    for (int i = 0; i < size; ++i) {
+        config.setArrayIndex(i);
+        r.emplace_back(
+                CombinedIndexPart{
+                    config.value(QStringLiteral("name")).toString(),
+                    config.value(QStringLiteral("index-stamp")).toString(),
+                    config.value(QStringLiteral("doc-base")).toInt(),
+                    config.value(QStringLiteral("doc-count")).toInt()});
+    }
+    config.endArray();
+    return r;
+}
+
 } // anonymous namespace
 
 char const *
@@ -157,73 +2070,87 @@ CSwordModuleInfo::FilterOption::valueToReadings(int const value) noexcept {
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::footnotes{
     "Footnotes",
     "Footnotes",
-    QT_TRANSLATE_NOOP("QObject", "Footnotes")};
+    QT_TRANSLATE_NOOP("QObject", "Footnotes"),
+    0u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::strongNumbers{
     "Strong's Numbers",
     "Strongs",
-    QT_TRANSLATE_NOOP("QObject", "Strong's numbers")};
+    QT_TRANSLATE_NOOP("QObject", "Strong's numbers"),
+    1u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::headings{
     "Headings",
     "Headings",
-     QT_TRANSLATE_NOOP("QObject", "Headings")};
+     QT_TRANSLATE_NOOP("QObject", "Headings"),
+    2u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::morphTags{
      "Morphological Tags",
      "Morph",
-     QT_TRANSLATE_NOOP("QObject", "Morphological tags")};
+     QT_TRANSLATE_NOOP("QObject", "Morphological tags"),
+    3u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::lemmas{
     "Lemmas",
     "Lemma",
-    QT_TRANSLATE_NOOP("QObject", "Lemmas")};
+    QT_TRANSLATE_NOOP("QObject", "Lemmas"),
+    4u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::hebrewPoints{
     "Hebrew Vowel Points",
     "HebrewPoints",
-    QT_TRANSLATE_NOOP("QObject", "Hebrew vowel points")};
+    QT_TRANSLATE_NOOP("QObject", "Hebrew vowel points"),
+    5u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::hebrewCantillation{
     "Hebrew Cantillation",
     "Cantillation",
-    QT_TRANSLATE_NOOP("QObject", "Hebrew cantillation marks")};
+    QT_TRANSLATE_NOOP("QObject", "Hebrew cantillation marks"),
+    6u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::greekAccents{
     "Greek Accents",
     "GreekAccents",
-    QT_TRANSLATE_NOOP("QObject", "Greek accents")};
+    QT_TRANSLATE_NOOP("QObject", "Greek accents"),
+    7u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::scriptureReferences{
     "Cross-references",
     "Scripref",
-    QT_TRANSLATE_NOOP("QObject", "Scripture cross-references")};
+    QT_TRANSLATE_NOOP("QObject", "Scripture cross-references"),
+    8u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::redLetterWords{
     "Words of Christ in Red",
     "RedLetterWords",
-    QT_TRANSLATE_NOOP("QObject", "Red letter words")};
+    QT_TRANSLATE_NOOP("QObject", "Red letter words"),
+    9u};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::textualVariants{
     "Textual Variants",
     "Variants",
     QT_TRANSLATE_NOOP("QObject", "Textual variants"),
+    10u,
     &CSwordModuleInfo::FilterOption::valueToReadings};
 
 CSwordModuleInfo::FilterOption const CSwordModuleInfo::morphSegmentation{
     "Morph Segmentation",
     "MorphSegmentation",
-    QT_TRANSLATE_NOOP("QObject", "Morph segmentation")};
+    QT_TRANSLATE_NOOP("QObject", "Morph segmentation"),
+    11u};
 
 CSwordModuleInfo::CSwordModuleInfo(sword::SWModule & module,
                                    CSwordBackend & backend,
                                    ModuleType type)
-    : m_swordModule(module)
+    : m_swordModule(&module)
     , m_backend(backend)
     , m_type(type)
+    , m_hidden(false) // Set by CSwordBackend::initModules()
     , m_cancelIndexing(false)
     , m_cachedName(QString::fromUtf8(module.getName()))
     , m_cachedFeatures(retrieveFeatures(module))
+    , m_cachedFilterOptions(retrieveFilterOptions(module))
     , m_cachedCategory(retrieveCategory(type, m_cachedFeatures, module))
     , m_cachedLanguage(
         Language::fromAbbrev(
@@ -241,10 +2168,6 @@ CSwordModuleInfo::CSwordModuleInfo(sword::SWModule & module,
     , m_cachedHasVersion(
           ((*m_backend.getConfig())[module.getName()]["Version"]).size() > 0)
 {
-    m_hidden = btConfig().value<QStringList>(
-                   QStringLiteral("state/hiddenModules"))
-               .contains(m_cachedName);
-
     if (m_cachedHasVersion
         && (minimumSwordVersion() > sword::SWVersion::currentVersion))
     {
@@ -261,21 +2184,29 @@ bool CSwordModuleInfo::unlock(const QString & unlockKey) {
     if (!isEncrypted())
         return false;
 
-    bool unlocked = unlockKeyIsValid();
+    bool const unlocked = !isLocked();
 
     btConfig().setModuleEncryptionKey(m_cachedName, unlockKey);
+    CSwordBackend::updateModuleSettings();
+    {
+        std::lock_guard<std::mutex> const guard(m_configCacheMutex);
+        m_configCache[CipherKey].reset();
+        m_aboutTextCache.reset();
+    }
 
     /// \todo remove this comment once it is no longer needed
     /* There is currently a deficiency in sword 1.8.1 in that
        backend->setCipherKey() does not work correctly for modules from which
        data was already fetched. Therefore we have to reload the modules in
        bibletime.cpp */
-    m_backend.raw().setCipherKey(m_swordModule.getName(),
+    m_backend.raw().setCipherKey(m_swordModule->getName(),
                                  unlockKey.toUtf8().constData());
+    BtRawEntryCache::instance().removeModule(m_cachedName);
 
     /// \todo write to Sword config as well
 
-    if (unlockKeyIsValid() != unlocked)
+    m_lockState.store(LockState::Unknown, std::memory_order_relaxed);
+    if (isLocked() == unlocked)
         Q_EMIT unlockedChanged(!unlocked);
     return true;
 }
@@ -284,7 +2215,16 @@ bool CSwordModuleInfo::isLocked() const {
     // still works, but the cipherkey is stored in BtConfig.
     // Works because it is set in sword on program startup.
 
-    return isEncrypted() && !unlockKeyIsValid();
+    /* Checking the key decrypts the first entry, so the result is cached until
+       the key is changed by unlock(): */
+    auto state = m_lockState.load(std::memory_order_relaxed);
+    if (state == LockState::Unknown) {
+        state = (isEncrypted() && !unlockKeyIsValid())
+                ? LockState::Locked
+                : LockState::Unlocked;
+        m_lockState.store(state, std::memory_order_relaxed);
+    }
+    return state == LockState::Locked;
 }
 
 bool CSwordModuleInfo::isEncrypted() const {
@@ -305,20 +2245,33 @@ bool CSwordModuleInfo::isEncrypted() const {
 }
 
 bool CSwordModuleInfo::unlockKeyIsValid() const {
-    sword::SWKey * const key = m_swordModule.getKey();
+    sword::SWKey * const key = m_swordModule->getKey();
     sword::VerseKey * const vk = dynamic_cast<sword::VerseKey *>(key);
+
+    // Restore the position of the key, since others may rely on it:
+    std::unique_ptr<sword::SWKey> const savedKey(key->clone());
+    bool const intros = vk && vk->isIntros();
+    auto const restoreKey =
+            qScopeGuard(
+                [key, vk, intros, &savedKey]() noexcept {
+                    if (vk)
+                        vk->setIntros(intros);
+                    key->positionFrom(*savedKey);
+                });
+
     if (vk)
         vk->setIntros(false);
-    m_swordModule.setPosition(sword::TOP);
+    m_swordModule->setPosition(sword::TOP);
 
     /* This needs to use ::fromLatin1 because if the text is still locked, a lot
        of garbage will show up. It will also work with properly decrypted
        Unicode text, because all non-ASCII Unicode chars consist of bytes >127
        and therefore contain no control (nonprintable) characters, which are all
        <127. */
+    auto const rawEntry(readRawEntry(*m_swordModule));
     const QString test(isUnicode()
-                       ? QString::fromUtf8(m_swordModule.getRawEntry())
-                       : QString::fromLatin1(m_swordModule.getRawEntry()));
+                       ? QString::fromUtf8(rawEntry.c_str())
+                       : QString::fromLatin1(rawEntry.c_str()));
 
     if (test.isEmpty())
         return false;
@@ -330,16 +2283,30 @@ bool CSwordModuleInfo::unlockKeyIsValid() const {
 }
 
 QString CSwordModuleInfo::getUnlockInfo() {
-    return m_swordModule.getConfigEntry("UnlockInfo");
+    return m_swordModule->getConfigEntry("UnlockInfo");
 }
 
 QString CSwordModuleInfo::getGlobalBaseIndexLocation() {
     return util::directory::getUserIndexDir().absolutePath();
 }
 
+QString CSwordModuleInfo::getCombinedIndexLocation() {
+    /* The directory is hidden, so that it is not mistaken for the orphaned
+       index of a module, see CSwordBackend::deleteOrphanedIndices(): */
+    return getGlobalBaseIndexLocation() + QStringLiteral("/.combined");
+}
+
 QString CSwordModuleInfo::getModuleBaseIndexLocation() const {
-    return QStringLiteral("%1/%2").arg(getGlobalBaseIndexLocation(),
-                                       m_cachedName.toLocal8Bit());
+    /* Prebuilt indices of the system-wide index directory are searched first,
+       except for writable modules whose indices are updated after edits: */
+    if (auto const & sharedDir = util::directory::getSharedIndexDir();
+        sharedDir && !isWritable())
+    {
+        auto location(sharedDir->absoluteFilePath(m_cachedName));
+        if (probeIndex(location))
+            return location;
+    }
+    return getModuleUserIndexLocation();
 }
 
 QString CSwordModuleInfo::getModuleStandardIndexLocation() const {
@@ -347,15 +2314,101 @@ QString CSwordModuleInfo::getModuleStandardIndexLocation() const {
     return getModuleBaseIndexLocation() + QStringLiteral("/standard");
 }
 
+QString CSwordModuleInfo::getModuleUserIndexLocation() const {
+    return QStringLiteral("%1/%2").arg(getGlobalBaseIndexLocation(),
+                                       m_cachedName.toLocal8Bit());
+}
+
+QString CSwordModuleInfo::getModuleUserStandardIndexLocation() const
+{ return getModuleUserIndexLocation() + QStringLiteral("/standard"); }
+
 bool CSwordModuleInfo::hasIndex() const {
+    if (auto const state = m_indexState.load(std::memory_order_acquire);
+        state != IndexState::Unknown)
+        return state == IndexState::Present;
+
+    // Probing the index is slow, so the results are reused while valid:
+    auto const lastModified =
+            [](QString const & path) {
+                QFileInfo const fi(path);
+                return fi.exists()
+                       ? fi.lastModified().toMSecsSinceEpoch()
+                       : qint64(-1);
+            };
+    auto const location(getModuleBaseIndexLocation());
+    IndexStateCache::Stamp stamp{
+        m_cachedHasVersion ? config(ModuleVersion) : QString(),
+        lastModified(location + QStringLiteral("/bibletime-index.conf")),
+        lastModified(location + QStringLiteral("/standard"))};
+    auto & cache = IndexStateCache::instance();
+    auto const r =
+            [&]{
+                if (auto const cached = cache.hasIndex(m_cachedName, stamp))
+                    return *cached;
+                auto const probed = probeIndex(location);
+                cache.store(m_cachedName, std::move(stamp), probed);
+                return probed;
+            }();
+
+    // Unless the index was built or deleted meanwhile:
+    auto expected = IndexState::Unknown;
+    m_indexState.compare_exchange_strong(
+                expected,
+                r ? IndexState::Present : IndexState::Absent,
+                std::memory_order_acq_rel);
+    return r;
+}
+
+void CSwordModuleInfo::refreshIndexState() const noexcept {
+    m_indexState.store(IndexState::Unknown, std::memory_order_release);
+    m_indexSize.store(-1, std::memory_order_relaxed);
+    m_indexGeneration.fetch_add(1u, std::memory_order_release);
+}
+
+void CSwordModuleInfo::recoverIndexDirectories() {
+    auto const entries =
+            QDir(getGlobalBaseIndexLocation()).entryInfoList(
+                QDir::Dirs | QDir::NoDotAndDotDot);
+    for (auto const & entry : entries) {
+        auto const baseLocation(entry.absoluteFilePath());
+        auto const location(baseLocation + QStringLiteral("/standard"));
+        auto const oldLocation(location + QStringLiteral(".old"));
+        if (QFileInfo(oldLocation).isDir()) {
+            // Interrupted before the new index was moved in place:
+            if (!QFileInfo::exists(location)) {
+                QDir().rename(oldLocation, location);
+                continue;
+            }
+            QDir(oldLocation).removeRecursively();
+        }
+
+        // Interrupted before all files of the new index were saved:
+        if (QFileInfo::exists(stagedIndexConfigFile(location))
+            && installStagedIndexConfig(baseLocation))
+        {
+            QSettings module_config(baseLocation
+                                    + QStringLiteral("/bibletime-index.conf"),
+                                    QSettings::IniFormat);
+            module_config.setValue(QStringLiteral("needs-rebuild"), true);
+        }
+    }
+}
+
+void CSwordModuleInfo::loadIndexStates()
+{ IndexStateCache::instance().load(indexStateSnapshotFile()); }
+
+void CSwordModuleInfo::saveIndexStates()
+{ IndexStateCache::instance().save(indexStateSnapshotFile()); }
+
+bool CSwordModuleInfo::probeIndex(QString const & baseIndexLocation) const {
     { // Is this a directory?
-        QFileInfo fi(getModuleStandardIndexLocation());
+        QFileInfo fi(baseIndexLocation + QStringLiteral("/standard"));
         if (!fi.isDir())
             return false;
     }
 
     // Are the index version and module version OK?
-    QSettings module_config(getModuleBaseIndexLocation()
+    QSettings module_config(baseIndexLocation
                             + QStringLiteral("/bibletime-index.conf"),
                             QSettings::IniFormat);
 
@@ -375,9 +2428,79 @@ bool CSwordModuleInfo::hasIndex() const {
         return false;
     }
 
+    // Was the index tokenized for the language of the module?
+    if (indexTokenization(baseIndexLocation) != moduleTokenization(*this))
+        return false;
+
+    // The stored verse indices depend on the versification:
+    if (module_config.contains(QStringLiteral("versification"))
+        && module_config.value(QStringLiteral("versification")).toString()
+           != moduleVersification(*this))
+        return false;
+
     // Is the index there?
-    return lucene::index::IndexReader::indexExists(getModuleStandardIndexLocation()
-                                                   .toLatin1().constData());
+    return lucene::index::IndexReader::indexExists(
+                (baseIndexLocation + QStringLiteral("/standard"))
+                .toLatin1().constData());
+}
+
+QString CSwordModuleInfo::indexStamp() const {
+    QSettings module_config(getModuleBaseIndexLocation()
+                            + QStringLiteral("/bibletime-index.conf"),
+                            QSettings::IniFormat);
+    return QStringLiteral("%1:%2")
+            .arg(INDEX_VERSION)
+            .arg(module_config.value(QStringLiteral("index-time")).toString());
+}
+
+bool CSwordModuleInfo::hasUpdatableIndex() const {
+    if (!QFileInfo(getModuleUserStandardIndexLocation()).isDir()
+        || !QFileInfo::exists(entryHashesFile(getModuleUserIndexLocation())))
+        return false;
+
+    /* The lemma index and the verse attribute store of verse keyed modules
+       need to be updated as well: */
+    if ((m_type == Bible || m_type == Commentary)
+        && !(QFileInfo::exists(lemmaIndexFile(getModuleUserIndexLocation()))
+             && QFileInfo::exists(
+                 verseAttributeStoreFile(getModuleUserIndexLocation()))))
+        return false;
+
+    QSettings module_config(getModuleUserIndexLocation()
+                            + QStringLiteral("/bibletime-index.conf"),
+                            QSettings::IniFormat);
+    if (module_config.value(QStringLiteral("index-version")).toUInt()
+        != INDEX_VERSION)
+        return false;
+
+    // The index might lack entries since updating it failed:
+    if (module_config.value(QStringLiteral("needs-rebuild"), false).toBool())
+        return false;
+
+    // Adding or dropping the permuterm field needs a complete rebuild:
+    if (module_config.value(QStringLiteral("permuterm"), false).toBool()
+        != permutermIndexEnabled())
+        return false;
+
+    // So does changing the tokenization:
+    if (indexTokenization(getModuleUserIndexLocation())
+        != moduleTokenization(*this))
+        return false;
+
+    /* And changing the versification, since the documents, the lemma index and
+       the verse attribute store are keyed by verse indices: */
+    if (module_config.value(QStringLiteral("versification")).toString()
+        != moduleVersification(*this))
+        return false;
+
+    /* And changing the configuration entries the documents are rendered with,
+       since the hashes of the raw entries do not cover these: */
+    if (module_config.value(QStringLiteral("rendering-config")).toString()
+        != renderingConfigHash(*this))
+        return false;
+
+    return lucene::index::IndexReader::indexExists(
+                getModuleUserStandardIndexLocation().toLatin1().constData());
 }
 
 bool CSwordModuleInfo::hasImportantFilterOption() const {
@@ -391,55 +2514,82 @@ bool CSwordModuleInfo::hasImportantFilterOption() const {
     return false;
 }
 
-inline void CSwordModuleInfo::setImportantFilterOptions(bool enable) {
-    m_backend.setOption(CSwordModuleInfo::strongNumbers, enable);
-    m_backend.setOption(CSwordModuleInfo::morphTags, enable);
-    m_backend.setOption(CSwordModuleInfo::footnotes, enable);
-    m_backend.setOption(CSwordModuleInfo::headings, enable);
-}
-
-void CSwordModuleInfo::buildIndex() {
+void CSwordModuleInfo::buildIndex(std::optional<int> const shards) {
     auto cleanup =
             qScopeGuard(
                 [this]() noexcept
                 { m_cancelIndexing.store(false, std::memory_order_relaxed); });
 #define CANCEL_INDEXING (m_cancelIndexing.load(std::memory_order_relaxed))
 
+    // The directory of a new index until it replaced the old one, if any:
+    QString sideIndex;
+    IndexingCounters counters;
     try {
-        // Without this we don't get strongs, lemmas, etc.
-        m_backend.setFilterOptions(btConfig().getFilterOptions());
-        /* Make sure we reset all important filter options which influcence the
-           plain filters. Turn on these options, they are needed for the
-           EntryAttributes population */
-        setImportantFilterOptions(true);
-
-        /* We don't want the following in the text, the do not carry searchable
-           information. */
-        m_backend.setOption(CSwordModuleInfo::morphSegmentation, false);
-        m_backend.setOption(CSwordModuleInfo::scriptureReferences, false);
-        m_backend.setOption(CSwordModuleInfo::redLetterWords, false);
+        prepareIndexingFilterOptions(m_backend);
+        prefetchDataFiles(); // All entries are read in order
+
+        /* If only the module version changed, we update the existing index
+           with the entries whose content changed: */
+        auto oldHashes =
+                (incrementalIndexUpdatesEnabled() && hasUpdatableIndex())
+                ? loadEntryHashes(getModuleUserIndexLocation())
+                : std::nullopt;
+        EntryHashes newHashes;
+
+        /* When updating, the entries changed or removed are dropped from the
+           old lemma index and verse attribute store and the re-indexed
+           entries are merged in later: */
+        std::optional<BtLemmaIndex> oldLemmaIndex;
+        std::optional<BtVerseAttributeStore::Builder> oldVerseAttributes;
+        if (oldHashes && (m_type == Bible || m_type == Commentary)) {
+            oldLemmaIndex =
+                    BtLemmaIndex::load(
+                        lemmaIndexFile(getModuleUserIndexLocation()));
+            oldVerseAttributes =
+                    BtVerseAttributeStore::Builder::load(
+                        verseAttributeStoreFile(getModuleUserIndexLocation()));
+            if (!oldLemmaIndex || !oldVerseAttributes) // Rebuild all instead
+                oldHashes.reset();
+        }
 
         // Do not use any stop words:
-        Analyzer analyzer;
-        const QString index(getModuleStandardIndexLocation());
+        auto const tokenization = moduleTokenization(*this);
+        Analyzer analyzer(tokenization);
+        auto const mergePolicy(IndexMergePolicy::fromConfig());
+        auto const fastBuild = fastIndexBuildsEnabled();
+        const QString index(getModuleUserStandardIndexLocation());
 
         QDir dir(QStringLiteral("/"));
         dir.mkpath(getGlobalBaseIndexLocation());
-        dir.mkpath(getModuleBaseIndexLocation());
-        dir.mkpath(getModuleStandardIndexLocation());
-
-        if (lucene::index::IndexReader::indexExists(index.toLatin1().constData()))
-            if (lucene::index::IndexReader::isLocked(index.toLatin1().constData()))
-                lucene::index::IndexReader::unlock(index.toLatin1().constData());
+        dir.mkpath(getModuleUserIndexLocation());
+        dir.mkpath(getModuleUserStandardIndexLocation());
+
+        /* Updates are done in place, but a new index is built in a side
+           directory and swapped in when done, so that the old index can still
+           be searched meanwhile and is kept if indexing fails: */
+        if (oldHashes) {
+            IndexSearcherCache::instance().invalidate(index);
+            auto const path(index.toLatin1());
+            if (lucene::index::IndexReader::indexExists(path.constData())
+                && lucene::index::IndexReader::isLocked(path.constData()))
+                lucene::index::IndexReader::unlock(path.constData());
+        } else {
+            sideIndex = index + QStringLiteral(".new");
+            QDir(sideIndex).removeRecursively(); // Left by a crash
+            dir.mkpath(sideIndex);
+        }
 
-        // Always create a new index:
+        // Create a new index unless updating:
+        BtIndexingMemoryBudget::Share const memoryShare;
         auto writer =
             std::make_optional<lucene::index::IndexWriter>(
-                index.toLatin1().constData(),
+                (oldHashes ? index : sideIndex).toLatin1().constData(),
                 &analyzer,
-                true);
+                !oldHashes.has_value());
         writer->setMaxFieldLength(BT_MAX_LUCENE_FIELD_LENGTH);
         writer->setUseCompoundFile(true); // Merge segments into a single file
+        mergePolicy.applyTo(*writer);
+        applyMemoryShare(*writer, memoryShare);
 
         CSwordBibleModuleInfo *bm = qobject_cast<CSwordBibleModuleInfo*>(this);
 
@@ -453,10 +2603,10 @@ void CSwordModuleInfo::buildIndex() {
         }
         else
         {
-            m_swordModule.setPosition(sword::TOP);
-            verseLowIndex = m_swordModule.getIndex();
-            m_swordModule.setPosition(sword::BOTTOM);
-            verseHighIndex = m_swordModule.getIndex();
+            m_swordModule->setPosition(sword::TOP);
+            verseLowIndex = m_swordModule->getIndex();
+            m_swordModule->setPosition(sword::BOTTOM);
+            verseHighIndex = m_swordModule->getIndex();
         }
 
         // verseLowIndex is not 0 in all cases (i.e. NT-only modules)
@@ -466,204 +2616,1063 @@ void CSwordModuleInfo::buildIndex() {
         // Index() is not implemented properly for lexicons, so work around it:
         if (m_type == CSwordModuleInfo::Lexicon) {
             verseIndex = 0;
-            verseLowIndex = 0;
-            verseSpan = static_cast<CSwordLexiconModuleInfo *>(this)->entries().size();
-        }
-
-        Q_EMIT indexingProgress(0);
-
-        sword::SWKey * const key = m_swordModule.getKey();
-        sword::VerseKey * const vk = dynamic_cast<sword::VerseKey *>(key);
-
-        if (vk) {
-            /* We have to be sure to insert the english key into the index,
-               otherwise we'd be in trouble if the language changes. */
-            vk->setLocale("en_US");
-            /* If we have a verse based module, we want to include the pre-
-               chapter etc. headings in the search. */
-            vk->setIntros(true);
+            verseLowIndex = 0;
+            verseSpan = static_cast<CSwordLexiconModuleInfo *>(this)->entries().size();
         }
 
-        QByteArray textBuffer; // Holds UTF-8 data and is faster than QString.
+        Q_EMIT indexingProgress(0);
 
-        // we start with the first module entry, key is automatically updated
-        // because key is a pointer to the modules key
-        m_swordModule.setSkipConsecutiveLinks(true);
+        sword::VerseKey * const vk = prepareIndexingKey(*m_swordModule);
 
         auto const sPwcharBuffer =
             std::make_unique<wchar_t[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
         wchar_t * const wcharBuffer = sPwcharBuffer.get();
         BT_ASSERT(wcharBuffer);
 
-        if(bm && vk) // Implied that vk could be null due to cast above
-            vk->setIndex(bm->lowerBound().index());
-        else
-            m_swordModule.setPosition(sword::TOP);
-
         bool importantFilterOption = hasImportantFilterOption();
+        auto const permuterm = permutermIndexEnabled();
+        DocumentBuilder builder(permuterm);
 
-        while (!(m_swordModule.popError()) && !CANCEL_INDEXING) {
-
-            /* Also index Chapter 0 and Verse 0, because they might have
-               information in the entry attributes. We used to just put their
-               content into the textBuffer and continue to the next verse, but
-               with entry attributes this doesn't work any more. Hits in the
-               search dialog will show up as 1:1 (instead of 0). */
-
-            lucene::document::Document doc;
-
-            //index the key
-            lucene_utf8towcs(wcharBuffer, key->getText(), BT_MAX_LUCENE_FIELD_LENGTH);
-
-            doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("key")),
-                                                  static_cast<const TCHAR *>(wcharBuffer),
-                                                  lucene::document::Field::STORE_YES
-                                                  | lucene::document::Field::INDEX_NO)));
-
-            if (importantFilterOption) {
-                // Index text including strongs, morph, footnotes, and headings.
-                setImportantFilterOptions(true);
-                textBuffer.append(m_swordModule.stripText());
-                lucene_utf8towcs(wcharBuffer,
-                                 static_cast<const char *>(textBuffer),
-                                 BT_MAX_LUCENE_FIELD_LENGTH);
-                doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("content")),
-                                                      static_cast<const TCHAR *>(wcharBuffer),
-                                                      lucene::document::Field::STORE_NO
-                                                      | lucene::document::Field::INDEX_TOKENIZED)));
-                textBuffer.clear();
-            }
-
-            // Index text without strongs, morph, footnotes, and headings.
-            setImportantFilterOptions(false);
-            textBuffer.append(m_swordModule.stripText());
-            lucene_utf8towcs(wcharBuffer,
-                             static_cast<const char *>(textBuffer),
-                             BT_MAX_LUCENE_FIELD_LENGTH);
-            doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("content")),
-                                                  static_cast<const TCHAR *>(wcharBuffer),
-                                                  lucene::document::Field::STORE_NO
-                                                  | lucene::document::Field::INDEX_TOKENIZED)));
-            textBuffer.clear();
-
-            for (auto & vp : m_swordModule.getEntryAttributes()["Footnote"]) {
-                lucene_utf8towcs(wcharBuffer, vp.second["body"], BT_MAX_LUCENE_FIELD_LENGTH);
-                doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("footnote")),
-                                                      static_cast<const TCHAR *>(wcharBuffer),
-                                                      lucene::document::Field::STORE_NO
-                                                      | lucene::document::Field::INDEX_TOKENIZED)));
-            }
-
-            // Headings
-            for (auto & vp
-                 : m_swordModule.getEntryAttributes()["Heading"]["Preverse"])
-            {
-                lucene_utf8towcs(wcharBuffer, vp.second, BT_MAX_LUCENE_FIELD_LENGTH);
-                doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("heading")),
-                                                      static_cast<const TCHAR *>(wcharBuffer),
-                                                      lucene::document::Field::STORE_NO
-                                                      | lucene::document::Field::INDEX_TOKENIZED)));
-            }
+        // Verse keyed modules also get a lemma index and attribute store:
+        std::optional<BtLemmaIndex> lemmaIndex;
+        std::optional<BtVerseAttributeStore::Builder> verseAttributes;
+        std::vector<std::uint32_t> changedVerseIndices;
+        if (vk) {
+            lemmaIndex.emplace();
+            verseAttributes.emplace();
+        }
 
-            // Strongs/Morphs
-            for (auto const & vp : m_swordModule.getEntryAttributes()["Word"]) {
-                auto const & attrs = vp.second;
-                auto const partCountIter(attrs.find("PartCount"));
-                int partCount = (partCountIter != attrs.end())
-                                ? QString(partCountIter->second).toInt()
-                                : 0;
-                for (int i=0; i<partCount; i++) {
-
-                    sword::SWBuf lemmaKey = "Lemma";
-                    if (partCount > 1)
-                        lemmaKey.appendFormatted(".%d", i+1);
-                    auto const lemmaIter(attrs.find(lemmaKey));
-                    if (lemmaIter != attrs.end()) {
-                        lucene_utf8towcs(wcharBuffer, lemmaIter->second, BT_MAX_LUCENE_FIELD_LENGTH);
-                        doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("strong")),
-                                                              static_cast<const TCHAR *>(wcharBuffer),
-                                                              lucene::document::Field::STORE_NO
-                                                              | lucene::document::Field::INDEX_TOKENIZED)));
+        /* Genbooks can not be positioned by index, hence those are always
+           indexed sequentially. */
+        unsigned long const numShards =
+                (!oldHashes
+                 && ((bm && vk) || m_type == CSwordModuleInfo::Lexicon))
+                ? std::min(
+                      static_cast<unsigned long>(
+                          std::max(shards.value_or(
+                                       btConfig().value<int>(
+                                           QStringLiteral(
+                                               "settings/behaviour/"
+                                               "indexShards"),
+                                           1)),
+                                   1)),
+                      verseSpan / BT_MIN_INDEX_SHARD_SIZE)
+                : 1u;
+        if (numShards > 1u) {
+            buildIndexShards(*writer,
+                             numShards,
+                             bm ? verseLowIndex : 0u,
+                             verseSpan,
+                             bm ? (verseHighIndex + 1u) : verseSpan,
+                             importantFilterOption,
+                             !fastBuild,
+                             newHashes,
+                             lemmaIndex ? &*lemmaIndex : nullptr,
+                             verseAttributes ? &*verseAttributes : nullptr,
+                             counters);
+        } else {
+            if(bm && vk) // Implied that vk could be null due to cast above
+                vk->setIndex(bm->lowerBound().index());
+            else
+                m_swordModule->setPosition(sword::TOP);
+
+            while (!(m_swordModule->popError()) && !CANCEL_INDEXING) {
+                QByteArray keyText(m_swordModule->getKey()->getText());
+                sword::SWBuf const rawEntry(readRawEntry(*m_swordModule));
+                auto hash = entryHash(rawEntry);
+                bool entryChanged = true;
+                if (oldHashes) {
+                    if (auto const it = oldHashes->constFind(keyText);
+                        it != oldHashes->cend())
+                    {
+                        entryChanged = (*it != hash);
+                        oldHashes->erase(it);
+                        if (entryChanged) {
+                            deleteIndexedEntry(*writer, keyText, wcharBuffer);
+                            if (vk)
+                                changedVerseIndices.emplace_back(
+                                        static_cast<std::uint32_t>(
+                                            vk->getIndex()));
+                        }
                     }
-
+                }
+                if (entryChanged)
+                    indexCurrentEntry(*m_swordModule,
+                                      rawEntry,
+                                      m_backend,
+                                      importantFilterOption,
+                                      *writer,
+                                      builder,
+                                      lemmaIndex ? &*lemmaIndex : nullptr,
+                                      verseAttributes
+                                      ? &*verseAttributes
+                                      : nullptr,
+                                      counters);
+                newHashes.insert(std::move(keyText), std::move(hash));
+                counters.entries.fetch_add(1u, std::memory_order_relaxed);
+
+                //Index() is not implemented properly for lexicons, so we use a
+                //workaround.
+                if (m_type == CSwordModuleInfo::Lexicon) {
+                    verseIndex++;
+                } else {
+                    verseIndex = m_swordModule->getIndex();
                 }
 
-                auto const morphIter(attrs.find("Morph"));
-                if (morphIter != attrs.end()) {
-                    lucene_utf8towcs(wcharBuffer, morphIter->second, BT_MAX_LUCENE_FIELD_LENGTH);
-                    doc.add(*(new lucene::document::Field(static_cast<const TCHAR *>(_T("morph")),
-                                                          static_cast<const TCHAR *>(wcharBuffer),
-                                                          lucene::document::Field::STORE_NO
-                                                          | lucene::document::Field::INDEX_TOKENIZED)));
+                if (verseIndex % 200 == 0) {
+                    if (verseSpan == 0) { // Prevent division by zero
+                        Q_EMIT indexingProgress(0);
+                    } else {
+                        Q_EMIT indexingProgress(
+                                static_cast<int>(
+                                        (100 * (verseIndex - verseLowIndex))
+                                        / verseSpan));
+                    }
+                    Q_EMIT indexingStatistics(counters.statistics(verseSpan));
+                    applyMemoryShare(*writer, memoryShare);
                 }
-            }
 
-            writer->addDocument(&doc);
-            //Index() is not implemented properly for lexicons, so we use a
-            //workaround.
-            if (m_type == CSwordModuleInfo::Lexicon) {
-                verseIndex++;
-            } else {
-                verseIndex = m_swordModule.getIndex();
-            }
+                m_swordModule->increment();
+            } // while (!(m_module.Error()) && !CANCEL_INDEXING)
 
-            if (verseIndex % 200 == 0) {
-                if (verseSpan == 0) { // Prevent division by zero
-                    Q_EMIT indexingProgress(0);
-                } else {
-                    Q_EMIT indexingProgress(
-                            static_cast<int>(
-                                    (100 * (verseIndex - verseLowIndex))
-                                    / verseSpan));
+            // Remove entries no longer present in the module:
+            if (oldHashes && !CANCEL_INDEXING) {
+                for (auto it = oldHashes->cbegin(); it != oldHashes->cend(); ++it)
+                {
+                    deleteIndexedEntry(*writer, it.key(), wcharBuffer);
+                    if (vk) {
+                        sword::VerseKey removedKey(*vk);
+                        removedKey.setText(it.key().constData());
+                        changedVerseIndices.emplace_back(
+                                static_cast<std::uint32_t>(
+                                    removedKey.getIndex()));
+                    }
                 }
             }
+            if (oldVerseAttributes && verseAttributes) {
+                oldVerseAttributes->remove(changedVerseIndices);
+                oldVerseAttributes->merge(*verseAttributes);
+                verseAttributes = std::move(oldVerseAttributes);
+            }
+            if (oldLemmaIndex && lemmaIndex) {
+                oldLemmaIndex->remove(std::move(changedVerseIndices));
+                oldLemmaIndex->merge(*lemmaIndex);
+                lemmaIndex = std::move(oldLemmaIndex);
+            }
 
-            m_swordModule.increment();
-        } // while (!(m_module.Error()) && !CANCEL_INDEXING)
+            builder.logStatistics(m_cachedName);
+        }
 
-        if (!CANCEL_INDEXING)
+        // Fast builds are optimized later by optimizeIndex():
+        auto const writeStarted = IndexingCounters::Clock::now();
+        if (!CANCEL_INDEXING && !fastBuild)
             writer->optimize();
         writer->close();
         writer.reset();
+        IndexingCounters::addTimeSince(counters.writeTime, writeStarted);
+        auto const statistics = counters.statistics(verseSpan);
+        logIndexingStatistics(m_cachedName, statistics);
 
         if (CANCEL_INDEXING) {
-            deleteIndex();
+            if (sideIndex.isEmpty()) {
+                deleteIndex();
+            } else { // Keep the old index
+                QDir(sideIndex).removeRecursively();
+            }
         } else {
-            QSettings module_config(getModuleBaseIndexLocation()
-                                    + QStringLiteral("/bibletime-index.conf"),
-                                    QSettings::IniFormat);
-            if (m_cachedHasVersion)
-                module_config.setValue(QStringLiteral("module-version"),
-                                       config(CSwordModuleInfo::ModuleVersion));
-            module_config.setValue(QStringLiteral("index-version"),
-                                   INDEX_VERSION);
+            /* The configuration of a new index is staged in its directory and
+               only installed once all files of the index are saved, see
+               recoverIndexDirectories(): */
+            auto const baseLocation(getModuleUserIndexLocation());
+            auto const configFile(baseLocation
+                                  + QStringLiteral("/bibletime-index.conf"));
+            bool const staged = !sideIndex.isEmpty();
+            if (staged) // Keep any other settings
+                QFile::copy(configFile, stagedIndexConfigFile(sideIndex));
+            {
+                QSettings module_config(staged
+                                        ? stagedIndexConfigFile(sideIndex)
+                                        : configFile,
+                                        QSettings::IniFormat);
+                if (m_cachedHasVersion)
+                    module_config.setValue(
+                                QStringLiteral("module-version"),
+                                config(CSwordModuleInfo::ModuleVersion));
+                module_config.setValue(QStringLiteral("index-version"),
+                                       INDEX_VERSION);
+                module_config.setValue(QStringLiteral("permuterm"), permuterm);
+                module_config.setValue(QStringLiteral("tokenization"),
+                                       tokenizationName(tokenization));
+                module_config.setValue(QStringLiteral("versification"),
+                                       moduleVersification(*this));
+                module_config.setValue(QStringLiteral("rendering-config"),
+                                       renderingConfigHash(*this));
+                module_config.setValue(QStringLiteral("optimized"),
+                                       !fastBuild);
+                module_config.remove(QStringLiteral("needs-rebuild"));
+                module_config.setValue(QStringLiteral("index-time"),
+                                       QDateTime::currentMSecsSinceEpoch());
+                module_config.remove(QStringLiteral("index-size"));
+                module_config.sync();
+            }
+            if (staged) {
+                IndexSearcherCache::instance().invalidate(index);
+                replaceIndexDirectory(sideIndex, index);
+                sideIndex.clear();
+            }
+
+            auto const lemmaIndexFileName(
+                        lemmaIndexFile(getModuleUserIndexLocation()));
+            if (lemmaIndex) {
+                lemmaIndex->finish();
+                lemmaIndex->save(lemmaIndexFileName);
+            } else {
+                QFile::remove(lemmaIndexFileName);
+            }
+            auto const verseAttributeStoreFileName(
+                        verseAttributeStoreFile(getModuleUserIndexLocation()));
+            if (!verseAttributes
+                || !verseAttributes->save(verseAttributeStoreFileName))
+                QFile::remove(verseAttributeStoreFileName);
+            saveEntryHashes(baseLocation, newHashes);
+            if (staged && !installStagedIndexConfig(baseLocation))
+                throw std::runtime_error(
+                        "Failed to install the configuration of the index!");
+            computeIndexSize(baseLocation);
+            IndexSearcherCache::instance().invalidate(index);
+            m_indexSize.store(-1, std::memory_order_relaxed);
+            m_indexState.store(IndexState::Present, std::memory_order_release);
+            m_indexGeneration.fetch_add(1u, std::memory_order_release);
+            Q_EMIT indexingStatistics(statistics);
             Q_EMIT hasIndexChanged(true);
+            Q_EMIT indexingFinished();
         }
     // } catch (CLuceneError & e) {
     } catch (...) {
-        deleteIndex();
+        if (sideIndex.isEmpty()) {
+            deleteIndex();
+        } else { // Keep the old index
+            QDir(sideIndex).removeRecursively();
+        }
+        throw;
+    }
+}
+
+void CSwordModuleInfo::updateIndexEntries(QStringList const & keys) {
+    if (!hasUpdatableIndex())
+        return buildIndex();
+
+    try {
+        auto hashes(loadEntryHashes(getModuleUserIndexLocation()));
+        std::optional<BtLemmaIndex> lemmaIndex;
+        std::optional<BtVerseAttributeStore::Builder> verseAttributes;
+        if (hashes && (m_type == Bible || m_type == Commentary)) {
+            lemmaIndex =
+                    BtLemmaIndex::load(
+                        lemmaIndexFile(getModuleUserIndexLocation()));
+            verseAttributes =
+                    BtVerseAttributeStore::Builder::load(
+                        verseAttributeStoreFile(getModuleUserIndexLocation()));
+            if (!lemmaIndex || !verseAttributes)
+                hashes.reset();
+        }
+        if (!hashes) // Rebuild the whole index instead
+            return buildIndex();
+
+        prepareIndexingFilterOptions(m_backend);
+
+        // Do not use any stop words:
+        Analyzer analyzer(indexTokenization(getModuleUserIndexLocation()));
+        const QString index(getModuleUserStandardIndexLocation());
+        if (lucene::index::IndexReader::isLocked(index.toLatin1().constData()))
+            lucene::index::IndexReader::unlock(index.toLatin1().constData());
+        BtIndexingMemoryBudget::Share const memoryShare;
+        lucene::index::IndexWriter writer(index.toLatin1().constData(),
+                                          &analyzer,
+                                          false);
+        writer.setMaxFieldLength(BT_MAX_LUCENE_FIELD_LENGTH);
+        writer.setUseCompoundFile(true);
+        IndexMergePolicy::fromConfig().applyTo(writer);
+        applyMemoryShare(writer, memoryShare);
+
+        sword::VerseKey * const vk = prepareIndexingKey(*m_swordModule);
+        auto const wcharBuffer =
+            std::make_unique<wchar_t[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
+        bool const importantFilterOption = hasImportantFilterOption();
+        DocumentBuilder builder(
+                    indexHasPermuterm(getModuleUserIndexLocation()));
+        std::optional<BtLemmaIndex> newLemmaIndex;
+        std::vector<std::uint32_t> changedVerseIndices;
+        if (vk && lemmaIndex)
+            newLemmaIndex.emplace();
+        IndexingCounters counters;
+
+        for (auto const & key : keys) {
+            m_swordModule->getKey()->setText(key.toUtf8().constData());
+            if (m_swordModule->popError())
+                continue;
+            QByteArray keyText(m_swordModule->getKey()->getText());
+            sword::SWBuf const rawEntry(readRawEntry(*m_swordModule));
+            deleteIndexedEntry(writer, keyText, wcharBuffer.get());
+            if (newLemmaIndex)
+                changedVerseIndices.emplace_back(
+                        static_cast<std::uint32_t>(vk->getIndex()));
+            indexCurrentEntry(*m_swordModule,
+                              rawEntry,
+                              m_backend,
+                              importantFilterOption,
+                              writer,
+                              builder,
+                              newLemmaIndex ? &*newLemmaIndex : nullptr,
+                              // Replaces the attributes of the entry:
+                              (newLemmaIndex && verseAttributes)
+                              ? &*verseAttributes
+                              : nullptr,
+                              counters);
+            hashes->insert(std::move(keyText), entryHash(rawEntry));
+            counters.entries.fetch_add(1u, std::memory_order_relaxed);
+        }
+        auto const writeStarted = IndexingCounters::Clock::now();
+        writer.close();
+        IndexingCounters::addTimeSince(counters.writeTime, writeStarted);
+
+        if (lemmaIndex && newLemmaIndex) {
+            lemmaIndex->remove(std::move(changedVerseIndices));
+            lemmaIndex->merge(*newLemmaIndex);
+            lemmaIndex->finish();
+            lemmaIndex->save(lemmaIndexFile(getModuleUserIndexLocation()));
+        }
+        if (verseAttributes) {
+            auto const fileName(
+                        verseAttributeStoreFile(getModuleUserIndexLocation()));
+            if (!verseAttributes->save(fileName))
+                QFile::remove(fileName);
+        }
+
+        // Change the index stamp, so that cached lemma indices are reloaded:
+        QSettings module_config(getModuleUserIndexLocation()
+                                + QStringLiteral("/bibletime-index.conf"),
+                                QSettings::IniFormat);
+        module_config.setValue(QStringLiteral("index-time"),
+                               QDateTime::currentMSecsSinceEpoch());
+        module_config.remove(QStringLiteral("index-size"));
+        module_config.sync();
+        saveEntryHashes(getModuleUserIndexLocation(), *hashes);
+        computeIndexSize(getModuleUserIndexLocation());
+        IndexSearcherCache::instance().invalidate(index);
+        m_indexSize.store(-1, std::memory_order_relaxed);
+        m_indexGeneration.fetch_add(1u, std::memory_order_release);
+        auto const statistics =
+                counters.statistics(static_cast<std::uint64_t>(keys.size()));
+        logIndexingStatistics(m_cachedName, statistics);
+        Q_EMIT indexingStatistics(statistics);
+        Q_EMIT indexingFinished();
+    } catch (...) {
+        /* The index might lack the documents of some of the entries now, but
+           it is still better to search than none until it is rebuilt. A
+           failed rebuild by buildIndex() above already removed the index: */
+        auto const index(getModuleUserStandardIndexLocation());
+        if (QFileInfo(index).isDir()) {
+            QSettings module_config(getModuleUserIndexLocation()
+                                    + QStringLiteral("/bibletime-index.conf"),
+                                    QSettings::IniFormat);
+            module_config.setValue(QStringLiteral("needs-rebuild"), true);
+            module_config.setValue(QStringLiteral("index-time"),
+                                   QDateTime::currentMSecsSinceEpoch());
+            module_config.sync();
+            IndexSearcherCache::instance().invalidate(index);
+            m_indexGeneration.fetch_add(1u, std::memory_order_release);
+        }
         throw;
     }
 }
 
+QString CSwordModuleInfo::indexKey(CSwordKey const & key) const {
+    std::unique_ptr<sword::SWKey> k(m_swordModule->createKey());
+    auto * const vk = dynamic_cast<sword::VerseKey *>(k.get());
+    if (vk)
+        vk->setIntros(true);
+    k->setText(key.key().toUtf8().constData());
+    // The index contains the english keys, see prepareIndexingKey():
+    if (vk)
+        vk->setLocale("en_US");
+    return QString::fromUtf8(k->getText());
+}
+
+void CSwordModuleInfo::buildIndexShards(lucene::index::IndexWriter & writer,
+                                        unsigned long const numShards,
+                                        unsigned long const lowIndex,
+                                        unsigned long const span,
+                                        unsigned long const endIndex,
+                                        bool const importantFilterOption,
+                                        bool const optimize,
+                                        EntryHashes & hashes,
+                                        BtLemmaIndex * const lemmaIndex,
+                                        BtVerseAttributeStore::Builder * const
+                                                verseAttributes,
+                                        IndexingCounters & counters)
+{
+    BT_ASSERT(numShards > 1u);
+    BT_ASSERT(span > 0u);
+
+    /* For lexicons the shard boundaries are entry numbers which are turned into
+       keys via the entries() list, which we need to load before starting any
+       threads: */
+    CSwordLexiconModuleInfo::Entries const * const entries =
+            (m_type == CSwordModuleInfo::Lexicon)
+            ? &static_cast<CSwordLexiconModuleInfo *>(this)->entries()
+            : nullptr;
+
+    struct Shard {
+        QString path;
+        unsigned long begin;
+        unsigned long end;
+        std::unique_ptr<QThread> thread;
+        std::exception_ptr error;
+        EntryHashes hashes;
+        BtLemmaIndex lemmaIndex;
+        BtVerseAttributeStore::Builder verseAttributes;
+    };
+    std::vector<Shard> shards(numShards);
+    auto const removeShardDirectories =
+            qScopeGuard(
+                [&shards]() noexcept {
+                    for (auto const & shard : shards)
+                        if (!shard.path.isEmpty())
+                            QDir(shard.path).removeRecursively();
+                });
+    /* Any shard threads still running when leaving this function, e.g. due to
+       an exception, must be stopped before their states and directories are
+       destroyed: */
+    auto const joinShardThreads =
+            qScopeGuard(
+                [this, &shards]() noexcept {
+                    for (auto const & shard : shards) {
+                        if (shard.thread && shard.thread->isRunning()) {
+                            m_cancelIndexing.store(true,
+                                                   std::memory_order_relaxed);
+                            shard.thread->wait();
+                        }
+                    }
+                });
+
+    // The configuration is read before starting any threads:
+    auto const permuterm = permutermIndexEnabled();
+    auto const tokenization = moduleTokenization(*this);
+    auto const mergePolicy(IndexMergePolicy::fromConfig());
+
+    for (unsigned long i = 0u; i < numShards; ++i) {
+        auto & shard = shards[i];
+        shard.path = QStringLiteral("%1/shard-%2")
+                     .arg(getModuleUserIndexLocation())
+                     .arg(i);
+        QDir(shard.path).removeRecursively();
+        QDir(QStringLiteral("/")).mkpath(shard.path);
+        shard.begin = lowIndex + (span * i) / numShards;
+        shard.end = (i + 1u < numShards)
+                    ? lowIndex + (span * (i + 1u)) / numShards
+                    : endIndex;
+        shard.thread.reset(QThread::create(
+            [this,
+             entries,
+             importantFilterOption,
+             permuterm,
+             tokenization,
+             lemmaIndex,
+             verseAttributes,
+             &shard,
+             &counters]
+            {
+                try {
+                    /* The filter options are global to the SWMgr of the
+                       modules, hence each shard needs its own backend: */
+                    auto const backend(CSwordBackend::createWorkerInstance());
+                    auto * const m = backend->findModuleByName(m_cachedName);
+                    if (!m)
+                        throw std::runtime_error(
+                                "Module not found by indexing shard!");
+                    prepareIndexingFilterOptions(*backend);
+                    auto & module = m->swordModule();
+                    auto * const vk = prepareIndexingKey(module);
+
+                    Analyzer analyzer(tokenization);
+                    BtIndexingMemoryBudget::Share const memoryShare;
+                    lucene::index::IndexWriter writer(
+                                shard.path.toLatin1().constData(),
+                                &analyzer,
+                                true);
+                    writer.setMaxFieldLength(BT_MAX_LUCENE_FIELD_LENGTH);
+                    mergePolicy.applyTo(writer);
+                    applyMemoryShare(writer, memoryShare);
+
+                    DocumentBuilder builder(permuterm);
+
+                    if (entries) {
+                        auto const entry(
+                                entries->utf8At(
+                                    static_cast<qsizetype>(shard.begin))
+                                .toByteArray());
+                        module.getKey()->setText(
+                                    m->isUnicode()
+                                    ? entry.constData()
+                                    : util::cp1252::fromUnicode(
+                                          QString::fromUtf8(entry))
+                                          .constData());
+                    } else {
+                        BT_ASSERT(vk);
+                        vk->setIndex(static_cast<long>(shard.begin));
+                        /* The previous shard already indexed the first one of
+                           any consecutively linked entries: */
+                        if (shard.begin > 0u) {
+                            sword::VerseKey previous(*vk);
+                            previous.setIndex(
+                                        static_cast<long>(shard.begin - 1u));
+                            if (module.isLinked(&previous, vk))
+                                module.increment();
+                        }
+                    }
+
+                    for (auto n = shard.end - shard.begin;
+                         !module.popError() && !CANCEL_INDEXING;
+                         module.increment())
+                    {
+                        if (entries) {
+                            if (!n--)
+                                break;
+                        } else if (static_cast<unsigned long>(vk->getIndex())
+                                   >= shard.end)
+                        {
+                            break;
+                        }
+                        sword::SWBuf const rawEntry(readRawEntry(module));
+                        shard.hashes.insert(
+                                    QByteArray(module.getKey()->getText()),
+                                    entryHash(rawEntry));
+                        indexCurrentEntry(module,
+                                          rawEntry,
+                                          *backend,
+                                          importantFilterOption,
+                                          writer,
+                                          builder,
+                                          lemmaIndex ? &shard.lemmaIndex
+                                                     : nullptr,
+                                          verseAttributes
+                                          ? &shard.verseAttributes
+                                          : nullptr,
+                                          counters);
+                        if (counters.entries.fetch_add(
+                                    1u,
+                                    std::memory_order_relaxed) % 200u == 0u)
+                            applyMemoryShare(writer, memoryShare);
+                    }
+                    auto const writeStarted = IndexingCounters::Clock::now();
+                    writer.close();
+                    IndexingCounters::addTimeSince(counters.writeTime,
+                                                   writeStarted);
+                    builder.logStatistics(m_cachedName);
+                } catch (...) {
+                    shard.error = std::current_exception();
+                    // The index can not be completed, so stop other shards:
+                    m_cancelIndexing.store(true, std::memory_order_relaxed);
+                }
+            }));
+        shard.thread->start(QThread::LowPriority);
+    }
+
+    for (auto & shard : shards) {
+        while (!shard.thread->wait(100u)) {
+            auto const statistics = counters.statistics(span);
+            Q_EMIT indexingProgress(
+                    static_cast<int>((100u * statistics.entriesDone) / span));
+            Q_EMIT indexingStatistics(statistics);
+        }
+    }
+    // All shard threads are joined before rethrowing the first error:
+    for (auto const & shard : shards)
+        if (shard.error)
+            std::rethrow_exception(shard.error);
+    if (CANCEL_INDEXING)
+        return;
+    for (auto const & shard : shards) {
+        hashes.insert(shard.hashes);
+        if (lemmaIndex)
+            lemmaIndex->merge(shard.lemmaIndex);
+        if (verseAttributes)
+            verseAttributes->merge(shard.verseAttributes);
+    }
+
+    // Merge the shards in order, so that the document order is kept:
+    lucene::util::ValueArray<lucene::store::Directory *> directories(numShards);
+    auto const closeDirectories =
+            qScopeGuard(
+                [&directories]() noexcept {
+                    for (std::size_t i = 0u; i < directories.length; ++i) {
+                        if (auto * directory = directories.values[i]) {
+                            directory->close();
+                            _CLDECDELETE(directory);
+                        }
+                    }
+                });
+    for (std::size_t i = 0u; i < numShards; ++i)
+        directories.values[i] =
+                lucene::store::FSDirectory::getDirectory(
+                    shards[i].path.toLatin1().constData());
+    // Unlike addIndexesNoOptimize(), addIndexes() merges into a single segment:
+    auto const writeStarted = IndexingCounters::Clock::now();
+    if (optimize) {
+        writer.addIndexes(directories);
+    } else {
+        writer.addIndexesNoOptimize(directories);
+    }
+    IndexingCounters::addTimeSince(counters.writeTime, writeStarted);
+}
+
+void CSwordModuleInfo::deleteIndexedEntry(lucene::index::IndexWriter & writer,
+                                          QByteArray const & keyText,
+                                          wchar_t * const wcharBuffer)
+{
+    util::utf8::toWide(wcharBuffer,
+                       BT_MAX_LUCENE_FIELD_LENGTH,
+                       keyText.constData(),
+                       static_cast<std::size_t>(keyText.size()));
+    lucene::index::Term term(static_cast<const TCHAR *>(_T("key")),
+                             static_cast<const TCHAR *>(wcharBuffer));
+    writer.deleteDocuments(&term);
+}
+
+bool CSwordModuleInfo::incrementalIndexUpdatesEnabled() {
+    return btConfig().value<bool>(
+                QStringLiteral("settings/behaviour/incrementalIndexUpdates"),
+                true);
+}
+
+bool CSwordModuleInfo::permutermIndexEnabled() {
+    return btConfig().value<bool>(
+                QStringLiteral("settings/behaviour/permutermIndex"),
+                false);
+}
+
+bool CSwordModuleInfo::fastIndexBuildsEnabled() {
+    return btConfig().value<bool>(
+                QStringLiteral("settings/behaviour/fastIndexBuild"),
+                false);
+}
+
+bool CSwordModuleInfo::hasUnoptimizedIndex() const {
+    return QFileInfo(getModuleUserStandardIndexLocation()).isDir()
+           && !indexIsOptimized(getModuleUserIndexLocation());
+}
+
+bool CSwordModuleInfo::indexNeedsRebuild() const {
+    return QFileInfo(getModuleUserStandardIndexLocation()).isDir()
+           && indexMarkedForRebuild(getModuleUserIndexLocation());
+}
+
+void CSwordModuleInfo::optimizeIndex() {
+    if (!hasUnoptimizedIndex())
+        return;
+
+    const QString index(getModuleUserStandardIndexLocation());
+    IndexSearcherCache::instance().invalidate(index);
+    {
+        Analyzer analyzer(indexTokenization(getModuleUserIndexLocation()));
+        auto const path(index.toLatin1());
+        if (lucene::index::IndexReader::isLocked(path.constData()))
+            lucene::index::IndexReader::unlock(path.constData());
+        lucene::index::IndexWriter writer(path.constData(), &analyzer, false);
+        writer.setMaxFieldLength(BT_MAX_LUCENE_FIELD_LENGTH);
+        writer.setUseCompoundFile(true);
+        writer.optimize();
+        writer.close();
+    }
+
+    /* The documents and their order are unchanged, hence the index stamp is
+       kept: */
+    QSettings module_config(getModuleUserIndexLocation()
+                            + QStringLiteral("/bibletime-index.conf"),
+                            QSettings::IniFormat);
+    module_config.setValue(QStringLiteral("optimized"), true);
+    module_config.remove(QStringLiteral("index-size"));
+    module_config.sync();
+    computeIndexSize(getModuleUserIndexLocation());
+    IndexSearcherCache::instance().invalidate(index);
+    m_indexSize.store(-1, std::memory_order_relaxed);
+}
+
 void CSwordModuleInfo::deleteIndex() {
     deleteIndexForModule(m_cachedName);
+    // A shared index might still be there, see getModuleBaseIndexLocation():
+    refreshIndexState();
     Q_EMIT hasIndexChanged(false);
 }
 
 void CSwordModuleInfo::deleteIndexForModule(const QString & name) {
+    IndexSearcherCache::instance().invalidate(
+                QStringLiteral("%1/%2/standard")
+                .arg(getGlobalBaseIndexLocation(), name));
+    IndexStateCache::instance().invalidate(name);
     QDir(QStringLiteral("%1/%2").arg(getGlobalBaseIndexLocation(), name))
             .removeRecursively();
 }
 
+void CSwordModuleInfo::buildCombinedIndex(BtConstModuleList const & modules)
+{
+    BT_TRACE_SPAN("build combined index");
+    deleteCombinedIndex();
+    auto const location(getCombinedIndexLocation());
+    QDir(QStringLiteral("/")).mkpath(location);
+
+    std::vector<CombinedIndexPart> parts;
+    bool permuterm = true; // Whether all parts have the permuterm field
+    try {
+        lucene::util::ValueArray<lucene::store::Directory *> directories(
+                    static_cast<std::size_t>(modules.size()));
+        auto const closeDirectories =
+                qScopeGuard(
+                    [&directories]() noexcept {
+                        for (std::size_t i = 0u; i < directories.length; ++i) {
+                            if (auto * directory = directories.values[i]) {
+                                directory->close();
+                                _CLDECDELETE(directory);
+                            }
+                        }
+                    });
+        std::int32_t docBase = 0;
+        for (auto const * const m : modules) {
+            /* The combined index is queried with a single analyzer, hence
+               modules tokenized by bigrams are searched on their own: */
+            if (!m->hasIndex()
+                || indexTokenization(m->getModuleBaseIndexLocation())
+                   != Tokenization::Words)
+                continue;
+            /* Take the stamp first, so that concurrent updates of the index
+               make the combined index outdated: */
+            auto stamp(m->indexStamp());
+            permuterm = permuterm
+                        && indexHasPermuterm(m->getModuleBaseIndexLocation());
+            auto * const directory =
+                    lucene::store::FSDirectory::getDirectory(
+                        m->getModuleStandardIndexLocation()
+                        .toLatin1().constData());
+            directories.values[parts.size()] = directory;
+
+            /* Merging drops the documents deleted by incremental index updates
+               and appends the others in order: */
+            std::unique_ptr<lucene::index::IndexReader> reader(
+                        lucene::index::IndexReader::open(directory));
+            auto const docCount = reader->numDocs();
+            reader->close();
+
+            parts.emplace_back(CombinedIndexPart{m->name(),
+                                                 std::move(stamp),
+                                                 docBase,
+                                                 docCount});
+            docBase += docCount;
+        }
+        directories.length = parts.size();
+
+        Analyzer analyzer;
+        lucene::index::IndexWriter writer(location.toLatin1().constData(),
+                                          &analyzer,
+                                          true);
+        writer.setMaxFieldLength(BT_MAX_LUCENE_FIELD_LENGTH);
+        writer.addIndexes(directories);
+        writer.close();
+    } catch (...) {
+        deleteCombinedIndex();
+        throw;
+    }
+
+    QSettings config(combinedIndexConfigFile(), QSettings::IniFormat);
+    config.setValue(QStringLiteral("index-version"), INDEX_VERSION);
+    config.setValue(QStringLiteral("permuterm"), permuterm);
+    config.beginWriteArray(QStringLiteral("modules"),
+                           static_cast<int>(parts.size()));
+    for (std::size_t i = 0u; i < parts.size(); ++i) {
+        config.setArrayIndex(static_cast<int>(i));
+        config.setValue(QStringLiteral("name"), parts[i].moduleName);
+        config.setValue(QStringLiteral("index-stamp"), parts[i].indexStamp);
+        config.setValue(QStringLiteral("doc-base"), parts[i].docBase);
+        config.setValue(QStringLiteral("doc-count"), parts[i].docCount);
+    }
+    config.endArray();
+    config.sync();
+}
+
+void CSwordModuleInfo::deleteCombinedIndex() {
+    auto const location(getCombinedIndexLocation());
+    IndexSearcherCache::instance().invalidate(location);
+    QDir(location).removeRecursively();
+}
+
+void CSwordModuleInfo::releaseCachedIndexSearchers()
+{ IndexSearcherCache::instance().clear(); }
+
+void CSwordModuleInfo::prefetchDataFiles() const {
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    /* The data path is the directory of the module files, or for some drivers
+       like those of lexicons the common prefix of the file names: */
+    QFileInfo const dataPath(config(AbsoluteDataPath));
+    auto const files =
+            dataPath.isDir()
+            ? QDir(dataPath.filePath()).entryInfoList(QDir::Files)
+            : dataPath.dir().entryInfoList(
+                  {dataPath.fileName() + QStringLiteral("*")},
+                  QDir::Files);
+    for (auto const & file : files) {
+        auto const fd = ::open(QFile::encodeName(file.filePath()).constData(),
+                               O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        ::close(fd);
+    }
+#endif
+}
+
+void CSwordModuleInfo::releaseCaches() const {
+    {
+        std::lock_guard<std::mutex> const guard(m_lemmaIndexMutex);
+        m_lemmaIndex.reset();
+        m_lemmaIndexStamp.clear();
+    }
+    {
+        std::lock_guard<std::mutex> const guard(m_verseAttributeStoreMutex);
+        m_verseAttributeStore.reset();
+        m_verseAttributeStoreGeneration.reset();
+    }
+    {
+        std::lock_guard<std::mutex> const guard(m_corpusStatisticsMutex);
+        m_corpusStatistics.reset();
+        m_corpusStatisticsStamp.clear();
+    }
+    IndexSearcherCache::instance().invalidate(
+                getModuleStandardIndexLocation());
+    BtRawEntryCache::instance().removeModule(m_cachedName);
+}
+
+void CSwordModuleInfo::releaseIdleModules(
+        QList<CSwordModuleInfo *> const & modules,
+        std::uint32_t const idlePeriods)
+{
+    BT_ASSERT(idlePeriods > 0u);
+    auto const period =
+            m_currentUsePeriod.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    // Release every module only once after it became idle:
+    for (auto const * const module : modules)
+        if (period - module->m_lastUsedPeriod.load(std::memory_order_relaxed)
+            == idlePeriods)
+            module->releaseCaches();
+}
+
 ::qint64 CSwordModuleInfo::indexSize() const {
+    if (auto const cached = m_indexSize.load(std::memory_order_relaxed);
+        cached >= 0)
+        return cached;
+    auto const recorded = recordedIndexSize();
+    auto const size = recorded
+                      ? *recorded
+                      : computeIndexSize(getModuleBaseIndexLocation());
+    m_indexSize.store(size, std::memory_order_relaxed);
+    return size;
+}
+
+std::optional<::qint64> CSwordModuleInfo::recordedIndexSize() const {
+    QSettings module_config(getModuleBaseIndexLocation()
+                            + QStringLiteral("/bibletime-index.conf"),
+                            QSettings::IniFormat);
+    bool ok;
+    auto const size =
+            module_config.value(QStringLiteral("index-size")).toLongLong(&ok);
+    if (!ok || size < 0)
+        return {};
+    return size;
+}
+
+::qint64 CSwordModuleInfo::computeIndexSize(
+        QString const & baseIndexLocation)
+{
     namespace DU = util::directory;
-    return DU::getDirSizeRecursive(getModuleBaseIndexLocation());
+    auto const size = DU::getDirSizeRecursive(baseIndexLocation);
+    QSettings module_config(baseIndexLocation
+                            + QStringLiteral("/bibletime-index.conf"),
+                            QSettings::IniFormat);
+    // Don't create the configuration of indexes which do not exist:
+    if (module_config.contains(QStringLiteral("index-version")))
+        module_config.setValue(QStringLiteral("index-size"), size);
+    return size;
+}
+
+std::shared_ptr<BtLemmaIndex const> CSwordModuleInfo::lemmaIndex() const {
+    // Reload the lemma index whenever the index has been rebuilt:
+    auto stamp(indexStamp());
+    std::lock_guard<std::mutex> const guard(m_lemmaIndexMutex);
+    if (stamp != m_lemmaIndexStamp) {
+        m_lemmaIndex.reset();
+        if (hasIndex())
+            if (auto lemmaIndex =
+                    BtLemmaIndex::load(
+                        lemmaIndexFile(getModuleBaseIndexLocation())))
+                m_lemmaIndex =
+                        std::make_shared<BtLemmaIndex const>(
+                            std::move(*lemmaIndex));
+        m_lemmaIndexStamp = std::move(stamp);
+    }
+    return m_lemmaIndex;
+}
+
+std::shared_ptr<BtCorpusStatistics const>
+CSwordModuleInfo::corpusStatistics(BtCancellationToken const & cancellation)
+        const
+{
+    if (!hasIndex())
+        return {};
+    auto stamp(indexStamp());
+    {
+        std::lock_guard<std::mutex> const guard(m_corpusStatisticsMutex);
+        if (m_corpusStatistics && stamp == m_corpusStatisticsStamp)
+            return m_corpusStatistics;
+    }
+
+    // The statistics are saved with the index, unless it is not writable:
+    auto const fileName(corpusStatisticsFile(getModuleBaseIndexLocation()));
+    std::shared_ptr<BtCorpusStatistics const> r;
+    if (auto loaded = BtCorpusStatistics::load(fileName, stamp)) {
+        r = std::make_shared<BtCorpusStatistics const>(std::move(*loaded));
+    } else if (auto computed = computeCorpusStatistics(cancellation)) {
+        computed->save(fileName, stamp);
+        r = std::move(computed);
+    } else {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> const guard(m_corpusStatisticsMutex);
+    m_corpusStatistics = r;
+    m_corpusStatisticsStamp = std::move(stamp);
+    return r;
+}
+
+std::shared_ptr<BtCorpusStatistics>
+CSwordModuleInfo::computeCorpusStatistics(
+        BtCancellationToken const & cancellation) const
+{
+    BT_TRACE_SPAN("compute corpus statistics");
+    auto const searcher(IndexSearcherCache::instance().searcher(
+                            getModuleStandardIndexLocation()));
+    auto * const reader = searcher->getReader();
+    auto r(std::make_shared<BtCorpusStatistics>());
+    r->m_numEntries = static_cast<std::uint32_t>(reader->numDocs());
+
+    /* Map the documents of verse keyed modules to their books, numbered in the
+       order of the versification: */
+    std::vector<int> docBooks;
+    std::unique_ptr<sword::SWKey> key(m_swordModule->createKey());
+    if (auto * const vk = dynamic_cast<sword::VerseKey *>(key.get())) {
+        vk->setIntros(true);
+        auto const & verseIndices = searcher->verseIndices();
+        docBooks.resize(verseIndices.size(), -1);
+        std::map<std::pair<char, char>, int> books;
+        for (std::size_t i = 0u; i < verseIndices.size(); ++i) {
+            if (i % BT_SEARCH_CANCELLATION_INTERVAL == 0u
+                && cancellation.cancelled())
+                return {};
+            if (verseIndices[i] < 0
+                || reader->isDeleted(static_cast<int32_t>(i)))
+                continue;
+            vk->setIndex(verseIndices[i]);
+            if (vk->getTestament() > 0 && vk->getBook() > 0) {
+                books.try_emplace(std::pair(vk->getTestament(), vk->getBook()),
+                                  0);
+                docBooks[i] = vk->getTestament() * 256 + vk->getBook();
+            }
+        }
+
+        std::unique_ptr<sword::SWKey> nameKey(m_swordModule->createKey());
+        auto & localizedKey = static_cast<sword::VerseKey &>(*nameKey);
+        localizedKey.setIntros(true);
+        for (auto & [book, number] : books) {
+            number = static_cast<int>(r->m_books.size());
+            localizedKey.setTestament(book.first);
+            localizedKey.setBook(book.second);
+            r->m_books.append(QString::fromUtf8(localizedKey.getBookName()));
+        }
+        for (auto & docBook : docBooks)
+            if (docBook >= 0)
+                docBook = books[std::pair(static_cast<char>(docBook / 256),
+                                          static_cast<char>(docBook % 256))];
+    }
+
+    // Walk the term dictionary once, reading the postings of every term:
+    auto const numBooks = static_cast<std::size_t>(r->m_books.size());
+    std::unique_ptr<lucene::index::TermEnum> termEnum(reader->terms());
+    std::unique_ptr<lucene::index::TermDocs> termDocs(reader->termDocs());
+    auto const cleanup =
+            qScopeGuard(
+                [&termEnum, &termDocs]() noexcept {
+                    termDocs->close();
+                    termEnum->close();
+                });
+    for (std::size_t n = 1u; termEnum->next(); ++n) {
+        if (n % BT_SEARCH_CANCELLATION_INTERVAL == 0u
+            && cancellation.cancelled())
+            return {};
+        auto * const term = termEnum->term(false);
+        auto const * const field = term->field();
+        std::vector<BtCorpusStatistics::Term> * terms;
+        if (!_tcscmp(field, _T("content"))) {
+            terms = &r->m_terms[0];
+        } else if (!_tcscmp(field, _T("strong"))) {
+            terms = &r->m_terms[1];
+        } else if (!_tcscmp(field, _T("morph"))) {
+            terms = &r->m_terms[2];
+        } else {
+            continue;
+        }
+
+        BtCorpusStatistics::Term t{
+            QString::fromWCharArray(
+                    static_cast<wchar_t const *>(term->text())),
+            0u,
+            0u,
+            std::vector<std::uint32_t>(numBooks, 0u)};
+        termDocs->seek(termEnum.get());
+        while (termDocs->next()) {
+            t.occurrences += static_cast<std::uint64_t>(termDocs->freq());
+            ++t.entries;
+            if (numBooks > 0u)
+                if (auto const book =
+                        docBooks[static_cast<std::size_t>(termDocs->doc())];
+                    book >= 0)
+                    ++t.bookEntries[static_cast<std::size_t>(book)];
+        }
+        terms->emplace_back(std::move(t));
+    }
+    return r;
+}
+
+std::shared_ptr<BtVerseAttributeStore const>
+CSwordModuleInfo::verseAttributeStore() const {
+    /* Unlike lemmaIndex(), this is used when rendering every verse, hence the
+       index configuration is not read every time: */
+    auto const generation = m_indexGeneration.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> const guard(m_verseAttributeStoreMutex);
+    if (m_verseAttributeStoreGeneration != generation) {
+        m_verseAttributeStore.reset();
+        if ((m_type == Bible || m_type == Commentary) && hasIndex())
+            m_verseAttributeStore =
+                    BtVerseAttributeStore::load(
+                        verseAttributeStoreFile(getModuleBaseIndexLocation()));
+        m_verseAttributeStoreGeneration = generation;
+    }
+    return m_verseAttributeStore;
 }
 
 CSwordModuleSearch::ModuleResultList
 CSwordModuleInfo::searchIndexed(QString const & searchedText,
-                                sword::ListKey const & scope) const
+                                sword::ListKey const & scope,
+                                std::size_t const pageSize,
+                                BtCancellationToken const & cancellation,
+                                int const maxThreads) const
 {
     auto const sPutfBuffer =
         std::make_unique<char[]>(BT_MAX_LUCENE_FIELD_LENGTH  + 1);
@@ -674,40 +3683,135 @@ CSwordModuleInfo::searchIndexed(QString const & searchedText,
     wchar_t * const wcharBuffer = sPwcharBuffer.get();
     BT_ASSERT(wcharBuffer);
 
-    // work around Swords thread insafety for Bibles and Commentaries
-    m_swordModule.setKey(createKey()->asSwordKey());
+    BT_TRACE_SPAN("search indexed");
 
     // do not use any stop words
-    Analyzer analyzer;
-    lucene::search::IndexSearcher searcher(getModuleStandardIndexLocation().toLatin1().constData());
-    lucene_utf8towcs(wcharBuffer, searchedText.toUtf8().constData(), BT_MAX_LUCENE_FIELD_LENGTH);
-    std::unique_ptr<lucene::search::Query> q(lucene::queryParser::QueryParser::parse(static_cast<const TCHAR *>(wcharBuffer),
-                                                                                     static_cast<const TCHAR *>(_T("content")),
-                                                                                     &analyzer));
+    auto const tokenization = indexTokenization(getModuleBaseIndexLocation());
+    Analyzer analyzer(tokenization);
+    auto const location(getModuleStandardIndexLocation());
+    auto const searcher(IndexSearcherCache::instance().searcher(location));
+    std::unique_ptr<lucene::search::Query> q;
+    {
+        BT_TRACE_SPAN("search indexed: parse query");
+        auto const utf8Text(searchedText.toUtf8());
+        util::utf8::toWide(wcharBuffer,
+                           BT_MAX_LUCENE_FIELD_LENGTH,
+                           utf8Text.constData(),
+                           static_cast<std::size_t>(utf8Text.size()));
+        ContentQueryParser parser(
+                    &analyzer,
+                    indexHasPermuterm(getModuleBaseIndexLocation()));
+        q.reset(parser.parse(static_cast<const TCHAR *>(wcharBuffer)));
+    }
 
-    std::unique_ptr<lucene::search::Hits> h(
-                searcher.search(q.get(), lucene::search::Sort::INDEXORDER()));
+    /* Large indices are searched in ranges of their documents concurrently,
+       small ones are searched faster in a single thread: */
+    auto const numRanges =
+            std::min({static_cast<std::int32_t>(maxThreads),
+                      static_cast<std::int32_t>(QThread::idealThreadCount()),
+                      searcher->getReader()->maxDoc()
+                      / BT_MIN_SEARCH_RANGE_SIZE});
+    std::optional<std::vector<std::int32_t>> docs;
+    std::unique_ptr<lucene::search::Hits> h;
+    if (numRanges > 1) {
+        docs = searchRangesInParallel(*searcher, *q, numRanges, cancellation);
+    } else {
+        BT_TRACE_SPAN("search indexed: lucene search");
+        h.reset(searcher->search(q.get(),
+                                 lucene::search::Sort::INDEXORDER()));
+    }
+
+    /* The terms of modules tokenized by bigrams are pairs of characters, which
+       the highlighter can not match against words: */
+    std::shared_ptr<CSwordModuleSearch::QueryTerms const> queryTerms;
+    if (tokenization == Tokenization::Words)
+        queryTerms = extractQueryTerms(q.get(), searcher->getReader());
 
     const bool useScope = (scope.getCount() > 0);
 
-    lucene::document::Document * doc = nullptr;
-    std::unique_ptr<sword::SWKey> swKey(m_swordModule.createKey());
+    /* The module is shared with the GUI thread, which sets its key to render
+       entries, so the hits are resolved using a private key instead: */
+    std::unique_ptr<sword::SWKey> swKey(m_swordModule->createKey());
 
     sword::VerseKey * const vk = dynamic_cast<sword::VerseKey *>(swKey.get());
     if (vk)
         vk->setIntros(true);
 
-    CSwordModuleSearch::ModuleResultList results;
-    for (size_t i = 0; i < h->length(); ++i) {
-        doc = &h->doc(i);
-        lucene_wcstoutf8(utfBuffer,
-                         static_cast<const wchar_t *>(doc->get(static_cast<const TCHAR *>(_T("key")))),
-                         BT_MAX_LUCENE_FIELD_LENGTH);
+    if (numRanges > 1 && !docs) // Cancelled
+        return CSwordModuleSearch::ModuleResultList(*swKey);
+    auto const numHits = docs ? docs->size() : h->length();
+    auto const * const verseIndices = vk ? &searcher->verseIndices() : nullptr;
+
+    /* Without a scope every hit is a result, so the hits of pathological
+       queries can be left in the Hits object and fetched later on demand: */
+    bool pageHits = !useScope && pageSize > 0u && numHits > pageSize;
+
+    /* Entries changed by incremental index updates are at the end of the
+       index, so the hits of verse based modules are paged in verse order by
+       their verse indices. Hits lacking verse indices are all collected and
+       sorted below instead: */
+    if (pageHits && verseIndices) {
+        if (!docs) {
+            docs.emplace();
+            docs->reserve(numHits);
+            for (std::size_t i = 0u; i < numHits; ++i)
+                docs->push_back(h->id(i));
+        }
+        pageHits = sortDocumentsByVerse(*docs, *verseIndices);
+    }
+
+    if (pageHits && docs) {
+        CSwordModuleSearch::ModuleResultList results(*swKey);
+        results.setQueryTerms(std::move(queryTerms));
+        auto pendingHits(std::make_shared<DocumentPendingHits>(searcher,
+                                                               std::move(*docs),
+                                                               *swKey,
+                                                               pageSize));
+        pendingHits->fetch(0u, pageSize, results);
+        IndexSearcherCache::instance().addPendingHits(location, pendingHits);
+        results.setPendingHits(std::move(pendingHits));
+        return results;
+    }
+    if (pageHits) {
+        CSwordModuleSearch::ModuleResultList results(*swKey);
+        results.setQueryTerms(std::move(queryTerms));
+        auto pendingHits(std::make_shared<LucenePendingHits>(searcher,
+                                                             std::move(q),
+                                                             std::move(h),
+                                                             *swKey,
+                                                             pageSize));
+        pendingHits->fetch(0u, pageSize, results);
+        IndexSearcherCache::instance().addPendingHits(location, pendingHits);
+        results.setPendingHits(std::move(pendingHits));
+        return results;
+    }
 
-        swKey->setText(utfBuffer);
+    std::optional<CSwordModuleSearch::ScopeIntervals> scopeIntervals;
+    if (useScope && vk)
+        scopeIntervals.emplace(scope, *vk);
+
+    BT_TRACE_SPAN("search indexed: collect hits");
+    CSwordModuleSearch::ModuleResultList results(*swKey);
+    results.setQueryTerms(std::move(queryTerms));
+    for (size_t i = 0; i < numHits; ++i) {
+        if (i % BT_SEARCH_CANCELLATION_INTERVAL == 0u
+            && cancellation.cancelled())
+            return results;
+        if (docs) {
+            setKeyToDocument(*swKey,
+                             *searcher,
+                             (*docs)[i],
+                             verseIndices,
+                             utfBuffer);
+        } else {
+            setKeyToHit(*swKey, *h, i, verseIndices, utfBuffer);
+        }
 
         // Limit results based on scope:
-        if (useScope) {
+        if (scopeIntervals) {
+            if (scopeIntervals->contains(vk->getIndex()))
+                results.append(*swKey);
+        } else if (useScope) {
             for (int j = 0; j < scope.getCount(); j++) {
                 if (auto const * const vkey =
                             dynamic_cast<sword::VerseKey const *>(
@@ -715,14 +3819,132 @@ CSwordModuleInfo::searchIndexed(QString const & searchedText,
                 {
                     if (vkey->getLowerBound().compare(*swKey) <= 0
                         && vkey->getUpperBound().compare(*swKey) >= 0)
-                        results.emplace_back(swKey->clone());
+                        results.append(*swKey);
                 }
             }
         } else { // No scope, give me all buffers
-            results.emplace_back(swKey->clone());
+            results.append(*swKey);
+        }
+    }
+
+    /* Entries changed by incremental index updates are at the end of the
+       index, so make sure verse based results are still in verse order: */
+    results.sortVerses();
+
+    return results;
+}
+
+std::optional<std::vector<CSwordModuleSearch::ModuleResultList>>
+CSwordModuleInfo::searchCombinedIndex(QString const & searchedText,
+                                      BtConstModuleList const & modules,
+                                      sword::ListKey const & scope)
+{
+    BT_TRACE_SPAN("search combined index");
+
+    // Find the parts of the searched modules, in the order of the documents:
+    struct Part {
+        std::size_t moduleIndex;
+        std::int32_t docBase;
+        std::int32_t docEnd;
+    };
+    std::vector<Part> parts;
+    {
+        auto const allParts(loadCombinedIndexParts());
+        for (int i = 0; i < modules.size(); ++i) {
+            auto const * const m = modules.at(i);
+            auto const it =
+                    std::find_if(allParts.begin(),
+                                 allParts.end(),
+                                 [m](CombinedIndexPart const & part)
+                                 { return part.moduleName == m->name(); });
+            if (it == allParts.end() || it->indexStamp != m->indexStamp())
+                return {};
+            parts.emplace_back(Part{static_cast<std::size_t>(i),
+                                    it->docBase,
+                                    it->docBase + it->docCount});
+        }
+    }
+    std::sort(parts.begin(),
+              parts.end(),
+              [](Part const & a, Part const & b)
+              { return a.docBase < b.docBase; });
+
+    // Only verse based modules can be scoped without their own keys:
+    std::vector<std::unique_ptr<sword::SWKey>> keys;
+    std::vector<std::optional<CSwordModuleSearch::ScopeIntervals>>
+            scopeIntervals(static_cast<std::size_t>(modules.size()));
+    std::vector<CSwordModuleSearch::ModuleResultList> results;
+    for (std::size_t i = 0u; i < scopeIntervals.size(); ++i) {
+        keys.emplace_back(
+                    modules.at(static_cast<int>(i))->swordModule().createKey());
+        auto * const vk = dynamic_cast<sword::VerseKey *>(keys.back().get());
+        if (vk) {
+            vk->setIntros(true);
+        } else if (scope.getCount() > 0) {
+            return {};
         }
+        results.emplace_back(*keys.back());
+        if (vk && scope.getCount() > 0)
+            scopeIntervals[i].emplace(scope, *vk);
+    }
+
+    auto const location(getCombinedIndexLocation());
+    if (!lucene::index::IndexReader::indexExists(
+            location.toLatin1().constData()))
+        return {};
+
+    auto const utfBuffer =
+            std::make_unique<char[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
+    auto const wcharBuffer =
+            std::make_unique<wchar_t[]>(BT_MAX_LUCENE_FIELD_LENGTH + 1);
+
+    // do not use any stop words
+    Analyzer analyzer;
+    auto const searcher(IndexSearcherCache::instance().searcher(location));
+    std::unique_ptr<lucene::search::Query> q;
+    {
+        auto const utf8Text(searchedText.toUtf8());
+        util::utf8::toWide(wcharBuffer.get(),
+                           BT_MAX_LUCENE_FIELD_LENGTH,
+                           utf8Text.constData(),
+                           static_cast<std::size_t>(utf8Text.size()));
+        ContentQueryParser parser(&analyzer, indexHasPermuterm(location));
+        q.reset(parser.parse(static_cast<const TCHAR *>(wcharBuffer.get())));
+    }
+    std::unique_ptr<lucene::search::Hits> h(
+                searcher->search(q.get(), lucene::search::Sort::INDEXORDER()));
+
+    // The hits are in document order, hence the parts are visited in turn:
+    auto part = parts.cbegin();
+    for (std::size_t i = 0u; i < h->length(); ++i) {
+        auto const id = h->id(i);
+        while (part != parts.cend() && id >= part->docEnd)
+            ++part;
+        if (part == parts.cend())
+            break;
+        if (id < part->docBase) // A hit of a module not searched
+            continue;
+
+        auto & key = *keys[part->moduleIndex];
+        setKeyToHit(key,
+                    *h,
+                    i,
+                    dynamic_cast<sword::VerseKey *>(&key)
+                    ? &searcher->verseIndices()
+                    : nullptr,
+                    utfBuffer.get());
+        auto const & intervals = scopeIntervals[part->moduleIndex];
+        if (!intervals
+            || intervals->contains(
+                static_cast<sword::VerseKey &>(key).getIndex()))
+            results[part->moduleIndex].append(key);
     }
 
+    /* Entries changed by incremental index updates are at the end of the
+       index of their module, so make sure verse based results are still in
+       verse order: */
+    for (auto & r : results)
+        r.sortVerses();
     return results;
 }
 
@@ -732,17 +3954,51 @@ sword::SWVersion CSwordModuleInfo::minimumSwordVersion() const {
 }
 
 QString CSwordModuleInfo::config(const CSwordModuleInfo::ConfigEntry entry) const {
+    if (entry < 0 || entry > Markup)
+        return {};
+
+    // Entries decoded by getFormattedConfigEntry() depend on the language:
+    QString language;
+    switch (entry) {
+        case AboutInformation:
+        case Description:
+        case DistributionLicense:
+        case DistributionSource:
+        case DistributionNotes:
+        case TextSource:
+        case CopyrightNotes:
+        case CopyrightHolder:
+        case CopyrightDate:
+        case CopyrightContactName:
+        case CopyrightContactAddress:
+        case CopyrightContactEmail:
+            language = CSwordBackend::instance().booknameLanguage();
+            break;
+        default:
+            break;
+    }
+
+    std::lock_guard<std::mutex> const guard(m_configCacheMutex);
+    auto & cached = m_configCache[entry];
+    if (!cached || cached->language != language)
+        cached.emplace(CachedConfigEntry{std::move(language),
+                                         decodeConfig(entry)});
+    return cached->value;
+}
+
+QString CSwordModuleInfo::decodeConfig(ConfigEntry const entry) const {
     switch (entry) {
 
         case AboutInformation:
             return getFormattedConfigEntry(QStringLiteral("About"));
 
         case CipherKey: {
-            if (btConfig().getModuleEncryptionKey(m_cachedName).isNull()) {
-                return QString(m_swordModule.getConfigEntry("CipherKey")); // Fallback
-            } else {
-                return btConfig().getModuleEncryptionKey(m_cachedName);
-            }
+            // Also decoded by the modules of worker instances:
+            auto key(CSwordBackend::moduleSettings()->cipherKeys.value(
+                         m_cachedName));
+            if (key.isNull())
+                return QString(m_swordModule->getConfigEntry("CipherKey")); // Fallback
+            return key;
         }
 
         case AbsoluteDataPath: {
@@ -854,31 +4110,6 @@ QString CSwordModuleInfo::config(const CSwordModuleInfo::ConfigEntry entry) cons
     }
 }
 
-bool CSwordModuleInfo::has(CSwordModuleInfo::FilterOption const & option) const {
-    /// \todo This is a BAD workaround to see if the filter is GBF, OSIS or ThML!
-    auto const & originalOptionName = option.configOptionName;
-    using namespace std::string_literals;
-    std::string const optionNames[] = {
-        "OSIS"s + originalOptionName,
-        "GBF"s + originalOptionName,
-        "ThML"s + originalOptionName,
-        "UTF8"s + originalOptionName,
-        originalOptionName
-    };
-    for (auto [it, end] =
-                m_swordModule.getConfig().equal_range("GlobalOptionFilter");
-         it != end;
-         ++it)
-    {
-        auto const & valueBuf = it->second;
-        std::string_view const value(valueBuf.c_str(), valueBuf.size());
-        for (auto const & optionName : optionNames)
-            if (value == optionName)
-                return true;
-    }
-    return false;
-}
-
 CSwordModuleInfo::TextDirection CSwordModuleInfo::textDirection() const {
     return (config(TextDir) == QStringLiteral("RtoL"))
             ? RightToLeft
@@ -889,16 +4120,37 @@ char const * CSwordModuleInfo::textDirectionAsHtml() const
 { return textDirection() == RightToLeft ? "rtl" : "ltr"; }
 
 void CSwordModuleInfo::write(CSwordKey * key, const QString & newText) {
-    m_swordModule.setKey(key->key().toUtf8().constData());
+    // The journal is keyed by the key texts as normalized by the module:
+    m_swordModule->setKey(key->key().toUtf8().constData());
+    BtEntryWriteJournal::instance().write(
+                *this,
+                QByteArray(m_swordModule->getKey()->getText()),
+                isUnicode() ? newText.toUtf8() : newText.toLocal8Bit());
+}
 
-    /* Don't store a pointer to the const char* value somewhere because QCString
-      doesn't keep the value of it. */
-    m_swordModule.setEntry(isUnicode()
-                      ? newText.toUtf8().constData()
-                      : newText.toLocal8Bit().constData());
+void CSwordModuleInfo::writeEntry(QByteArray const & key,
+                                  QByteArray const & entry)
+{
+    m_swordModule->setKey(key.constData());
+    m_swordModule->setEntry(entry.constData(), entry.size());
 }
 
 QString CSwordModuleInfo::aboutText() const {
+    // The text depends on the languages of the GUI and the localized entries:
+    auto language(QLocale().name() + QChar('\n')
+                  + CSwordBackend::instance().booknameLanguage());
+    {
+        std::lock_guard<std::mutex> const guard(m_configCacheMutex);
+        if (m_aboutTextCache && m_aboutTextCache->language == language)
+            return m_aboutTextCache->value;
+    }
+    auto text(renderAboutText());
+    std::lock_guard<std::mutex> const guard(m_configCacheMutex);
+    m_aboutTextCache.emplace(CachedConfigEntry{std::move(language), text});
+    return text;
+}
+
+QString CSwordModuleInfo::renderAboutText() const {
     static auto const row(
                 QStringLiteral("<tr><td><b>%1</b></td><td>%2</td></tr>"));
 
@@ -911,7 +4163,7 @@ QString CSwordModuleInfo::aboutText() const {
                  : tr("unknown"));
 
     {
-        const QString sourceType(m_swordModule.getConfigEntry("SourceType"));
+        const QString sourceType(m_swordModule->getConfigEntry("SourceType"));
         text += row
                 .arg(tr("Markup"))
                 .arg(!sourceType.isEmpty()
@@ -927,11 +4179,11 @@ QString CSwordModuleInfo::aboutText() const {
             .arg(tr("Language"))
             .arg(m_cachedLanguage->translatedName().toHtmlEscaped());
 
-    if (char const * const e = m_swordModule.getConfigEntry("Category"))
+    if (char const * const e = m_swordModule->getConfigEntry("Category"))
         text += row.arg(tr("Category"))
                    .arg(QString{e}.toHtmlEscaped());
 
-    if (char const * const e = m_swordModule.getConfigEntry("LCSH"))
+    if (char const * const e = m_swordModule->getConfigEntry("LCSH"))
         text += row.arg(tr("LCSH"))
                    .arg(QString{e}.toHtmlEscaped());
 
@@ -943,25 +4195,11 @@ QString CSwordModuleInfo::aboutText() const {
         text += row
                 .arg(tr("Unlock key"))
                 .arg(config(CSwordModuleInfo::CipherKey).toHtmlEscaped());
-        if (char const * const e = m_swordModule.getConfigEntry("UnlockInfo"))
+        if (char const * const e = m_swordModule->getConfigEntry("UnlockInfo"))
             text += row.arg(tr("Unlock info")).arg(QString(e).toHtmlEscaped());
     }
 
     QString options;
-    static constexpr auto const allFilterOptions = {
-        &footnotes,
-        &strongNumbers,
-        &headings,
-        &morphTags,
-        &lemmas,
-        &hebrewPoints,
-        &hebrewCantillation,
-        &greekAccents,
-        &scriptureReferences,
-        &redLetterWords,
-        &textualVariants,
-        &morphSegmentation,
-    };
     for (auto const * const filterOption : allFilterOptions) {
         if (has(*filterOption)) {
             if (!options.isEmpty())
@@ -1013,7 +4251,7 @@ QString CSwordModuleInfo::aboutText() const {
 }
 
 bool CSwordModuleInfo::isUnicode() const noexcept
-{ return m_swordModule.isUnicode(); }
+{ return m_swordModule->isUnicode(); }
 
 QIcon CSwordModuleInfo::moduleIcon() const {
     if (isLocked())
@@ -1092,7 +4330,7 @@ QString CSwordModuleInfo::categoryName(const CSwordModuleInfo::Category & catego
 
 QString CSwordModuleInfo::getSimpleConfigEntry(const QString & name) const {
     auto const * const value =
-            m_swordModule.getConfigEntry(name.toUtf8().constData());
+            m_swordModule->getConfigEntry(name.toUtf8().constData());
     return isUnicode() ? QString::fromUtf8(value) : QString::fromLatin1(value);
 }
 
@@ -1105,10 +4343,10 @@ QString CSwordModuleInfo::getFormattedConfigEntry(const QString & name) const {
         sword::SWBuf RTF_Buffer;
         if (i < 0) {
             RTF_Buffer =
-                    m_swordModule.getConfigEntry(name.toUtf8().constData());
+                    m_swordModule->getConfigEntry(name.toUtf8().constData());
         } else {
             RTF_Buffer =
-                    m_swordModule.getConfigEntry(
+                    m_swordModule->getConfigEntry(
                         QStringLiteral("%1_%2")
                         .arg(name, localeNames[i])
                         .toUtf8().constData());
@@ -1138,6 +4376,7 @@ bool CSwordModuleInfo::setHidden(bool hide) {
         hiddenModules.removeOne(m_cachedName);
     }
     btConfig().setValue(configKey, hiddenModules);
+    CSwordBackend::updateModuleSettings();
     Q_EMIT hiddenChanged(hide);
     return true;
 }
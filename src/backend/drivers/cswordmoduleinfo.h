@@ -15,21 +15,32 @@
 #include <QObject>
 
 #include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <QByteArray>
+#include <QHash>
 #include <QIcon>
+#include <QList>
 #include <QMetaType>
 #include <QString>
+#include <QStringList>
 #include <QtGlobal>
+#include <vector>
+#include "../btverseattributestore.h"
 #include "../cswordmodulesearch.h"
 #include "../language.h"
+#include "../rendering/btrendertimestatistics.h"
 
 
-// CLucene no longer lists the following functions in its headers
-extern size_t lucene_utf8towcs(wchar_t *, const char *,  size_t maxslen);
-extern size_t lucene_wcstoutf8 (char *,  const wchar_t *, size_t maxslen);
-
+class BtCorpusStatistics;
+class BtLemmaIndex;
 class CSwordBackend;
 class CSwordKey;
+namespace lucene { namespace index { class IndexWriter; } }
 namespace sword {
 class ListKey;
 class SWModule;
@@ -49,8 +60,32 @@ class CSwordModuleInfo: public QObject {
 
     Q_OBJECT
 
+    friend class CSwordBackend; // Sets m_hidden and rebinds loaded modules
+    friend class BtEntryWriteJournal; // Commits the entries of write()
+
 public: // types:
 
+    /** Maps the key texts of indexed entries to hashes of their content. */
+    using EntryHashes = QHash<QByteArray, QByteArray>;
+
+    /**
+      \brief The progress of buildIndex() as emitted by indexingStatistics().
+      \note When indexing in parallel, the times of the phases are summed up
+            over all threads, hence they may exceed the elapsed time.
+    */
+    struct IndexingStatistics {
+        std::uint64_t entriesDone;
+        std::uint64_t entriesTotal;
+        std::uint64_t bytesProcessed; ///< The size of the raw entries indexed
+        std::chrono::milliseconds elapsed;
+        std::chrono::milliseconds renderTime; ///< Filtering entries into text
+        std::chrono::milliseconds tokenizeTime; ///< Analyzing the documents
+        std::chrono::milliseconds writeTime; ///< Merging and closing segments
+    };
+
+    /** The counters of buildIndex(), shared by its threads. */
+    struct IndexingCounters;
+
     struct FilterOption {
         static char const * valueToOnOff(int value) noexcept;
         static char const * valueToReadings(int value) noexcept;
@@ -58,6 +93,7 @@ public: // types:
         char const * optionName;
         std::string configOptionName;
         char const * translatableOptionName;
+        std::uint8_t bit; ///< The bit of the option in the mask used by has()
         char const * (*valueToString)(int value) noexcept = &valueToOnOff;
     };
 
@@ -165,6 +201,26 @@ public: // methods:
     */
     static QString getGlobalBaseIndexLocation();
 
+    /**
+      \returns the path to the combined index of several modules, see
+               buildCombinedIndex().
+    */
+    static QString getCombinedIndexLocation();
+
+    /**
+      Builds a combined search index of the given modules by merging their
+      indices, so that they can be searched in a single pass with shared term
+      dictionaries by searchCombinedIndex(). Modules without an index and
+      modules whose index is tokenized by character pairs instead of words are
+      left out. The combined index is only used for a module as long as the
+      index of the module is unchanged, see indexStamp().
+      \throws when unsuccessful
+    */
+    static void buildCombinedIndex(BtConstModuleList const & modules);
+
+    /** Removes the combined index, see buildCombinedIndex(). */
+    static void deleteCombinedIndex();
+
     /**
       Removes the search index for this module (rm -rf).
     */
@@ -176,15 +232,70 @@ public: // methods:
     */
     static void deleteIndexForModule(const QString & name);
 
+    /**
+      Closes the index searchers which are kept open for repeated searches.
+    */
+    static void releaseCachedIndexSearchers();
+
+    /**
+      \brief Asks the operating system to read the data files of this module
+             into its page cache in the background, so that the many small
+             reads of Sword are served from memory. This is meant for walking
+             through large parts of the module, e.g. when indexing it.
+    */
+    void prefetchDataFiles() const;
+
+    /**
+      Completes or reverts the replacements of index directories by buildIndex()
+      which were interrupted, e.g. by a crash. Any index whose configuration was
+      installed before all its files were saved is marked to be rebuilt, see
+      indexNeedsRebuild(). Must be called at startup before using the indices.
+    */
+    static void recoverIndexDirectories();
+
+    /**
+      Loads the results of hasIndex() of previous sessions from the cache
+      directory. They are reused as long as the index files are unchanged.
+    */
+    static void loadIndexStates();
+
+    /** Saves the results of hasIndex() for the next session. */
+    static void saveIndexStates();
+
     /**
     * Returns the config entry which is pecified by the parameter.
+    * The decoded values are cached, the localized ones per language of the
+    * booknames.
     */
     QString config(const CSwordModuleInfo::ConfigEntry entry) const;
 
     /**
     * Returns the module object so all objects can access the original Sword module.
+    * This marks the module as used, see releaseIdleModules().
+    */
+    sword::SWModule & swordModule() const {
+        m_lastUsedPeriod.store(
+                    m_currentUsePeriod.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+        return *m_swordModule;
+    }
+
+    /**
+      \brief Releases the data kept in memory for this module, i.e. its lemma
+             index, verse attribute store, corpus statistics, open index
+             searcher and cached raw entries, which are loaded again when
+             needed.
+    */
+    void releaseCaches() const;
+
+    /**
+      \brief Starts a new period of use and releases the caches of the given
+             modules which have just been unused for the given number of
+             periods.
+      \pre idlePeriods > 0
     */
-    sword::SWModule & swordModule() const { return m_swordModule; }
+    static void releaseIdleModules(QList<CSwordModuleInfo *> const & modules,
+                                   std::uint32_t idlePeriods);
 
     /**
     * Sets the unlock key of the modules and writes the key into the config file.
@@ -210,6 +321,7 @@ wrong, or if the config file was write protected return false.
     * This function returns true if this module is locked (encrypted + correct cipher key),
     * otherwise return false.
     * @return True if this module is locked, i.e. encrypted but without a key set
+    * The result is cached until the module is unlocked with unlock().
     */
     bool isLocked() const;
 
@@ -220,6 +332,7 @@ wrong, or if the config file was write protected return false.
       that is the case, we can safely assume that a) the module was properly
       unlocked and b) no buffer overflows will occur, which can happen when
       Sword filters process garbage text which was not properly decrypted.
+      The position of the key of the module is restored afterwards.
     */
     bool unlockKeyIsValid() const;
 
@@ -231,11 +344,77 @@ wrong, or if the config file was write protected return false.
 
     /**
       \returns true if the module's index has been built.
+      \note The result is kept until the index is built or deleted by this
+            module or refreshIndexState() is called, so this is cheap enough
+            for painting and sorting views.
     */
     bool hasIndex() const;
 
     /**
-      \returns the path to this module's index base dir
+      Drops the cached results of hasIndex() and indexSize(), e.g. after the
+      index files have been changed by other means than this module.
+    */
+    void refreshIndexState() const noexcept;
+
+    /**
+      \returns a string identifying the current index of this module, which
+               changes whenever the index is rebuilt or updated.
+    */
+    QString indexStamp() const;
+
+    /**
+      \returns whether this module has an index which was built for another
+               version of the module and can be updated by buildIndex()
+               without rebuilding it completely.
+    */
+    bool hasUpdatableIndex() const;
+
+    /**
+      \returns whether buildIndex() should update existing indices instead of
+               rebuilding them ("settings/behaviour/incrementalIndexUpdates").
+    */
+    static bool incrementalIndexUpdatesEnabled();
+
+    /**
+      \returns whether buildIndex() should also index all rotations of the
+               content words, so that queries with leading wildcards like
+               "*ness" are looked up without enumerating every word of the
+               index ("settings/behaviour/permutermIndex").
+    */
+    static bool permutermIndexEnabled();
+
+    /**
+      \returns whether buildIndex() should skip merging the index into a single
+               segment ("settings/behaviour/fastIndexBuild"), which makes the
+               index searchable sooner but slightly slower until it has been
+               optimized by optimizeIndex().
+    */
+    static bool fastIndexBuildsEnabled();
+
+    /**
+      \returns whether this module has an index built by a fast build which has
+               not been optimized yet, see fastIndexBuildsEnabled().
+    */
+    bool hasUnoptimizedIndex() const;
+
+    /**
+      \returns whether updating the index of this module failed, so that the
+               index is only kept for searching until it is rebuilt completely
+               by buildIndex(), see updateIndexEntries().
+    */
+    bool indexNeedsRebuild() const;
+
+    /**
+      Merges the segments of an index built by a fast build into a single one,
+      unless it has been optimized already.
+      \throws when unsuccessful
+    */
+    void optimizeIndex();
+
+    /**
+      \returns the path to this module's index base dir, which is the one in
+               util::directory::getSharedIndexDir() if it contains a valid
+               index of the module, or else getModuleUserIndexLocation().
     */
     QString getModuleBaseIndexLocation() const;
 
@@ -245,24 +424,126 @@ wrong, or if the config file was write protected return false.
     QString getModuleStandardIndexLocation() const;
 
     /**
-      Builds a search index for this module
+      \returns the path to this module's index base dir in the directory of
+               the user, to which buildIndex() writes.
+    */
+    QString getModuleUserIndexLocation() const;
+
+    /**
+      \returns the path to this module's standard index in the directory of
+               the user, see getModuleUserIndexLocation().
+    */
+    QString getModuleUserStandardIndexLocation() const;
+
+    /**
+      Builds a search index for this module. For large Bibles, commentaries and
+      lexicons, the entries may be indexed by several threads in parallel
+      ("settings/behaviour/indexShards"). If hasUpdatableIndex() and
+      incrementalIndexUpdatesEnabled(), only the entries whose content has
+      changed since the index was built are re-indexed.
+      \param[in] shards If given, the number of threads to index in parallel
+                        instead of the configured number.
       \throws when unsuccessful
     */
-    void buildIndex();
+    void buildIndex(std::optional<int> shards = std::nullopt);
+
+    /**
+      Updates the documents of the given entries in the search index of this
+      module, e.g. after they were changed by write(), instead of rebuilding
+      the whole index. If the index can not be updated, i.e. unless
+      hasUpdatableIndex(), it is rebuilt by buildIndex() instead. If updating
+      fails, the index is kept but marked to be rebuilt, see
+      indexNeedsRebuild().
+      \param[in] keys The keys of the entries as returned by indexKey().
+      \throws when unsuccessful
+    */
+    void updateIndexEntries(QStringList const & keys);
+
+    /**
+      \returns the text of the given key of this module as stored in the search
+               index, which is independent of the locale of the key.
+    */
+    QString indexKey(CSwordKey const & key) const;
 
     /**
-      \returns index size
+      \returns index size, as recorded in the index configuration or else as
+               computed by computeIndexSize().
+      \note Computing the size can be slow, e.g. on network file systems. The
+            result is cached like that of hasIndex().
     */
     ::qint64 indexSize() const;
 
+    /**
+      \returns the index size recorded in the index configuration when the
+               index was built or its size was computed, if any.
+    */
+    std::optional<::qint64> recordedIndexSize() const;
+
+    /**
+      \brief Computes the size of the index at the given base index location
+             by summing up the sizes of its files, and records it in the index
+             configuration.
+      \note This is thread-safe and can be used by background threads.
+    */
+    static ::qint64 computeIndexSize(QString const & baseIndexLocation);
+
+    /**
+      \returns the index of the Strong's numbers and morphological codes of
+               this module, which is built along with the search index of verse
+               keyed modules, or nullptr if there is none.
+    */
+    std::shared_ptr<BtLemmaIndex const> lemmaIndex() const;
+
+    /** \returns the times recently taken to render entries for display. */
+    BtRenderTimeStatistics & renderTimes() const noexcept
+    { return m_renderTimes; }
+
+    /**
+      \returns the frequencies of the terms in the search index of this module,
+               which are computed on first use and kept for the current index,
+               or nullptr if there is no index or computing was cancelled.
+    */
+    std::shared_ptr<BtCorpusStatistics const> corpusStatistics(
+            BtCancellationToken const & cancellation = {}) const;
+
+    /**
+      \returns the store of the entry attributes of the verses of this module,
+               which is built along with the search index of verse keyed
+               modules, or nullptr if there is none.
+    */
+    std::shared_ptr<BtVerseAttributeStore const> verseAttributeStore() const;
+
     /**
       This function uses CLucene to perform and index based search.
+      \param[in] pageSize If not zero and an unscoped search has more hits,
+                          only the first page of hits is fetched and the rest
+                          is left to be fetched on demand.
+      \param[in] cancellation Collecting the hits stops once this is
+                              cancelled, leaving the result incomplete.
+      \param[in] maxThreads The maximum number of threads by which ranges of a
+                            large index are searched concurrently.
       \returns the result
       \throws on error
     */
     CSwordModuleSearch::ModuleResultList
     searchIndexed(QString const & searchedText,
-                  sword::ListKey const & scope) const;
+                  sword::ListKey const & scope,
+                  std::size_t pageSize = 0u,
+                  BtCancellationToken const & cancellation = {},
+                  int maxThreads = 1) const;
+
+    /**
+      Searches the given modules in a single pass of the combined index, see
+      buildCombinedIndex().
+      \returns the results in the order of the given modules, or nothing if
+               the combined index does not contain the current indices of all
+               of the modules or the search can not be done in it.
+      \throws on error
+    */
+    static std::optional<std::vector<CSwordModuleSearch::ModuleResultList>>
+    searchCombinedIndex(QString const & searchedText,
+                        BtConstModuleList const & modules,
+                        sword::ListKey const & scope);
 
     /**
       \returns the type of the module.
@@ -294,7 +575,12 @@ wrong, or if the config file was write protected return false.
     bool has(CSwordModuleInfo::Feature const feature) const noexcept
     { return m_cachedFeatures.testFlag(feature); }
 
-    bool has(CSwordModuleInfo::FilterOption const &) const;
+    /**
+      \returns whether the module supports the filter option given as
+               parameter.
+    */
+    bool has(CSwordModuleInfo::FilterOption const & option) const noexcept
+    { return m_cachedFilterOptions & (1u << option.bit); }
 
     /** \returns the text direction of the module's text. */
     CSwordModuleInfo::TextDirection textDirection() const;
@@ -304,7 +590,8 @@ wrong, or if the config file was write protected return false.
 
     /**
       Writes the new text at the given position into the module. This does
-      only work for writabe modules.
+      only work for writabe modules. The text might only be committed to the
+      module later, see BtEntryWriteJournal.
     */
     void write(CSwordKey * key, const QString & newText);
 
@@ -341,7 +628,8 @@ wrong, or if the config file was write protected return false.
     CSwordModuleInfo::Category category() const { return m_cachedCategory; }
 
     /**
-    * The about text which belongs to this module.
+    * The about text which belongs to this module. It is cached per language of
+    * the GUI and of the booknames.
     */
     QString aboutText() const;
 
@@ -406,7 +694,74 @@ protected: // methods:
     QString getFormattedConfigEntry(const QString & name) const;
 
     bool hasImportantFilterOption() const;
-    void setImportantFilterOptions(bool enable);
+
+private: // types:
+
+    enum class IndexState : unsigned char { Unknown, Absent, Present };
+    enum class LockState : unsigned char { Unknown, Unlocked, Locked };
+
+    struct CachedConfigEntry {
+        QString language; ///< Empty unless the entry is localized
+        QString value;
+    };
+
+private: // methods:
+
+    /**
+      \brief Makes this module use the given Sword module, which Sword loaded
+             again with the same configuration, see
+             CSwordBackend::reloadModules().
+    */
+    void rebind(sword::SWModule & module) noexcept { m_swordModule = &module; }
+
+    /** Decodes the config entry for config(). */
+    QString decodeConfig(ConfigEntry entry) const;
+
+    /**
+      Writes the given entry encoded for the module to the given key of the
+      Sword module, without flushing the module.
+    */
+    void writeEntry(QByteArray const & key, QByteArray const & entry);
+
+    /**
+      Computes the statistics for corpusStatistics() from the index.
+      \returns the statistics or nullptr if cancelled.
+    */
+    std::shared_ptr<BtCorpusStatistics> computeCorpusStatistics(
+            BtCancellationToken const & cancellation) const;
+
+    /** Renders the text returned by aboutText(). */
+    QString renderAboutText() const;
+
+    /** Probes the index files at the given base location for hasIndex(). */
+    bool probeIndex(QString const & baseIndexLocation) const;
+
+    /**
+      Indexes the entries in parallel into separate shard indices, which are
+      then merged into the given writer.
+      \param[in] numShards the number of shards (and threads) to use.
+      \param[in] lowIndex the index (or lexicon entry number) to start at.
+      \param[in] span the number of entries to index in total.
+      \param[in] endIndex the index (or entry number) after the last entry.
+      \param[in] optimize whether to merge the shards into a single segment.
+      \throws when unsuccessful
+    */
+    void buildIndexShards(lucene::index::IndexWriter & writer,
+                          unsigned long numShards,
+                          unsigned long lowIndex,
+                          unsigned long span,
+                          unsigned long endIndex,
+                          bool importantFilterOption,
+                          bool optimize,
+                          EntryHashes & hashes,
+                          BtLemmaIndex * lemmaIndex,
+                          BtVerseAttributeStore::Builder * verseAttributes,
+                          IndexingCounters & counters);
+
+    /** Removes the document of the entry with the given key from the index. */
+    static void deleteIndexedEntry(lucene::index::IndexWriter & writer,
+                                   QByteArray const & keyText,
+                                   wchar_t * wcharBuffer);
 
 Q_SIGNALS:
 
@@ -415,18 +770,42 @@ Q_SIGNALS:
     void unlockedChanged(bool unlocked);
     void indexingFinished();
     void indexingProgress(int);
+    void indexingStatistics(
+            CSwordModuleInfo::IndexingStatistics const & statistics);
 
 private: // fields:
 
-    sword::SWModule & m_swordModule;
+    sword::SWModule * m_swordModule;
     CSwordBackend & m_backend;
     ModuleType const m_type;
     bool m_hidden;
     std::atomic<bool> m_cancelIndexing;
+    mutable std::atomic<IndexState> m_indexState{IndexState::Unknown};
+    mutable std::atomic<::qint64> m_indexSize{-1}; // -1 if unknown
+    mutable std::atomic<LockState> m_lockState{LockState::Unknown};
+    mutable std::mutex m_lemmaIndexMutex;
+    mutable std::shared_ptr<BtLemmaIndex const> m_lemmaIndex;
+    mutable QString m_lemmaIndexStamp;
+    /** Incremented whenever the index changed, see verseAttributeStore(). */
+    mutable std::atomic<std::uint64_t> m_indexGeneration{0u};
+    mutable std::mutex m_verseAttributeStoreMutex;
+    mutable std::shared_ptr<BtVerseAttributeStore const> m_verseAttributeStore;
+    mutable std::optional<std::uint64_t> m_verseAttributeStoreGeneration;
+    mutable BtRenderTimeStatistics m_renderTimes;
+    mutable std::mutex m_corpusStatisticsMutex;
+    mutable std::shared_ptr<BtCorpusStatistics const> m_corpusStatistics;
+    mutable QString m_corpusStatisticsStamp;
+    mutable std::mutex m_configCacheMutex;
+    mutable std::optional<CachedConfigEntry> m_configCache[Markup + 1];
+    mutable std::optional<CachedConfigEntry> m_aboutTextCache;
+    /** The period of use in which swordModule() was last called. */
+    mutable std::atomic<std::uint32_t> m_lastUsedPeriod{0u};
+    static inline std::atomic<std::uint32_t> m_currentUsePeriod{0u};
 
     // Cached data:
     QString const m_cachedName;
     Features const m_cachedFeatures;
+    std::uint32_t const m_cachedFilterOptions; ///< The bits of has() options
     CSwordModuleInfo::Category const m_cachedCategory;
     std::shared_ptr<Language const> const m_cachedLanguage;
     std::shared_ptr<Language const> const m_cachedGlossaryTargetLanguage;
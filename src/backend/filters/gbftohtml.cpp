@@ -24,6 +24,7 @@
 #include "../../util/btassert.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../managers/cswordbackend.h"
+#include "tagdispatch.h"
 
 // Sword includes:
 #include <gbfhtml.h>
@@ -107,10 +108,15 @@ char Filters::GbfToHtml::processText(sword::SWBuf& buf, const sword::SWKey * key
     //A simple word<WT> means: No entry for this word "word"
 
 
+    // Avoid converting the text if there are no tags to process:
+    if (!std::strstr(buf.c_str(), "<W"))
+        return 1; //WARNING: Return already here
+
     //split the text into parts which end with the GBF tag marker for strongs/lemmas
     QStringList list;
     {
-        auto t = QString::fromUtf8(buf.c_str());
+        auto t = QString::fromUtf8(buf.c_str(),
+                                   static_cast<qsizetype>(buf.length()));
         {
             static QRegularExpression const tag(
                 QStringLiteral(R"PCRE(([.,;:]?<W[HGT][^>]*?>\s*)+)PCRE"));
@@ -305,15 +311,17 @@ bool Filters::GbfToHtml::handleToken(sword::SWBuf &buf, const char *token, sword
         /* We use several append calls because appendFormatted slows down
            filtering, which should be fast. */
 
-        if (!std::strncmp(token, "WG", 2u)
-            || !std::strncmp(token, "WH", 2u)
-            || !std::strncmp(token, "WT", 2u))
-        {
+        switch (gbfTokenCode(token)) {
+        case gbfTokenCode('W', 'G'):
+        case gbfTokenCode('W', 'H'):
+        case gbfTokenCode('W', 'T'):
             buf.append('<').append(token).append('>');
-        } else if (!std::strncmp(token, "RB", 2u)) {
+            break;
+        case gbfTokenCode('R', 'B'):
             myUserData->hasFootnotePreTag = true;
             buf.append("<span class=\"footnotepre\">");
-        } else if (!std::strncmp(token, "RF", 2u)) {
+            break;
+        case gbfTokenCode('R', 'F'):
             if (myUserData->hasFootnotePreTag) {
                 //     qWarning("inserted footnotepre end");
                 buf.append("</span>");
@@ -329,19 +337,23 @@ bool Filters::GbfToHtml::handleToken(sword::SWBuf &buf, const char *token, sword
                .append("\">*</span> ");
             myUserData->swordFootnote++;
             userData->suspendTextPassThru = true;
-        } else if (!std::strncmp(token, "Rf", 2u)) { // End of footnote
+            break;
+        case gbfTokenCode('R', 'f'): // End of footnote
             userData->suspendTextPassThru = false;
-        } else if (!std::strncmp(token, "FN", 2u)) {
+            break;
+        case gbfTokenCode('F', 'N'):
             // The end </font> tag is inserted in addTokenSubsitute
             buf.append("<font face=\"");
             for (size_t i = 2u; i < tokenLength; i++)
                 if (token[i] != '\"')
                     buf.append(token[i]);
             buf.append("\">");
-        } else if (!std::strncmp(token, "CA", 2u)) { // ASCII value <CA##> in hex
+            break;
+        case gbfTokenCode('C', 'A'): // ASCII value <CA##> in hex
             BT_ASSERT(tokenLength == 4u);
             buf.append(static_cast<char>(hexToChar(token + 2u)));
-        } else {
+            break;
+        default:
             return GBFHTML::handleToken(buf, token, userData);
         }
     }
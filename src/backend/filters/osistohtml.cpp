@@ -18,6 +18,7 @@
 #include "../drivers/cswordmoduleinfo.h"
 #include "../managers/cswordbackend.h"
 #include "../managers/referencemanager.h"
+#include "tagdispatch.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -31,11 +32,55 @@
 
 namespace {
 
+enum class OsisTag {
+    Unknown,
+    Abbr,
+    Div,
+    DivineName,
+    Hi,
+    Milestone,
+    Name,
+    Note,
+    P,
+    Q,
+    Reference,
+    Seg,
+    Title,
+    TransChange,
+    W
+};
+
+OsisTag osisTag(std::string_view const name) noexcept {
+    using namespace std::literals;
+    using Filters::tagHash;
+    auto const tag =
+            [name](std::string_view const tagName, OsisTag const t) noexcept
+            { return (name == tagName) ? t : OsisTag::Unknown; };
+    switch (tagHash(name)) {
+    case tagHash("abbr"): return tag("abbr"sv, OsisTag::Abbr);
+    case tagHash("div"): return tag("div"sv, OsisTag::Div);
+    case tagHash("divineName"): return tag("divineName"sv, OsisTag::DivineName);
+    case tagHash("hi"): return tag("hi"sv, OsisTag::Hi);
+    case tagHash("milestone"): return tag("milestone"sv, OsisTag::Milestone);
+    case tagHash("name"): return tag("name"sv, OsisTag::Name);
+    case tagHash("note"): return tag("note"sv, OsisTag::Note);
+    case tagHash("p"): return tag("p"sv, OsisTag::P);
+    case tagHash("q"): return tag("q"sv, OsisTag::Q);
+    case tagHash("reference"): return tag("reference"sv, OsisTag::Reference);
+    case tagHash("seg"): return tag("seg"sv, OsisTag::Seg);
+    case tagHash("title"): return tag("title"sv, OsisTag::Title);
+    case tagHash("transChange"):
+        return tag("transChange"sv, OsisTag::TransChange);
+    case tagHash("w"): return tag("w"sv, OsisTag::W);
+    default: return OsisTag::Unknown;
+    }
+}
+
 template <typename UserData>
 void renderReference(char const * const osisRef,
                      sword::SWBuf & buf,
                      sword::SWModule const & myModule,
-                     UserData const & myUserData)
+                     UserData & myUserData)
 {
     QString const ref(osisRef);
     //BT_ASSERT(!ref.isEmpty()); checked later
@@ -46,18 +91,24 @@ void renderReference(char const * const osisRef,
            If the osisRef is something like "ModuleID:key comes here" then the
            modulename is given, so we'll use that one. */
 
-        auto const * mod =
-                CSwordBackend::instance().findSwordModuleByPointer(&myModule);
-        //BT_ASSERT(mod); checked later
-        if (!mod || (mod->type() != CSwordModuleInfo::Bible
-                     && mod->type() != CSwordModuleInfo::Commentary))
-        {
-            mod = btConfig().getDefaultSwordModuleByType(
-                      QStringLiteral("standardBible"));
-            if (!mod)
-                mod = CSwordBackend::instance().findFirstAvailableModule(
-                          CSwordModuleInfo::Bible);
+        // The default module is the same for all references of the entry:
+        if (!myUserData.referenceModule.has_value()) {
+            auto const * mod =
+                    CSwordBackend::instance().findSwordModuleByPointer(
+                        &myModule);
+            //BT_ASSERT(mod); checked later
+            if (!mod || (mod->type() != CSwordModuleInfo::Bible
+                         && mod->type() != CSwordModuleInfo::Commentary))
+            {
+                mod = btConfig().getDefaultSwordModuleByType(
+                          QStringLiteral("standardBible"));
+                if (!mod)
+                    mod = CSwordBackend::instance().findFirstAvailableModule(
+                              CSwordModuleInfo::Bible);
+            }
+            myUserData.referenceModule.emplace(mod);
         }
+        auto const * mod = *myUserData.referenceModule;
 
         // BT_ASSERT(mod); There's no necessarily a module or standard Bible
 
@@ -138,19 +189,20 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
     // manually process if it wasn't a simple substitution
 
     if (!substituteToken(buf, token)) {
+        /* Dispatch on the name of the tag before parsing the token, which the
+           base class would parse again for tags not handled here: */
+        auto const tagKind = osisTag(xmlTagName(token));
+        if (tagKind == OsisTag::Unknown) //all tokens handled by OSISHTMLHref will run through the filter now
+            return sword::OSISHTMLHREF::handleToken(buf, token, userData);
+
         UserData* myUserData = static_cast<UserData*>(userData);
         sword::SWModule* myModule = const_cast<sword::SWModule*>(myUserData->module); //hack
 
         sword::XMLTag const tag(token);
         //     qWarning("found %s", token);
-        auto const osisQToTickEntry =
-                userData->module->getConfigEntry("OSISqToTick");
-        bool const osisQToTick =
-                !osisQToTickEntry || osisQToTickEntry != "false"sv;
 
-        std::string_view const tagName(tag.getName());
-
-        if (tagName == "div"sv) {
+        switch (tagKind) {
+        case OsisTag::Div: {
             if (tag.isEndTag()) {
                 buf.append("</div>");
             } else {
@@ -172,8 +224,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
                     buf.append("<div>");
                 }
             }
+            break;
         }
-        else if (tagName == "w"sv) {
+        case OsisTag::W: {
             if ((!tag.isEmpty()) && (!tag.isEndTag())) { //start tag
                 const char *attrib;
                 const char *val;
@@ -304,8 +357,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else if (tag.isEndTag()) { // end or empty <w> tag
                 buf.append("</span>");
             }
+            break;
         }
-        else if (tagName == "note"sv) {
+        case OsisTag::Note: {
             if (!tag.isEndTag()) { //start tag
                 const sword::SWBuf type( tag.getAttribute("type") );
 
@@ -370,8 +424,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
                 myUserData->noteTypes.pop_back();
                 myUserData->suspendTextPassThru = false;
             }
+            break;
         }
-        else if (tagName == "reference"sv) {
+        case OsisTag::Reference: {
             if (!tag.isEndTag() && !tag.isEmpty()) {
                 renderReference(tag.getAttribute("osisRef"),
                                 buf,
@@ -384,8 +439,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else { // empty reference marker
                 // -- what should we do?  nothing for now.
             }
+            break;
         }
-        else if (tagName == "title"sv) {
+        case OsisTag::Title: {
             if (!tag.isEndTag() && !tag.isEmpty()) {
                 buf.append("<div class=\"sectiontitle\">");
             }
@@ -396,8 +452,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
                 // what to do?  is this even valid?
                 buf.append("<br/>");
             }
+            break;
         }
-        else if (tagName == "hi"sv) { // <hi> highlighted text
+        case OsisTag::Hi: { // <hi> highlighted text
             const sword::SWBuf type = tag.getAttribute("type");
 
             if ((!tag.isEndTag()) && (!tag.isEmpty())) {
@@ -429,8 +486,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else if (tag.isEndTag()) { //all hi replacements are html spans
                 buf.append("</span>");
             }
+            break;
         }
-        else if (tagName == "name"sv) {
+        case OsisTag::Name: {
             const sword::SWBuf type = tag.getAttribute("type");
 
             if ((!tag.isEndTag()) && (!tag.isEmpty())) {
@@ -456,8 +514,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else if (tag.isEndTag()) { //all hi replacements are html spans
                 buf.append("</span></span> ");
             }
+            break;
         }
-        else if (tagName == "transChange"sv) {
+        case OsisTag::TransChange: {
             sword::SWBuf type( tag.getAttribute("type") );
 
             if ( !type.length() ) {
@@ -494,15 +553,21 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else if (tag.isEndTag()) { //all hi replacements are html spans
                 buf.append("</span></span>");
             }
+            break;
         }
-        else if (tagName == "p"sv) {
+        case OsisTag::P: {
             if (tag.isEndTag())
                 buf.append("</p>");
             else
                 buf.append("<p>");
 
+            break;
         }
-        else if (tagName == "q"sv) { // <q> quote
+        case OsisTag::Q: { // <q> quote
+            auto const osisQToTickEntry =
+                    userData->module->getConfigEntry("OSISqToTick");
+            bool const osisQToTick =
+                    !osisQToTickEntry || osisQToTickEntry != "false"sv;
             //sword::SWBuf type = tag.getAttribute("type");
             sword::SWBuf who = tag.getAttribute("who");
             const char *lev = tag.getAttribute("level");
@@ -537,8 +602,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
 
                 myUserData->quote.who = "";
             }
+            break;
         }
-        else if (tagName == "abbr"sv) {
+        case OsisTag::Abbr: {
             if (!tag.isEndTag() && !tag.isEmpty()) {
                 const sword::SWBuf expansion = tag.getAttribute("expansion");
 
@@ -549,8 +615,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
             else if (tag.isEndTag()) {
                 buf.append("</span>");
             }
+            break;
         }
-        else if (tagName == "milestone"sv) {
+        case OsisTag::Milestone: {
             const sword::SWBuf type = tag.getAttribute("type");
 
             if ((type == "screen") || (type == "line")) {//line break
@@ -564,8 +631,9 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
                     buf.append(marker);
                 }
             }
+            break;
         }
-        else if (tagName == "seg"sv) {
+        case OsisTag::Seg: {
             if (!tag.isEndTag() && !tag.isEmpty()) {
 
                 const sword::SWBuf type = tag.getAttribute("type");
@@ -592,18 +660,20 @@ bool Filters::OsisToHtml::handleToken(sword::SWBuf &buf, const char *token, swor
                 buf.append("</span>");
             }
             //qWarning(QString("handled <seg> token. result: %1").arg(buf.c_str()).latin1());
+            break;
         }
         //divine name, don't use simple tag replacing because it may have attributes
-        else if (tagName == "divineName"sv) {
+        case OsisTag::DivineName: {
             if (!tag.isEndTag()) {
                 buf.append("<span class=\"name\"><span class=\"divine\">");
             }
             else { //all hi replacements are html spans
                 buf.append("</span></span>");
             }
+            break;
         }
-        else { //all tokens handled by OSISHTMLHref will run through the filter now
-            return sword::OSISHTMLHREF::handleToken(buf, token, userData);
+        case OsisTag::Unknown:
+            break;
         }
     }
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 
 // Sword includes:
@@ -32,6 +33,8 @@
 #pragma GCC diagnostic pop
 
 
+class CSwordModuleInfo;
+
 namespace Filters {
 
 /**
@@ -64,6 +67,10 @@ class OsisToHtml: public sword::OSISHTMLHREF {
                 struct {
                     sword::SWBuf who;
                 } quote;
+
+                /** The module references without a module prefix link into,
+                    looked up at the first such reference. */
+                std::optional<CSwordModuleInfo const *> referenceModule;
         };
 
     public: // methods:
@@ -0,0 +1,117 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+
+/**
+  \file tagdispatch.h
+  \brief Helpers for dispatching the tokens of the render filters.
+
+  Instead of comparing the name of a token against every known tag in turn,
+  the filters switch on tagHash() of the name and only compare the name to the
+  tag of the matching case, e.g.
+
+  \code
+  switch (tagHash(name)) {
+  case tagHash("div"): return (name == "div"sv) ? Tag::Div : Tag::Unknown;
+  ...
+  }
+  \endcode
+
+  Since the hashes of the case labels are computed at compile time, colliding
+  tag names result in duplicate case labels, i.e. compilation errors.
+*/
+
+namespace Filters {
+
+constexpr char asciiToLower(char const c) noexcept
+{ return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+/** \returns the FNV-1a hash of the given tag name. */
+constexpr std::uint32_t tagHash(std::string_view const name) noexcept {
+    std::uint32_t h = 2166136261u;
+    for (auto const c : name)
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    return h;
+}
+
+/** \returns the FNV-1a hash of the given tag name converted to lower case. */
+constexpr std::uint32_t tagHashCaseInsensitive(std::string_view const name)
+        noexcept
+{
+    std::uint32_t h = 2166136261u;
+    for (auto const c : name)
+        h = (h ^ static_cast<unsigned char>(asciiToLower(c))) * 16777619u;
+    return h;
+}
+
+/** \returns whether the given names are equal ignoring the ASCII case. */
+constexpr bool equalsCaseInsensitive(std::string_view const a,
+                                     std::string_view const b) noexcept
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0u; i < a.size(); ++i)
+        if (asciiToLower(a[i]) != asciiToLower(b[i]))
+            return false;
+    return true;
+}
+
+/**
+  \brief Determines the name of the given XML token like sword::XMLTag, but
+         without copying the token or parsing any attributes.
+  \param[in] token The XML token without the angle brackets.
+  \param[out] isEndTag Set to whether the token is an end tag.
+  \returns the name of the tag, which is empty if there is none.
+*/
+inline std::string_view xmlTagName(char const * const token,
+                                   bool & isEndTag) noexcept
+{
+    isEndTag = false;
+    auto const isAlpha =
+            [](char const c) noexcept
+            { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    std::size_t start = 0u;
+    for (; token[start] && !isAlpha(token[start]); ++start)
+        if (token[start] == '/')
+            isEndTag = true;
+    auto end = start;
+    while (token[end] && !std::strchr("\t\r\n />", token[end]))
+        ++end;
+    return std::string_view(token + start, end - start);
+}
+
+inline std::string_view xmlTagName(char const * const token) noexcept {
+    bool isEndTag;
+    return xmlTagName(token, isEndTag);
+}
+
+/** \returns the first two characters of a GBF token for switch statements. */
+constexpr std::uint16_t gbfTokenCode(char const * const token) noexcept {
+    if (!token[0u] || !token[1u])
+        return 0u;
+    return static_cast<std::uint16_t>(
+                (static_cast<unsigned char>(token[0u]) << 8u)
+                | static_cast<unsigned char>(token[1u]));
+}
+
+constexpr std::uint16_t gbfTokenCode(char const a, char const b) noexcept {
+    return static_cast<std::uint16_t>((static_cast<unsigned char>(a) << 8u)
+                                      | static_cast<unsigned char>(b));
+}
+
+} // namespace Filters
@@ -12,15 +12,18 @@
 
 #include "thmltohtml.h"
 
+#include <cstring>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 #include <QUrl>
+#include <string_view>
 #include <utility>
 #include "../../util/btassert.h"
 #include "../config/btconfig.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../managers/cswordbackend.h"
 #include "../managers/referencemanager.h"
+#include "tagdispatch.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -41,6 +44,37 @@
 #pragma GCC diagnostic pop
 
 
+namespace {
+
+enum class ThmlTag { Unknown, Div, Foreign, Img, Note, ScripRef, Sync };
+
+/** ThML tag names are matched case-insensitively like sword::stricmp(). */
+ThmlTag thmlTag(std::string_view const name) noexcept {
+    using namespace std::literals;
+    using Filters::equalsCaseInsensitive;
+    using Filters::tagHashCaseInsensitive;
+    auto const tag =
+            [name](std::string_view const tagName, ThmlTag const t) noexcept
+            {
+                return equalsCaseInsensitive(name, tagName)
+                       ? t
+                       : ThmlTag::Unknown;
+            };
+    switch (tagHashCaseInsensitive(name)) {
+    case tagHashCaseInsensitive("div"): return tag("div"sv, ThmlTag::Div);
+    case tagHashCaseInsensitive("foreign"):
+        return tag("foreign"sv, ThmlTag::Foreign);
+    case tagHashCaseInsensitive("img"): return tag("img"sv, ThmlTag::Img);
+    case tagHashCaseInsensitive("note"): return tag("note"sv, ThmlTag::Note);
+    case tagHashCaseInsensitive("scripRef"):
+        return tag("scripRef"sv, ThmlTag::ScripRef);
+    case tagHashCaseInsensitive("sync"): return tag("sync"sv, ThmlTag::Sync);
+    default: return ThmlTag::Unknown;
+    }
+}
+
+} // anonymous namespace
+
 namespace Filters {
 
 ThmlToHtml::ThmlToHtml() {
@@ -71,9 +105,14 @@ char ThmlToHtml::processText(sword::SWBuf &buf, const sword::SWKey *key,
             return 1;
     }
 
+    // Avoid converting the text if there are no tags to process:
+    if (!std::strstr(buf.c_str(), "<sync"))
+        return 1; //WARNING: Return already here
+
     QStringList list;
     {
-        auto t = QString::fromUtf8(buf.c_str());
+        auto t = QString::fromUtf8(buf.c_str(),
+                                   static_cast<qsizetype>(buf.length()));
         {
             static QRegularExpression const tag(
                 QStringLiteral(R"PCRE(([.,;]?<sync[^>]+(type|value)=)PCRE"
@@ -238,30 +277,46 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                              sword::BasicFilterUserData *userData)
 {
     if (!substituteToken(buf, token) && !substituteEscapeString(buf, token)) {
+        /* Dispatch on the name of the tag before parsing the token, which the
+           base class would parse again for tags not handled here: */
+        auto const tagKind = thmlTag(xmlTagName(token));
+        if (tagKind == ThmlTag::Unknown) // unknown tag, pass through:
+            return sword::ThMLHTML::handleToken(buf, token, userData);
+
         sword::XMLTag const tag(token);
         BT_ASSERT(dynamic_cast<UserData *>(userData));
         UserData * const myUserData = static_cast<UserData *>(userData);
         // Hack to be able to call stuff like Lang():
         sword::SWModule const * const myModule =
                 const_cast<sword::SWModule *>(myUserData->module);
-        char const * const tagName = tag.getName();
-        if (!tagName) // unknown tag, pass through:
-            return sword::ThMLHTML::handleToken(buf, token, userData);
-        if (!sword::stricmp(tagName, "foreign")) {
+        auto const standardBible =
+                [myUserData] {
+                    if (!myUserData->standardBible.has_value())
+                        myUserData->standardBible.emplace(
+                                btConfig().getDefaultSwordModuleByType(
+                                    QStringLiteral("standardBible")));
+                    return *myUserData->standardBible;
+                };
+        switch (tagKind) {
+        case ThmlTag::Foreign: {
             // A text part in another language, we have to set the right font
 
             if (const char * const tagLang = tag.getAttribute("lang"))
                 buf.append("<span class=\"foreign\" lang=\"")
                    .append(tagLang)
                    .append("\">");
-        } else if (!sword::stricmp(tagName, "sync")) {
+            break;
+        }
+        case ThmlTag::Sync: {
             // If Morph or Strong or Lemma:
             if (const char * const tagType = tag.getAttribute("type"))
                 if (!sword::stricmp(tagType, "morph")
                     || !sword::stricmp(tagType, "Strongs")
                     || !sword::stricmp(tagType, "lemma"))
                     buf.append('<').append(token).append('>');
-        } else if (!sword::stricmp(tagName, "note")) { // <note> tag
+            break;
+        }
+        case ThmlTag::Note: { // <note> tag
             if (!tag.isEmpty()) {
                 if (!tag.isEndTag()) {
                     buf.append(" <span class=\"footnote\" note=\"")
@@ -281,7 +336,9 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                     myUserData->inFootnoteTag = false;
                 }
             }
-        } else if (!sword::stricmp(tagName, "scripRef")) { // a scripRef
+            break;
+        }
+        case ThmlTag::ScripRef: { // a scripRef
             // scrip refs which are embeded in footnotes may not be displayed!
 
             if (!myUserData->inFootnoteTag) {
@@ -293,8 +350,7 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                         myUserData->suspendTextPassThru = false;
                     } else { // like "<scripRef>John 3:16</scripRef>"
                         if (CSwordModuleInfo const * const mod =
-                                btConfig().getDefaultSwordModuleByType(
-                                        "standardBible"))
+                                standardBible())
                         {
                             ReferenceManager::ParseOptions options{
                                     mod->name(),
@@ -346,8 +402,7 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                     myUserData->inscriptRef = true;
                     myUserData->suspendTextPassThru = false;
 
-                    auto * mod = btConfig().getDefaultSwordModuleByType(
-                                     QStringLiteral("standardBible"));
+                    auto * mod = standardBible();
                     if (! mod)
                         mod = CSwordBackend::instance().findFirstAvailableModule(CSwordModuleInfo::Bible);
 
@@ -383,7 +438,9 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                     myUserData->suspendTextPassThru = true;
                 }
             }
-        } else if (!sword::stricmp(tagName, "div")) {
+            break;
+        }
+        case ThmlTag::Div: {
             if (tag.isEndTag()) {
                 buf.append("</div>");
             } else if (char const * const tagClass = tag.getAttribute("class")){
@@ -393,8 +450,12 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                     buf.append("<div class=\"booktitle\">");
                 }
             }
-        } else if (!sword::stricmp(tagName, "img") && tag.getAttribute("src")) {
+            break;
+        }
+        case ThmlTag::Img: {
             const char * value = tag.getAttribute("src");
+            if (!value) // Let unknown token pass thru:
+                return sword::ThMLHTML::handleToken(buf, token, userData);
 
             if (value[0] == '/')
                 value++; //strip the first /
@@ -416,8 +477,10 @@ bool ThmlToHtml::handleToken(sword::SWBuf &buf, const char *token,
                             QString::fromUtf8(value))
                     ).toString().toUtf8().constData())
                .append("\" />");
-        } else { // Let unknown token pass thru:
-            return sword::ThMLHTML::handleToken(buf, token, userData);
+            break;
+        }
+        case ThmlTag::Unknown:
+            break;
         }
     }
     return true;
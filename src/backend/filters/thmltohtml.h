@@ -32,6 +32,8 @@
 #pragma GCC diagnostic pop
 
 
+class CSwordModuleInfo;
+
 namespace Filters {
 
 /**
@@ -48,6 +50,8 @@ class ThmlToHtml: public sword::ThMLHTML {
                       swordFootnote(1) {}
 
                 std::optional<QString> absolutePath;
+                /** The default Bible, looked up at the first reference. */
+                std::optional<CSwordModuleInfo const *> standardBible;
                 bool inscriptRef;
                 bool inFootnoteTag;
                 unsigned short int swordFootnote;
@@ -0,0 +1,119 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btbooknametable.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <versekey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+namespace {
+
+QString const nullString;
+
+} // anonymous namespace
+
+std::shared_ptr<BtBookNameTable const>
+BtBookNameTable::forLocale(QByteArray const & localeName,
+                           QByteArray const & versification)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<QByteArray, QByteArray>,
+                    std::shared_ptr<BtBookNameTable const>> tables;
+
+    std::lock_guard<std::mutex> const guard(mutex);
+    auto & table = tables[std::pair(localeName, versification)];
+    if (!table)
+        table.reset(new BtBookNameTable(localeName, versification));
+    return table;
+}
+
+BtBookNameTable::BtBookNameTable(QByteArray const & localeName,
+                                 QByteArray const & versification)
+    : m_localeName(localeName)
+    , m_versification(versification)
+{
+    sword::VerseKey key;
+    key.setLocale(localeName.constData());
+    key.setVersificationSystem(versification.constData());
+    for (int testament = 1; testament <= 2; ++testament) {
+        auto & books = m_books[testament - 1];
+        auto const numBooks = key.BMAX[testament - 1];
+        books.reserve(static_cast<std::size_t>(numBooks));
+        key.setTestament(static_cast<char>(testament));
+        for (int book = 1; book <= numBooks; ++book) {
+            key.setBook(static_cast<char>(book));
+            books.emplace_back(
+                        Book{QString::fromUtf8(key.getBookName()),
+                             QString::fromUtf8(key.getBookAbbrev())});
+        }
+    }
+}
+
+BtBookNameTable::Book const *
+BtBookNameTable::book(int const testament, int const book) const noexcept {
+    if (testament < 1 || testament > 2 || book < 1)
+        return nullptr;
+    auto const & books = m_books[testament - 1];
+    return static_cast<std::size_t>(book) <= books.size()
+           ? &books[static_cast<std::size_t>(book - 1)]
+           : nullptr;
+}
+
+QString const & BtBookNameTable::bookName(int const testament,
+                                          int const book) const noexcept
+{
+    auto const * const b = this->book(testament, book);
+    return b ? b->name : nullString;
+}
+
+QString const &
+BtBookNameTable::bookAbbreviation(int const testament, int const book) const
+        noexcept
+{
+    auto const * const b = this->book(testament, book);
+    return b ? b->abbreviation : nullString;
+}
+
+QString BtBookNameTable::keyText(int const testament,
+                                 int const book,
+                                 int const chapter,
+                                 int const verse) const
+{
+    // The headings of the module and its testaments are not translated:
+    if (book < 1)
+        return (testament < 1)
+               ? QStringLiteral("[ Module Heading ]")
+               : QStringLiteral("[ Testament %1 Heading ]").arg(testament);
+    auto const * const b = this->book(testament, book);
+    if (!b)
+        return {};
+    return QStringLiteral("%1 %2:%3").arg(b->name,
+                                          QString::number(chapter),
+                                          QString::number(verse));
+}
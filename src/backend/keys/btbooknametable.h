@@ -0,0 +1,86 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <memory>
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+
+/**
+  \brief The localized names and abbreviations of the books of a versification
+         system, so that key texts are formatted without the locale lookups of
+         sword::VerseKey.
+
+  A table is built on the first use of a locale and a versification system and
+  shared between all users of them, so that switching the language of the book
+  names back and forth does not rebuild the tables.
+*/
+class BtBookNameTable {
+
+public: // methods:
+
+    /**
+      \returns the table of the given locale and versification system.
+      \note This is thread-safe.
+    */
+    static std::shared_ptr<BtBookNameTable const> forLocale(
+            QByteArray const & localeName,
+            QByteArray const & versification);
+
+    /**
+      \returns the name of the given book of the given testament, or a null
+               string if there is no such book.
+    */
+    QString const & bookName(int testament, int book) const noexcept;
+
+    /**
+      \returns the preferred abbreviation of the given book of the given
+               testament, or a null string if there is no such book.
+    */
+    QString const & bookAbbreviation(int testament, int book) const noexcept;
+
+    /**
+      \returns the text of the given position as returned by
+               sword::VerseKey::getText() for keys without a suffix, or a null
+               string if there is no such book.
+    */
+    QString keyText(int testament, int book, int chapter, int verse) const;
+
+    QByteArray const & localeName() const noexcept { return m_localeName; }
+
+    QByteArray const & versification() const noexcept
+    { return m_versification; }
+
+private: // types:
+
+    struct Book {
+        QString name;
+        QString abbreviation;
+    };
+
+private: // methods:
+
+    BtBookNameTable(QByteArray const & localeName,
+                    QByteArray const & versification);
+
+    Book const * book(int testament, int book) const noexcept;
+
+private: // fields:
+
+    QByteArray const m_localeName;
+    QByteArray const m_versification;
+    std::vector<Book> m_books[2]; ///< By testament
+
+}; /* class BtBookNameTable */
@@ -0,0 +1,77 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btversificationmapping.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <versekey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+std::shared_ptr<BtVersificationMapping const>
+BtVersificationMapping::forVersifications(QString const & from,
+                                          QString const & to)
+{
+    static std::mutex mutex;
+    static std::map<std::pair<QString, QString>,
+                    std::shared_ptr<BtVersificationMapping const>> mappings;
+
+    std::lock_guard<std::mutex> const guard(mutex);
+    auto & mapping = mappings[std::make_pair(from, to)];
+    if (!mapping)
+        mapping.reset(new BtVersificationMapping(from, to));
+    return mapping;
+}
+
+BtVersificationMapping::BtVersificationMapping(QString const & from,
+                                               QString const & to)
+{
+    sword::VerseKey source;
+    source.setVersificationSystem(from.toUtf8().constData());
+    source.setIntros(true);
+    source.setPosition(sword::BOTTOM);
+    auto const size = source.getIndex() + 1;
+
+    sword::VerseKey target;
+    target.setVersificationSystem(to.toUtf8().constData());
+    target.setIntros(true);
+
+    m_indices.reserve(static_cast<std::size_t>(size));
+    for (long index = 0; index < size; ++index) {
+        source.setIndex(index);
+        target.positionFrom(source);
+        bool const inVersification = !target.popError();
+        if (target.isBoundSet()) {
+            m_indices.push_back(-1);
+            target.clearBounds();
+        } else {
+            m_indices.push_back(inVersification
+                                ? static_cast<std::int32_t>(target.getIndex())
+                                : -1);
+        }
+    }
+}
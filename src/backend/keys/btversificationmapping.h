@@ -0,0 +1,63 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <QString>
+#include <vector>
+
+
+/**
+  \brief Maps the verse indices (including intros) of one versification system
+         to those of another one without going through the av11n mapping of
+         sword for every verse.
+
+  The mapping is built on first use by mapping every verse of the source
+  versification like sword::VerseKey::positionFrom() does. Mappings are
+  shared between all users of the same pair of versification systems.
+*/
+class BtVersificationMapping {
+
+public: // methods:
+
+    /**
+      \returns the mapping between the given versification systems, which is
+               built on the first call for the pair.
+      \note This is thread-safe.
+    */
+    static std::shared_ptr<BtVersificationMapping const> forVersifications(
+            QString const & from,
+            QString const & to);
+
+    /**
+      \returns the index in the target versification system which the given
+               index of the source versification system maps to, or -1 if
+               the verse maps to a range of verses, is not part of the target
+               versification system or the index is out of range.
+    */
+    long mappedIndex(long index) const noexcept {
+        auto const i = static_cast<std::size_t>(index);
+        return (index >= 0 && i < m_indices.size()) ? m_indices[i] : -1;
+    }
+
+private: // methods:
+
+    BtVersificationMapping(QString const & from, QString const & to);
+
+private: // fields:
+
+    std::vector<std::int32_t> m_indices;
+
+}; /* class BtVersificationMapping */
@@ -0,0 +1,91 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btversificationtable.h"
+
+#include <algorithm>
+#include <mutex>
+#include <QHash>
+#include "../../util/btassert.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <versekey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+std::shared_ptr<BtVersificationTable const>
+BtVersificationTable::forVersification(QString const & versification) {
+    static std::mutex mutex;
+    static QHash<QString, std::shared_ptr<BtVersificationTable const>> tables;
+
+    std::lock_guard<std::mutex> const guard(mutex);
+    auto & table = tables[versification];
+    if (!table)
+        table.reset(new BtVersificationTable(versification));
+    return table;
+}
+
+BtVersificationTable::BtVersificationTable(QString const & versification)
+    : m_versification(versification)
+{
+    sword::VerseKey key;
+    key.setVersificationSystem(versification.toUtf8().constData());
+    key.setIntros(true);
+    key.setPosition(sword::BOTTOM);
+    m_size = key.getIndex() + 1;
+
+    for (long index = 0; index < m_size; ++index) {
+        key.setIndex(index);
+        Position const p{key.getTestament(),
+                         key.getBook(),
+                         key.getChapter(),
+                         key.getVerse()};
+        if (!m_runs.empty()) {
+            auto const & run = m_runs.back();
+            if (run.first.testament == p.testament
+                && run.first.book == p.book
+                && run.first.chapter == p.chapter
+                && run.first.verse + (index - run.firstIndex) == p.verse)
+                continue;
+        }
+        m_runs.emplace_back(Run{index, p});
+    }
+    m_runs.shrink_to_fit();
+    BT_ASSERT(!m_runs.empty());
+}
+
+BtVersificationTable::Position
+BtVersificationTable::position(long index) const noexcept {
+    index = std::clamp(index, 0L, m_size - 1);
+    auto const it =
+            std::upper_bound(m_runs.begin(),
+                             m_runs.end(),
+                             index,
+                             [](long const i, Run const & run) noexcept
+                             { return i < run.firstIndex; });
+    BT_ASSERT(it != m_runs.begin());
+    auto const & run = *(it - 1);
+    auto r(run.first);
+    r.verse += static_cast<int>(index - run.firstIndex);
+    return r;
+}
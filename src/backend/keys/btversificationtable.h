@@ -0,0 +1,79 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <memory>
+#include <QString>
+#include <vector>
+
+
+/**
+  \brief Maps the verse indices (including intros) of a versification system
+         to references without having to go through a sword::VerseKey.
+
+  The table is built with a single pass over a versification system and stores
+  only the runs of consecutive verses, i.e. about one entry per chapter. Tables
+  are shared between all users of the same versification system.
+*/
+class BtVersificationTable {
+
+public: // types:
+
+    struct Position {
+        int testament;
+        int book;
+        int chapter;
+        int verse;
+    };
+
+public: // methods:
+
+    /**
+      \returns the table of the given versification system, which is built on
+               the first call for the system.
+      \note This is thread-safe.
+    */
+    static std::shared_ptr<BtVersificationTable const> forVersification(
+            QString const & versification);
+
+    /**
+      \returns the position at the given index in the same way as
+               sword::VerseKey::setIndex() with intros enabled would, clamping
+               indices outside of the versification system.
+    */
+    Position position(long index) const noexcept;
+
+    /** \returns the number of indices of the versification system. */
+    long size() const noexcept { return m_size; }
+
+    /** \returns the name of the versification system. */
+    QString const & versification() const noexcept { return m_versification; }
+
+private: // types:
+
+    struct Run {
+        long firstIndex;
+        Position first;
+    };
+
+private: // methods:
+
+    explicit BtVersificationTable(QString const & versification);
+
+private: // fields:
+
+    QString const m_versification;
+    std::vector<Run> m_runs;
+    long m_size = 0;
+
+}; /* class BtVersificationTable */
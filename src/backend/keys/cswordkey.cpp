@@ -12,11 +12,21 @@
 
 #include "cswordkey.h"
 
-#include <QRegularExpression>
-#include <QRegularExpressionMatch>
+#include <cstddef>
+#include <QByteArrayView>
+#include <QChar>
+#include <QHash>
 #include <QString>
+#include <QStringDecoder>
+#include <QStringView>
+#include <utility>
+#include <vector>
 #include "../../util/btassert.h"
+#include "../../util/bttrace.h"
+#include "../btentrywritejournal.h"
+#include "../btrawentrycache.h"
 #include "../drivers/cswordmoduleinfo.h"
+#include "../managers/cswordbackend.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -37,6 +47,116 @@
 #pragma GCC diagnostic pop
 
 
+namespace {
+
+/**
+  \brief Replaces the contents of the given string with the given UTF-8 text,
+         reusing the capacity of the string.
+*/
+void assignUtf8(QString & out, char const * const data, std::size_t const size)
+{
+    QByteArrayView const utf8(data, static_cast<qsizetype>(size));
+    QStringDecoder decoder(QStringDecoder::Utf8,
+                           QStringDecoder::Flag::Stateless);
+    out.resize(decoder.requiredSpace(utf8.size()));
+    auto * const end = decoder.appendToBuffer(out.data(), utf8);
+    out.resize(static_cast<qsizetype>(end - out.constData()));
+}
+
+/**
+  \brief Links the Strong's numbers in the rendered text of a lexicon entry
+         which the entry refers to by e.g. "GREEK for 0123" or "HEBREW for
+         0123".
+
+  The text is scanned once for the references and for the whole numbers
+  outside of tags and entities, and only rewritten if any of the numbers are
+  referred to.
+*/
+void linkStrongsNumbers(QString & text) {
+    static constexpr QStringView const greek(u"GREEK");
+    static constexpr QStringView const hebrew(u"HEBREW");
+    static auto const isDigit =
+            [](QChar const c) { return c >= u'0' && c <= u'9'; };
+    static auto const isWordChar =
+            [](QChar const c) { return c.isLetterOrNumber() || c == u'_'; };
+
+    struct Number {
+        qsizetype start;
+        qsizetype size;
+        QStringView value; ///< Without leading zeros
+    };
+    std::vector<Number> numbers;
+    QHash<QStringView, QStringView> languages; // By the referred values
+
+    QStringView const view(text);
+    bool inTag = false;
+    bool inEntity = false;
+    for (qsizetype i = 0; i < view.size(); ++i) {
+        auto const c = view[i];
+        if (inTag) {
+            inTag = (c != u'>');
+            continue;
+        }
+        if (c == u'<') {
+            inTag = true;
+            inEntity = false;
+            continue;
+        }
+        if (inEntity) {
+            inEntity = (c != u';') && !c.isSpace();
+            continue;
+        }
+        if (c == u'&') {
+            inEntity = true;
+            continue;
+        }
+        if (!isDigit(c) || (i > 0 && isWordChar(view[i - 1])))
+            continue;
+
+        auto end = i + 1;
+        while (end < view.size() && isDigit(view[end]))
+            ++end;
+        auto first = i;
+        while (first < end && view[first] == u'0')
+            ++first;
+        if ((end >= view.size() || !isWordChar(view[end])) && first < end) {
+            auto const value = view.sliced(first, end - first);
+            numbers.push_back({i, end - i, value});
+            if (auto const before = view.first(i);
+                before.endsWith(u" for ") && !languages.contains(value))
+            {
+                for (auto const language : {greek, hebrew})
+                    if (before.chopped(5).endsWith(language))
+                        languages.insert(value, language);
+            }
+        }
+        i = end - 1;
+    }
+    if (languages.isEmpty())
+        return;
+
+    QString r;
+    r.reserve(text.size() + 128);
+    qsizetype last = 0;
+    for (auto const & number : numbers) {
+        auto const it = languages.constFind(number.value);
+        if (it == languages.constEnd())
+            continue;
+        r.append(view.sliced(last, number.start - last))
+         .append(QStringLiteral("<span lemma=\"%1%2\">"
+                                "<a href=\"strongs://%3/%2\">%4</a></span>")
+                 .arg(it->first(1),
+                      number.value.toString().rightJustified(5, u'0'),
+                      *it,
+                      view.sliced(number.start, number.size)));
+        last = number.start + number.size;
+    }
+    r.append(view.sliced(last));
+    text = std::move(r);
+}
+
+} // anonymous namespace
+
 CSwordKey::~CSwordKey() noexcept = default;
 
 QString CSwordKey::normalizedKey() const { return key(); }
@@ -51,11 +171,36 @@ QString CSwordKey::rawText() {
     if (key().isNull())
         return QString();
 
-    return QString::fromUtf8(m.getRawEntry());
+    return QString::fromUtf8(cachedRawEntry());
+}
+
+QByteArray CSwordKey::cachedRawEntry() const {
+    auto & m = m_module->swordModule();
+    QByteArray key(m.getKey()->getText());
+    if (auto pending =
+            BtEntryWriteJournal::instance().pendingEntry(m_module->name(), key))
+        return *std::move(pending);
+    return BtRawEntryCache::instance().entry(
+                m_module->name(),
+                key,
+                [&m] {
+                    BT_TRACE_SPAN("sword read raw entry");
+                    auto const lock(CSwordBackend::lockSwordFiles());
+                    return QByteArray(m.getRawEntry());
+                });
 }
 
 QString CSwordKey::renderedText(const CSwordKey::TextRenderType mode) {
+    QString text;
+    renderTextInto(text, mode);
+    return text;
+}
+
+void CSwordKey::renderTextInto(QString & out,
+                               CSwordKey::TextRenderType const mode)
+{
     BT_ASSERT(m_module);
+    out.resize(0);
 
     auto & m = m_module->swordModule();
     if (auto * const vk_mod = dynamic_cast<sword::VerseKey *>(m.getKey()))
@@ -72,54 +217,57 @@ QString CSwordKey::renderedText(const CSwordKey::TextRenderType mode) {
             && !strstr(m.getKey()->getText(), rawKey()))
         {
             qDebug("return an empty key for %s", m.getKey()->getText());
-            return QString();
+            return;
         }
     }
 
     if (key().isNull())
-        return QString();
+        return;
 
     bool DoRender = mode != ProcessEntryAttributesOnly;
-    auto text = QString::fromUtf8(m.renderText(nullptr, -1, DoRender).c_str());
+    // Entries written but not yet committed are not read from the module:
+    auto const pending(
+                BtEntryWriteJournal::instance().pendingEntry(
+                    m_module->name(),
+                    QByteArray(m.getKey()->getText())));
+    auto const rendered = [&m, &pending, DoRender] {
+        BT_TRACE_SPAN("sword render text");
+        if (pending)
+            return m.renderText(pending->constData(),
+                                static_cast<int>(pending->size()),
+                                DoRender);
+        // Sword only processes the entry attributes of entries it reads:
+        auto const lock(CSwordBackend::lockSwordFiles());
+        return m.renderText(nullptr, -1, DoRender);
+    }();
     if (!DoRender)
-        return QString();
+        return;
+    assignUtf8(out, rendered.c_str(), rendered.length());
 
-    // This is yucky, but if we want strong lexicon refs we have to do it here.
-    if (m_module->type() == CSwordModuleInfo::Lexicon) {
-        const QString t(text);
-        static QRegularExpression const rx(
-            QStringLiteral(R"PCRE((GREEK|HEBREW) for 0*([1-9]\d*))PCRE"));
-        QRegularExpressionMatch match;
-        int pos = 0;
-        while ((pos = t.indexOf(rx, pos, &match)) != -1) {
-            auto language = match.captured(1);
-            auto langcode = language.at(0); // "G" or "H"
-            auto number = match.captured(2);
-            auto paddednumber = number.rightJustified(5, '0'); // Form 00123
-
-            text.replace(
-                QRegularExpression(
-                    QStringLiteral(
-                        R"PCRE((>[^<>]+))PCRE" // Avoid replacing inside tags
-                        R"PCRE(\\b(0*%1)\\b)PCRE") // And span around 0's
-                    .arg(std::move(number))),
-                QStringLiteral("\\1<span lemma=\"%1%2\">"
-                               "<a href=\"strongs://%3/%2\">\\2</a></span>")
-                    .arg(std::move(langcode),
-                         std::move(paddednumber),
-                         std::move(language)));
-            pos += match.capturedLength();
-        }
-    }
-    return text;
+    // Link the Strong's numbers lexicon entries refer to:
+    if (m_module->type() == CSwordModuleInfo::Lexicon)
+        linkStrongsNumbers(out);
 }
 
 QString CSwordKey::strippedText() {
+    QString text;
+    strippedTextInto(text);
+    return text;
+}
+
+void CSwordKey::strippedTextInto(QString & out) {
+    out.resize(0);
     if (!m_module)
-        return QString();
+        return;
 
     auto & m = m_module->swordModule();
     m.getKey()->copyFrom(asSwordKey());
 
-    return QString::fromUtf8(m.stripText());
+    /* Stripping does not need the entry attributes, which Sword does not
+       process when given the raw entry: */
+    auto const raw(cachedRawEntry());
+    auto const stripped(m.renderText(raw.constData(),
+                                     static_cast<int>(raw.size()),
+                                     false));
+    assignUtf8(out, stripped.c_str(), stripped.length());
 }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QString>
 
 
@@ -86,11 +87,27 @@ public: // methods:
     */
     QString renderedText(const CSwordKey::TextRenderType mode = CSwordKey::Normal);
 
+    /**
+      \brief Like renderedText(), but replaces the contents of the given string
+             with the rendered text, reusing its capacity.
+
+      Rendering many entries into the same string avoids allocating a new
+      string for each of them.
+    */
+    void renderTextInto(QString & out,
+                        CSwordKey::TextRenderType mode = CSwordKey::Normal);
+
     /**
       \returns the text after removing all markup tags from it.
     */
     QString strippedText();
 
+    /**
+      \brief Like strippedText(), but replaces the contents of the given string
+             with the stripped text, reusing its capacity.
+    */
+    void strippedTextInto(QString & out);
+
     /** Check whether key is valid. Can be invalidated during av11n mapping. */
     bool isValid() const { return m_valid; }
 
@@ -107,6 +124,14 @@ protected: // methods:
     */
     virtual const char * rawKey() const = 0;
 
+private: // methods:
+
+    /**
+      \returns the raw entry of the key currently set to the Sword module,
+               which is looked up in BtRawEntryCache first.
+    */
+    QByteArray cachedRawEntry() const;
+
 protected: // fields:
 
     const CSwordModuleInfo * m_module;
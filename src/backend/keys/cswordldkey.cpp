@@ -15,6 +15,7 @@
 #include <QByteArray>
 #include "../../util/btassert.h"
 #include "../../util/cp1252.h"
+#include "../drivers/cswordlexiconmoduleinfo.h"
 #include "../drivers/cswordmoduleinfo.h"
 
 // Sword includes:
@@ -110,6 +111,19 @@ bool CSwordLDKey::setKey(const char *newKey) {
 
 /** Uses the parameter to returns the next entry afer this key. */
 CSwordLDKey* CSwordLDKey::NextEntry() {
+    /* Use the cached entries instead of seeking, if the key is one of them,
+       except in daily devotionals whose entries are not cached yet: */
+    auto const & lexicon =
+            *static_cast<CSwordLexiconModuleInfo const *>(m_module);
+    if (!lexicon.seeksDirectly()) {
+        auto const & entries = lexicon.entries();
+        if (auto const i = entries.indexOf(key()); i >= 0) {
+            if (i + 1 < entries.size())
+                setKey(entries.at(i + 1));
+            return this;
+        }
+    }
+
     auto & m = m_module->swordModule();
     m.setKey(&m_key); // use this key as base for the next one!
     //   m.getKey()->setText( (const char*)key().utf8() );
@@ -126,6 +140,19 @@ CSwordLDKey* CSwordLDKey::NextEntry() {
 
 /** Uses the parameter to returns the next entry afer this key. */
 CSwordLDKey* CSwordLDKey::PreviousEntry() {
+    /* Use the cached entries instead of seeking, if the key is one of them,
+       except in daily devotionals whose entries are not cached yet: */
+    auto const & lexicon =
+            *static_cast<CSwordLexiconModuleInfo const *>(m_module);
+    if (!lexicon.seeksDirectly()) {
+        auto const & entries = lexicon.entries();
+        if (auto const i = entries.indexOf(key()); i >= 0) {
+            if (i > 0)
+                setKey(entries.at(i - 1));
+            return this;
+        }
+    }
+
     auto & m = m_module->swordModule();
     m.setKey(&m_key); // use this key as base for the next one!
     //   m.getKey()->setText( (const char*)key().utf8() );
@@ -17,6 +17,7 @@
 #include <string_view>
 #include "../../util/btassert.h"
 #include "../drivers/cswordbiblemoduleinfo.h"
+#include "btversificationmapping.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -82,12 +83,23 @@ void CSwordVerseKey::setModule(const CSwordModuleInfo *newModule) {
 
     if (strcmp(m_key.getVersificationSystem(), newVersification)) {
         /// Remap key position to new versification
-        sword::VerseKey oldKey(m_key);
-
-        m_key.setVersificationSystem(newVersification);
-
-        m_key.positionFrom(oldKey);
-        inVersification = !m_key.popError();
+        auto const mappedIndex =
+                (m_key.isIntros() && !m_key.isBoundSet() && !m_key.getSuffix())
+                ? BtVersificationMapping::forVersifications(
+                      m_key.getVersificationSystem(),
+                      newVersification)->mappedIndex(m_key.getIndex())
+                : -1;
+        if (mappedIndex >= 0) {
+            m_key.setVersificationSystem(newVersification);
+            m_key.setIndex(mappedIndex);
+        } else { // Let sword map ranges and verses missing in the target
+            sword::VerseKey oldKey(m_key);
+
+            m_key.setVersificationSystem(newVersification);
+
+            m_key.positionFrom(oldKey);
+            inVersification = !m_key.popError();
+        }
     }
 
     m_module = newModule;
@@ -152,6 +164,10 @@ QString CSwordVerseKey::bookName() const {
     }
 
     if ((m_key.getTestament() >= min + 1) && (m_key.getTestament() <= max + 1) && (m_key.getBook() <= m_key.BMAX[min])) {
+        if (auto const & name = bookNames().bookName(m_key.getTestament(),
+                                                     m_key.getBook());
+            !name.isNull())
+            return name;
         return QString::fromUtf8(m_key.getBookName());
     }
 
@@ -161,9 +177,27 @@ QString CSwordVerseKey::bookName() const {
 
 /** Sets the key we use to the parameter. */
 QString CSwordVerseKey::key() const {
-    return QString::fromUtf8(m_key.isBoundSet()
-                             ? m_key.getRangeText()
-                             : m_key.getText());
+    if (m_key.isBoundSet())
+        return QString::fromUtf8(m_key.getRangeText());
+    if (!m_key.getSuffix())
+        if (auto text(bookNames().keyText(m_key.getTestament(),
+                                          m_key.getBook(),
+                                          m_key.getChapter(),
+                                          m_key.getVerse()));
+            !text.isNull())
+            return text;
+    return QString::fromUtf8(m_key.getText());
+}
+
+BtBookNameTable const & CSwordVerseKey::bookNames() const {
+    // Looking up the names is much cheaper than translating them by the locale:
+    if (!m_bookNames
+        || m_bookNames->localeName() != m_key.getLocale()
+        || m_bookNames->versification() != m_key.getVersificationSystem())
+        m_bookNames = BtBookNameTable::forLocale(
+                          m_key.getLocale(),
+                          m_key.getVersificationSystem());
+    return *m_bookNames;
 }
 
 QString CSwordVerseKey::normalizedKey() const {
@@ -14,9 +14,11 @@
 
 #include "cswordkey.h"
 
+#include <memory>
 #include <QPointer>
 #include <QString>
 #include "../btsignal.h"
+#include "btbooknametable.h"
 
 // Sword includes:
 #pragma GCC diagnostic push
@@ -193,9 +195,15 @@ class CSwordVerseKey final : public CSwordKey {
 
         const char * rawKey() const final override;
 
+    private: // methods:
+
+        /** \returns the book names of the locale of the key. */
+        BtBookNameTable const & bookNames() const;
+
     private: // fields:
 
         sword::VerseKey m_key;
         QPointer<BtSignal> m_afterChangedSignaller;
+        mutable std::shared_ptr<BtBookNameTable const> m_bookNames;
 
 };
@@ -12,10 +12,17 @@
 
 #include "language.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <optional>
 #include <QHash>
 #include <QLocale>
 #include <QObject>
 #include <QtGlobal>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include "../util/btassert.h"
 #include "managers/btlocalemgr.h"
@@ -26,17 +33,315 @@
 
 namespace {
 
-struct LanguageMap: QHash<QString, std::shared_ptr<Language const>> {
-    LanguageMap();
+struct KnownLanguage {
+    char const * abbrevs[3]; // Unused ones are null
+    char const * englishName;
 };
 
-LanguageMap::LanguageMap() {
-    // Developers: It's easy to get a list of used language codes from all modules:
-    // Refresh all sources; go to .sword/InstallMgr/; run:
-    // grep -R -hs Lang= *|cut -c 6-|sort|uniq
-    // Don't remove unused languages from the source code unless you know it won't be used
-    // anymore.in any module ever.
+// Developers: It's easy to get a list of used language codes from all modules:
+// Refresh all sources; go to .sword/InstallMgr/; run:
+// grep -R -hs Lang= *|cut -c 6-|sort|uniq
+// Don't remove unused languages from the source code unless you know it won't be used
+// anymore.in any module ever.
+constexpr static KnownLanguage const knownLanguages[] = {
+    //  {{"aa"}, QT_TRANSLATE_NOOP("QObject", "Afar")},
+    //  {{"ab"}, QT_TRANSLATE_NOOP("QObject", "Abkhazian")},
+    //  {{"ae"}, QT_TRANSLATE_NOOP("QObject", "Avestan")},
+    {{"af"}, QT_TRANSLATE_NOOP("QObject", "Afrikaans")},
+    //  {{"am"}, QT_TRANSLATE_NOOP("QObject", "Amharic")},
+    {{"amu"}, QT_TRANSLATE_NOOP("QObject", "Amuzgo, Guerrero")},
+    {{"ang"}, QT_TRANSLATE_NOOP("QObject", "English, Old (ca.450-1100)")},
+    {{"ar"}, QT_TRANSLATE_NOOP("QObject", "Arabic")},
+    //  {{"as"}, QT_TRANSLATE_NOOP("QObject", "Assamese")},
+    {{"az"}, QT_TRANSLATE_NOOP("QObject", "Azerbaijani")},
+    {{"azb"}, QT_TRANSLATE_NOOP("QObject", "Azerbaijani, South")},
+    //  {{"ba"}, QT_TRANSLATE_NOOP("QObject", "Bashkir")},
+    {{"bar"}, QT_TRANSLATE_NOOP("QObject", "Bavarian")},
+    {{"be"}, QT_TRANSLATE_NOOP("QObject", "Belarusian")},
+    {{"bg"}, QT_TRANSLATE_NOOP("QObject", "Bulgarian")},
+    //  {{"bh"}, QT_TRANSLATE_NOOP("QObject", "Bihari")},
+    //  {{"bi"}, QT_TRANSLATE_NOOP("QObject", "Bislama")},
+    //  {{"bn"}, QT_TRANSLATE_NOOP("QObject", "Bengali")},
+    //  {{"bo"}, QT_TRANSLATE_NOOP("QObject", "Tibetan")},
+    {{"br"}, QT_TRANSLATE_NOOP("QObject", "Breton")},
+    {{"bs"}, QT_TRANSLATE_NOOP("QObject", "Bosnian")},
+    {{"ca"}, QT_TRANSLATE_NOOP("QObject", "Catalan")},
+    //  {{"ce"}, QT_TRANSLATE_NOOP("QObject", "Chechen")},
+    {{"cco"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Comaltepec")},
+    {{"ceb"}, QT_TRANSLATE_NOOP("QObject", "Cebuano")},
+    {{"ch"}, QT_TRANSLATE_NOOP("QObject", "Chamorro")},
+    {{"chd"}, QT_TRANSLATE_NOOP("QObject", "Chontal, Highland Oaxaca")},
+    {{"chq"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Quiotepec")},
+    {{"chz"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Ozumac\u00edn")},
+    //  {{"co"}, QT_TRANSLATE_NOOP("QObject", "Corsican")},
+    {{"ckw"}, QT_TRANSLATE_NOOP("QObject", "Cakchiquel, Western")},
+    {{"cnl"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Lalana")},
+    {{"cnt"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Tepetotutla")},
+    {{"cop"}, QT_TRANSLATE_NOOP("QObject", "Coptic")},
+    {{"cs"}, QT_TRANSLATE_NOOP("QObject", "Czech")},
+    {{"cso"}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Sochiapan")},
+    {{"cti"}, QT_TRANSLATE_NOOP("QObject", "Chol, Tila")},
+    {{"ctp"}, QT_TRANSLATE_NOOP("QObject", "Chatino, Western Highland")},
+    {{"cu"}, QT_TRANSLATE_NOOP("QObject", "Church Slavic")},
+    //  {{"cv"}, QT_TRANSLATE_NOOP("QObject", "Chuvash")},
+    {{"cy"}, QT_TRANSLATE_NOOP("QObject", "Welsh")},
+    {{"da"}, QT_TRANSLATE_NOOP("QObject", "Danish")},
+    {{"de"}, QT_TRANSLATE_NOOP("QObject", "German")},
+    {{"dug"}, QT_TRANSLATE_NOOP("QObject", "Duruma")},
+    //  {{"dz"}, QT_TRANSLATE_NOOP("QObject", "Dzongkha")},
+    {{"el", "gre", "ell"}, QT_TRANSLATE_NOOP("QObject", "Greek, Modern (1453-)")},
+    {{"en"}, QT_TRANSLATE_NOOP("QObject", "English")},
+    {{"en-US"}, QT_TRANSLATE_NOOP("QObject", "American English")},
+    {{"enm"}, QT_TRANSLATE_NOOP("QObject", "English, Middle (1100-1500)")},
+    {{"eo"}, QT_TRANSLATE_NOOP("QObject", "Esperanto")},
+    {{"es"}, QT_TRANSLATE_NOOP("QObject", "Spanish")},
+    {{"et"}, QT_TRANSLATE_NOOP("QObject", "Estonian")},
+    {{"eu"}, QT_TRANSLATE_NOOP("QObject", "Basque")},
+    {{"fa"}, QT_TRANSLATE_NOOP("QObject", "Persian")},
+    {{"fi"}, QT_TRANSLATE_NOOP("QObject", "Finnish")},
+    //  {{"fj"}, QT_TRANSLATE_NOOP("QObject", "Fijian")},
+    //  {{"fo"}, QT_TRANSLATE_NOOP("QObject", "Faroese")},
+    {{"fr"}, QT_TRANSLATE_NOOP("QObject", "French")},
+    {{"fy"}, QT_TRANSLATE_NOOP("QObject", "Frisian")},
+    {{"ga"}, QT_TRANSLATE_NOOP("QObject", "Irish")},
+    {{"gd"}, QT_TRANSLATE_NOOP("QObject", "Gaelic (Scots)")},
+    {{"gez"}, QT_TRANSLATE_NOOP("QObject", "Geez")},
+    //  {{"gl"}, QT_TRANSLATE_NOOP("QObject", "Gallegan")},
+    //  {{"gn"}, QT_TRANSLATE_NOOP("QObject", "Guarani")},
+    //  {{"gn"}, QT_TRANSLATE_NOOP("QObject", "Gujarati")},
+    {{"got"}, QT_TRANSLATE_NOOP("QObject", "Gothic")},
+    {{"gv"}, QT_TRANSLATE_NOOP("QObject", "Manx")},
+    {{"grc"}, QT_TRANSLATE_NOOP("QObject", "Greek, Ancient (to 1453)")},
+    {{"hau"}, QT_TRANSLATE_NOOP("QObject", "Hausa")},
+    {{"haw"}, QT_TRANSLATE_NOOP("QObject", "Hawaiian")},
+    {{"hbo"}, QT_TRANSLATE_NOOP("QObject", "Hebrew, Ancient")},
+    {{"he"}, QT_TRANSLATE_NOOP("QObject", "Hebrew")},
+    {{"hi"}, QT_TRANSLATE_NOOP("QObject", "Hindi")},
+    //  {{"ho"}, QT_TRANSLATE_NOOP("QObject", "Hiri Motu")},
+    {{"hr"}, QT_TRANSLATE_NOOP("QObject", "Croatian")},
+    {{"ht"}, QT_TRANSLATE_NOOP("QObject", "Haitian Creole")},
+    {{"hu"}, QT_TRANSLATE_NOOP("QObject", "Hungarian")},
+    {{"huv"}, QT_TRANSLATE_NOOP("QObject", "Huave, San Mateo Del Mar")},
+    {{"hy"}, QT_TRANSLATE_NOOP("QObject", "Armenian")},
+    //  {{"hz"}, QT_TRANSLATE_NOOP("QObject", "Herero")},
+    //  {{"ia"}, QT_TRANSLATE_NOOP("QObject", "Interlingua")},
+    {{"id"}, QT_TRANSLATE_NOOP("QObject", "Indonesian")},
+    //  {{"ie"}, QT_TRANSLATE_NOOP("QObject", "Interlingue")},
+    //  {{"ik"}, QT_TRANSLATE_NOOP("QObject", "Inupiaq")},
+    {{"is"}, QT_TRANSLATE_NOOP("QObject", "Icelandic")},
+    {{"it"}, QT_TRANSLATE_NOOP("QObject", "Italian")},
+    {{"itz"}, QT_TRANSLATE_NOOP("QObject", "Itz\u00e1")},
+    {{"ixl"}, QT_TRANSLATE_NOOP("QObject", "Ixil, San Juan Cotzal")},
+    //  {{"iu"}, QT_TRANSLATE_NOOP("QObject", "Inuktitut")},
+    {{"ja"}, QT_TRANSLATE_NOOP("QObject", "Japanese")},
+    {{"jac"}, QT_TRANSLATE_NOOP("QObject", "Jacalteco, Eastern")},
+    {{"jvn"}, QT_TRANSLATE_NOOP("QObject", "Javanese, Caribbean")},
+    {{"ka"}, QT_TRANSLATE_NOOP("QObject", "Georgian")},
+    {{"kek"}, QT_TRANSLATE_NOOP("QObject", "Kekchi")},
+    //  {{"ki"}, QT_TRANSLATE_NOOP("QObject", "Kikuyu")},
+    //  {{"kj"}, QT_TRANSLATE_NOOP("QObject", "Kuanyama")},
+    //  {{"kk"}, QT_TRANSLATE_NOOP("QObject", "Kazakh")},
+    //  {{"kl"}, QT_TRANSLATE_NOOP("QObject", "Kalaallisut")},
+    //  {{"km"}, QT_TRANSLATE_NOOP("QObject", "Khmer")},
+    //  {{"kn"}, QT_TRANSLATE_NOOP("QObject", "Kannada")},
+    {{"ko"}, QT_TRANSLATE_NOOP("QObject", "Korean")},
+    //  {{"ks"}, QT_TRANSLATE_NOOP("QObject", "Kashmiri")},
+    {{"ku"}, QT_TRANSLATE_NOOP("QObject", "Kurdish")},
+    //  {{"kv"}, QT_TRANSLATE_NOOP("QObject", "Komi")},
+    //  {{"kw"}, QT_TRANSLATE_NOOP("QObject", "Cornish")},
+    {{"ky"}, QT_TRANSLATE_NOOP("QObject", "Kirghiz")},
+    {{"la"}, QT_TRANSLATE_NOOP("QObject", "Latin")},
+    {{"lac"}, QT_TRANSLATE_NOOP("QObject", "Lacandon")},
+    //  {{"lb"}, QT_TRANSLATE_NOOP("QObject", "Letzeburgesch")},
+    {{"lmo"}, QT_TRANSLATE_NOOP("QObject", "Lombard")},
+    //  {{"ln"}, QT_TRANSLATE_NOOP("QObject", "Lingala")},
+    //  {{"lo"}, QT_TRANSLATE_NOOP("QObject", "Lao")},
+    {{"lt"}, QT_TRANSLATE_NOOP("QObject", "Lithuanian")},
+    {{"lv"}, QT_TRANSLATE_NOOP("QObject", "Latvian")},
+    {{"mg"}, QT_TRANSLATE_NOOP("QObject", "Malagasy")},
+    //  {{"mh"}, QT_TRANSLATE_NOOP("QObject", "Marshall")},
+    {{"mi"}, QT_TRANSLATE_NOOP("QObject", "Maori")},
+    {{"mir"}, QT_TRANSLATE_NOOP("QObject", "Mixe, Isthmus")},
+    {{"miz"}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Coatzospan")},
+    {{"mk"}, QT_TRANSLATE_NOOP("QObject", "Macedonian")},
+    {{"mks"}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Silacayoapan")},
+    //  {{"ml"}, QT_TRANSLATE_NOOP("QObject", "Malayalam")},
+    //  {{"mn"}, QT_TRANSLATE_NOOP("QObject", "Mongolian")},
+    //  {{"mo"}, QT_TRANSLATE_NOOP("QObject", "Moldavian")},
+    {{"mos"}, QT_TRANSLATE_NOOP("QObject", "More")},
+    //  {{"mr"}, QT_TRANSLATE_NOOP("QObject", "Marathi")},
+    {{"ms"}, QT_TRANSLATE_NOOP("QObject", "Malay")},
+    {{"mt"}, QT_TRANSLATE_NOOP("QObject", "Maltese")},
+    {{"mul"}, QT_TRANSLATE_NOOP("QObject", "(Multiple languages)")},
+    {{"mvc"}, QT_TRANSLATE_NOOP("QObject", "Mam, Central")},
+    {{"mvj"}, QT_TRANSLATE_NOOP("QObject", "Mam, Todos Santos Cuchumat\u00e1n")},
+    {{"mxq"}, QT_TRANSLATE_NOOP("QObject", "Mixe, Juquila")},
+    {{"mxt"}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Jamiltepec")},
+    {{"my"}, QT_TRANSLATE_NOOP("QObject", "Burmese")},
+    //  {{"na"}, QT_TRANSLATE_NOOP("QObject", "Nauru")},
+    {{"nb"}, QT_TRANSLATE_NOOP("QObject", "Norwegian Bokm\u00e5l")},
+    {{"ncl"}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Michoac\u00e1n")},
+    //  {{"nd"}, QT_TRANSLATE_NOOP("QObject", "Ndebele, North")},
+    {{"nds"}, QT_TRANSLATE_NOOP("QObject", "Low German; Low Saxon")},
+    {{"ne"}, QT_TRANSLATE_NOOP("QObject", "Nepali")},
+    {{"ngu"}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Guerrero")},
+    {{"nhy"}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Northern Oaxaca")},
+    //  {{"ng"}, QT_TRANSLATE_NOOP("QObject", "Ndonga")},
+    {{"nl"}, QT_TRANSLATE_NOOP("QObject", "Dutch")},
+    {{"nn"}, QT_TRANSLATE_NOOP("QObject", "Norwegian Nynorsk")},
+    {{"no"}, QT_TRANSLATE_NOOP("QObject", "Norwegian")},
+    //  {{"nr"}, QT_TRANSLATE_NOOP("QObject", "Ndebele, South")},
+    //  {{"nv"}, QT_TRANSLATE_NOOP("QObject", "Navajo")},
+    //  {{"ny"}, QT_TRANSLATE_NOOP("QObject", "Chichewa; Nyanja")},
+    //  {{"oc"}, QT_TRANSLATE_NOOP("QObject", "Occitan (post 1500); Provençal")},
+    //  {{"om"}, QT_TRANSLATE_NOOP("QObject", "Oromo")},
+    //  {{"or"}, QT_TRANSLATE_NOOP("QObject", "Oriya")},
+    //  {{"os"}, QT_TRANSLATE_NOOP("QObject", "Ossetian; Ossetic")},
+    {{"otq"}, QT_TRANSLATE_NOOP("QObject", "Otomi, Quer\u00e9taro")},
+    //  {{"pa"}, QT_TRANSLATE_NOOP("QObject", "Panjabi")},
+    {{"pap"}, QT_TRANSLATE_NOOP("QObject", "Papiamento")},
+    //  {{"pi"}, QT_TRANSLATE_NOOP("QObject", "Pali")},
+    {{"pl"}, QT_TRANSLATE_NOOP("QObject", "Polish")},
+    {{"pot"}, QT_TRANSLATE_NOOP("QObject", "Potawatomi")},
+    {{"ppk"}, QT_TRANSLATE_NOOP("QObject", "Uma")},
+    {{"prs"}, QT_TRANSLATE_NOOP("QObject", "Persian (Dari)")},
+    //  {{"ps"}, QT_TRANSLATE_NOOP("QObject", "Pushto")},
+    {{"pt"}, QT_TRANSLATE_NOOP("QObject", "Portuguese")},
+    {{"pt-BR"}, QT_TRANSLATE_NOOP("QObject", "Brazilian Portuguese")},
+    //  {{"qu"}, QT_TRANSLATE_NOOP("QObject", "Quechua")},
+    {{"qut"}, QT_TRANSLATE_NOOP("QObject", "Quich\u00e9, West Central")},
+    //  {{"rm"}, QT_TRANSLATE_NOOP("QObject", "Raeto-Romance")},
+    //  {{"rn"}, QT_TRANSLATE_NOOP("QObject", "Rundi")},
+    {{"ro"}, QT_TRANSLATE_NOOP("QObject", "Romanian")},
+    {{"ru"}, QT_TRANSLATE_NOOP("QObject", "Russian")},
+    //  {{"rw"}, QT_TRANSLATE_NOOP("QObject", "Kinyarwanda")},
+    //  {{"sa"}, QT_TRANSLATE_NOOP("QObject", "Sanskrit")},
+    //  {{"sc"}, QT_TRANSLATE_NOOP("QObject", "Sardinian")},
+    {{"sco"}, QT_TRANSLATE_NOOP("QObject", "Scots")},
+    //  {{"sd"}, QT_TRANSLATE_NOOP("QObject", "Sindhi")},
+    //  {{"se"}, QT_TRANSLATE_NOOP("QObject", "Northern Sami")},
+    //  {{"sg"}, QT_TRANSLATE_NOOP("QObject", "Sango")},
+    //  {{"si"}, QT_TRANSLATE_NOOP("QObject", "Sinhalese")},
+    {{"sk"}, QT_TRANSLATE_NOOP("QObject", "Slovak")},
+    {{"sl"}, QT_TRANSLATE_NOOP("QObject", "Slovenian")},
+    //  {{"sm"}, QT_TRANSLATE_NOOP("QObject", "Samoan")},
+    //  {{"sn"}, QT_TRANSLATE_NOOP("QObject", "Shona")},
+    {{"so"}, QT_TRANSLATE_NOOP("QObject", "Somali")},
+    {{"sq"}, QT_TRANSLATE_NOOP("QObject", "Albanian")},
+    //  {{"sr"}, QT_TRANSLATE_NOOP("QObject", "Serbian")},
+    {{"srn"}, QT_TRANSLATE_NOOP("QObject", "Sranan")},
+    //  {{"ss"}, QT_TRANSLATE_NOOP("QObject", "Swati")},
+    //  {{"st"}, QT_TRANSLATE_NOOP("QObject", "Sotho, Southern")},
+    //  {{"su"}, QT_TRANSLATE_NOOP("QObject", "Sundanese")},
+    {{"sv"}, QT_TRANSLATE_NOOP("QObject", "Swedish")},
+    {{"sw"}, QT_TRANSLATE_NOOP("QObject", "Swahili")},
+    {{"syr"}, QT_TRANSLATE_NOOP("QObject", "Syriac")},
+    {{"ta"}, QT_TRANSLATE_NOOP("QObject", "Tamil")},
+    //  {{"te"}, QT_TRANSLATE_NOOP("QObject", "Telugu")},
+    //  {{"tg"}, QT_TRANSLATE_NOOP("QObject", "Tajik")},
+    {{"th"}, QT_TRANSLATE_NOOP("QObject", "Thai")},
+    //  {{"tk"}, QT_TRANSLATE_NOOP("QObject", "Turkmen")},
+    {{"tl"}, QT_TRANSLATE_NOOP("QObject", "Tagalog")},
+    {{"tlh"}, QT_TRANSLATE_NOOP("QObject", "Klingon")},
+    {{"tn"}, QT_TRANSLATE_NOOP("QObject", "Tswana")},
+    {{"tr"}, QT_TRANSLATE_NOOP("QObject", "Turkish")},
+    //  {{"ts"}, QT_TRANSLATE_NOOP("QObject", "Tsonga")},
+    //  {{"tt"}, QT_TRANSLATE_NOOP("QObject", "Tatar")},
+    {{"ttc"}, QT_TRANSLATE_NOOP("QObject", "Tektiteko")},
+    //  {{"tw"}, QT_TRANSLATE_NOOP("QObject", "Twi")},
+    {{"ty"}, QT_TRANSLATE_NOOP("QObject", "Tahitian")},
+    {{"tzz"}, QT_TRANSLATE_NOOP("QObject", "Tzotzil, Zinacant\u00e1n")},
+    //  {{"ug"}, QT_TRANSLATE_NOOP("QObject", "Uighur")},
+    {{"uk"}, QT_TRANSLATE_NOOP("QObject", "Ukrainian")},
+    //  {{"ur"}, QT_TRANSLATE_NOOP("QObject", "Urdu")},
+    {{"ury"}, QT_TRANSLATE_NOOP("QObject", "Orya")},
+    {{"usp"}, QT_TRANSLATE_NOOP("QObject", "Uspanteco")},
+    //  {{"uz"}, QT_TRANSLATE_NOOP("QObject", "Uzbek")},
+    {{"vi"}, QT_TRANSLATE_NOOP("QObject", "Vietnamese")},
+    //  {{"vo"}, QT_TRANSLATE_NOOP("QObject", "Volapük")},
+    //  {{"wo"}, QT_TRANSLATE_NOOP("QObject", "Wolof")},
+    {{"xh"}, QT_TRANSLATE_NOOP("QObject", "Xhosa")},
+    {{"xtd"}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Diuxi-Tilantongo")},
+    {{"yi"}, QT_TRANSLATE_NOOP("QObject", "Yiddish")},
+    {{"yo"}, QT_TRANSLATE_NOOP("QObject", "Yoruba")},
+    //  {{"za"}, QT_TRANSLATE_NOOP("QObject", "Zhuang")},
+    {{"zab"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, San Juan Guelav\u00eda")},
+    {{"zaw"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Mitla")},
+    {{"zh"}, QT_TRANSLATE_NOOP("QObject", "Chinese")},
+    {{"zpo"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Amatl\u00e1n")},
+    {{"zpq"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Zoogocho")},
+    {{"zpu"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Yal\u00e1lag")},
+    {{"zpv"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Chichicapan")},
+    {{"zsr"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Southern Rincon")},
+    {{"ztq"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Quioquitani-Quier\u00ed")},
+    {{"zty"}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Yatee")},
+    {{"zu"}, QT_TRANSLATE_NOOP("QObject", "Zulu")},
+};
+
+constexpr static std::size_t const numKnownLanguages =
+        std::extent_v<decltype(knownLanguages)>;
+
+constexpr std::size_t countKnownAbbrevs() noexcept {
+    std::size_t r = 0u;
+    for (auto const & language : knownLanguages)
+        for (auto const * const abbrev : language.abbrevs)
+            if (abbrev)
+                ++r;
+    return r;
+}
+
+struct KnownAbbrev {
+    std::string_view abbrev;
+    std::size_t languageIndex;
+};
+
+/** The abbreviations of knownLanguages, sorted at compile time. */
+constexpr static auto const knownAbbrevs =
+        [] {
+            std::array<KnownAbbrev, countKnownAbbrevs()> r{};
+            std::size_t size = 0u;
+            for (std::size_t i = 0u; i < numKnownLanguages; ++i) {
+                for (auto const * const a : knownLanguages[i].abbrevs) {
+                    if (!a)
+                        continue;
+                    std::string_view const abbrev(a);
+                    // Insertion sort, since std::sort is not constexpr:
+                    auto j = size++;
+                    for (; j > 0u && abbrev < r[j - 1u].abbrev; --j)
+                        r[j] = r[j - 1u];
+                    r[j] = KnownAbbrev{abbrev, i};
+                }
+            }
+            return r;
+        }();
+
+constexpr bool knownAbbrevsAreUnique() noexcept {
+    for (std::size_t i = 1u; i < knownAbbrevs.size(); ++i)
+        if (knownAbbrevs[i - 1u].abbrev == knownAbbrevs[i].abbrev)
+            return false;
+    return true;
+}
+static_assert(knownAbbrevsAreUnique(),
+              "Every abbreviation may only belong to one language!");
+
+/** \returns the index of the known language of the given abbreviation. */
+std::optional<std::size_t> findKnownLanguage(QString const & abbrev) {
+    auto const latin1(abbrev.toLatin1());
+    std::string_view const needle(latin1.constData(),
+                                  static_cast<std::size_t>(latin1.size()));
+    auto const it =
+            std::lower_bound(knownAbbrevs.begin(),
+                             knownAbbrevs.end(),
+                             needle,
+                             [](KnownAbbrev const & a, std::string_view b)
+                             { return a.abbrev < b; });
+    if (it == knownAbbrevs.end() || it->abbrev != needle)
+        return {};
+    return it->languageIndex;
+}
 
+/** \returns a new Language object for the known language at given index. */
+std::shared_ptr<Language const> createKnownLanguage(std::size_t const index) {
     /*:
     The string "Names of languages" doesn't actually need translation.
     It is put here to help translators notice this help text.
@@ -65,249 +370,13 @@ LanguageMap::LanguageMap() {
     */
     QObject::tr("Names of languages", "No need to translate - see the longer comment (If there is no longer comment, it doesn't work yet :)) ------ ");
 
-    auto const addLanguage =
-        [this](QStringList abbrevs, QString englishName) {
-            auto language =
-                    std::make_shared<Language>(std::move(abbrevs),
-                                               std::move(englishName));
-            for (auto const & abbrev : language->abbrevs()) {
-                BT_ASSERT(!contains(abbrev));
-                insert(abbrev, language);
-            }
-        };
-
-    //  addLanguage({QStringLiteral("aa")}, QT_TRANSLATE_NOOP("QObject", "Afar"));
-    //  addLanguage({QStringLiteral("ab")}, QT_TRANSLATE_NOOP("QObject", "Abkhazian"));
-    //  addLanguage({QStringLiteral("ae")}, QT_TRANSLATE_NOOP("QObject", "Avestan"));
-    addLanguage({QStringLiteral("af")}, QT_TRANSLATE_NOOP("QObject", "Afrikaans"));
-    //  addLanguage({QStringLiteral("am")}, QT_TRANSLATE_NOOP("QObject", "Amharic"));
-    addLanguage({QStringLiteral("amu")}, QT_TRANSLATE_NOOP("QObject", "Amuzgo, Guerrero"));
-    addLanguage({QStringLiteral("ang")}, QT_TRANSLATE_NOOP("QObject", "English, Old (ca.450-1100)"));
-    addLanguage({QStringLiteral("ar")}, QT_TRANSLATE_NOOP("QObject", "Arabic"));
-    //  addLanguage({QStringLiteral("as")}, QT_TRANSLATE_NOOP("QObject", "Assamese"));
-    addLanguage({QStringLiteral("az")}, QT_TRANSLATE_NOOP("QObject", "Azerbaijani"));
-    addLanguage({QStringLiteral("azb")}, QT_TRANSLATE_NOOP("QObject", "Azerbaijani, South"));
-    //  addLanguage({QStringLiteral("ba")}, QT_TRANSLATE_NOOP("QObject", "Bashkir"));
-    addLanguage({QStringLiteral("bar")}, QT_TRANSLATE_NOOP("QObject", "Bavarian"));
-    addLanguage({QStringLiteral("be")}, QT_TRANSLATE_NOOP("QObject", "Belarusian"));
-    addLanguage({QStringLiteral("bg")}, QT_TRANSLATE_NOOP("QObject", "Bulgarian"));
-    //  addLanguage({QStringLiteral("bh")}, QT_TRANSLATE_NOOP("QObject", "Bihari"));
-    //  addLanguage({QStringLiteral("bi")}, QT_TRANSLATE_NOOP("QObject", "Bislama"));
-    //  addLanguage({QStringLiteral("bn")}, QT_TRANSLATE_NOOP("QObject", "Bengali"));
-    //  addLanguage({QStringLiteral("bo")}, QT_TRANSLATE_NOOP("QObject", "Tibetan"));
-    addLanguage({QStringLiteral("br")}, QT_TRANSLATE_NOOP("QObject", "Breton"));
-    addLanguage({QStringLiteral("bs")}, QT_TRANSLATE_NOOP("QObject", "Bosnian"));
-    addLanguage({QStringLiteral("ca")}, QT_TRANSLATE_NOOP("QObject", "Catalan"));
-    //  addLanguage({QStringLiteral("ce")}, QT_TRANSLATE_NOOP("QObject", "Chechen"));
-    addLanguage({QStringLiteral("cco")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Comaltepec"));
-    addLanguage({QStringLiteral("ceb")}, QT_TRANSLATE_NOOP("QObject", "Cebuano"));
-    addLanguage({QStringLiteral("ch")}, QT_TRANSLATE_NOOP("QObject", "Chamorro"));
-    addLanguage({QStringLiteral("chd")}, QT_TRANSLATE_NOOP("QObject", "Chontal, Highland Oaxaca"));
-    addLanguage({QStringLiteral("chq")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Quiotepec"));
-    addLanguage({QStringLiteral("chz")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Ozumac\u00edn"));
-    //  addLanguage({QStringLiteral("co")}, QT_TRANSLATE_NOOP("QObject", "Corsican"));
-    addLanguage({QStringLiteral("ckw")}, QT_TRANSLATE_NOOP("QObject", "Cakchiquel, Western"));
-    addLanguage({QStringLiteral("cnl")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Lalana"));
-    addLanguage({QStringLiteral("cnt")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Tepetotutla"));
-    addLanguage({QStringLiteral("cop")}, QT_TRANSLATE_NOOP("QObject", "Coptic"));
-    addLanguage({QStringLiteral("cs")}, QT_TRANSLATE_NOOP("QObject", "Czech"));
-    addLanguage({QStringLiteral("cso")}, QT_TRANSLATE_NOOP("QObject", "Chinantec, Sochiapan"));
-    addLanguage({QStringLiteral("cti")}, QT_TRANSLATE_NOOP("QObject", "Chol, Tila"));
-    addLanguage({QStringLiteral("ctp")}, QT_TRANSLATE_NOOP("QObject", "Chatino, Western Highland"));
-    addLanguage({QStringLiteral("cu")}, QT_TRANSLATE_NOOP("QObject", "Church Slavic"));
-    //  addLanguage({QStringLiteral("cv")}, QT_TRANSLATE_NOOP("QObject", "Chuvash"));
-    addLanguage({QStringLiteral("cy")}, QT_TRANSLATE_NOOP("QObject", "Welsh"));
-    addLanguage({QStringLiteral("da")}, QT_TRANSLATE_NOOP("QObject", "Danish"));
-    addLanguage({QStringLiteral("de")}, QT_TRANSLATE_NOOP("QObject", "German"));
-    addLanguage({QStringLiteral("dug")}, QT_TRANSLATE_NOOP("QObject", "Duruma"));
-    //  addLanguage({QStringLiteral("dz")}, QT_TRANSLATE_NOOP("QObject", "Dzongkha"));
-    addLanguage({QStringLiteral("el"), QStringLiteral("gre"), QStringLiteral("ell")}, QT_TRANSLATE_NOOP("QObject", "Greek, Modern (1453-)"));
-    addLanguage({QStringLiteral("en")}, QT_TRANSLATE_NOOP("QObject", "English"));
-    addLanguage({QStringLiteral("en-US")}, QT_TRANSLATE_NOOP("QObject", "American English"));
-    addLanguage({QStringLiteral("enm")}, QT_TRANSLATE_NOOP("QObject", "English, Middle (1100-1500)"));
-    addLanguage({QStringLiteral("eo")}, QT_TRANSLATE_NOOP("QObject", "Esperanto"));
-    addLanguage({QStringLiteral("es")}, QT_TRANSLATE_NOOP("QObject", "Spanish"));
-    addLanguage({QStringLiteral("et")}, QT_TRANSLATE_NOOP("QObject", "Estonian"));
-    addLanguage({QStringLiteral("eu")}, QT_TRANSLATE_NOOP("QObject", "Basque"));
-    addLanguage({QStringLiteral("fa")}, QT_TRANSLATE_NOOP("QObject", "Persian"));
-    addLanguage({QStringLiteral("fi")}, QT_TRANSLATE_NOOP("QObject", "Finnish"));
-    //  addLanguage({QStringLiteral("fj")}, QT_TRANSLATE_NOOP("QObject", "Fijian"));
-    //  addLanguage({QStringLiteral("fo")}, QT_TRANSLATE_NOOP("QObject", "Faroese"));
-    addLanguage({QStringLiteral("fr")}, QT_TRANSLATE_NOOP("QObject", "French"));
-    addLanguage({QStringLiteral("fy")}, QT_TRANSLATE_NOOP("QObject", "Frisian"));
-    addLanguage({QStringLiteral("ga")}, QT_TRANSLATE_NOOP("QObject", "Irish"));
-    addLanguage({QStringLiteral("gd")}, QT_TRANSLATE_NOOP("QObject", "Gaelic (Scots)"));
-    addLanguage({QStringLiteral("gez")}, QT_TRANSLATE_NOOP("QObject", "Geez"));
-    //  addLanguage({QStringLiteral("gl")}, QT_TRANSLATE_NOOP("QObject", "Gallegan"));
-    //  addLanguage({QStringLiteral("gn")}, QT_TRANSLATE_NOOP("QObject", "Guarani"));
-    //  addLanguage({QStringLiteral("gn")}, QT_TRANSLATE_NOOP("QObject", "Gujarati"));
-    addLanguage({QStringLiteral("got")}, QT_TRANSLATE_NOOP("QObject", "Gothic"));
-    addLanguage({QStringLiteral("gv")}, QT_TRANSLATE_NOOP("QObject", "Manx"));
-    addLanguage({QStringLiteral("grc")}, QT_TRANSLATE_NOOP("QObject", "Greek, Ancient (to 1453)"));
-    addLanguage({QStringLiteral("hau")}, QT_TRANSLATE_NOOP("QObject", "Hausa"));
-    addLanguage({QStringLiteral("haw")}, QT_TRANSLATE_NOOP("QObject", "Hawaiian"));
-    addLanguage({QStringLiteral("hbo")}, QT_TRANSLATE_NOOP("QObject", "Hebrew, Ancient"));
-    addLanguage({QStringLiteral("he")}, QT_TRANSLATE_NOOP("QObject", "Hebrew"));
-    addLanguage({QStringLiteral("hi")}, QT_TRANSLATE_NOOP("QObject", "Hindi"));
-    //  addLanguage({QStringLiteral("ho")}, QT_TRANSLATE_NOOP("QObject", "Hiri Motu"));
-    addLanguage({QStringLiteral("hr")}, QT_TRANSLATE_NOOP("QObject", "Croatian"));
-    addLanguage({QStringLiteral("ht")}, QT_TRANSLATE_NOOP("QObject", "Haitian Creole"));
-    addLanguage({QStringLiteral("hu")}, QT_TRANSLATE_NOOP("QObject", "Hungarian"));
-    addLanguage({QStringLiteral("huv")}, QT_TRANSLATE_NOOP("QObject", "Huave, San Mateo Del Mar"));
-    addLanguage({QStringLiteral("hy")}, QT_TRANSLATE_NOOP("QObject", "Armenian"));
-    //  addLanguage({QStringLiteral("hz")}, QT_TRANSLATE_NOOP("QObject", "Herero"));
-    //  addLanguage({QStringLiteral("ia")}, QT_TRANSLATE_NOOP("QObject", "Interlingua"));
-    addLanguage({QStringLiteral("id")}, QT_TRANSLATE_NOOP("QObject", "Indonesian"));
-    //  addLanguage({QStringLiteral("ie")}, QT_TRANSLATE_NOOP("QObject", "Interlingue"));
-    //  addLanguage({QStringLiteral("ik")}, QT_TRANSLATE_NOOP("QObject", "Inupiaq"));
-    addLanguage({QStringLiteral("is")}, QT_TRANSLATE_NOOP("QObject", "Icelandic"));
-    addLanguage({QStringLiteral("it")}, QT_TRANSLATE_NOOP("QObject", "Italian"));
-    addLanguage({QStringLiteral("itz")}, QT_TRANSLATE_NOOP("QObject", "Itz\u00e1"));
-    addLanguage({QStringLiteral("ixl")}, QT_TRANSLATE_NOOP("QObject", "Ixil, San Juan Cotzal"));
-    //  addLanguage({QStringLiteral("iu")}, QT_TRANSLATE_NOOP("QObject", "Inuktitut"));
-    addLanguage({QStringLiteral("ja")}, QT_TRANSLATE_NOOP("QObject", "Japanese"));
-    addLanguage({QStringLiteral("jac")}, QT_TRANSLATE_NOOP("QObject", "Jacalteco, Eastern"));
-    addLanguage({QStringLiteral("jvn")}, QT_TRANSLATE_NOOP("QObject", "Javanese, Caribbean"));
-    addLanguage({QStringLiteral("ka")}, QT_TRANSLATE_NOOP("QObject", "Georgian"));
-    addLanguage({QStringLiteral("kek")}, QT_TRANSLATE_NOOP("QObject", "Kekchi"));
-    //  addLanguage({QStringLiteral("ki")}, QT_TRANSLATE_NOOP("QObject", "Kikuyu"));
-    //  addLanguage({QStringLiteral("kj")}, QT_TRANSLATE_NOOP("QObject", "Kuanyama"));
-    //  addLanguage({QStringLiteral("kk")}, QT_TRANSLATE_NOOP("QObject", "Kazakh"));
-    //  addLanguage({QStringLiteral("kl")}, QT_TRANSLATE_NOOP("QObject", "Kalaallisut"));
-    //  addLanguage({QStringLiteral("km")}, QT_TRANSLATE_NOOP("QObject", "Khmer"));
-    //  addLanguage({QStringLiteral("kn")}, QT_TRANSLATE_NOOP("QObject", "Kannada"));
-    addLanguage({QStringLiteral("ko")}, QT_TRANSLATE_NOOP("QObject", "Korean"));
-    //  addLanguage({QStringLiteral("ks")}, QT_TRANSLATE_NOOP("QObject", "Kashmiri"));
-    addLanguage({QStringLiteral("ku")}, QT_TRANSLATE_NOOP("QObject", "Kurdish"));
-    //  addLanguage({QStringLiteral("kv")}, QT_TRANSLATE_NOOP("QObject", "Komi"));
-    //  addLanguage({QStringLiteral("kw")}, QT_TRANSLATE_NOOP("QObject", "Cornish"));
-    addLanguage({QStringLiteral("ky")}, QT_TRANSLATE_NOOP("QObject", "Kirghiz"));
-    addLanguage({QStringLiteral("la")}, QT_TRANSLATE_NOOP("QObject", "Latin"));
-    addLanguage({QStringLiteral("lac")}, QT_TRANSLATE_NOOP("QObject", "Lacandon"));
-    //  addLanguage({QStringLiteral("lb")}, QT_TRANSLATE_NOOP("QObject", "Letzeburgesch"));
-    addLanguage({QStringLiteral("lmo")}, QT_TRANSLATE_NOOP("QObject", "Lombard"));
-    //  addLanguage({QStringLiteral("ln")}, QT_TRANSLATE_NOOP("QObject", "Lingala"));
-    //  addLanguage({QStringLiteral("lo")}, QT_TRANSLATE_NOOP("QObject", "Lao"));
-    addLanguage({QStringLiteral("lt")}, QT_TRANSLATE_NOOP("QObject", "Lithuanian"));
-    addLanguage({QStringLiteral("lv")}, QT_TRANSLATE_NOOP("QObject", "Latvian"));
-    addLanguage({QStringLiteral("mg")}, QT_TRANSLATE_NOOP("QObject", "Malagasy"));
-    //  addLanguage({QStringLiteral("mh")}, QT_TRANSLATE_NOOP("QObject", "Marshall"));
-    addLanguage({QStringLiteral("mi")}, QT_TRANSLATE_NOOP("QObject", "Maori"));
-    addLanguage({QStringLiteral("mir")}, QT_TRANSLATE_NOOP("QObject", "Mixe, Isthmus"));
-    addLanguage({QStringLiteral("miz")}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Coatzospan"));
-    addLanguage({QStringLiteral("mk")}, QT_TRANSLATE_NOOP("QObject", "Macedonian"));
-    addLanguage({QStringLiteral("mks")}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Silacayoapan"));
-    //  addLanguage({QStringLiteral("ml")}, QT_TRANSLATE_NOOP("QObject", "Malayalam"));
-    //  addLanguage({QStringLiteral("mn")}, QT_TRANSLATE_NOOP("QObject", "Mongolian"));
-    //  addLanguage({QStringLiteral("mo")}, QT_TRANSLATE_NOOP("QObject", "Moldavian"));
-    addLanguage({QStringLiteral("mos")}, QT_TRANSLATE_NOOP("QObject", "More"));
-    //  addLanguage({QStringLiteral("mr")}, QT_TRANSLATE_NOOP("QObject", "Marathi"));
-    addLanguage({QStringLiteral("ms")}, QT_TRANSLATE_NOOP("QObject", "Malay"));
-    addLanguage({QStringLiteral("mt")}, QT_TRANSLATE_NOOP("QObject", "Maltese"));
-    addLanguage({QStringLiteral("mul")}, QT_TRANSLATE_NOOP("QObject", "(Multiple languages)"));
-    addLanguage({QStringLiteral("mvc")}, QT_TRANSLATE_NOOP("QObject", "Mam, Central"));
-    addLanguage({QStringLiteral("mvj")}, QT_TRANSLATE_NOOP("QObject", "Mam, Todos Santos Cuchumat\u00e1n"));
-    addLanguage({QStringLiteral("mxq")}, QT_TRANSLATE_NOOP("QObject", "Mixe, Juquila"));
-    addLanguage({QStringLiteral("mxt")}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Jamiltepec"));
-    addLanguage({QStringLiteral("my")}, QT_TRANSLATE_NOOP("QObject", "Burmese"));
-    //  addLanguage({QStringLiteral("na")}, QT_TRANSLATE_NOOP("QObject", "Nauru"));
-    addLanguage({QStringLiteral("nb")}, QT_TRANSLATE_NOOP("QObject", "Norwegian Bokm\u00e5l"));
-    addLanguage({QStringLiteral("ncl")}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Michoac\u00e1n"));
-    //  addLanguage({QStringLiteral("nd")}, QT_TRANSLATE_NOOP("QObject", "Ndebele, North"));
-    addLanguage({QStringLiteral("nds")}, QT_TRANSLATE_NOOP("QObject", "Low German; Low Saxon"));
-    addLanguage({QStringLiteral("ne")}, QT_TRANSLATE_NOOP("QObject", "Nepali"));
-    addLanguage({QStringLiteral("ngu")}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Guerrero"));
-    addLanguage({QStringLiteral("nhy")}, QT_TRANSLATE_NOOP("QObject", "Nahuatl, Northern Oaxaca"));
-    //  addLanguage({QStringLiteral("ng")}, QT_TRANSLATE_NOOP("QObject", "Ndonga"));
-    addLanguage({QStringLiteral("nl")}, QT_TRANSLATE_NOOP("QObject", "Dutch"));
-    addLanguage({QStringLiteral("nn")}, QT_TRANSLATE_NOOP("QObject", "Norwegian Nynorsk"));
-    addLanguage({QStringLiteral("no")}, QT_TRANSLATE_NOOP("QObject", "Norwegian"));
-    //  addLanguage({QStringLiteral("nr")}, QT_TRANSLATE_NOOP("QObject", "Ndebele, South"));
-    //  addLanguage({QStringLiteral("nv")}, QT_TRANSLATE_NOOP("QObject", "Navajo"));
-    //  addLanguage({QStringLiteral("ny")}, QT_TRANSLATE_NOOP("QObject", "Chichewa; Nyanja"));
-    //  addLanguage({QStringLiteral("oc")}, QT_TRANSLATE_NOOP("QObject", "Occitan (post 1500); Provençal"));
-    //  addLanguage({QStringLiteral("om")}, QT_TRANSLATE_NOOP("QObject", "Oromo"));
-    //  addLanguage({QStringLiteral("or")}, QT_TRANSLATE_NOOP("QObject", "Oriya"));
-    //  addLanguage({QStringLiteral("os")}, QT_TRANSLATE_NOOP("QObject", "Ossetian; Ossetic"));
-    addLanguage({QStringLiteral("otq")}, QT_TRANSLATE_NOOP("QObject", "Otomi, Quer\u00e9taro"));
-    //  addLanguage({QStringLiteral("pa")}, QT_TRANSLATE_NOOP("QObject", "Panjabi"));
-    addLanguage({QStringLiteral("pap")}, QT_TRANSLATE_NOOP("QObject", "Papiamento"));
-    //  addLanguage({QStringLiteral("pi")}, QT_TRANSLATE_NOOP("QObject", "Pali"));
-    addLanguage({QStringLiteral("pl")}, QT_TRANSLATE_NOOP("QObject", "Polish"));
-    addLanguage({QStringLiteral("pot")}, QT_TRANSLATE_NOOP("QObject", "Potawatomi"));
-    addLanguage({QStringLiteral("ppk")}, QT_TRANSLATE_NOOP("QObject", "Uma"));
-    addLanguage({QStringLiteral("prs")}, QT_TRANSLATE_NOOP("QObject", "Persian (Dari)"));
-    //  addLanguage({QStringLiteral("ps")}, QT_TRANSLATE_NOOP("QObject", "Pushto"));
-    addLanguage({QStringLiteral("pt")}, QT_TRANSLATE_NOOP("QObject", "Portuguese"));
-    addLanguage({QStringLiteral("pt-BR")}, QT_TRANSLATE_NOOP("QObject", "Brazilian Portuguese"));
-    //  addLanguage({QStringLiteral("qu")}, QT_TRANSLATE_NOOP("QObject", "Quechua"));
-    addLanguage({QStringLiteral("qut")}, QT_TRANSLATE_NOOP("QObject", "Quich\u00e9, West Central"));
-    //  addLanguage({QStringLiteral("rm")}, QT_TRANSLATE_NOOP("QObject", "Raeto-Romance"));
-    //  addLanguage({QStringLiteral("rn")}, QT_TRANSLATE_NOOP("QObject", "Rundi"));
-    addLanguage({QStringLiteral("ro")}, QT_TRANSLATE_NOOP("QObject", "Romanian"));
-    addLanguage({QStringLiteral("ru")}, QT_TRANSLATE_NOOP("QObject", "Russian"));
-    //  addLanguage({QStringLiteral("rw")}, QT_TRANSLATE_NOOP("QObject", "Kinyarwanda"));
-    //  addLanguage({QStringLiteral("sa")}, QT_TRANSLATE_NOOP("QObject", "Sanskrit"));
-    //  addLanguage({QStringLiteral("sc")}, QT_TRANSLATE_NOOP("QObject", "Sardinian"));
-    addLanguage({QStringLiteral("sco")}, QT_TRANSLATE_NOOP("QObject", "Scots"));
-    //  addLanguage({QStringLiteral("sd")}, QT_TRANSLATE_NOOP("QObject", "Sindhi"));
-    //  addLanguage({QStringLiteral("se")}, QT_TRANSLATE_NOOP("QObject", "Northern Sami"));
-    //  addLanguage({QStringLiteral("sg")}, QT_TRANSLATE_NOOP("QObject", "Sango"));
-    //  addLanguage({QStringLiteral("si")}, QT_TRANSLATE_NOOP("QObject", "Sinhalese"));
-    addLanguage({QStringLiteral("sk")}, QT_TRANSLATE_NOOP("QObject", "Slovak"));
-    addLanguage({QStringLiteral("sl")}, QT_TRANSLATE_NOOP("QObject", "Slovenian"));
-    //  addLanguage({QStringLiteral("sm")}, QT_TRANSLATE_NOOP("QObject", "Samoan"));
-    //  addLanguage({QStringLiteral("sn")}, QT_TRANSLATE_NOOP("QObject", "Shona"));
-    addLanguage({QStringLiteral("so")}, QT_TRANSLATE_NOOP("QObject", "Somali"));
-    addLanguage({QStringLiteral("sq")}, QT_TRANSLATE_NOOP("QObject", "Albanian"));
-    //  addLanguage({QStringLiteral("sr")}, QT_TRANSLATE_NOOP("QObject", "Serbian"));
-    addLanguage({QStringLiteral("srn")}, QT_TRANSLATE_NOOP("QObject", "Sranan"));
-    //  addLanguage({QStringLiteral("ss")}, QT_TRANSLATE_NOOP("QObject", "Swati"));
-    //  addLanguage({QStringLiteral("st")}, QT_TRANSLATE_NOOP("QObject", "Sotho, Southern"));
-    //  addLanguage({QStringLiteral("su")}, QT_TRANSLATE_NOOP("QObject", "Sundanese"));
-    addLanguage({QStringLiteral("sv")}, QT_TRANSLATE_NOOP("QObject", "Swedish"));
-    addLanguage({QStringLiteral("sw")}, QT_TRANSLATE_NOOP("QObject", "Swahili"));
-    addLanguage({QStringLiteral("syr")}, QT_TRANSLATE_NOOP("QObject", "Syriac"));
-    addLanguage({QStringLiteral("ta")}, QT_TRANSLATE_NOOP("QObject", "Tamil"));
-    //  addLanguage({QStringLiteral("te")}, QT_TRANSLATE_NOOP("QObject", "Telugu"));
-    //  addLanguage({QStringLiteral("tg")}, QT_TRANSLATE_NOOP("QObject", "Tajik"));
-    addLanguage({QStringLiteral("th")}, QT_TRANSLATE_NOOP("QObject", "Thai"));
-    //  addLanguage({QStringLiteral("tk")}, QT_TRANSLATE_NOOP("QObject", "Turkmen"));
-    addLanguage({QStringLiteral("tl")}, QT_TRANSLATE_NOOP("QObject", "Tagalog"));
-    addLanguage({QStringLiteral("tlh")}, QT_TRANSLATE_NOOP("QObject", "Klingon"));
-    addLanguage({QStringLiteral("tn")}, QT_TRANSLATE_NOOP("QObject", "Tswana"));
-    addLanguage({QStringLiteral("tr")}, QT_TRANSLATE_NOOP("QObject", "Turkish"));
-    //  addLanguage({QStringLiteral("ts")}, QT_TRANSLATE_NOOP("QObject", "Tsonga"));
-    //  addLanguage({QStringLiteral("tt")}, QT_TRANSLATE_NOOP("QObject", "Tatar"));
-    addLanguage({QStringLiteral("ttc")}, QT_TRANSLATE_NOOP("QObject", "Tektiteko"));
-    //  addLanguage({QStringLiteral("tw")}, QT_TRANSLATE_NOOP("QObject", "Twi"));
-    addLanguage({QStringLiteral("ty")}, QT_TRANSLATE_NOOP("QObject", "Tahitian"));
-    addLanguage({QStringLiteral("tzz")}, QT_TRANSLATE_NOOP("QObject", "Tzotzil, Zinacant\u00e1n"));
-    //  addLanguage({QStringLiteral("ug")}, QT_TRANSLATE_NOOP("QObject", "Uighur"));
-    addLanguage({QStringLiteral("uk")}, QT_TRANSLATE_NOOP("QObject", "Ukrainian"));
-    //  addLanguage({QStringLiteral("ur")}, QT_TRANSLATE_NOOP("QObject", "Urdu"));
-    addLanguage({QStringLiteral("ury")}, QT_TRANSLATE_NOOP("QObject", "Orya"));
-    addLanguage({QStringLiteral("usp")}, QT_TRANSLATE_NOOP("QObject", "Uspanteco"));
-    //  addLanguage({QStringLiteral("uz")}, QT_TRANSLATE_NOOP("QObject", "Uzbek"));
-    addLanguage({QStringLiteral("vi")}, QT_TRANSLATE_NOOP("QObject", "Vietnamese"));
-    //  addLanguage({QStringLiteral("vo")}, QT_TRANSLATE_NOOP("QObject", "Volapük"));
-    //  addLanguage({QStringLiteral("wo")}, QT_TRANSLATE_NOOP("QObject", "Wolof"));
-    addLanguage({QStringLiteral("xh")}, QT_TRANSLATE_NOOP("QObject", "Xhosa"));
-    addLanguage({QStringLiteral("xtd")}, QT_TRANSLATE_NOOP("QObject", "Mixtec, Diuxi-Tilantongo"));
-    addLanguage({QStringLiteral("yi")}, QT_TRANSLATE_NOOP("QObject", "Yiddish"));
-    addLanguage({QStringLiteral("yo")}, QT_TRANSLATE_NOOP("QObject", "Yoruba"));
-    //  addLanguage({QStringLiteral("za")}, QT_TRANSLATE_NOOP("QObject", "Zhuang"));
-    addLanguage({QStringLiteral("zab")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, San Juan Guelav\u00eda"));
-    addLanguage({QStringLiteral("zaw")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Mitla"));
-    addLanguage({QStringLiteral("zh")}, QT_TRANSLATE_NOOP("QObject", "Chinese"));
-    addLanguage({QStringLiteral("zpo")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Amatl\u00e1n"));
-    addLanguage({QStringLiteral("zpq")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Zoogocho"));
-    addLanguage({QStringLiteral("zpu")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Yal\u00e1lag"));
-    addLanguage({QStringLiteral("zpv")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Chichicapan"));
-    addLanguage({QStringLiteral("zsr")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Southern Rincon"));
-    addLanguage({QStringLiteral("ztq")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Quioquitani-Quier\u00ed"));
-    addLanguage({QStringLiteral("zty")}, QT_TRANSLATE_NOOP("QObject", "Zapotec, Yatee"));
-    addLanguage({QStringLiteral("zu")}, QT_TRANSLATE_NOOP("QObject", "Zulu"));
+    auto const & known = knownLanguages[index];
+    QStringList abbrevs;
+    for (auto const * const abbrev : known.abbrevs)
+        if (abbrev)
+            abbrevs.append(QString::fromLatin1(abbrev));
+    return std::make_shared<Language>(std::move(abbrevs),
+                                      QString::fromUtf8(known.englishName));
 }
 
 } // anonymous namespace
@@ -329,15 +398,28 @@ QString Language::translatedName() const
 std::shared_ptr<Language const> Language::fromAbbrev(QString const & abbrev) {
     BT_ASSERT(!abbrev.contains('_')); // Weak check for certain BCP 47 bugs
 
-    static LanguageMap languageMap;
+    // Guards both the known and the other languages resolved so far:
+    static std::mutex languagesMutex;
+    static std::array<std::shared_ptr<Language const>, numKnownLanguages>
+            knownLanguageObjects;
+    static QHash<QString, std::shared_ptr<Language const>> swordLanguages;
+
+    auto const knownIndex =
+            abbrev.isEmpty()
+            ? findKnownLanguage(QStringLiteral("en"))
+            : findKnownLanguage(abbrev);
+    BT_ASSERT(knownIndex || !abbrev.isEmpty());
 
-    BT_ASSERT(languageMap.contains(QStringLiteral("en")));
-    static auto const defaultLanguage = *languageMap.find(QStringLiteral("en"));
-    if (abbrev.isEmpty())
-        return defaultLanguage;
+    std::lock_guard<std::mutex> const guard(languagesMutex);
+    if (knownIndex) {
+        auto & language = knownLanguageObjects[*knownIndex];
+        if (!language)
+            language = createKnownLanguage(*knownIndex);
+        return language;
+    }
 
-    auto it(languageMap.find(abbrev));
-    if (it != languageMap.constEnd())
+    if (auto const it = swordLanguages.constFind(abbrev);
+        it != swordLanguages.constEnd())
         return *it;
 
     struct SwordLanguage: Language {
@@ -395,6 +477,6 @@ std::shared_ptr<Language const> Language::fromAbbrev(QString const & abbrev) {
     }; // struct SwordLanguage
 
     auto newLang = std::make_shared<SwordLanguage>(QStringList{abbrev}, abbrev);
-    languageMap.insert(abbrev, newLang);
+    swordLanguages.insert(abbrev, newLang);
     return newLang;
 }
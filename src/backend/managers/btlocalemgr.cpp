@@ -12,21 +12,175 @@
 
 #include "btlocalemgr.h"
 
+#include <iterator>
+#include <list>
+#include <mutex>
 #include <QByteArray>
-#include "../../util/btassert.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QStringList>
 
 // Sword includes:
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wextra-semi"
 #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
 #include <localemgr.h>
+#include <swbuf.h>
+#include <swconfig.h>
+#include <swlocale.h>
+#include <swmgr.h>
 #pragma GCC diagnostic pop
 
 namespace {
 
+using LocaleFiles = std::map<sword::SWBuf, std::vector<sword::SWBuf>>;
+
+/**
+  \returns the value of Name in the [Meta] section of the given locale file
+           without parsing the rest of the file.
+*/
+QByteArray localeName(QString const & fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    bool inMeta = false;
+    while (!file.atEnd()) {
+        auto const line = file.readLine().trimmed();
+        if (line.startsWith('[')) {
+            inMeta = (line == "[Meta]");
+        } else if (inMeta && line.startsWith("Name")) {
+            auto const value = line.mid(4).trimmed();
+            if (value.startsWith('='))
+                return value.mid(1).trimmed();
+        }
+    }
+    return {};
+}
+
+void addLocaleFiles(LocaleFiles & localeFiles, QString const & path) {
+    QDir const dir(path);
+    for (auto const & entry
+         : dir.entryList({QStringLiteral("*.conf")}, QDir::Files, QDir::Name))
+    {
+        auto const fileName = dir.absoluteFilePath(entry);
+        auto const name = localeName(fileName);
+        if (!name.isEmpty())
+            localeFiles[name.constData()].emplace_back(
+                    fileName.toLocal8Bit().constData());
+    }
+}
+
+/**
+  \returns the locale files in the locales.d directories Sword would load
+           them from, by the names of the locales.
+*/
+LocaleFiles findLocaleFiles() {
+    char configType = 0;
+    char * prefixPath = nullptr;
+    char * configPath = nullptr;
+    std::list<sword::SWBuf> augPaths;
+    sword::SWConfig * sysConf = nullptr;
+    sword::SWMgr::findConfig(&configType,
+                             &prefixPath,
+                             &configPath,
+                             &augPaths,
+                             &sysConf);
+
+    LocaleFiles r;
+    if (prefixPath) {
+        // Like sword::LocaleMgr, take a sword.conf in the path as the base:
+        QString const base =
+                (configType == 2)
+                ? QFileInfo(QString::fromLocal8Bit(configPath)).path()
+                : QString::fromLocal8Bit(prefixPath);
+        addLocaleFiles(r, QDir(base).filePath(QStringLiteral("locales.d")));
+    }
+    if (configType != 1)
+        for (auto const & augPath : augPaths)
+            addLocaleFiles(r,
+                           QDir(QString::fromLocal8Bit(augPath.c_str()))
+                               .filePath(QStringLiteral("locales.d")));
+
+    delete[] prefixPath;
+    delete[] configPath;
+    delete sysConf;
+    return r;
+}
+
+/**
+  Sword's locale manager parses all locale files when constructed, whereas a
+  session uses only a few of them. This manager only finds the files of the
+  locales and parses them when they are requested.
+*/
 struct BtLocaleMgrImpl final: public sword::LocaleMgr {
 
-    friend sword::LocaleMap const & ::BtLocaleMgr::internalSwordLocales();
+    /* The base class parses all files in the given directory, hence it is
+       given none: */
+    BtLocaleMgrImpl()
+        : sword::LocaleMgr("")
+        , m_localeFiles(findLocaleFiles())
+    {}
+
+    sword::SWLocale * getLocale(char const * name) override {
+        std::lock_guard const guard(m_mutex);
+        if (!loadLocale(name))
+            loadLocale(sword::SWLocale::DEFAULT_LOCALE_NAME);
+        return sword::LocaleMgr::getLocale(name);
+    }
+
+    std::list<sword::SWBuf> getAvailableLocales() override {
+        std::list<sword::SWBuf> r;
+        for (auto const & [name, files] : m_localeFiles)
+            r.emplace_back(name);
+        return r;
+    }
+
+    void setDefaultLocaleName(char const * name) override {
+        /* The base class looks up the locale without encoding and modifier,
+           and the one without country: */
+        static auto const chop =
+                [](QByteArray & str, char const separator) {
+                    if (auto const i = str.indexOf(separator); i >= 0)
+                        str.truncate(i);
+                };
+        QByteArray language(name);
+        chop(language, '.');
+        chop(language, '@');
+
+        std::lock_guard const guard(m_mutex);
+        loadLocale(language.constData());
+        chop(language, '_');
+        loadLocale(language.constData());
+        sword::LocaleMgr::setDefaultLocaleName(name);
+    }
+
+    /**
+      \returns whether the locale of the given name is available, parsing it
+               if it has not been parsed yet.
+    */
+    bool loadLocale(char const * name) {
+        if (locales->find(name) != locales->end())
+            return true;
+        auto const it = m_localeFiles.find(name);
+        if (it == m_localeFiles.end())
+            return false;
+
+        // Like sword::LocaleMgr, merge locales with the same name:
+        auto * const locale = new sword::SWLocale(it->second.front().c_str());
+        for (auto i = std::next(it->second.begin()); i != it->second.end();
+             ++i)
+        {
+            sword::SWLocale other(i->c_str());
+            *locale += other;
+        }
+        locales->emplace(it->first, locale);
+        return true;
+    }
+
+    LocaleFiles const m_localeFiles;
+    std::mutex m_mutex;
 
 };
 
@@ -45,11 +199,8 @@ BtLocaleMgrImpl & btLocaleMgrInstance() {
 
 } // anonymous namespace
 
-auto BtLocaleMgr::internalSwordLocales() -> sword::LocaleMap const & {
-    auto const & btLocaleMgr = btLocaleMgrInstance();
-    BT_ASSERT(btLocaleMgr.locales);
-    return *btLocaleMgr.locales;
-}
+auto BtLocaleMgr::internalSwordLocales() -> LocaleFiles const &
+{ return btLocaleMgrInstance().m_localeFiles; }
 
 sword::SWLocale * BtLocaleMgr::localeTranslator()
 { return btLocaleMgrInstance().getLocale("locales"); }
@@ -14,6 +14,7 @@
 
 #include <map>
 #include <QString>
+#include <vector>
 
 
 namespace sword {
@@ -22,10 +23,19 @@ class SWLocale;
 } // namespace sword
 
 
-/** An interface replacement for sword::LocaleMgr. */
+/**
+  An interface replacement for sword::LocaleMgr. The locales are parsed only
+  when they are used for the first time.
+*/
 namespace BtLocaleMgr {
 
-std::map<sword::SWBuf, sword::SWLocale *> const & internalSwordLocales();
+/**
+  \returns the names of the available Sword locales mapped to the paths of
+           their files, without parsing the locales.
+*/
+std::map<sword::SWBuf, std::vector<sword::SWBuf>> const &
+internalSwordLocales();
+
 sword::SWLocale * localeTranslator();
 QString defaultLocaleName();
 void setDefaultLocaleName(QString const & localeName);
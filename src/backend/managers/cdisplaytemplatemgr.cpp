@@ -13,19 +13,24 @@
 #include "cdisplaytemplatemgr.h"
 
 #include <algorithm>
+#include <iterator>
 #include <QDir>
 #include <QFile>
-#include <QFileInfo>
 #include <QFont>
 #include <QIODevice>
 #include <QObject>
 #include <QStringList>
+#include <QStringView>
 #include <QTextStream>
+#include <utility>
 #include "../../util/btassert.h"
+#include "../../util/bttrace.h"
 #include "../../util/directory.h"
+#include "../bttaskscheduler.h"
 #include "../config/btconfig.h"
 #include "../drivers/btmodulelist.h"
 #include "../drivers/cswordmoduleinfo.h"
+#include "colormanager.h"
 #include "cswordbackend.h"
 
 
@@ -44,8 +49,11 @@ auto const defaultTemplateName = QStringLiteral("Blue.css");
 
 CDisplayTemplateMgr * CDisplayTemplateMgr::m_instance = nullptr;
 
-CDisplayTemplateMgr::CDisplayTemplateMgr(QString & errorMessage) :
-    m_multiModuleHeaders(true) {
+CDisplayTemplateMgr::CDisplayTemplateMgr(QString & errorMessage)
+    : m_multiModuleHeaders(true)
+    , m_displayTemplatesPath(
+          util::directory::getDisplayTemplatesDir().absolutePath())
+{
     BT_ASSERT(!m_instance);
     m_instance = this;
 
@@ -55,62 +63,62 @@ CDisplayTemplateMgr::CDisplayTemplateMgr(QString & errorMessage) :
         const QDir & td = DU::getDisplayTemplatesDir(); // Global template directory
         const QDir & utd = DU::getUserDisplayTemplatesDir(); // User template directory
 
-        // Load regular templates:
-        {
-            const QStringList filter(QStringLiteral("*.tmpl"));
-            // Preload global display templates from disk:
-            for (auto const & file : td.entryList(filter, readableFileFilter))
-                loadTemplate(td.canonicalPath() + '/' + file);
-            // Preload user display templates from disk:
-            for (auto const & file : utd.entryList(filter, readableFileFilter))
-                loadTemplate(utd.canonicalPath() + '/' + file);
-        }
-
-        if (!m_templateMap.contains(CSSTEMPLATEBASE)) {
-            errorMessage = QObject::tr("CSS base template not found!");
-            return;
-        }
+        /* Only record the templates here, since usually just the active one
+           is ever filled. User templates override global ones: */
+        const QStringList filter{QStringLiteral("*.tmpl"),
+                                 QStringLiteral("*.css")};
+        for (auto const * const dir : {&td, &utd})
+            for (auto const & file : dir->entryList(filter, readableFileFilter))
+                m_templateFiles.insert(file, dir->canonicalPath() + '/' + file);
+    }
 
-        // Load CSS templates:
-        {
-            const QStringList cssfilter(QStringLiteral("*.css"));
-            // Load global app stylesheets
-            for (auto const & file : td.entryList(cssfilter, readableFileFilter))
-                loadCSSTemplate(td.canonicalPath() + '/' + file);
-            // Load user app stylesheets
-            for (auto const & file : utd.entryList(cssfilter, readableFileFilter))
-                loadCSSTemplate(utd.canonicalPath() + '/' + file);
-        }
+    if (!m_templateFiles.contains(CSSTEMPLATEBASE)) {
+        errorMessage = QObject::tr("CSS base template not found!");
+        return;
     }
 
-    if (!m_cssMap.contains(defaultTemplateName)) {
+    if (!m_templateFiles.contains(defaultTemplateName)) {
         errorMessage = QObject::tr("Default template \"%1\" not found!")
                        .arg(defaultTemplateName);
         return;
     }
 
     // Create template names cache:
-    m_availableTemplateNamesCache = m_templateMap.keys();
+    m_availableTemplateNamesCache = m_templateFiles.keys();
     const bool b = m_availableTemplateNamesCache.removeOne(CSSTEMPLATEBASE);
     BT_ASSERT(b);
-    m_availableTemplateNamesCache.append(m_cssMap.keys());
     std::sort(m_availableTemplateNamesCache.begin(),
               m_availableTemplateNamesCache.end());
 
+    // Have the active template ready by the time the first text is rendered:
+    prefetchTemplate(activeTemplateName());
+
     errorMessage = QString();
 }
 
+CDisplayTemplateMgr::~CDisplayTemplateMgr() {
+    // The prefetching tasks refer to this object:
+    decltype(m_prefetchTasks) tasks;
+    {
+        std::lock_guard<std::mutex> const guard(m_templatesMutex);
+        tasks.swap(m_prefetchTasks);
+    }
+    for (auto const & task : tasks)
+        task->cancel();
+    for (auto const & task : tasks)
+        task->wait();
+    m_instance = nullptr;
+}
+
 QString CDisplayTemplateMgr::fillTemplate(const QString & name,
                                           const QString & content,
                                           const Settings & settings) const
 {
+    BT_TRACE_SPAN("fill template");
     BT_ASSERT(name != CSSTEMPLATEBASE);
     BT_ASSERT(name.endsWith(QStringLiteral(".css"))
               || name.endsWith(QStringLiteral(".tmpl")));
-    BT_ASSERT(!name.endsWith(QStringLiteral(".css"))
-              || m_cssMap.contains(name));
-    BT_ASSERT(!name.endsWith(QStringLiteral(".tmpl"))
-              || m_templateMap.contains(name));
+    BT_ASSERT(m_templateFiles.contains(name));
     const bool templateIsCss = name.endsWith(QStringLiteral(".css"));
 
     QString displayTypeString;
@@ -162,6 +170,100 @@ QString CDisplayTemplateMgr::fillTemplate(const QString & name,
                      .arg(header, content);
     }
 
+    auto const langCSS(languageCss());
+    QString const pageDirection(
+                QString::fromLatin1(settings.textDirectionAsHtmlDirAttr()));
+    auto const bodyClasses(QStringLiteral("%1 %1_%2").arg(displayTypeString,
+                                                          moduleName));
+    static auto const themeStyleMarker = QStringLiteral("#THEME_STYLE#");
+    auto const themeStyle(templateIsCss ? loadCSSTemplate(name)
+                                        : themeStyleMarker);
+
+    auto const slotValue =
+            [&](Slot const slot) -> QString const * {
+                switch (slot) {
+                case Slot::Title: return &settings.title;
+                case Slot::LangAbbrev: return &settings.langAbbrev;
+                case Slot::DisplayType: return &displayTypeString;
+                case Slot::LangCss: return &langCSS;
+                case Slot::PageDirection: return &pageDirection;
+                case Slot::Content: return &newContent;
+                case Slot::BodyClasses: return &bodyClasses;
+                case Slot::DisplayTemplatesPath:
+                    return &m_displayTemplatesPath;
+                case Slot::ThemeStyle: return &themeStyle;
+                case Slot::None:
+                default: return nullptr;
+                }
+            };
+
+    // Splice the fragments and values into a single allocation:
+    auto const compiled(loadTemplate(templateIsCss
+                                     ? QStringLiteral(CSSTEMPLATEBASE)
+                                     : name));
+    qsizetype size = 0;
+    for (auto const & fragment : *compiled) {
+        size += fragment.literal.size();
+        if (auto const * const value = slotValue(fragment.slot))
+            size += value->size();
+    }
+    QString output;
+    output.reserve(size);
+    for (auto const & fragment : *compiled) {
+        output.append(fragment.literal);
+        if (auto const * const value = slotValue(fragment.slot))
+            output.append(*value);
+    }
+    return output;
+}
+
+CDisplayTemplateMgr::CompiledTemplate
+CDisplayTemplateMgr::compileTemplate(QString const & text) {
+    static std::pair<QString, Slot> const markers[] = {
+        {QStringLiteral("TITLE"), Slot::Title},
+        {QStringLiteral("LANG_ABBREV"), Slot::LangAbbrev},
+        {QStringLiteral("DISPLAYTYPE"), Slot::DisplayType},
+        {QStringLiteral("LANG_CSS"), Slot::LangCss},
+        {QStringLiteral("PAGE_DIRECTION"), Slot::PageDirection},
+        {QStringLiteral("CONTENT"), Slot::Content},
+        {QStringLiteral("BODY_CLASSES"), Slot::BodyClasses},
+        {QStringLiteral("DISPLAY_TEMPLATES_PATH"), Slot::DisplayTemplatesPath},
+        {QStringLiteral("THEME_STYLE"), Slot::ThemeStyle}};
+
+    CompiledTemplate r;
+    qsizetype copied = 0;
+    for (auto pos = text.indexOf('#'); pos >= 0;) {
+        auto const end = text.indexOf('#', pos + 1);
+        if (end < 0)
+            break;
+        auto const marker(QStringView(text).sliced(pos + 1, end - pos - 1));
+        auto const it =
+                std::find_if(std::begin(markers),
+                             std::end(markers),
+                             [&marker](std::pair<QString, Slot> const & m)
+                             { return m.first == marker; });
+        if (it == std::end(markers)) {
+            pos = end; // The closing '#' might start a marker
+            continue;
+        }
+        r.emplace_back(Fragment{text.mid(copied, pos - copied), it->second});
+        copied = end + 1;
+        pos = text.indexOf('#', copied);
+    }
+    r.emplace_back(Fragment{text.mid(copied), Slot::None});
+    return r;
+}
+
+QString CDisplayTemplateMgr::languageCss() const {
+    auto availableLanguages = CSwordBackend::instance().availableLanguages();
+    BT_ASSERT(availableLanguages);
+    auto const fontGeneration = btConfig().fontGeneration();
+
+    std::lock_guard<std::mutex> const guard(m_languageCssMutex);
+    if (m_languageCssLanguages == availableLanguages
+        && m_languageCssFontGeneration == fontGeneration)
+        return m_languageCss;
+
     QString langCSS;
     {
         const QFont & f = btConfig().getDefaultFont();
@@ -177,83 +279,60 @@ QString CDisplayTemplateMgr::fillTemplate(const QString & name,
                          ? QStringLiteral("italic")
                          : QStringLiteral("normal")));
     }
-    {
-        auto const availableLanguages =
-                CSwordBackend::instance().availableLanguages();
-        BT_ASSERT(availableLanguages);
-        for (auto const & lang : *availableLanguages) {
-            if (lang->abbrev().isEmpty())
-                continue;
-
-            BtConfig::FontSettingsPair fp = btConfig().getFontForLanguage(*lang);
-            if (fp.first) {
-                const QFont & f = fp.second;
-
-                /* QFont::weight() returns an int in the range [0, 99] but CSS
-                   requires a real number in the range [1, 1000]. No extra
-                   checks are needed for floating point precision in the result
-                   range. */
-                auto const fontWeight = 1.0 + (f.weight() * 999.0) / 99.0;
-
-                auto const fontStyleString =
-                        [&f]() {
-                            switch ((int) f.style()) {
-                            case QFont::StyleItalic:
-                                return QStringLiteral("italic");
-                            case QFont::StyleOblique:
-                                return QStringLiteral("oblique");
-                            case QFont::StyleNormal:
-                            default:
-                                return QStringLiteral("normal");
-                            }
-                        }();
-
-                auto const textDecorationString =
-                        f.underline()
-                        ? (f.strikeOut()
-                           ? QStringLiteral("underline line-through")
-                           : QStringLiteral("underline"))
-                        : (f.strikeOut()
-                           ? QStringLiteral("line-through")
-                           : QStringLiteral("none"));
-
-                /// \todo Add support translating more QFont properties to CSS.
-
-                langCSS.append(
-                            QStringLiteral("*[lang=%1]{font-family:%2;"
-                                           "font-size:%3pt;font-weight:%4;"
-                                           "font-style:%5;text-decoration:%6}")
-                            .arg(lang->abbrev(),
-                                 f.family(),
-                                 QString::number(f.pointSizeF(), 'f'),
-                                 QString::number(fontWeight),
-                                 fontStyleString,
-                                 textDecorationString));
-            }
+    for (auto const & lang : *availableLanguages) {
+        if (lang->abbrev().isEmpty())
+            continue;
+
+        BtConfig::FontSettingsPair fp = btConfig().getFontForLanguage(*lang);
+        if (fp.first) {
+            const QFont & f = fp.second;
+
+            /* QFont::weight() returns an int in the range [0, 99] but CSS
+               requires a real number in the range [1, 1000]. No extra checks
+               are needed for floating point precision in the result range. */
+            auto const fontWeight = 1.0 + (f.weight() * 999.0) / 99.0;
+
+            auto const fontStyleString =
+                    [&f]() {
+                        switch ((int) f.style()) {
+                        case QFont::StyleItalic:
+                            return QStringLiteral("italic");
+                        case QFont::StyleOblique:
+                            return QStringLiteral("oblique");
+                        case QFont::StyleNormal:
+                        default:
+                            return QStringLiteral("normal");
+                        }
+                    }();
+
+            auto const textDecorationString =
+                    f.underline()
+                    ? (f.strikeOut()
+                       ? QStringLiteral("underline line-through")
+                       : QStringLiteral("underline"))
+                    : (f.strikeOut()
+                       ? QStringLiteral("line-through")
+                       : QStringLiteral("none"));
+
+            /// \todo Add support translating more QFont properties to CSS.
+
+            langCSS.append(
+                        QStringLiteral("*[lang=%1]{font-family:%2;"
+                                       "font-size:%3pt;font-weight:%4;"
+                                       "font-style:%5;text-decoration:%6}")
+                        .arg(lang->abbrev(),
+                             f.family(),
+                             QString::number(f.pointSizeF(), 'f'),
+                             QString::number(fontWeight),
+                             fontStyleString,
+                             textDecorationString));
         }
     }
 
-    namespace DU = util::directory;
-    QString output(m_templateMap[templateIsCss
-                                 ? QString(CSSTEMPLATEBASE)
-                                 : name]); // don't change the map's content directly, use a copy
-    output.replace(QStringLiteral("#TITLE#"), settings.title)
-          .replace(QStringLiteral("#LANG_ABBREV#"), settings.langAbbrev)
-          .replace(QStringLiteral("#DISPLAYTYPE#"), displayTypeString)
-          .replace(QStringLiteral("#LANG_CSS#"), langCSS)
-          .replace(QStringLiteral("#PAGE_DIRECTION#"),
-                   settings.textDirectionAsHtmlDirAttr())
-          .replace(QStringLiteral("#CONTENT#"), newContent)
-          .replace(QStringLiteral("#BODY_CLASSES#"),
-                   QStringLiteral("%1 %1_%2").arg(displayTypeString,
-                                                  moduleName))
-          .replace(QStringLiteral("#DISPLAY_TEMPLATES_PATH#"),
-                   DU::getDisplayTemplatesDir().absolutePath());
-
-    if (templateIsCss)
-        output.replace(QStringLiteral("#THEME_STYLE#"), m_cssMap[name]);
-
-    return output;
+    m_languageCss = langCSS;
+    m_languageCssLanguages = std::move(availableLanguages);
+    m_languageCssFontGeneration = fontGeneration;
+    return langCSS;
 }
 
 QString CDisplayTemplateMgr::activeTemplateName() {
@@ -266,20 +345,71 @@ QString CDisplayTemplateMgr::activeTemplateName() {
            : tn;
 }
 
-void CDisplayTemplateMgr::loadTemplate(const QString & filename) {
-    BT_ASSERT(filename.endsWith(QStringLiteral(".tmpl")));
-    BT_ASSERT(QFileInfo(filename).isFile());
-    const QString templateString = readFileToString(filename);
-    if (!templateString.isEmpty())
-        m_templateMap.insert(QFileInfo(filename).fileName(), templateString);
+void CDisplayTemplateMgr::prefetchTemplate(QString const & name) const {
+    if (!m_templateFiles.contains(name))
+        return;
+    {
+        std::lock_guard<std::mutex> const guard(m_templatesMutex);
+        if (m_templateMap.contains(name) || m_cssMap.contains(name))
+            return;
+        std::erase_if(m_prefetchTasks,
+                      [](std::shared_ptr<BtTaskToken> const & task)
+                      { return task->finished(); });
+    }
+    auto task(
+            BtTaskScheduler::instance().submit(
+                [this, name](BtTaskToken &) {
+                    if (name.endsWith(QStringLiteral(".css"))) {
+                        loadCSSTemplate(name);
+                        loadTemplate(QStringLiteral(CSSTEMPLATEBASE));
+                    } else {
+                        loadTemplate(name);
+                    }
+                },
+                BtTaskScheduler::Priority::Idle));
+    std::lock_guard<std::mutex> const guard(m_templatesMutex);
+    m_prefetchTasks.emplace_back(std::move(task));
+}
+
+CDisplayTemplateMgr::CompiledTemplatePtr
+CDisplayTemplateMgr::loadTemplate(QString const & name) const {
+    BT_ASSERT(name.endsWith(QStringLiteral(".tmpl")));
+    {
+        std::lock_guard<std::mutex> const guard(m_templatesMutex);
+        if (auto const it = m_templateMap.constFind(name);
+            it != m_templateMap.cend())
+            return *it;
+    }
+
+    // Load without the lock held, so that other templates can be filled:
+    auto const fileIt = m_templateFiles.constFind(name);
+    BT_ASSERT(fileIt != m_templateFiles.cend());
+    auto compiled(std::make_shared<CompiledTemplate const>(
+                      compileTemplate(readFileToString(*fileIt))));
+
+    std::lock_guard<std::mutex> const guard(m_templatesMutex);
+    auto & r = m_templateMap[name];
+    if (!r) // Unless loaded by another thread meanwhile
+        r = std::move(compiled);
+    return r;
 }
 
-void CDisplayTemplateMgr::loadCSSTemplate(const QString & filename) {
-    BT_ASSERT(filename.endsWith(QStringLiteral(".css")));
-    const QFileInfo fi(filename);
-    BT_ASSERT(fi.isFile());
-    if (fi.isReadable())
-        m_cssMap.insert(fi.fileName(), readFileToString(filename));
+QString CDisplayTemplateMgr::loadCSSTemplate(QString const & name) const {
+    BT_ASSERT(name.endsWith(QStringLiteral(".css")));
+    {
+        std::lock_guard<std::mutex> const guard(m_templatesMutex);
+        if (auto const it = m_cssMap.constFind(name); it != m_cssMap.cend())
+            return *it;
+    }
+
+    /* The colors of the style sheet do not change at runtime, so replace
+       their markers only once instead of in every filled template: */
+    auto const fileIt = m_templateFiles.constFind(name);
+    BT_ASSERT(fileIt != m_templateFiles.cend());
+    auto css(ColorManager::replaceColors(readFileToString(*fileIt), name));
+
+    std::lock_guard<std::mutex> const guard(m_templatesMutex);
+    return *m_cssMap.insert(name, std::move(css));
 }
 
 void CDisplayTemplateMgr::setMultiModuleHeadersVisible(bool visible) {
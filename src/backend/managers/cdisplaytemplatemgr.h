@@ -12,14 +12,20 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <QHash>
 #include <QString>
 #include <QStringList>
+#include <vector>
 #include "../../util/btassert.h"
 #include "../drivers/btmodulelist.h"
 #include "../drivers/cswordmoduleinfo.h"
 
 
+class BtTaskToken;
+
 /**
   Manages the display templates used in the filters and display classes.
   \note This is a singleton.
@@ -63,6 +69,8 @@ class CDisplayTemplateMgr {
         */
         explicit CDisplayTemplateMgr(QString & errorMessage);
 
+        ~CDisplayTemplateMgr();
+
         /**
           \returns the list of available templates.
         */
@@ -90,6 +98,12 @@ class CDisplayTemplateMgr {
         */
         static QString activeTemplateName();
 
+        /**
+          \brief Loads the given template in the background unless loaded yet,
+                 e.g. because it is likely to be filled next.
+        */
+        void prefetchTemplate(QString const & name) const;
+
         /**
           \returns The singleton instance of the instance of this class.
         */
@@ -104,17 +118,72 @@ class CDisplayTemplateMgr {
         */
         void setMultiModuleHeadersVisible(bool visible);
 
+    private: // types:
+
+        /** The placeholders of a template filled by fillTemplate(). */
+        enum class Slot {
+            None,
+            Title,
+            LangAbbrev,
+            DisplayType,
+            LangCss,
+            PageDirection,
+            Content,
+            BodyClasses,
+            DisplayTemplatesPath,
+            ThemeStyle
+        };
+
+        /** A literal text of a template followed by a placeholder, if any. */
+        struct Fragment {
+            QString literal;
+            Slot slot;
+        };
+
+        /** A template split at its placeholders. */
+        using CompiledTemplate = std::vector<Fragment>;
+        using CompiledTemplatePtr = std::shared_ptr<CompiledTemplate const>;
+
     private: // methods:
 
-        /** Preloads a single template from disk: */
-        void loadTemplate(const QString & filename);
-        void loadCSSTemplate(const QString & filename);
+        static CompiledTemplate compileTemplate(QString const & text);
+
+        /**
+          \returns the style sheet of the fonts of the content and of all
+                   available languages, regenerated only if fonts or languages
+                   changed.
+        */
+        QString languageCss() const;
+
+        /**
+          \returns the given .tmpl template, loaded from disk on first use.
+        */
+        CompiledTemplatePtr loadTemplate(QString const & name) const;
+
+        /**
+          \returns the given .css template with its colors replaced, loaded
+                   from disk on first use.
+        */
+        QString loadCSSTemplate(QString const & name) const;
 
     private: // fields:
 
         bool m_multiModuleHeaders;
-        QHash<QString, QString> m_templateMap;
-        QHash<QString, QString> m_cssMap;
+
+        /** The paths of all templates by name, user templates overriding. */
+        QHash<QString, QString> m_templateFiles;
+
+        mutable std::mutex m_templatesMutex;
+        mutable QHash<QString, CompiledTemplatePtr> m_templateMap;
+        mutable QHash<QString, QString> m_cssMap;
+        mutable std::vector<std::shared_ptr<BtTaskToken>> m_prefetchTasks;
+
+        QString const m_displayTemplatesPath;
+
+        mutable std::mutex m_languageCssMutex;
+        mutable QString m_languageCss;
+        mutable std::shared_ptr<void const> m_languageCssLanguages;
+        mutable std::uint64_t m_languageCssFontGeneration = 0u;
         static CDisplayTemplateMgr * m_instance;
         QStringList m_availableTemplateNamesCache;
 
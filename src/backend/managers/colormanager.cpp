@@ -12,7 +12,10 @@
 
 #include "colormanager.h"
 
+#include <functional>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <QApplication>
 #include <QColor>
 #include <QDir>
@@ -20,9 +23,11 @@
 #include <QPalette>
 #include <QSettings>
 #include <QStringList>
+#include <QStringView>
 #include <QVariant>
 #include <utility>
 #include "../../util/btassert.h"
+#include "../../util/bttrace.h"
 #include "../../util/directory.h"
 #include "../../backend/managers/cdisplaytemplatemgr.h"
 
@@ -36,93 +41,90 @@ bool darkMode() {
             > palette.color(QPalette::Window).value();
 }
 
-using ColorMaps = std::map<QString, std::map<QString, QString> >;
-
-ColorMaps createColorMaps() {
+/* The color maps allow looking up the colors by QStringView, so that the
+   markers need not be copied when replacing them: */
+using ColorMap = std::map<QString, QString, std::less<>>;
+using ColorMaps = std::map<QString, ColorMap>;
+
+ColorMap loadColorMap(QString const & templateName) {
+    // Start with default color map:
+    ColorMap colorMap;
+    auto const p(qApp->palette());
+    if (darkMode()) {
+        colorMap.emplace(QStringLiteral("FOREGROUND_COLOR"),
+                         p.color(QPalette::WindowText).name());
+        colorMap.emplace(QStringLiteral("BACKGROUND_COLOR"),
+                         p.color(QPalette::Base).name());
+        colorMap.emplace(QStringLiteral("HIGHLIGHT"),
+                         QStringLiteral("#ffff00"));
+        colorMap.emplace(QStringLiteral("BACKGROUND_HIGHLIGHT"),
+                         QStringLiteral("#444466"));
+        colorMap.emplace(QStringLiteral("CROSSREF_COLOR"),
+                         QStringLiteral("#aac2ff"));
+        colorMap.emplace(QStringLiteral("JESUS_WORDS_COLOR"),
+                         QStringLiteral("#ff0000"));
+    } else {
+        colorMap.emplace(QStringLiteral("FOREGROUND_COLOR"),
+                         p.color(QPalette::WindowText).name());
+        colorMap.emplace(QStringLiteral("BACKGROUND_COLOR"),
+                         p.color(QPalette::Base).name());
+        colorMap.emplace(QStringLiteral("HIGHLIGHT"),
+                         QStringLiteral("#ffff00"));
+        colorMap.emplace(QStringLiteral("BACKGROUND_HIGHLIGHT"),
+                         QStringLiteral("#ddddff"));
+        colorMap.emplace(QStringLiteral("CROSSREF_COLOR"),
+                         QStringLiteral("#1414ff"));
+        colorMap.emplace(QStringLiteral("JESUS_WORDS_COLOR"),
+                         QStringLiteral("#ff0000"));
+    }
+
+    // The color map is next to the style sheet, user stylesheets first:
     namespace DU = util::directory;
-    QDir::Filters const readableFileFilter(QDir::Files | QDir::Readable);
-    QStringList const cssFilter(QStringLiteral("*.css"));
-
-    ColorMaps colorMaps;
-
-    auto const loadColorMap =
-            [&colorMaps](QString const & filePath) {
-                QFileInfo const cssInfo(filePath);
-                static auto const cMapPathTemplate(
-                            QStringLiteral("%1/%2.cmap"));
-                auto cMapPath(cMapPathTemplate.arg(cssInfo.path())
-                                              .arg(cssInfo.completeBaseName()));
-                QFileInfo const cMapInfo(cMapPath);
-                auto fileName(cssInfo.fileName());
-
-                // Start with default color map:
-                std::map<QString, QString> colorMap;
-                auto const p(qApp->palette());
-                if (darkMode()) {
-                    colorMap.emplace(QStringLiteral("FOREGROUND_COLOR"),
-                                     p.color(QPalette::WindowText).name());
-                    colorMap.emplace(QStringLiteral("BACKGROUND_COLOR"),
-                                     p.color(QPalette::Base).name());
-                    colorMap.emplace(QStringLiteral("HIGHLIGHT"),
-                                     QStringLiteral("#ffff00"));
-                    colorMap.emplace(QStringLiteral("BACKGROUND_HIGHLIGHT"),
-                                     QStringLiteral("#444466"));
-                    colorMap.emplace(QStringLiteral("CROSSREF_COLOR"),
-                                     QStringLiteral("#aac2ff"));
-                    colorMap.emplace(QStringLiteral("JESUS_WORDS_COLOR"),
-                                     QStringLiteral("#ff0000"));
-                } else {
-                    colorMap.emplace(QStringLiteral("FOREGROUND_COLOR"),
-                                     p.color(QPalette::WindowText).name());
-                    colorMap.emplace(QStringLiteral("BACKGROUND_COLOR"),
-                                     p.color(QPalette::Base).name());
-                    colorMap.emplace(QStringLiteral("HIGHLIGHT"),
-                                     QStringLiteral("#ffff00"));
-                    colorMap.emplace(QStringLiteral("BACKGROUND_HIGHLIGHT"),
-                                     QStringLiteral("#ddddff"));
-                    colorMap.emplace(QStringLiteral("CROSSREF_COLOR"),
-                                     QStringLiteral("#1414ff"));
-                    colorMap.emplace(QStringLiteral("JESUS_WORDS_COLOR"),
-                                     QStringLiteral("#ff0000"));
-                }
-
-                if (cMapInfo.exists()) {
-                    QSettings cMapSettings(cMapPath, QSettings::IniFormat);
-                    static auto const dark = QStringLiteral("dark");
-                    static auto const light = QStringLiteral("light");
-                    cMapSettings.beginGroup(darkMode() ? dark : light);
-                    for (auto const & colorKey : cMapSettings.childKeys())
-                        colorMap[colorKey] = cMapSettings.value(colorKey).toString();
-                }
-                colorMaps[std::move(fileName)] = std::move(colorMap);
-            };
-
-    // Load global app stylesheets
-    auto const & td = DU::getDisplayTemplatesDir();
-    for (auto const & file : td.entryList(cssFilter, readableFileFilter))
-        loadColorMap(QStringLiteral("%1/%2").arg(td.canonicalPath(), file));
-
-    // Load user app stylesheets
-    auto const & utd = DU::getUserDisplayTemplatesDir();
-    for (auto const & file : utd.entryList(cssFilter, readableFileFilter))
-        loadColorMap(QStringLiteral("%1/%2").arg(utd.canonicalPath(), file));
-
-    return colorMaps;
+    for (auto const * const dir : {&DU::getUserDisplayTemplatesDir(),
+                                   &DU::getDisplayTemplatesDir()})
+    {
+        QFileInfo const cssInfo(dir->filePath(templateName));
+        if (!cssInfo.isFile())
+            continue;
+        static auto const cMapPathTemplate(QStringLiteral("%1/%2.cmap"));
+        auto const cMapPath(cMapPathTemplate.arg(cssInfo.path())
+                                            .arg(cssInfo.completeBaseName()));
+        if (QFileInfo::exists(cMapPath)) {
+            QSettings cMapSettings(cMapPath, QSettings::IniFormat);
+            static auto const dark = QStringLiteral("dark");
+            static auto const light = QStringLiteral("light");
+            cMapSettings.beginGroup(darkMode() ? dark : light);
+            for (auto const & colorKey : cMapSettings.childKeys())
+                colorMap[colorKey] = cMapSettings.value(colorKey).toString();
+        }
+        break;
+    }
+    return colorMap;
 }
 
-auto const & colorMaps() {
-    static auto const maps = createColorMaps();
-    return maps;
+/**
+  \returns the color map of the given template, which is loaded on first use.
+           Maps are never removed, so the reference stays valid.
+*/
+ColorMap const & templateColorMap(QString const & templateName) {
+    static std::mutex mutex;
+    static ColorMaps maps;
+    {
+        std::lock_guard<std::mutex> const guard(mutex);
+        if (auto const it = maps.find(templateName); it != maps.end())
+            return it->second;
+    }
+    auto map(loadColorMap(templateName));
+    std::lock_guard<std::mutex> const guard(mutex);
+    return maps.try_emplace(templateName, std::move(map)).first->second;
 }
 
 QString getColorByPattern(QString const & pattern, QString const & templateName)
 {
     BT_ASSERT(!templateName.isEmpty());
-    auto const & maps = colorMaps();
-    auto const mapIt(maps.find(templateName));
-    BT_ASSERT(mapIt != maps.end());
-    auto const valueIt(mapIt->second.find(pattern));
-    BT_ASSERT(valueIt != mapIt->second.end());
+    auto const & map = templateColorMap(templateName);
+    auto const valueIt(map.find(pattern));
+    BT_ASSERT(valueIt != map.end());
     BT_ASSERT(!valueIt->second.isEmpty());
     return valueIt->second;
 }
@@ -135,13 +137,60 @@ QString replaceColors(QString content) {
                          CDisplayTemplateMgr::activeTemplateName());
 }
 
-QString replaceColors(QString content, QString const & templateName) {
-    auto const & maps = colorMaps();
-    auto const mapsIt = maps.find(templateName);
-    BT_ASSERT(mapsIt != maps.end());
-    for (auto const & [key, value] : mapsIt->second)
-        content.replace(QStringLiteral("#%1#").arg(key), value);
-    return content;
+QString replaceColors(QString content, QString const & templateName)
+{ return replaceColors(std::move(content), templateName, {}); }
+
+QString replaceColors(QString content, Markers const markers) {
+    return replaceColors(std::move(content),
+                         CDisplayTemplateMgr::activeTemplateName(),
+                         markers);
+}
+
+QString replaceColors(QString content,
+                      QString const & templateName,
+                      Markers const markers)
+{
+    BT_TRACE_SPAN("replace colors");
+    auto const & colorMap = templateColorMap(templateName);
+
+    auto const replacement =
+            [&colorMap, markers](QStringView const name)
+                    -> std::optional<QStringView>
+            {
+                for (auto const & marker : markers)
+                    if (marker.first == name)
+                        return marker.second;
+                auto const it = colorMap.find(name);
+                if (it == colorMap.end())
+                    return {};
+                return QStringView(it->second);
+            };
+
+    // Replace all "#KEY#" markers in a single pass:
+    QString r;
+    qsizetype copied = 0;
+    for (auto pos = content.indexOf('#'); pos >= 0;) {
+        auto const end = content.indexOf('#', pos + 1);
+        if (end < 0)
+            break;
+        auto const value =
+                replacement(QStringView(content).sliced(pos + 1,
+                                                        end - pos - 1));
+        if (!value) {
+            pos = end; // The closing '#' might start a marker
+            continue;
+        }
+        if (r.isNull())
+            r.reserve(content.size());
+        r.append(QStringView(content).sliced(copied, pos - copied))
+         .append(*value);
+        copied = end + 1;
+        pos = content.indexOf('#', copied);
+    }
+    if (!copied)
+        return content;
+    r.append(QStringView(content).sliced(copied));
+    return r;
 }
 
 QString getBackgroundColor()
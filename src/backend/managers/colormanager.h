@@ -12,13 +12,29 @@
 
 #pragma once
 
+#include <initializer_list>
 #include <QString>
+#include <QStringView>
+#include <utility>
 
 
 namespace ColorManager {
 
+/** The names of additional "#NAME#" markers and their replacements. */
+using Markers = std::initializer_list<std::pair<QStringView, QStringView>>;
+
 QString replaceColors(QString content);
 QString replaceColors(QString content, QString const & templateName);
+
+/**
+  \brief Replaces the color markers like replaceColors(content) and in the
+         same pass the given additional markers.
+*/
+QString replaceColors(QString content, Markers markers);
+QString replaceColors(QString content,
+                      QString const & templateName,
+                      Markers markers);
+
 QString getBackgroundColor();
 QString getBackgroundColor(QString const & templateName);
 QString getBackgroundHighlightColor();
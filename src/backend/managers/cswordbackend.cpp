@@ -12,18 +12,36 @@
 
 #include "cswordbackend.h"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QMetaObject>
 #include <QSet>
+#include <QTimer>
 #include <QString>
 #include <QStringDecoder>
+#include <QThread>
 #include <string_view>
+#include <utility>
+#include <vector>
 #include "../../util/btconnect.h"
+#include "../../util/btstartupprofile.h"
 #include "../../util/directory.h"
+#include "../btentrywritejournal.h"
 #include "../btglobal.h"
+#include "../btheadwordindex.h"
+#include "../btindexingscheduler.h"
 #include "../btinstallmgr.h"
+#include "../btlexiconcachebuilder.h"
+#include "../btrawentrycache.h"
+#include "../btsearchthread.h"
 #include "../config/btconfig.h"
+#include "../config/bthistorystore.h"
 #include "../drivers/cswordbiblemoduleinfo.h"
 #include "../drivers/cswordbookmoduleinfo.h"
 #include "../drivers/cswordcommentarymoduleinfo.h"
@@ -45,13 +63,61 @@
 #include <swfilter.h>
 #include <swversion.h>
 #include <utilstr.h>
+#include <versificationmgr.h>
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif
 #pragma GCC diagnostic pop
 
+#ifndef Q_OS_WIN
+#include <sys/resource.h>
+#endif
+
+
+namespace {
+
+/**
+  \brief Sets up the state of Sword shared by all backends before any files of
+         modules are opened, see CSwordBackend::lockSwordFiles().
+*/
+void prepareSwordFiles() {
+    /* Sword creates its other process wide managers lazily, hence create them
+       before any worker thread might: */
+    sword::VersificationMgr::getSystemVersificationMgr();
+    BtLocaleMgr::defaultLocaleName();
+
+    /* Never close the files of other modules to open another one, since other
+       threads might read from them without the lock: */
+    sword::FileMgr::getSystemFileMgr()->maxFiles =
+            std::numeric_limits<int>::max();
+
+#ifndef Q_OS_WIN
+    // Allow as many open files as the system does instead:
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0
+        && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+}
+
+/** \returns whether the given modules have the same configuration. */
+bool sameConfig(sword::SWModule const & a, sword::SWModule const & b) {
+    auto const & configA = a.getConfig();
+    auto const & configB = b.getConfig();
+    return std::equal(configA.begin(),
+                      configA.end(),
+                      configB.begin(),
+                      configB.end());
+}
+
+} // anonymous namespace
 
 CSwordBackend * CSwordBackend::m_instance = nullptr;
+std::shared_ptr<CSwordBackend::ModuleSettings const>
+        CSwordBackend::m_moduleSettings;
 
 CSwordBackend::CSwordBackend()
         : m_manager(nullptr, nullptr, false,
@@ -69,10 +135,61 @@ CSwordBackend::CSwordBackend()
                clearCache);
     BT_CONNECT(m_dataModel.get(), &BtBookshelfModel::rowsAboutToBeRemoved,
                clearCache);
+    connectModuleLookup();
 
     setBooknameLanguage(btConfig().booknameLanguage());
+    CSwordModuleInfo::recoverIndexDirectories();
+    CSwordModuleInfo::loadIndexStates();
     initModules();
-    deleteOrphanedIndices();
+
+    /* Probing the indices of all modules is slow, so do it in the background
+       once the event loop runs, i.e. after the main window is shown: */
+    QTimer::singleShot(0, this, &CSwordBackend::deleteOrphanedIndices);
+    QTimer::singleShot(std::chrono::seconds(5),
+                       this,
+                       &CSwordBackend::prewarmIndices);
+
+    /* Optionally release the data kept in memory for modules which were not
+       used for the configured number of minutes: */
+    if (auto const idleMinutes =
+                btConfig().value<int>(
+                    QStringLiteral(
+                        "settings/behaviour/releaseIdleModulesMinutes"),
+                    0);
+        idleMinutes > 0)
+    {
+        auto * const timer = new QTimer(this);
+        BT_CONNECT(timer, &QTimer::timeout,
+                   this,
+                   [this, idleMinutes]{
+                       CSwordModuleInfo::releaseIdleModules(
+                                   moduleList(),
+                                   static_cast<std::uint32_t>(idleMinutes));
+                   });
+        timer->start(std::chrono::minutes(1));
+    }
+
+    /* Build the key caches of lexicons after startup and whenever the modules
+       changed, e.g. after installing modules: */
+    m_lexiconCacheBuilder = std::make_unique<BtLexiconCacheBuilder>();
+    BT_CONNECT(m_lexiconCacheBuilder.get(), &BtLexiconCacheBuilder::cacheBuilt,
+               this, &CSwordBackend::sigLexiconCacheBuilt,
+               Qt::QueuedConnection);
+    QTimer::singleShot(0, this, &CSwordBackend::buildLexiconCaches);
+    BT_CONNECT(this, &CSwordBackend::sigSwordSetupChanged,
+               this, &CSwordBackend::buildLexiconCaches,
+               Qt::QueuedConnection);
+
+    /* Add the headwords of lexicons to the index once their caches are built,
+       waiting for other caches built at the same time: */
+    auto * const headwordIndexTimer = new QTimer(this);
+    headwordIndexTimer->setSingleShot(true);
+    headwordIndexTimer->setInterval(std::chrono::seconds(2));
+    BT_CONNECT(headwordIndexTimer, &QTimer::timeout,
+               this, &CSwordBackend::updateHeadwordIndex);
+    BT_CONNECT(this, &CSwordBackend::sigLexiconCacheBuilt,
+               headwordIndexTimer, [headwordIndexTimer]
+               { headwordIndexTimer->start(); });
 
     BT_ASSERT(!m_instance);
     m_instance = this;
@@ -83,12 +200,75 @@ CSwordBackend::CSwordBackend(const QString & path, const bool augmentHome)
                     false, new sword::EncodingFilterMgr(sword::ENC_UTF8),
                     false, augmentHome)
         , m_dataModel(BtBookshelfModel::newInstance())
-{}
+{ connectModuleLookup(); }
+
+CSwordBackend::CSwordBackend(WorkerInstanceTag)
+        : m_manager(nullptr, nullptr, false,
+                    new sword::EncodingFilterMgr(sword::ENC_UTF8), true)
+        , m_dataModel(BtBookshelfModel::newInstance())
+        , m_isWorker(true)
+{ connectModuleLookup(); }
 
 CSwordBackend::~CSwordBackend() {
+    if (m_instance == this) {
+        if (m_orphanedIndicesThread) {
+            m_stopDeletingOrphanedIndices.store(true,
+                                                std::memory_order_relaxed);
+            m_orphanedIndicesThread->wait();
+        }
+        if (m_prewarmIndicesThread) {
+            m_stopPrewarmingIndices.store(true, std::memory_order_relaxed);
+            m_prewarmIndicesThread->wait();
+        }
+        m_lexiconCacheBuilder.reset();
+        CSwordModuleInfo::releaseCachedIndexSearchers();
+        CSwordModuleInfo::saveIndexStates();
+    }
     shutdownModules();
 }
 
+std::unique_ptr<CSwordBackend> CSwordBackend::createWorkerInstance() {
+    auto const lock(lockSwordFiles());
+    std::unique_ptr<CSwordBackend> r(new CSwordBackend(WorkerInstanceTag()));
+    r->initModules();
+    return r;
+}
+
+std::unique_lock<std::recursive_mutex> CSwordBackend::lockSwordFiles() {
+    static std::once_flag prepared;
+    std::call_once(prepared, prepareSwordFiles);
+    static std::recursive_mutex mutex;
+    return std::unique_lock<std::recursive_mutex>(mutex);
+}
+
+std::shared_ptr<CSwordBackend::ModuleSettings const>
+CSwordBackend::moduleSettings() {
+    if (auto r = std::atomic_load_explicit(&m_moduleSettings,
+                                           std::memory_order_acquire))
+        return r;
+    static auto const noSettings = std::make_shared<ModuleSettings const>();
+    return noSettings;
+}
+
+std::shared_ptr<CSwordBackend::ModuleSettings const>
+CSwordBackend::updateModuleSettings() {
+    auto settings(std::make_shared<ModuleSettings>());
+    auto const names(btConfig().value<QStringList>(
+                         QStringLiteral("state/hiddenModules")));
+    settings->hiddenModules = QSet<QString>(names.begin(), names.end());
+    auto const keys(btConfig().group(QStringLiteral("Module keys")));
+    for (auto const & name : keys.childKeys())
+        settings->cipherKeys.insert(name, keys.value<QString>(name));
+
+    std::shared_ptr<ModuleSettings const> r(std::move(settings));
+    std::atomic_store_explicit(&m_moduleSettings, r, std::memory_order_release);
+    return r;
+}
+
+std::shared_ptr<CSwordBackend::ModuleSettings const>
+CSwordBackend::settingsForLoading() const
+{ return m_isWorker ? moduleSettings() : updateModuleSettings(); }
+
 CSwordModuleInfo * CSwordBackend::findFirstAvailableModule(CSwordModuleInfo::ModuleType type) {
 
     for (CSwordModuleInfo * const m : moduleList())
@@ -132,12 +312,16 @@ CSwordBackend::availableLanguages() noexcept
 void CSwordBackend::uninstallModules(BtConstModuleSet const & toBeDeleted) {
     if (toBeDeleted.empty())
         return;
+    BtEntryWriteJournal::instance().commit();
+    BtSearchThread::stopAllSearches();
     m_dataModel->removeModules(toBeDeleted);
     Q_EMIT sigSwordSetupChanged();
 
     BtInstallMgr installMgr;
     QMap<QString, sword::SWMgr *> mgrDict; // Maps config paths to SWMgr objects
     for (CSwordModuleInfo const * const mInfo : toBeDeleted) {
+        BtIndexingScheduler::instance().cancel(mInfo);
+
         // Find the install path for the sword manager:
         QString dataPath = mInfo->config(CSwordModuleInfo::DataPath);
         if (dataPath.left(2) == QStringLiteral("./"))
@@ -189,63 +373,78 @@ BtConstModuleList CSwordBackend::getConstPointerList(const QStringList & names)
 }
 
 CSwordBackend::LoadError CSwordBackend::initModules() {
+    BtStartupProfile::Phase const phase("CSwordBackend::initModules");
     // qWarning("globalSwordConfigPath is %s", globalConfPath);
 
     shutdownModules(); // Remove previous modules
     m_dataModel->clear();
 
+    auto const lock(lockSwordFiles());
+
     const LoadError ret = static_cast<LoadError>(m_manager.load());
 
+    // Read the settings once instead of for each module:
+    auto const settings(settingsForLoading());
+
+    QList<CSwordModuleInfo *> newModules;
     for (auto const & modulePair : m_manager.getModules()) {
-        sword::SWModule * const curMod = modulePair.second;
-        BT_ASSERT(curMod);
-        std::unique_ptr<CSwordModuleInfo> newModule;
-
-        std::string_view const modType = curMod->getType();
-        using namespace std::literals;
-        if (modType == "Biblical Texts"sv) {
-            newModule = std::make_unique<CSwordBibleModuleInfo>(*curMod, *this);
-        } else if (modType == "Commentaries"sv) {
-            newModule = std::make_unique<CSwordCommentaryModuleInfo>(*curMod,
-                                                                     *this);
-        } else if (modType == "Lexicons / Dictionaries"sv) {
-            newModule = std::make_unique<CSwordLexiconModuleInfo>(*curMod,
-                                                                  *this);
-        } else if (modType == "Generic Books"sv) {
-            newModule = std::make_unique<CSwordBookModuleInfo>(*curMod, *this);
-        } else {
-            continue;
-        }
+        BT_ASSERT(modulePair.second);
+        /// \todo Refactor data model to use shared_ptr to contain works
+        if (auto newModule = createModule(*modulePair.second, *settings))
+            newModules.append(newModule.release());
+    }
+    m_dataModel->addModules(newModules);
 
-        // Append the new modules to our list, but only if it's supported
-        // The constructor of CSwordModuleInfo prints a warning on stdout
-        if (!newModule->hasVersion()
-            || (newModule->minimumSwordVersion() <= sword::SWVersion::currentVersion))
-        {
+    Q_EMIT sigSwordSetupChanged();
+    return ret;
+}
 
-            /* There is currently a deficiency in sword 1.8.1 in that backend->setCipherKey() does
-             * not work correctly for modules from which data was already fetched. Therefore we have to
-             * reload the modules. The cipher key must be set before any read occurs on the module.
-             * Reading from the module can happen in subtle ways. The addModule below causes a read
-             * to determine if the locked or unlocked icon is used by the model.
-             */
-            if (newModule->isEncrypted()) {
-                auto const unlockKey(
-                        btConfig().getModuleEncryptionKey(newModule->name()));
-                if (!unlockKey.isNull())
-                    m_manager.setCipherKey(
-                                newModule->name().toUtf8().constData(),
-                                unlockKey.toUtf8().constData());
-            }
+std::unique_ptr<CSwordModuleInfo> CSwordBackend::createModule(
+        sword::SWModule & swordModule,
+        ModuleSettings const & settings)
+{
+    std::unique_ptr<CSwordModuleInfo> newModule;
+
+    std::string_view const modType = swordModule.getType();
+    using namespace std::literals;
+    if (modType == "Biblical Texts"sv) {
+        newModule = std::make_unique<CSwordBibleModuleInfo>(swordModule, *this);
+    } else if (modType == "Commentaries"sv) {
+        newModule = std::make_unique<CSwordCommentaryModuleInfo>(swordModule,
+                                                                 *this);
+    } else if (modType == "Lexicons / Dictionaries"sv) {
+        newModule = std::make_unique<CSwordLexiconModuleInfo>(swordModule,
+                                                              *this);
+    } else if (modType == "Generic Books"sv) {
+        newModule = std::make_unique<CSwordBookModuleInfo>(swordModule, *this);
+    } else {
+        return nullptr;
+    }
 
-            /// \todo Refactor data model to use shared_ptr to contain works
-            m_dataModel->addModule(newModule.get());
-            newModule.release();
-        }
+    // Append the new modules to our list, but only if it's supported
+    // The constructor of CSwordModuleInfo prints a warning on stdout
+    if (newModule->hasVersion()
+        && (newModule->minimumSwordVersion()
+            > sword::SWVersion::currentVersion))
+        return nullptr;
+
+    /* There is currently a deficiency in sword 1.8.1 in that
+     * backend->setCipherKey() does not work correctly for modules from which
+     * data was already fetched. Therefore we have to reload the modules. The
+     * cipher key must be set before any read occurs on the module. Reading
+     * from the module can happen in subtle ways. Adding the module to the
+     * model causes a read to determine if the locked or unlocked icon is used
+     * by the model.
+     */
+    if (newModule->isEncrypted()) {
+        auto const unlockKey(settings.cipherKeys.value(newModule->name()));
+        if (!unlockKey.isNull())
+            m_manager.setCipherKey(newModule->name().toUtf8().constData(),
+                                   unlockKey.toUtf8().constData());
     }
 
-    Q_EMIT sigSwordSetupChanged();
-    return ret;
+    newModule->m_hidden = settings.hiddenModules.contains(newModule->name());
+    return newModule;
 }
 
 void CSwordBackend::Private::addRenderFilters(sword::SWModule * module,
@@ -278,8 +477,13 @@ void CSwordBackend::Private::addRenderFilters(sword::SWModule * module,
 }
 
 void CSwordBackend::shutdownModules() {
+    // The modules must not be deleted while they are being searched:
+    if (m_instance == this)
+        BtSearchThread::stopAllSearches();
+    auto const lock(lockSwordFiles());
     m_dataModel->clear(true);
     m_manager.shutdownModules();
+    m_appliedFilterOptions.reset();
 }
 
 void CSwordBackend::Private::shutdownModules() {
@@ -301,36 +505,123 @@ void CSwordBackend::Private::shutdownModules() {
 
 void CSwordBackend::setOption(CSwordModuleInfo::FilterOption const & option,
                               const int state)
-{ m_manager.setGlobalOption(option.optionName, option.valueToString(state)); }
+{
+    m_appliedFilterOptions.reset();
+    m_manager.setGlobalOption(option.optionName, option.valueToString(state));
+}
 
 void CSwordBackend::setFilterOptions(const FilterOptions & options) {
-    setOption(CSwordModuleInfo::footnotes,           options.footnotes);
-    setOption(CSwordModuleInfo::strongNumbers,       options.strongNumbers);
-    setOption(CSwordModuleInfo::headings,            options.headings);
-    setOption(CSwordModuleInfo::morphTags,           options.morphTags);
-    setOption(CSwordModuleInfo::lemmas,              options.lemmas);
-    setOption(CSwordModuleInfo::hebrewPoints,        options.hebrewPoints);
-    setOption(CSwordModuleInfo::hebrewCantillation,  options.hebrewCantillation);
-    setOption(CSwordModuleInfo::greekAccents,        options.greekAccents);
-    setOption(CSwordModuleInfo::redLetterWords,      options.redLetterWords);
-    setOption(CSwordModuleInfo::textualVariants,     options.textualVariants);
-    setOption(CSwordModuleInfo::morphSegmentation,   options.morphSegmentation);
-    // setOption(CSwordModuleInfo::transliteration,   options.transliteration);
-    setOption(CSwordModuleInfo::scriptureReferences, options.scriptureReferences);
-}
-
-CSwordModuleInfo * CSwordBackend::findModuleByName(const QString & name) const {
-    for (auto * const mod : m_dataModel->moduleList())
-        if (mod->name().compare(name, Qt::CaseInsensitive) == 0)
-            return mod;
-    return nullptr;
+    auto const & applied = m_appliedFilterOptions;
+    if (applied && applied->filterOptionsAreEqual(options)) {
+        ++m_skippedFilterOptionUpdates;
+        return;
+    }
+
+    auto const apply =
+            [this, &applied, &options](
+                    CSwordModuleInfo::FilterOption const & option,
+                    int FilterOptions::* const member)
+            {
+                if (!applied || (*applied).*member != options.*member)
+                    m_manager.setGlobalOption(
+                                option.optionName,
+                                option.valueToString(options.*member));
+            };
+    apply(CSwordModuleInfo::footnotes,           &FilterOptions::footnotes);
+    apply(CSwordModuleInfo::strongNumbers,       &FilterOptions::strongNumbers);
+    apply(CSwordModuleInfo::headings,            &FilterOptions::headings);
+    apply(CSwordModuleInfo::morphTags,           &FilterOptions::morphTags);
+    apply(CSwordModuleInfo::lemmas,              &FilterOptions::lemmas);
+    apply(CSwordModuleInfo::hebrewPoints,        &FilterOptions::hebrewPoints);
+    apply(CSwordModuleInfo::hebrewCantillation,
+          &FilterOptions::hebrewCantillation);
+    apply(CSwordModuleInfo::greekAccents,        &FilterOptions::greekAccents);
+    apply(CSwordModuleInfo::redLetterWords,
+          &FilterOptions::redLetterWords);
+    apply(CSwordModuleInfo::textualVariants,
+          &FilterOptions::textualVariants);
+    apply(CSwordModuleInfo::morphSegmentation,
+          &FilterOptions::morphSegmentation);
+    // apply(CSwordModuleInfo::transliteration, ...);
+    apply(CSwordModuleInfo::scriptureReferences,
+          &FilterOptions::scriptureReferences);
+    m_appliedFilterOptions = options;
 }
 
-CSwordModuleInfo * CSwordBackend::findSwordModuleByPointer(const sword::SWModule * const swmodule) const {
-    for (auto * const mod : m_dataModel->moduleList())
-        if (&mod->swordModule() == swmodule)
-            return mod;
-    return nullptr;
+QString CSwordBackend::filterOptionsKey() {
+    QString r;
+    for (auto const * const option : {&CSwordModuleInfo::footnotes,
+                                      &CSwordModuleInfo::strongNumbers,
+                                      &CSwordModuleInfo::headings,
+                                      &CSwordModuleInfo::morphTags,
+                                      &CSwordModuleInfo::lemmas,
+                                      &CSwordModuleInfo::hebrewPoints,
+                                      &CSwordModuleInfo::hebrewCantillation,
+                                      &CSwordModuleInfo::greekAccents,
+                                      &CSwordModuleInfo::redLetterWords,
+                                      &CSwordModuleInfo::textualVariants,
+                                      &CSwordModuleInfo::morphSegmentation,
+                                      &CSwordModuleInfo::scriptureReferences})
+    {
+        if (auto const * const value =
+                    m_manager.getGlobalOption(option->optionName))
+            r.append(QString::fromUtf8(value));
+        r.append('|');
+    }
+    return r;
+}
+
+CSwordModuleInfo * CSwordBackend::findModuleByName(const QString & name) const
+{ return m_modulesByName.value(name.toCaseFolded(), nullptr); }
+
+CSwordModuleInfo * CSwordBackend::findSwordModuleByPointer(const sword::SWModule * const swmodule) const
+{ return m_modulesBySwordModule.value(swmodule, nullptr); }
+
+void CSwordBackend::addToModuleLookup(CSwordModuleInfo * const module) {
+    // Like a linear search, prefer the first of modules with equal names:
+    auto name(module->name().toCaseFolded());
+    if (!m_modulesByName.contains(name))
+        m_modulesByName.insert(std::move(name), module);
+    m_modulesBySwordModule.insert(&module->swordModule(), module);
+}
+
+void CSwordBackend::connectModuleLookup() {
+    BT_CONNECT(m_dataModel.get(), &BtBookshelfModel::rowsInserted,
+               this,
+               [this](QModelIndex const &, int const first, int const last) {
+                   auto const & modules = m_dataModel->moduleList();
+                   for (int i = first; i <= last; ++i)
+                       addToModuleLookup(modules.at(i));
+               });
+    BT_CONNECT(m_dataModel.get(), &BtBookshelfModel::rowsAboutToBeRemoved,
+               this,
+               [this](QModelIndex const &, int const first, int const last) {
+                   auto const & modules = m_dataModel->moduleList();
+                   if (first == 0 && last == modules.size() - 1) {
+                       m_modulesByName.clear();
+                       m_modulesBySwordModule.clear();
+                       return;
+                   }
+                   for (int i = first; i <= last; ++i) {
+                       auto * const module = modules.at(i);
+                       m_modulesBySwordModule.remove(&module->swordModule());
+                       auto const name(module->name().toCaseFolded());
+                       auto const it = m_modulesByName.find(name);
+                       if (it == m_modulesByName.end() || *it != module)
+                           continue;
+                       m_modulesByName.erase(it);
+
+                       // Fall back to any remaining module of the same name:
+                       for (int j = 0; j < modules.size(); ++j) {
+                           if ((j < first || j > last)
+                               && modules.at(j)->name().toCaseFolded() == name)
+                           {
+                               m_modulesByName.insert(name, modules.at(j));
+                               break;
+                           }
+                       }
+                   }
+               });
 }
 
 QString CSwordBackend::booknameLanguage() const
@@ -354,12 +645,101 @@ void CSwordBackend::setBooknameLanguage(QString const & language) {
        this method not being called very often. */
     for (auto const * const mod : m_dataModel->moduleList())
         mod->swordModule().getKey()->setLocale(newLocaleName.constData());
+
+    // The raw entry cache is keyed by the localized texts of the keys:
+    BtRawEntryCache::instance().clear();
 }
 
 void CSwordBackend::reloadModules() {
-    shutdownModules();
-    m_manager.reloadConfig();
-    initModules();
+    /* The modules are rebound or deleted below, so stop searching them first.
+       The indexing jobs only use the modules of their own worker backends: */
+    if (m_instance == this) {
+        BtEntryWriteJournal::instance().commit();
+        BtSearchThread::stopAllSearches();
+    }
+
+    auto const lock(lockSwordFiles());
+
+    /* Keep the previous Sword modules until the modules are updated, so that
+       the configuration of the reloaded modules can be compared to theirs: */
+    auto detached(m_manager.detachModules());
+    if (!detached) {
+        BtRawEntryCache::instance().clear();
+        shutdownModules();
+        m_manager.reloadConfig();
+        initModules();
+        return;
+    }
+    m_appliedFilterOptions.reset();
+    m_manager.load();
+
+    // The modules not loaded again are removed:
+    QHash<QString, CSwordModuleInfo *> removed;
+    for (auto * const module : m_dataModel->moduleList())
+        removed.insert(module->name(), module);
+
+    // Keep the modules which are unchanged, but encrypted ones might be locked:
+    auto const settings(settingsForLoading());
+    QList<CSwordModuleInfo *> added;
+    for (auto const & modulePair : m_manager.getModules()) {
+        BT_ASSERT(modulePair.second);
+        auto & swordModule = *modulePair.second;
+        auto const it =
+                removed.find(QString::fromUtf8(swordModule.getName()));
+        if (it != removed.end()
+            && !(*it)->isEncrypted()
+            && sameConfig((*it)->swordModule(), swordModule))
+        {
+            auto * const module = *it;
+            m_modulesBySwordModule.remove(&module->swordModule());
+            module->rebind(swordModule);
+            m_modulesBySwordModule.insert(&swordModule, module);
+            removed.erase(it);
+        } else if (auto newModule = createModule(swordModule, *settings)) {
+            added.append(newModule.release());
+        }
+    }
+
+    BtConstModuleSet removedSet;
+    for (auto const * const module : std::as_const(removed)) {
+        BtIndexingScheduler::instance().cancel(module);
+        BtRawEntryCache::instance().removeModule(module->name());
+        removedSet.insert(module);
+    }
+    m_dataModel->removeModules(removedSet);
+    m_dataModel->addModules(added);
+
+    Q_EMIT sigSwordSetupChanged();
+
+    qDeleteAll(removed);
+    m_manager.deleteDetachedModules(*detached);
+}
+
+std::optional<CSwordBackend::Private::DetachedModules>
+CSwordBackend::Private::detachModules() {
+    if (!myconfig)
+        return {};
+    DetachedModules r{{}, myconfig, {}};
+    r.modules.swap(Modules);
+    r.cipherFilters.swap(cipherFilters);
+    config = myconfig = nullptr;
+    findConfig(&configType, &prefixPath, &configPath, &augPaths, &sysConfig);
+    loadConfigDir(configPath);
+    return r;
+}
+
+void CSwordBackend::Private::deleteDetachedModules(DetachedModules & detached)
+{
+    for (auto const & modulePair : detached.modules)
+        delete modulePair.second;
+    detached.modules.clear();
+    for (auto const & filterPair : detached.cipherFilters) {
+        cleanupFilters.remove(filterPair.second);
+        delete filterPair.second;
+    }
+    detached.cipherFilters.clear();
+    delete detached.config;
+    detached.config = nullptr;
 }
 
 void CSwordBackend::Private::reloadConfig() {
@@ -467,24 +847,167 @@ QStringList CSwordBackend::swordDirList() const {
     return swordDirs;
 }
 
+void CSwordBackend::buildLexiconCaches() {
+    QStringList moduleNames;
+    for (auto const * const module : moduleList())
+        if (module->type() == CSwordModuleInfo::Lexicon
+            && !static_cast<CSwordLexiconModuleInfo const *>(
+                    module)->hasEntriesCache())
+            moduleNames.append(module->name());
+    if (!moduleNames.isEmpty())
+        m_lexiconCacheBuilder->buildCaches(moduleNames);
+    updateHeadwordIndex();
+}
+
+void CSwordBackend::updateHeadwordIndex() {
+    std::vector<BtHeadwordIndex::Module> lexicons;
+    for (auto const * const module : moduleList())
+        if (module->type() == CSwordModuleInfo::Lexicon)
+            lexicons.push_back(
+                    {module->name(),
+                     module->config(CSwordModuleInfo::ModuleVersion).toUtf8()});
+    BtHeadwordIndex::update(std::move(lexicons));
+}
+
+void CSwordBackend::buildLexiconCache(QString const & moduleName) {
+    if (m_lexiconCacheBuilder) // Not in worker instances
+        m_lexiconCacheBuilder->buildCaches({moduleName}, true);
+}
+
 void CSwordBackend::deleteOrphanedIndices() {
-    const QStringList entries = QDir(CSwordModuleInfo::getGlobalBaseIndexLocation()).entryList(QDir::Dirs);
-    for (auto const & entry : entries) {
-        if (entry == '.' || entry == QStringLiteral(".."))
-            continue;
-        if (CSwordModuleInfo * const module = findModuleByName(entry)) {
-            if (!module->hasIndex()) { //index files found, but wrong version etc.
-                qDebug() << "deleting outdated index for module" << entry;
-                CSwordModuleInfo::deleteIndexForModule(entry);
+    if (m_orphanedIndicesThread && !m_orphanedIndicesThread->isFinished())
+        return;
+
+    // The configuration is read before starting the thread:
+    bool const keepUpdatable =
+            CSwordModuleInfo::incrementalIndexUpdatesEnabled();
+    bool const deleteOrphaned =
+            btConfig().value<bool>(
+                QStringLiteral("settings/behaviour/autoDeleteOrphanedIndices"),
+                true);
+
+    m_orphanedIndicesThread.reset(QThread::create(
+        [this, keepUpdatable, deleteOrphaned] {
+            auto const entries =
+                    QDir(CSwordModuleInfo::getGlobalBaseIndexLocation())
+                    .entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            if (entries.isEmpty())
+                return;
+
+            // The indices are probed with the modules of a worker backend:
+            auto const backend(createWorkerInstance());
+            for (auto const & entry : entries) {
+                if (m_stopDeletingOrphanedIndices.load(
+                        std::memory_order_relaxed))
+                    return;
+                auto & scheduler = BtIndexingScheduler::instance();
+                if (auto const * const module =
+                            backend->findModuleByName(entry))
+                {
+                    auto const outdated =
+                            [module, keepUpdatable] {
+                                return !module->hasIndex()
+                                       && !(keepUpdatable
+                                            && module->hasUpdatableIndex());
+                            };
+                    // Index files found, but wrong version etc.:
+                    if (outdated()) {
+                        /* Indices being built or rebuilt are outdated too,
+                           hence those of modules with jobs are kept, and the
+                           index might have been built before checking: */
+                        scheduler.runUnlessScheduled(
+                                    entry,
+                                    [module, &entry, &outdated] {
+                                        module->refreshIndexState();
+                                        if (!outdated())
+                                            return;
+                                        qDebug() << "deleting outdated index "
+                                                    "for module" << entry;
+                                        CSwordModuleInfo::deleteIndexForModule(
+                                                    entry);
+                                    });
+                    } else if (module->indexNeedsRebuild()) {
+                        // Updating the index failed in a previous session:
+                        QMetaObject::invokeMethod(
+                                    this,
+                                    [entry] {
+                                        BtIndexingScheduler::instance()
+                                                .enqueueRebuild(entry);
+                                    },
+                                    Qt::QueuedConnection);
+                    }
+                } else if (deleteOrphaned) { // No module exists
+                    // The module might have been installed meanwhile:
+                    scheduler.runUnlessScheduled(
+                                entry,
+                                [&entry] {
+                                    qDebug() << "deleting orphaned index in "
+                                                "directory" << entry;
+                                    CSwordModuleInfo::deleteIndexForModule(
+                                                entry);
+                                });
+                }
             }
-        } else { //no module exists
-            if (btConfig().value<bool>(
-                    QStringLiteral(
-                        "settings/behaviour/autoDeleteOrphanedIndices"), true))
-            {
-                qDebug() << "deleting orphaned index in directory" << entry;
-                CSwordModuleInfo::deleteIndexForModule(entry);
+        }));
+    m_orphanedIndicesThread->start(QThread::LowestPriority);
+}
+
+void CSwordBackend::prewarmIndices() {
+    if (!btConfig().value<bool>(
+            QStringLiteral("settings/behaviour/prewarmIndices"),
+            false)
+        || (m_prewarmIndicesThread && !m_prewarmIndicesThread->isFinished()))
+        return;
+
+    /* Only a few modules are read, so that the page cache is not thrashed on
+       machines with little memory: */
+    static constexpr qsizetype maxModules = 4;
+    static constexpr ::qint64 maxBytes = 256 * 1024 * 1024;
+
+    QStringList locations;
+    ::qint64 bytes = 0;
+    auto const addModule =
+            [&locations, &bytes](CSwordModuleInfo const * const module) {
+                if (!module
+                    || locations.size() >= maxModules
+                    || !module->hasIndex())
+                    return;
+                auto location(module->getModuleStandardIndexLocation());
+                if (locations.contains(location))
+                    return;
+                auto const size = module->indexSize();
+                if (bytes + size > maxBytes)
+                    return;
+                bytes += size;
+                locations.append(std::move(location));
+            };
+    addModule(btConfig().getDefaultSwordModuleByType(
+                  QStringLiteral("standardBible")));
+    // The history lists the most recent searches first:
+    for (auto const & value : BtHistoryStore::searchModules().items())
+        for (auto const & name : value.split(QStringLiteral(", ")))
+            addModule(findModuleByName(name));
+    if (locations.isEmpty())
+        return;
+
+    m_prewarmIndicesThread.reset(QThread::create(
+        [this, locations = std::move(locations)] {
+            static constexpr ::qint64 bufferSize = 1024 * 1024;
+            auto const buffer = std::make_unique<char[]>(
+                                      static_cast<std::size_t>(bufferSize));
+            for (auto const & location : locations) {
+                for (auto const & fileInfo
+                     : QDir(location).entryInfoList(QDir::Files))
+                {
+                    QFile file(fileInfo.filePath());
+                    if (!file.open(QIODevice::ReadOnly))
+                        continue;
+                    while (file.read(buffer.get(), bufferSize) > 0)
+                        if (m_stopPrewarmingIndices.load(
+                                std::memory_order_relaxed))
+                            return;
+                }
             }
-        }
-    }
+        }));
+    m_prewarmIndicesThread->start(QThread::LowestPriority);
 }
@@ -12,8 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <set>
@@ -37,6 +43,9 @@
 #include <swmgr.h>
 #pragma GCC diagnostic pop
 
+class BtLexiconCacheBuilder;
+class QThread;
+
 namespace sword {
 class Module;
 class Config;
@@ -69,8 +78,24 @@ public: // types:
         NoModules = 1
     };
 
+    /**
+      \brief The settings of the modules, which are read from btConfig() by
+             the main thread only, see moduleSettings().
+    */
+    struct ModuleSettings {
+
+        /** The names of the modules hidden by the user. */
+        QSet<QString> hiddenModules;
+
+        /** The cipher keys entered by the user, by the names of the modules. */
+        QHash<QString, QString> cipherKeys;
+
+    };
+
 private: // types:
 
+    struct WorkerInstanceTag {};
+
     using AvailableLanguagesCacheContainer =
             std::set<std::shared_ptr<Language const>>;
 
@@ -94,6 +119,54 @@ public: // methods:
 
     ~CSwordBackend() override;
 
+    /**
+      \brief Creates a separate backend with the same modules as the regular
+             instance.
+
+      The returned backend has its own Sword manager, hence its own module
+      objects, keys and filter option state. This allows worker threads to use
+      modules with filter options of their own. The files of the modules are
+      still opened through state shared by all backends, see
+      lockSwordFiles().
+      \note The returned backend is not available through instance().
+      \returns the new backend with its modules already initialized.
+    */
+    static std::unique_ptr<CSwordBackend> createWorkerInstance();
+
+    /**
+      \returns the module settings read by the last updateModuleSettings().
+      \note Unlike btConfig(), this may be used by worker threads, e.g. by the
+            modules of worker instances.
+    */
+    static std::shared_ptr<ModuleSettings const> moduleSettings();
+
+    /**
+      \brief Reads the module settings from btConfig() again, e.g. after a
+             module was hidden or unlocked.
+      \note Must only be called by the main thread.
+      \returns the settings read.
+    */
+    static std::shared_ptr<ModuleSettings const> updateModuleSettings();
+
+    /**
+      \brief Locks the files of the Sword modules of all backends.
+
+      Sword opens, reopens and closes the files of the modules of all backends
+      through the process wide sword::FileMgr, whose list of files is not
+      locked. Hence backends load, reload and delete their modules under this
+      lock, and every thread reading entries from Sword modules, e.g. by
+      getRawEntry(), stripText() or renderText() without a given text, must
+      hold it while doing so. Filtering a text read before does not need it.
+
+      Besides, the FileMgr is set up before the first backend is created not
+      to close the files of other modules to stay below a number of open
+      files, so that positioning the keys of modules without this lock, which
+      reads the indices of lexicons and books, never closes the files of other
+      threads.
+      \returns the lock held.
+    */
+    static std::unique_lock<std::recursive_mutex> lockSwordFiles();
+
     /** \returns the singleton instance. */
     static CSwordBackend & instance() noexcept {
         BT_ASSERT(m_instance);
@@ -134,8 +207,36 @@ public: // methods:
     */
     void setOption(CSwordModuleInfo::FilterOption const & type, const int state);
 
+    /**
+      \brief Sets the state of all filter options.
+
+      Only the options which differ from the ones applied by the previous call
+      are changed, unless setOption() was called or the modules were reloaded
+      in the meantime.
+    */
     void setFilterOptions(const FilterOptions & options);
 
+    /**
+      \returns the filter options applied by setFilterOptions(), unless other
+               options were changed since, e.g. to apply the same options to
+               another instance.
+    */
+    std::optional<FilterOptions> const & appliedFilterOptions() const noexcept
+    { return m_appliedFilterOptions; }
+
+    /**
+      \returns the number of calls to setFilterOptions() which did not need to
+               change any option.
+    */
+    std::uint64_t skippedFilterOptionUpdates() const noexcept
+    { return m_skippedFilterOptionUpdates; }
+
+    /**
+      \returns a string identifying the current state of the filter options
+               set by setFilterOptions(), e.g. to key caches of rendered text.
+    */
+    QString filterOptionsKey();
+
     /** \returns the language for the international booknames of Sword. */
     QString booknameLanguage() const;
 
@@ -167,7 +268,12 @@ public: // methods:
     sword::SWConfig * getConfig() const { return m_manager.config; }
 
     /**
-      \brief Reloads all Sword modules.
+      \brief Reloads all Sword modules, e.g. after modules were installed.
+
+      Only the modules which were added, removed or changed, including all
+      encrypted modules, are added to and removed from model(). The other
+      modules are kept and only use the reloaded Sword modules, so windows of
+      these modules need not be reloaded.
     */
     void reloadModules();
 
@@ -200,10 +306,29 @@ public: // methods:
     /**
       Deletes all indices of modules where hasIndex() returns false (because of
       wrong index version etc.) and deletes all orphaned indexes (no module
-      present) if autoDeleteOrphanedIndices is true.
+      present) if autoDeleteOrphanedIndices is true. Since this probes the
+      index of every module, it is done by a background thread at the lowest
+      priority, which uses its own worker instance of the backend.
     */
     void deleteOrphanedIndices();
 
+    /**
+      Reads the index files of the default Bible and of the modules searched
+      most recently (see BtHistoryStore::searchModules()) in a background thread
+      at the lowest priority, so that the first search after startup does not
+      wait for the disk. This is done only if enabled by
+      "settings/behaviour/prewarmIndices".
+    */
+    void prewarmIndices();
+
+    /**
+      \brief Builds the key cache of the given lexicon module in the background
+             before the other caches still to be built.
+
+      The signal sigLexiconCacheBuilt() is emitted when the cache is built.
+    */
+    void buildLexiconCache(QString const & moduleName);
+
     QString prefixPath() const
     { return QString::fromLatin1(m_manager.prefixPath); }
 
@@ -213,16 +338,85 @@ Q_SIGNALS:
 
     void sigSwordSetupChanged();
 
+    /**
+      \brief Emitted when the key cache of the given lexicon module was built in
+             the background, so that its entries can be loaded quickly.
+    */
+    void sigLexiconCacheBuilt(QString const & moduleName);
+
+private: // methods:
+
+    CSwordBackend(WorkerInstanceTag);
+
+    /**
+      \brief Keeps m_modulesByName and m_modulesBySwordModule in sync with the
+             modules in m_dataModel.
+    */
+    void connectModuleLookup();
+
+    /** \brief Adds the given module to the lookup hashes. */
+    void addToModuleLookup(CSwordModuleInfo * module);
+
+    /**
+      \returns the module settings to load the modules with. Worker instances
+               are used by other threads, hence they reuse the settings read by
+               the main thread.
+    */
+    std::shared_ptr<ModuleSettings const> settingsForLoading() const;
+
+    /**
+      \returns a new module for the given Sword module, or nullptr if the
+               module is not supported.
+      \param[in] settings The settings of the modules.
+    */
+    std::unique_ptr<CSwordModuleInfo> createModule(
+            sword::SWModule & swordModule,
+            ModuleSettings const & settings);
+
+    /**
+      \brief Builds the missing or outdated key caches of the lexicon modules
+             in the background.
+    */
+    void buildLexiconCaches();
+
+    /**
+      \brief Updates the BtHeadwordIndex of the lexicon modules in the
+             background.
+    */
+    void updateHeadwordIndex();
+
 private: // fields:
 
     struct Private: public sword::SWMgr {
 
+    // Types:
+
+        /** The Sword modules detached by detachModules(). */
+        struct DetachedModules {
+            sword::ModMap modules;
+            sword::SWConfig * config;
+            decltype(cipherFilters) cipherFilters;
+        };
+
     // Methods:
 
         using sword::SWMgr::SWMgr;
 
         void shutdownModules();
         void reloadConfig();
+
+        /**
+          \brief Detaches the loaded modules together with their configuration
+                 and reads the configuration again, so that the modules can be
+                 loaded again while the detached modules are still used.
+          \returns the detached modules, or nothing if the configuration is
+                   not owned by the manager, i.e. can not be detached.
+        */
+        std::optional<DetachedModules> detachModules();
+
+        /** \brief Deletes the modules detached by detachModules(). */
+        void deleteDetachedModules(DetachedModules & detached);
+
         void addRenderFilters(sword::SWModule * module,
                               sword::ConfigEntMap & section) override;
 
@@ -240,6 +434,25 @@ private: // fields:
     std::shared_ptr<AvailableLanguagesCacheContainer const>
             m_availableLanguagesCache;
 
+    /** Maps the case folded names of the modules to the modules. */
+    QHash<QString, CSwordModuleInfo *> m_modulesByName;
+    QHash<sword::SWModule const *, CSwordModuleInfo *> m_modulesBySwordModule;
+
+    /** Only used by the regular instance. */
+    std::unique_ptr<BtLexiconCacheBuilder> m_lexiconCacheBuilder;
+    std::unique_ptr<QThread> m_orphanedIndicesThread;
+    std::atomic<bool> m_stopDeletingOrphanedIndices{false};
+    std::unique_ptr<QThread> m_prewarmIndicesThread;
+    std::atomic<bool> m_stopPrewarmingIndices{false};
+
+    /** The filter options applied by setFilterOptions(), if still applied. */
+    std::optional<FilterOptions> m_appliedFilterOptions;
+    std::uint64_t m_skippedFilterOptionUpdates = 0u;
+
+    /** Whether this is a worker instance, see createWorkerInstance(). */
+    bool const m_isWorker = false;
+
     static CSwordBackend * m_instance;
+    static std::shared_ptr<ModuleSettings const> m_moduleSettings;
 
 };
@@ -12,16 +12,33 @@
 
 #include "referencemanager.h"
 
+#include <mutex>
+#include <QCache>
+#include <QChar>
 #include <QDebug>
+#include <QStringList>
 #include <utility>
 #include "../../util/btassert.h"
 #include "../config/btconfig.h"
 #include "../keys/cswordversekey.h"
+#include "../drivers/cswordbiblemoduleinfo.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "btlocalemgr.h"
 #include "cswordbackend.h"
 
 
+namespace {
+
+/** The maximum number of references kept parsed by parseVerseReference(). */
+constexpr qsizetype const maxParsedReferences = 4096;
+
+/* The filters parse the same references over and over, and they render in
+   several threads: */
+std::mutex parsedReferencesMutex;
+QCache<QString, QString> parsedReferences(maxParsedReferences);
+
+} // anonymous namespace
+
 /** Returns a hyperlink used to be imbedded in the display windows. At the moment the format is sword://module/key */
 QString ReferenceManager::encodeHyperlink(CSwordModuleInfo const & module,
                                           QString const & key)
@@ -65,8 +82,6 @@ ReferenceManager::decodeHyperlink(QString const & hyperlink) {
        (if present).
     */
 
-    QStringView ref(hyperlink);
-
     static auto const preferredModule =
             [](ReferenceManager::Type const type) -> CSwordModuleInfo * {
                 QString typeStr;
@@ -85,79 +100,84 @@ ReferenceManager::decodeHyperlink(QString const & hyperlink) {
                 }
                 return btConfig().getDefaultSwordModuleByType(typeStr);
             };
+    static auto const is =
+            [](QStringView const part, QStringView const name) noexcept
+            { return part.compare(name, Qt::CaseInsensitive) == 0; };
+
+    auto const parts(splitUrl(hyperlink));
+    if (!parts)
+        return {};
 
     DecodedHyperlink ret;
-    static auto const removeCaseInsensitivePrefix =
-            [](QStringView & ref, QString const & prefix) {
-                if (ref.startsWith(prefix, Qt::CaseInsensitive)) {
-                    ref = ref.mid(prefix.size() - 1);
-                    return true;
-                }
-                return false;
-            };
-    int slashPos; // position of the last parsed slash
-    if (removeCaseInsensitivePrefix(ref, QStringLiteral("sword://"))) { //Bible, Commentary or Lexicon
-        if (removeCaseInsensitivePrefix(ref, QStringLiteral("bible/"))) {
+    QStringView key;
+    if (is(parts->scheme, u"sword")) { //Bible, Commentary or Lexicon
+        if (is(parts->host, u"bible")) {
             ret.type = ReferenceManager::Bible;
-        } else if (removeCaseInsensitivePrefix(ref,
-                                               QStringLiteral("commentary/")))
-        {
+        } else if (is(parts->host, u"commentary")) {
             ret.type = ReferenceManager::Commentary;
-        } else if (removeCaseInsensitivePrefix(ref, QStringLiteral("lexicon/")))
-        {
+        } else if (is(parts->host, u"lexicon")) {
             ret.type = ReferenceManager::Lexicon;
-        } else if (removeCaseInsensitivePrefix(ref, QStringLiteral("book/"))) {
+        } else if (is(parts->host, u"book")) {
             ret.type = ReferenceManager::GenericBook;
         } else {
             return {};
         }
 
         // string up to next slash is the modulename
-        slashPos = ref.indexOf('/');
+        auto const slashPos = parts->path.indexOf(u'/');
         if (slashPos < 0) // if key is empty
             return {};
         if (slashPos == 0) {
             ret.module = preferredModule(ret.type);
         } else { // We have a module given
             ret.module = CSwordBackend::instance().findModuleByName(
-                             ref.left(slashPos).toString());
+                             parts->path.left(slashPos).toString());
             if (!ret.module)
                 ret.module = preferredModule(ret.type);
         }
+        key = parts->path.mid(slashPos + 1);
     } else {
         struct { Type hebrew; Type greek; } types;
-        if (removeCaseInsensitivePrefix(ref, QStringLiteral("morph://"))) {
+        if (is(parts->scheme, u"morph")) {
             types = {MorphHebrew, MorphGreek};
-        } else if (removeCaseInsensitivePrefix(ref,
-                                               QStringLiteral("strongs://")))
-        {
+        } else if (is(parts->scheme, u"strongs")) {
             types = {StrongsHebrew, StrongsGreek};
         } else {
             return {};
         }
 
-        // Part up to next slash is the language:
-        slashPos = ref.indexOf('/');
-        if (slashPos <= 0) // if language or key is empty (0 or -1)
-            return {};
-        auto const language(ref.left(slashPos).toString().toLower());
-        if (language == QStringLiteral("hebrew")) {
+        // The host is the language:
+        if (is(parts->host, u"hebrew")) {
             ret.type = types.hebrew;
-        } else if (language == QStringLiteral("greek")) {
+        } else if (is(parts->host, u"greek")) {
             ret.type = types.greek;
         } else {
             return {};
         }
 
         ret.module = preferredModule(ret.type);
+        key = parts->path;
     }
-    ref = ref.mid(slashPos + 1); // The remaining part is the key
-    if (ref.isEmpty()) // require non-empty key
+    if (key.isEmpty()) // require non-empty key
         return {};
-    ret.key = ref.toString();
+    ret.key = key.toString();
     return ret;
 }
 
+std::optional<ReferenceManager::UrlParts>
+ReferenceManager::splitUrl(QStringView const url) noexcept {
+    auto const schemeEnd = url.indexOf(u"://");
+    if (schemeEnd <= 0)
+        return {};
+    auto const rest = url.mid(schemeEnd + 3);
+    auto const hostEnd = rest.indexOf(u'/');
+    if (hostEnd < 0)
+        return UrlParts{url.left(schemeEnd), rest, {}};
+    return UrlParts{url.left(schemeEnd),
+                    rest.left(hostEnd),
+                    rest.mid(hostEnd + 1)};
+}
+
 /** Parses the given verse references using the given language and the module.*/
 QString ReferenceManager::parseVerseReference(
         QString const & ref,
@@ -177,6 +197,19 @@ QString ReferenceManager::parseVerseReference(
         return {};
     }
 
+    auto const cacheKey =
+            QStringList{
+                ref,
+                options.refBase,
+                options.sourceLanguage,
+                static_cast<CSwordBibleModuleInfo const *>(mod)
+                    ->lowerBound().versification()}.join(QChar(u'\x1f'));
+    {
+        std::lock_guard const guard(parsedReferencesMutex);
+        if (auto const * const cached = parsedReferences.object(cacheKey))
+            return *cached;
+    }
+
     QString sourceLanguage = options.sourceLanguage;
 
     bool const haveLocaleForSourceLanguage =
@@ -239,5 +272,8 @@ QString ReferenceManager::parseVerseReference(
         }
     }
     backend.setBooknameLanguage(oldLocaleName);
+
+    std::lock_guard const guard(parsedReferencesMutex);
+    parsedReferences.insert(cacheKey, new QString(ret));
     return ret;
 }
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <QString>
+#include <QStringView>
 #include <optional>
 #include "../drivers/cswordmoduleinfo.h"
 
@@ -39,6 +40,19 @@ struct DecodedHyperlink {
     QString key;
 };
 
+/** The parts of an URL of the form <scheme>://<host>/<path>. */
+struct UrlParts {
+    QStringView scheme;
+    QStringView host;
+    QStringView path; ///< Empty if there is no slash after the host
+};
+
+/**
+  \brief Splits the given URL into its parts in a single pass.
+  \returns views into the given URL, or nothing if it has no scheme.
+*/
+std::optional<UrlParts> splitUrl(QStringView url) noexcept;
+
 /** Turn a hyperlink into module, key and type.
 * Decodes the given hyperlink into module, key and type.
 * @param hyperlink The hyperlink to decode
@@ -0,0 +1,164 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btchapterrendercache.h"
+
+#include <algorithm>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QSaveFile>
+#include <utility>
+#include "../../util/directory.h"
+
+
+//Increment this, if the format of the cached chapters changes
+constexpr static quint32 const BT_CHAPTER_RENDER_CACHE_VERSION = 1u;
+
+//Maximum number of chapters kept in memory by all caches together
+constexpr static std::size_t const BT_MAX_CACHED_CHAPTERS = 64u;
+
+namespace {
+
+QString chapterFileName(QByteArray const & key) {
+    return QStringLiteral("%1/rendered/%2.chapter").arg(
+                util::directory::getUserCacheDir().absolutePath(),
+                QString::fromLatin1(
+                    QCryptographicHash::hash(key, QCryptographicHash::Sha1)
+                    .toHex()));
+}
+
+} // anonymous namespace
+
+BtChapterRenderCache::BtChapterRenderCache() {
+    auto & s = shared();
+    std::lock_guard<std::mutex> const guard(s.mutex);
+    ++s.instances;
+}
+
+BtChapterRenderCache::~BtChapterRenderCache() {
+    auto & s = shared();
+    std::lock_guard<std::mutex> const guard(s.mutex);
+    if (--s.instances > 0u)
+        return;
+    for (auto const & [key, chapter] : s.chapters)
+        if (chapter.modified)
+            write(key, chapter);
+    s.chapters.clear();
+}
+
+void BtChapterRenderCache::setSettings(QByteArray settings)
+{ m_settings = std::move(settings); }
+
+std::optional<QString> BtChapterRenderCache::text(QString const & chapter,
+                                                  int const verse)
+{
+    if (!enabled())
+        return {};
+    auto & s = shared();
+    std::lock_guard<std::mutex> const guard(s.mutex);
+    auto const & verses = findChapter(s, chapter).verses;
+    if (auto const it = verses.constFind(verse); it != verses.cend())
+        return *it;
+    return {};
+}
+
+void BtChapterRenderCache::insert(QString const & chapter,
+                                  int const verse,
+                                  QString text)
+{
+    if (!enabled())
+        return;
+    auto & s = shared();
+    std::lock_guard<std::mutex> const guard(s.mutex);
+    auto & c = findChapter(s, chapter);
+    c.verses.insert(verse, std::move(text));
+    c.modified = true;
+}
+
+std::size_t BtChapterRenderCache::memoryUsage() {
+    auto & s = shared();
+    std::lock_guard<std::mutex> const guard(s.mutex);
+    std::size_t r = 0u;
+    for (auto const & [key, chapter] : s.chapters) {
+        r += static_cast<std::size_t>(key.capacity());
+        for (auto const & text : chapter.verses)
+            r += static_cast<std::size_t>(text.capacity()) * sizeof(QChar);
+    }
+    return r;
+}
+
+BtChapterRenderCache::Shared & BtChapterRenderCache::shared() {
+    static Shared s;
+    return s;
+}
+
+BtChapterRenderCache::Chapter &
+BtChapterRenderCache::findChapter(Shared & s, QString const & chapter) {
+    auto key(m_settings);
+    key.append('\n').append(chapter.toUtf8());
+    if (auto const it = s.chapters.find(key); it != s.chapters.end()) {
+        it->second.lastUse = ++s.useCounter;
+        return it->second;
+    }
+
+    // Drop the least recently used chapter:
+    if (s.chapters.size() >= BT_MAX_CACHED_CHAPTERS) {
+        auto const it =
+                std::min_element(
+                    s.chapters.begin(),
+                    s.chapters.end(),
+                    [](auto const & a, auto const & b)
+                    { return a.second.lastUse < b.second.lastUse; });
+        if (it->second.modified)
+            write(it->first, it->second);
+        s.chapters.erase(it);
+    }
+
+    Chapter c{{}, ++s.useCounter, false};
+    QFile file(chapterFileName(key));
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream s(&file);
+        s.setVersion(QDataStream::Qt_6_5);
+        quint32 version;
+        QByteArray cachedKey;
+        s >> version >> cachedKey;
+        if (s.status() == QDataStream::Ok
+            && version == BT_CHAPTER_RENDER_CACHE_VERSION
+            && cachedKey == key)
+        {
+            s >> c.verses;
+            if (s.status() != QDataStream::Ok)
+                c.verses.clear();
+        }
+    }
+    return s.chapters.emplace(std::move(key), std::move(c)).first->second;
+}
+
+void BtChapterRenderCache::write(QByteArray const & key,
+                                 Chapter const & chapter)
+{
+    auto const fileName(chapterFileName(key));
+    QDir().mkpath(QFileInfo(fileName).path());
+    QSaveFile saveFile(fileName);
+    if (saveFile.open(QIODevice::WriteOnly)) {
+        QDataStream s(&saveFile);
+        s.setVersion(QDataStream::Qt_6_5);
+        s << BT_CHAPTER_RENDER_CACHE_VERSION << key << chapter.verses;
+        if (s.status() != QDataStream::Ok || !saveFile.commit())
+            qWarning() << "Failed to write" << saveFile.fileName();
+    }
+}
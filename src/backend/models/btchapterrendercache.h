@@ -0,0 +1,105 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+
+/**
+  \brief A persistent cache of the rendered verses of chapters.
+
+  The verses are stored in one file per chapter in the user cache directory.
+  The file names are hashes of the chapter and of the settings the verses
+  were rendered with, so changing any of these just results in other files
+  being used.
+
+  A limited number of chapters is kept in memory, shared by all instances, so
+  that windows showing the same module with the same settings reuse each
+  others verses. The chapters with new verses are written when dropped from
+  memory and when the last instance is destroyed.
+
+  Every instance must only be used by a single thread, but several instances
+  may be used by different threads.
+*/
+class BtChapterRenderCache {
+
+public: // methods:
+
+    BtChapterRenderCache();
+    BtChapterRenderCache(BtChapterRenderCache const &) = delete;
+    BtChapterRenderCache & operator=(BtChapterRenderCache const &) = delete;
+    ~BtChapterRenderCache();
+
+    /**
+      \brief Sets the settings of the texts.
+      \param[in] settings All settings the texts depend on, or an empty array
+                          to disable the cache.
+    */
+    void setSettings(QByteArray settings);
+
+    bool enabled() const noexcept { return !m_settings.isEmpty(); }
+
+    /**
+      \param[in] chapter Identifies the module, its version and the chapter.
+      \returns the cached text of the given verse of the chapter, if any.
+    */
+    std::optional<QString> text(QString const & chapter, int verse);
+
+    /** \brief Caches the text of the given verse of the chapter. */
+    void insert(QString const & chapter, int verse, QString text);
+
+    /**
+      \returns the number of bytes of the texts of the chapters in memory,
+               which are shared by all instances.
+    */
+    static std::size_t memoryUsage();
+
+private: // types:
+
+    struct Chapter {
+        QHash<int, QString> verses;
+        std::uint64_t lastUse;
+        bool modified;
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        std::map<QByteArray, Chapter> chapters; ///< By settings and chapter
+        std::uint64_t useCounter = 0u;
+        std::size_t instances = 0u;
+    };
+
+private: // methods:
+
+    static Shared & shared();
+
+    /**
+      \returns the given chapter, which is read from disk if needed.
+      \pre The mutex of shared() is locked.
+    */
+    Chapter & findChapter(Shared & s, QString const & chapter);
+
+    static void write(QByteArray const & key, Chapter const & chapter);
+
+private: // fields:
+
+    QByteArray m_settings;
+
+}; /* class BtChapterRenderCache */
@@ -0,0 +1,134 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btmoduletextfinder.h"
+
+#include <memory>
+#include <QThread>
+#include <utility>
+#include "../cswordmodulesearch.h"
+#include "../drivers/cswordmoduleinfo.h"
+#include "../keys/cswordkey.h"
+#include "../keys/cswordversekey.h"
+#include "../rendering/btrendercontextpool.h"
+#include "btmoduletextmodel.h"
+
+
+BtModuleTextFinder::BtModuleTextFinder(QObject * const parent)
+    : QObject(parent)
+{}
+
+BtModuleTextFinder::~BtModuleTextFinder() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+        m_request.reset();
+    }
+    m_condition.notify_all();
+    if (m_thread)
+        m_thread->wait();
+}
+
+std::uint64_t BtModuleTextFinder::find(QStringList modules,
+                                       QString words,
+                                       int const fromRow,
+                                       bool const backward)
+{
+    std::uint64_t generation;
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        generation = ++m_generation;
+        m_request.emplace(Request{std::move(modules),
+                                  std::move(words),
+                                  fromRow,
+                                  backward,
+                                  generation});
+        if (!m_thread) {
+            m_thread.reset(QThread::create([this]{ work(); }));
+            m_thread->start(QThread::LowPriority);
+        }
+    }
+    m_condition.notify_one();
+    return generation;
+}
+
+void BtModuleTextFinder::cancel() {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    ++m_generation;
+    m_request.reset();
+}
+
+bool BtModuleTextFinder::cancelled(std::uint64_t const generation) {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return m_stopping || m_generation != generation;
+}
+
+void BtModuleTextFinder::work() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock,
+                             [this]{ return m_stopping || m_request; });
+            if (m_stopping)
+                return;
+            request = std::move(*m_request);
+            m_request.reset();
+        }
+        auto const lease(Rendering::BtRenderContextPool::instance().acquire());
+        auto & context = *lease;
+
+        auto const foundRow =
+            [this, &context, &request]() -> int {
+                auto const modules(context.findModules(request.modules));
+                if (modules.isEmpty())
+                    return -1;
+                CSwordModuleSearch::Highlighter const highlighter(
+                            request.words,
+                            true);
+                if (highlighter.isEmpty())
+                    return -1;
+
+                BtModuleTextModel model(context.backend());
+                model.setModules(request.modules);
+                auto const step = request.backward ? -1 : 1;
+                QString text; // Reused for the texts of all rows
+                for (auto row = request.fromRow;
+                     row >= 0 && row < model.rowCount();
+                     row += step)
+                {
+                    if (cancelled(request.generation))
+                        return -1;
+                    for (int i = 0; i < modules.size(); ++i) {
+                        auto const & module = *modules.at(i);
+                        if (module.type() == CSwordModuleInfo::Bible
+                            || module.type() == CSwordModuleInfo::Commentary)
+                        {
+                            auto key(model.indexToVerseKey(row, module));
+                            if (key.verse() == 0) // Intros are not shown
+                                break;
+                            key.strippedTextInto(text);
+                        } else {
+                            std::unique_ptr<CSwordKey> const key(
+                                        model.indexToKey(row, i));
+                            key->strippedTextInto(text);
+                        }
+                        if (highlighter.hasMatch(text))
+                            return row;
+                    }
+                }
+                return -1;
+            }();
+        if (!cancelled(request.generation))
+            Q_EMIT found(request.generation, foundRow);
+    }
+}
@@ -0,0 +1,99 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QObject>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <QString>
+#include <QStringList>
+
+
+class QThread;
+
+/**
+  \brief Searches the stripped text of the rows of a BtModuleTextModel for the
+         highlighted words in a background thread.
+
+  The thread uses its own CSwordBackend (see
+  CSwordBackend::createWorkerInstance()), so finding the next row containing
+  the words does not need to render all the rows in between to HTML. Since the
+  stripped text is only an approximation of the rendered text, the rows found
+  have to be confirmed by the caller, e.g. by counting the highlights in the
+  rendered row.
+*/
+class BtModuleTextFinder: public QObject {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtModuleTextFinder(QObject * parent = nullptr);
+    ~BtModuleTextFinder() override;
+
+    /**
+      \brief Starts searching, cancelling any previous search.
+      \param[in] modules The modules of the model searched.
+      \param[in] words The highlighted words to search for.
+      \param[in] fromRow The first row to search.
+      \param[in] backward Whether to search towards the first row.
+      \returns the generation of the search, as passed to found().
+    */
+    std::uint64_t find(QStringList modules,
+                       QString words,
+                       int fromRow,
+                       bool backward);
+
+    /** \brief Cancels any running search. */
+    void cancel();
+
+Q_SIGNALS:
+
+    /**
+      \brief Emitted when a search has finished.
+      \param[in] generation The generation returned by find().
+      \param[in] row The row found, or -1 if the words were not found.
+    */
+    void found(quint64 generation, int row);
+
+private: // types:
+
+    struct Request {
+        QStringList modules;
+        QString words;
+        int fromRow;
+        bool backward;
+        std::uint64_t generation;
+    };
+
+private: // methods:
+
+    void work();
+
+    /** \returns whether the search of the given generation was cancelled. */
+    bool cancelled(std::uint64_t generation);
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::optional<Request> m_request;
+    std::uint64_t m_generation = 0u;
+    std::unique_ptr<QThread> m_thread;
+    bool m_stopping = false;
+
+}; /* class BtModuleTextFinder */
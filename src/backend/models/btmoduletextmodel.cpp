@@ -13,21 +13,38 @@
 #include <QTextEdit>
 #include "btmoduletextmodel.h"
 
+#include <algorithm>
+#include <QMetaObject>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QThread>
+#include <QTimerEvent>
 #include "../../util/btassert.h"
+#include "../../util/btconnect.h"
+#include "../../util/bttrace.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../drivers/cswordbiblemoduleinfo.h"
 #include "../drivers/cswordbookmoduleinfo.h"
 #include "../drivers/cswordlexiconmoduleinfo.h"
+#include "../config/btconfig.h"
 #include "../cswordmodulesearch.h"
+#include "../keys/btversificationmapping.h"
+#include "../keys/btversificationtable.h"
 #include "../keys/cswordtreekey.h"
 #include "../keys/cswordversekey.h"
+#include "../managers/cdisplaytemplatemgr.h"
 #include "../managers/colormanager.h"
 #include "../managers/cswordbackend.h"
 #include "../rendering/ctextrendering.h"
+#include "btmoduletextrenderer.h"
 
 
+//Maximum number of rendered rows (per role) kept for repeated requests
+constexpr static qsizetype const BT_MAX_CACHED_ROWS = 512;
+
+//Minimum number of characters of the rows of entries split into several rows
+constexpr static qsizetype const BT_ENTRY_CHUNK_SIZE = 16 * 1024;
+
 namespace {
 
 DisplayOptions const defaultDisplayOptions = []() noexcept {
@@ -54,6 +71,13 @@ FilterOptions const defaultFilterOptions = []() noexcept {
     return opts;
 }();
 
+// Only these roles are expensive enough to be rendered asynchronously:
+bool isRenderedTextRole(int const role) noexcept {
+    return role == ModuleEntry::TextRole
+           || (role >= ModuleEntry::Text0Role
+               && role <= ModuleEntry::Text9Role);
+}
+
 QStringList splitText(QString const & text) {
     QStringList parts;
     int from = 0;
@@ -195,11 +219,8 @@ QString processText(const QString &text) {
     if (text.isEmpty())
         return text;
     QString localText = text;
-    { // Fix !P tag which is not rich text:
-        int index = 0;
-        while ((index = localText.indexOf(QStringLiteral("<!P>"))) >= 0)
-            localText.remove(index,4);
-    }
+    // Fix !P tag which is not rich text:
+    localText.remove(QStringLiteral("<!P>"));
     auto parts = splitText(localText);
     fixDoubleBR(parts);
 
@@ -226,107 +247,562 @@ QString processText(const QString &text) {
     return parts.join(QString());
 }
 
+/**
+  \returns the given text split after the ends of paragraphs into chunks of at
+           least the given number of characters, except for the last one.
+*/
+QStringList splitIntoChunks(QString const & text, qsizetype const chunkSize) {
+    static QRegularExpression const paragraphEnd(
+                QStringLiteral(R"PCRE(</p>|</div>|<br\s*/?>)PCRE"),
+                QRegularExpression::CaseInsensitiveOption);
+    QStringList chunks;
+    qsizetype start = 0;
+    for (auto it = paragraphEnd.globalMatch(text); it.hasNext();) {
+        auto const end = it.next().capturedEnd();
+        if (end - start >= chunkSize && end < text.size()) {
+            chunks.append(text.mid(start, end - start));
+            start = end;
+        }
+    }
+    chunks.append(text.mid(start));
+    return chunks;
+}
+
 } // anonymous namespace
 
 BtModuleTextModel::BtModuleTextModel(QObject *parent)
+    : BtModuleTextModel(CSwordBackend::instance(), parent)
+{}
+
+BtModuleTextModel::BtModuleTextModel(CSwordBackend & backend,
+                                     QObject * const parent)
     : QAbstractListModel(parent)
+    , m_backend(backend)
     , m_firstEntry(0)
     , m_maxEntries(0)
     , m_displayRendering(defaultDisplayOptions, defaultFilterOptions)
+    , m_renderCache(BT_MAX_CACHED_ROWS)
 {}
 
+BtModuleTextModel::~BtModuleTextModel() = default;
+
 void BtModuleTextModel::reloadModules() {
+    cancelPrefetch();
     m_moduleInfoList.clear();
     for (auto const & moduleName : m_modules)
         m_moduleInfoList.append(
-                    CSwordBackend::instance().findModuleByName(
-                        moduleName));
+                    m_backend.findModuleByName(moduleName));
 
     beginResetModel();
+    m_renderCache.clear();
+    resetChunks();
+
+    // Keep the views responsive while slow modules are rendered:
+    if (m_asyncRenderingForSlowModules)
+        m_asyncRendering = m_asyncRenderingForSlowModules = false;
+    if (!m_asyncRendering && !m_renderingUnavailable && hasSlowModules())
+        m_asyncRendering = m_asyncRenderingForSlowModules = true;
+
+    updateRenderer(true);
+    updateRendererThreads();
     const CSwordModuleInfo* firstModule = m_moduleInfoList.at(0);
+    m_versificationTable.reset();
     if (isBible() || isCommentary()) {
         CSwordBibleModuleInfo const * const m =
             static_cast<const CSwordBibleModuleInfo *>(firstModule);
-        m_firstEntry = m->lowerBound().index();
+        auto const lowerBound(m->lowerBound());
+        m_firstEntry = lowerBound.index();
         m_maxEntries = m->upperBound().index() - m_firstEntry + 1;
+        m_versificationTable =
+                BtVersificationTable::forVersification(
+                    lowerBound.versification());
     } else if(isLexicon()) {
-        m_maxEntries =
-                static_cast<CSwordLexiconModuleInfo const *>(firstModule)
-                ->entries().size();
+        auto const & lexicon =
+                *static_cast<CSwordLexiconModuleInfo const *>(firstModule);
+        if (lexicon.seeksDirectly()) {
+            if (!m_directEntryKey)
+                m_directEntryKey.emplace();
+            m_maxEntries = 1;
+            m_backend.buildLexiconCache(lexicon.name());
+        } else {
+            m_directEntryKey.reset();
+            m_maxEntries = lexicon.entries().size();
+        }
     } else if(isBook()) {
-        sword::TreeKeyIdx tk(
-                    *static_cast<CSwordBookModuleInfo const *>(firstModule)
-                    ->tree());
-        tk.root();
-        tk.firstChild();
-        BT_ASSERT(tk.getOffset() == 4);
-        tk.setPosition(sword::BOTTOM);
-        m_maxEntries = tk.getOffset() / 4;
+        auto const & toc =
+                static_cast<CSwordBookModuleInfo const *>(firstModule)
+                ->tableOfContents();
+        BT_ASSERT(toc.node(0).firstChild < 0
+                  || toc.node(toc.node(0).firstChild).offset == 4);
+        m_maxEntries = static_cast<int>(toc.maxOffset() / 4);
     }
+    updateChapterCache();
 
     endResetModel();
 }
 
+void BtModuleTextModel::setDirectEntryKey(QString key) {
+    if (!m_directEntryKey || *m_directEntryKey == key)
+        return;
+    *m_directEntryKey = std::move(key);
+    cancelPrefetch();
+    m_renderCache.clear();
+    resetChunks();
+    updateRenderer(true);
+    Q_EMIT dataChanged(index(0), index(0));
+}
+
 void BtModuleTextModel::setModules(const QStringList& modules) {
     m_modules = modules;
     reloadModules();
 }
 
 
+void BtModuleTextModel::setAsyncRendering(bool const enabled) {
+    m_asyncRenderingForSlowModules = false;
+    if (enabled == m_asyncRendering)
+        return;
+    m_asyncRendering = enabled;
+    updateRendererThreads();
+    if (!enabled) {
+        // Replace any placeholders shown:
+        beginResetModel();
+        endResetModel();
+    }
+}
+
+void BtModuleTextModel::setChunkLargeEntries(bool const enabled) {
+    if (enabled == m_chunkLargeEntries)
+        return;
+    beginResetModel();
+    cancelPrefetch();
+    m_chunkLargeEntries = enabled;
+    m_renderCache.clear();
+    resetChunks();
+    endResetModel();
+}
+
+bool BtModuleTextModel::chunkingEntries() const {
+    return m_chunkLargeEntries
+           && !m_moduleInfoList.isEmpty()
+           && (isLexicon() || isBook());
+}
+
+void BtModuleTextModel::resetChunks() {
+    m_entryChunkCounts.clear();
+    m_extraRows = 0;
+    ++m_chunkGeneration;
+    m_lastChunkedEntry.reset();
+}
+
+std::pair<int, int> BtModuleTextModel::rowToEntry(int const row) const {
+    int extraRows = 0;
+    for (auto const & [chunkedEntry, numChunks] : m_entryChunkCounts) {
+        auto const firstRow = chunkedEntry + extraRows;
+        if (row < firstRow)
+            break;
+        if (row < firstRow + numChunks)
+            return {chunkedEntry, row - firstRow};
+        extraRows += numChunks - 1;
+    }
+    return {row - extraRows, 0};
+}
+
+int BtModuleTextModel::entryToRow(int const entry) const {
+    auto row = entry;
+    for (auto const & [chunkedEntry, numChunks] : m_entryChunkCounts) {
+        if (chunkedEntry >= entry)
+            break;
+        row += numChunks - 1;
+    }
+    return row;
+}
+
+int BtModuleTextModel::splitEntry(int const entry) {
+    if (!chunkingEntries())
+        return 1;
+    entryText(entryToRow(entry), ModuleEntry::Text0Role);
+    if (m_lastChunkedEntry && m_lastChunkedEntry->entry == entry)
+        insertChunkRows(entry,
+                        static_cast<int>(m_lastChunkedEntry->chunks.size()),
+                        m_chunkGeneration);
+    auto const it = m_entryChunkCounts.find(entry);
+    return (it == m_entryChunkCounts.end()) ? 1 : it->second;
+}
+
+void BtModuleTextModel::insertChunkRows(int const entry,
+                                        int const numChunks,
+                                        std::uint64_t const generation)
+{
+    if (generation != m_chunkGeneration
+        || numChunks < 2
+        || m_entryChunkCounts.contains(entry))
+        return;
+    auto const row = entryToRow(entry);
+    cancelPrefetch();
+    // The rows after the entry move, so their cached texts are outdated:
+    for (auto const & key : m_renderCache.keys())
+        if (key.first > row)
+            m_renderCache.remove(key);
+    beginInsertRows(QModelIndex(), row + 1, row + numChunks - 1);
+    m_entryChunkCounts.emplace(entry, numChunks);
+    m_extraRows += numChunks - 1;
+    if (m_findState && m_findState->index > row)
+        m_findState->index += numChunks - 1;
+    endInsertRows();
+}
+
+void BtModuleTextModel::setParallelColumnRendering(bool const enabled) {
+    m_parallelColumnRendering = enabled;
+    updateRendererThreads();
+}
+
+void BtModuleTextModel::updateRendererThreads() {
+    if (!m_asyncRendering && !m_parallelColumnRendering) {
+        m_renderer.reset();
+        return;
+    }
+    if (!m_renderer) {
+        m_renderer = std::make_unique<BtModuleTextRenderer>();
+        BT_CONNECT(m_renderer.get(), &BtModuleTextRenderer::rowRendered,
+                   this,
+                   [this](quint64 const generation,
+                          int const row,
+                          int const role,
+                          QString text)
+                   { rowRendered(generation, row, role, std::move(text)); });
+        BT_CONNECT(m_renderer.get(),
+                   &BtModuleTextRenderer::renderingUnavailable,
+                   this,
+                   [this]{
+                       m_parallelColumnRendering = false;
+                       m_renderingUnavailable = true;
+                       setAsyncRendering(false);
+                       updateRendererThreads();
+                   },
+                   Qt::QueuedConnection);
+        updateRenderer(true);
+    }
+    m_renderer->setMaxThreads(
+                m_parallelColumnRendering
+                ? std::min(static_cast<int>(m_moduleInfoList.size()),
+                           QThread::idealThreadCount())
+                : 1);
+}
+
+void BtModuleTextModel::setViewportRow(int const row) {
+    if (m_renderer)
+        m_renderer->setViewportRow(row);
+}
+
+void BtModuleTextModel::setPrefetchWindow(int const rowsAhead,
+                                          int const rowsBehind)
+{
+    m_prefetchRowsAhead = std::max(rowsAhead, 0);
+    m_prefetchRowsBehind = std::max(rowsBehind, 0);
+}
+
+void BtModuleTextModel::prefetchRows(int const index, int const direction) {
+    cancelPrefetch();
+    if (index < 0 || index >= rowCount())
+        return;
+
+    // Queue the rows in the direction of navigation first, nearest first:
+    auto const step = (direction < 0) ? -1 : 1;
+    auto const queueRows =
+            [this, index](int const rowStep, int const numRows) {
+                for (int i = 1; i <= numRows; ++i) {
+                    auto const row = index + rowStep * i;
+                    if (row < 0 || row >= rowCount())
+                        break;
+                    m_prefetchQueue.push_back(row);
+                }
+            };
+    auto const factor = hasSlowModules() ? 2 : 1;
+    queueRows(step, m_prefetchRowsAhead * factor);
+    queueRows(-step, m_prefetchRowsBehind * factor);
+    if (m_prefetchQueue.empty())
+        return;
+
+    if (m_asyncRendering && !chunkingEntries()) {
+        // The background renderer prioritizes the rows by itself:
+        for (auto const row : m_prefetchQueue)
+            for (int column = 0; column < m_moduleInfoList.size(); ++column)
+                if (!m_renderCache.contains(
+                        std::pair<int, int>(row,
+                                            ModuleEntry::Text0Role + column)))
+                    m_renderer->requestRow(row,
+                                           ModuleEntry::Text0Role + column);
+        m_prefetchQueue.clear();
+        return;
+    }
+    std::reverse(m_prefetchQueue.begin(), m_prefetchQueue.end());
+    m_prefetchTimerId = startTimer(0);
+}
+
+bool BtModuleTextModel::hasSlowModules() const {
+    return std::any_of(m_moduleInfoList.begin(),
+                       m_moduleInfoList.end(),
+                       [](CSwordModuleInfo const * const module)
+                       { return module && module->renderTimes().isSlow(); });
+}
+
+std::size_t BtModuleTextModel::renderCacheMemoryUsage() const noexcept
+{ return m_renderCacheBytes; }
+
+void BtModuleTextModel::cancelPrefetch() {
+    m_prefetchQueue.clear();
+    if (m_prefetchTimerId) {
+        killTimer(m_prefetchTimerId);
+        m_prefetchTimerId = 0;
+    }
+}
+
+void BtModuleTextModel::timerEvent(QTimerEvent * const event) {
+    if (!m_prefetchTimerId || event->timerId() != m_prefetchTimerId)
+        return QAbstractListModel::timerEvent(event);
+    event->accept();
+
+    // Render a single uncached row per event to keep the GUI responsive:
+    while (!m_prefetchQueue.empty()) {
+        auto const row = m_prefetchQueue.back();
+        m_prefetchQueue.pop_back();
+        bool rendered = false;
+        for (int column = 0; column < m_moduleInfoList.size(); ++column) {
+            auto const role = ModuleEntry::Text0Role + column;
+            if (!m_renderCache.contains(std::pair<int, int>(row, role))) {
+                renderRow(row, role);
+                rendered = true;
+            }
+        }
+        if (rendered)
+            return;
+    }
+    cancelPrefetch();
+}
+
+void BtModuleTextModel::updateRenderer(bool const dropRequests) {
+    if (!m_renderer)
+        return;
+    m_renderer->setSettings({m_modules,
+                             m_displayRendering.displayOptions(),
+                             m_displayRendering.filterOptions(),
+                             m_highlightWords,
+                             m_findState,
+                             m_directEntryKey,
+                             ++m_renderGeneration},
+                            dropRequests);
+}
+
+void BtModuleTextModel::rowRendered(std::uint64_t const generation,
+                                    int const row,
+                                    int const role,
+                                    QString text)
+{
+    if (row < 0 || row >= rowCount())
+        return;
+    if (generation == m_renderGeneration)
+        m_renderCache.insert(std::pair<int, int>(row, role),
+                             new CachedText(std::move(text),
+                                            m_renderCacheBytes));
+    // Rows rendered using outdated settings are just requested again:
+    QList<int> roles{role};
+    for (auto r = role + 1; r <= ModuleEntry::Text9Role; ++r)
+        if (canonicalRole(r) == role)
+            roles.append(r);
+    auto const i = index(row, 0);
+    Q_EMIT dataChanged(i, i, roles);
+}
+
+std::atomic<std::uint64_t> BtModuleTextModel::s_dataCalls{0u};
+std::atomic<std::uint64_t> BtModuleTextModel::s_renderCacheHits{0u};
+std::atomic<std::uint64_t> BtModuleTextModel::s_renderCacheMisses{0u};
+
 QVariant BtModuleTextModel::data(const QModelIndex & index, int role) const {
+    BT_TRACE_SPAN("text model data");
+    s_dataCalls.fetch_add(1u, std::memory_order_relaxed);
+    role = canonicalRole(role);
+    /* The rows of entries split into several rows are only known after the
+       entries are rendered, so these are rendered right away: */
+    if (m_asyncRendering && isRenderedTextRole(role) && !chunkingEntries()) {
+        // The views request the same rows over and over while scrolling:
+        if (auto const * const cached =
+                m_renderCache.object(std::pair<int, int>(index.row(), role)))
+        {
+            s_renderCacheHits.fetch_add(1u, std::memory_order_relaxed);
+            return QVariant(cached->text);
+        }
 
-    QString text;
-    if (isBible() || isCommentary())
-        text = verseData(index, role);
-    else if (isBook())
-        text = bookData(index, role);
-    else if (isLexicon())
-        text = lexiconData(index, role);
-    else
-        text = QStringLiteral("invalid");
+        // Reading a cached chapter is cheaper than a round trip to a thread:
+        if (auto const key = chapterCacheKey(index.row(), role);
+            key && m_chapterCache.text(key->first, key->second))
+            return QVariant(renderRow(index.row(), role));
+
+        s_renderCacheMisses.fetch_add(1u, std::memory_order_relaxed);
+        m_renderer->requestRow(index.row(), role);
+        return QVariant(
+                    QStringLiteral("<span style=\"color:gray\">%1</span>")
+                    .arg(indexToKeyName(index.row()).toHtmlEscaped()));
+    }
+    return QVariant(renderRow(index.row(), role));
+}
 
-    text = processText(text);
+int BtModuleTextModel::canonicalRole(int const role) const {
+    // Verse keyed columns without a module of their own show the first one:
+    if (role > ModuleEntry::Text0Role
+        && role <= ModuleEntry::Text9Role
+        && role - ModuleEntry::Text0Role >= m_moduleInfoList.size()
+        && (isBible() || isCommentary()))
+        return ModuleEntry::Text0Role;
+    return role;
+}
+
+std::optional<QString> BtModuleTextModel::renderedRow(int const row,
+                                                      int const role) const
+{
+    if (auto const * const cached =
+            m_renderCache.object(std::pair<int, int>(row, canonicalRole(role))))
+        return cached->text;
+    return {};
+}
+
+QString BtModuleTextModel::renderRow(int const row, int role) const {
+    if (row < 0 || row >= rowCount())
+        return {};
+    role = canonicalRole(role);
+
+    // The views request the same rows over and over while scrolling:
+    std::pair<int, int> cacheKey(row, role);
+    if (auto const * const cached = m_renderCache.object(cacheKey)) {
+        s_renderCacheHits.fetch_add(1u, std::memory_order_relaxed);
+        return cached->text;
+    }
+    s_renderCacheMisses.fetch_add(1u, std::memory_order_relaxed);
+
+    // The views request all columns of a row, so render them concurrently:
+    if (m_parallelColumnRendering
+        && m_renderer
+        && role >= ModuleEntry::Text0Role
+        && role <= ModuleEntry::Text9Role
+        && m_moduleInfoList.size() > 1
+        && (isBible() || isCommentary()))
+    {
+        std::vector<int> roles;
+        for (int column = 0; column < m_moduleInfoList.size(); ++column) {
+            auto const columnRole = ModuleEntry::Text0Role + column;
+            if (!m_renderCache.contains(std::pair<int, int>(row, columnRole)))
+                roles.push_back(columnRole);
+        }
+        auto texts(m_renderer->renderNow(row, roles));
+        for (std::size_t i = 0u; i < roles.size(); ++i)
+            if (texts[i])
+                m_renderCache.insert(std::pair<int, int>(row, roles[i]),
+                                     new CachedText(std::move(*texts[i]),
+                                                    m_renderCacheBytes));
+        if (auto const * const cached = m_renderCache.object(cacheKey))
+            return cached->text;
+    }
+
+    auto const chapterKey = chapterCacheKey(row, role);
+    QString text;
+    if (auto cached = chapterKey
+                      ? m_chapterCache.text(chapterKey->first,
+                                            chapterKey->second)
+                      : std::nullopt)
+    {
+        text = std::move(*cached);
+    } else if (isBook() || isLexicon()) {
+        text = entryText(row, role);
+    } else if (chapterKey && m_renderWholeChapters) {
+        text = renderChapter(row, role, chapterKey->first);
+    } else {
+        if (isBible() || isCommentary())
+            text = verseData(this->index(row, 0), role);
+        else
+            text = QStringLiteral("invalid");
+
+        text = processText(text);
+        if (chapterKey)
+            m_chapterCache.insert(chapterKey->first, chapterKey->second, text);
+    }
 
     if ( ! m_highlightWords.isEmpty()) {
-        auto t = CSwordModuleSearch::highlightSearchedText(text,
-                                                           m_highlightWords,
-                                                           true);
-        if (m_findState && index.row() == m_findState->index) {
+        auto t = m_highlighter.apply(text);
+        if (m_findState && row == m_findState->index) {
             // t = highlightFindPreviousNextField(t); now inlined:
             int from = 0;
+            bool found = true;
             for (int i = 0; i < m_findState->subIndex; ++i) {
                 int pos = t.indexOf(QStringLiteral("\"highlightwords\""), from);
-                if (pos == -1)
-                    return t;
-                else {
+                if (pos == -1) {
+                    found = false; // The text is cached all the same
+                    break;
+                } else {
                     from = pos + 1;
                 }
             }
-            int position = from + 14; // highlightwords = 14, quote was already added
-            t.insert(position, '2');
+            if (found) {
+                // highlightwords = 14, quote was already added:
+                int position = from + 14;
+                t.insert(position, '2');
+            }
         }
-        return QVariant(t);
+        text = std::move(t);
     }
 
-    return QVariant(text);
+    m_renderCache.insert(std::move(cacheKey),
+                         new CachedText(text, m_renderCacheBytes));
+    return text;
 }
 
-QString BtModuleTextModel::lexiconData(const QModelIndex & index, int role) const {
-    int row = index.row();
+QString BtModuleTextModel::entryText(int const row, int const role) const {
+    auto const [entry, chunk] = rowToEntry(row);
+    if (m_lastChunkedEntry
+        && m_lastChunkedEntry->entry == entry
+        && m_lastChunkedEntry->role == role)
+        return m_lastChunkedEntry->chunks.value(chunk);
+
+    auto text = processText(isBook()
+                            ? bookData(entry, role)
+                            : lexiconData(entry, role));
+    if (!chunkingEntries()
+        || !isRenderedTextRole(role)
+        || text.size() <= BT_ENTRY_CHUNK_SIZE)
+        return text;
 
+    auto chunks(splitIntoChunks(text, BT_ENTRY_CHUNK_SIZE));
+    if (chunks.size() > 1 && !m_entryChunkCounts.contains(entry)) {
+        // Rows can not be inserted while the views request data:
+        auto * const self = const_cast<BtModuleTextModel *>(this);
+        QMetaObject::invokeMethod(
+                    self,
+                    [self,
+                     entry,
+                     numChunks = static_cast<int>(chunks.size()),
+                     generation = m_chunkGeneration]
+                    { self->insertChunkRows(entry, numChunks, generation); },
+                    Qt::QueuedConnection);
+    }
+    text = chunks.value(chunk);
+    m_lastChunkedEntry.emplace(ChunkedEntry{entry, role, std::move(chunks)});
+    return text;
+}
+
+QString BtModuleTextModel::lexiconData(int const entry, int role) const {
     const CSwordLexiconModuleInfo *lexiconModule = qobject_cast<const CSwordLexiconModuleInfo*>(m_moduleInfoList.at(0));
     BtConstModuleList moduleList;
     moduleList << lexiconModule;
-    QString keyName = lexiconModule->entries()[row];
+    QString keyName = m_directEntryKey
+                      ? *m_directEntryKey
+                      : lexiconModule->entries()[entry];
 
     if (role == ModuleEntry::TextRole || role == ModuleEntry::Text0Role) {
         if (keyName.isEmpty())
             return {};
-        auto text = m_displayRendering.renderDisplayEntry(moduleList, keyName);
-        text.replace(QStringLiteral("#CHAPTERTITLE#"), QString());
-        text.replace(QStringLiteral("#TEXT_ALIGN#"), QStringLiteral("left"));
-        text = ColorManager::replaceColors(text);
-        return text;
+        return ColorManager::replaceColors(
+                    m_displayRendering.renderDisplayEntry(moduleList, keyName),
+                    {{u"CHAPTERTITLE", QStringView()},
+                     {u"TEXT_ALIGN", u"left"}});
     }
     else if (role == ModuleEntry::ReferenceRole){
         return keyName;
@@ -334,12 +810,12 @@ QString BtModuleTextModel::lexiconData(const QModelIndex & index, int role) cons
     return QString();
 }
 
-QString BtModuleTextModel::bookData(const QModelIndex & index, int role) const {
+QString BtModuleTextModel::bookData(int const entry, int role) const {
     if (role == ModuleEntry::TextRole ||
             role == ModuleEntry::Text0Role) {
         const CSwordBookModuleInfo *bookModule = qobject_cast<const CSwordBookModuleInfo*>(m_moduleInfoList.at(0));
         CSwordTreeKey key(bookModule->tree(), bookModule);
-        int bookIndex = index.row() * 4;
+        int bookIndex = entry * 4;
         key.setOffset(bookIndex);
         BtConstModuleList moduleList;
         moduleList << bookModule;
@@ -371,19 +847,22 @@ static int getColumnFromRole(int role) {
 
 QString BtModuleTextModel::verseData(const QModelIndex & index, int role) const {
     int row = index.row();
-    CSwordVerseKey key = indexToVerseKey(row);
-    int verse = key.verse();
+    BT_ASSERT(m_versificationTable);
+    auto const position = m_versificationTable->position(row + m_firstEntry);
+    int verse = position.verse;
 
     if (role >= ModuleEntry::TextRole && role <= ModuleEntry::Edit9Role) {
         if (verse == 0)
             return QString();
+        CSwordVerseKey key = indexToVerseKey(row);
         QString text;
 
         QString chapterTitle;
         if (verse == 1)
             chapterTitle =
-                    QStringLiteral("%1 %2").arg(key.bookName(),
-                                                QString::number(key.chapter()));
+                    QStringLiteral("%1 %2").arg(
+                        key.bookName(),
+                        QString::number(position.chapter));
 
         BtConstModuleList modules;
         if ( role == ModuleEntry::TextRole) {
@@ -420,9 +899,8 @@ QString BtModuleTextModel::verseData(const QModelIndex & index, int role) const
                                               "<small>%1</small></span>")
                                .arg(tr("Click to edit"))
                              : rawText);
-                return CSwordModuleSearch::highlightSearchedText(
-                            ColorManager::replaceColors(std::move(text)),
-                            m_highlightWords);
+                return m_queryHighlighter.apply(
+                            ColorManager::replaceColors(std::move(text)));
             }
         }
 
@@ -435,10 +913,9 @@ QString BtModuleTextModel::verseData(const QModelIndex & index, int role) const
                     ? Rendering::CTextRendering::KeyTreeItem::Settings::SimpleKey
                     : Rendering::CTextRendering::KeyTreeItem::Settings::NoKey);
 
-        text.replace(QStringLiteral("#CHAPTERTITLE#"), chapterTitle);
-        text.replace(QStringLiteral("#TEXT_ALIGN#"), QStringLiteral("left"));
-        text = ColorManager::replaceColors(text);
-        return text;
+        return ColorManager::replaceColors(std::move(text),
+                                           {{u"CHAPTERTITLE", chapterTitle},
+                                            {u"TEXT_ALIGN", u"left"}});
     }
     return QString();
 }
@@ -448,7 +925,7 @@ int BtModuleTextModel::columnCount(const QModelIndex & /*parent*/) const {
 }
 
 int BtModuleTextModel::rowCount(const QModelIndex & /*parent*/) const {
-    return m_maxEntries;
+    return m_maxEntries + m_extraRows;
 }
 
 QHash<int, QByteArray> BtModuleTextModel::roleNames() const {
@@ -513,7 +990,7 @@ bool BtModuleTextModel::isLexicon() const {
 // Function is valid for Bibles, Commentaries, and Books
 int BtModuleTextModel::keyToIndex(CSwordKey const & key) const {
     if (auto const * const treeKey = dynamic_cast<CSwordTreeKey const *>(&key))
-        return treeKey->offset() / 4u;
+        return entryToRow(static_cast<int>(treeKey->offset() / 4u));
     if (auto const * const vKey = dynamic_cast<CSwordVerseKey const *>(&key))
         return vKey->index();
     return 0;
@@ -533,18 +1010,31 @@ BtModuleTextModel::indexToVerseKey(int index,
 {
     CSwordVerseKey key(&module);
     key.setIntros(true);
-    key.setIndex(index + m_firstEntry);
+    long keyIndex = index + m_firstEntry;
+
+    // Map the verse to the versification of the module like rendering does:
+    if (m_versificationTable) {
+        auto const & versification = m_versificationTable->versification();
+        if (auto const moduleVersification = key.versification();
+            moduleVersification != versification)
+        {
+            keyIndex = BtVersificationMapping::forVersifications(
+                           versification,
+                           moduleVersification)->mappedIndex(keyIndex);
+            if (keyIndex < 0) {
+                auto r(indexToVerseKey(index));
+                r.setModule(&module);
+                return r;
+            }
+        }
+    }
+    key.setIndex(keyIndex);
     return key;
 }
 
-int BtModuleTextModel::indexToVerse(int index) const
-{
-    const CSwordModuleInfo* module = m_moduleInfoList.at(0);
-    CSwordVerseKey key(module);
-
-    key.setIntros(true);
-    key.setIndex(index + m_firstEntry);
-    return key.verse();
+int BtModuleTextModel::indexToVerse(int index) const {
+    BT_ASSERT(m_versificationTable);
+    return m_versificationTable->position(index + m_firstEntry).verse;
 }
 
 CSwordKey* BtModuleTextModel::indexToKey(int index, int moduleNum) const
@@ -572,32 +1062,165 @@ QString BtModuleTextModel::indexToKeyName(int index) const {
     if (isBible() || isCommentary())
         return indexToVerseKey(index).key();
     if (isBook())
-        return indexToBookKey(index).key();
+        return indexToBookKey(rowToEntry(index).first).key();
     if (isLexicon())
-        return qobject_cast<CSwordLexiconModuleInfo const *>(
-                    m_moduleInfoList.at(0))->entries()[index];
+        return m_directEntryKey
+               ? *m_directEntryKey
+               : qobject_cast<CSwordLexiconModuleInfo const *>(
+                     m_moduleInfoList.at(0))->entries()[
+                         rowToEntry(index).first];
     return QStringLiteral("???");
 }
 
 void BtModuleTextModel::setFindState(std::optional<FindState> findState) {
+    std::optional<int> oldRowToClear;
     if (m_findState
         && (!findState || (m_findState->index != findState->index)))
-    {
-        QModelIndex oldIndexToClear = index(m_findState->index, 0);
-        m_findState = std::move(findState);
+        oldRowToClear = m_findState->index;
+    m_findState = std::move(findState);
+    updateRenderer(false);
+    if (oldRowToClear) {
+        QModelIndex oldIndexToClear = index(*oldRowToClear, 0);
+        uncacheRow(*oldRowToClear);
         Q_EMIT dataChanged(oldIndexToClear, oldIndexToClear);
-    } else {
-        m_findState = std::move(findState);
     }
     if (m_findState) {
         QModelIndex index = this->index(m_findState->index, 0);
+        uncacheRow(m_findState->index);
         Q_EMIT dataChanged(index, index);
     }
 }
+
+void BtModuleTextModel::updateChapterCache() {
+    QByteArray settings;
+    if (!m_moduleInfoList.isEmpty()
+        && (isBible() || isCommentary())
+        && btConfig().value<bool>(QStringLiteral("GUI/cacheRenderedChapters"),
+                                  true))
+    {
+        auto const & f = m_displayRendering.filterOptions();
+        auto const & d = m_displayRendering.displayOptions();
+        for (auto const option
+             : {f.footnotes, f.strongNumbers, f.headings, f.morphTags,
+                f.lemmas, f.hebrewPoints, f.hebrewCantillation,
+                f.greekAccents, f.textualVariants, f.redLetterWords,
+                f.scriptureReferences, f.morphSegmentation,
+                d.lineBreaks, d.verseNumbers})
+            settings.append(QByteArray::number(option)).append(',');
+        for (auto const & value
+             : {CDisplayTemplateMgr::activeTemplateName(),
+                ColorManager::getForegroundColor(),
+                ColorManager::getBackgroundColor(),
+                ColorManager::getCrossRefColor(),
+                m_backend.booknameLanguage()})
+            settings.append(value.toUtf8()).append('\n');
+    }
+    m_chapterCache.setSettings(std::move(settings));
+    m_renderWholeChapters =
+            btConfig().value<bool>(QStringLiteral("GUI/renderWholeChapters"),
+                                   false);
+}
+
+std::optional<std::pair<QString, int>>
+BtModuleTextModel::chapterCacheKey(int const row, int role) const {
+    if (!m_chapterCache.enabled())
+        return {};
+    role = canonicalRole(role);
+    if (role < ModuleEntry::Text0Role || role > ModuleEntry::Text9Role)
+        return {};
+    auto const column = role - ModuleEntry::Text0Role;
+    auto const * const module =
+            m_moduleInfoList.at(column < m_moduleInfoList.size() ? column : 0);
+    if (!module || module->isWritable())
+        return {};
+
+    BT_ASSERT(m_versificationTable);
+    auto const position = m_versificationTable->position(row + m_firstEntry);
+    if (position.verse == 0)
+        return {};
+    return std::pair<QString, int>(
+                QStringLiteral("%1\n%2\n%3 %4 %5").arg(
+                    module->name(),
+                    module->config(CSwordModuleInfo::ModuleVersion),
+                    QString::number(position.testament),
+                    QString::number(position.book),
+                    QString::number(position.chapter)),
+                position.verse);
+}
+
+QString BtModuleTextModel::renderChapter(int const row,
+                                         int const role,
+                                         QString const & chapter) const
+{
+    BT_ASSERT(m_versificationTable);
+    auto const positionOf =
+            [this](int const r)
+            { return m_versificationTable->position(r + m_firstEntry); };
+    auto const position = positionOf(row);
+    auto const inChapter =
+            [&position](BtVersificationTable::Position const & p) {
+                return p.verse > 0
+                       && p.chapter == position.chapter
+                       && p.book == position.book
+                       && p.testament == position.testament;
+            };
+    auto firstRow = row;
+    while (firstRow > 0 && inChapter(positionOf(firstRow - 1)))
+        --firstRow;
+    auto lastRow = row;
+    while (lastRow + 1 < rowCount() && inChapter(positionOf(lastRow + 1)))
+        ++lastRow;
+
+    auto const column = canonicalRole(role) - ModuleEntry::Text0Role;
+    BtConstModuleList modules;
+    modules.append(m_moduleInfoList.at(column < m_moduleInfoList.size()
+                                       ? column
+                                       : 0));
+    auto const lowerBound(indexToVerseKey(firstRow));
+    auto texts(m_displayRendering.renderDisplayEntries(
+                   modules,
+                   lowerBound,
+                   indexToVerseKey(lastRow),
+                   m_displayRendering.displayOptions().verseNumbers
+                   ? Rendering::CTextRendering::KeyTreeItem::Settings::SimpleKey
+                   : Rendering::CTextRendering::KeyTreeItem::Settings::NoKey));
+
+    QString r;
+    for (std::size_t i = 0u; i < texts.size(); ++i) {
+        auto const verseRow = firstRow + static_cast<int>(i);
+        auto const verse = positionOf(verseRow).verse;
+        auto const chapterTitle =
+                (verse == 1)
+                ? QStringLiteral("%1 %2").arg(
+                      lowerBound.bookName(),
+                      QString::number(position.chapter))
+                : QString();
+        auto text(processText(
+                      ColorManager::replaceColors(
+                          std::move(texts[i]),
+                          {{u"CHAPTERTITLE", chapterTitle},
+                           {u"TEXT_ALIGN", u"left"}})));
+        if (verseRow == row)
+            r = text;
+        m_chapterCache.insert(chapter, verse, std::move(text));
+    }
+    return r;
+}
+
+void BtModuleTextModel::uncacheRow(int const index) {
+    for (auto const & key : m_renderCache.keys())
+        if (key.first == index)
+            m_renderCache.remove(key);
+}
 void BtModuleTextModel::setHighlightWords(
         const QString& highlightWords, bool /* caseSensitive */) {
     beginResetModel();
+    cancelPrefetch();
+    m_renderCache.clear();
     m_highlightWords = highlightWords;
+    m_highlighter = CSwordModuleSearch::Highlighter(m_highlightWords, true);
+    m_queryHighlighter = CSwordModuleSearch::Highlighter(m_highlightWords);
+    updateRenderer(true);
     endResetModel();
 }
 
@@ -610,8 +1233,13 @@ void BtModuleTextModel::setOptions(DisplayOptions const & displayOptions,
             filterOptions))
         return;
     beginResetModel();
+    cancelPrefetch();
+    m_renderCache.clear();
     m_displayRendering.setDisplayOptions(displayOptions);
     m_displayRendering.setFilterOptions(filterOptions);
+    resetChunks();
+    updateChapterCache();
+    updateRenderer(true);
     endResetModel();
 }
 
@@ -624,6 +1252,8 @@ bool BtModuleTextModel::setData(
     auto const & module = *m_moduleInfoList.at(getColumnFromRole(role));
     CSwordVerseKey mKey(indexToVerseKey(index.row(), module));
     const_cast<CSwordModuleInfo &>(module).write(&mKey, value.toString());
+    uncacheRow(index.row());
+    updateRenderer(false);
     Q_EMIT dataChanged(index, index);
     return true;
 }
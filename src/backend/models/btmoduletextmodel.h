@@ -12,17 +12,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <optional>
 #include <QAbstractListModel>
+#include <QCache>
 #include <QColor>
 #include <QStringList>
+#include <utility>
+#include <vector>
 #include "../btglobal.h"
+#include "../cswordmodulesearch.h"
 #include "../drivers/btmodulelist.h"
 #include "../keys/cswordversekey.h"
 #include "../keys/cswordtreekey.h"
 #include "../rendering/cdisplayrendering.h"
+#include "btchapterrendercache.h"
 
 
+class BtModuleTextRenderer;
+class BtVersificationTable;
+class CSwordBackend;
 class CSwordModuleInfo;
 
 /** For the BtFindWidget buttons (previous, next) */
@@ -99,6 +112,21 @@ struct ModuleEntry {
     instantiated.
 
     \note Four parallel modules are supported.
+
+    In asynchronous mode (see setAsyncRendering()), data() returns a
+    placeholder for rows not yet rendered and queues them for rendering by a
+    BtModuleTextRenderer. The rows are prioritized by their distance from the
+    row given to setViewportRow(), and dataChanged() is emitted for each row
+    once it has been rendered. With parallel column rendering (see
+    setParallelColumnRendering()), the columns of parallel verse keyed modules
+    are rendered in separate threads concurrently.
+
+    With chunked entries (see setChunkLargeEntries()), lexicon and book entries
+    whose rendered text is large are split after paragraphs into several rows,
+    so that the views only lay out the chunks visible. Rows are inserted after
+    the first row of such an entry when it is first rendered, so the rows of
+    the model correspond to entries only as mapped by rowToEntry() and
+    entryToRow(). Such entries are always rendered in the calling thread.
  */
 
 
@@ -106,10 +134,24 @@ class BtModuleTextModel: public QAbstractListModel {
 
     Q_OBJECT
 
+public: // fields:
+
+    /**
+      The default numbers of rows pre-rendered in and against the direction of
+      navigation, see setPrefetchWindow().
+    */
+    constexpr static int const defaultPrefetchRowsAhead = 40;
+    constexpr static int const defaultPrefetchRowsBehind = 10;
+
 public:
 
     BtModuleTextModel(QObject *parent = nullptr);
 
+    /** Creates a model which looks up its modules in the given backend. */
+    BtModuleTextModel(CSwordBackend & backend, QObject * parent = nullptr);
+
+    ~BtModuleTextModel() override;
+
     /** Convert index(row) into CSwordVerseKey. */
     CSwordVerseKey indexToVerseKey(int index) const;
 
@@ -142,9 +184,39 @@ public:
     QVariant data(const QModelIndex & index,
                   int role = Qt::DisplayRole) const override;
 
+    /**
+      Returns the final text of the given row and role, rendering it in the
+      calling thread if needed, even in asynchronous mode.
+    */
+    QString renderRow(int row, int role) const;
+
+    /** \returns the final text of the given row and role, if rendered. */
+    std::optional<QString> renderedRow(int row, int role) const;
+
     /** Reimplemented from QAbstractItemModel. */
     int rowCount(const QModelIndex & parent = QModelIndex()) const override;
 
+    /**
+      \returns the number of calls of data() of all models so far, e.g. for
+               measuring the calls per frame of the views.
+    */
+    static std::uint64_t dataCalls() noexcept
+    { return s_dataCalls.load(std::memory_order_relaxed); }
+
+    /**
+      \returns the number of lookups of rendered rows of all models so far
+               which found the row in the render cache.
+    */
+    static std::uint64_t renderCacheHits() noexcept
+    { return s_renderCacheHits.load(std::memory_order_relaxed); }
+
+    /**
+      \returns the number of lookups of rendered rows of all models so far
+               which had to render the row.
+    */
+    static std::uint64_t renderCacheMisses() noexcept
+    { return s_renderCacheMisses.load(std::memory_order_relaxed); }
+
     /** Reimplemented from QAbstractItemModel. */
     virtual bool setData(const QModelIndex &index,
                          const QVariant &value, int role = Qt::EditRole) override;
@@ -168,6 +240,118 @@ public:
     /** Load module pointers from module names */
     void reloadModules();
 
+    /**
+      \returns whether the model has a single row showing the entry of the key
+               given to setDirectEntryKey(), because the module is a daily
+               devotional whose entries are not cached yet (see
+               CSwordLexiconModuleInfo::seeksDirectly()). The entries are cached
+               in the background, after which reloadModules() lists them all.
+    */
+    bool seeksDirectly() const noexcept { return m_directEntryKey.has_value(); }
+
+    /** \brief Sets the key of the single row if seeksDirectly(). */
+    void setDirectEntryKey(QString key);
+
+    /** Enables or disables rendering the text rows in a background thread. */
+    void setAsyncRendering(bool enabled);
+
+    bool asyncRendering() const noexcept { return m_asyncRendering; }
+
+    /**
+      Enables or disables rendering the columns of a row concurrently in
+      background threads.
+    */
+    void setParallelColumnRendering(bool enabled);
+
+    bool parallelColumnRendering() const noexcept
+    { return m_parallelColumnRendering; }
+
+    /**
+      Enables or disables splitting large lexicon and book entries into several
+      rows.
+    */
+    void setChunkLargeEntries(bool enabled);
+
+    bool chunkLargeEntries() const noexcept { return m_chunkLargeEntries; }
+
+    /**
+      \returns the index of the entry shown in the given row, and the number of
+               the chunk of the entry shown, which is 0 unless the entry is
+               split into several rows.
+    */
+    std::pair<int, int> rowToEntry(int row) const;
+
+    /** \returns the first row showing the entry of the given index. */
+    int entryToRow(int entry) const;
+
+    /**
+      \brief Splits the given entry into several rows right away, if needed.
+      \returns the number of rows of the entry.
+      \note Must not be called while the views request data.
+    */
+    int splitEntry(int entry);
+
+    /** Set the row around which asynchronous rendering is prioritized. */
+    void setViewportRow(int row);
+
+    /**
+      Set the number of rows pre-rendered by prefetchRows() in the direction of
+      navigation and in the opposite direction.
+    */
+    void setPrefetchWindow(int rowsAhead, int rowsBehind);
+
+    /** \returns the larger side of the window set by setPrefetchWindow(). */
+    int prefetchRows() const noexcept
+    { return std::max(m_prefetchRowsAhead, m_prefetchRowsBehind); }
+
+    /**
+      Pre-renders the rows around the given index(row) during idle time. The
+      window is doubled for modules which render slowly.
+      \param[in] direction The direction of navigation, negative if the user
+                           navigated backwards.
+    */
+    void prefetchRows(int index, int direction);
+
+    /**
+      \returns the number of bytes of the texts in the render cache of this
+               model, without the chapters shared with other models.
+    */
+    std::size_t renderCacheMemoryUsage() const noexcept;
+
+protected: // methods:
+
+    void timerEvent(QTimerEvent * event) override;
+
+private: // types:
+
+    /** A rendered row in m_renderCache, whose size is accounted. */
+    class CachedText {
+
+    public: // methods:
+
+        CachedText(QString t, std::size_t & totalBytes) noexcept
+            : text(std::move(t))
+            , m_totalBytes(totalBytes)
+        { m_totalBytes += bytes(); }
+
+        CachedText(CachedText const &) = delete;
+        CachedText & operator=(CachedText const &) = delete;
+
+        ~CachedText() { m_totalBytes -= bytes(); }
+
+        std::size_t bytes() const noexcept
+        { return static_cast<std::size_t>(text.capacity()) * sizeof(QChar); }
+
+    public: // fields:
+
+        QString const text;
+
+    private: // fields:
+
+        std::size_t & m_totalBytes;
+
+    };
+
 private:
 
     CSwordTreeKey indexToBookKey(int index) const;
@@ -178,17 +362,118 @@ private:
     bool isLexicon() const;
     bool isSelected(int index) const;
 
+    /** Returns the role whose text is shown for the given role. */
+    int canonicalRole(int role) const;
+
+    /** \returns whether any of the modules renders slowly. */
+    bool hasSlowModules() const;
+
+    /** Stops pre-rendering the rows queued by prefetchRows(). */
+    void cancelPrefetch();
+
+    /** Drops all cached rows of the given index(row). */
+    void uncacheRow(int index);
+
+    /** Passes the settings the texts depend on to the chapter cache. */
+    void updateChapterCache();
+
+    /**
+      \returns the chapter and verse identifying the text of the given row and
+               role in the chapter cache, if the text can be cached there.
+    */
+    std::optional<std::pair<QString, int>> chapterCacheKey(int row,
+                                                           int role) const;
+
+    /**
+      \brief Renders all verses of the chapter of the given row in a single
+             pass and puts them into the chapter cache.
+      \param[in] chapter The chapter as identified by chapterCacheKey().
+      \returns the processed text of the given row.
+    */
+    QString renderChapter(int row, int role, QString const & chapter) const;
+
+    /** Creates, configures or destroys the background renderer as needed. */
+    void updateRendererThreads();
+
+    /** Passes the current settings to the background renderer, if any. */
+    void updateRenderer(bool dropRequests);
+
+    void rowRendered(std::uint64_t generation,
+                     int row,
+                     int role,
+                     QString text);
+
+    /** \returns whether entries of the modules are split into several rows. */
+    bool chunkingEntries() const;
+
+    /** Forgets all entries split into several rows. */
+    void resetChunks();
+
+    /** Inserts the rows for the further chunks of the given entry. */
+    void insertChunkRows(int entry, int numChunks, std::uint64_t generation);
+
+    /** \returns the processed text of the given row of a lexicon or book. */
+    QString entryText(int row, int role) const;
+
     /** returns text string for each model index */
-    QString bookData(const QModelIndex & index, int role = Qt::DisplayRole) const;
+    QString bookData(int entry, int role = Qt::DisplayRole) const;
     QString verseData(const QModelIndex & index, int role = Qt::DisplayRole) const;
-    QString lexiconData(const QModelIndex & index, int role = Qt::DisplayRole) const;
+    QString lexiconData(int entry, int role = Qt::DisplayRole) const;
 
+    CSwordBackend & m_backend;
     BtConstModuleList m_moduleInfoList;
     QStringList m_modules;
     QString m_highlightWords;
+    CSwordModuleSearch::Highlighter m_highlighter;
+    CSwordModuleSearch::Highlighter m_queryHighlighter;
 
     int m_firstEntry;
+    static std::atomic<std::uint64_t> s_dataCalls;
+    static std::atomic<std::uint64_t> s_renderCacheHits;
+    static std::atomic<std::uint64_t> s_renderCacheMisses;
+
     int m_maxEntries;
+    /** The key of the single row if seeksDirectly(). */
+    std::optional<QString> m_directEntryKey;
+    /** The verse index table of the first Bible or commentary module. */
+    std::shared_ptr<BtVersificationTable const> m_versificationTable;
     Rendering::CDisplayRendering m_displayRendering;
     std::optional<FindState> m_findState;
+
+    /** The number of bytes of the texts in m_renderCache. */
+    mutable std::size_t m_renderCacheBytes = 0u;
+
+    /** The final HTML of recently requested rows, keyed by (row, role). */
+    mutable QCache<std::pair<int, int>, CachedText> m_renderCache;
+
+    /** The rendered verses of Bibles and commentaries kept across sessions. */
+    mutable BtChapterRenderCache m_chapterCache;
+    bool m_renderWholeChapters = false;
+
+    std::unique_ptr<BtModuleTextRenderer> m_renderer;
+    bool m_asyncRendering = false;
+    /** Whether rendering is asynchronous only since modules render slowly. */
+    bool m_asyncRenderingForSlowModules = false;
+    bool m_renderingUnavailable = false;
+    bool m_parallelColumnRendering = false;
+    std::uint64_t m_renderGeneration = 0u;
+
+    bool m_chunkLargeEntries = false;
+    /** The numbers of chunks of the entries split into several rows. */
+    std::map<int, int> m_entryChunkCounts;
+    int m_extraRows = 0; ///< The rows of all chunks but the first ones
+    std::uint64_t m_chunkGeneration = 0u;
+
+    /** The chunks of the entry split most recently. */
+    struct ChunkedEntry {
+        int entry;
+        int role;
+        QStringList chunks;
+    };
+    mutable std::optional<ChunkedEntry> m_lastChunkedEntry;
+
+    int m_prefetchRowsAhead = 0;
+    int m_prefetchRowsBehind = 0;
+    std::vector<int> m_prefetchQueue; // The row to prefetch next is at the back
+    int m_prefetchTimerId = 0;
 };
@@ -0,0 +1,215 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btmoduletextrenderer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <QThread>
+#include "../../util/btassert.h"
+#include "../rendering/btrendercontext.h"
+
+
+//Maximum number of queued rows, the ones farthest from the viewport are dropped
+constexpr static std::size_t const BT_MAX_QUEUED_ROWS = 256u;
+
+BtModuleTextRenderer::BtModuleTextRenderer(QObject * const parent)
+    : QObject(parent)
+{}
+
+BtModuleTextRenderer::~BtModuleTextRenderer() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+        m_requests.clear();
+    }
+    m_condition.notify_all();
+    for (auto const & thread : m_threads)
+        thread->wait();
+}
+
+void BtModuleTextRenderer::setMaxThreads(int const maxThreads) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_maxThreads = static_cast<std::size_t>(std::max(maxThreads, 1));
+    }
+    m_condition.notify_all();
+}
+
+void BtModuleTextRenderer::setSettings(Settings settings,
+                                       bool const dropRequests)
+{
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_settings = std::move(settings);
+    if (dropRequests)
+        m_requests.erase(std::remove_if(m_requests.begin(),
+                                        m_requests.end(),
+                                        [](Request const & request)
+                                        { return !request.promise; }),
+                         m_requests.end());
+}
+
+void BtModuleTextRenderer::requestRow(int const row, int const role) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        BT_ASSERT(m_settings);
+        if (m_stopping || m_unavailable)
+            return;
+        if (std::any_of(m_requests.begin(),
+                        m_requests.end(),
+                        [row, role](Request const & request) {
+                            return !request.promise
+                                   && request.row == row
+                                   && request.role == role;
+                        }))
+            return;
+        m_requests.emplace_back(Request{row, role, nullptr});
+        if (m_requests.size() > BT_MAX_QUEUED_ROWS) {
+            auto const it =
+                    std::max_element(
+                        m_requests.begin(),
+                        m_requests.end(),
+                        [this](Request const & a, Request const & b)
+                        { return distance(a) < distance(b); });
+            if (!it->promise)
+                m_requests.erase(it);
+        }
+        startThreads();
+    }
+    m_condition.notify_one();
+}
+
+std::vector<std::optional<QString>> BtModuleTextRenderer::renderNow(
+        int const row,
+        std::vector<int> const & roles)
+{
+    std::vector<std::promise<std::optional<QString>>> promises(roles.size());
+    std::vector<std::future<std::optional<QString>>> futures;
+    futures.reserve(roles.size());
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        BT_ASSERT(m_settings);
+        if (m_stopping || m_unavailable)
+            return std::vector<std::optional<QString>>(roles.size());
+        for (std::size_t i = 0u; i < roles.size(); ++i) {
+            futures.emplace_back(promises[i].get_future());
+            m_requests.emplace_back(Request{row, roles[i], &promises[i]});
+        }
+        startThreads();
+    }
+    m_condition.notify_all();
+
+    std::vector<std::optional<QString>> r;
+    r.reserve(futures.size());
+    for (auto & future : futures)
+        r.emplace_back(future.get());
+    return r;
+}
+
+void BtModuleTextRenderer::setViewportRow(int const row) {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_viewportRow = row;
+}
+
+int BtModuleTextRenderer::distance(Request const & request) const noexcept {
+    // Rows waited for are always rendered first:
+    return request.promise ? -1 : std::abs(request.row - m_viewportRow);
+}
+
+void BtModuleTextRenderer::startThreads() {
+    auto availableThreads = m_idleThreads;
+    while (availableThreads < m_requests.size()
+           && m_threads.size() < m_maxThreads)
+    {
+        auto const threadIndex = m_threads.size();
+        m_threads.emplace_back(
+                    QThread::create([this, threadIndex]{ work(threadIndex); }));
+        m_threads.back()->start(QThread::LowPriority);
+        ++availableThreads;
+    }
+}
+
+void BtModuleTextRenderer::work(std::size_t const threadIndex) {
+    Rendering::BtRenderContext context;
+    std::unique_ptr<BtModuleTextModel> model;
+    std::uint64_t generation = 0u;
+    for (;;) {
+        Request request;
+        std::optional<Settings> newSettings;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_idleThreads;
+            m_condition.wait(
+                        lock,
+                        [this, threadIndex] {
+                            return m_stopping
+                                   || m_unavailable
+                                   || (threadIndex < m_maxThreads
+                                       && !m_requests.empty());
+                        });
+            --m_idleThreads;
+            if (m_stopping || m_unavailable)
+                return;
+
+            // Take the most urgent request:
+            auto const it =
+                    std::min_element(
+                        m_requests.begin(),
+                        m_requests.end(),
+                        [this](Request const & a, Request const & b)
+                        { return distance(a) < distance(b); });
+            request = *it;
+            m_requests.erase(it);
+            BT_ASSERT(m_settings);
+            if (!model || m_settings->generation != generation)
+                newSettings = m_settings;
+        }
+
+        if (newSettings) {
+            model.reset();
+            if (context.findModules(newSettings->modules).isEmpty()) {
+                {
+                    std::lock_guard<std::mutex> const guard(m_mutex);
+                    m_unavailable = true;
+                    for (auto const & pending : m_requests)
+                        if (pending.promise)
+                            pending.promise->set_value(std::nullopt);
+                    m_requests.clear();
+                }
+                m_condition.notify_all();
+                if (request.promise)
+                    request.promise->set_value(std::nullopt);
+                Q_EMIT renderingUnavailable();
+                return;
+            }
+            model = std::make_unique<BtModuleTextModel>(context.backend());
+            model->setOptions(newSettings->displayOptions,
+                              newSettings->filterOptions);
+            model->setModules(newSettings->modules);
+            if (newSettings->directEntryKey)
+                model->setDirectEntryKey(
+                            std::move(*newSettings->directEntryKey));
+            model->setHighlightWords(newSettings->highlightWords, false);
+            model->setFindState(std::move(newSettings->findState));
+            generation = newSettings->generation;
+        }
+        auto text(model->renderRow(request.row, request.role));
+        if (request.promise) {
+            request.promise->set_value(std::move(text));
+        } else {
+            Q_EMIT rowRendered(generation,
+                               request.row,
+                               request.role,
+                               std::move(text));
+        }
+    }
+}
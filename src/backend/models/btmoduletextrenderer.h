@@ -0,0 +1,135 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QObject>
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <QString>
+#include <QStringList>
+#include <utility>
+#include <vector>
+#include "../btglobal.h"
+#include "btmoduletextmodel.h"
+
+
+class QThread;
+
+/**
+  \brief Renders the rows of a BtModuleTextModel in background threads.
+
+  Every thread uses its own CSwordBackend (see
+  CSwordBackend::createWorkerInstance()) and a BtModuleTextModel which mirrors
+  the settings of the model displayed. The threads are started lazily, up to
+  the maximum set by setMaxThreads(). Queued rows are rendered in the order of
+  their distance from the row at the top of the viewport, after any rows
+  requested by renderNow().
+*/
+class BtModuleTextRenderer: public QObject {
+
+    Q_OBJECT
+
+public: // types:
+
+    struct Settings {
+        QStringList modules;
+        DisplayOptions displayOptions;
+        FilterOptions filterOptions;
+        QString highlightWords;
+        std::optional<FindState> findState;
+        std::optional<QString> directEntryKey;
+        std::uint64_t generation;
+    };
+
+public: // methods:
+
+    BtModuleTextRenderer(QObject * parent = nullptr);
+    ~BtModuleTextRenderer() override;
+
+    /** \brief Sets the maximum number of rendering threads. */
+    void setMaxThreads(int maxThreads);
+
+    /**
+      \brief Sets the settings used to render subsequent requests.
+      \param[in] settings The new settings.
+      \param[in] dropRequests Whether to drop all pending requests.
+    */
+    void setSettings(Settings settings, bool dropRequests);
+
+    /** \brief Queues the given row for rendering unless already queued. */
+    void requestRow(int row, int role);
+
+    /**
+      \brief Renders the given roles of a row concurrently and waits for them.
+      \returns the texts in the order of the given roles, or std::nullopt for
+               the texts which could not be rendered in the background.
+    */
+    std::vector<std::optional<QString>> renderNow(
+            int row,
+            std::vector<int> const & roles);
+
+    /** \brief Sets the row the queued requests are prioritized around. */
+    void setViewportRow(int row);
+
+Q_SIGNALS:
+
+    /**
+      \brief Emitted when a queued row has been rendered.
+      \param[in] generation The generation of the settings the row has been
+                            rendered with.
+    */
+    void rowRendered(quint64 generation, int row, int role, QString text);
+
+    /**
+      \brief Emitted if the modules to render are not available to the
+             rendering threads.
+    */
+    void renderingUnavailable();
+
+private: // types:
+
+    struct Request {
+        int row;
+        int role;
+        std::promise<std::optional<QString>> * promise;
+    };
+
+private: // methods:
+
+    /** \returns the priority of the given request, lower is more urgent. */
+    int distance(Request const & request) const noexcept;
+
+    /** \brief Starts threads for the pending requests. Needs m_mutex. */
+    void startThreads();
+
+    void work(std::size_t threadIndex);
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<Request> m_requests;
+    std::optional<Settings> m_settings;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+    std::size_t m_maxThreads = 1u;
+    std::size_t m_idleThreads = 0u;
+    int m_viewportRow = 0;
+    bool m_stopping = false;
+    bool m_unavailable = false;
+
+}; /* class BtModuleTextRenderer */
@@ -0,0 +1,185 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btflatkeytree.h"
+
+#include <algorithm>
+
+
+namespace Rendering {
+namespace {
+
+/**
+  \returns the index of the given value in the given values, which is appended
+           unless found. The most recently used values are at the end.
+*/
+template <typename T>
+std::uint32_t intern(std::vector<T> & values, T const & value) {
+    auto const it = std::find(values.rbegin(), values.rend(), value);
+    if (it != values.rend())
+        return static_cast<std::uint32_t>(values.rend() - it - 1);
+    values.push_back(value);
+    return static_cast<std::uint32_t>(values.size() - 1u);
+}
+
+} // anonymous namespace
+
+BtFlatKeyTree::BtFlatKeyTree(CTextRendering::KeyTree const & tree) {
+    m_entries.reserve(tree.size());
+    for (auto const & item : tree) {
+        m_entries.emplace_back(makeEntry(item));
+        if (!item.childList().empty()) {
+            auto const [begin, end] = appendChildren(item.childList());
+            m_entries.back().childrenBegin = begin;
+            m_entries.back().childrenEnd = end;
+        }
+    }
+}
+
+CTextRendering::KeyTree BtFlatKeyTree::toKeyTree() const {
+    CTextRendering::KeyTree tree;
+    appendItems(tree, m_entries);
+    return tree;
+}
+
+BtConstModuleList BtFlatKeyTree::collectModules() const {
+    BtConstModuleList modules;
+    for (auto const & moduleList : m_moduleLists)
+        for (auto const * const module : moduleList)
+            if (!modules.contains(module))
+                modules.append(module);
+    return modules;
+}
+
+void BtFlatKeyTree::append(QString key,
+                           BtConstModuleList const & modules,
+                           Settings const & settings,
+                           long const verseIndex,
+                           QString const & versification)
+{
+    m_entries.emplace_back(makeEntry(std::move(key),
+                                     modules,
+                                     settings,
+                                     verseIndex,
+                                     versification,
+                                     false));
+}
+
+void BtFlatKeyTree::appendContent(QString content, Settings const & settings)
+{
+    m_entries.emplace_back(makeEntry(std::move(content),
+                                     {},
+                                     settings,
+                                     -1,
+                                     {},
+                                     true));
+}
+
+void BtFlatKeyTree::emplaceItem(
+        std::optional<CTextRendering::KeyTreeItem> & item,
+        Entry const & entry) const
+{
+    if (entry.alternativeContent) {
+        item.emplace(entry.text, entry.settings);
+    } else {
+        item.emplace(entry.text,
+                     entry.verseIndex,
+                     m_versifications[entry.versification],
+                     modules(entry),
+                     entry.settings);
+    }
+    appendItems(item->childList(), children(entry));
+}
+
+CTextRendering::KeyTree BtFlatKeyTree::modulesTree() const {
+    CTextRendering::KeyTree tree;
+    for (auto const & moduleList : m_moduleLists)
+        tree.emplace_back(QString(),
+                          moduleList,
+                          Settings{false, Settings::NoKey});
+    return tree;
+}
+
+BtFlatKeyTree::Entry BtFlatKeyTree::makeEntry(
+        QString text,
+        BtConstModuleList const & modules,
+        Settings const & settings,
+        long const verseIndex,
+        QString const & versification,
+        bool const alternativeContent)
+{
+    return Entry{std::move(text),
+                 verseIndex,
+                 intern(m_moduleLists, modules),
+                 intern(m_versifications, versification),
+                 0u,
+                 0u,
+                 settings,
+                 alternativeContent};
+}
+
+BtFlatKeyTree::Entry
+BtFlatKeyTree::makeEntry(CTextRendering::KeyTreeItem const & item) {
+    if (item.hasAlternativeContent())
+        return makeEntry(item.getAlternativeContent(),
+                         {},
+                         item.settings(),
+                         -1,
+                         {},
+                         true);
+    return makeEntry(item.key(),
+                     item.modules(),
+                     item.settings(),
+                     item.verseIndex(),
+                     item.versification(),
+                     false);
+}
+
+std::pair<std::uint32_t, std::uint32_t>
+BtFlatKeyTree::appendChildren(CTextRendering::KeyTree const & items) {
+    // The children of an entry are contiguous, so append them first:
+    auto const begin = m_children.size();
+    for (auto const & item : items)
+        m_children.emplace_back(makeEntry(item));
+    auto const end = m_children.size();
+    auto i = begin;
+    for (auto const & item : items) {
+        if (!item.childList().empty()) {
+            auto const [childrenBegin, childrenEnd] =
+                    appendChildren(item.childList());
+            m_children[i].childrenBegin = childrenBegin;
+            m_children[i].childrenEnd = childrenEnd;
+        }
+        ++i;
+    }
+    return {static_cast<std::uint32_t>(begin),
+            static_cast<std::uint32_t>(end)};
+}
+
+void BtFlatKeyTree::appendItems(CTextRendering::KeyTree & tree,
+                                std::span<Entry const> entries) const
+{
+    for (auto const & entry : entries) {
+        if (entry.alternativeContent) {
+            tree.emplace_back(entry.text, entry.settings);
+        } else {
+            tree.emplace_back(entry.text,
+                              entry.verseIndex,
+                              m_versifications[entry.versification],
+                              modules(entry),
+                              entry.settings);
+        }
+        appendItems(tree.back().childList(), children(entry));
+    }
+}
+
+} /* namespace Rendering */
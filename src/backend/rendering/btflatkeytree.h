@@ -0,0 +1,143 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <QString>
+#include <span>
+#include <utility>
+#include <vector>
+#include "../drivers/btmodulelist.h"
+#include "ctextrendering.h"
+
+
+namespace Rendering {
+
+/**
+  \brief A CTextRendering::KeyTree stored contiguously.
+
+  The entries are stored by value in vectors instead of a node per entry, the
+  children of every entry are a range of a separate vector, and the lists of
+  modules and the versifications are stored once per tree. Trees of thousands
+  of verses thus need only a few allocations.
+
+  Since CTextRendering::renderEntry() works on KeyTreeItem objects, entries
+  are turned into an item just for the time they are rendered, see
+  emplaceItem().
+*/
+class BtFlatKeyTree {
+
+public: // types:
+
+    using Settings = CTextRendering::KeyTreeItem::Settings;
+
+    struct Entry {
+        QString text; ///< The key, or the alternative content
+        long verseIndex; ///< As of KeyTreeItem::verseIndex()
+        std::uint32_t moduleList; ///< Index into m_moduleLists
+        std::uint32_t versification; ///< Index into m_versifications
+        std::uint32_t childrenBegin; ///< Index into m_children
+        std::uint32_t childrenEnd;
+        Settings settings;
+        bool alternativeContent;
+    };
+
+public: // methods:
+
+    BtFlatKeyTree() = default;
+
+    /** \brief Creates the flat copy of the given tree. */
+    explicit BtFlatKeyTree(CTextRendering::KeyTree const & tree);
+
+    /** \returns a copy of this tree as a CTextRendering::KeyTree. */
+    CTextRendering::KeyTree toKeyTree() const;
+
+    void reserve(std::size_t const size) { m_entries.reserve(size); }
+
+    /** \returns the number of top level entries. */
+    std::size_t size() const noexcept { return m_entries.size(); }
+    bool empty() const noexcept { return m_entries.empty(); }
+
+    std::vector<Entry>::const_iterator begin() const noexcept
+    { return m_entries.begin(); }
+
+    std::vector<Entry>::const_iterator end() const noexcept
+    { return m_entries.end(); }
+
+    std::span<Entry const> children(Entry const & entry) const noexcept {
+        return std::span<Entry const>(m_children).subspan(
+                    entry.childrenBegin,
+                    entry.childrenEnd - entry.childrenBegin);
+    }
+
+    BtConstModuleList const & modules(Entry const & entry) const noexcept
+    { return m_moduleLists[entry.moduleList]; }
+
+    /** \returns all modules used by the entries, in order of first use. */
+    BtConstModuleList collectModules() const;
+
+    /** \brief Appends a top level entry of the given key. */
+    void append(QString key,
+                BtConstModuleList const & modules,
+                Settings const & settings,
+                long verseIndex = -1,
+                QString const & versification = QString());
+
+    /** \brief Appends a top level entry of alternative content. */
+    void appendContent(QString content, Settings const & settings);
+
+    /**
+      \brief Constructs the KeyTreeItem of the given entry and its children
+             into the given optional.
+    */
+    void emplaceItem(std::optional<CTextRendering::KeyTreeItem> & item,
+                     Entry const & entry) const;
+
+    /**
+      \returns a tree with an item for every list of modules used, for passing
+               to CTextRendering::finishText() which only looks at the modules.
+    */
+    CTextRendering::KeyTree modulesTree() const;
+
+private: // methods:
+
+    Entry makeEntry(QString text,
+                    BtConstModuleList const & modules,
+                    Settings const & settings,
+                    long verseIndex,
+                    QString const & versification,
+                    bool alternativeContent);
+    Entry makeEntry(CTextRendering::KeyTreeItem const & item);
+
+    /**
+      \brief Appends the given items and their descendants as children.
+      \returns the index of the first and past the last child appended.
+    */
+    std::pair<std::uint32_t, std::uint32_t> appendChildren(
+            CTextRendering::KeyTree const & items);
+
+    void appendItems(CTextRendering::KeyTree & tree,
+                     std::span<Entry const> entries) const;
+
+private: // fields:
+
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_children;
+    std::vector<BtConstModuleList> m_moduleLists;
+    std::vector<QString> m_versifications;
+
+}; /* class BtFlatKeyTree */
+
+} /* namespace Rendering */
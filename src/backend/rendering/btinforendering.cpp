@@ -12,10 +12,15 @@
 
 #include "btinforendering.h"
 
+#include <list>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <QByteArray>
 #include <QChar>
+#include <QHash>
 #include <QObject>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
@@ -25,11 +30,13 @@
 #include <utility>
 #include "../../util/btassert.h"
 #include "../btglobal.h"
+#include "../btheadwordindex.h"
 #include "../config/btconfig.h"
 #include "../drivers/btmodulelist.h"
 #include "../drivers/cswordlexiconmoduleinfo.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../keys/cswordkey.h"
+#include "../keys/cswordversekey.h"
 #include "../managers/cdisplaytemplatemgr.h"
 #include "../managers/cswordbackend.h"
 #include "crossrefrendering.h"
@@ -55,8 +62,120 @@
 #pragma GCC diagnostic pop
 
 
+//Maximum number of characters of the rendered infos cached
+constexpr static qsizetype const BT_MAX_CACHED_INFOS_SIZE = 4 * 1024 * 1024;
+
 namespace {
 
+CSwordModuleInfo * getFirstAvailableStrongsModule(CSwordBackend & backend,
+                                                  bool wantHebrew);
+
+/**
+  \brief Caches the Strong's lexicons found and the rendered infos for the
+         session, until the installed modules change.
+
+  The cache is shared by all threads rendering infos. Since modules are looked
+  up by name, the backends of render contexts share the infos rendered.
+
+  The least recently used infos are dropped when the cached infos exceed
+  BT_MAX_CACHED_INFOS_SIZE characters.
+*/
+class InfoCache {
+
+public: // methods:
+
+    static InfoCache & instance() {
+        static InfoCache cache;
+        return cache;
+    }
+
+    /** \returns the result of getFirstAvailableStrongsModule(). */
+    CSwordModuleInfo * firstAvailableStrongsModule(CSwordBackend & backend,
+                                                   bool const wantHebrew)
+    {
+        std::lock_guard const guard(m_mutex);
+        auto & name = m_strongsModules[wantHebrew ? 1 : 0];
+        if (!name.has_value()) {
+            auto const * const m =
+                    getFirstAvailableStrongsModule(backend, wantHebrew);
+            name.emplace(m ? m->name() : QString());
+        }
+        return name->isEmpty() ? nullptr : backend.findModuleByName(*name);
+    }
+
+    /**
+      \returns the info of the given kind and value rendered with the given
+               module and filter options, rendering it unless cached.
+      \param[in] filterOptions The key of the filter options the info is
+                               rendered with (see
+                               CSwordBackend::filterOptionsKey()), or empty if
+                               they are set by the rendering itself.
+    */
+    template <typename Render>
+    QString info(char const kind,
+                 QString const & value,
+                 CSwordModuleInfo const * const module,
+                 QString const & filterOptions,
+                 Render && render)
+    {
+        auto key(QStringLiteral("%1|%2|%3|%4").arg(
+                     QChar::fromLatin1(kind),
+                     module ? module->name() : QString(),
+                     filterOptions,
+                     value));
+        {
+            std::lock_guard const guard(m_mutex);
+            if (auto const it = m_index.constFind(key); it != m_index.cend()) {
+                m_entries.splice(m_entries.begin(), m_entries, *it);
+                return (*it)->second;
+            }
+        }
+
+        // Render without holding the lock, so other threads are not blocked:
+        auto r(render());
+        std::lock_guard const guard(m_mutex);
+        if (m_index.contains(key)) // Rendered by another thread meanwhile
+            return r;
+        m_size += r.size();
+        m_entries.emplace_front(key, r);
+        m_index.insert(std::move(key), m_entries.begin());
+        while (m_size > BT_MAX_CACHED_INFOS_SIZE && m_entries.size() > 1u) {
+            m_size -= m_entries.back().second.size();
+            m_index.remove(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        return r;
+    }
+
+private: // types:
+
+    using Entry = std::pair<QString, QString>;
+
+private: // methods:
+
+    InfoCache() {
+        QObject::connect(&CSwordBackend::instance(),
+                         &CSwordBackend::sigSwordSetupChanged,
+                         [this]{
+                             std::lock_guard const guard(m_mutex);
+                             m_strongsModules[0].reset();
+                             m_strongsModules[1].reset();
+                             m_index.clear();
+                             m_entries.clear();
+                             m_size = 0;
+                         });
+    }
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::optional<QString> m_strongsModules[2]; ///< Names, empty if none
+    std::list<Entry> m_entries;
+    QHash<QString, std::list<Entry>::iterator> m_index;
+    qsizetype m_size = 0;
+
+};
+
 QString decodeAbbreviation(QString const & data) {
     /// \todo Is "text" correct?
     /* before:
@@ -70,15 +189,14 @@ QString decodeAbbreviation(QString const & data) {
             .arg(QObject::tr("Abbreviation"), data);
 }
 
-QString decodeCrossReference(QString const & data,
-                             BtConstModuleList const & modules)
+/**
+  \param[in] pos The position of the colon after the module prefix of the
+                 reference, or -1 if none.
+*/
+QString renderCrossReference(QString const & data,
+                             CSwordModuleInfo const * const module,
+                             int const pos)
 {
-    if (data.isEmpty())
-        return QStringLiteral("<div class=\"crossrefinfo\"><h3>%1</h3></div>")
-               .arg(QObject::tr("Cross references"));
-
-    // qWarning("setting crossref %s", data.latin1());
-
     DisplayOptions dispOpts;
     dispOpts.lineBreaks  = false;
     dispOpts.verseNumbers = true;
@@ -87,30 +205,6 @@ QString decodeCrossReference(QString const & data,
     Rendering::CrossRefRendering renderer(dispOpts, filterOpts);
     Rendering::CTextRendering::KeyTree tree;
 
-    // const bool isBible = true;
-    const CSwordModuleInfo * module(nullptr);
-
-    // a prefixed module gives the module to look into
-    static QRegularExpression const re(QStringLiteral(R"PCRE(^[^ ]+:)PCRE"));
-    // re.setMinimal(true);
-    int pos = re.match(data).capturedEnd();
-    if (pos >= 0)
-        --pos;
-
-    if (pos > 0) {
-        auto moduleName = data.left(pos);
-        // qWarning("found module %s", moduleName.latin1());
-        module = CSwordBackend::instance().findModuleByName(
-                     std::move(moduleName));
-    }
-
-    if (!module)
-        module = btConfig().getDefaultSwordModuleByType(
-                     QStringLiteral("standardBible"));
-
-    if (!module && modules.size() > 0)
-        module = modules.at(0);
-
     // BT_ASSERT(module); // why? the existense of the module is tested later
     Rendering::CTextRendering::KeyTreeItem::Settings settings{
         false,
@@ -160,7 +254,48 @@ QString decodeCrossReference(QString const & data,
            .arg(renderer.renderKeyTree(tree));
 }
 
-QString decodeFootnote(QString const & data) {
+QString decodeCrossReference(QString const & data,
+                             BtConstModuleList const & modules,
+                             Rendering::InfoContext const & context)
+{
+    if (data.isEmpty())
+        return QStringLiteral("<div class=\"crossrefinfo\"><h3>%1</h3></div>")
+               .arg(QObject::tr("Cross references"));
+
+    // qWarning("setting crossref %s", data.latin1());
+
+    // const bool isBible = true;
+    const CSwordModuleInfo * module(nullptr);
+
+    // a prefixed module gives the module to look into
+    static QRegularExpression const re(QStringLiteral(R"PCRE(^[^ ]+:)PCRE"));
+    // re.setMinimal(true);
+    int pos = re.match(data).capturedEnd();
+    if (pos >= 0)
+        --pos;
+
+    if (pos > 0) {
+        auto moduleName = data.left(pos);
+        // qWarning("found module %s", moduleName.latin1());
+        module = context.backend().findModuleByName(std::move(moduleName));
+    }
+
+    if (!module)
+        module = context.defaultModule(QStringLiteral("standardBible"));
+
+    if (!module && modules.size() > 0)
+        module = modules.at(0);
+
+    return InfoCache::instance().info(
+                'C',
+                data,
+                module,
+                QString(), // Set by CrossRefRendering
+                [&data, module, pos]
+                { return renderCrossReference(data, module, pos); });
+}
+
+QString renderFootnote(QString const & data, CSwordBackend & backend) {
     QStringList list = data.split('/');
     BT_ASSERT(list.count() >= 3);
     if (!list.count())
@@ -168,7 +303,7 @@ QString decodeFootnote(QString const & data) {
 
     FilterOptions filterOpts;
     filterOpts.footnotes   = true;
-    CSwordBackend::instance().setFilterOptions(filterOpts);
+    backend.setFilterOptions(filterOpts);
 
     const QString modulename = list.first();
     const QString swordFootnote = list.last();
@@ -178,30 +313,58 @@ QString decodeFootnote(QString const & data) {
     list.pop_front();
     const QString keyname = list.join('/');
 
-    auto * const module =
-            CSwordBackend::instance().findModuleByName(modulename);
+    auto * const module = backend.findModuleByName(modulename);
     if (!module)
         return QString();
 
     QSharedPointer<CSwordKey> key(module->createKey());
     key->setKey(keyname);
 
-    // force entryAttributes:
-    key->renderedText(CSwordKey::ProcessEntryAttributesOnly);
-
     auto & m = module->swordModule();
-    const char * const note =
-        m.getEntryAttributes()
-            ["Footnote"][swordFootnote.toLatin1().data()]["body"].c_str();
+    QByteArray note;
+    /* The footnotes of verses are usually in the attribute store of the index,
+       which spares running the filters on the whole entry: */
+    auto const * const vk = dynamic_cast<CSwordVerseKey const *>(key.data());
+    auto const store(vk ? module->verseAttributeStore() : nullptr);
+    if (auto const body =
+                store
+                ? store->footnote(static_cast<std::uint32_t>(vk->index()),
+                                  swordFootnote)
+                : std::nullopt)
+    {
+        note = body->toUtf8();
+        // The references in the footnote are relative to the entry:
+        m.getKey()->copyFrom(key->asSwordKey());
+    } else {
+        // force entryAttributes:
+        key->renderedText(CSwordKey::ProcessEntryAttributesOnly);
+        note = m.getEntryAttributes()
+                   ["Footnote"][swordFootnote.toLatin1().data()]["body"]
+                   .c_str();
+    }
     return QStringLiteral("<div class=\"footnoteinfo\" lang=\"%1\"><h3>%2</h3>"
                           "<p>%3</p></div>")
            .arg(module->language()->abbrev(),
                 QObject::tr("Footnote"),
-                QString::fromUtf8(m.renderText(note).c_str()));
+                QString::fromUtf8(m.renderText(note.constData()).c_str()));
 }
 
-CSwordModuleInfo * getFirstAvailableStrongsModule(bool wantHebrew) {
-    for (auto * const m : CSwordBackend::instance().moduleList()) {
+QString decodeFootnote(QString const & data,
+                       Rendering::InfoContext const & context)
+{
+    return InfoCache::instance().info(
+                'F',
+                data,
+                nullptr, // Given by the data
+                QString(), // Set by renderFootnote()
+                [&data, &context]
+                { return renderFootnote(data, context.backend()); });
+}
+
+CSwordModuleInfo * getFirstAvailableStrongsModule(CSwordBackend & backend,
+                                                  bool wantHebrew)
+{
+    for (auto * const m : backend.moduleList()) {
         if (m->type() == CSwordLexiconModuleInfo::Lexicon) {
             auto lexModule = qobject_cast<CSwordLexiconModuleInfo *>(m);
             if (wantHebrew
@@ -217,42 +380,131 @@ CSwordModuleInfo * getFirstAvailableStrongsModule(bool wantHebrew) {
     return nullptr;
 }
 
-CSwordModuleInfo * getStrongsModule(bool const wantHebrew) {
+CSwordModuleInfo * getStrongsModule(Rendering::InfoContext const & context,
+                                    bool const wantHebrew)
+{
     auto * const m =
-            btConfig().getDefaultSwordModuleByType(
+            context.defaultModule(
                 wantHebrew
                 ? QStringLiteral("standardHebrewStrongsLexicon")
                 : QStringLiteral("standardGreekStrongsLexicon"));
-    return m ? m : getFirstAvailableStrongsModule(wantHebrew);
+    return m
+           ? m
+           : InfoCache::instance().firstAvailableStrongsModule(
+                 context.backend(),
+                 wantHebrew);
+}
+
+/**
+  \returns the given Strong's lexicon if it has an entry for the given Strong's
+           number, otherwise another lexicon of the language having one
+           according to the BtHeadwordIndex, or the given lexicon if none has.
+*/
+CSwordModuleInfo * strongsModuleWithEntry(CSwordModuleInfo * const module,
+                                          QString const & strongs,
+                                          bool const wantHebrew,
+                                          CSwordBackend & backend)
+{
+    auto const index = BtHeadwordIndex::instance();
+    if (!module || !index)
+        return module;
+    auto const key(
+            static_cast<CSwordLexiconModuleInfo *>(module)->normalizeStrongsKey(
+                strongs));
+    if (index->contains(module->name(), key))
+        return module;
+    auto const feature = wantHebrew
+                         ? CSwordModuleInfo::FeatureHebrewDef
+                         : CSwordModuleInfo::FeatureGreekDef;
+    for (auto const & match : index->find(key))
+        if (auto * const m = backend.findModuleByName(match.moduleName);
+            m && m->has(feature))
+            return m;
+    return module;
+}
+
+QString renderStrongs(CSwordModuleInfo * const module,
+                      QString const & strongs)
+{
+    QString text;
+    if (module) {
+        QSharedPointer<CSwordKey> key(module->createKey());
+        auto lexModule = qobject_cast<CSwordLexiconModuleInfo *>(module);
+        key->setKey(lexModule->normalizeStrongsKey(strongs));
+        text = key->renderedText();
+    }
+    //if the module could not be found just display an empty lemma info
+
+    return QStringLiteral("<div class=\"strongsinfo\" lang=\"%1\"><h3>%2: %3"
+                          "</h3><p>%4</p></div>")
+           .arg(module ? module->language()->abbrev() : QStringLiteral("en"),
+                QObject::tr("Strongs"),
+                strongs,
+                text);
 }
 
-QString decodeStrongs(QString const & data) {
+QString decodeStrongs(QString const & data,
+                      Rendering::InfoContext const & context)
+{
     QString ret;
     for (auto const & strongs : data.split('|')) {
         bool const wantHebrew = strongs.left(1) == 'H';
-        CSwordModuleInfo * module = getStrongsModule(wantHebrew);
-        QString text;
-        if (module) {
-            QSharedPointer<CSwordKey> key(module->createKey());
-            auto lexModule = qobject_cast<CSwordLexiconModuleInfo *>(module);
-            key->setKey(lexModule->normalizeStrongsKey(strongs));
-            text = key->renderedText();
-        }
-        //if the module could not be found just display an empty lemma info
-
-        ret.append(
-            QStringLiteral("<div class=\"strongsinfo\" lang=\"%1\"><h3>%2: %3"
-                           "</h3><p>%4</p></div>")
-            .arg(module ? module->language()->abbrev() : QStringLiteral("en"),
-                 QObject::tr("Strongs"),
-                 strongs,
-                 text)
-        );
+        CSwordModuleInfo * module =
+                strongsModuleWithEntry(getStrongsModule(context, wantHebrew),
+                                       strongs,
+                                       wantHebrew,
+                                       context.backend());
+        ret.append(InfoCache::instance().info(
+                       'S',
+                       strongs,
+                       module,
+                       context.backend().filterOptionsKey(),
+                       [module, &strongs]
+                       { return renderStrongs(module, strongs); }));
     }
     return ret;
 }
 
-QString decodeMorph(QString const & data) {
+QString renderMorph(CSwordModuleInfo * const module,
+                    QString const & value,
+                    bool const skipFirstChar,
+                    Rendering::InfoContext const & context)
+{
+    QString text;
+    // BT_ASSERT(module);
+    if (module) {
+        QSharedPointer<CSwordKey> key(module->createKey());
+
+        // skip H or G (language sign) if we have to skip it
+        const bool isOk = key->setKey(skipFirstChar ? value.mid(1) : value);
+        // BT_ASSERT(isOk);
+        /* try to use the other morph lexicon, because this one failed with
+           the current morph code. */
+        if (!isOk) {
+            /// \todo: what if the module doesn't exist?
+            key->setModule(
+                        context.defaultModule(
+                            QStringLiteral("standardHebrewMorphLexicon")));
+            key->setKey(skipFirstChar ? value.mid(1) : value);
+        }
+
+        text = key->renderedText();
+    }
+
+    // if the module wasn't found just display an empty morph info
+    return QStringLiteral("<div class=\"morphinfo\" lang=\"%1\">"
+                          "<h3>%2: %3</h3><p>%4</p></div>")
+           .arg(module
+                ? module->language()->abbrev()
+                : QStringLiteral("en"),
+                QObject::tr("Morphology"),
+                value,
+                text);
+}
+
+QString decodeMorph(QString const & data,
+                    Rendering::InfoContext const & context)
+{
     QStringList morphs = data.split('|');
     QString ret;
 
@@ -267,7 +519,7 @@ QString decodeMorph(QString const & data) {
         if (valStart > -1) {
             valueClass = morph.mid(0, valStart);
             // qDebug() << "valueClass: " << valueClass;
-            module = CSwordBackend::instance().findModuleByName(valueClass);
+            module = context.backend().findModuleByName(valueClass);
         }
         value = morph.mid(valStart + 1); /* works for prepended module and
                                             without (-1 +1 == 0). */
@@ -280,13 +532,13 @@ QString decodeMorph(QString const & data) {
             if (value.size() > 1 && value.at(1).isDigit()) {
                 switch (value.at(0).toLatin1()) {
                     case 'G':
-                        module = btConfig().getDefaultSwordModuleByType(
+                        module = context.defaultModule(
                                      QStringLiteral(
                                          "standardGreekMorphLexicon"));
                         skipFirstChar = true;
                         break;
                     case 'H':
-                        module = btConfig().getDefaultSwordModuleByType(
+                        module = context.defaultModule(
                                      QStringLiteral(
                                          "standardHebrewMorphLexicon"));
                         skipFirstChar = true;
@@ -303,53 +555,32 @@ QString decodeMorph(QString const & data) {
             }
             //if it is still not set use the default
             if (!module)
-                module = btConfig().getDefaultSwordModuleByType(
+                module = context.defaultModule(
                              QStringLiteral("standardGreekMorphLexicon"));
         }
 
-        QString text;
-        // BT_ASSERT(module);
-        if (module) {
-            QSharedPointer<CSwordKey> key(module->createKey());
-
-            // skip H or G (language sign) if we have to skip it
-            const bool isOk = key->setKey(skipFirstChar ? value.mid(1) : value);
-            // BT_ASSERT(isOk);
-            /* try to use the other morph lexicon, because this one failed with
-               the current morph code. */
-            if (!isOk) {
-                /// \todo: what if the module doesn't exist?
-                key->setModule(
-                            btConfig().getDefaultSwordModuleByType(
-                                QStringLiteral("standardHebrewMorphLexicon")));
-                key->setKey(skipFirstChar ? value.mid(1) : value);
-            }
-
-            text = key->renderedText();
-        }
-
-        // if the module wasn't found just display an empty morph info
-        ret.append(QStringLiteral("<div class=\"morphinfo\" lang=\"%1\">"
-                                  "<h3>%2: %3</h3><p>%4</p></div>")
-                   .arg(module
-                        ? module->language()->abbrev()
-                        : QStringLiteral("en"),
-                        QObject::tr("Morphology"),
-                        value,
-                        text));
+        ret.append(InfoCache::instance().info(
+                       'M',
+                       morph,
+                       module,
+                       context.backend().filterOptionsKey(),
+                       [module, &value, skipFirstChar, &context] {
+                           return renderMorph(module,
+                                              value,
+                                              skipFirstChar,
+                                              context);
+                       }));
     }
 
     return ret;
 }
 
-QString decodeSwordReference(QString const & data) {
+QString decodeSwordReference(QString const & data, CSwordBackend & backend) {
     static QRegularExpression const rx(
         QStringLiteral(R"PCRE(sword://(bible|lexicon)/(.*)/(.*))PCRE"),
         QRegularExpression::CaseInsensitiveOption);
     if (auto const match = rx.match(data); match.hasMatch()) {
-        if (auto * const module =
-                    CSwordBackend::instance().findModuleByName(
-                        match.captured(2)))
+        if (auto * const module = backend.findModuleByName(match.captured(2)))
         {
             std::unique_ptr<CSwordKey> key(module->createKey());
             auto reference = match.captured(3);
@@ -368,6 +599,29 @@ QString decodeSwordReference(QString const & data) {
 
 namespace Rendering {
 
+InfoContext::InfoContext(CSwordBackend & backend)
+    : m_backend(&backend)
+{
+    for (auto type : {QStringLiteral("standardBible"),
+                      QStringLiteral("standardGreekStrongsLexicon"),
+                      QStringLiteral("standardHebrewStrongsLexicon"),
+                      QStringLiteral("standardGreekMorphLexicon"),
+                      QStringLiteral("standardHebrewMorphLexicon")})
+    {
+        auto name(btConfig().value<QString>(
+                      QStringLiteral("settings/defaults/") + type));
+        m_defaultModuleNames.insert(std::move(type), std::move(name));
+    }
+}
+
+InfoContext::InfoContext() : InfoContext(CSwordBackend::instance()) {}
+
+CSwordModuleInfo * InfoContext::defaultModule(QString const & type) const {
+    BT_ASSERT(m_defaultModuleNames.contains(type));
+    auto const & name = m_defaultModuleNames[type];
+    return name.isEmpty() ? nullptr : m_backend->findModuleByName(name);
+}
+
 ListInfoData detectInfo(QString const & data) {
     ListInfoData list;
     auto const attrList(data.split(QStringLiteral("||")));
@@ -397,6 +651,11 @@ ListInfoData detectInfo(QString const & data) {
 
 
 QString formatInfo(const ListInfoData & list,  BtConstModuleList const & modules)
+{ return formatInfo(list, modules, InfoContext()); }
+
+QString formatInfo(ListInfoData const & list,
+                   BtConstModuleList const & modules,
+                   InfoContext const & context)
 {
     BT_ASSERT(!modules.contains(nullptr) && (modules.size() <= 1 && "not implemented"));
 
@@ -409,16 +668,16 @@ QString formatInfo(const ListInfoData & list,  BtConstModuleList const & modules
         auto const & value = infoData.second;
         switch (infoData.first) {
             case Lemma:
-                text.append(decodeStrongs(value));
+                text.append(decodeStrongs(value, context));
                 continue;
             case Morph:
-                text.append(decodeMorph(value));
+                text.append(decodeMorph(value, context));
                 continue;
             case CrossReference:
-                text.append(decodeCrossReference(value, modules));
+                text.append(decodeCrossReference(value, modules, context));
                 continue;
             case Footnote:
-                text.append(decodeFootnote(value));
+                text.append(decodeFootnote(value, context));
                 continue;
             case Abbreviation:
                 text.append(decodeAbbreviation(value));
@@ -437,9 +696,10 @@ QString formatInfo(const ListInfoData & list,  BtConstModuleList const & modules
                     } else {
                         BT_ASSERT(false && "not implemented");
                     }
-                    text.append(decodeStrongs(v));
+                    text.append(decodeStrongs(v, context));
                 } else if (value.contains(QStringLiteral("sword:"))) {
-                    text.append(decodeSwordReference(value));
+                    text.append(decodeSwordReference(value,
+                                                     context.backend()));
                     continue;
                 } else {
                     BT_ASSERT(false); /// \todo Why is this here?
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QPair>
 #include <QString>
@@ -19,6 +20,9 @@
 #include "../drivers/btmodulelist.h"
 
 
+class CSwordBackend;
+class CSwordModuleInfo;
+
 namespace Rendering {
 
 enum InfoType {
@@ -35,12 +39,64 @@ using InfoData = QPair<InfoType, QString>;
 using ListInfoData = QList<InfoData>;
 
 
+/**
+  \brief The backend infos are rendered with and the default modules used.
+
+  The names of the default modules are read from the configuration when the
+  context is constructed, which must be done in the main thread. To render infos
+  in another thread, e.g. with the backend of a render context (see
+  BtRenderContext), pass a context to that thread and use withBackend().
+*/
+class InfoContext {
+
+public: // methods:
+
+    explicit InfoContext(CSwordBackend & backend);
+
+    /** \brief Uses the regular backend. */
+    InfoContext();
+
+    CSwordBackend & backend() const noexcept { return *m_backend; }
+
+    /**
+      \returns a copy of this context using the given backend, e.g. in the
+               thread rendering the infos.
+    */
+    InfoContext withBackend(CSwordBackend & backend) const {
+        auto r(*this);
+        r.m_backend = &backend;
+        return r;
+    }
+
+    /**
+      \returns the default module of the given type (see
+               BtConfig::getDefaultSwordModuleByType()) in the backend of this
+               context, or nullptr if none.
+    */
+    CSwordModuleInfo * defaultModule(QString const & type) const;
+
+private: // fields:
+
+    CSwordBackend * m_backend;
+    QHash<QString, QString> m_defaultModuleNames;
+
+}; /* class InfoContext */
+
 /** Parse string for attributes */
 ListInfoData detectInfo(QString const & data);
 
 /** Process list of InfoData and format all data into string */
 QString formatInfo(ListInfoData const & info,
                    BtConstModuleList const & modules);
+
+/**
+  \brief Formats the given infos like formatInfo() with the modules and the
+         defaults of the given context. The given modules must be from the
+         backend of the context.
+*/
+QString formatInfo(ListInfoData const & info,
+                   BtConstModuleList const & modules,
+                   InfoContext const & context);
 QString formatInfo(QString const & info, QString const & lang = QString());
 
 } /* namespace Rendering { */
@@ -0,0 +1,61 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btrendercontext.h"
+
+
+namespace Rendering {
+
+CSwordBackend & BtRenderContext::backend() {
+    if (!m_backend)
+        m_backend = CSwordBackend::createWorkerInstance();
+    return *m_backend;
+}
+
+CSwordModuleInfo * BtRenderContext::findModule(QString const & name) {
+    bool const created = !m_backend;
+    auto * module = backend().findModuleByName(name);
+    if (!module && !created) {
+        // The module might have been installed after creating the backend:
+        m_backend = CSwordBackend::createWorkerInstance();
+        module = m_backend->findModuleByName(name);
+    }
+    return module;
+}
+
+BtConstModuleList BtRenderContext::findModules(QStringList const & names) {
+    auto const lookUp =
+            [this, &names] {
+                BtConstModuleList r;
+                for (auto const & name : names) {
+                    auto const * const module =
+                            m_backend->findModuleByName(name);
+                    if (!module)
+                        return BtConstModuleList();
+                    r.append(module);
+                }
+                return r;
+            };
+    if (names.isEmpty())
+        return {};
+    bool const created = !m_backend;
+    backend();
+    auto r(lookUp());
+    if (r.isEmpty() && !created) {
+        // The modules might have been installed after creating the backend:
+        m_backend = CSwordBackend::createWorkerInstance();
+        r = lookUp();
+    }
+    return r;
+}
+
+} /* namespace Rendering */
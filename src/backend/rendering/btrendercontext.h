@@ -0,0 +1,77 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <memory>
+#include <QStringList>
+#include "../drivers/btmodulelist.h"
+#include "../managers/cswordbackend.h"
+
+
+class CSwordModuleInfo;
+
+namespace Rendering {
+
+/**
+  \brief The state needed to render modules in a thread other than the main
+         thread.
+
+  A context owns its own CSwordBackend (see
+  CSwordBackend::createWorkerInstance()), hence its own Sword modules, keys and
+  filter option state. Several threads can therefore render the same module
+  with different filter options at the same time, each in its own context,
+  while reading the entries under CSwordBackend::lockSwordFiles().
+  CTextRendering applies its filter options to the backend of the modules it
+  renders, i.e. to the context those have been looked up in.
+
+  A context must only be used by one thread at a time. Threads which do not
+  render all the time borrow one from BtRenderContextPool instead.
+*/
+class BtRenderContext {
+
+public: // methods:
+
+    /** \returns the backend of this context, which is created when needed. */
+    CSwordBackend & backend();
+
+    /**
+      \brief Discards the backend, so it is recreated with the modules currently
+             installed when needed.
+      \warning This invalidates all modules looked up in this context.
+    */
+    void reset() noexcept { m_backend.reset(); }
+
+    /**
+      \brief Looks up a module in the backend of this context.
+
+      If the module is not found, the backend is recreated once, since the
+      module might have been installed after creating the backend.
+      \warning Recreating the backend invalidates all modules looked up before.
+      \returns the module or nullptr if not found.
+    */
+    CSwordModuleInfo * findModule(QString const & name);
+
+    /**
+      \brief Looks up several modules like findModule().
+      \returns the modules in the given order, or an empty list if any of them
+               was not found.
+    */
+    BtConstModuleList findModules(QStringList const & names);
+
+private: // fields:
+
+    std::unique_ptr<CSwordBackend> m_backend;
+
+}; /* class BtRenderContext */
+
+} /* namespace Rendering */
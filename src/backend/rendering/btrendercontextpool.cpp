@@ -0,0 +1,148 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btrendercontextpool.h"
+
+#include <algorithm>
+#include <QThread>
+#include <utility>
+#include "../../util/btconnect.h"
+#include "../managers/cswordbackend.h"
+
+
+namespace Rendering {
+namespace {
+
+/** Orders queued jobs in a heap, the job to run next on top. */
+template <typename QueuedJob>
+bool runsLater(QueuedJob const & a, QueuedJob const & b) noexcept {
+    if (a.priority != b.priority)
+        return a.priority < b.priority;
+    return a.sequence > b.sequence;
+}
+
+} // anonymous namespace
+
+BtRenderContextPool::Lease::~Lease() {
+    if (m_context)
+        m_pool->release(std::move(m_context), m_generation);
+}
+
+BtRenderContextPool::BtRenderContextPool()
+    : m_size(static_cast<std::size_t>(std::max(QThread::idealThreadCount(),
+                                               1)))
+{
+    // Render with the modules currently installed:
+    auto & backend = CSwordBackend::instance();
+    BT_CONNECT(&backend, &CSwordBackend::sigSwordSetupChanged,
+               &backend, [this]{ reset(); });
+}
+
+BtRenderContextPool::~BtRenderContextPool() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto const & thread : m_threads)
+        thread->wait();
+}
+
+BtRenderContextPool & BtRenderContextPool::instance() {
+    static BtRenderContextPool pool;
+    return pool;
+}
+
+BtRenderContextPool::Lease BtRenderContextPool::acquire() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock,
+                     [this] {
+                         return !m_idleContexts.empty()
+                                || m_numContexts < m_size;
+                     });
+    std::unique_ptr<BtRenderContext> context;
+    if (m_idleContexts.empty()) {
+        // The backend of the context is only created when used:
+        context = std::make_unique<BtRenderContext>();
+        ++m_numContexts;
+    } else {
+        context = std::move(m_idleContexts.back());
+        m_idleContexts.pop_back();
+    }
+    return Lease(*this, std::move(context), m_generation);
+}
+
+void BtRenderContextPool::release(std::unique_ptr<BtRenderContext> context,
+                                  std::uint64_t const generation)
+{
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (generation == m_generation) {
+            m_idleContexts.emplace_back(std::move(context));
+            context.reset();
+        }
+    }
+    if (context) { // Outdated, so reset it without holding the lock:
+        context->reset();
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_idleContexts.emplace_back(std::move(context));
+    }
+    m_condition.notify_all();
+}
+
+void BtRenderContextPool::submit(Job job, Priority const priority) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_jobs.push_back({priority, m_nextSequence++, std::move(job)});
+        std::push_heap(m_jobs.begin(), m_jobs.end(), &runsLater<QueuedJob>);
+        if (m_threads.empty()) {
+            for (std::size_t i = 0u; i < m_size; ++i) {
+                m_threads.emplace_back(QThread::create([this]{ work(); }));
+                m_threads.back()->start(QThread::LowPriority);
+            }
+        }
+    }
+    m_condition.notify_all();
+}
+
+void BtRenderContextPool::reset() {
+    decltype(m_idleContexts) idleContexts;
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        ++m_generation;
+        idleContexts.swap(m_idleContexts);
+        m_numContexts -= idleContexts.size();
+    }
+    // Destroy the backends without holding the lock:
+    idleContexts.clear();
+    m_condition.notify_all();
+}
+
+void BtRenderContextPool::work() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock,
+                             [this]{ return m_stopping || !m_jobs.empty(); });
+            if (m_stopping)
+                return;
+            std::pop_heap(m_jobs.begin(), m_jobs.end(), &runsLater<QueuedJob>);
+            job = std::move(m_jobs.back().job);
+            m_jobs.pop_back();
+        }
+        auto const context(acquire());
+        job(*context);
+    }
+}
+
+} /* namespace Rendering */
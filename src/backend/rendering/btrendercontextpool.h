@@ -0,0 +1,143 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "btrendercontext.h"
+
+
+class QThread;
+
+namespace Rendering {
+
+/**
+  \brief A pool of render contexts shared by the threads rendering in the
+         background, and a scheduler running render jobs on them.
+
+  Creating the backend of a context loads all modules, so threads borrow a
+  context from this pool for the time they render instead of owning one each.
+  The pool holds at most one context per hardware thread, which are reset when
+  the Sword setup changes.
+
+  Jobs submitted are run by as many worker threads as there are contexts, jobs
+  of higher priority first and jobs of equal priority in the order submitted.
+*/
+class BtRenderContextPool {
+
+public: // types:
+
+    enum class Priority : unsigned char { Background, Normal, Interactive };
+
+    /** A job rendering in the given context borrowed for it. */
+    using Job = std::function<void (BtRenderContext &)>;
+
+    /** A context borrowed from the pool, which is returned when destroyed. */
+    class Lease {
+
+        friend class BtRenderContextPool;
+
+    public: // methods:
+
+        Lease(Lease && move) noexcept = default;
+        Lease & operator=(Lease && move) = delete;
+        ~Lease();
+
+        BtRenderContext & operator*() const noexcept { return *m_context; }
+        BtRenderContext * operator->() const noexcept
+        { return m_context.get(); }
+
+    private: // methods:
+
+        Lease(BtRenderContextPool & pool,
+              std::unique_ptr<BtRenderContext> context,
+              std::uint64_t generation) noexcept
+            : m_pool(&pool)
+            , m_context(std::move(context))
+            , m_generation(generation)
+        {}
+
+    private: // fields:
+
+        BtRenderContextPool * m_pool;
+        std::unique_ptr<BtRenderContext> m_context;
+        std::uint64_t m_generation;
+
+    }; /* class Lease */
+
+public: // methods:
+
+    ~BtRenderContextPool();
+
+    static BtRenderContextPool & instance();
+
+    /** \returns the maximum number of contexts in the pool. */
+    std::size_t size() const noexcept { return m_size; }
+
+    /**
+      \brief Borrows a context, waiting until one is available.
+      \warning A thread must not borrow a second context while holding one,
+               since it might wait for itself.
+    */
+    Lease acquire();
+
+    /** \brief Queues the given job to run in a worker thread. */
+    void submit(Job job, Priority priority = Priority::Normal);
+
+    /**
+      \brief Resets all contexts, so that they are recreated with the modules
+             currently installed when used next.
+
+      Contexts currently borrowed are reset when they are returned.
+    */
+    void reset();
+
+private: // types:
+
+    struct QueuedJob {
+        Priority priority;
+        std::uint64_t sequence;
+        Job job;
+    };
+
+private: // methods:
+
+    BtRenderContextPool();
+
+    void release(std::unique_ptr<BtRenderContext> context,
+                 std::uint64_t generation);
+
+    void work();
+
+private: // fields:
+
+    std::size_t const m_size;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::unique_ptr<BtRenderContext>> m_idleContexts;
+    std::size_t m_numContexts = 0u; ///< Idle and borrowed contexts
+    std::uint64_t m_generation = 0u;
+    std::vector<QueuedJob> m_jobs; ///< A heap of the jobs queued
+    std::uint64_t m_nextSequence = 0u;
+    std::vector<std::unique_ptr<QThread>> m_threads;
+    bool m_stopping = false;
+
+}; /* class BtRenderContextPool */
+
+} /* namespace Rendering */
@@ -0,0 +1,74 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btrendertimestatistics.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace {
+
+/** The 95th percentile above which modules are considered slow. */
+constexpr std::chrono::milliseconds const slowRenderTime(20);
+
+/** The number of recorded times after which the modules are classified. */
+constexpr std::size_t const minSamples = 16u;
+
+} // anonymous namespace
+
+void BtRenderTimeStatistics::record(
+        std::chrono::steady_clock::duration const time) noexcept
+{
+    auto const us =
+            std::chrono::duration_cast<std::chrono::microseconds>(time)
+            .count();
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_samples[m_numRecorded % windowSize] =
+            static_cast<std::uint32_t>(
+                std::clamp<decltype(us)>(
+                    us,
+                    0,
+                    std::numeric_limits<std::uint32_t>::max()));
+    ++m_numRecorded;
+
+    // Classify the module again once in a while only:
+    if (m_numRecorded >= minSamples && m_numRecorded % minSamples == 0u)
+        m_slow.store(summaryLocked().p95 >= slowRenderTime,
+                     std::memory_order_relaxed);
+}
+
+BtRenderTimeStatistics::Summary BtRenderTimeStatistics::summary() const {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return summaryLocked();
+}
+
+BtRenderTimeStatistics::Summary BtRenderTimeStatistics::summaryLocked() const
+{
+    auto const n = std::min(m_numRecorded, windowSize);
+    if (!n)
+        return {0u, {}, {}};
+    std::vector<std::uint32_t> samples(m_samples.begin(),
+                                       m_samples.begin()
+                                       + static_cast<std::ptrdiff_t>(n));
+    std::uint64_t sum = 0u;
+    for (auto const sample : samples)
+        sum += sample;
+    auto const p95 = samples.begin()
+                     + static_cast<std::ptrdiff_t>((n - 1u) * 95u / 100u);
+    std::nth_element(samples.begin(), p95, samples.end());
+    using Rep = std::chrono::microseconds::rep;
+    return {n,
+            std::chrono::microseconds(static_cast<Rep>(sum / n)),
+            std::chrono::microseconds(static_cast<Rep>(*p95))};
+}
@@ -0,0 +1,67 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+
+/**
+  \brief The times taken by the most recent renderings of the entries of a
+         module for display, to tell modules which render slowly.
+
+  The times are recorded by the renderers of any thread.
+*/
+class BtRenderTimeStatistics {
+
+public: // types:
+
+    struct Summary {
+        std::size_t samples; ///< The number of times in the rolling window
+        std::chrono::microseconds mean;
+        std::chrono::microseconds p95;
+    };
+
+public: // methods:
+
+    /** \brief Records the time taken to render a single entry. */
+    void record(std::chrono::steady_clock::duration time) noexcept;
+
+    /** \returns the statistics of the times in the rolling window. */
+    Summary summary() const;
+
+    /**
+      \returns whether the 95th percentile of the recorded times is so high
+               that users notice the rendering of single entries.
+    */
+    bool isSlow() const noexcept
+    { return m_slow.load(std::memory_order_relaxed); }
+
+private: // methods:
+
+    Summary summaryLocked() const;
+
+private: // fields:
+
+    constexpr static std::size_t const windowSize = 128u;
+
+    mutable std::mutex m_mutex;
+    std::array<std::uint32_t, windowSize> m_samples{}; ///< In microseconds
+    std::size_t m_numRecorded = 0u;
+    std::atomic<bool> m_slow{false};
+
+}; /* class BtRenderTimeStatistics */
@@ -12,6 +12,7 @@
 
 #include "cdisplayrendering.h"
 
+#include <memory>
 #include <QRegularExpression>
 #include <QString>
 #include <QtGlobal>
@@ -50,21 +51,25 @@ CDisplayRendering::CDisplayRendering()
 CDisplayRendering::CDisplayRendering(DisplayOptions const & displayOptions,
                                      FilterOptions const & filterOptions)
     : CTextRendering(true, displayOptions, filterOptions)
-{}
+{ m_recordRenderTimes = true; }
 
-QString CDisplayRendering::renderDisplayEntry(
+namespace {
+
+/**
+  \brief Appends the items of the given key as shown in the displays, i.e.
+         including the intros of the book and chapter before their first verse.
+*/
+void appendDisplayEntry(
+        CTextRendering::KeyTree & tree,
         BtConstModuleList const & modules,
         QString const & keyName,
         CTextRendering::KeyTreeItem::Settings::KeyRenderingFace keyRendering)
-        const
 {
     BT_ASSERT(!keyName.isEmpty());
 
     //no highlighted key and no extra key link in the text
     const CSwordModuleInfo *module = modules.first();
 
-    Rendering::CTextRendering::KeyTree tree;
-
     //in Bibles and Commentaries we need to check if 0:0 and X:0 contain something
     if (module->type() == CSwordModuleInfo::Bible
         || module->type() == CSwordModuleInfo::Commentary)
@@ -97,9 +102,52 @@ QString CDisplayRendering::renderDisplayEntry(
     }
     using Settings = CTextRendering::KeyTreeItem::Settings;
     tree.emplace_back(keyName, modules, Settings{false, keyRendering});
+}
+
+} // anonymous namespace
+
+QString CDisplayRendering::renderDisplayEntry(
+        BtConstModuleList const & modules,
+        QString const & keyName,
+        CTextRendering::KeyTreeItem::Settings::KeyRenderingFace keyRendering)
+        const
+{
+    Rendering::CTextRendering::KeyTree tree;
+    appendDisplayEntry(tree, modules, keyName, keyRendering);
     return renderKeyTree(tree);
 }
 
+std::vector<QString> CDisplayRendering::renderDisplayEntries(
+        BtConstModuleList const & modules,
+        CSwordVerseKey const & lowerBound,
+        CSwordVerseKey const & upperBound,
+        CTextRendering::KeyTreeItem::Settings::KeyRenderingFace keyRendering)
+        const
+{
+    BT_ASSERT(!modules.isEmpty());
+    applyFilterOptions(modules);
+
+    // A single key is enough for all entries of a single module:
+    std::unique_ptr<CSwordKey> key(modules.count() == 1
+                                   ? modules.first()->createKey()
+                                   : nullptr);
+    std::vector<QString> r;
+    QString entries; // Reused for all verses
+    KeyTree tree; // Reused for all verses
+    CSwordVerseKey verseKey(lowerBound);
+    verseKey.setIntros(true);
+    for (;;) {
+        tree.clear();
+        appendDisplayEntry(tree, modules, verseKey.key(), keyRendering);
+        entries.resize(0);
+        for (auto const & item : tree)
+            entries.append(renderEntry(item, key.get()));
+        r.emplace_back(finishText(entries, tree));
+        if (!(verseKey < upperBound) || !verseKey.next())
+            return r;
+    }
+}
+
 QString CDisplayRendering::entryLink(KeyTreeItem const & item,
                                      CSwordModuleInfo const & module) const
 {
@@ -15,6 +15,7 @@
 #include "ctextrendering.h"
 
 #include <utility>
+#include <vector>
 
 
 namespace Rendering {
@@ -48,6 +49,20 @@ public: // methods:
                         CTextRendering::KeyTreeItem::Settings::CompleteShort)
             const;
 
+    /**
+      \brief Renders the verses from the lower to the upper bound in a single
+             pass, stepping through the verses sequentially and reusing the
+             same key for all of them.
+      \returns the verses rendered like renderDisplayEntry() would render each
+               of them, in order.
+    */
+    std::vector<QString> renderDisplayEntries(
+            BtConstModuleList const & modules,
+            CSwordVerseKey const & lowerBound,
+            CSwordVerseKey const & upperBound,
+            CTextRendering::KeyTreeItem::Settings::KeyRenderingFace
+                    keyRendering) const;
+
 protected: // methods:
 
     QString entryLink(KeyTreeItem const & item,
@@ -18,6 +18,7 @@
 #include "../drivers/btmodulelist.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../keys/cswordkey.h"
+#include "../keys/cswordversekey.h"
 
 
 
@@ -40,13 +41,28 @@ QString CPlainTextExportRendering::renderEntry(KeyTreeItem const & i,
             renderedText += QStringLiteral("   ") + module->name();
     renderedText += QStringLiteral(":\n");
 
+    auto * const verseKey = dynamic_cast<CSwordVerseKey *>(key.get());
+    QString entry; // Reused for the texts of all modules
     for (auto const * const module : modules) {
-        key->setModule(module);
-        key->setKey(i.key());
-        QString entry = key->strippedText().append('\n');
+        if (verseKey) {
+            key->setModule(modules.first());
+            // Positioning by index spares parsing the key of every verse:
+            if (i.verseIndex() >= 0
+                && verseKey->versification() == i.versification())
+            {
+                verseKey->setIndex(i.verseIndex());
+            } else {
+                key->setKey(i.key());
+            }
+            key->setModule(module); // Maps the verse to its versification
+        } else {
+            key->setModule(module);
+            key->setKey(i.key());
+        }
+        key->strippedTextInto(entry);
+        renderedText.append(entry).append('\n');
         if (modules.count() > 1)
-            entry.append('\n');
-        renderedText.append(entry);
+            renderedText.append('\n');
     }
     return renderedText;
 }
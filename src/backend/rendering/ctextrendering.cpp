@@ -12,15 +12,33 @@
 
 #include "ctextrendering.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <QLatin1String>
+#include <QStringList>
+#include <QStringBuilder>
+#include <QStringView>
+#include <QTextStream>
+#include <QThread>
 #include <QtAlgorithms>
+#include <utility>
+#include <vector>
 #include "../../util/btassert.h"
+#include "../../util/bttrace.h"
 #include "../config/btconfig.h"
 #include "../drivers/cswordmoduleinfo.h"
 #include "../keys/cswordkey.h"
 #include "../keys/cswordversekey.h"
 #include "../managers/cdisplaytemplatemgr.h"
 #include "../managers/cswordbackend.h"
+#include "btflatkeytree.h"
+#include "btrendercontextpool.h"
 
 // Sword includes:
 #include <swkey.h>
@@ -28,6 +46,46 @@
 
 using namespace Rendering;
 
+//Number of entries rendered at once by streaming renderKeyTree()
+constexpr static std::size_t const BT_RENDER_BATCH_SIZE = 100u;
+
+namespace {
+
+/**
+  \brief Appends a copy of the given item and its children to the tree, using
+         the modules of the given backend.
+  \returns whether all modules of the item are available in the backend.
+*/
+bool copyKeyTreeItem(CTextRendering::KeyTree & tree,
+                     CTextRendering::KeyTreeItem const & item,
+                     CSwordBackend & backend)
+{
+    if (item.hasAlternativeContent()) {
+        tree.emplace_back(item.getAlternativeContent(), item.settings());
+    } else {
+        BtConstModuleList modules;
+        for (auto const * const module : item.modules()) {
+            auto const * const backendModule =
+                    backend.findModuleByName(module->name());
+            if (!backendModule)
+                return false;
+            modules.append(backendModule);
+        }
+        tree.emplace_back(item.key(),
+                          item.verseIndex(),
+                          item.versification(),
+                          modules,
+                          item.settings());
+    }
+    auto & childList = tree.back().childList();
+    for (auto const & child : item.childList())
+        if (!copyKeyTreeItem(childList, child, backend))
+            return false;
+    return true;
+}
+
+} // anonymous namespace
+
 CTextRendering::KeyTreeItem::KeyTreeItem(const QString &key,
                                          const CSwordModuleInfo *module,
                                          const Settings &settings)
@@ -49,6 +107,18 @@ CTextRendering::KeyTreeItem::KeyTreeItem(const QString &key,
     , m_key(key)
 {}
 
+CTextRendering::KeyTreeItem::KeyTreeItem(QString const & key,
+                                         long const verseIndex,
+                                         QString versification,
+                                         BtConstModuleList const & modules,
+                                         Settings const & settings)
+    : m_settings(settings)
+    , m_moduleList(modules)
+    , m_key(key)
+    , m_verseIndex(verseIndex)
+    , m_versification(std::move(versification))
+{}
+
 CTextRendering::KeyTreeItem::KeyTreeItem(const QString &startKey,
                                          const QString &stopKey,
                                          const CSwordModuleInfo *module,
@@ -70,10 +140,13 @@ CTextRendering::KeyTreeItem::KeyTreeItem(const QString &startKey,
 
         if (!m_key.isEmpty() && !stopKey.isEmpty()) { //we have a range of keys
             bool ok = true;
+            auto const versification(start.versification());
 
             while (ok && ((start < stop) || (start == stop)) ) { //range
                 m_childList.emplace_back(start.key(),
-                                         module,
+                                         start.index(),
+                                         versification,
+                                         m_moduleList,
                                          KeyTreeItem::Settings{
                                              false,
                                              settings.keyRenderingFace});
@@ -160,28 +233,270 @@ BtConstModuleList CTextRendering::collectModules(KeyTree const & tree) {
     return modules;
 }
 
-QString CTextRendering::renderKeyTree(KeyTree const & tree) const {
+void CTextRendering::applyFilterOptions(BtConstModuleList const & modules)
+        const
+{
+    /* Set the options on the backend of the modules, which might not be
+       CSwordBackend::instance() when rendering in a BtRenderContext. Without
+       modules there is nothing to apply them to, and changing the options of
+       the global backend might interfere with other threads: */
     //CSwordBackend::instance()()->setDisplayOptions( m_displayOptions );
-    CSwordBackend::instance().setFilterOptions(m_filterOptions);
+    if (!modules.isEmpty())
+        modules.first()->backend().setFilterOptions(m_filterOptions);
+}
 
+QString CTextRendering::renderKeyTree(
+        KeyTree const & tree,
+        BtCancellationToken const & cancellation) const
+{
+    BT_TRACE_SPAN("render key tree");
+    auto entries(renderEntries(tree, cancellation));
+    if (entries.isNull())
+        return {};
+    return finishText(entries, tree);
+}
+
+QString CTextRendering::renderKeyTree(
+        BtFlatKeyTree const & tree,
+        BtCancellationToken const & cancellation) const
+{
+    BT_TRACE_SPAN("render key tree");
+    auto entries(renderEntries(tree, cancellation));
+    if (entries.isNull())
+        return {};
+    return finishText(entries, tree.modulesTree());
+}
+
+std::pair<QString, qsizetype>
+CTextRendering::finishedFrame(KeyTree const & tree) const {
+    static QString const marker(QStringLiteral("<!--BT_ENTRIES-->"));
+    auto frame(finishText(marker, tree));
+    auto const markerPos = frame.indexOf(marker);
+    BT_ASSERT(markerPos >= 0);
+    frame.remove(markerPos, marker.size());
+    return {std::move(frame), markerPos};
+}
+
+QString CTextRendering::renderEntries(
+        KeyTree const & tree,
+        BtCancellationToken const & cancellation) const
+{
     const BtConstModuleList modules = collectModules(tree);
-    QString t;
+    applyFilterOptions(modules);
+
+    QString t(QStringLiteral("")); // Not null, unlike a cancelled rendering
+    t.reserve(m_entrySizeHint * static_cast<qsizetype>(tree.size()));
 
     //optimization for entries with the same key
 
     if (modules.count() == 1) { //this optimizes the rendering, only one key created for all items
         std::unique_ptr<CSwordKey> key(modules.first()->createKey());
         for (auto const & item : tree) {
-            key->setKey(item.key());
-            t.append(renderEntry(item, key.get()));
+            if (cancellation.cancelled())
+                return {};
+            t.append(renderEntry(item, key.get())); // Positions the key
         }
     }
     else {
-        for (auto const & item : tree)
+        for (auto const & item : tree) {
+            if (cancellation.cancelled())
+                return {};
             t.append(renderEntry(item));
+        }
+    }
+
+    if (!tree.empty())
+        m_entrySizeHint = t.size() / static_cast<qsizetype>(tree.size());
+    return t;
+}
+
+QString CTextRendering::renderEntries(
+        BtFlatKeyTree const & tree,
+        BtCancellationToken const & cancellation) const
+{
+    BtConstModuleList const modules = tree.collectModules();
+    applyFilterOptions(modules);
+
+    QString t(QStringLiteral("")); // Not null, unlike a cancelled rendering
+    t.reserve(m_entrySizeHint * static_cast<qsizetype>(tree.size()));
+
+    std::unique_ptr<CSwordKey> key;
+    if (modules.count() == 1) // A single key for all entries
+        key.reset(modules.first()->createKey());
+    std::optional<KeyTreeItem> item; // The item of the entry rendered
+    for (auto const & entry : tree) {
+        if (cancellation.cancelled())
+            return {};
+        tree.emplaceItem(item, entry);
+        t.append(renderEntry(*item, key.get())); // Positions the key
+    }
+
+    if (!tree.empty())
+        m_entrySizeHint = t.size() / static_cast<qsizetype>(tree.size());
+    return t;
+}
+
+bool CTextRendering::renderKeyTree(
+        KeyTree const & tree,
+        QTextStream & out,
+        std::function<bool(std::size_t)> const & progress) const
+{
+    BT_TRACE_SPAN("render key tree");
+    BtConstModuleList const modules = collectModules(tree);
+    applyFilterOptions(modules);
+
+    // Write the finished text around the entries separately:
+    auto const [frame, entriesPos] = finishedFrame(tree);
+    out << QStringView(frame).left(entriesPos);
+
+    std::unique_ptr<CSwordKey> key;
+    if (modules.count() == 1) //only one key created for all items
+        key.reset(modules.first()->createKey());
+    QString batch;
+    std::size_t rendered = 0u;
+    for (auto const & item : tree) {
+        batch.append(renderEntry(item, key.get())); // Positions the key
+        if (++rendered % BT_RENDER_BATCH_SIZE == 0u
+            || rendered == tree.size())
+        {
+            out << batch;
+            batch.truncate(0);
+            if (progress && !progress(rendered))
+                return false;
+        }
+    }
+
+    out << QStringView(frame).mid(entriesPos);
+    return true;
+}
+
+bool CTextRendering::renderKeyTreeInParallel(
+        KeyTree const & tree,
+        QTextStream & out,
+        std::function<std::unique_ptr<CTextRendering>()> const & newRenderer,
+        std::function<bool(std::size_t)> const & progress) const
+{
+    using Batch = std::pair<KeyTree::const_iterator, KeyTree::const_iterator>;
+    std::vector<Batch> batches;
+    for (auto it = tree.begin(); it != tree.end();) {
+        auto const begin = it;
+        for (std::size_t i = 0u;
+             i < BT_RENDER_BATCH_SIZE && it != tree.end();
+             ++i)
+            ++it;
+        batches.emplace_back(begin, it);
+    }
+    auto const numThreads =
+            std::min(BtRenderContextPool::instance().size(),
+                     batches.size());
+    if (numThreads <= 1u)
+        return renderKeyTree(tree, out, progress);
+
+    /* Keep the rendered batches not written yet bounded, so that memory use
+       does not grow with the size of the tree: */
+    auto const maxBatchesAhead = 4u * numThreads;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::optional<QString>> texts(batches.size());
+    std::vector<bool> failed(batches.size(), false);
+    std::size_t nextBatch = 0u;
+    std::size_t written = 0u;
+    bool stopping = false;
+
+    auto const work =
+            [&] {
+                auto const context(BtRenderContextPool::instance().acquire());
+                std::unique_ptr<CTextRendering> renderer;
+                for (;;) {
+                    std::size_t batch;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(
+                                    lock,
+                                    [&] {
+                                        return stopping
+                                               || nextBatch >= batches.size()
+                                               || nextBatch
+                                                  < written + maxBatchesAhead;
+                                    });
+                        if (stopping || nextBatch >= batches.size())
+                            return;
+                        batch = nextBatch++;
+                    }
+                    if (!renderer)
+                        renderer = newRenderer();
+                    KeyTree workerTree;
+                    bool ok = true;
+                    for (auto it = batches[batch].first;
+                         ok && it != batches[batch].second;
+                         ++it)
+                        ok = copyKeyTreeItem(workerTree,
+                                             *it,
+                                             context->backend());
+                    std::optional<QString> text;
+                    if (ok)
+                        text.emplace(renderer->renderEntries(workerTree));
+                    {
+                        std::lock_guard<std::mutex> const guard(mutex);
+                        if (text) {
+                            texts[batch] = std::move(text);
+                        } else {
+                            failed[batch] = true;
+                        }
+                    }
+                    condition.notify_all();
+                }
+            };
+    std::vector<std::unique_ptr<QThread>> threads;
+    threads.reserve(numThreads);
+    for (std::size_t i = 0u; i < numThreads; ++i) {
+        threads.emplace_back(QThread::create(work));
+        threads.back()->start();
     }
 
-    return finishText(t, tree);
+    auto const [frame, entriesPos] = finishedFrame(tree);
+    out << QStringView(frame).left(entriesPos);
+
+    bool r = true;
+    std::size_t rendered = 0u;
+    for (std::size_t batch = 0u; batch < batches.size(); ++batch) {
+        std::optional<QString> text;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock,
+                           [&] { return texts[batch] || failed[batch]; });
+            text = std::move(texts[batch]);
+            texts[batch].reset();
+            written = batch + 1u;
+        }
+        condition.notify_all();
+
+        auto const & [begin, end] = batches[batch];
+        if (!text) { // Modules unavailable to the worker threads
+            KeyTree batchTree;
+            for (auto it = begin; it != end; ++it)
+                copyKeyTreeItem(batchTree, *it, CSwordBackend::instance());
+            text.emplace(renderEntries(batchTree));
+        }
+        out << *text;
+        rendered += static_cast<std::size_t>(std::distance(begin, end));
+        if (progress && !progress(rendered)) {
+            r = false;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> const guard(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto const & thread : threads)
+        thread->wait();
+
+    if (r)
+        out << QStringView(frame).mid(entriesPos);
+    return r;
 }
 
 QString CTextRendering::renderKeyRange(
@@ -189,18 +504,54 @@ QString CTextRendering::renderKeyRange(
         CSwordVerseKey const & upperBound,
         const BtConstModuleList &modules,
         const QString &highlightKey,
-        const KeyTreeItem::Settings &keySettings)
+        const KeyTreeItem::Settings &keySettings,
+        BtCancellationToken const & cancellation)
 {
 
     if (lowerBound == upperBound) // same key, render single key:
         return renderSingleKey(lowerBound.key(), modules, keySettings);
+    return renderKeyTree(flatKeyRangeTree(lowerBound,
+                                          upperBound,
+                                          modules,
+                                          highlightKey,
+                                          keySettings),
+                         cancellation);
+}
+
+CTextRendering::KeyTree CTextRendering::keyRangeTree(
+        CSwordVerseKey const & lowerBound,
+        CSwordVerseKey const & upperBound,
+        BtConstModuleList const & modules,
+        QString const & highlightKey,
+        KeyTreeItem::Settings const & keySettings)
+{
+    return flatKeyRangeTree(lowerBound,
+                            upperBound,
+                            modules,
+                            highlightKey,
+                            keySettings).toKeyTree();
+}
+
+BtFlatKeyTree CTextRendering::flatKeyRangeTree(
+        CSwordVerseKey const & lowerBound,
+        CSwordVerseKey const & upperBound,
+        BtConstModuleList const & modules,
+        QString const & highlightKey,
+        KeyTreeItem::Settings const & keySettings)
+{
+    BtFlatKeyTree tree;
+    if (lowerBound == upperBound) {
+        tree.append(lowerBound.key(), modules, keySettings);
+        return tree;
+    }
 
-    // Render range:
     BT_ASSERT(lowerBound < upperBound);
-    KeyTree tree;
     KeyTreeItem::Settings settings = keySettings;
+    tree.reserve(static_cast<std::size_t>(upperBound.index()
+                                          - lowerBound.index() + 1));
 
     auto curKey = lowerBound;
+    auto const versification(curKey.versification());
     do {
         //make sure the key given by highlightKey gets marked as current key
         settings.highlight = (!highlightKey.isEmpty() ? (curKey.key() == highlightKey) : false);
@@ -213,17 +564,25 @@ QString CTextRendering::renderKeyRange(
 
         if (curKey.chapter() == 0) { // range was 0:0-1:x, render 0:0 first and jump to 1:0
             curKey.setVerse(0);
-            tree.emplace_back(curKey.key(), modules, settings);
+            tree.append(curKey.key(),
+                        modules,
+                        settings,
+                        curKey.index(),
+                        versification);
             curKey.setChapter(1);
             curKey.setVerse(0);
         }
-        tree.emplace_back(curKey.key(), modules, settings);
+        tree.append(curKey.key(),
+                    modules,
+                    settings,
+                    curKey.index(),
+                    versification);
         if (!curKey.next()) {
             /// \todo Notify the user about this failure.
             break;
         }
     } while (curKey < upperBound);
-    return renderKeyTree(tree);
+    return tree;
 }
 
 QString CTextRendering::renderSingleKey(
@@ -282,12 +641,26 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
                       ? QStringLiteral("\n")
                       : QStringLiteral("\n\t\t<tr>\n"));
     // Only insert the table stuff if we are displaying parallel.
+    auto const currentClass = (i.settings().highlight
+                               ? QStringLiteral("current")
+                               : QString());
 
+    QString entry; // Reused for the entries of all modules
+    QString key_renderedText; // Reused for the texts of all modules
+    QString boundText; // Reused for the verses of bound keys
     for (auto const & modulePtr : modules) {
         BT_ASSERT(modulePtr);
+        auto const renderStart = std::chrono::steady_clock::now();
         if (myVK) {
             key->setModule(*modules.begin());
-            key->setKey(i.key());
+            // Positioning by index spares parsing the key of every verse:
+            if (i.verseIndex() >= 0
+                && myVK->versification() == i.versification())
+            {
+                myVK->setIndex(i.verseIndex());
+            } else {
+                key->setKey(i.key());
+            }
 
             // this would change key position due to v11n translation
             key->setModule(modulePtr);
@@ -300,13 +673,13 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
         i.setMappedKey(key->key() != i.key() ? key : nullptr);
 
         auto & swModule = modulePtr->swordModule();
-        auto const langAttr =
-                QStringLiteral(" xml:lang=\"%1\" lang=\"%1\"").arg(
-                    modulePtr->language()->abbrev());
+        auto const & langAbbrev = modulePtr->language()->abbrev();
+        QString const langAttr(QStringLiteral(" xml:lang=\"") % langAbbrev
+                               % QStringLiteral("\" lang=\"") % langAbbrev
+                               % u'"');
 
-        QString key_renderedText;
         if (key->isValid() && i.key() == key->key()) {
-            key_renderedText = key->renderedText();
+            key->renderTextInto(key_renderedText);
 
             // if key was expanded
             if (CSwordVerseKey const * const vk =
@@ -319,7 +692,8 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
                     for (auto i = lowerBoundIndex; i < upperBoundIndex; ++i) {
                         key_renderedText += ' ';
                         pk.setIndex(i + 1);
-                        key_renderedText += pk.renderedText();
+                        pk.renderTextInto(boundText);
+                        key_renderedText += boundText;
                     }
                 }
             }
@@ -328,16 +702,35 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
                     QStringLiteral("<span class=\"inactive\">&#8212;</span>");
         }
 
-        QString entry;
+        entry.resize(0);
         if (m_filterOptions.headings && key->isValid() && i.key() == key->key()) {
 
-            // only process EntryAttributes, do not render, this might destroy the EntryAttributes again
-            swModule.renderText(nullptr, -1, 0);
+            /* The preverse headings of verses are usually in the attribute
+               store of the index, which spares running the filters again: */
+            QStringList preverseHeadings;
+            auto const store(myVK ? modulePtr->verseAttributeStore()
+                                  : nullptr);
+            if (store) {
+                preverseHeadings =
+                        store->headings(
+                            static_cast<std::uint32_t>(myVK->index()));
+            } else {
+                // only process EntryAttributes, do not render, this might destroy the EntryAttributes again
+                {
+                    auto const lock(CSwordBackend::lockSwordFiles());
+                    swModule.renderText(nullptr, -1, 0);
+                }
 
-            for (auto const & vp
-                 : swModule.getEntryAttributes()["Heading"]["Preverse"])
-            {
-                auto preverseHeading(QString::fromUtf8(vp.second.c_str()));
+                for (auto const & vp
+                     : swModule.getEntryAttributes()["Heading"]["Preverse"])
+                    preverseHeadings.append(
+                                QString::fromUtf8(
+                                    vp.second.c_str(),
+                                    static_cast<qsizetype>(vp.second.size())));
+            }
+
+            QString heading;
+            for (auto preverseHeading : preverseHeadings) {
                 if (preverseHeading.isEmpty())
                     continue;
 
@@ -398,29 +791,29 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
 
                 /// \todo Take care of the heading type!
                 if (!preverseHeading.isEmpty())
-                    entry = QStringLiteral(
-                                "<div%1 class=\"sectiontitle\">%2</div>")
-                            .arg(langAttr, preverseHeading);
+                    heading = std::move(preverseHeading);
             }
+            if (!heading.isEmpty())
+                entry += QStringLiteral("<div") % langAttr
+                         % QStringLiteral(" class=\"sectiontitle\">")
+                         % heading % QStringLiteral("</div>");
         }
 
-        entry.append(m_displayOptions.lineBreaks
-                     ? QStringLiteral("<div class=\"")
-                     : QStringLiteral("<div class=\"inline "));
-        if (oneModule && i.settings().highlight)
-            entry.append(QStringLiteral("current"));
-        entry.append(QStringLiteral("entry\""));
-        auto const textDirectionAttribute =
-                QStringLiteral(" dir=\"%1\">").arg(
-                    modulePtr->textDirectionAsHtml());
-        entry.append(langAttr).append(textDirectionAttribute);
+        QString const textDirectionAttribute(
+                    QStringLiteral(" dir=\"")
+                    % QLatin1String(modulePtr->textDirectionAsHtml())
+                    % QStringLiteral("\">"));
+        entry += (m_displayOptions.lineBreaks
+                  ? QStringLiteral("<div class=\"")
+                  : QStringLiteral("<div class=\"inline "))
+                 % (oneModule ? currentClass : QString())
+                 % QStringLiteral("entry\"") % langAttr
+                 % textDirectionAttribute;
 
         //keys should normally be left-to-right, but this doesn't apply in all cases
         if(key->isValid() && i.key() == key->key())
-            entry.append(
-                    QStringLiteral(
-                            "<span class=\"entryname\" dir=\"ltr\">%1</span>")
-                    .arg(entryLink(i, *modulePtr)));
+            entry += QStringLiteral("<span class=\"entryname\" dir=\"ltr\">")
+                     % entryLink(i, *modulePtr) % QStringLiteral("</span>");
 
         if (m_addText)
             entry.append(key_renderedText);
@@ -431,18 +824,17 @@ QString CTextRendering::renderEntry(KeyTreeItem const & i, CSwordKey * k) const
         entry.append(QStringLiteral("</div>"));
 
         if (oneModule) {
-            renderedText.append(QStringLiteral("\t\t%1\n").arg(entry));
+            renderedText += QStringLiteral("\t\t") % entry % u'\n';
         } else {
-            renderedText.append(
-                        QStringLiteral("\t\t<td class=\"%1entry\"%2%3\n\t\t\t%4"
-                                       "\n\t\t</td>\n")
-                        .arg(i.settings().highlight
-                             ? QStringLiteral("current")
-                             : QString(),
-                             langAttr,
-                             textDirectionAttribute,
-                             entry));
+            renderedText += QStringLiteral("\t\t<td class=\"") % currentClass
+                            % QStringLiteral("entry\"") % langAttr
+                            % textDirectionAttribute
+                            % QStringLiteral("\n\t\t\t") % entry
+                            % QStringLiteral("\n\t\t</td>\n");
         }
+        if (m_recordRenderTimes)
+            modulePtr->renderTimes().record(
+                        std::chrono::steady_clock::now() - renderStart);
     }
 
     if (!oneModule)
@@ -12,17 +12,25 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <list>
+#include <memory>
 #include <QString>
+#include <utility>
+#include "../../util/btcancellationtoken.h"
 #include "../btglobal.h"
 #include "../drivers/btmodulelist.h"
 
 
 class CSwordKey;
 class CSwordVerseKey;
+class QTextStream;
 
 namespace Rendering {
 
+class BtFlatKeyTree;
+
 /**
  * CTextRendering is BibleTime's place where the actual rendering takes place.
  * It provides several methods to convert an abstract tree of items
@@ -72,6 +80,17 @@ class CTextRendering {
                             const BtConstModuleList &modules,
                             const Settings &settings);
 
+                /**
+                  \brief Creates the item of a verse, which is also known by
+                         its index in the given versification, so that
+                         rendering can position keys without parsing the key.
+                */
+                KeyTreeItem(QString const & key,
+                            long verseIndex,
+                            QString versification,
+                            BtConstModuleList const & modules,
+                            Settings const & settings);
+
                 KeyTreeItem(const QString &startKey,
                             const QString &stopKey,
                             const CSwordModuleInfo *module,
@@ -93,6 +112,13 @@ class CTextRendering {
 
                 QString const & key() const { return m_key; }
 
+                /** \returns the index of the verse, or -1 if not known. */
+                long verseIndex() const noexcept { return m_verseIndex; }
+
+                /** \returns the versification of verseIndex(). */
+                QString const & versification() const noexcept
+                { return m_versification; }
+
                 Settings const & settings() const { return m_settings; }
 
                 KeyTree & childList() const noexcept { return m_childList; }
@@ -107,6 +133,8 @@ class CTextRendering {
                 Settings m_settings;
                 BtConstModuleList m_moduleList;
                 QString m_key;
+                long m_verseIndex = -1;
+                QString m_versification;
                 mutable CSwordKey const * m_mappedKey = nullptr;
                 mutable KeyTree m_childList;
 
@@ -139,14 +167,85 @@ class CTextRendering {
             m_displayOptions = displayOptions;
         }
 
-        QString renderKeyTree(KeyTree const & tree) const;
+        /**
+          \returns the rendered tree, or a null string if rendering was
+                   stopped because the given token was cancelled.
+        */
+        QString renderKeyTree(
+                KeyTree const & tree,
+                BtCancellationToken const & cancellation = {}) const;
+
+        /** \brief Renders the flat tree like renderKeyTree(tree). */
+        QString renderKeyTree(
+                BtFlatKeyTree const & tree,
+                BtCancellationToken const & cancellation = {}) const;
+
+        /**
+          \brief Renders the tree like renderKeyTree(tree), but writes the
+                 text to the given stream in pieces, rendering only a batch of
+                 entries at a time instead of building the whole text first.
+          \param[in] progress If given, called after every batch with the
+                              number of entries rendered so far. Rendering is
+                              stopped if it returns false.
+          \returns whether the whole tree was rendered.
+        */
+        bool renderKeyTree(
+                KeyTree const & tree,
+                QTextStream & out,
+                std::function<bool(std::size_t)> const & progress = {}) const;
+
+        /**
+          \brief Renders the tree like the streaming renderKeyTree(), but
+                 renders the batches of entries by several worker threads and
+                 writes them in order.
+
+          Every worker thread uses its own BtRenderContext and its own
+          renderer. Batches
+          with modules not available to the worker threads are rendered by
+          the calling thread.
+          \param[in] newRenderer Creates the renderer of a worker thread,
+                                 which should render like this one.
+          \param[in] progress If given, called after every batch with the
+                              number of entries written so far. Rendering is
+                              stopped if it returns false.
+          \returns whether the whole tree was rendered.
+        */
+        bool renderKeyTreeInParallel(
+                KeyTree const & tree,
+                QTextStream & out,
+                std::function<std::unique_ptr<CTextRendering>()> const &
+                        newRenderer,
+                std::function<bool(std::size_t)> const & progress = {}) const;
+
+        /**
+          \returns the tree of the entries of the verses from the lower to the
+                   upper bound, as rendered by renderKeyRange().
+        */
+        static KeyTree keyRangeTree(
+                CSwordVerseKey const & lowerBound,
+                CSwordVerseKey const & upperBound,
+                BtConstModuleList const & modules,
+                QString const & highlightKey = QString(),
+                KeyTreeItem::Settings const & settings =
+                        KeyTreeItem::Settings());
+
+        /** \returns the tree of keyRangeTree() as a flat tree. */
+        static BtFlatKeyTree flatKeyRangeTree(
+                CSwordVerseKey const & lowerBound,
+                CSwordVerseKey const & upperBound,
+                BtConstModuleList const & modules,
+                QString const & highlightKey = QString(),
+                KeyTreeItem::Settings const & settings =
+                        KeyTreeItem::Settings());
 
+        /** \returns the range rendered like renderKeyTree(). */
         QString renderKeyRange(
                 CSwordVerseKey const & lowerBound,
                 CSwordVerseKey const & upperBound,
                 const BtConstModuleList &modules,
                 const QString &hightlightKey = QString(),
-                const KeyTreeItem::Settings &settings = KeyTreeItem::Settings());
+                const KeyTreeItem::Settings &settings = KeyTreeItem::Settings(),
+                BtCancellationToken const & cancellation = {});
 
         QString renderSingleKey(
                 const QString &key,
@@ -156,6 +255,26 @@ class CTextRendering {
     protected: // methods:
 
         static BtConstModuleList collectModules(KeyTree const & tree);
+        void applyFilterOptions(BtConstModuleList const & modules) const;
+
+        /**
+          \returns the entries of the tree rendered without finishText(), or
+                   a null string if the given token was cancelled.
+        */
+        QString renderEntries(
+                KeyTree const & tree,
+                BtCancellationToken const & cancellation = {}) const;
+
+        /** \returns the entries of the flat tree like renderEntries(tree). */
+        QString renderEntries(
+                BtFlatKeyTree const & tree,
+                BtCancellationToken const & cancellation = {}) const;
+
+        /**
+          \returns the finished text of the tree with a placeholder for the
+                   entries, and the position of the placeholder.
+        */
+        std::pair<QString, qsizetype> finishedFrame(KeyTree const & tree) const;
         virtual QString renderEntry(KeyTreeItem const & item,
                                     CSwordKey * key = nullptr) const;
         virtual QString finishText(QString const & text,
@@ -169,6 +288,15 @@ class CTextRendering {
         FilterOptions m_filterOptions;
         bool const m_addText;
 
+        /** Whether to record the render times of the entries of modules. */
+        bool m_recordRenderTimes = false;
+
+        /**
+          The average size of the entries rendered last by renderEntries(),
+          used to allocate the text of the next entries at once.
+        */
+        mutable qsizetype m_entrySizeHint = 0;
+
 }; /* class CTextRendering */
 
 } /* namespace Rendering */
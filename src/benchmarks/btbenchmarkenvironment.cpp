@@ -0,0 +1,87 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btbenchmarkenvironment.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include "../backend/config/btconfig.h"
+#include "../backend/managers/cdisplaytemplatemgr.h"
+#include "../util/directory.h"
+
+
+namespace {
+
+#ifdef Q_OS_WIN
+char const * const HOME_VARIABLE = "APPDATA";
+QString const SWORD_DIR = QStringLiteral("Sword");
+#else
+char const * const HOME_VARIABLE = "HOME";
+QString const SWORD_DIR = QStringLiteral(".sword");
+#endif
+
+} // anonymous namespace
+
+BtBenchmarkEnvironment::BtBenchmarkEnvironment()
+    : m_oldHome(qgetenv(HOME_VARIABLE))
+{}
+
+BtBenchmarkEnvironment::~BtBenchmarkEnvironment() {
+    delete CDisplayTemplateMgr::instance();
+    m_indexingScheduler.reset();
+    m_backend.reset();
+    if (m_configInitialized)
+        BtConfig::destroyInstance();
+    qputenv(HOME_VARIABLE, m_oldHome);
+}
+
+bool BtBenchmarkEnvironment::init() {
+    if (!m_homeDir.isValid()) {
+        qWarning() << "Unable to create a temporary home directory:"
+                   << m_homeDir.errorString();
+        return false;
+    }
+
+    // Measure the modules of the user, unless SWORD_PATH is set:
+    auto swordDir(qEnvironmentVariable("SWORD_PATH"));
+    if (swordDir.isEmpty())
+        swordDir = QDir(QString::fromLocal8Bit(m_oldHome)).filePath(SWORD_DIR);
+    if (!QFile::link(QDir(swordDir).absolutePath(),
+                     m_homeDir.filePath(SWORD_DIR)))
+    {
+        qWarning() << "Unable to link the Sword directory" << swordDir;
+        return false;
+    }
+    qputenv(HOME_VARIABLE, QFile::encodeName(m_homeDir.path()));
+
+    if (!util::directory::initDirectoryCache())
+        return false;
+
+    if (BtConfig::initBtConfig() != BtConfig::INIT_OK) {
+        qWarning() << "Unable to initialize the configuration.";
+        return false;
+    }
+    m_configInitialized = true;
+
+    QString errorMessage;
+    new CDisplayTemplateMgr(errorMessage);
+    if (!errorMessage.isNull()) {
+        qWarning() << errorMessage;
+        return false;
+    }
+
+    m_backend.emplace();
+    m_indexingScheduler.emplace();
+    return true;
+}
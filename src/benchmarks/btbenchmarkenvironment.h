@@ -0,0 +1,58 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <optional>
+#include <QByteArray>
+#include <QTemporaryDir>
+#include "../backend/btindexingscheduler.h"
+#include "../backend/managers/cswordbackend.h"
+
+
+/**
+  \brief Initializes the backend for the benchmarks in a temporary user
+         directory.
+
+  The configuration, caches and indices used by the benchmarks are kept in a
+  temporary home directory, which is removed afterwards. Hence the benchmarks
+  neither change the indices nor depend on the settings of the user, but run
+  with the default settings. The Sword directory of the temporary home links to
+  the one of the user, or to SWORD_PATH if set, so that the installed modules
+  (or those in SWORD_PATH) are measured.
+  \note Like the application, the benchmarks need to be installed to find their
+        data files.
+*/
+class BtBenchmarkEnvironment {
+
+public: // methods:
+
+    BtBenchmarkEnvironment();
+    ~BtBenchmarkEnvironment();
+
+    /**
+      \brief Initializes the directory cache, the configuration, the display
+             templates and the backend.
+      \pre The application object has been created.
+      \returns whether the initialization succeeded.
+    */
+    bool init();
+
+private: // fields:
+
+    QTemporaryDir m_homeDir;
+    QByteArray m_oldHome;
+    bool m_configInitialized = false;
+    std::optional<CSwordBackend> m_backend;
+    std::optional<BtIndexingScheduler> m_indexingScheduler;
+
+};
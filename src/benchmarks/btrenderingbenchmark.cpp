@@ -0,0 +1,150 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include <optional>
+#include <QDebug>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <QTest>
+#include <utility>
+#include "../backend/config/btconfig.h"
+#include "../backend/drivers/btmodulelist.h"
+#include "../backend/drivers/cswordmoduleinfo.h"
+#include "../backend/managers/cswordbackend.h"
+#include "../backend/rendering/cdisplayrendering.h"
+#include "btbenchmarkenvironment.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <swmodule.h>
+#include <versekey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+namespace {
+
+// The benchmark also runs on servers without any display:
+void useOffscreenPlatform() {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+}
+Q_CONSTRUCTOR_FUNCTION(useOffscreenPlatform)
+
+/**
+  \brief Calls the given function at every entry of the given module, including
+         the introductions of Bibles and commentaries.
+*/
+template <typename F>
+void forEachEntry(sword::SWModule & m, F && f) {
+    if (auto * const vk = dynamic_cast<sword::VerseKey *>(m.getKey()))
+        vk->setIntros(true);
+    m.setSkipConsecutiveLinks(true);
+    for (m.setPosition(sword::TOP); !m.popError(); m.increment())
+        f();
+    m.setSkipConsecutiveLinks(false);
+}
+
+CSwordModuleInfo const * findModule(QString const & moduleName)
+{ return CSwordBackend::instance().findModuleByName(moduleName); }
+
+} // anonymous namespace
+
+/**
+  \brief Measures the throughput of rendering whole modules.
+
+  Every entry of each installed module is rendered through the render filters
+  of the module (e.g. Filters::OsisToHtml), and through CDisplayRendering like
+  the display windows do. The modules are rows of the benchmarks tagged by
+  their names, e.g. "renderFilters:KJV" only measures the filters of KJV.
+*/
+class BtRenderingBenchmark: public QObject {
+
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void initTestCase() {
+        m_environment.emplace();
+        QVERIFY(m_environment->init());
+        CSwordBackend::instance().setFilterOptions(
+                    btConfig().getFilterOptions());
+    }
+
+    void cleanupTestCase() { m_environment.reset(); }
+
+    void renderFilters_data() { addModuleRows(); }
+
+    void renderFilters() {
+        QFETCH(QString, moduleName);
+        auto const * const module = findModule(moduleName);
+        QVERIFY(module);
+        auto & m = module->swordModule();
+        QBENCHMARK {
+            forEachEntry(m, [&m]{ m.renderText(); });
+        }
+    }
+
+    void renderDisplay_data() { addModuleRows(); }
+
+    void renderDisplay() {
+        QFETCH(QString, moduleName);
+        auto const * const module = findModule(moduleName);
+        QVERIFY(module);
+        auto & m = module->swordModule();
+        QStringList keys;
+        forEachEntry(m,
+                     [&m, &keys] {
+                         auto key(QString::fromUtf8(m.getKeyText()));
+                         if (!key.isEmpty())
+                             keys.append(std::move(key));
+                     });
+        qInfo() << moduleName << "has" << keys.size() << "entries.";
+
+        BtConstModuleList const modules{module};
+        Rendering::CDisplayRendering const rendering;
+        QBENCHMARK {
+            for (auto const & key : keys)
+                rendering.renderDisplayEntry(modules, key);
+        }
+        qInfo() << "Filter option updates skipped:"
+                << CSwordBackend::instance().skippedFilterOptionUpdates();
+    }
+
+private: // methods:
+
+    void addModuleRows() {
+        QTest::addColumn<QString>("moduleName");
+        for (auto const * const module : CSwordBackend::instance().moduleList())
+            QTest::newRow(module->name().toUtf8().constData())
+                    << module->name();
+    }
+
+private: // fields:
+
+    std::optional<BtBenchmarkEnvironment> m_environment;
+
+};
+
+QTEST_MAIN(BtRenderingBenchmark)
+#include "btrenderingbenchmark.moc"
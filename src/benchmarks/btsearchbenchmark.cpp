@@ -0,0 +1,203 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <ostream>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "../backend/config/btconfig.h"
+#include "../backend/cswordmodulesearch.h"
+#include "../backend/drivers/btmodulelist.h"
+#include "../backend/drivers/cswordmoduleinfo.h"
+#include "../backend/managers/cswordbackend.h"
+#include "btbenchmarkenvironment.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wsuggest-destructor-override"
+#endif
+#include <listkey.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+#pragma GCC diagnostic pop
+
+
+//Number of times every query is searched
+constexpr static int const BT_SEARCH_BENCHMARK_RUNS = 5;
+
+namespace {
+
+char const * const queryCorpus[] = {
+    "God",
+    "love",
+    "light darkness",
+    "\"in the beginning\"",
+    "\"the kingdom of heaven\"",
+    "lov*",
+    "stren?th",
+    "strong:H430",
+    "strong:G26",
+    "morph:N-NSM",
+};
+
+// Evaluated for Bibles and commentaries only:
+char const * const scopeCorpus[] = {
+    "Genesis - Deuteronomy",
+    "Matthew - John",
+};
+
+QJsonObject measureQuery(CSwordModuleInfo const & module,
+                         QString const & query,
+                         sword::ListKey const & scope)
+{
+    std::vector<double> latencies;
+    std::size_t hits = 0u;
+    QElapsedTimer timer;
+    for (int i = 0; i < BT_SEARCH_BENCHMARK_RUNS; ++i) {
+        timer.start();
+        auto const results = CSwordModuleSearch::search(query,
+                                                        {&module},
+                                                        scope);
+        latencies.push_back(static_cast<double>(timer.nsecsElapsed()) / 1e6);
+        hits = results.front().results.totalSize();
+    }
+    auto const firstMs = latencies.front();
+    std::sort(latencies.begin(), latencies.end());
+    return QJsonObject{
+        {QStringLiteral("query"), query},
+        {QStringLiteral("hits"), static_cast<qint64>(hits)},
+        {QStringLiteral("firstMs"), firstMs},
+        {QStringLiteral("minMs"), latencies.front()},
+        {QStringLiteral("medianMs"), latencies[latencies.size() / 2u]}};
+}
+
+/**
+  \brief Measures building and searching the indices of the given modules.
+
+  The index of every module is built, before a fixed corpus of queries (words,
+  phrases, wildcards, Strong's numbers and morphological codes, in Bibles and
+  commentaries also within a scope) is searched in it like the search dialog
+  does. The build time, the size of the index and the latencies of the queries
+  are written to the given stream as a JSON document.
+  \returns whether all modules were found and indexed.
+*/
+bool benchmarkSearch(QStringList const & moduleNames, std::ostream & out) {
+    auto & backend = CSwordBackend::instance();
+    bool r = true;
+    QJsonArray modules;
+    for (auto const & moduleName : moduleNames) {
+        QJsonObject result{{QStringLiteral("module"), moduleName}};
+        auto * const module = backend.findModuleByName(moduleName);
+        if (!module) {
+            result.insert(QStringLiteral("error"),
+                          QStringLiteral("Module not found"));
+            modules.append(result);
+            r = false;
+            continue;
+        }
+
+        // Build the index in the temporary index directory:
+        QElapsedTimer timer;
+        timer.start();
+        try {
+            module->buildIndex();
+        } catch (std::exception const & e) {
+            result.insert(QStringLiteral("error"), QString::fromUtf8(e.what()));
+        } catch (...) {
+            result.insert(QStringLiteral("error"),
+                          QStringLiteral("Unknown exception"));
+        }
+        if (result.contains(QStringLiteral("error"))) {
+            modules.append(result);
+            r = false;
+            continue;
+        }
+        result.insert(QStringLiteral("buildIndexMs"),
+                      static_cast<double>(timer.nsecsElapsed()) / 1e6);
+        result.insert(QStringLiteral("indexSize"), module->indexSize());
+
+        QJsonArray queries;
+        try {
+            sword::ListKey const noScope;
+            for (auto const * const query : queryCorpus)
+                queries.append(measureQuery(*module,
+                                            QString::fromUtf8(query),
+                                            noScope));
+            if (module->type() == CSwordModuleInfo::Bible
+                || module->type() == CSwordModuleInfo::Commentary)
+            {
+                for (auto const * const scopeText : scopeCorpus) {
+                    auto const scope(
+                            BtConfig::parseVerseListWithModules(
+                                QString::fromUtf8(scopeText),
+                                QStringList{moduleName}));
+                    for (auto const * const query : queryCorpus) {
+                        auto queryResult(
+                                measureQuery(*module,
+                                             QString::fromUtf8(query),
+                                             scope));
+                        queryResult.insert(QStringLiteral("scope"),
+                                           QString::fromUtf8(scopeText));
+                        queries.append(queryResult);
+                    }
+                }
+            }
+        } catch (...) {
+            result.insert(QStringLiteral("error"),
+                          QStringLiteral("Search failed"));
+            r = false;
+        }
+        result.insert(QStringLiteral("queries"), queries);
+        modules.append(result);
+    }
+    out << QJsonDocument(QJsonObject{{QStringLiteral("modules"), modules}})
+               .toJson().constData();
+    return r;
+}
+
+} // anonymous namespace
+
+int main(int argc, char * argv[]) {
+    // The benchmark also runs on servers without any display:
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    auto const moduleNames(QApplication::arguments().mid(1));
+    if (moduleNames.isEmpty()) {
+        std::cerr << "Usage: " << argv[0] << " <module>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BtBenchmarkEnvironment environment;
+    if (!environment.init())
+        return EXIT_FAILURE;
+    return benchmarkSearch(moduleNames, std::cout)
+           ? EXIT_SUCCESS
+           : EXIT_FAILURE;
+}
@@ -34,11 +34,13 @@
 #include "../backend/keys/cswordversekey.h"
 #include "../backend/managers/cswordbackend.h"
 #include "../util/btassert.h"
+#include "../util/btstartupprofile.h"
 #include "../util/cresmgr.h"
 #include "../util/directory.h"
 #include "bibletimeapp.h"
 #include "btaboutmoduledialog.h"
 #include "btbookshelfdockwidget.h"
+#include "btcorpusstatisticsdialog.h"
 #include "btmessageinputdialog.h"
 #include "cmdiarea.h"
 #include "display/btfindwidget.h"
@@ -105,7 +107,10 @@ BibleTime::BibleTime(BibleTimeApp & app, QWidget *parent, Qt::WindowFlags flags)
             qWarning("Can't load startuplogo! Check your installation.");
         }
     }
-    app.initBackends();
+    {
+        BtStartupProfile::Phase const phase("BibleTimeApp::initBackends");
+        app.initBackends();
+    }
 
     if (splash) {
         splash->showMessage(
@@ -114,7 +119,10 @@ BibleTime::BibleTime(BibleTimeApp & app, QWidget *parent, Qt::WindowFlags flags)
                     splashTextAlignment);
         qApp->processEvents();
     }
-    initView();
+    {
+        BtStartupProfile::Phase const phase("BibleTime::initView");
+        initView();
+    }
 
     if (splash) {
         splash->showMessage(
@@ -124,10 +132,13 @@ BibleTime::BibleTime(BibleTimeApp & app, QWidget *parent, Qt::WindowFlags flags)
         splash->setAttribute(Qt::WA_DeleteOnClose);
         splash->finish(this);
     }
-    initActions();
-    initMenubar();
-    initToolbars();
-    initConnections();
+    {
+        BtStartupProfile::Phase const phase("BibleTime::initActions");
+        initActions();
+        initMenubar();
+        initToolbars();
+        initConnections();
+    }
 
     setWindowTitle(QStringLiteral("BibleTime " BT_VERSION));
     setWindowIcon(CResMgr::mainWindow::icon());
@@ -139,6 +150,7 @@ BibleTime::~BibleTime() {
     // The backend is deleted by the BibleTimeApp instance
 
     delete m_debugWindow;
+    delete m_profilerWindow;
     m_bookshelfDock->saveBookshelfState();
     saveProfile();
 }
@@ -170,6 +182,14 @@ CDisplayWindow* BibleTime::createReadDisplayWindow(
             std::terminate();
     }
     m_mdi->addDisplayWindow(displayWindow);
+
+    // When restoring a session, the windows are rendered after all are shown:
+    if (m_restoringProfile) {
+        displayWindow->deferLookup();
+        displayWindow->show();
+        qApp->restoreOverrideCursor();
+        return displayWindow;
+    }
     displayWindow->show();
 
     /* We have to process pending events here, otherwise displayWindow is not
@@ -239,12 +259,19 @@ void BibleTime::moduleAbout(CSwordModuleInfo *module) {
     dialog->raise();
 }
 
+void BibleTime::moduleStatistics(CSwordModuleInfo * module) {
+    auto * const dialog = new BtCorpusStatisticsDialog(module, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose); // Destroy dialog when closed
+    dialog->show();
+    dialog->raise();
+}
+
 /** Refreshes all presenters.*/
 void BibleTime::refreshDisplayWindows() const {
     for (auto const * const subWindow : m_mdi->subWindowList())
         if (CDisplayWindow * const window =
                 dynamic_cast<CDisplayWindow*>(subWindow->widget()))
-            window->reload();
+            window->reloadWhenDisplayed();
 }
 
 void BibleTime::processCommandline(bool const ignoreSession,
@@ -254,8 +281,10 @@ void BibleTime::processCommandline(bool const ignoreSession,
         return;
 
     // Restore workspace if not not ignoring session data:
-    if (!ignoreSession)
+    if (!ignoreSession) {
+        BtStartupProfile::Phase const phase("BibleTime::reloadProfile");
         reloadProfile();
+    }
 
     if (btConfig().value<bool>(QStringLiteral("state/crashedLastTime"), false))
         return;
@@ -337,11 +366,13 @@ void BibleTime::openSearchDialog(BtConstModuleList modules,
 void BibleTime::openFindWidget() { m_findWidget->showAndSelect(); }
 
 #ifdef BUILD_TEXT_TO_SPEECH
-void BibleTime::speakText(QString const & text) {
-    if (!m_textToSpeech)
-        m_textToSpeech = createTextToSpeechInstance();
+void BibleTime::speakText(QString const & text,
+                          BtSpeechSession::Continuation continuation)
+{
+    if (!m_speechSession)
+        m_speechSession = std::make_unique<BtSpeechSession>();
 
-    m_textToSpeech->say(text);
+    m_speechSession->speak(text, std::move(continuation));
 }
 
 std::unique_ptr<QTextToSpeech> BibleTime::createTextToSpeechInstance() {
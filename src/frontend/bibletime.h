@@ -14,6 +14,7 @@
 
 #include <QMainWindow>
 
+#include <iosfwd>
 #include <QList>
 #include <QPointer>
 #ifdef BUILD_TEXT_TO_SPEECH
@@ -22,6 +23,9 @@
 #include <QTimer>
 #include "../backend/drivers/btmodulelist.h"
 #include "../backend/drivers/cswordmoduleinfo.h"
+#ifdef BUILD_TEXT_TO_SPEECH
+#include "btspeechsession.h"
+#endif
 #include "displaywindow/btactioncollection.h"
 
 
@@ -277,8 +281,10 @@ public:
     /**
       Speaks the given text.
       \param[in] text The text to speak.
+      \param[in] continuation The texts to speak after it, if any.
      */
-    void speakText(QString const & text);
+    void speakText(QString const & text,
+                   BtSpeechSession::Continuation continuation = {});
 
     /**
       Creates a QTextToSpeech instance, taking text-to-speech
@@ -313,6 +319,26 @@ public Q_SLOTS:
     */
     void processCommandline(bool ignoreSession, QString const & bibleKey);
 
+    /**
+      \brief Measures the smoothness of scrolling display windows.
+
+      For every given template, key and layout a maximized window with the
+      modules of the layout in parallel is opened at the key and scrolled at a
+      constant velocity for a few seconds. The p50, p95 and p99 frame times
+      and render times, and the calls of BtModuleTextModel::data() per frame
+      are written to the given stream.
+      \param[in] layouts The names of the modules of every window.
+      \param[in] keys The keys to scroll from, or an empty key for the default.
+      \param[in] templates The names of the display templates, or an empty name
+                           for the active template.
+      \param[in] out The stream to write the results to.
+      \returns whether all modules and templates were found.
+    */
+    bool benchmarkScrolling(QList<QStringList> const & layouts,
+                            QStringList const & keys,
+                            QStringList const & templates,
+                            std::ostream & out);
+
     void autoScrollStop();
 
 Q_SIGNALS:
@@ -367,6 +393,10 @@ private: // methods:
     void showOrHideToolBars();
 
     void slotShowDebugWindow(bool);
+    void slotShowProfilerWindow(bool);
+
+    /** Logs the memory used by the caches of the modules and windows. */
+    void slotLogMemoryUsage();
 
 private Q_SLOTS:
 
@@ -380,6 +410,7 @@ private Q_SLOTS:
                                              QString const & key = {});
     void slotModuleUnlock(CSwordModuleInfo * module);
     void moduleAbout(CSwordModuleInfo * module);
+    void moduleStatistics(CSwordModuleInfo * module);
 
     /** Automatically scrolls the display. */
     void slotAutoScroll();
@@ -437,6 +468,13 @@ private Q_SLOTS:
     void autoScrollPause();
     bool autoScrollAnyKey();
 
+    /**
+      Starts or stops scrolling the current display at m_autoScrollSpeed. The
+      display is scrolled by m_autoScrollTimer, or by its frame clock if
+      "settings/behaviour/frameSyncedAutoScroll" is enabled.
+    */
+    void setAutoScrollRunning(bool running);
+
     /** Called when search button is pressed. */
     void slotSearchModules();
 
@@ -489,14 +527,20 @@ private: // fields:
     BtFindWidget * m_findWidget;
 
     int m_autoScrollSpeed = 0;
+    bool m_autoScrollRunning = false;
+    bool m_restoringProfile = false;
     QTimer m_autoScrollTimer;
+    QPointer<BtModelViewReadDisplay> m_autoScrollDisplay;
     QPointer<Search::CSearchDialog> m_searchDialog;
 
     QAction * m_debugWidgetAction = nullptr;
     QPointer<QWidget> m_debugWindow;
+    QAction * m_profilerAction = nullptr;
+    QPointer<QWidget> m_profilerWindow;
+    QAction * m_memoryUsageAction = nullptr;
 
     #ifdef BUILD_TEXT_TO_SPEECH
-    std::unique_ptr<QTextToSpeech> m_textToSpeech;
+    std::unique_ptr<BtSpeechSession> m_speechSession;
     #endif
 
 };
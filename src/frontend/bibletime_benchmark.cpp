@@ -0,0 +1,197 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "bibletime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QEventLoop>
+#include <QMdiSubWindow>
+#include <QQuickWindow>
+#include <QTimer>
+#include <utility>
+#include <vector>
+#include "../backend/config/btconfig.h"
+#include "../backend/managers/cdisplaytemplatemgr.h"
+#include "../backend/managers/cswordbackend.h"
+#include "../backend/models/btmoduletextmodel.h"
+#include "cmdiarea.h"
+#include "display/btmodelviewreaddisplay.h"
+#include "display/modelview/btquickwidget.h"
+#include "displaywindow/cdisplaywindow.h"
+
+
+//Time for loading and rendering the rows visible before scrolling
+constexpr static int const BT_SCROLL_BENCHMARK_SETTLE_MS = 1000;
+
+//Time for scrolling every window
+constexpr static int const BT_SCROLL_BENCHMARK_DURATION_MS = 10000;
+
+//Velocity of scrolling in pixels per second
+constexpr static double const BT_SCROLL_BENCHMARK_VELOCITY = 1200.0;
+
+namespace {
+
+void waitFor(int const milliseconds) {
+    QEventLoop loop;
+    QTimer::singleShot(milliseconds, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+double percentile(std::vector<std::int64_t> & values, std::size_t const p) {
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    auto const i = std::min(values.size() * p / 100u, values.size() - 1u);
+    return static_cast<double>(values[i]) / 1e6;
+}
+
+void printPercentiles(std::ostream & out,
+                      char const * const name,
+                      std::vector<std::int64_t> values)
+{
+    out << ", " << name << " p50 " << percentile(values, 50u)
+        << " ms, p95 " << percentile(values, 95u)
+        << " ms, p99 " << percentile(values, 99u) << " ms";
+}
+
+} // anonymous namespace
+
+bool BibleTime::benchmarkScrolling(QList<QStringList> const & layouts,
+                                   QStringList const & keys,
+                                   QStringList const & templates,
+                                   std::ostream & out)
+{
+    static auto const templateKey = QStringLiteral("GUI/activeTemplateName");
+    auto const oldTemplate =
+            btConfig().value<QString>(templateKey, QString());
+    auto const & availableTemplates =
+            CDisplayTemplateMgr::instance()->availableTemplates();
+
+    bool r = true;
+    for (auto const & templateName : templates) {
+        if (!templateName.isEmpty()
+            && !availableTemplates.contains(templateName))
+        {
+            out << "Template not found: " << qPrintable(templateName)
+                << std::endl;
+            r = false;
+            continue;
+        }
+        btConfig().setValue(templateKey,
+                            templateName.isEmpty()
+                            ? oldTemplate
+                            : templateName);
+        auto const usedTemplate = CDisplayTemplateMgr::activeTemplateName();
+
+        for (auto const & moduleNames : layouts) {
+            QList<CSwordModuleInfo *> modules;
+            for (auto const & moduleName : moduleNames) {
+                if (auto * const module =
+                        CSwordBackend::instance().findModuleByName(moduleName))
+                {
+                    modules.append(module);
+                } else {
+                    out << "Module not found: " << qPrintable(moduleName)
+                        << std::endl;
+                    r = false;
+                }
+            }
+            if (modules.isEmpty())
+                continue;
+
+            for (auto const & key : keys) {
+                auto * const window = createReadDisplayWindow(modules, key);
+                if (auto * const subWindow =
+                        qobject_cast<QMdiSubWindow *>(window->parentWidget()))
+                    subWindow->showMaximized();
+                auto * const quickWidget =
+                        window->displayWidget()->quickWidget();
+                waitFor(BT_SCROLL_BENCHMARK_SETTLE_MS);
+
+                /* The frames of a QQuickWidget are synchronized and rendered
+                   by the GUI thread: */
+                std::vector<std::int64_t> frameTimes;
+                std::vector<std::int64_t> renderTimes;
+                std::vector<std::int64_t> dataCalls;
+                QElapsedTimer clock;
+                clock.start();
+                std::int64_t frameStart = -1;
+                std::int64_t syncStart = 0;
+                auto lastDataCalls = BtModuleTextModel::dataCalls();
+                auto * const quickWindow = quickWidget->quickWindow();
+                auto const syncConnection =
+                        QObject::connect(
+                            quickWindow,
+                            &QQuickWindow::beforeSynchronizing,
+                            quickWindow,
+                            [&] { syncStart = clock.nsecsElapsed(); },
+                            Qt::DirectConnection);
+                auto const renderConnection =
+                        QObject::connect(
+                            quickWindow,
+                            &QQuickWindow::afterRendering,
+                            quickWindow,
+                            [&] {
+                                auto const now = clock.nsecsElapsed();
+                                auto const calls =
+                                        BtModuleTextModel::dataCalls();
+                                if (frameStart >= 0) {
+                                    frameTimes.push_back(now - frameStart);
+                                    renderTimes.push_back(now - syncStart);
+                                    dataCalls.push_back(
+                                            static_cast<std::int64_t>(
+                                                calls - lastDataCalls));
+                                }
+                                frameStart = now;
+                                lastDataCalls = calls;
+                            },
+                            Qt::DirectConnection);
+                quickWidget->setAutoScrollVelocity(
+                            BT_SCROLL_BENCHMARK_VELOCITY);
+                waitFor(BT_SCROLL_BENCHMARK_DURATION_MS);
+                quickWidget->setAutoScrollVelocity(0.0);
+                QObject::disconnect(syncConnection);
+                QObject::disconnect(renderConnection);
+
+                std::int64_t totalCalls = 0;
+                std::int64_t maxCalls = 0;
+                for (auto const calls : dataCalls) {
+                    totalCalls += calls;
+                    maxCalls = std::max(maxCalls, calls);
+                }
+                out << qPrintable(moduleNames.join(u',')) << " at \""
+                    << qPrintable(key) << "\" with "
+                    << qPrintable(usedTemplate) << ": "
+                    << frameTimes.size() << " frames";
+                printPercentiles(out, "frame", std::move(frameTimes));
+                printPercentiles(out, "render", std::move(renderTimes));
+                out << ", data calls per frame "
+                    << (dataCalls.empty()
+                        ? 0.0
+                        : static_cast<double>(totalCalls)
+                          / static_cast<double>(dataCalls.size()))
+                    << " avg, " << maxCalls << " max" << std::endl;
+
+                m_mdi->closeAllSubWindows();
+                QCoreApplication::sendPostedEvents(nullptr,
+                                                   QEvent::DeferredDelete);
+            }
+        }
+    }
+    btConfig().setValue(templateKey, oldTemplate);
+    return r;
+}
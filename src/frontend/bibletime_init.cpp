@@ -26,6 +26,7 @@
 #include "../backend/config/btconfig.h"
 #include "../util/btassert.h"
 #include "../util/btconnect.h"
+#include "../util/bttrace.h"
 #include "../util/cresmgr.h"
 #include "bibletimeapp.h"
 #include "btbookshelfdockwidget.h"
@@ -544,6 +545,7 @@ void BibleTime::createCentralWidget()
 
 /** Initializes the action objects of the GUI */
 void BibleTime::initActions() {
+    BT_TRACE_SPAN("init main window actions");
     m_actions = new ActionCollection(m_bookshelfDock->toggleViewAction(),
                                      m_bookmarksDock->toggleViewAction(),
                                      m_magDock->toggleViewAction(),
@@ -705,10 +707,18 @@ void BibleTime::initActions() {
         m_debugWidgetAction->setCheckable(true);
         BT_CONNECT(m_debugWidgetAction, &QAction::triggered,
                    this,                &BibleTime::slotShowDebugWindow);
+        m_profilerAction = new QAction(this);
+        m_profilerAction->setCheckable(true);
+        BT_CONNECT(m_profilerAction, &QAction::triggered,
+                   this,             &BibleTime::slotShowProfilerWindow);
+        m_memoryUsageAction = new QAction(this);
+        BT_CONNECT(m_memoryUsageAction, &QAction::triggered,
+                   this,                &BibleTime::slotLogMemoryUsage);
     }
 }
 
 void BibleTime::initMenubar() {
+    BT_TRACE_SPAN("init main window menus");
     // File menu:
     m_fileMenu = new QMenu(this);
     m_fileMenu->addAction(m_actions->file.openWork);
@@ -810,6 +820,8 @@ void BibleTime::initMenubar() {
     if (m_debugWidgetAction) {
         m_helpMenu->addSeparator();
         m_helpMenu->addAction(m_debugWidgetAction);
+        m_helpMenu->addAction(m_profilerAction);
+        m_helpMenu->addAction(m_memoryUsageAction);
     }
     menuBar()->addMenu(m_helpMenu);
 }
@@ -854,6 +866,10 @@ void BibleTime::retranslateUi() {
 
     if (m_debugWidgetAction)
         m_debugWidgetAction->setText(tr("Show \"What's this widget\" dialog"));
+    if (m_profilerAction)
+        m_profilerAction->setText(tr("Show profiler"));
+    if (m_memoryUsageAction)
+        m_memoryUsageAction->setText(tr("Log memory usage"));
 
     m_actions->retranslateUi();
 }
@@ -877,6 +893,9 @@ void BibleTime::initConnections() {
                this,            &BibleTime::slotModuleUnlock);
     BT_CONNECT(m_bookshelfDock, &BtBookshelfDockWidget::moduleAboutTriggered,
                this,            &BibleTime::moduleAbout);
+    BT_CONNECT(m_bookshelfDock,
+               &BtBookshelfDockWidget::moduleStatisticsTriggered,
+               this, &BibleTime::moduleStatistics);
     BT_CONNECT(m_bookshelfDock, &BtBookshelfDockWidget::installWorksClicked,
                this,            &BibleTime::slotBookshelfWizard);
 }
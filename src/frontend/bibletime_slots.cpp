@@ -15,18 +15,24 @@
 #include <QAction>
 #include <QClipboard>
 #include <QCursor>
+#include <QDebug>
 #include <QDesktopServices>
+#include <QFile>
 #include <QInputDialog>
 #include <QMdiSubWindow>
 #include <QMenu>
 #include <QMetaObject>
 #include <QProcess>
+#include <QQuickItem>
 #include <QtGlobal>
 #include <QTimerEvent>
 #include <QToolBar>
 #include <QUrl>
 #include "../backend/config/btconfig.h"
+#include "../backend/drivers/cswordlexiconmoduleinfo.h"
 #include "../backend/managers/cswordbackend.h"
+#include "../backend/models/btchapterrendercache.h"
+#include "../backend/models/btmoduletextmodel.h"
 #include "../util/btassert.h"
 #include "../util/btconnect.h"
 #include "../util/directory.h"
@@ -37,9 +43,13 @@
 #include "debugwindow.h"
 #include "display/btfindwidget.h"
 #include "display/btmodelviewreaddisplay.h"
+#include "display/modelview/btqmlinterface.h"
+#include "display/modelview/btquickwidget.h"
 #include "displaywindow/btmodulechooserbar.h"
 #include "displaywindow/cdisplaywindow.h"
 #include "messagedialog.h"
+#include "profilerwindow.h"
+#include "searchdialog/csearchdialog.h"
 #include "settingsdialogs/cconfigurationdialog.h"
 #include "tips/bttipdialog.h"
 
@@ -67,7 +77,7 @@ void BibleTime::slotSettingsOptions() {
                    #ifdef BUILD_TEXT_TO_SPEECH
                    // reset current text-to-speech instance, will be recreated
                    // based on current config when needed
-                   m_textToSpeech.reset();
+                   m_speechSession.reset();
                    #endif
                });
 
@@ -505,6 +515,8 @@ void BibleTime::reloadProfile() {
         QList<CSwordModuleInfo *> okModules;
     };
     QMap<QString, WindowLoadStatus> failedWindows;
+    QList<CDisplayWindow *> restoredWindows;
+    m_restoringProfile = true;
     for (auto const & w
          : sessionConf.value<QStringList>(QStringLiteral("windowsList")))
     {
@@ -540,12 +552,14 @@ void BibleTime::reloadProfile() {
         auto const key = windowConf.value<QString>(QStringLiteral("key"));
         if (auto * const window = createReadDisplayWindow(wls.okModules, key)) {
             window->applyProfileSettings(windowConf);
+            restoredWindows.append(window);
             if (windowConf.value<bool>(QStringLiteral("hasFocus"), false))
                 focusWindow = window;
         } else {
             failedWindows.insert(w, wls);
         }
     }
+    m_restoringProfile = false;
 
     /* This call is necessary to restore the visibility of the toolbars in the child
      * windows, since their state is not saved automatically.
@@ -559,6 +573,11 @@ void BibleTime::reloadProfile() {
     if (focusWindow)
         focusWindow->setFocus();
 
+    /* Render the restored windows which are displayed, the others are rendered
+       when they are shown or activated: */
+    for (auto * const window : restoredWindows)
+        window->resumeLookup();
+
     // Re-enable updates and repaint:
     setUpdatesEnabled(true);
     repaint(); /// \bug The main window (except decors) is all black without this (not even hover over toolbar buttons work)
@@ -583,33 +602,36 @@ void BibleTime::toggleFullscreen() {
     m_mdi->triggerWindowUpdate();
 }
 
+namespace {
+
+/** The intervals of the steps of auto scrolling by speed, in milliseconds. */
+constexpr int const autoScrollIntervals[21] = {
+    1, 2, 3, 5, 9, 15, 25, 43, 72, 120, 200,
+    120, 72, 43, 25, 15, 9, 5, 3, 2, 1
+};
+
+} // anonymous namespace
+
 template <bool goingUp>
 void BibleTime::autoScroll() {
     setDisplayFocus();
 
-    static constexpr int const intervals[21] = {
-        1, 2, 3, 5, 9, 15, 25, 43, 72, 120, 200,
-        120, 72, 43, 25, 15, 9, 5, 3, 2, 1
-    };
-
     static constexpr int const nudgeSpeed = goingUp ? 1 : -1;
     if (m_autoScrollSpeed == 0
         || ((m_autoScrollSpeed > 0) != goingUp // going in the opposite when
-            && !m_autoScrollTimer.isActive())) // resuming from pause
+            && !m_autoScrollRunning)) // resuming from pause
     {
         m_autoScrollSpeed = nudgeSpeed; // start safe at slow speed
-        m_autoScrollTimer.setInterval(intervals[m_autoScrollSpeed + 10]);
     } else if (m_autoScrollSpeed != nudgeSpeed * 10) { // Stay in [-10, 10]
         m_autoScrollSpeed += nudgeSpeed;
         if (m_autoScrollSpeed == 0) {
-            m_autoScrollTimer.stop();
+            setAutoScrollRunning(false);
             m_actions->view.scroll.pauseAutoScroll->setEnabled(false);
             return;
         }
-        m_autoScrollTimer.setInterval(intervals[m_autoScrollSpeed + 10]);
     }
 
-    m_autoScrollTimer.start();
+    setAutoScrollRunning(true);
     m_actions->view.scroll.pauseAutoScroll->setEnabled(true);
 }
 
@@ -620,11 +642,7 @@ void BibleTime::autoScrollPause() {
     if (!m_autoScrollSpeed)
         return;
     setDisplayFocus();
-    if (m_autoScrollTimer.isActive()) {
-        m_autoScrollTimer.stop();
-    } else {
-        m_autoScrollTimer.start();
-    }
+    setAutoScrollRunning(!m_autoScrollRunning);
 }
 
 bool BibleTime::autoScrollAnyKey() {
@@ -635,11 +653,42 @@ bool BibleTime::autoScrollAnyKey() {
 }
 
 void BibleTime::autoScrollStop() {
-    m_autoScrollTimer.stop();
+    setAutoScrollRunning(false);
     m_autoScrollSpeed = 0;
     m_actions->view.scroll.pauseAutoScroll->setEnabled(false);
 }
 
+void BibleTime::setAutoScrollRunning(bool const running) {
+    m_autoScrollRunning = running;
+    auto const interval = autoScrollIntervals[m_autoScrollSpeed + 10];
+
+    // Stop any display scrolled by its frame clock:
+    if (m_autoScrollDisplay) {
+        m_autoScrollDisplay->setAutoScrollVelocity(0.0);
+        m_autoScrollDisplay.clear();
+    }
+
+    if (!running) {
+        m_autoScrollTimer.stop();
+    } else if (btConfig().value<bool>(
+                   QStringLiteral("settings/behaviour/frameSyncedAutoScroll"),
+                   false))
+    {
+        m_autoScrollTimer.stop();
+        if (auto * const display = getCurrentDisplay()) {
+            // The timer scrolled by a pixel per interval:
+            auto const pixelsPerSecond = 1000.0 / interval;
+            display->setAutoScrollVelocity((m_autoScrollSpeed > 0)
+                                           ? -pixelsPerSecond
+                                           : pixelsPerSecond);
+            m_autoScrollDisplay = display;
+        }
+    } else {
+        m_autoScrollTimer.setInterval(interval);
+        m_autoScrollTimer.start();
+    }
+}
+
 void BibleTime::slotAutoScroll() {
     auto * display = getCurrentDisplay();
     if (display) {
@@ -730,3 +779,73 @@ void BibleTime::slotShowDebugWindow(bool show) {
         delete m_debugWindow;
     }
 }
+
+void BibleTime::slotShowProfilerWindow(bool show) {
+    if (show) {
+        BT_ASSERT(!m_profilerWindow);
+        m_profilerWindow = new ProfilerWindow();
+        BT_CONNECT(m_profilerWindow, &QObject::destroyed, m_profilerAction,
+                   [action=m_profilerAction] { action->setChecked(false); },
+                   Qt::DirectConnection);
+    } else {
+        delete m_profilerWindow;
+    }
+}
+
+void BibleTime::slotLogMemoryUsage() {
+    auto const kib =
+            [](std::size_t const bytes)
+            { return QString::number(static_cast<double>(bytes) / 1024.0,
+                                     'f',
+                                     1); };
+    qDebug().noquote() << "Memory usage in KiB:";
+
+    #ifdef Q_OS_LINUX
+    {
+        QFile status(QStringLiteral("/proc/self/status"));
+        if (status.open(QIODevice::ReadOnly))
+            for (auto const & line : status.readAll().split('\n'))
+                if (line.startsWith("VmRSS:") || line.startsWith("VmHWM:"))
+                    qDebug().noquote() << "  Process" << line.simplified();
+    }
+    #endif
+
+    // The lexicon entries are kept until the modules are reloaded:
+    for (auto const * const module : CSwordBackend::instance().moduleList()) {
+        auto const * const lexicon =
+                dynamic_cast<CSwordLexiconModuleInfo const *>(module);
+        if (!lexicon)
+            continue;
+        if (auto const * const entries = lexicon->loadedEntries())
+            qDebug().noquote()
+                    << "  Module" << module->name()
+                    << "lexicon entries:" << kib(entries->heapBytes())
+                    << "read," << kib(entries->mappedBytes()) << "mapped";
+    }
+
+    if (m_searchDialog) {
+        std::size_t bytes = 0u;
+        for (auto const & result : m_searchDialog->results())
+            bytes += result.results.memoryUsage();
+        qDebug().noquote() << "  Search results:" << kib(bytes);
+    }
+
+    qDebug().noquote() << "  Shared chapter render cache:"
+                       << kib(BtChapterRenderCache::memoryUsage());
+
+    for (auto * const subWindow : m_mdi->subWindowList()) {
+        auto const * const window =
+                qobject_cast<CDisplayWindow *>(subWindow->widget());
+        if (!window)
+            continue;
+        auto const * const display = window->displayWidget();
+        auto const * const model = display->qmlInterface()->textModel();
+        auto const * const rootItem = display->quickWidget()->rootObject();
+        qDebug().noquote()
+                << "  Window" << subWindow->windowTitle()
+                << "render caches:"
+                << kib(model ? model->renderCacheMemoryUsage() : 0u)
+                << "QML objects:"
+                << (rootItem ? rootItem->findChildren<QObject *>().size() : 0);
+    }
+}
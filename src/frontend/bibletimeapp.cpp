@@ -37,6 +37,7 @@
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
+#include "../backend/btentrywritejournal.h"
 #include "../backend/config/btconfig.h"
 #include "../backend/managers/cdisplaytemplatemgr.h"
 #include "../util/btassert.h"
@@ -160,6 +161,9 @@ BibleTimeApp::~BibleTimeApp() {
     btConfig().setValue(QStringLiteral("state/crashedTwoTimes"), false);
 
     delete CDisplayTemplateMgr::instance();
+    if (m_indexingScheduler)
+        BtEntryWriteJournal::instance().commit();
+    m_indexingScheduler.reset();
     m_backend.reset();
     delete m_icons;
 
@@ -308,4 +312,6 @@ void BibleTimeApp::initBackends() {
     CDisplaySettingsPage::resetLanguage(); /// \todo refactor this hack
 
     m_backend.emplace();
+    m_indexingScheduler.emplace();
+    BtEntryWriteJournal::instance().recover();
 }
@@ -14,6 +14,7 @@
 
 #include <QApplication>
 
+#include "../backend/btindexingscheduler.h"
 #include "../backend/managers/cswordbackend.h"
 #include <optional>
 #include <QObject>
@@ -53,6 +54,7 @@ private: // fields:
     bool m_debugMode;
     BtIcons * m_icons;
     std::optional<CSwordBackend> m_backend;
+    std::optional<BtIndexingScheduler> m_indexingScheduler;
 
 };
 
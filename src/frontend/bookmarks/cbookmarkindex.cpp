@@ -29,7 +29,6 @@
 #include "../../backend/btbookmarksmodel.h"
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
-#include "../../backend/managers/cswordbackend.h"
 #include "../../util/btassert.h"
 #include "../../util/btconnect.h"
 #include "../../util/bticons.h"
@@ -488,22 +487,18 @@ void CBookmarkIndex::dropEvent(QDropEvent * event) {
         if (BTMimeData const * const mdata =
                 dynamic_cast<BTMimeData const *>(event->mimeData()))
         {
-            //create the new bookmark
-            auto const & bookmark = mdata->bookmarks().first();
-            QString moduleName(bookmark.module());
-            QString keyText(bookmark.key());
-            QString description(bookmark.description());
-            auto * const minfo =
-                    CSwordBackend::instance().findModuleByName(
-                        std::move(moduleName));
-            BT_ASSERT(minfo);
+            //create the new bookmarks in a single batch
+            QList<BtBookmarksModel::NewBookmark> bookmarks;
+            bookmarks.reserve(mdata->bookmarks().size());
+            for (auto const & bookmark : mdata->bookmarks())
+                bookmarks.append({bookmark.module(),
+                                  bookmark.key(),
+                                  bookmark.description()});
 
             /// \todo add title
-            m_bookmarksModel->addBookmark(indexUnderParent,
-                                          parentIndex,
-                                          *minfo,
-                                          std::move(keyText),
-                                          std::move(description));
+            m_bookmarksModel->addBookmarks(indexUnderParent,
+                                           parentIndex,
+                                           bookmarks);
         }
     } else {
         event->accept();
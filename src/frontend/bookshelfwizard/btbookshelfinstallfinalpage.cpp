@@ -12,6 +12,7 @@
 
 #include "btbookshelfinstallfinalpage.h"
 
+#include <algorithm>
 #include <QApplication>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -119,6 +120,7 @@ void BtBookshelfInstallFinalPage::initializePage() {
     // Install works:
     auto & btWiz = btWizard();
     m_modules = btWiz.selectedWorks().values();
+    m_moduleStatus.assign(static_cast<std::size_t>(m_modules.size()), -1);
     m_thread = new BtInstallThread(m_modules, btWiz.installPath(), this);
     BT_CONNECT(m_thread, &BtInstallThread::preparingInstall,
                this,     &BtBookshelfInstallFinalPage::slotInstallStarted,
@@ -153,33 +155,40 @@ void BtBookshelfInstallFinalPage::slotInstallStarted(int moduleIndex) {
     m_msgLabel->setText(
             tr("Installing \"%1\"").arg(m_modules.at(moduleIndex)->name()));
     m_msgLabel2->setText(m_modules.at(moduleIndex)->config(CSwordModuleInfo::Description));
-    m_lastStatus = -1;
 }
 
 void BtBookshelfInstallFinalPage::slotStatusUpdated(int moduleIndex, int status)
 {
+    auto & lastStatus =
+            m_moduleStatus.at(static_cast<std::size_t>(moduleIndex));
+
     // Skip initial high value sent by Sword:
-    if (m_lastStatus == -1 && status > 80)
+    if (lastStatus == -1 && status > 80)
         return;
 
-    if (m_lastStatus == status)
+    if (lastStatus == status)
         return;
 
-    m_lastStatus = status;
-
-    int const perModuleIncrement = 100 / m_modules.count();
-    m_progressBar->setValue((moduleIndex * perModuleIncrement)
-                            + (status * perModuleIncrement / 100));
+    lastStatus = status;
+    updateProgressBar();
 }
 
 void BtBookshelfInstallFinalPage::slotOneItemCompleted(int moduleIndex,
                                                        bool successful)
 {
-    m_progressBar->setValue((moduleIndex + 1) * (100 / m_modules.count()));
+    m_moduleStatus.at(static_cast<std::size_t>(moduleIndex)) = 100;
+    updateProgressBar();
     if (!successful)
         m_installFailed = true;
 }
 
+void BtBookshelfInstallFinalPage::updateProgressBar() {
+    int total = 0;
+    for (auto const status : m_moduleStatus)
+        total += std::max(status, 0);
+    m_progressBar->setValue(total / std::max(m_modules.count(), 1));
+}
+
 void BtBookshelfInstallFinalPage::slotThreadFinished() {
     m_progressBar->setValue(100);
     m_stopButton->setEnabled(false);
@@ -17,6 +17,7 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <vector>
 #include "../../backend/drivers/btmoduleset.h"
 
 
@@ -57,6 +58,7 @@ private Q_SLOTS:
 private: // methods:
 
     void retranslateUi();
+    void updateProgressBar();
 
 private: // fields:
 
@@ -71,6 +73,7 @@ private: // fields:
     bool m_installCompleted = false;
 
     QList<CSwordModuleInfo *> m_modules;
-    int m_lastStatus = -1;
+    /** The progress of every module, which are installed concurrently. */
+    std::vector<int> m_moduleStatus;
 
 }; /* class BtBookshelfInstallFinalPage */
@@ -24,9 +24,9 @@
 #include <set>
 #include "../../backend/btinstallbackend.h"
 #include "../../backend/config/btconfig.h"
-#include "../../backend/drivers/cswordmoduleinfo.h"
-#include "../../backend/managers/cswordbackend.h"
+#include "../../backend/language.h"
 #include "../../util/btconnect.h"
+#include "../../util/tool.h"
 #include "btbookshelfwizard.h"
 #include "btbookshelfwizardenums.h"
 
@@ -99,12 +99,13 @@ void BtBookshelfLanguagesPage::initializePage() {
 void BtBookshelfLanguagesPage::initializeLanguages() {
     // Get languages from sources:
     std::set<QString> languages;
-    for (auto const & sourceName : btWizard().selectedSources()) {
-        std::unique_ptr<CSwordBackend const> const backend =
-                BtInstallBackend::backend(BtInstallBackend::source(sourceName));
-        for (auto const * module : backend->moduleList())
-            languages.insert(module->language()->translatedName());
-    }
+    for (auto const & catalogue
+         : BtInstallBackend::catalogues(btWizard().selectedSources()))
+        for (auto const & entry : *catalogue)
+            languages.insert(
+                        Language::fromAbbrev(
+                            util::tool::fixSwordBcp47(entry.language))
+                        ->translatedName());
 
     // Update languages model:
     m_model->clear();
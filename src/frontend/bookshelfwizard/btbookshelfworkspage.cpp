@@ -13,12 +13,14 @@
 #include "btbookshelfworkspage.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <QAbstractItemView>
 #include <QApplication>
 #include <QByteArray>
 #include <QComboBox>
 #include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QLabel>
@@ -41,9 +43,11 @@
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/btmoduleset.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
+#include "../../backend/language.h"
 #include "../../backend/managers/cswordbackend.h"
 #include "../../util/btassert.h"
 #include "../../util/btconnect.h"
+#include "../../util/tool.h"
 #include "../btbookshelfgroupingmenu.h"
 #include "../btbookshelfview.h"
 #include "btbookshelfwizard.h"
@@ -63,26 +67,80 @@ QString const groupingOrderKey("GUI/BookshelfWizard/InstallPage/grouping");
 QString const installPathKey(
         "GUI/BookshelfWizard/InstallPage/installPathIndex");
 
-inline bool filter(WizardTaskType const taskType,
-                   QStringList const & languages,
-                   CSwordModuleInfo const * const mInfo)
-{
-    if (taskType == WizardTaskType::installWorks) {
-        return !CSwordBackend::instance().findModuleByName(mInfo->name())
-               && languages.contains(mInfo->language()->translatedName());
-    } else if (taskType == WizardTaskType::updateWorks) {
-        using CSMI = CSwordModuleInfo;
-        using CSV = sword::SWVersion const;
-        CSMI const * const installedModule =
-                CSwordBackend::instance().findModuleByName(mInfo->name());
-        return installedModule
-               && (CSV(installedModule->config(CSMI::ModuleVersion).toLatin1())
-                   < CSV(mInfo->config(CSMI::ModuleVersion).toLatin1()));
-    } else {
-        BT_ASSERT(taskType == WizardTaskType::removeWorks);
-        return CSwordBackend::instance().findModuleByName(mInfo->name());
+/**
+  \brief Decides which modules of the catalogues are listed for a task.
+
+  The names and parsed versions of the installed modules are looked up once on
+  construction, as are the languages of the catalogue entries, so that
+  deciding on the entries of all catalogues is a single linear pass.
+*/
+class ModuleSelector {
+
+public: // methods:
+
+    ModuleSelector(WizardTaskType const taskType,
+                   QStringList const & languages)
+        : m_taskType(taskType)
+        , m_languages(languages.cbegin(), languages.cend())
+    {
+        for (auto const * const module
+             : CSwordBackend::instance().moduleList())
+        {
+            auto name(module->name().toCaseFolded());
+            // Like findModuleByName(), prefer the first of equal names:
+            if (!m_installedVersions.contains(name))
+                m_installedVersions.insert(
+                            std::move(name),
+                            sword::SWVersion(
+                                module->config(
+                                    CSwordModuleInfo::ModuleVersion)
+                                .toLatin1().constData()));
+        }
     }
-}
+
+    /**
+      \returns whether the module of the given catalogue entry is to be
+               listed for the task.
+    */
+    bool operator()(BtInstallBackend::CatalogueEntry const & entry) {
+        auto const installed =
+                m_installedVersions.constFind(entry.name.toCaseFolded());
+        if (m_taskType == WizardTaskType::installWorks) {
+            return installed == m_installedVersions.cend()
+                   && languageSelected(entry.language);
+        } else if (m_taskType == WizardTaskType::updateWorks) {
+            return installed != m_installedVersions.cend()
+                   && (*installed
+                       < sword::SWVersion(
+                           entry.version.toLatin1().constData()));
+        } else {
+            BT_ASSERT(m_taskType == WizardTaskType::removeWorks);
+            return installed != m_installedVersions.cend();
+        }
+    }
+
+private: // methods:
+
+    bool languageSelected(QString const & abbrev) {
+        auto it = m_languageSelected.constFind(abbrev);
+        if (it == m_languageSelected.cend())
+            it = m_languageSelected.insert(
+                     abbrev,
+                     m_languages.contains(
+                         Language::fromAbbrev(
+                             util::tool::fixSwordBcp47(abbrev))
+                         ->translatedName()));
+        return *it;
+    }
+
+private: // fields:
+
+    WizardTaskType const m_taskType;
+    QSet<QString> const m_languages;
+    QHash<QString, sword::SWVersion> m_installedVersions; ///< By folded name
+    QHash<QString, bool> m_languageSelected; ///< By language abbreviation
+
+};
 
 } // anonymous namespace
 
@@ -266,23 +324,35 @@ void BtBookshelfWorksPage::initializePage() {
         QSet<QString> addedModuleNames;
         m_bookshelfModel->clear();
         m_usedBackends.clear();
-        for (auto const & sourceName : sources) {
+        /* The modules are chosen from the catalogues of the sources, so that
+           backends are only loaded for the sources which offer any of them: */
+        auto const catalogues(BtInstallBackend::catalogues(sources));
+        ModuleSelector select(m_taskType, languages);
+        for (qsizetype i = 0; i < sources.size(); ++i) {
+            QSet<QString> chosenModuleNames;
+            for (auto const & entry
+                 : *catalogues[static_cast<std::size_t>(i)])
+                if (!addedModuleNames.contains(entry.name)
+                    && select(entry))
+                    chosenModuleNames.insert(entry.name);
+            if (chosenModuleNames.isEmpty())
+                continue;
+
             sword::InstallSource const source =
-                    BtInstallBackend::source(sourceName);
+                    BtInstallBackend::source(sources.at(i));
             std::unique_ptr<CSwordBackend const> backend(
                         BtInstallBackend::backend(source));
             bool backendUsed = false;
             for (auto * const module : backend->moduleList()) {
-                if (filter(m_taskType, languages, module)) {
-                    QString const & moduleName = module->name();
-                    if (addedModuleNames.contains(moduleName))
-                        continue;
-                    addedModuleNames.insert(moduleName);
-                    m_bookshelfModel->addModule(module);
-                    module->setProperty("installSourceName",
-                                        QString(source.caption.c_str()));
-                    backendUsed = true;
-                }
+                QString const & moduleName = module->name();
+                if (!chosenModuleNames.contains(moduleName)
+                    || addedModuleNames.contains(moduleName))
+                    continue;
+                addedModuleNames.insert(moduleName);
+                m_bookshelfModel->addModule(module);
+                module->setProperty("installSourceName",
+                                    QString(source.caption.c_str()));
+                backendUsed = true;
             }
             if (backendUsed)
                 m_usedBackends.emplace_back(std::move(backend));
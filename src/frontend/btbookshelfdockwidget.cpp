@@ -183,6 +183,9 @@ void BtBookshelfDockWidget::initMenus() {
             addMenuAction(&BtBookshelfDockWidget::moduleAboutTriggered);
     m_itemAboutAction->setIcon(RM::aboutModule::icon());
 
+    m_itemStatisticsAction =
+            addMenuAction(&BtBookshelfDockWidget::moduleStatisticsTriggered);
+
     BT_CONNECT(m_itemContextMenu, &QMenu::aboutToShow,
                [this]{
                    void * v =
@@ -194,6 +197,8 @@ void BtBookshelfDockWidget::initMenus() {
                                tr("&Search in %1...").arg(module->name()));
                    m_itemSearchAction->setEnabled(!module->isLocked());
                    m_itemUnlockAction->setEnabled(module->isLocked());
+                   m_itemStatisticsAction->setEnabled(!module->isLocked()
+                                                      && module->hasIndex());
                });
 }
 
@@ -203,6 +208,7 @@ void BtBookshelfDockWidget::retranslateUi() {
     m_itemOpenAction->setText(tr("&Open"));
     m_itemUnlockAction->setText(tr("&Unlock..."));
     m_itemAboutAction->setText(tr("&About..."));
+    m_itemStatisticsAction->setText(tr("S&tatistics..."));
 
     m_installLabel->setText(tr("There are currently no works installed. Please "
                                "click the button below to install new works."));
@@ -48,6 +48,7 @@ class BtBookshelfDockWidget: public QDockWidget {
         void moduleSearchTriggered(CSwordModuleInfo *module);
         void moduleUnlockTriggered(CSwordModuleInfo *module);
         void moduleAboutTriggered(CSwordModuleInfo *module);
+        void moduleStatisticsTriggered(CSwordModuleInfo *module);
         void groupingOrderChanged(BtBookshelfTreeModel::Grouping newGrouping);
         void installWorksClicked();
 
@@ -70,6 +71,7 @@ class BtBookshelfDockWidget: public QDockWidget {
         QAction *m_itemSearchAction;
         QAction *m_itemUnlockAction;
         QAction *m_itemAboutAction;
+        QAction *m_itemStatisticsAction;
 
         static BtBookshelfDockWidget *m_instance;
 };
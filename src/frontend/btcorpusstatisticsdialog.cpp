@@ -0,0 +1,225 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btcorpusstatisticsdialog.h"
+
+#include <algorithm>
+#include <QComboBox>
+#include <QDebug>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMetaObject>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include <utility>
+#include "../backend/btcorpusstatistics.h"
+#include "../backend/bttaskscheduler.h"
+#include "../backend/drivers/cswordmoduleinfo.h"
+#include "../util/btconnect.h"
+#include "messagedialog.h"
+
+
+BtCorpusStatisticsDialog::BtCorpusStatisticsDialog(
+        CSwordModuleInfo const * module,
+        QWidget * parent,
+        Qt::WindowFlags flags)
+    : QDialog(parent, flags)
+    , m_module(module)
+    , m_cancellation(BtCancellationToken::create())
+{
+    resize(650, 450);
+    auto * const mainLayout = new QVBoxLayout(this);
+
+    auto * const filterLayout = new QHBoxLayout;
+    m_fieldComboBox = new QComboBox(this);
+    filterLayout->addWidget(m_fieldComboBox);
+    m_filterEdit = new QLineEdit(this);
+    m_filterEdit->setClearButtonEnabled(true);
+    filterLayout->addWidget(m_filterEdit, 1);
+    mainLayout->addLayout(filterLayout);
+
+    auto * const splitter = new QSplitter(this);
+    m_termsView = new QTreeWidget(splitter);
+    m_termsView->setRootIsDecorated(false);
+    m_termsView->setUniformRowHeights(true);
+    m_termsView->setColumnCount(3);
+    m_termsView->header()->setSectionResizeMode(
+                QHeaderView::ResizeToContents);
+    splitter->addWidget(m_termsView);
+    m_booksView = new QTreeWidget(splitter);
+    m_booksView->setRootIsDecorated(false);
+    m_booksView->setColumnCount(2);
+    m_booksView->header()->setSectionResizeMode(
+                QHeaderView::ResizeToContents);
+    splitter->addWidget(m_booksView);
+    splitter->setStretchFactor(0, 2);
+    splitter->setStretchFactor(1, 1);
+    mainLayout->addWidget(splitter, 1);
+
+    m_statusLabel = new QLabel(this);
+    mainLayout->addWidget(m_statusLabel);
+
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Close,
+                                     Qt::Horizontal,
+                                     this);
+    BT_CONNECT(m_buttons, &QDialogButtonBox::rejected,
+               this, &BtCorpusStatisticsDialog::reject);
+    mainLayout->addWidget(m_buttons);
+
+    retranslateUi();
+
+    BT_CONNECT(m_fieldComboBox, &QComboBox::currentIndexChanged,
+               this, &BtCorpusStatisticsDialog::fillTerms);
+    BT_CONNECT(m_filterEdit, &QLineEdit::textChanged,
+               this, &BtCorpusStatisticsDialog::filterTerms);
+    BT_CONNECT(m_termsView, &QTreeWidget::currentItemChanged,
+               this, &BtCorpusStatisticsDialog::fillBooks);
+    BT_CONNECT(module, &QObject::destroyed,
+               this, &BtCorpusStatisticsDialog::close);
+
+    // Computing the statistics reads the whole index, which might take a while:
+    m_fieldComboBox->setEnabled(false);
+    m_filterEdit->setEnabled(false);
+    m_statusLabel->setText(tr("Computing the statistics..."));
+    m_token = BtTaskScheduler::instance().submit(
+                  [this](BtTaskToken &) {
+                      std::shared_ptr<BtCorpusStatistics const> statistics;
+                      try {
+                          statistics =
+                                  m_module->corpusStatistics(m_cancellation);
+                      } catch (...) {
+                          qWarning() << "Failed to compute the statistics of"
+                                     << m_module->name();
+                      }
+                      QMetaObject::invokeMethod(
+                                  this,
+                                  [this, statistics = std::move(statistics)]
+                                  { showStatistics(std::move(statistics)); },
+                                  Qt::QueuedConnection);
+                  },
+                  BtTaskScheduler::Priority::Interactive);
+}
+
+BtCorpusStatisticsDialog::~BtCorpusStatisticsDialog() {
+    m_cancellation.cancel();
+    m_token->cancel();
+    m_token->wait();
+}
+
+void BtCorpusStatisticsDialog::retranslateUi() {
+    setWindowTitle(tr("Statistics of %1").arg(m_module->name()));
+    auto const field = m_fieldComboBox->currentIndex();
+    m_fieldComboBox->clear();
+    m_fieldComboBox->addItem(tr("Words"));
+    m_fieldComboBox->addItem(tr("Strong's numbers"));
+    m_fieldComboBox->addItem(tr("Morphological codes"));
+    m_fieldComboBox->setCurrentIndex(std::max(field, 0));
+    m_filterEdit->setPlaceholderText(tr("Filter"));
+    m_termsView->setHeaderLabels({tr("Term"),
+                                  tr("Occurrences"),
+                                  tr("Entries")});
+    m_booksView->setHeaderLabels({tr("Book"), tr("Entries")});
+    message::prepareDialogBox(m_buttons);
+}
+
+void BtCorpusStatisticsDialog::showStatistics(
+        std::shared_ptr<BtCorpusStatistics const> statistics)
+{
+    m_statistics = std::move(statistics);
+    if (!m_statistics) {
+        m_statusLabel->setText(tr("The statistics could not be computed."));
+        return;
+    }
+    m_fieldComboBox->setEnabled(true);
+    m_filterEdit->setEnabled(true);
+    m_booksView->setVisible(!m_statistics->books().isEmpty());
+    fillTerms();
+}
+
+void BtCorpusStatisticsDialog::fillTerms() {
+    if (!m_statistics)
+        return;
+    auto const & terms =
+            m_statistics->terms(static_cast<BtCorpusStatistics::Field>(
+                                    std::max(m_fieldComboBox->currentIndex(),
+                                             0)));
+    m_termsView->setUpdatesEnabled(false);
+    m_termsView->setSortingEnabled(false);
+    m_termsView->clear();
+    QList<QTreeWidgetItem *> items;
+    items.reserve(static_cast<qsizetype>(terms.size()));
+    for (std::size_t i = 0u; i < terms.size(); ++i) {
+        auto * const item = new QTreeWidgetItem;
+        item->setText(0, terms[i].text);
+        item->setData(0, Qt::UserRole, static_cast<qulonglong>(i));
+        item->setData(1,
+                      Qt::DisplayRole,
+                      static_cast<qulonglong>(terms[i].occurrences));
+        item->setData(2,
+                      Qt::DisplayRole,
+                      static_cast<qulonglong>(terms[i].entries));
+        item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+        item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+        items.append(item);
+    }
+    m_termsView->addTopLevelItems(items);
+    m_termsView->setSortingEnabled(true);
+    m_termsView->sortByColumn(1, Qt::DescendingOrder);
+    m_termsView->setUpdatesEnabled(true);
+    m_statusLabel->setText(
+                tr("%n term(s) in %1 entries.",
+                   nullptr,
+                   static_cast<int>(terms.size()))
+                    .arg(m_statistics->numEntries()));
+    filterTerms();
+    fillBooks();
+}
+
+void BtCorpusStatisticsDialog::filterTerms() {
+    auto const filter(m_filterEdit->text());
+    m_termsView->setUpdatesEnabled(false);
+    for (int i = 0; i < m_termsView->topLevelItemCount(); ++i) {
+        auto * const item = m_termsView->topLevelItem(i);
+        item->setHidden(!filter.isEmpty()
+                        && !item->text(0).contains(filter,
+                                                   Qt::CaseInsensitive));
+    }
+    m_termsView->setUpdatesEnabled(true);
+}
+
+void BtCorpusStatisticsDialog::fillBooks() {
+    m_booksView->clear();
+    auto const * const item = m_termsView->currentItem();
+    if (!m_statistics || !item)
+        return;
+    auto const & term =
+            m_statistics->terms(static_cast<BtCorpusStatistics::Field>(
+                                    std::max(m_fieldComboBox->currentIndex(),
+                                             0)))
+                [item->data(0, Qt::UserRole).value<qulonglong>()];
+    auto const & books = m_statistics->books();
+    for (std::size_t i = 0u; i < term.bookEntries.size(); ++i) {
+        if (!term.bookEntries[i])
+            continue;
+        auto * const bookItem = new QTreeWidgetItem(m_booksView);
+        bookItem->setText(0, books[static_cast<qsizetype>(i)]);
+        bookItem->setData(1,
+                          Qt::DisplayRole,
+                          static_cast<qulonglong>(term.bookEntries[i]));
+        bookItem->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+    }
+}
@@ -0,0 +1,72 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QDialog>
+
+#include <memory>
+#include <QObject>
+#include <Qt>
+#include "../util/btcancellationtoken.h"
+
+
+class BtCorpusStatistics;
+class BtTaskToken;
+class CSwordModuleInfo;
+class QComboBox;
+class QDialogButtonBox;
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QWidget;
+
+/**
+  \brief Shows how often the words, Strong's numbers and morphological codes
+         occur in a module, and in which books.
+
+  The statistics are computed from the search index in a background task.
+*/
+class BtCorpusStatisticsDialog: public QDialog {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtCorpusStatisticsDialog(CSwordModuleInfo const * module,
+                             QWidget * parent = nullptr,
+                             Qt::WindowFlags flags = Qt::WindowFlags());
+    ~BtCorpusStatisticsDialog() override;
+
+private: // methods:
+
+    void retranslateUi();
+    void showStatistics(
+            std::shared_ptr<BtCorpusStatistics const> statistics);
+    void fillTerms();
+    void filterTerms();
+    void fillBooks();
+
+private: // fields:
+
+    CSwordModuleInfo const * const m_module;
+    BtCancellationToken const m_cancellation;
+    std::shared_ptr<BtTaskToken> m_token;
+    std::shared_ptr<BtCorpusStatistics const> m_statistics;
+    QComboBox * m_fieldComboBox;
+    QLineEdit * m_filterEdit;
+    QLabel * m_statusLabel;
+    QTreeWidget * m_termsView;
+    QTreeWidget * m_booksView;
+    QDialogButtonBox * m_buttons;
+
+}; /* class BtCorpusStatisticsDialog */
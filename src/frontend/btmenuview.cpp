@@ -12,6 +12,7 @@
 
 #include "btmenuview.h"
 
+#include <cstddef>
 #include <QAbstractItemModel>
 #include <QAction>
 #include <QActionGroup>
@@ -22,6 +23,7 @@
 #include <QPersistentModelIndex>
 #include <QVariant>
 #include <Qt>
+#include <vector>
 #include "../util/btassert.h"
 #include "../util/btconnect.h"
 
@@ -41,7 +43,13 @@ BtMenuView::BtMenuView(QString const & title, QWidget * parent)
     : QMenu(title, parent)
     , m_model(nullptr)
     , m_actions(nullptr)
-{}
+{
+    BT_CONNECT(this, &QMenu::aboutToShow,
+               [this]{
+                   if (m_dirty)
+                       rebuildMenu();
+               });
+}
 
 BtMenuView::~BtMenuView() {
     delete m_actions;
@@ -51,19 +59,13 @@ void BtMenuView::setModel(QAbstractItemModel *model) {
     if (m_model)
         m_model->disconnect(this);
     m_model = model;
-    rebuildMenu();
+    invalidateMenu();
     if (model) {
-        /* Instead of connecting each signal to rebuildMenu() directly, we
-           instead queue events to this BtMenuView instance. The multiple
-           "rebuild" events can be merged by the event handler to avoid
-           consecutive rebuild events from causing needless rebuilds. */
-        auto const triggerRebuild =
-                [this] {
-                    QCoreApplication::postEvent(this,
-                                                new QEvent(rebuildEventType),
-                                                Qt::HighEventPriority);
-                };
-        BT_CONNECT(model, &QAbstractItemModel::dataChanged, triggerRebuild);
+        auto const triggerRebuild = [this]{ invalidateMenu(); };
+        BT_CONNECT(model, &QAbstractItemModel::dataChanged,
+                   [this](QModelIndex const & topLeft,
+                          QModelIndex const & bottomRight)
+                   { updateActions(topLeft, bottomRight); });
         BT_CONNECT(model, &QAbstractItemModel::layoutChanged, triggerRebuild);
         BT_CONNECT(model, &QAbstractItemModel::modelReset, triggerRebuild);
         BT_CONNECT(model, &QAbstractItemModel::rowsInserted, triggerRebuild);
@@ -76,12 +78,70 @@ bool BtMenuView::event(QEvent * const e) {
     if (e->type() == rebuildEventType) {
         e->accept();
         QCoreApplication::removePostedEvents(this, rebuildEventType);
-        rebuildMenu();
+        if (m_dirty)
+            rebuildMenu();
         return true;
     }
     return QMenu::event(e);
 }
 
+void BtMenuView::invalidateMenu() {
+    if (m_dirty)
+        return;
+    m_dirty = true;
+    /* A menu being shown is rebuilt by a queued event, so that consecutive
+       changes of the model are merged into a single rebuild: */
+    if (isVisible())
+        QCoreApplication::postEvent(this,
+                                    new QEvent(rebuildEventType),
+                                    Qt::HighEventPriority);
+}
+
+void BtMenuView::updateActions(QModelIndex const & topLeft,
+                               QModelIndex const & bottomRight)
+{
+    if (m_dirty || !m_actions)
+        return;
+
+    auto const parentIndex = topLeft.parent();
+    std::vector<QAction *> actions(
+                static_cast<std::size_t>(bottomRight.row() - topLeft.row() + 1),
+                nullptr);
+    for (auto * const action : m_actions->actions()) {
+        auto const index =
+                action->property(persistentIndexPropertyName)
+                .toPersistentModelIndex();
+        if (index.isValid()
+            && index.parent() == parentIndex
+            && index.row() >= topLeft.row()
+            && index.row() <= bottomRight.row())
+            actions[static_cast<std::size_t>(index.row() - topLeft.row())] =
+                    action;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        auto const index = m_model->index(row, 0, parentIndex);
+        auto * const oldAction =
+                actions[static_cast<std::size_t>(row - topLeft.row())];
+        auto * const parentMenu =
+                oldAction ? qobject_cast<QMenu *>(oldAction->parent())
+                          : nullptr;
+        // Submenus and items without an action are only added by rebuilding:
+        if (!parentMenu || m_model->rowCount(index) > 0) {
+            invalidateMenu();
+            return;
+        }
+
+        if (auto * const newAction_ = newAction(parentMenu, index)) {
+            newAction_->setActionGroup(m_actions);
+            newAction_->setProperty(persistentIndexPropertyName,
+                                    QPersistentModelIndex(index));
+            parentMenu->insertAction(oldAction, newAction_);
+        }
+        delete oldAction;
+    }
+}
+
 void BtMenuView::preBuildMenu(QActionGroup *) {
     // Intentionally empty. Reimplement in subclass if needed.
 }
@@ -178,6 +238,7 @@ QMenu *BtMenuView::newMenu(QMenu *parentMenu, const QModelIndex &itemIndex) {
 }
 
 void BtMenuView::rebuildMenu() {
+    m_dirty = false;
     removeMenus();
 
     delete m_actions;
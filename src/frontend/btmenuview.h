@@ -26,9 +26,10 @@ class QModelIndex;
 class QWidget;
 
 /**
-  This is a special menu, which shows the contents of an item model. The menu is repopulated
-  with data from the item model each time before its shown, and it does not in any other way
-  react to changes in the model.
+  This is a special menu, which shows the contents of an item model. The menu is only built
+  when it is about to be shown. Changes to the data of items already in the menu update their
+  actions in place, while other changes to the model just cause the menu to be rebuilt when
+  it is shown next, or right away if it is being shown.
 
   The menu is built from items in the model which are below the given parent index. By
   default this parent index is invalid. When the menu is about to show, all items directly
@@ -119,14 +120,28 @@ class BtMenuView: public QMenu {
         /** \brief Rebuilds the menu. */
         void rebuildMenu();
 
+        /**
+          \brief Makes the menu be rebuilt before it is shown next, or soon if
+                 it is being shown.
+        */
+        void invalidateMenu();
+
     private: // methods:
 
         void buildMenu(QMenu *parentMenu, const QModelIndex &parentIndex);
         void removeMenus();
 
+        /**
+          \brief Replaces the actions of the given rows with new ones, or
+                 invalidates the menu if this is not possible.
+        */
+        void updateActions(QModelIndex const & topLeft,
+                           QModelIndex const & bottomRight);
+
     private: // fields:
 
         QAbstractItemModel *m_model;
         QActionGroup *m_actions;
+        bool m_dirty = false; ///< Whether to rebuild the menu before showing
 
 };
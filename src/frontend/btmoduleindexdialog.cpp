@@ -12,9 +12,15 @@
 
 #include "btmoduleindexdialog.h"
 
-#include <array>
-#include <QApplication>
+#include <algorithm>
+#include <cstdint>
+#include <QChar>
+#include <QEventLoop>
+#include <QMetaObject>
+#include <QStringList>
+#include <Qt>
 #include <utility>
+#include "../backend/btindexingscheduler.h"
 #include "../backend/drivers/cswordmoduleinfo.h"
 #include "../util/btassert.h"
 #include "../util/btconnect.h"
@@ -34,80 +40,174 @@ bool BtModuleIndexDialog::indexAllModules(const QList<CSwordModuleInfo *> &modul
 
 BtModuleIndexDialog::BtModuleIndexDialog(int numModules)
     : QProgressDialog(tr("Preparing to index modules..."), tr("Cancel"), 0,
-                      numModules * 100, nullptr),
-      m_currentModuleIndex(0)
+                      numModules * 100, nullptr)
+    , m_moduleProgress(static_cast<std::size_t>(numModules), -1)
+    , m_moduleStatistics(static_cast<std::size_t>(numModules))
 {
     setWindowTitle(tr("Creating indices"));
     setModal(true);
 }
 
+void BtModuleIndexDialog::updateProgress(
+        QList<CSwordModuleInfo *> const & modules)
+{
+    int total = 0;
+    QStringList activeModuleNames;
+    QStringList details;
+    for (std::size_t i = 0u; i < m_moduleProgress.size(); ++i) {
+        auto const progress = m_moduleProgress[i];
+        if (progress < 0)
+            continue;
+        total += progress;
+        if (progress >= 100)
+            continue;
+        auto const & name = modules.at(static_cast<int>(i))->name();
+        activeModuleNames.append(name);
+
+        // Show the throughput and the estimated time left:
+        auto const & statistics = m_moduleStatistics[i];
+        if (!statistics || statistics->elapsed.count() <= 0)
+            continue;
+        auto const perSecond =
+                (statistics->entriesDone * 1000u)
+                / static_cast<std::uint64_t>(statistics->elapsed.count());
+        if (perSecond > 0u
+            && statistics->entriesTotal > statistics->entriesDone)
+        {
+            details.append(
+                    tr("%1: %2 of %3 entries (%4 per second, about %5 s left)")
+                    .arg(name)
+                    .arg(statistics->entriesDone)
+                    .arg(statistics->entriesTotal)
+                    .arg(perSecond)
+                    .arg((statistics->entriesTotal - statistics->entriesDone)
+                         / perSecond));
+        } else {
+            details.append(tr("%1: %2 of %3 entries (%4 per second)")
+                           .arg(name)
+                           .arg(statistics->entriesDone)
+                           .arg(statistics->entriesTotal)
+                           .arg(perSecond));
+        }
+    }
+    setValue(total);
+    if (!activeModuleNames.isEmpty()) {
+        details.prepend(tr("Creating index for work: %1")
+                        .arg(activeModuleNames.join(QStringLiteral(", "))));
+        setLabelText(details.join(QChar('\n')));
+    }
+}
+
 bool BtModuleIndexDialog::indexAllModulesPrivate(const QList<CSwordModuleInfo*> &modules)
 {
     bool success = true;
 
-    QList <CSwordModuleInfo*> indexedModules;
-    for (auto * const m : modules) {
-        BT_ASSERT(!m->hasIndex());
-
-        /*
-          Keep track of created indices to delete them on failure or
-          cancellation:
-        */
-        indexedModules.append(m);
+    auto & scheduler = BtIndexingScheduler::instance();
+    auto const cancelAll =
+            [&scheduler, &modules] {
+                for (auto const * const m : modules)
+                    scheduler.cancel(m);
+            };
 
-        std::array<QMetaObject::Connection, 3u> connections{
-                BT_CONNECT(this, &BtModuleIndexDialog::canceled,
-                           m /* needed */,  [m]{ m->cancelIndexing(); }),
+    std::vector<QMetaObject::Connection> connections;
+    for (int i = 0; i < modules.size(); ++i) {
+        auto * const m = modules.at(i);
+        BT_ASSERT(!m->hasIndex());
+        auto & progress = m_moduleProgress[static_cast<std::size_t>(i)];
+        auto & statistics =
+                m_moduleStatistics[static_cast<std::size_t>(i)];
+        connections.emplace_back(
                 BT_CONNECT(m, &CSwordModuleInfo::indexingFinished,
                            this, // needed
-                           [this]{
-                               setValue(m_currentModuleIndex * 100 + 100);
-                               qApp->processEvents();
-                           }),
+                           [this, &modules, &progress]{
+                               progress = 100;
+                               updateProgress(modules);
+                           }));
+        connections.emplace_back(
                 BT_CONNECT(m, &CSwordModuleInfo::indexingProgress,
                            this, // needed
-                           [this](int percentage) {
-                               setValue(m_currentModuleIndex * 100 + percentage);
-                               qApp->processEvents();
-                           })};
-
-        // Single module indexing blocks until finished:
-        setLabelText(tr("Creating index for work: %1").arg(m->name()));
-
-        try {
-            m->buildIndex();
-        } catch (...) {
-            QString msg;
-            try {
-                throw;
-            } catch (std::exception const & e) {
-                msg = e.what();
-            } catch (...) {
-                msg = tr("<UNKNOWN EXCEPTION>");
-            }
-
-            message::showWarning(this,
-                                 tr("Indexing aborted"),
-                                 tr("An internal error occurred while building "
-                                    "the index:<br/><br/>%1").arg(msg));
-            success = false;
-        }
-
-        m_currentModuleIndex++;
+                           [this, &modules, &progress](int percentage) {
+                               progress = std::max(percentage, 0);
+                               updateProgress(modules);
+                           }));
+        connections.emplace_back(
+                BT_CONNECT(m, &CSwordModuleInfo::indexingStatistics,
+                           this, // needed
+                           [this, &modules, &progress, &statistics](
+                                   CSwordModuleInfo::IndexingStatistics const &
+                                           s)
+                           {
+                               statistics = s;
+                               progress = std::max(progress, 0);
+                               updateProgress(modules);
+                           }));
+    }
+    connections.emplace_back(
+            BT_CONNECT(this, &BtModuleIndexDialog::canceled, cancelAll));
+    connections.emplace_back(
+            BT_CONNECT(&scheduler, &BtIndexingScheduler::indexingFailed,
+                       this, // needed
+                       [this, &success, &cancelAll, &modules](
+                               QString const & moduleName,
+                               QString const & msg)
+                       {
+                           if (!success
+                               || std::none_of(
+                                      modules.begin(),
+                                      modules.end(),
+                                      [&moduleName](auto const * const m)
+                                      { return m->name() == moduleName; }))
+                               return;
+                           success = false;
+                           cancelAll();
+                           message::showWarning(
+                                       this,
+                                       tr("Indexing aborted"),
+                                       tr("An internal error occurred while "
+                                          "building the index:<br/><br/>%1")
+                                       .arg(msg));
+                       }));
+
+    /* Indexing runs in the worker threads until all modules are done, whose
+       progress and results are delivered to this thread by its event loop: */
+    for (auto const * const m : modules)
+        scheduler.enqueue(m, BtIndexingScheduler::Priority::Search);
+    {
+        QEventLoop loop;
+        auto const quitIfDone =
+                [this, &loop, &scheduler, &modules] {
+                    if (wasCanceled()
+                        || std::none_of(modules.begin(),
+                                        modules.end(),
+                                        [&scheduler](auto const * const m)
+                                        { return scheduler.isScheduled(m); }))
+                        loop.quit();
+                };
+        // These connections are dropped with the loop:
+        BT_CONNECT(&scheduler, &BtIndexingScheduler::jobFinished,
+                   &loop, quitIfDone);
+        BT_CONNECT(this, &BtModuleIndexDialog::canceled,
+                   &loop, &QEventLoop::quit);
+        // The jobs might have finished before connecting:
+        QMetaObject::invokeMethod(&loop, quitIfDone, Qt::QueuedConnection);
+        loop.exec();
+    }
 
-        for (auto & connection : connections) {
-            BT_DEBUG_ONLY(auto const r =) disconnect(std::move(connection));
-            BT_ASSERT(r);
-        }
+    for (auto & connection : connections) {
+        BT_DEBUG_ONLY(auto const r =) disconnect(std::move(connection));
+        BT_ASSERT(r);
+    }
 
-        if (wasCanceled()) success = false;
+    if (wasCanceled()) success = false;
 
-        if (!success) break;
-    }
+    // None of the modules is scheduled any more, hence this does not block:
+    if (success)
+        success = scheduler.waitForIndices(
+                      BtConstModuleList(modules.begin(), modules.end()));
 
     if (!success) {
         // Delete already created indices:
-        for (auto * const m : indexedModules)
+        for (auto * const m : modules)
             if (m->hasIndex())
                 m->deleteIndex();
     }
@@ -14,13 +14,16 @@
 
 #include <QProgressDialog>
 
+#include <optional>
+#include <vector>
+#include "../backend/drivers/cswordmoduleinfo.h"
 
-class CSwordModuleInfo;
 
 /**
   This dialog is used to index a list of modules and to show progress for that.
   While the indexing is in progress it creates a blocking, top level dialog
-  which shows the progress while the indexing is done.
+  which shows the progress while the indexing is done. The modules are indexed
+  through BtIndexingScheduler with Priority::Search.
 */
 class BtModuleIndexDialog: public QProgressDialog {
 
@@ -54,8 +57,15 @@ private: // methods:
     */
     bool indexAllModulesPrivate(QList<CSwordModuleInfo *> const & modules);
 
+    void updateProgress(QList<CSwordModuleInfo *> const & modules);
+
 private: // fields:
 
-    int m_currentModuleIndex;
+    /** Indexing progress percentages per module, or -1 if not yet started. */
+    std::vector<int> m_moduleProgress;
+
+    /** The latest indexing statistics per module, if any. */
+    std::vector<std::optional<CSwordModuleInfo::IndexingStatistics>>
+            m_moduleStatistics;
 
 };
@@ -12,9 +12,17 @@
 
 #include "btprinter.h"
 
+#include <algorithm>
+#include <memory>
+#include <QAbstractTextDocumentLayout>
+#include <QApplication>
+#include <QFontMetricsF>
+#include <QPainter>
 #include <QPrintDialog>
 #include <QPrinter>
-#include <QTextEdit>
+#include <QProgressDialog>
+#include <QTextDocument>
+#include <QTextStream>
 #include "../backend/keys/cswordversekey.h"
 #include "../backend/managers/cdisplaytemplatemgr.h"
 #include "../util/btassert.h"
@@ -41,13 +49,109 @@ BtPrinter::BtPrinter(DisplayOptions const & displayOptions,
 {}
 
 void BtPrinter::printKeyTree(KeyTree const & tree) {
-    QTextEdit htmlPage;
-    htmlPage.setHtml(renderKeyTree(tree));
-
     QPrinter printer;
     QPrintDialog printDialog(&printer);
-    if (printDialog.exec() == QDialog::Accepted)
-        htmlPage.print(&printer);
+    if (printDialog.exec() != QDialog::Accepted)
+        return;
+
+    QProgressDialog progress(tr("Preparing the text for printing..."),
+                             tr("Cancel"),
+                             0,
+                             static_cast<int>(tree.size()));
+    progress.setWindowTitle(QStringLiteral("BibleTime"));
+    progress.setWindowModality(Qt::ApplicationModal);
+    progress.setMinimumDuration(500);
+
+    // Render the entries in batches by worker threads:
+    QString html;
+    {
+        QTextStream out(&html);
+        auto const displayOptions = m_displayOptions;
+        auto const filterOptions = m_filterOptions;
+        if (!renderKeyTreeInParallel(
+                tree,
+                out,
+                [displayOptions, filterOptions] {
+                    return std::make_unique<BtPrinter>(displayOptions,
+                                                       filterOptions);
+                },
+                [&progress](std::size_t const rendered) {
+                    progress.setValue(static_cast<int>(rendered));
+                    qApp->processEvents(); //do not lock the GUI!
+                    return !progress.wasCanceled();
+                }))
+            return;
+    }
+
+    QTextDocument document;
+    document.setHtml(html);
+    html = QString();
+    printDocument(document, printer, progress);
+}
+
+bool BtPrinter::printDocument(QTextDocument & document,
+                              QPrinter & printer,
+                              QProgressDialog & progress)
+{
+    /* Like QTextDocument::print(), but paint the pages one by one, so that
+       printing can be followed and canceled: */
+    document.documentLayout()->setPaintDevice(&printer);
+    auto const pageRect = printer.pageRect(QPrinter::DevicePixel);
+    QFontMetricsF const fontMetrics(document.defaultFont(), &printer);
+    auto const pageNumberHeight = 2.0 * fontMetrics.height();
+    QSizeF const bodySize(pageRect.width(),
+                          pageRect.height() - pageNumberHeight);
+    document.setPageSize(bodySize);
+
+    auto const pageCount = document.pageCount();
+    auto fromPage = printer.fromPage();
+    auto toPage = printer.toPage();
+    if (fromPage <= 0 && toPage <= 0) {
+        fromPage = 1;
+        toPage = pageCount;
+    }
+    fromPage = std::max(fromPage, 1);
+    toPage = std::min(toPage, pageCount);
+    if (fromPage > toPage)
+        return false;
+
+    progress.setLabelText(tr("Printing..."));
+    progress.setRange(fromPage - 1, toPage);
+    progress.setValue(fromPage - 1);
+
+    QPainter painter(&printer);
+    if (!painter.isActive())
+        return false;
+    for (auto page = fromPage; page <= toPage; ++page) {
+        if (page != fromPage)
+            printer.newPage();
+
+        painter.save();
+        painter.translate(0.0, -(page - 1) * bodySize.height());
+        document.drawContents(&painter,
+                              QRectF(QPointF(0.0,
+                                             (page - 1) * bodySize.height()),
+                                     bodySize));
+        painter.restore();
+
+        painter.save();
+        painter.setFont(document.defaultFont());
+        auto const pageNumber = QString::number(page);
+        painter.drawText(
+                    QPointF(bodySize.width()
+                            - fontMetrics.horizontalAdvance(pageNumber),
+                            bodySize.height() + 1.5 * fontMetrics.height()),
+                    pageNumber);
+        painter.restore();
+
+        progress.setValue(page);
+        qApp->processEvents(); //do not lock the GUI!
+        if (progress.wasCanceled()) {
+            printer.abort();
+            return false;
+        }
+    }
+    return true;
 }
 
 QString BtPrinter::entryLink(KeyTreeItem const & item,
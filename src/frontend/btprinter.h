@@ -16,6 +16,10 @@
 #include "../backend/rendering/cdisplayrendering.h"
 
 
+class QPrinter;
+class QProgressDialog;
+class QTextDocument;
+
 /** \brief Manages the print item queue and printing. */
 class BtPrinter final: public QObject, public Rendering::CDisplayRendering {
 
@@ -27,10 +31,24 @@ public: // methods:
               FilterOptions const & filterOptions,
               QObject * const parent = nullptr);
 
+    /**
+      \brief Asks for a printer and prints the given tree.
+
+      The entries are rendered by worker threads, and the pages are printed
+      one by one, showing the progress and allowing to cancel printing.
+    */
     void printKeyTree(KeyTree const &);
 
 private: // methods:
 
+    /**
+      \brief Prints the pages of the given document chosen in the printer.
+      \returns whether all the pages were printed.
+    */
+    bool printDocument(QTextDocument & document,
+                       QPrinter & printer,
+                       QProgressDialog & progress);
+
     QString entryLink(KeyTreeItem const & item,
                       CSwordModuleInfo const & module) const override;
 
@@ -0,0 +1,143 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#ifdef BUILD_TEXT_TO_SPEECH
+
+#include "btspeechsession.h"
+
+#include <QMetaObject>
+#include <QTextBoundaryFinder>
+#include <QTextToSpeech>
+#include <QThread>
+#include <utility>
+#include "../util/btconnect.h"
+#include "bibletime.h"
+
+
+namespace {
+
+/** The number of chunks queued in the engine ahead of the spoken one. */
+constexpr int const chunksAhead = 2;
+
+/**
+  The number of characters of the chunks, unless single sentences are longer.
+  The first chunk of a text is a single sentence, so speaking starts early.
+*/
+constexpr qsizetype const chunkSize = 400;
+
+} // anonymous namespace
+
+BtSpeechSession::BtSpeechSession(QObject * const parent)
+    : QObject(parent)
+    , m_tts(BibleTime::createTextToSpeechInstance())
+{
+    BT_CONNECT(m_tts.get(), &QTextToSpeech::aboutToSynthesize,
+               this,
+               [this] {
+                   if (m_queuedChunks > 0)
+                       --m_queuedChunks;
+                   feed();
+               });
+}
+
+BtSpeechSession::~BtSpeechSession() {
+    if (m_prefetchThread)
+        m_prefetchThread->wait();
+}
+
+void BtSpeechSession::speak(QString const & text, Continuation continuation) {
+    stop();
+    if (continuation)
+        m_continuation =
+                std::make_shared<Continuation>(std::move(continuation));
+    appendChunks(text);
+    feed();
+}
+
+void BtSpeechSession::stop() {
+    ++m_generation;
+    m_tts->stop();
+    m_chunks.clear();
+    m_queuedChunks = 0;
+    m_continuation.reset();
+    m_prefetchedText.reset();
+}
+
+void BtSpeechSession::appendChunks(QString const & text) {
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Sentence, text);
+    QString chunk;
+    bool first = m_chunks.isEmpty() && m_queuedChunks == 0;
+    qsizetype start = 0;
+    for (auto end = finder.toNextBoundary();
+         end >= 0;
+         end = finder.toNextBoundary())
+    {
+        auto const sentence = QStringView(text).mid(start, end - start);
+        start = end;
+        if (!chunk.isEmpty() && chunk.size() + sentence.size() > chunkSize) {
+            m_chunks.append(std::move(chunk));
+            chunk.clear();
+        }
+        chunk.append(sentence);
+        if (first && !chunk.trimmed().isEmpty()) {
+            m_chunks.append(std::move(chunk));
+            chunk.clear();
+            first = false;
+        }
+    }
+    if (!chunk.trimmed().isEmpty())
+        m_chunks.append(std::move(chunk));
+}
+
+void BtSpeechSession::feed() {
+    while (m_queuedChunks < chunksAhead) {
+        if (m_chunks.isEmpty()) {
+            if (!m_prefetchedText)
+                break;
+            appendChunks(*m_prefetchedText);
+            m_prefetchedText.reset();
+            continue;
+        }
+        m_tts->enqueue(m_chunks.takeFirst());
+        ++m_queuedChunks;
+    }
+    startPrefetch();
+}
+
+void BtSpeechSession::startPrefetch() {
+    if (!m_continuation || m_prefetchedText || m_prefetchThread)
+        return;
+
+    m_prefetchThread.reset(
+        QThread::create(
+            [this, generation = m_generation, continuation = m_continuation] {
+                auto text((*continuation)());
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, generation, text = std::move(text)]() mutable {
+                        m_prefetchThread->wait();
+                        m_prefetchThread.reset();
+                        if (generation == m_generation) {
+                            if (text) {
+                                m_prefetchedText = std::move(text);
+                            } else { // The session ends after this text
+                                m_continuation.reset();
+                            }
+                        }
+                        feed();
+                    },
+                    Qt::QueuedConnection);
+            }));
+    m_prefetchThread->start(QThread::LowPriority);
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#ifdef BUILD_TEXT_TO_SPEECH
+
+#pragma once
+
+#include <QObject>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <QString>
+#include <QStringList>
+
+
+class QTextToSpeech;
+class QThread;
+
+/**
+  \brief Speaks texts sentence by sentence with a persistent text-to-speech
+         engine.
+
+  A text is split into chunks of whole sentences, of which only a few are
+  queued in the engine at a time, so that speaking starts as soon as the first
+  chunk is synthesized instead of after the whole text. If a continuation is
+  given, the text it returns next is prepared by a background thread while the
+  current text is spoken, and is spoken right after it.
+*/
+class BtSpeechSession: public QObject {
+
+    Q_OBJECT
+
+public: // types:
+
+    /**
+      Returns the next text to speak, or nothing to end the session. It is
+      called by background threads, but never concurrently.
+    */
+    using Continuation = std::function<std::optional<QString>()>;
+
+public: // methods:
+
+    BtSpeechSession(QObject * parent = nullptr);
+    ~BtSpeechSession() override;
+
+    /**
+      \brief Stops speaking and starts speaking the given text.
+      \param[in] continuation The texts to speak after the given one, if any.
+    */
+    void speak(QString const & text, Continuation continuation = {});
+
+    /** \brief Stops speaking and ends the session. */
+    void stop();
+
+private: // methods:
+
+    /** \brief Splits the given text into chunks appended to m_chunks. */
+    void appendChunks(QString const & text);
+
+    /** \brief Queues chunks in the engine until enough are queued. */
+    void feed();
+
+    /** \brief Prepares the next text of the continuation, if needed. */
+    void startPrefetch();
+
+private: // fields:
+
+    std::unique_ptr<QTextToSpeech> m_tts;
+    QStringList m_chunks; ///< The chunks not yet queued in the engine
+    int m_queuedChunks = 0; ///< Queued, but not yet being synthesized
+
+    std::shared_ptr<Continuation> m_continuation;
+    std::optional<QString> m_prefetchedText;
+    std::unique_ptr<QThread> m_prefetchThread;
+    std::uint64_t m_generation = 0u;
+
+}; /* class BtSpeechSession */
+
+#endif
@@ -12,8 +12,11 @@
 
 #include "cexportmanager.h"
 
+#include <functional>
+#include <memory>
 #include <QApplication>
 #include <QClipboard>
+#include <QFile>
 #include <QFileDialog>
 #include <QList>
 #include <QProgressDialog>
@@ -37,6 +40,68 @@ using namespace Rendering;
 
 using KTI = CTextRendering::KeyTreeItem;
 
+namespace {
+
+using RendererFactory = std::function<std::unique_ptr<CTextRendering>()>;
+
+/**
+  \brief Renders the given tree into the given file in batches, rendering the
+         batches in parallel.
+  \returns whether the whole tree was saved. If rendering was stopped by the
+           progress callback, the partially written file is removed.
+*/
+bool writeKeyTree(QString const & filename,
+                  CTextRendering::KeyTree const & tree,
+                  RendererFactory const & newRenderer,
+                  std::function<bool(std::size_t)> const & progress)
+{
+    struct UserData {
+        CTextRendering::KeyTree const & tree;
+        RendererFactory const & newRenderer;
+        std::function<bool(std::size_t)> const & progress;
+        bool complete;
+    } userData{tree, newRenderer, progress, false};
+    static auto const writer =
+            +[](QTextStream & out, void * userPtr) {
+                auto & data = *static_cast<UserData *>(userPtr);
+                data.complete =
+                        data.newRenderer()->renderKeyTreeInParallel(
+                            data.tree,
+                            out,
+                            data.newRenderer,
+                            data.progress);
+            };
+    if (!util::tool::savePlainFile(filename, *writer, &userData))
+        return false;
+    if (!userData.complete) {
+        QFile::remove(filename);
+        return false;
+    }
+    return true;
+}
+
+/**
+  \returns the given tree rendered with batches rendered in parallel, or a
+           null string if rendering was stopped by the progress callback.
+*/
+QString renderKeyTree(CTextRendering::KeyTree const & tree,
+                      RendererFactory const & newRenderer,
+                      std::function<bool(std::size_t)> const & progress)
+{
+    QString r;
+    bool complete;
+    {
+        QTextStream out(&r);
+        complete = newRenderer()->renderKeyTreeInParallel(tree,
+                                                          out,
+                                                          newRenderer,
+                                                          progress);
+    }
+    return complete ? r : QString();
+}
+
+} // anonymous namespace
+
 CExportManager::CExportManager(bool const showProgress,
                                QString const & progressLabel,
                                FilterOptions const & filterOptions,
@@ -68,10 +133,22 @@ bool CExportManager::saveKey(CSwordKey const * const key,
     if (filename.isEmpty())
         return false;
 
+    CSwordVerseKey const * const vk =
+            dynamic_cast<CSwordVerseKey const *>(key);
+
+    /* Plain text of ranges, e.g. of whole books, is streamed to the file while
+       being rendered in parallel, since there are no placeholders to fill: */
+    if (format == Text && vk && vk->isBoundSet()
+        && vk->lowerBound() < vk->upperBound())
+        return saveKeyTree(filename,
+                           CTextRendering::keyRangeTree(vk->lowerBound(),
+                                                        vk->upperBound(),
+                                                        modules),
+                           format,
+                           addText);
+
     QString text;
     {
-        CSwordVerseKey const * const vk =
-                dynamic_cast<CSwordVerseKey const *>(key);
         auto const render = newRenderer(format, addText);
         if (vk && vk->isBoundSet()) {
             text = render->renderKeyRange(vk->lowerBound(),
@@ -104,24 +181,17 @@ bool CExportManager::saveKeyList(CSwordModuleSearch::ModuleResultList const & l,
         return false;
 
     CTextRendering::KeyTree tree; /// \todo Verify that items in tree are properly freed.
-
-    setProgressRange(l.size()); /// \todo check size
     KTI::Settings itemSettings;
     itemSettings.highlight = false;
 
-    for (auto const & keyPtr : l) {
-        if (progressWasCancelled())
-            return false;
-        tree.emplace_back(QString::fromLocal8Bit(keyPtr->getText()),
+    for (auto const & key : l)
+        tree.emplace_back(QString::fromLocal8Bit(key.getText()),
                           module,
                           itemSettings);
-        incProgress();
-    }
 
-    QString const text = newRenderer(format, addText)->renderKeyTree(tree);
-    util::tool::savePlainFile(filename, text);
-    closeProgressDialog();
-    return true;
+    if (addText)
+        module->prefetchDataFiles();
+    return saveKeyTree(filename, tree, format, addText);
 }
 
 bool CExportManager::saveKeyList(QList<CSwordKey *> const & list,
@@ -140,18 +210,27 @@ bool CExportManager::saveKeyList(QList<CSwordKey *> const & list,
     KTI::Settings itemSettings;
     itemSettings.highlight = false;
 
-    setProgressRange(list.count());
-    for (CSwordKey const * const k : list) {
-        if (progressWasCancelled())
-            return false;
+    for (CSwordKey const * const k : list)
         tree.emplace_back(k->key(), k->module(), itemSettings);
-        incProgress();
-    }
 
-    QString const text = newRenderer(format, addText)->renderKeyTree(tree);
-    util::tool::savePlainFile(filename, text);
+    return saveKeyTree(filename, tree, format, addText);
+}
+
+bool CExportManager::saveKeyTree(QString const & filename,
+                                 CTextRendering::KeyTree const & tree,
+                                 Format const format,
+                                 bool const addText)
+{
+    setProgressRange(static_cast<int>(tree.size()));
+    bool const r =
+            writeKeyTree(filename,
+                         tree,
+                         [this, format, addText]
+                         { return newRenderer(format, addText); },
+                         [this](std::size_t const rendered)
+                         { return renderingProgressed(rendered); });
     closeProgressDialog();
-    return true;
+    return r;
 }
 
 namespace {
@@ -201,16 +280,26 @@ bool CExportManager::copyKeyList(CSwordModuleSearch::ModuleResultList const & l,
     KTI::Settings itemSettings;
     itemSettings.highlight = false;
 
-    for (auto const & keyPtr : l) {
+    for (auto const & key : l) {
         if (progressWasCancelled())
             return false;
-        tree.emplace_back(QString::fromLocal8Bit(keyPtr->getText()),
+        tree.emplace_back(QString::fromLocal8Bit(key.getText()),
                           module,
                           itemSettings);
     }
 
-    copyToClipboard(newRenderer(format, addText)->renderKeyTree(tree));
+    if (addText)
+        module->prefetchDataFiles();
+    setProgressRange(static_cast<int>(tree.size()));
+    auto const text(renderKeyTree(tree,
+                                  [this, format, addText]
+                                  { return newRenderer(format, addText); },
+                                  [this](std::size_t const rendered)
+                                  { return renderingProgressed(rendered); }));
     closeProgressDialog();
+    if (text.isNull())
+        return false;
+    copyToClipboard(text);
     return true;
 }
 
@@ -226,16 +315,19 @@ bool CExportManager::copyKeyList(QList<CSwordKey *> const & list,
     KTI::Settings itemSettings;
     itemSettings.highlight = false;
 
-    setProgressRange(list.count());
-    for (CSwordKey const * const k : list) {
-        if (progressWasCancelled())
-            return false;
+    for (CSwordKey const * const k : list)
         tree.emplace_back(k->key(), k->module(), itemSettings);
-        incProgress();
-    }
 
-    copyToClipboard(newRenderer(format, addText)->renderKeyTree(tree));
+    setProgressRange(static_cast<int>(tree.size()));
+    auto const text(renderKeyTree(tree,
+                                  [this, format, addText]
+                                  { return newRenderer(format, addText); },
+                                  [this](std::size_t const rendered)
+                                  { return renderingProgressed(rendered); }));
     closeProgressDialog();
+    if (text.isNull())
+        return false;
+    copyToClipboard(text);
     return true;
 }
 
@@ -340,10 +432,10 @@ bool CExportManager::printKeyList(
     BtPrinter::KeyTree tree; /// \todo Verify that items in tree are properly freed.
 
     setProgressRange(list.size());
-    for (auto const & keyPtr : list) {
+    for (auto const & swKey : list) {
         if (progressWasCancelled())
             return false;
-        QString const key = keyPtr->getText();
+        QString const key = swKey.getText();
         tree.emplace_back(key, key, module, settings);
         incProgress();
     }
@@ -395,8 +487,9 @@ const QString CExportManager::getSaveFileName(const Format format) {
                                         nullptr);
 }
 
-std::unique_ptr<CTextRendering> CExportManager::newRenderer(Format const format,
-                                                            bool const addText)
+std::unique_ptr<CTextRendering> CExportManager::newRenderer(
+        Format const format,
+        bool const addText) const
 {
     FilterOptions filterOptions = m_filterOptions;
     filterOptions.footnotes = false;
@@ -435,6 +528,18 @@ void CExportManager::incProgress() {
         m_progressDialog->setValue(m_progressDialog->value() + 1);
 }
 
+void CExportManager::setProgress(int const items) {
+    if (!m_progressDialog)
+        return;
+    m_progressDialog->setValue(items);
+    qApp->processEvents(); //do not lock the GUI!
+}
+
+bool CExportManager::renderingProgressed(std::size_t const rendered) {
+    setProgress(static_cast<int>(rendered));
+    return !progressWasCancelled();
+}
+
 bool CExportManager::progressWasCancelled() {
     return m_progressDialog ? m_progressDialog->wasCanceled() : false;
 }
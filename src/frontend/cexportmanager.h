@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <QList>
 #include <QString>
@@ -19,14 +20,12 @@
 #include "../backend/config/btconfig.h"
 #include "../backend/cswordmodulesearch.h"
 #include "../backend/drivers/btmodulelist.h"
+#include "../backend/rendering/ctextrendering.h"
 
 
 class CSwordKey;
 class CSwordModuleInfo;
 class QProgressDialog;
-namespace Rendering {
-class CTextRendering;
-}
 
 class CExportManager {
 
@@ -107,8 +106,20 @@ protected: // methods:
 
 private: // methods:
 
-    std::unique_ptr<Rendering::CTextRendering> newRenderer(Format const format,
-                                                           bool const addText);
+    /** \note Also called by the threads rendering in parallel. */
+    std::unique_ptr<Rendering::CTextRendering> newRenderer(
+            Format const format,
+            bool const addText) const;
+
+    /**
+      \brief Renders the tree into the given file in batches, which are
+             rendered in parallel, showing the progress of rendering.
+      \returns whether the whole tree was saved.
+    */
+    bool saveKeyTree(QString const & filename,
+                     Rendering::CTextRendering::KeyTree const & tree,
+                     Format const format,
+                     bool const addText);
 
     /** \returns the CSS string used in HTML pages. */
     void setProgressRange(int const items);
@@ -116,6 +127,15 @@ private: // methods:
     /** \brief Increments the progress by one item. */
     void incProgress();
 
+    /** \brief Sets the progress to the given number of items. */
+    void setProgress(int const items);
+
+    /**
+      \brief Sets the progress to the given number of entries rendered.
+      \returns whether rendering should go on, i.e. was not cancelled.
+    */
+    bool renderingProgressed(std::size_t const rendered);
+
     bool progressWasCancelled();
 
     /** \brief Closes the progress dialog immediately. */
@@ -16,15 +16,23 @@
 #include <QAction>
 #include <QLabel>
 #include <QLayout>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
 #include <QSize>
+#include <QStringBuilder>
 #include <QVBoxLayout>
 #include <QtAlgorithms>
 #include <QMenu>
+#include <utility>
 #include "../backend/config/btconfig.h"
 #include "../backend/drivers/cswordmoduleinfo.h"
 #include "../backend/keys/cswordkey.h"
 #include "../backend/managers/colormanager.h"
+#include "../backend/managers/cswordbackend.h"
 #include "../backend/managers/referencemanager.h"
+#include "../backend/rendering/btrendercontext.h"
+#include "../backend/rendering/btrendercontextpool.h"
 #include "../util/btconnect.h"
 #include "bibletime.h"
 #include "bttextbrowser.h"
@@ -34,9 +42,20 @@ using namespace sword;
 
 namespace InfoDisplay {
 
+namespace {
+
+constexpr static qsizetype const BT_MAX_CACHED_INFOS = 256;
+
+bool sameFilterOptions(std::optional<FilterOptions> const & a,
+                       std::optional<FilterOptions> const & b) noexcept
+{ return a ? (b && a->filterOptionsAreEqual(*b)) : !b; }
+
+} // anonymous namespace
+
 CInfoDisplay::CInfoDisplay(BibleTime * parent)
         : QWidget(parent)
         , m_mainWindow(parent)
+        , m_infoCache(BT_MAX_CACHED_INFOS)
 {
     QVBoxLayout * const layout = new QVBoxLayout(this);
     layout->setContentsMargins(2, 2, 2, 2); // Leave small border
@@ -75,9 +94,13 @@ CInfoDisplay::CInfoDisplay(BibleTime * parent)
                    setInfo(key->renderedText(), m->language()->abbrev());
                });
     layout->addWidget(m_textBrowser);
+    BT_CONNECT(&CSwordBackend::instance(), &CSwordBackend::sigSwordSetupChanged,
+               this, [this]{ m_infoCache.clear(); });
     unsetInfo();
 }
 
+CInfoDisplay::~CInfoDisplay() = default;
+
 void CInfoDisplay::unsetInfo() {
     setInfo(tr("<small>This is the Mag viewer area. Hover the mouse over links "
                "or other items which include some data and the contents appear "
@@ -91,14 +114,21 @@ void CInfoDisplay::updateColors() {
     p.setColor(QPalette::Base, ColorManager::getBackgroundColor());
     p.setColor(QPalette::Text, ColorManager::getForegroundColor());
     m_textBrowser->setPalette(p);
+    m_infoCache.clear(); // The colors are part of the rendered infos
 }
 
-void CInfoDisplay::setInfo(const QString & renderedData, const QString & lang) {
+QString CInfoDisplay::finishInfo(QString const & renderedData,
+                                 QString const & lang)
+{
     QString text = Rendering::formatInfo(renderedData, lang);
     text.replace(QStringLiteral("#CHAPTERTITLE#"), QString());
     text.replace(QStringLiteral("#TEXT_ALIGN#"), QStringLiteral("left"));
-    text = ColorManager::replaceColors(text);
-    m_textBrowser->setText(text);
+    return ColorManager::replaceColors(std::move(text));
+}
+
+void CInfoDisplay::setInfo(const QString & renderedData, const QString & lang) {
+    cancelInfoRendering();
+    m_textBrowser->setText(finishInfo(renderedData, lang));
 }
 
 void CInfoDisplay::setInfo(const Rendering::InfoType type, const QString & data) {
@@ -111,16 +141,138 @@ void CInfoDisplay::setInfo(const Rendering::ListInfoData & list) {
         return;
 
     if (list.isEmpty()) {
+        cancelInfoRendering();
         m_textBrowser->setText(QString());
         return;
     }
 
-    BtConstModuleList l;
+    setBrowserFont(m_mainWindow->getCurrentModule());
+    auto request(infoRequest(list));
+    if (auto const * const cached = cachedInfo(request)) {
+        cancelInfoRendering();
+        m_textBrowser->setText(*cached);
+        return;
+    }
+
+    /* Render in the background, replacing any request not yet started. The
+       previous info remains shown until the rendering has finished: */
+    request.generation = ++m_infoGeneration;
+    m_pendingRequest.emplace(std::move(request));
+    startInfoRendering();
+}
+
+void CInfoDisplay::prefetchInfo(Rendering::ListInfoData const & list) {
+    if (!isVisible() || list.isEmpty())
+        return;
+    auto request(infoRequest(list));
+    if (cachedInfo(request) || m_prefetchingInfos.contains(request.cacheKey))
+        return;
+    m_prefetchingInfos.insert(request.cacheKey);
+
+    // The job may outlive this widget, so it does not access it directly:
+    BtRenderContextPool::instance().submit(
+        [self = QPointer<CInfoDisplay>(this),
+         request = std::move(request)](BtRenderContext & context)
+        {
+            auto text(renderInfo(request, context));
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [self,
+                 cacheKey = request.cacheKey,
+                 filterOptions = request.filterOptions,
+                 text = std::move(text)]
+                {
+                    if (!self)
+                        return;
+                    self->m_prefetchingInfos.remove(cacheKey);
+                    self->m_infoCache.insert(
+                                cacheKey,
+                                new CachedInfo{filterOptions, text});
+                },
+                Qt::QueuedConnection);
+        },
+        BtRenderContextPool::Priority::Background);
+}
+
+bool CInfoDisplay::hasCachedInfo(Rendering::ListInfoData const & list) const
+{ return !list.isEmpty() && cachedInfo(infoRequest(list)); }
+
+CInfoDisplay::InfoRequest
+CInfoDisplay::infoRequest(Rendering::ListInfoData const & list) const {
+    QStringList moduleNames;
     const CSwordModuleInfo * m(m_mainWindow->getCurrentModule());
     if(m != nullptr)
-        l.append(m);
-    setBrowserFont(m);
-    setInfo(Rendering::formatInfo(list, l));
+        moduleNames.append(m->name());
+    auto cacheKey(moduleNames.join(u','));
+    for (auto const & info : list)
+        cacheKey += u'\n' % QString::number(info.first) % u':' % info.second;
+    return {list,
+            std::move(moduleNames),
+            Rendering::InfoContext(),
+            CSwordBackend::instance().appliedFilterOptions(),
+            0u,
+            std::move(cacheKey)};
+}
+
+QString const * CInfoDisplay::cachedInfo(InfoRequest const & request) const {
+    if (auto const * const cached = m_infoCache.object(request.cacheKey))
+        if (sameFilterOptions(cached->filterOptions, request.filterOptions))
+            return &cached->text;
+    return nullptr;
+}
+
+QString CInfoDisplay::renderInfo(InfoRequest const & request,
+                                 BtRenderContext & context)
+{
+    // Looking up the modules might recreate the backend:
+    auto const modules(context.findModules(request.moduleNames));
+    auto & backend = context.backend();
+    if (request.filterOptions)
+        backend.setFilterOptions(*request.filterOptions);
+    return finishInfo(
+                Rendering::formatInfo(request.list,
+                                      modules,
+                                      request.context.withBackend(backend)));
+}
+
+void CInfoDisplay::cancelInfoRendering() {
+    ++m_infoGeneration;
+    m_pendingRequest.reset();
+}
+
+void CInfoDisplay::startInfoRendering() {
+    if (!m_pendingRequest || m_rendering)
+        return;
+
+    // The job may outlive this widget, so it does not access it directly:
+    BtRenderContextPool::instance().submit(
+        [self = QPointer<CInfoDisplay>(this),
+         request = std::move(*m_pendingRequest)](BtRenderContext & context)
+        {
+            auto text(renderInfo(request, context));
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [self,
+                 generation = request.generation,
+                 cacheKey = request.cacheKey,
+                 filterOptions = request.filterOptions,
+                 text = std::move(text)]
+                {
+                    if (!self)
+                        return;
+                    self->m_rendering = false;
+                    self->m_infoCache.insert(
+                                cacheKey,
+                                new CachedInfo{filterOptions, text});
+                    if (generation == self->m_infoGeneration)
+                        self->m_textBrowser->setText(text);
+                    self->startInfoRendering();
+                },
+                Qt::QueuedConnection);
+        },
+        BtRenderContextPool::Priority::Interactive);
+    m_pendingRequest.reset();
+    m_rendering = true;
 }
 
 void CInfoDisplay::setInfo(CSwordModuleInfo * const module) {
@@ -14,13 +14,21 @@
 
 #include <QWidget>
 
+#include <cstdint>
+#include <optional>
+#include <QCache>
 #include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "../backend/btglobal.h"
 #include "../backend/rendering/btinforendering.h"
 
 
 class QAction;
 class QSize;
 class BibleTime;
+class BtRenderContext;
 class BtTextBrowser;
 
 namespace InfoDisplay {
@@ -32,11 +40,22 @@ class CInfoDisplay: public QWidget {
 public: // methods:
 
     CInfoDisplay(BibleTime * parent = nullptr);
+    ~CInfoDisplay() override;
 
     void unsetInfo();
     void setInfo(const QString & renderedData,
                  const QString & lang = QString());
     void setInfo(Rendering::ListInfoData const &);
+
+    /**
+      \brief Renders the given infos in the background, so that setInfo()
+             shows them right away later.
+    */
+    void prefetchInfo(Rendering::ListInfoData const & list);
+
+    /** \returns whether setInfo() would show the given infos right away. */
+    bool hasCachedInfo(Rendering::ListInfoData const & list) const;
+
     QSize sizeHint() const override;
     void updateColors();
 
@@ -45,14 +64,63 @@ public Q_SLOTS:
     void setInfo(Rendering::InfoType const, QString const & data);
     void setInfo(CSwordModuleInfo * module);
 
+private: // types:
+
+    /** An info to render in the background. */
+    struct InfoRequest {
+        Rendering::ListInfoData list;
+        QStringList moduleNames;
+        Rendering::InfoContext context;
+        std::optional<FilterOptions> filterOptions;
+        std::uint64_t generation;
+        QString cacheKey;
+    };
+
+    /** An info rendered for the filter options it was rendered with. */
+    struct CachedInfo {
+        std::optional<FilterOptions> filterOptions;
+        QString text;
+    };
+
 private:
     void setBrowserFont(const CSwordModuleInfo* const module);
 
+    /** \brief Cancels any info being rendered in the background. */
+    void cancelInfoRendering();
+
+    /** \brief Starts rendering the pending info request, if any. */
+    void startInfoRendering();
+
+    /** \returns a request to render the given infos with the current module. */
+    InfoRequest infoRequest(Rendering::ListInfoData const & list) const;
+
+    /** \returns the cached rendering of the given request, if any. */
+    QString const * cachedInfo(InfoRequest const & request) const;
+
+    static QString renderInfo(InfoRequest const & request,
+                              BtRenderContext & context);
+
+    static QString finishInfo(QString const & renderedData,
+                              QString const & lang = QString());
+
 private: // fields:
 
     BtTextBrowser * m_textBrowser;
     BibleTime * m_mainWindow;
 
+    /**
+      Infos are rendered in the background one at a time. While rendering, only
+      the most recent request is kept pending, and results are shown only if no
+      other info was set in the meantime.
+    */
+    bool m_rendering = false;
+    std::optional<InfoRequest> m_pendingRequest;
+    std::uint64_t m_infoGeneration = 0u;
+
+    /** The infos rendered recently, by InfoRequest::cacheKey. */
+    QCache<QString, CachedInfo> m_infoCache;
+    QSet<QString> m_prefetchingInfos; ///< By InfoRequest::cacheKey
+
 };
 
 } //end of InfoDisplay namespace
@@ -19,6 +19,7 @@
 #include <QMdiSubWindow>
 #include <QMenu>
 #include <QPoint>
+#include <QPointer>
 #include <QRect>
 #include <QSize>
 #include <QStyle>
@@ -38,6 +39,47 @@ inline CDisplayWindow * getDisplayWindow(const QMdiSubWindow * const mdiWindow)
     return qobject_cast<CDisplayWindow *>(mdiWindow->widget());
 }
 
+/**
+  \brief Batches the geometry changes of arranging subwindows.
+
+  Until destroyed, the lookups of the windows are deferred and their displays
+  keep the size of their QML views, so that every display is laid out and
+  rendered only once, at its final size.
+*/
+class ArrangementBatch {
+
+public: // methods:
+
+    explicit ArrangementBatch(QList<QMdiSubWindow *> const & subWindows) {
+        for (auto * const subWindow : subWindows) {
+            auto * const window = getDisplayWindow(subWindow);
+            if (!window)
+                continue;
+            m_windows.append(window);
+            window->displayWidget()->freezeLayout();
+            if (!window->lookupDeferred()) {
+                window->deferLookup();
+                m_deferredWindows.append(window);
+            }
+        }
+    }
+
+    ~ArrangementBatch() {
+        for (auto const & window : m_windows)
+            if (window)
+                window->displayWidget()->thawLayout();
+        for (auto const & window : m_deferredWindows)
+            if (window)
+                window->resumeLookup();
+    }
+
+private: // fields:
+
+    QList<QPointer<CDisplayWindow>> m_windows;
+    QList<QPointer<CDisplayWindow>> m_deferredWindows;
+
+};
+
 } // anonymous namespace
 
 
@@ -162,6 +204,7 @@ void CMDIArea::myTileVertical() {
     setViewMode(QMdiArea::SubWindowView);
 
     setUpdatesEnabled(false);
+    ArrangementBatch const batch(windows);
 
     QMdiSubWindow * const active = activeSubWindow();
 
@@ -196,6 +239,7 @@ void CMDIArea::myTileHorizontal() {
     setViewMode(QMdiArea::SubWindowView);
 
     setUpdatesEnabled(false);
+    ArrangementBatch const batch(windows);
     QMdiSubWindow * const active = activeSubWindow();
 
     const int heightForEach = height() / windows.count();
@@ -230,6 +274,7 @@ void CMDIArea::myTile() {
     setViewMode(QMdiArea::SubWindowView);
 
     setUpdatesEnabled(false);
+    ArrangementBatch const batch(windows);
     QMdiSubWindow * const active = activeSubWindow();
 
     const QRect domain = contentsRect();
@@ -289,6 +334,7 @@ void CMDIArea::myCascade() {
     }
     else {
         setUpdatesEnabled(false);
+        ArrangementBatch const batch(windows);
 
         QMdiSubWindow * const active = activeSubWindow();
 
@@ -415,24 +461,32 @@ bool CMDIArea::eventFilter(QObject *o, QEvent *e) {
 }
 
 void CMDIArea::triggerWindowUpdate() {
-    if (updatesEnabled()) {
-        switch (m_mdiArrangementMode) {
-            case ArrangementModeTileVertical:
-                QTimer::singleShot(0, this, &CMDIArea::myTileVertical);
-                break;
-            case ArrangementModeTileHorizontal:
-                QTimer::singleShot(0, this, &CMDIArea::myTileHorizontal);
-                break;
-            case ArrangementModeTile:
-                QTimer::singleShot(0, this, &CMDIArea::myTile);
-                break;
-            case ArrangementModeCascade:
-                QTimer::singleShot(0, this, &CMDIArea::myCascade);
-                break;
-            default:
-                break;
-        }
-    }
+    // Resizing the main window triggers updates repeatedly:
+    if (!updatesEnabled() || m_windowUpdatePending)
+        return;
+    m_windowUpdatePending = true;
+    QTimer::singleShot(
+        0,
+        this,
+        [this]{
+            m_windowUpdatePending = false;
+            switch (m_mdiArrangementMode) {
+                case ArrangementModeTileVertical:
+                    myTileVertical();
+                    break;
+                case ArrangementModeTileHorizontal:
+                    myTileHorizontal();
+                    break;
+                case ArrangementModeTile:
+                    myTile();
+                    break;
+                case ArrangementModeCascade:
+                    myCascade();
+                    break;
+                default:
+                    break;
+            }
+        });
 }
 
 void CMDIArea::enableWindowMinMaxFlags(bool enable)
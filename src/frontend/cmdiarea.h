@@ -76,7 +76,8 @@ class CMDIArea: public QMdiArea {
         { return m_mdiArrangementMode; }
 
         /**
-        * Forces an update of the currently chosen window arrangement.
+        * Forces an update of the currently chosen window arrangement. Updates
+        * triggered before the arrangement is applied are merged.
         */
         void triggerWindowUpdate();
 
@@ -166,5 +167,6 @@ class CMDIArea: public QMdiArea {
 
         CDisplayWindow* m_activeWindow;
         BibleTime* m_bibleTime;
+        bool m_windowUpdatePending = false;
 
 }; /* class CMDIArea */
@@ -13,6 +13,7 @@
 #include "btmodelviewreaddisplay.h"
 
 #include <memory>
+#include <optional>
 #include <QClipboard>
 #include <QDebug>
 #include <QDrag>
@@ -29,10 +30,14 @@
 #include <QTimer>
 #include <QToolBar>
 #include <utility>
+#include "../../backend/config/btconfig.h"
 #include "../../backend/keys/cswordkey.h"
+#include "../../backend/keys/cswordversekey.h"
 #include "../../backend/drivers/cswordbiblemoduleinfo.h"
 #include "../../backend/managers/cswordbackend.h"
 #include "../../backend/managers/referencemanager.h"
+#include "../../backend/models/btmoduletextmodel.h"
+#include "../../backend/rendering/btrendercontextpool.h"
 #include "../../util/btassert.h"
 #include "../../util/btconnect.h"
 #include "../../util/tool.h"
@@ -149,7 +154,15 @@ void BtModelViewReadDisplay::slotSliderReleased() {
 void BtModelViewReadDisplay::copyAsPlainText(TextPart const part)
 { QGuiApplication::clipboard()->setText(text(part)); }
 
+void BtModelViewReadDisplay::freezeLayout()
+{ m_quickWidget->setResizeMode(QQuickWidget::SizeViewToRootObject); }
+
+void BtModelViewReadDisplay::thawLayout()
+{ m_quickWidget->setResizeMode(QQuickWidget::SizeRootObjectToView); }
+
 void BtModelViewReadDisplay::contextMenuEvent(QContextMenuEvent * event) {
+    if (!m_popup && m_createPopup)
+        m_popup = std::exchange(m_createPopup, nullptr)();
     if (m_popup)
         m_popup->exec(event->globalPos());
 }
@@ -253,8 +266,55 @@ void BtModelViewReadDisplay::print(TextPart const type,
 
 #ifdef BUILD_TEXT_TO_SPEECH
 void BtModelViewReadDisplay::speakSelectedText() {
-    if (auto const * const qml = qmlInterface(); qml && qml->selection())
-        BibleTime::instance()->speakText(qml->getSelectedText());
+    auto const * const qml = qmlInterface();
+    if (!qml || !qml->selection())
+        return;
+
+    /* Optionally continue with the chapters after the selection, each of
+       which is prepared while the previous text is spoken: */
+    BtSpeechSession::Continuation continuation;
+    auto const * const windowKey = m_parentWindow->swordKey();
+    if (windowKey
+        && windowKey->module()
+        && windowKey->module()->type() == CSwordModuleInfo::Bible
+        && btConfig().value<bool>(
+               QStringLiteral("GUI/ttsContinueWithNextChapter"), false))
+    {
+        auto const key(qml->textModel()->indexToVerseKey(
+                           qml->selection()->endIndex));
+        continuation =
+            [moduleName = windowKey->module()->name(),
+             chapterKey = key.key()]() mutable -> std::optional<QString>
+            {
+                auto const context(
+                        Rendering::BtRenderContextPool::instance().acquire());
+                auto const * const bible =
+                        dynamic_cast<CSwordBibleModuleInfo const *>(
+                            context->findModule(moduleName));
+                if (!bible)
+                    return {};
+                CSwordVerseKey k(bible);
+                k.setKey(chapterKey);
+                if (!k.next(CSwordVerseKey::UseChapter))
+                    return {};
+                chapterKey = k.key();
+
+                context->backend().setFilterOptions(FilterOptions());
+                auto const verses =
+                        bible->verseCount(bible->bookNumber(k.bookName()),
+                                          static_cast<unsigned>(k.chapter()));
+                QString text;
+                QString verse;
+                for (unsigned v = 1u; v <= verses; ++v) {
+                    k.setVerse(static_cast<int>(v));
+                    k.strippedTextInto(verse);
+                    text.append(verse.trimmed()).append(u' ');
+                }
+                return text;
+            };
+    }
+    BibleTime::instance()->speakText(qml->getSelectedText(),
+                                     std::move(continuation));
 }
 #endif
 
@@ -339,6 +399,9 @@ void BtModelViewReadDisplay::scrollToKey(CSwordKey * key) {
 
 void BtModelViewReadDisplay::scroll(int value) { m_quickWidget->scroll(value); }
 
+void BtModelViewReadDisplay::setAutoScrollVelocity(double const pixelsPerSecond)
+{ m_quickWidget->setAutoScrollVelocity(pixelsPerSecond); }
+
 void BtModelViewReadDisplay::settingsChanged() {
     m_qmlInterface->settingsChanged();
 }
@@ -14,6 +14,8 @@
 
 #include <QWidget>
 
+#include <functional>
+#include <utility>
 #include "../../backend/btglobal.h"
 
 
@@ -124,8 +126,20 @@ public: // methods:
     /**
         \brief Installs the popup which should be opened when the right mouse
                button was pressed.
+        \param[in] createPopup Creates the popup once it is first needed.
     */
-    void installPopup(QMenu * const popup) { m_popup = popup; }
+    void installPopup(std::function<QMenu * ()> createPopup)
+    { m_createPopup = std::move(createPopup); }
+
+    /**
+        \brief Keeps the QML view at its size until thawLayout(), so that its
+               rows are laid out only once while the window is resized
+               repeatedly, e.g. when arranging the windows.
+    */
+    void freezeLayout();
+
+    /** \brief Resizes the QML view to its widget again, see freezeLayout(). */
+    void thawLayout();
 
     /**
        \param[in] format The format to use for the text.
@@ -155,6 +169,9 @@ public: // methods:
 
     void scroll(int pixels);
 
+    /** \see BtQuickWidget::setAutoScrollVelocity() */
+    void setAutoScrollVelocity(double pixelsPerSecond);
+
     void setNodeInfo(QString const & newNodeInfo);
 
     void setModules(QStringList const & modules);
@@ -187,6 +204,7 @@ private: /* Methods: */
 private: // fields:
 
     CDisplayWindow* m_parentWindow;
+    std::function<QMenu * ()> m_createPopup;
     QMenu * m_popup = nullptr;
     QString m_activeAnchor; //< Holds the current anchor
 
@@ -17,9 +17,9 @@ Item {
     id: columnView
 
     property alias length: columnText.length
-    property color textColor: BtQmlInterface.foregroundColor
-    property color textBackgroundColor: BtQmlInterface.backgroundColor
-    property color textBackgroundHighlightColor: BtQmlInterface.backgroundHighlightColor
+    property color textColor: btQmlInterface.foregroundColor
+    property color textBackgroundColor: btQmlInterface.backgroundColor
+    property color textBackgroundHighlightColor: btQmlInterface.backgroundHighlightColor
     required property font font
 
     signal hovered(string link);
@@ -69,7 +69,7 @@ Item {
         anchors.left: parent.left
         anchors.right: parent.right
         color: (listView.backgroundHighlightIndex === index)? textBackgroundHighlightColor: textBackgroundColor
-        border.width: (BtQmlInterface.moduleIsWritable(columnView.column))? 1 : 0
+        border.width: (btQmlInterface.moduleIsWritable(columnView.column))? 1 : 0
         border.color: "gray"
     }
 
@@ -98,7 +98,9 @@ Item {
         text: {
             var isHtml = displayView.textIsHtml(displayText);
             textFormat = isHtml;
-            return displayText;
+            if (isHtml === Text.PlainText)
+                return displayText;
+            return btQmlInterface.scaledImages(displayText, columnView.width);
         }
         visible: listView.columns > 0
         width: columnView.width
@@ -15,9 +15,9 @@ import QtQuick 2.2
 
 Item {
     id: delegate
-    property int spacing: 1.5 * BtQmlInterface.pixelsPerMM
+    property int spacing: 1.5 * btQmlInterface.pixelsPerMM
     property int textWidth: (listView.width / listView.columns)
-    property int vertSpace: 1 * BtQmlInterface.pixelsPerMM
+    property int vertSpace: 1 * btQmlInterface.pixelsPerMM
     property bool updating: false
     required property int index
     required property string text0
@@ -59,7 +59,7 @@ Item {
 
     function dragStart(index, active) {
         if (active) {
-            BtQmlInterface.dragHandler(index);
+            btQmlInterface.dragHandler(index);
         }
     }
 
@@ -114,9 +114,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: delegate.left
-        font: BtQmlInterface.font0
+        font: btQmlInterface.font0
         width: delegate.textWidth
-        onHovered: function(link) { BtQmlInterface.setHoveredLink(link) }
+        onHovered: function(link) { btQmlInterface.setHoveredLink(link) }
     }
 
     ColumnItem {
@@ -127,9 +127,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView0.right
-        font: BtQmlInterface.font1
+        font: btQmlInterface.font1
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -140,9 +140,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView1.right
-        font: BtQmlInterface.font2
+        font: btQmlInterface.font2
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -153,9 +153,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView2.right
-        font: BtQmlInterface.font3
+        font: btQmlInterface.font3
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -166,9 +166,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView3.right
-        font: BtQmlInterface.font4
+        font: btQmlInterface.font4
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -179,9 +179,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView4.right
-        font: BtQmlInterface.font5
+        font: btQmlInterface.font5
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -192,9 +192,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView5.right
-        font: BtQmlInterface.font6
+        font: btQmlInterface.font6
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -205,9 +205,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView6.right
-        font: BtQmlInterface.font7
+        font: btQmlInterface.font7
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -218,9 +218,9 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView7.right
-        font: BtQmlInterface.font8
+        font: btQmlInterface.font8
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 
     ColumnItem {
@@ -231,8 +231,8 @@ Item {
         anchors.top: delegate.top
         anchors.bottom: delegate.bottom
         anchors.left: columnView8.right
-        font: BtQmlInterface.font9
+        font: btQmlInterface.font9
         width: delegate.textWidth
-        onHovered: BtQmlInterface.setHoveredLink(link)
+        onHovered: btQmlInterface.setHoveredLink(link)
     }
 }
@@ -11,7 +11,7 @@
 **********/
 
 import BibleTime 1.0
-import QtQuick 2.10
+import QtQuick 6.4
 
 Rectangle {
     id: displayView
@@ -91,10 +91,10 @@ Rectangle {
             deselectCurrentSelection();
             selectionStart = null;
             selectionEnd = null;
-            BtQmlInterface.clearSelection();
+            btQmlInterface.clearSelection();
 
             draggingInProgress = true;
-            BtQmlInterface.dragHandler(mousePressedItemIndex, pressedLink);
+            btQmlInterface.dragHandler(mousePressedItemIndex, pressedLink);
             return; // Prevent starting of selection
         }
 
@@ -102,7 +102,7 @@ Rectangle {
             if (mousePressedTextPosition < 0) // Does not start selection
                 return;
             deselectCurrentSelection(); /// \todo This can be optimized
-            BtQmlInterface.clearSelection();
+            btQmlInterface.clearSelection();
             selectionInProgress = true;
             selectionStart = {
                 columnIndex: mousePressedColumnIndex,
@@ -163,7 +163,7 @@ Rectangle {
     // whole of the selected text. Hence we just recreate the respective
     // TextView QML widgets here to retrieve the selected texts.
     function selectedFromTextEdit(row, column, selectCallback) {
-        const rawText = BtQmlInterface.rawText(row, column);
+        const rawText = btQmlInterface.rawText(row, column);
         const item = Qt.createQmlObject(
                 'import QtQuick 2.10; TextEdit { visible: false }',
                 displayView); // parent
@@ -194,10 +194,10 @@ Rectangle {
                 if (end.textPosition < start.textPosition) {
                     [start, end] = [end, start];
                 } else if (end.textPosition == start.textPosition) {
-                    BtQmlInterface.clearSelection();
+                    btQmlInterface.clearSelection();
                     return;
                 }
-                BtQmlInterface.setSelection(
+                btQmlInterface.setSelection(
                         start.columnIndex,
                         start.itemIndex,
                         start.itemIndex,
@@ -225,7 +225,7 @@ Rectangle {
                         end.itemIndex,
                         start.columnIndex,
                         (item) => item.select(0, end.textPosition)));
-            BtQmlInterface.setSelection(
+            btQmlInterface.setSelection(
                     start.columnIndex,
                     start.itemIndex,
                     end.itemIndex,
@@ -236,12 +236,12 @@ Rectangle {
         deselectCurrentSelection();
         selectionStart = null;
         selectionEnd = null;
-        BtQmlInterface.clearSelection();
+        btQmlInterface.clearSelection();
 
         if (openPersonalCommentary(mousePressedX, mousePressedY))
             return;
         if (isBibleReference(pressedLink))
-            BtQmlInterface.setBibleKey(pressedLink);
+            btQmlInterface.setBibleKey(pressedLink);
     }
 
     function isBibleReference(url) {
@@ -264,6 +264,10 @@ Rectangle {
         listView.scroll(value);
     }
 
+    function setAutoScrollVelocity(velocity) {
+        listView.autoScrollVelocity = velocity;
+    }
+
     function isBlank(text) {
         var t = text;
         t.trim();
@@ -286,22 +290,27 @@ Rectangle {
     }
 
     Component.onCompleted: {
-        BtQmlInterface.positionItemOnScreen.connect(handlePositionItemOnScreen);
+        btQmlInterface.positionItemOnScreen.connect(handlePositionItemOnScreen);
     }
 
     width: 10
     height: 10
-    color: BtQmlInterface.backgroundColor
+    color: btQmlInterface.backgroundColor
 
     ListView {
         id: listView
 
-        property color textColor: BtQmlInterface.foregroundColor
-        property color textBackgroundColor: BtQmlInterface.backgroundColor
-        property int columns: BtQmlInterface.numModules
+        property color textColor: btQmlInterface.foregroundColor
+        property color textBackgroundColor: btQmlInterface.backgroundColor
+        property int columns: btQmlInterface.numModules
         property int savedRow: 0
         property int savedColumn: 0
-        property int backgroundHighlightIndex: BtQmlInterface.backgroundHighlightColorIndex
+        property int backgroundHighlightIndex: btQmlInterface.backgroundHighlightColorIndex
+        // The velocity of auto scrolling in pixels per second, negative when
+        // scrolling up:
+        property real autoScrollVelocity: 0
+        property int autoScrollTopIndex: -1
+        property int autoScrollEdgeIndex: -1
 
         function scroll(value) {
             var y = contentY;
@@ -309,25 +318,25 @@ Rectangle {
         }
 
         function startEdit(row, column) {
-            if (!BtQmlInterface.moduleIsWritable(column))
+            if (!btQmlInterface.moduleIsWritable(column))
                 return false;
-            if (BtQmlInterface.indexToVerse(row) === 0 )
+            if (btQmlInterface.indexToVerse(row) === 0 )
                 return false;
             savedRow = row;
             savedColumn = column;
-            BtQmlInterface.openEditor(row, column);
+            btQmlInterface.openEditor(row, column);
             return true;
         }
 
         function finishEdit(newText) {
-            BtQmlInterface.setRawText(savedRow, savedColumn, newText)
+            btQmlInterface.setRawText(savedRow, savedColumn, newText)
         }
 
         function updateReferenceText() {
             var index = indexAt(contentX,contentY+30);
             if (index < 0)
                 return;
-            BtQmlInterface.changeReference(index);
+            btQmlInterface.changeReference(index);
         }
 
         clip: true
@@ -337,24 +346,75 @@ Rectangle {
         anchors.topMargin: 0
         anchors.bottomMargin: 0
         boundsMovement: Flickable.StopAtBounds
+        // Keep the delegates of the rows around the viewport and reuse the
+        // others instead of laying out their (possibly complex script) text
+        // again whenever a row scrolls into view. The rows kept are about
+        // those prefetched by the model, estimated from the average row
+        // height and rounded to whole view heights to not update the buffer
+        // whenever the estimate changes:
+        cacheBuffer: {
+            const rowHeight = count > 0 ? contentHeight / count : 0;
+            const views = Math.ceil(btQmlInterface.prefetchRows * rowHeight
+                                    / Math.max(height, 1));
+            return Math.min(Math.max(views, 1), 4) * height;
+        }
+        reuseItems: true
         focus: true
         maximumFlickVelocity: 900
-        model: BtQmlInterface.textModel
+        model: btQmlInterface.textModel
         spacing: 2
         highlightFollowsCurrentItem: true
-        currentIndex: BtQmlInterface.currentModelIndex
+        currentIndex: btQmlInterface.currentModelIndex
         onCurrentIndexChanged: {
             positionViewAtIndex(currentIndex,ListView.Beginning)
         }
         onMovementEnded: {
             updateReferenceText();
         }
+        onContentYChanged: {
+            var index = indexAt(contentX, contentY);
+            if (index >= 0)
+                btQmlInterface.setViewportIndex(index);
+        }
+
+        // Auto scrolling is driven by the frame clock of the window, so it
+        // only runs when a frame is due and moves by fractions of pixels:
+        FrameAnimation {
+            running: listView.autoScrollVelocity < 0
+                     ? !listView.atYBeginning
+                     : (listView.autoScrollVelocity > 0 && !listView.atYEnd)
+            onTriggered: {
+                const velocity = listView.autoScrollVelocity;
+                listView.contentY += velocity * frameTime;
+
+                const topIndex = listView.indexAt(listView.contentX,
+                                                  listView.contentY + 30);
+                if (topIndex >= 0 && topIndex !== listView.autoScrollTopIndex) {
+                    listView.autoScrollTopIndex = topIndex;
+                    listView.updateReferenceText();
+                }
+
+                // Request the rows about to scroll into view once per row:
+                const edgeIndex =
+                    listView.indexAt(listView.contentX,
+                                     velocity > 0
+                                     ? listView.contentY + listView.height
+                                     : listView.contentY);
+                if (edgeIndex >= 0
+                    && edgeIndex !== listView.autoScrollEdgeIndex)
+                {
+                    listView.autoScrollEdgeIndex = edgeIndex;
+                    btQmlInterface.prefetchRows(edgeIndex,
+                                                velocity > 0 ? 1 : -1);
+                }
+            }
+        }
 
         delegate: DisplayDelegate {
-            // Due to the delegates being destroyed and re-created when the
-            // ListView is scrolled or flicked, we need to re-apply the
-            // any selection to the newly recreated delegates.
-            Component.onCompleted: {
+            // Due to the delegates being re-created or reused for other rows
+            // when the ListView is scrolled or flicked, we need to re-apply
+            // any selection to the new delegates.
+            function restoreSelection() {
                 if (selectionStart === null || selectionEnd === null)
                     return;
                 /// \todo support multi-column selections:
@@ -385,6 +445,13 @@ Rectangle {
                     columnItem.selectAll();
                 }
             }
+
+            Component.onCompleted: restoreSelection()
+            ListView.onPooled: {
+                for (let i = 0; i < listView.columns; ++i)
+                    deselect(i);
+            }
+            ListView.onReused: restoreSelection()
         }
     }
 }
@@ -0,0 +1,235 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btimageprovider.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <QByteArray>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+#include <QSaveFile>
+#include <QUrl>
+#include <utility>
+#include "../../../backend/bttaskscheduler.h"
+#include "../../../util/directory.h"
+
+
+//Increment this, if the format of the thumbnails changes
+constexpr static int const BT_IMAGE_THUMBNAIL_VERSION = 1;
+
+//Maximum size of the decoded images kept in memory by all windows together
+constexpr static qsizetype const BT_MAX_CACHED_IMAGES_KIB = 64 * 1024;
+
+//The widths images are scaled to are multiples of this
+constexpr static int const BT_IMAGE_WIDTH_STEP = 64;
+
+namespace {
+
+struct ImageCache {
+    std::mutex mutex;
+    QCache<QString, QImage> images{BT_MAX_CACHED_IMAGES_KIB};
+};
+
+ImageCache & imageCache() {
+    static ImageCache cache;
+    return cache;
+}
+
+QString thumbnailFileName(QFileInfo const & info, int const width) {
+    auto const key(
+            QStringLiteral("%1\n%2\n%3\n%4\n%5").arg(
+                QString::number(BT_IMAGE_THUMBNAIL_VERSION),
+                info.absoluteFilePath(),
+                QString::number(info.lastModified().toMSecsSinceEpoch()),
+                QString::number(info.size()),
+                QString::number(width)).toUtf8());
+    return QStringLiteral("%1/images/%2.png").arg(
+                util::directory::getUserCacheDir().absolutePath(),
+                QString::fromLatin1(
+                    QCryptographicHash::hash(key, QCryptographicHash::Sha1)
+                    .toHex()));
+}
+
+/**
+  \returns the image of the given file scaled down to at most the given
+           width, from the memory cache or the thumbnail if possible.
+*/
+QImage decodeImage(QString const & fileName, int const width) {
+    QFileInfo const info(fileName);
+    auto const cacheKey(QStringLiteral("%1\n%2").arg(QString::number(width),
+                                                      fileName));
+    auto & cache = imageCache();
+    {
+        std::lock_guard<std::mutex> const guard(cache.mutex);
+        if (auto const * const image = cache.images.object(cacheKey))
+            return *image;
+    }
+
+    auto const thumbnail(thumbnailFileName(info, width));
+    QImage image(thumbnail);
+    if (image.isNull()) {
+        QImageReader reader(fileName);
+        reader.setAutoTransform(true);
+        auto const size = reader.size();
+        bool const scaled = size.isValid() && size.width() > width;
+        if (scaled)
+            reader.setScaledSize(size.scaled(width,
+                                             size.height(),
+                                             Qt::KeepAspectRatio));
+        if (!reader.read(&image))
+            return {};
+
+        // Keep the images scaled down from large originals:
+        if (scaled && QDir().mkpath(QFileInfo(thumbnail).absolutePath())) {
+            QSaveFile file(thumbnail);
+            if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG"))
+                file.commit();
+        }
+    }
+
+    std::lock_guard<std::mutex> const guard(cache.mutex);
+    cache.images.insert(
+                cacheKey,
+                new QImage(image),
+                static_cast<qsizetype>(image.sizeInBytes() / 1024 + 1));
+    return image;
+}
+
+/**
+  \brief Decodes an image by BtTaskScheduler.
+
+  The engine deletes the response only after finished() was emitted, even if
+  cancelled. The state is shared with the task, which skips decoding if the
+  response was cancelled meanwhile.
+*/
+class ImageResponse final: public QQuickImageResponse {
+
+public: // methods:
+
+    ImageResponse(QString fileName, int const width)
+        : m_state(std::make_shared<State>())
+    {
+        m_state->response = this;
+        BtTaskScheduler::instance().submit(
+                    [state = m_state,
+                     fileName = std::move(fileName),
+                     width](BtTaskToken &)
+                    {
+                        QImage image;
+                        if (!state->cancelled.load(std::memory_order_relaxed))
+                            image = decodeImage(fileName, width);
+                        std::lock_guard<std::mutex> const guard(state->mutex);
+                        if (state->response) {
+                            state->response->m_image = std::move(image);
+                            Q_EMIT state->response->finished();
+                        }
+                    },
+                    BtTaskScheduler::Priority::Interactive);
+    }
+
+    ~ImageResponse() override {
+        std::lock_guard<std::mutex> const guard(m_state->mutex);
+        m_state->response = nullptr;
+    }
+
+    QQuickTextureFactory * textureFactory() const override
+    { return QQuickTextureFactory::textureFactoryForImage(m_image); }
+
+    QString errorString() const override {
+        return m_image.isNull()
+               ? QStringLiteral("Failed to decode the image.")
+               : QString();
+    }
+
+    void cancel() override
+    { m_state->cancelled.store(true, std::memory_order_relaxed); }
+
+private: // types:
+
+    struct State {
+        std::mutex mutex;
+        ImageResponse * response;
+        std::atomic<bool> cancelled{false};
+    };
+
+private: // fields:
+
+    std::shared_ptr<State> const m_state;
+    QImage m_image;
+
+};
+
+} // anonymous namespace
+
+QString BtImageProvider::id() { return QStringLiteral("btimages"); }
+
+QString BtImageProvider::scaledImages(QString const & text, int const width) {
+    if (!text.contains(QStringLiteral("<img")))
+        return text;
+
+    // Request fewer sizes while the columns are resized:
+    auto const w =
+            std::max((width + BT_IMAGE_WIDTH_STEP - 1) / BT_IMAGE_WIDTH_STEP, 1)
+            * BT_IMAGE_WIDTH_STEP;
+
+    // The filters refer to local images by file URLs or absolute paths:
+    static QRegularExpression const rx(
+                QStringLiteral(R"PCRE(<img src="((?:file://)?/[^"]+)")PCRE"));
+    QString r;
+    qsizetype last = 0;
+    for (auto it = rx.globalMatch(text); it.hasNext();) {
+        auto const match = it.next();
+        auto const src = match.captured(1);
+        auto const fileName = src.startsWith(QStringLiteral("file://"))
+                              ? QUrl(src).toLocalFile()
+                              : src;
+        r.append(QStringView(text).mid(last, match.capturedStart(1) - last))
+         .append(QStringLiteral("image://%1/%2/").arg(id(),
+                                                      QString::number(w)))
+         .append(QString::fromLatin1(
+                     fileName.toUtf8().toBase64(
+                         QByteArray::Base64UrlEncoding
+                         | QByteArray::OmitTrailingEquals)));
+        last = match.capturedEnd(1);
+    }
+    r.append(QStringView(text).mid(last));
+    return r;
+}
+
+QQuickImageResponse * BtImageProvider::requestImageResponse(
+        QString const & id,
+        QSize const & requestedSize)
+{
+    // The identifiers are "<width>/<file name in Base64>":
+    auto const separator = id.indexOf(u'/');
+    auto width = QStringView(id).left(separator).toInt();
+    if (requestedSize.width() > 0)
+        width = std::min(width, requestedSize.width());
+    auto fileName(
+            QString::fromUtf8(
+                QByteArray::fromBase64(
+                    id.mid(separator + 1).toLatin1(),
+                    QByteArray::Base64UrlEncoding
+                    | QByteArray::OmitTrailingEquals)));
+    return new ImageResponse(std::move(fileName), std::max(width, 1));
+}
@@ -0,0 +1,52 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QQuickImageProvider>
+
+#include <QSize>
+#include <QString>
+
+
+class QQuickImageResponse;
+
+/**
+  \brief Decodes the images of modules, e.g. of maps and atlases, for the
+         display windows in background threads.
+
+  The images of the texts rewritten by scaledImages() are requested from this
+  provider instead of being decoded by the text delegates in the GUI thread.
+  The images are decoded by BtTaskScheduler and scaled down to the width of
+  the column. The decoded images are kept in a cache of a limited size shared
+  by all windows. The images scaled down are also saved as thumbnails in the
+  user cache directory, so that the large originals need not be decoded
+  again in later sessions.
+*/
+class BtImageProvider final: public QQuickAsyncImageProvider {
+
+public: // methods:
+
+    /** \returns the identifier the provider is added to the QML engine by. */
+    static QString id();
+
+    /**
+      \returns the given HTML text with the local images referring to this
+               provider, scaled down to at most the given width.
+    */
+    static QString scaledImages(QString const & text, int width);
+
+    QQuickImageResponse * requestImageResponse(
+            QString const & id,
+            QSize const & requestedSize) override;
+
+}; /* class BtImageProvider */
@@ -12,11 +12,16 @@
 
 #include "btqmlinterface.h"
 
+#include <algorithm>
+#include <memory>
 #include <QApplication>
 #include <QClipboard>
+#include <QProgressDialog>
 #include <QScreen>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QSet>
+#include <QTextStream>
 #include <QTimerEvent>
 #include <utility>
 #include "../../../backend/config/btconfig.h"
@@ -26,21 +31,68 @@
 #include "../../../backend/keys/cswordkey.h"
 #include "../../../backend/managers/colormanager.h"
 #include "../../../backend/managers/cswordbackend.h"
+#include "../../../backend/managers/referencemanager.h"
+#include "../../../backend/models/btmoduletextfinder.h"
 #include "../../../backend/rendering/btinforendering.h"
 #include "../../../backend/rendering/cplaintextexportrendering.h"
 #include "../../../backend/rendering/ctextrendering.h"
 #include "../../../backend/rendering/btinforendering.h"
 #include "../../../util/btassert.h"
+#include "../../../util/btconnect.h"
 #include "../../bibletime.h"
-#include "../../btmoduleindexdialog.h"
 #include "../../cinfodisplay.h"
 #include "../../edittextwizard/btedittextwizard.h"
+#include "btimageprovider.h"
 
 
+//Number of entries copied by copyRange() between updates of the progress
+constexpr static int const BT_COPY_PROGRESS_INTERVAL = 50;
+
 BtQmlInterface::BtQmlInterface(QObject * parent)
     : QObject(parent)
     , m_moduleTextModel(new BtModuleTextModel(this))
-{}
+    , m_textFinder(new BtModuleTextFinder(this))
+{
+    BT_CONNECT(m_textFinder, &BtModuleTextFinder::found,
+               this,
+               [this](quint64 const generation, int const index)
+               { itemFound(generation, index); });
+
+    // List all entries of a daily devotional once they are cached:
+    BT_CONNECT(&CSwordBackend::instance(), &CSwordBackend::sigLexiconCacheBuilt,
+               this,
+               [this](QString const & moduleName) {
+                   if (!m_moduleTextModel->seeksDirectly()
+                       || m_moduleNames.value(0) != moduleName)
+                       return;
+                   m_moduleTextModel->reloadModules();
+                   if (m_swordKey)
+                       scrollToSwordKey(m_swordKey);
+               });
+    m_asyncImageDecoding =
+            btConfig().value<bool>(
+                QStringLiteral("settings/behaviour/asyncImageDecoding"),
+                false);
+    m_moduleTextModel->setAsyncRendering(
+                btConfig().value<bool>(
+                    QStringLiteral("settings/behaviour/asyncTextRendering"),
+                    false));
+    m_moduleTextModel->setChunkLargeEntries(
+                btConfig().value<bool>(QStringLiteral("GUI/chunkLargeEntries"),
+                                       false));
+    m_moduleTextModel->setParallelColumnRendering(
+                btConfig().value<bool>(
+                    QStringLiteral(
+                        "settings/behaviour/parallelColumnRendering"),
+                    false));
+    m_moduleTextModel->setPrefetchWindow(
+                btConfig().value<int>(
+                    QStringLiteral("settings/behaviour/prefetchRowsAhead"),
+                    BtModuleTextModel::defaultPrefetchRowsAhead),
+                btConfig().value<int>(
+                    QStringLiteral("settings/behaviour/prefetchRowsBehind"),
+                    BtModuleTextModel::defaultPrefetchRowsBehind));
+}
 
 BtQmlInterface::~BtQmlInterface() = default;
 
@@ -101,11 +153,15 @@ int BtQmlInterface::getCurrentModelIndex() const {
         key.setKey(m_swordKey->key());
         CSwordTreeKey p(key);
         p.positionToRoot();
-        if(p != key)
-            return static_cast<int>(key.offset() / 4u); /// \todo Check range!
+        if(p != key) /// \todo Check range!
+            return m_moduleTextModel->entryToRow(
+                        static_cast<int>(key.offset() / 4u));
     } else if (moduleType == CSwordModuleInfo::Lexicon) {
-        return static_cast<CSwordLexiconModuleInfo const *>(
-                    keyModule)->entries().indexOf(m_swordKey->key());
+        if (m_moduleTextModel->seeksDirectly())
+            return 0;
+        return m_moduleTextModel->entryToRow(
+                    static_cast<CSwordLexiconModuleInfo const *>(
+                        keyModule)->entries().indexOf(m_swordKey->key()));
     }
     return 0;
 }
@@ -114,6 +170,9 @@ int BtQmlInterface::getNumModules() const {
     return m_moduleNames.count();
 }
 
+int BtQmlInterface::getPrefetchRows() const
+{ return m_moduleTextModel->prefetchRows(); }
+
 double BtQmlInterface::getPixelsPerMM() const {
     constexpr static double const millimetersPerInch = 25.4;
     return QGuiApplication::screens().first()->physicalDotsPerInchX()
@@ -148,9 +207,7 @@ void BtQmlInterface::openEditor(int row, int column) {
     BtEditTextWizard wiz;
     wiz.setTitle(tr("Edit %1").arg(m_moduleTextModel->indexToKeyName(row)));
     wiz.setText(
-            m_moduleTextModel->data(
-                    m_moduleTextModel->index(row, 0),
-                    ModuleEntry::Edit0Role + column).toString());
+            m_moduleTextModel->renderRow(row, ModuleEntry::Edit0Role + column));
     wiz.setFont(m_fonts.at(column));
     if (wiz.exec() == QDialog::Accepted)
         setRawText(row, column, wiz.text());
@@ -180,70 +237,103 @@ QString BtQmlInterface::getLemmaFromLink(const QString& url) {
 }
 
 QString BtQmlInterface::getBibleUrlFromLink(const QString& url) {
-    static QRegularExpression const rx(
-        QStringLiteral(R"PCRE((sword://Bible/.*)\|\|(.*)=(.*))PCRE"));
-    if (auto const match = rx.match(url); match.hasMatch())
-        return match.captured(1);
-    return {};
+    // Like the regular expression (sword://Bible/.*)\|\|(.*)=(.*)
+    auto const parts(ReferenceManager::splitUrl(url));
+    if (!parts || parts->scheme != u"sword" || parts->host != u"Bible")
+        return {};
+    auto const equalsPos = parts->path.lastIndexOf(u'=');
+    if (equalsPos < 2)
+        return {};
+    auto const end = parts->path.lastIndexOf(u"||", equalsPos - 2);
+    if (end < 0)
+        return {};
+    return url.left(parts->path.data() - url.data() + end);
 }
 
 QString BtQmlInterface::getReferenceFromUrl(const QString& url) {
-    {
-        static QRegularExpression const rx(
-            QStringLiteral(
-                R"PCRE(sword://(bible|lexicon)/(.*)/(.*)(\|\|))PCRE"),
-            QRegularExpression::CaseInsensitiveOption);
-        if (auto const match = rx.match(url); match.hasMatch())
-            return QStringLiteral("href=sword://%1/%2/%3")
-                        .arg(match.capturedView(1),
-                             match.capturedView(2),
-                             match.capturedView(3));
-    }{
-        static QRegularExpression const rx(
-            QStringLiteral(R"PCRE(sword://(bible|lexicon)/(.*)/(.*))PCRE"),
-            QRegularExpression::CaseInsensitiveOption);
-        if (auto const match = rx.match(url); match.hasMatch())
-            return QStringLiteral("href=sword://%1/%2/%3")
-                        .arg(match.capturedView(1),
-                             match.capturedView(2),
-                             match.capturedView(3));
-    }{
-        static QRegularExpression const rx(
-            QStringLiteral(R"PCRE(sword://footnote/(.*)=(.*))PCRE"),
-            QRegularExpression::CaseInsensitiveOption);
-        if (auto const match = rx.match(url); match.hasMatch())
-            return QStringLiteral("note=%1").arg(match.capturedView(1));
-    }{
-        static QRegularExpression const rx(
-            QStringLiteral(R"PCRE(sword://lemmamorph/(.*)=(.*)/(.*))PCRE"),
-            QRegularExpression::CaseInsensitiveOption);
-        if (auto const match = rx.match(url); match.hasMatch())
-            return QStringLiteral("%1=%2").arg(match.capturedView(1),
-                                               match.capturedView(2));
+    static auto const is =
+            [](QStringView const part, QStringView const name) noexcept
+            { return part.compare(name, Qt::CaseInsensitive) == 0; };
+
+    auto const parts(ReferenceManager::splitUrl(url));
+    if (!parts || !is(parts->scheme, u"sword"))
+        return {};
+    auto path(parts->path);
+    if (is(parts->host, u"bible") || is(parts->host, u"lexicon")) {
+        // The key ends before the last "||", if any:
+        auto const slashPos = path.indexOf(u'/');
+        if (slashPos >= 0) {
+            if (auto const end = path.lastIndexOf(u"||"); end > slashPos)
+                path.truncate(end);
+            return QStringLiteral("href=sword://%1/%2").arg(parts->host, path);
+        }
+    } else if (is(parts->host, u"footnote")) {
+        if (auto const end = path.lastIndexOf(u'='); end >= 0)
+            return QStringLiteral("note=%1").arg(path.left(end));
+    } else if (is(parts->host, u"lemmamorph")) {
+        // Up to the last slash preceded by an equals sign:
+        if (auto const end = path.lastIndexOf(u'/');
+            end > 0 && path.lastIndexOf(u'=', end - 1) >= 0)
+            return path.left(end).toString();
     }
     return {};
 }
 
-QString BtQmlInterface::rawText(int const row, int const column) {
-    return m_moduleTextModel->data(m_moduleTextModel->index(row, 0),
-                                   ModuleEntry::Text0Role + column).toString();
+QString BtQmlInterface::rawText(int const row, int const column)
+{ return m_moduleTextModel->renderRow(row, ModuleEntry::Text0Role + column); }
+
+void BtQmlInterface::setViewportIndex(int const index) {
+    m_moduleTextModel->setViewportRow(index);
+
+    // Prefetch the infos of the visible links once scrolling has settled:
+    m_viewportIndex = index;
+    killTimer(m_prefetchInfoTimerId);
+    m_prefetchInfoTimerId = startTimer(500);
 }
 
+void BtQmlInterface::prefetchLinkInfos() {
+    auto * const infoDisplay = BibleTime::instance()->infoDisplay();
+    if (!infoDisplay->isVisible())
+        return;
+
+    static QRegularExpression const hrefRegExp(
+            QStringLiteral(R"regex(href="([^"]+)")regex"));
+    QSet<QString> urls;
+    auto const endRow = std::min(m_viewportIndex + 10,
+                                 m_moduleTextModel->rowCount());
+    for (int row = std::max(m_viewportIndex, 0); row < endRow; ++row) {
+        for (int column = 0; column < m_moduleNames.size(); ++column) {
+            // Rows not rendered yet are not visible either:
+            auto const text(
+                        m_moduleTextModel->renderedRow(
+                            row,
+                            ModuleEntry::Text0Role + column));
+            if (!text)
+                continue;
+            for (auto const & match : hrefRegExp.globalMatch(*text)) {
+                urls.insert(match.captured(1).replace(QStringLiteral("&amp;"),
+                                                      QStringLiteral("&")));
+                if (urls.size() >= 64)
+                    break;
+            }
+        }
+    }
+    for (auto const & url : urls) {
+        auto infoList(Rendering::detectInfo(getReferenceFromUrl(url)));
+        if (!infoList.isEmpty())
+            infoDisplay->prefetchInfo(infoList);
+    }
+}
+
+void BtQmlInterface::prefetchRows(int const index, int const direction)
+{ m_moduleTextModel->prefetchRows(index, direction); }
+
 void BtQmlInterface::setRawText(int row, int column, const QString& text) {
     QModelIndex index = m_moduleTextModel->index(row, 0);
     int const role = ModuleEntry::Edit0Role + column;
     Q_ASSERT(column < m_moduleNames.size());
-    if (m_moduleTextModel->setData(index, text, role)) {
-        if (auto * const module =
-                CSwordBackend::instance().findModuleByName(
-                    m_moduleNames[column]))
-        {
-            if (module->hasIndex()) {
-                module->deleteIndex();
-                BtModuleIndexDialog::indexAllModules({module});
-            }
-        }
-    }
+    // The search index is updated once the entry is committed:
+    m_moduleTextModel->setData(index, text, role);
 }
 
 void BtQmlInterface::cancelMagTimer() {
@@ -256,7 +346,11 @@ void BtQmlInterface::setMagReferenceByUrl(const QString& url) {
         return;
     m_timeoutUrl = url;
     cancelMagTimer();
-    m_linkTimerId = startTimer(400);
+    // Prefetched infos are shown sooner, as they need not be rendered first:
+    auto const cached =
+            BibleTime::instance()->infoDisplay()->hasCachedInfo(
+                Rendering::detectInfo(getReferenceFromUrl(url)));
+    m_linkTimerId = startTimer(cached ? 150 : 400);
 }
 
 void BtQmlInterface::settingsChanged() {
@@ -286,6 +380,14 @@ void BtQmlInterface::getFontsFromSettings() {
     Q_EMIT fontChanged();
 }
 
+QString BtQmlInterface::scaledImages(QString const & text, int const width)
+        const
+{
+    return m_asyncImageDecoding
+           ? BtImageProvider::scaledImages(text, width)
+           : text;
+}
+
 void BtQmlInterface::setBibleKey(const QString& link) {
     static QRegularExpression const rx(
         QStringLiteral(R"PCRE(sword://Bible/(.*)/(.*)\|\|(.*)=(.*))PCRE"));
@@ -294,6 +396,7 @@ void BtQmlInterface::setBibleKey(const QString& link) {
 }
 
 void BtQmlInterface::scrollToSwordKey(CSwordKey * key) {
+    auto const oldIndex = m_backgroundHighlightColorIndex;
     m_backgroundHighlightColorIndex = m_moduleTextModel->keyToIndex(*key);
 
     /* Convert from sword index to ListView index */
@@ -302,11 +405,19 @@ void BtQmlInterface::scrollToSwordKey(CSwordKey * key) {
 
     Q_EMIT backgroundHighlightColorIndexChanged();
     m_swordKey = key;
+    if (m_moduleTextModel->seeksDirectly())
+        m_moduleTextModel->setDirectEntryKey(key->key());
     Q_EMIT currentModelIndexChanged();
+
+    // Pre-render the rows the user is likely to navigate to next:
+    m_moduleTextModel->prefetchRows(
+                m_backgroundHighlightColorIndex,
+                m_backgroundHighlightColorIndex - oldIndex);
 }
 
 void BtQmlInterface::setModules(const QStringList &modules) {
     m_moduleNames = modules;
+    cancelFind();
     m_moduleTextModel->setModules(modules);
     getFontsFromSettings();
     Q_EMIT numModulesChanged();
@@ -388,12 +499,24 @@ void BtQmlInterface::changeColorTheme() {
 void BtQmlInterface::copyRange(int index1, int index2) const {
     QString text;
     std::unique_ptr<CSwordKey> key(m_swordKey->copy());
+    QProgressDialog progress(tr("Copying entries..."), tr("Cancel"), 0, 0);
+    progress.setWindowTitle(QStringLiteral("BibleTime"));
+    progress.setWindowModality(Qt::ApplicationModal);
+    progress.setMaximum(index2 - index1 + 1);
 
     for (int i=index1; i<=index2; ++i) {
+        // Entries split into several rows are copied only once:
+        if (m_moduleTextModel->rowToEntry(i).second != 0)
+            continue;
         QString keyName = m_moduleTextModel->indexToKeyName(i);
         key->setKey(keyName);
-        text.append(QStringLiteral("%1\n%2\n\n")
-                    .arg(keyName, key->strippedText()));
+        text.append(keyName).append('\n')
+            .append(key->strippedText()).append(QStringLiteral("\n\n"));
+        if ((i - index1) % BT_COPY_PROGRESS_INTERVAL == 0) {
+            progress.setValue(i - index1);
+            if (progress.wasCanceled())
+                return;
+        }
     }
     QClipboard *clipboard = QGuiApplication::clipboard();
     clipboard->setText(text);
@@ -405,35 +528,68 @@ void BtQmlInterface::copyVerseRange(CSwordVerseKey const & key1,
     BT_ASSERT(key1.module());
     BT_ASSERT(key1.module() == key2.module());
 
-    Rendering::CPlainTextExportRendering render(true);
+    auto const newRenderer =
+            []() -> std::unique_ptr<Rendering::CTextRendering> {
+                auto render(
+                        std::make_unique<Rendering::CPlainTextExportRendering>(
+                            true));
+                {
+                    DisplayOptions displayOptions;
+                    displayOptions.lineBreaks = true;
+                    displayOptions.verseNumbers = true;
+                    render->setDisplayOptions(displayOptions);
+                }{
+                    FilterOptions filterOptions;
+                    filterOptions.footnotes = 0;
+                    filterOptions.greekAccents = 1;
+                    filterOptions.headings = 1;
+                    filterOptions.hebrewCantillation = 1;
+                    filterOptions.hebrewPoints = 1;
+                    filterOptions.lemmas = 0;
+                    filterOptions.morphSegmentation = 1;
+                    filterOptions.morphTags = 0;
+                    filterOptions.redLetterWords = 1;
+                    filterOptions.scriptureReferences = 0;
+                    filterOptions.strongNumbers = 0;
+                    filterOptions.textualVariants = 0;
+                    render->setFilterOptions(filterOptions);
+                }
+                return render;
+            };
+    auto const tree(
+                Rendering::CTextRendering::keyRangeTree(key1,
+                                                        key2,
+                                                        {key1.module()}));
+
+    // Render huge ranges in the background, showing the progress:
+    QProgressDialog progress(tr("Copying verses..."),
+                             tr("Cancel"),
+                             0,
+                             static_cast<int>(tree.size()));
+    progress.setWindowTitle(QStringLiteral("BibleTime"));
+    progress.setWindowModality(Qt::ApplicationModal);
+    QString text;
     {
-        DisplayOptions displayOptions;
-        displayOptions.lineBreaks = true;
-        displayOptions.verseNumbers = true;
-        render.setDisplayOptions(displayOptions);
-    }{
-        FilterOptions filterOptions;
-        filterOptions.footnotes = 0;
-        filterOptions.greekAccents = 1;
-        filterOptions.headings = 1;
-        filterOptions.hebrewCantillation = 1;
-        filterOptions.hebrewPoints = 1;
-        filterOptions.lemmas = 0;
-        filterOptions.morphSegmentation = 1;
-        filterOptions.morphTags = 0;
-        filterOptions.redLetterWords = 1;
-        filterOptions.scriptureReferences = 0;
-        filterOptions.strongNumbers = 0;
-        filterOptions.textualVariants = 0;
-        render.setFilterOptions(filterOptions);
+        QTextStream out(&text);
+        if (!newRenderer()->renderKeyTreeInParallel(
+                tree,
+                out,
+                newRenderer,
+                [&progress](std::size_t const rendered) {
+                    // Also processes events, since the dialog is modal:
+                    progress.setValue(static_cast<int>(rendered));
+                    return !progress.wasCanceled();
+                }))
+            return;
     }
-    QGuiApplication::clipboard()->setText(
-                render.renderKeyRange(key1, key2, {key1.module()}));
+    QGuiApplication::clipboard()->setText(text);
 }
 
 void BtQmlInterface::setHighlightWords(const QString& words, bool caseSensitive) {
     QApplication::setOverrideCursor(Qt::WaitCursor);
     m_moduleTextModel->setHighlightWords(words, caseSensitive);
+    m_highlightWords = words;
+    cancelFind();
     m_findState.reset();
     m_moduleTextModel->setFindState(m_findState);
     QApplication::restoreOverrideCursor();
@@ -448,63 +604,93 @@ void BtQmlInterface::timerEvent(QTimerEvent * const event) {
         auto infoList(Rendering::detectInfo(getReferenceFromUrl(m_timeoutUrl)));
         if (!infoList.isEmpty())
             BibleTime::instance()->infoDisplay()->setInfo(std::move(infoList));
+    } else if (timerId == m_prefetchInfoTimerId) {
+        event->accept();
+        killTimer(m_prefetchInfoTimerId);
+        m_prefetchInfoTimerId = 0;
+        prefetchLinkInfos();
     } else {
         QObject::timerEvent(event);
     }
 }
 
 void BtQmlInterface::findText(bool const backward) {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
     if (!m_findState)
         m_findState = FindState{getCurrentModelIndex(), 0};
 
-    auto const countHighlightsInItem =
-        [this](int const index) {
-            return m_moduleTextModel->data(m_moduleTextModel->index(index),
-                                           ModuleEntry::Text1Role)
-                        .toString().count(QStringLiteral("\"highlightwords"));
-        };
-
+    // Step through the highlights of the current item first:
     auto const num = countHighlightsInItem(m_findState->index);
     if (backward) { // get previous matching item:
         if (num > 0 && m_findState->subIndex == 0) {
             // Found within m_findState->index item
             m_findState->subIndex = 1;
-        } else if (auto index = m_findState->index; index > 0) {
-            if (m_findState->subIndex == 0)
-                --index;
-            for (int i = 0; i < 1000; ++i, --index) {
-                if (auto const num2 = countHighlightsInItem(index)) {
-                    m_findState->index = index;
-                    if (m_findState->subIndex == 0) {
-                        m_findState->subIndex = num2;
-                    } else {
-                        --m_findState->subIndex;
-                    }
-                    if (m_findState->subIndex != 0)
-                        break;
-                }
-            }
+            return showFindState();
         }
-    } else { // get next matching item:
-        if (num > m_findState->subIndex) {
-            // Found within m_findState->index item
-            ++m_findState->subIndex;
-        } else if (m_findState->index < m_moduleTextModel->rowCount()) {
-            auto index = m_findState->index + 1;
-            for (int i = 0; i < 1000; ++i, ++index) {
-                if (countHighlightsInItem(index)) {
-                    m_findState->index = index;
-                    m_findState->subIndex = 1;
-                    break;
-                }
-            }
+        if (m_findState->subIndex > 1) {
+            --m_findState->subIndex;
+            return showFindState();
+        }
+    } else if (num > m_findState->subIndex) { // get next matching item:
+        // Found within m_findState->index item
+        ++m_findState->subIndex;
+        return showFindState();
+    }
+
+    // Continue with the other rows of an entry split into several rows:
+    auto const step = backward ? -1 : 1;
+    auto const entry = m_moduleTextModel->rowToEntry(m_findState->index).first;
+    for (auto row = m_findState->index + step;
+         row >= 0 && m_moduleTextModel->rowToEntry(row).first == entry;
+         row += step)
+    {
+        if (auto const n = countHighlightsInItem(row); n > 0) {
+            m_findState = FindState{row, backward ? n : 1};
+            return showFindState();
         }
     }
+    findItem(entry + step, backward);
+}
 
+int BtQmlInterface::countHighlightsInItem(int const index) const {
+    return m_moduleTextModel->renderRow(index, ModuleEntry::Text1Role)
+                .count(QStringLiteral("\"highlightwords"));
+}
+
+void BtQmlInterface::findItem(int const fromIndex, bool const backward) {
+    m_findBackward = backward;
+    m_findGeneration = m_textFinder->find(m_moduleNames,
+                                          m_highlightWords,
+                                          fromIndex,
+                                          backward);
+}
+
+void BtQmlInterface::itemFound(std::uint64_t const generation,
+                               int const index)
+{
+    if (generation != m_findGeneration || !m_findState || index < 0)
+        return;
+
+    /* The finder only searches the stripped text, so continue searching if the
+       words are not highlighted in the rendered item: */
+    auto const firstRow = m_moduleTextModel->entryToRow(index);
+    auto const numRows = m_moduleTextModel->splitEntry(index);
+    for (int i = 0; i < numRows; ++i) {
+        auto const row = m_findBackward ? firstRow + numRows - 1 - i
+                                        : firstRow + i;
+        if (auto const num = countHighlightsInItem(row); num > 0) {
+            m_findState = FindState{row, m_findBackward ? num : 1};
+            return showFindState();
+        }
+    }
+    findItem(index + (m_findBackward ? -1 : 1), m_findBackward);
+}
+
+void BtQmlInterface::cancelFind() {
+    m_textFinder->cancel();
+    m_findGeneration = 0u;
+}
+
+void BtQmlInterface::showFindState() {
     m_moduleTextModel->setFindState(m_findState);
     Q_EMIT positionItemOnScreen(m_findState->index);
-    QApplication::restoreOverrideCursor();
 }
-
-int BtQmlInterface::typeId;
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <QFont>
 #include <QList>
@@ -21,6 +22,7 @@
 #include "../../../backend/models/btmoduletextmodel.h"
 
 
+class BtModuleTextFinder;
 class CSwordKey;
 class CSwordModuleInfo;
 class CSwordVerseKey;
@@ -29,15 +31,16 @@ class RoleItemModel;
 /**
  * /brief This class provides communications between QML and c++.
  *
- * It is instantiated by usage within the QML files. It provides
- * properties and functions written in c++ and usable by QML.
+ * It is instantiated by every BtQuickWidget and available to its QML files as
+ * btQmlInterface. It provides properties and functions written in c++ and
+ * usable by QML.
  */
 
 class BtQmlInterface : public QObject {
 
     Q_OBJECT
     QML_ELEMENT
-    QML_SINGLETON
+    QML_UNCREATABLE("Provided by BtQuickWidget")
     Q_PROPERTY(QColor       backgroundColor         READ getBackgroundColor NOTIFY backgroundColorChanged)
     Q_PROPERTY(QColor       backgroundHighlightColor READ getBackgroundHighlightColor NOTIFY backgroundHighlightColorChanged)
     Q_PROPERTY(int          backgroundHighlightColorIndex READ getBackgroundHighlightColorIndex NOTIFY backgroundHighlightColorIndexChanged)
@@ -57,6 +60,7 @@ class BtQmlInterface : public QObject {
     Q_PROPERTY(QColor       foregroundColor         READ getForegroundColor NOTIFY foregroundColorChanged)
     Q_PROPERTY(int          numModules              READ getNumModules NOTIFY numModulesChanged)
     Q_PROPERTY(double       pixelsPerMM             READ getPixelsPerMM NOTIFY pixelsPerMMChanged)
+    Q_PROPERTY(int          prefetchRows            READ getPrefetchRows CONSTANT)
     Q_PROPERTY(QVariant     textModel               READ getTextModel NOTIFY textModelChanged)
 
 public: /* Types: */
@@ -91,10 +95,24 @@ public:
     void setMagReferenceByUrl(const QString& url);
     Q_INVOKABLE QString rawText(int row, int column);
     Q_INVOKABLE void setRawText(int row, int column, const QString& text);
+    Q_INVOKABLE void setViewportIndex(int index);
+
+    /**
+      Pre-renders the rows around the given index in the given direction, see
+      BtModuleTextModel::prefetchRows().
+    */
+    Q_INVOKABLE void prefetchRows(int index, int direction);
     Q_INVOKABLE void setBibleKey(const QString& link);
     Q_INVOKABLE int indexToVerse(int index);
     Q_INVOKABLE void setHoveredLink(QString const & link);
 
+    /**
+      \returns the given text with its images decoded in the background and
+               scaled to the given width of the column by BtImageProvider, if
+               enabled by "settings/behaviour/asyncImageDecoding".
+    */
+    Q_INVOKABLE QString scaledImages(QString const & text, int width) const;
+
     BtQmlInterface(QObject * parent = nullptr);
     ~BtQmlInterface() override;
 
@@ -127,6 +145,7 @@ public:
     QString getLemmaFromLink(const QString& url);
     int getNumModules() const;
     double getPixelsPerMM() const;
+    int getPrefetchRows() const;
 
     Q_INVOKABLE void setSelection(int column,
                                   int startIndex,
@@ -178,15 +197,27 @@ private:
     void getFontsFromSettings();
     QString getReferenceFromUrl(const QString& url);
 
-public: // Fields:
+    /** Prefetches the infos of the links in the rows around the viewport. */
+    void prefetchLinkInfos();
+
+    int countHighlightsInItem(int index) const;
+
+    /** Searches the next item with highlighted words in the background. */
+    void findItem(int fromIndex, bool backward);
 
-    static int typeId;
+    void itemFound(std::uint64_t generation, int index);
+    void cancelFind();
+    void showFindState();
 
 private: // Fields:
 
     bool m_firstHref = false;
+    bool m_asyncImageDecoding = false;
     int m_linkTimerId = 0;
+    int m_prefetchInfoTimerId = 0;
+    int m_viewportIndex = 0;
     BtModuleTextModel * const m_moduleTextModel;
+    BtModuleTextFinder * const m_textFinder;
     CSwordKey * m_swordKey = nullptr;
 
     QList<QFont> m_fonts;
@@ -196,6 +227,9 @@ private: // Fields:
     int m_contextMenuIndex;
     int m_contextMenuColumn;
     QString m_activeLink;
+    QString m_highlightWords;
     std::optional<FindState> m_findState;
+    std::uint64_t m_findGeneration = 0u;
+    bool m_findBackward = false;
     std::optional<Selection> m_selection;
 };
@@ -14,9 +14,11 @@
 #include "../../bibletime.h"
 
 #include <QCursor>
+#include <QDebug>
 #include <QGuiApplication>
 #include <QMimeData>
 #include <QMouseEvent>
+#include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QQuickItem>
@@ -26,20 +28,46 @@
 #include "../../../backend/managers/cswordbackend.h"
 #include "../../../util/btassert.h"
 #include "../../BtMimeData.h"
+#include "btimageprovider.h"
 #include "btqmlinterface.h"
 
 
+namespace {
+
+/**
+  \returns the QML engine shared by all display windows, so that the QML
+           files are compiled only once and the windows share their caches.
+*/
+QQmlEngine * sharedEngine() {
+    static QQmlEngine * const engine = [] {
+        // Destroyed with the main window, after its display windows:
+        auto * const e = new QQmlEngine(BibleTime::instance());
+        e->addImportPath(QStringLiteral("qrc:/qt/qml"));
+        e->addImageProvider(BtImageProvider::id(), new BtImageProvider);
+        return e;
+    }();
+    return engine;
+}
+
+} // anonymous namespace
+
 BtQuickWidget::BtQuickWidget(QWidget * const parent)
-    : QQuickWidget(parent)
-    , m_qmlInterface(
-        engine()->singletonInstance<BtQmlInterface *>(BtQmlInterface::typeId))
+    : QQuickWidget(sharedEngine(), parent)
+    , m_qmlInterface(new BtQmlInterface(this))
 {
-    BT_ASSERT(m_qmlInterface);
-
     setAcceptDrops(true);
 
-    engine()->addImportPath(QStringLiteral("qrc:/qt/qml"));
-    setSource(QUrl(QStringLiteral("qrc:/qt/qml/DisplayView.qml")));
+    /* Every window has its own BtQmlInterface, which the QML files access from
+       the context the root object is created in: */
+    auto * const context = new QQmlContext(engine(), this);
+    context->setContextProperty(QStringLiteral("btQmlInterface"),
+                                m_qmlInterface);
+    QUrl const source(QStringLiteral("qrc:/qt/qml/DisplayView.qml"));
+    auto * const component = new QQmlComponent(engine(), source, this);
+    auto * const rootObject = component->create(context);
+    if (!rootObject)
+        qWarning() << component->errors();
+    setContent(source, component, rootObject);
 
     m_scrollTimer.setInterval(100);
     m_scrollTimer.setSingleShot(false);
@@ -115,6 +143,9 @@ CSwordKey* BtQuickWidget::getMouseClickedKey() {
 
 void BtQuickWidget::scroll(int const pixels) { callQml("scroll", pixels); }
 
+void BtQuickWidget::setAutoScrollVelocity(double const pixelsPerSecond)
+{ callQml("setAutoScrollVelocity", pixelsPerSecond); }
+
 // Catch Leave event here insteaded of leaveEvent(e), because
 // QMdiSubwindow does not pass leaveEvent on down.
 bool BtQuickWidget::event(QEvent* e) {
@@ -33,6 +33,13 @@ public:
     BtQuickWidget(QWidget * const parent = nullptr);
 
     void scroll(int pixels);
+
+    /**
+      Scrolls the view continuously, synchronized to the frames of the window.
+      \param[in] pixelsPerSecond The velocity, negative to scroll up, or zero
+                                 to stop scrolling.
+    */
+    void setAutoScrollVelocity(double pixelsPerSecond);
     void updateReferenceText();
     void pageDown();
     void pageUp();
@@ -187,7 +187,7 @@ void BtModuleChooserMenu::update(BtModuleList newModulesToUse,
     m_selectedModule = newSelectedModule;
     m_buttonIndex = newButtonIndexIndex;
     m_leftLikeModules = newLeftLikeModules;
-    rebuildMenu();
+    invalidateMenu();
 }
 
 QIcon BtModuleChooserMenu::buttonIcon() const {
@@ -200,5 +200,5 @@ void BtModuleChooserMenu::setSelectedModule(
         CSwordModuleInfo * const newSelectedModule) noexcept
 {
     m_selectedModule = newSelectedModule;
-    rebuildMenu();
+    invalidateMenu();
 }
@@ -135,6 +135,8 @@ void CBibleReadWindow::initActions() {
     auto * const ac = actionCollection();
     m_actions.findText = &ac->action(QStringLiteral("findText"));
     m_actions.findStrongs = &ac->action(CResMgr::displaywindows::general::findStrongs::actionName);
+    m_actions.lookUpInLexicons =
+            &ac->action(QStringLiteral("lookUpInLexicons"));
     m_actions.copy.referenceOnly =
             &ac->action(QStringLiteral("copyReferenceOnly"));
 
@@ -207,6 +209,7 @@ QMenu * CBibleReadWindow::newDisplayWidgetPopupMenu() {
     auto * const popupMenu = new QMenu(this);
     popupMenu->addAction(m_actions.findText);
     popupMenu->addAction(m_actions.findStrongs);
+    popupMenu->addAction(m_actions.lookUpInLexicons);
     popupMenu->addSeparator();
 
     m_actions.copyMenu = new QMenu(tr("Copy"), popupMenu);
@@ -368,7 +371,7 @@ void CBibleReadWindow::syncWindows() {
     for (auto * const subWindow : mdi()->subWindowList()) {
         CDisplayWindow* w = dynamic_cast<CDisplayWindow*>(subWindow->widget());
         if (w && w->syncAllowed()) {
-            w->lookupKey(swordKey()->key());
+            w->syncWithKey(swordKey()->key());
         }
     }
 }
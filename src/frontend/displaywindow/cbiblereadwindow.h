@@ -59,6 +59,7 @@ protected: // methods:
     struct {
         QAction* findText;
         QAction* findStrongs;
+        QAction* lookUpInLexicons;
 
         QMenu* copyMenu;
         struct {
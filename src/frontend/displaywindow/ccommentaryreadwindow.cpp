@@ -16,11 +16,16 @@
 #include <QIcon>
 #include <QMenu>
 #include <QToolBar>
+#include "../../backend/config/btconfig.h"
 #include "../../backend/config/btconfigcore.h"
 #include "../../backend/keys/cswordversekey.h"
 #include "../../backend/managers/cswordbackend.h"
+#include "../../backend/models/btmoduletextmodel.h"
+#include "../../util/btconnect.h"
 #include "../../util/cresmgr.h"
 #include "../bibletime.h"
+#include "../display/btmodelviewreaddisplay.h"
+#include "../display/modelview/btqmlinterface.h"
 #include "../keychooser/ckeychooser.h"
 #include "btactioncollection.h"
 
@@ -66,7 +71,20 @@ CCommentaryReadWindow::CCommentaryReadWindow(
         QString const & key,
         CMDIArea * parent)
     : CDisplayWindow(modules, key, true, new ActionCollection(), parent)
-{ init(); }
+{
+    init();
+
+    // Commentary entries are long, so render them without blocking the GUI:
+    displayWidget()->qmlInterface()->textModel()->setAsyncRendering(true);
+
+    m_syncTimer.setSingleShot(true);
+    m_syncTimer.setInterval(
+                btConfig().value<int>(
+                    QStringLiteral("settings/behaviour/commentarySyncDelay"),
+                    150));
+    BT_CONNECT(&m_syncTimer, &QTimer::timeout,
+               this, &CCommentaryReadWindow::applySyncedKey);
+}
 
 void CCommentaryReadWindow::initActions() {
     BtActionCollection* ac = actionCollection();
@@ -181,3 +199,19 @@ void CCommentaryReadWindow::previousVerse() {
 bool CCommentaryReadWindow::syncAllowed() const noexcept {
     return m_syncButton->isChecked();
 }
+
+void CCommentaryReadWindow::syncWithKey(QString const & key) {
+    m_syncedKey = key;
+    m_syncTimer.start();
+}
+
+void CCommentaryReadWindow::applySyncedKey() {
+    auto const oldIndex = verseKey()->index();
+    lookupKey(m_syncedKey);
+
+    // The Bible window likely moves on in the same direction:
+    auto * const qmlInterface = displayWidget()->qmlInterface();
+    qmlInterface->prefetchRows(
+                qmlInterface->textModel()->verseKeyToIndex(*verseKey()),
+                (verseKey()->index() < oldIndex) ? -1 : 1);
+}
@@ -14,6 +14,9 @@
 
 #include "cdisplaywindow.h"
 
+#include <QString>
+#include <QTimer>
+
 
 class BtActionCollection;
 class CSwordVerseKey;
@@ -47,6 +50,7 @@ public: // Types:
         void storeProfileSettings(BtConfigCore & windowConf) const override;
         void applyProfileSettings(BtConfigCore const & windowConf) override;
         bool syncAllowed() const noexcept override;
+        void syncWithKey(QString const & key) override;
 
     public Q_SLOTS:
         void nextBook();
@@ -63,6 +67,12 @@ public: // Types:
         void setupMainWindowToolBars() override;
 
     private:
+        /** Shows the last key synced and prefetches the verses around it. */
+        void applySyncedKey();
+
         QAction* m_syncButton;
+        /** Collects fast key changes of the Bible window into one lookup. */
+        QTimer m_syncTimer;
+        QString m_syncedKey;
         CSwordVerseKey* verseKey();
 };
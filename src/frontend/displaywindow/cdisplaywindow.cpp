@@ -18,11 +18,16 @@
 #include <QFileDialog>
 #include <QMdiSubWindow>
 #include <QMenu>
+#include <QShowEvent>
 #include <QStringList>
 #include <QWidget>
+#include <utility>
+#include "../../backend/btheadwordindex.h"
 #include "../../backend/config/btconfig.h"
+#include "../../backend/drivers/cswordlexiconmoduleinfo.h"
 #include "../../backend/keys/cswordkey.h"
 #include "../../backend/managers/cswordbackend.h"
+#include "../../util/bttrace.h"
 #include "../../util/cresmgr.h"
 #include "../bibletime.h"
 #include "../cexportmanager.h"
@@ -130,6 +135,9 @@ CDisplayWindow::ActionCollection::ActionCollection(QObject * const parent)
     actn->setShortcut(CResMgr::displaywindows::general::findStrongs::accel);
     addAction(CResMgr::displaywindows::general::findStrongs::actionName, actn);
 
+    actn = new QAction(tr("Look up in all lexicons"), this);
+    addAction(QStringLiteral("lookUpInLexicons"), actn);
+
     #ifdef BUILD_TEXT_TO_SPEECH
     actn = new QAction(tr("Speak selected text"), this);
     addAction("speakSelectedText", actn);
@@ -166,9 +174,27 @@ CDisplayWindow::CDisplayWindow(BtModuleList const & modules,
     // QMdiSubWindow handles this procedure.
     //setAttribute(Qt::WA_DeleteOnClose);
 
-    // Connect this to the backend module list changes
-    BT_CONNECT(&CSwordBackend::instance(), &CSwordBackend::sigSwordSetupChanged,
-               this,                       &CDisplayWindow::reload);
+    /* Connect this to the backend module list changes. Only windows of which
+       modules were removed need to be reloaded, since the backend keeps the
+       unchanged modules when reloading them: */
+    auto & backend = CSwordBackend::instance();
+    BT_CONNECT(backend.model().get(), &BtBookshelfModel::rowsAboutToBeRemoved,
+               this,
+               [this, &backend](QModelIndex const &,
+                                int const first,
+                                int const last)
+               {
+                   auto const & modules = backend.moduleList();
+                   for (int i = first; i <= last; ++i)
+                       if (m_modules.contains(modules.at(i)))
+                           m_modulesRemoved = true;
+               });
+    BT_CONNECT(&backend, &CSwordBackend::sigSwordSetupChanged,
+               this,
+               [this] {
+                   if (std::exchange(m_modulesRemoved, false))
+                       reload();
+               });
 
     setWindowIcon(m_modules.first()->moduleIcon());
     updateWindowTitle();
@@ -289,10 +315,16 @@ CDisplayWindow::CDisplayWindow(BtModuleList const & modules,
                           &BtModelViewReadDisplay::speakSelectedText);
     speakSelectedTextAction.setEnabled(hasSelection);
     #endif
+    auto & lookUpInLexiconsAction =
+            initAddAction(QStringLiteral("lookUpInLexicons"),
+                          this,
+                          &CDisplayWindow::lookUpInLexicons);
+    lookUpInLexiconsAction.setEnabled(hasSelection);
     BT_CONNECT(m_displayWidget->qmlInterface(),
                &BtQmlInterface::selectionChanged,
                this,
-               [&copySelectedTextAction
+               [&copySelectedTextAction,
+                &lookUpInLexiconsAction
                 #ifdef BUILD_TEXT_TO_SPEECH
                 , &speakSelectedTextAction
                 #endif
@@ -300,6 +332,7 @@ CDisplayWindow::CDisplayWindow(BtModuleList const & modules,
                  std::optional<BtQmlInterface::Selection> const & newSelection)
                {
                 copySelectedTextAction.setEnabled(newSelection.has_value());
+                lookUpInLexiconsAction.setEnabled(newSelection.has_value());
                 #ifdef BUILD_TEXT_TO_SPEECH
                 speakSelectedTextAction.setEnabled(newSelection.has_value());
                 #endif
@@ -326,6 +359,7 @@ CDisplayWindow::CDisplayWindow(BtModuleList const & modules,
     addAction(m_actions.forwardInHistory);
     m_actions.findText =
             &m_actionCollection->action(QStringLiteral("findText"));
+    m_actions.lookUpInLexicons = &lookUpInLexiconsAction;
     m_actions.findStrongs =
             &initAddAction(
                 CResMgr::displaywindows::general::findStrongs::actionName,
@@ -423,6 +457,77 @@ void CDisplayWindow::clearMainWindowToolBars() {
 void CDisplayWindow::windowActivated() {
     clearMainWindowToolBars();
     setupMainWindowToolBars();
+    performPendingUpdates();
+}
+
+void CDisplayWindow::resumeLookup() {
+    m_lookupDeferred = false;
+    performPendingLookup();
+}
+
+bool CDisplayWindow::isDisplayed() const {
+    auto const * const subWindow = parentWidget();
+    if (!isVisible() || (subWindow && subWindow->isMinimized()))
+        return false;
+    return m_mdi->viewMode() != QMdiArea::TabbedView
+           || m_mdi->activeSubWindow() == subWindow;
+}
+
+void CDisplayWindow::performPendingLookup() {
+    if (m_lookupDeferred || !m_lookupPending || !isDisplayed())
+        return;
+    m_lookupPending = false;
+    lookup();
+}
+
+void CDisplayWindow::performPendingUpdates() {
+    if (m_reloadPending && isDisplayed()) {
+        reload();
+    } else {
+        performPendingLookup();
+    }
+}
+
+void CDisplayWindow::lookUpInLexicons() {
+    auto const headword(
+            m_displayWidget->qmlInterface()->getSelectedText().simplified());
+    if (headword.isEmpty())
+        return;
+
+    // Open each lexicon with the headword once, at its first such entry:
+    QList<CSwordModuleInfo *> modules;
+    QString key;
+    if (auto const index = BtHeadwordIndex::instance()) {
+        for (auto const & match : index->find(headword)) {
+            auto * const module =
+                    CSwordBackend::instance().findModuleByName(
+                        match.moduleName);
+            if (!module
+                || module->type() != CSwordModuleInfo::Lexicon
+                || modules.contains(module))
+                continue;
+            auto const & entries =
+                    static_cast<CSwordLexiconModuleInfo *>(module)->entries();
+            if (match.entryIndex >= entries.size())
+                continue; // The index is not yet updated for the module
+            if (modules.isEmpty())
+                key = entries.at(match.entryIndex);
+            modules.append(module);
+        }
+    }
+    if (modules.isEmpty()) {
+        message::showInformation(
+                    this,
+                    tr("Look up in all lexicons"),
+                    tr("No lexicon has an entry for \"%1\".").arg(headword));
+        return;
+    }
+    btMainWindow()->createReadDisplayWindow(std::move(modules), key);
+}
+
+void CDisplayWindow::showEvent(QShowEvent * const event) {
+    QMainWindow::showEvent(event);
+    performPendingUpdates();
 }
 
 void CDisplayWindow::updateWindowTitle() {
@@ -551,6 +656,7 @@ QMenu * CDisplayWindow::newDisplayWidgetPopupMenu() {
     auto * const popupMenu = new QMenu(this);
     popupMenu->addAction(m_actions.findText);
     popupMenu->addAction(m_actions.findStrongs);
+    popupMenu->addAction(m_actions.lookUpInLexicons);
     popupMenu->addSeparator();
 
     m_actions.copyMenu = new QMenu(tr("Copy..."), popupMenu);
@@ -626,6 +732,8 @@ CSwordKey* CDisplayWindow::getMouseClickedKey() const
 
 /** Refresh the settings of this window. */
 void CDisplayWindow::reload() {
+    m_reloadPending = false;
+
     // Since all the CSwordModuleInfo pointers are invalidated, we need to
     // rebuild m_modules based on m_moduleNames, and remove all missing modules:
     BT_ASSERT(!m_moduleNames.empty()); // This should otherwise be close()-d
@@ -664,6 +772,15 @@ void CDisplayWindow::reload() {
     m_actionCollection->readShortcuts(QStringLiteral("Lexicon shortcuts"));
 }
 
+void CDisplayWindow::reloadWhenDisplayed() {
+    // Hidden windows are reloaded only once they are shown or activated:
+    if (isDisplayed()) {
+        reload();
+    } else {
+        m_reloadPending = true;
+    }
+}
+
 void CDisplayWindow::slotAddModule(int index, CSwordModuleInfo * module) {
     BT_ASSERT(index <= m_modules.size());
     m_modules.insert(index, module);
@@ -747,6 +864,14 @@ void CDisplayWindow::lookupSwordKey(CSwordKey * newKey) {
     if (m_swordKey.get() != newKey)
         m_swordKey->setKey(newKey->key());
 
+    // Windows not displayed after restoring a session are rendered when shown:
+    if (m_lookupDeferred || (m_lookupPending && !isDisplayed())) {
+        m_lookupPending = true;
+        updateWindowTitle();
+        return;
+    }
+    m_lookupPending = false;
+
     m_displayWidget->setOptions(displayOptions(), filterOptions());
     m_displayWidget->scrollToKey(newKey);
     BibleTime::instance()->autoScrollStop();
@@ -757,6 +882,7 @@ void CDisplayWindow::lookupSwordKey(CSwordKey * newKey) {
 /** Initialize the window. Call this method from the outside, because calling
      this in the constructor is not possible! */
 bool CDisplayWindow::init() {
+    BT_TRACE_SPAN("init display window");
     initActions();
     initToolbars();
 
@@ -774,7 +900,9 @@ bool CDisplayWindow::init() {
     clearMainWindowToolBars();
     initConnections();
 
-    m_displayWidget->installPopup(newDisplayWidgetPopupMenu());
+    // Most windows never show their popup menu:
+    m_displayWidget->installPopup(
+                [this]{ return newDisplayWidgetPopupMenu(); });
 
     m_filterOptions = conf.getFilterOptions();
     m_displayOptions = conf.getDisplayOptions();
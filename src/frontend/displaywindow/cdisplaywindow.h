@@ -88,6 +88,24 @@ public:
     */
     virtual void applyProfileSettings(BtConfigCore const & windowConf);
 
+    /**
+       \brief Defers the lookups of this window until resumeLookup().
+
+       While deferred, lookups only update the key and the window title. This
+       is used when restoring sessions, so that windows hidden behind other
+       tabs are not rendered before the user switches to them.
+    */
+    void deferLookup() noexcept { m_lookupDeferred = true; }
+
+    /** \returns whether the lookups of this window are deferred. */
+    bool lookupDeferred() const noexcept { return m_lookupDeferred; }
+
+    /**
+       \brief Stops deferring lookups. A pending lookup is performed as soon as
+              this window is displayed.
+    */
+    void resumeLookup();
+
     /** Returns the display options used by this display window. */
     DisplayOptions const & displayOptions() const noexcept
     { return m_displayOptions; }
@@ -125,6 +143,9 @@ public:
                  window. */
     virtual bool syncAllowed() const noexcept { return false; }
 
+    /** Shows the given key of the active window this window is synced to. */
+    virtual void syncWithKey(QString const & key) { lookupKey(key); }
+
     /**
         * Return pointer to the BibleTime main window
         */
@@ -181,6 +202,12 @@ public Q_SLOTS:
     /** Refresh the settings of this window.*/
     virtual void reload();
 
+    /**
+      \brief Refreshes the settings of this window now if it is displayed, or
+             else when it is next shown or activated.
+    */
+    void reloadWhenDisplayed();
+
 protected:
 
     friend class CBibleReadWindow;
@@ -212,6 +239,8 @@ protected:
         return action;
     }
 
+    void showEvent(QShowEvent * event) override;
+
     /** Initializes the internel keyboard actions.*/
     virtual void initActions() = 0;
 
@@ -245,6 +274,24 @@ protected Q_SLOTS:
 
 private: // methods:
 
+    /** \returns whether this window is visible and not behind another tab. */
+    bool isDisplayed() const;
+
+    /** \brief Performs the pending lookup if this window is displayed. */
+    void performPendingLookup();
+
+    /**
+      \brief Performs the pending reload or else the pending lookup if this
+             window is displayed.
+    */
+    void performPendingUpdates();
+
+    /**
+      \brief Opens the lexicons with the selected text as a headword according
+             to the BtHeadwordIndex in a new window.
+    */
+    void lookUpInLexicons();
+
     template <typename Name, typename ... Args>
     QAction & initAction(Name && name, Args && ... args) {
         QAction & a = m_actionCollection->action(std::forward<Name>(name));
@@ -259,6 +306,7 @@ protected: // fields:
         BtToolBarPopupAction * forwardInHistory;
         QAction * findText;
         QAction * findStrongs;
+        QAction * lookUpInLexicons;
         QMenu * copyMenu;
         struct {
             QAction * byReferences;
@@ -297,6 +345,10 @@ private:
     CKeyChooser * m_keyChooser = nullptr;
     std::unique_ptr<CSwordKey> const m_swordKey;
     bool m_isInitialized = false; ///< Whether init() has been called
+    bool m_lookupDeferred = false; ///< Whether lookups are deferred
+    bool m_lookupPending = false; ///< Whether a deferred lookup is pending
+    bool m_reloadPending = false; ///< Whether a deferred reload is pending
+    bool m_modulesRemoved = false; ///< Whether any of m_modules was removed
     QToolBar * m_mainToolBar;
     BtModuleChooserBar* m_moduleChooserBar;
     QToolBar * m_buttonsToolBar;
@@ -13,13 +13,34 @@
 #include "clexiconreadwindow.h"
 
 #include <QAction>
+#include <QDate>
 #include <QString>
+#include "../../backend/drivers/cswordlexiconmoduleinfo.h"
+#include "../../backend/drivers/cswordmoduleinfo.h"
 #include "../../backend/keys/cswordkey.h"
 #include "../../backend/keys/cswordldkey.h"
 #include "../../util/cresmgr.h"
 #include "../keychooser/ckeychooser.h"
 
 
+namespace {
+
+/**
+  \returns the given key, or the key of the entry of today if the key is empty
+           and the first module is a daily devotional, which is seeked directly.
+*/
+QString initialKey(QList<CSwordModuleInfo *> const & modules,
+                   QString const & key)
+{
+    if (key.isEmpty()
+        && modules.first()->category()
+           == CSwordModuleInfo::Category::DailyDevotionals)
+        return CSwordLexiconModuleInfo::dateKey(QDate::currentDate());
+    return key;
+}
+
+} // anonymous namespace
+
 CLexiconReadWindow::ActionCollection::ActionCollection(QObject * const parent)
     : CDisplayWindow::ActionCollection(parent)
 {
@@ -36,7 +57,11 @@ CLexiconReadWindow::CLexiconReadWindow(
         QList<CSwordModuleInfo *> const & modules,
         QString const & key,
         CMDIArea * parent)
-    : CDisplayWindow(modules, key, true, new ActionCollection(), parent)
+    : CDisplayWindow(modules,
+                     initialKey(modules, key),
+                     true,
+                     new ActionCollection(),
+                     parent)
 { init(); }
 
 void CLexiconReadWindow::initActions() {
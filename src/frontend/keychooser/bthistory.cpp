@@ -12,45 +12,127 @@
 
 #include "bthistory.h"
 
+#include <algorithm>
 #include <QAction>
 #include <QVariant>
+#include <versificationmgr.h>
+#include <versekey.h>
+#include "../../backend/config/btconfig.h"
 #include "../../backend/keys/cswordkey.h"
+#include "../../backend/keys/cswordversekey.h"
 #include "../../util/btassert.h"
 
 
 namespace {
-char const ActionText[] = "BtHistory key";
+
+std::size_t historySize() {
+    return static_cast<std::size_t>(
+                std::max(btConfig().value<int>(
+                             QStringLiteral(
+                                 "settings/behaviour/navigationHistorySize"),
+                             100),
+                         1));
 }
 
+} // anonymous namespace
+
 BTHistory::BTHistory(QObject * const parent)
     : QObject(parent)
+    , m_history(historySize())
 { BT_ASSERT(class_invariant()); }
 
+BTHistory::Entry BTHistory::entryFor(CSwordKey const & key) const {
+    Entry entry;
+    if (!dynamic_cast<CSwordVerseKey const *>(&key)) {
+        entry.key = key.key();
+        return entry;
+    }
+
+    auto const & vk =
+            static_cast<sword::VerseKey const &>(key.asSwordKey());
+    auto const * const system =
+            sword::VersificationMgr::getSystemVersificationMgr()
+                ->getVersificationSystem(vk.getVersificationSystem());
+    if (!system) {
+        entry.key = key.key();
+        return entry;
+    }
+    entry.versification = system->getName();
+    if (vk.isBoundSet()) {
+        entry.lowerIndex = vk.getLowerBound().getIndex();
+        entry.upperIndex = vk.getUpperBound().getIndex();
+    } else {
+        entry.lowerIndex = vk.getIndex();
+    }
+    entry.locale = QByteArray(vk.getLocale());
+    for (int i = m_index; i >= 0; --i) {
+        auto const & other = m_history[static_cast<std::size_t>(i)];
+        if (other.versification) {
+            if (other.locale == entry.locale)
+                entry.locale = other.locale;
+            break;
+        }
+    }
+    return entry;
+}
+
+QString BTHistory::keyText(Entry const & entry) {
+    if (!entry.versification)
+        return entry.key;
+
+    auto const positioned =
+            [&entry](long const index) {
+                sword::VerseKey vk;
+                vk.setLocale(entry.locale.constData());
+                vk.setVersificationSystem(entry.versification);
+                vk.setIntros(true);
+                vk.setIndex(index);
+                return vk;
+            };
+    auto vk(positioned(entry.lowerIndex));
+    if (entry.upperIndex < 0)
+        return QString::fromUtf8(vk.getText());
+    vk.setLowerBound(positioned(entry.lowerIndex));
+    vk.setUpperBound(positioned(entry.upperIndex));
+    return QString::fromUtf8(vk.getRangeText());
+}
+
 void BTHistory::add(CSwordKey* newKey) {
     BT_ASSERT(newKey);
-    // Add new key Action after current index if we were not using the history functions,
-    // if it's not a duplicate and if it's not empty.
-    if (!m_inHistoryFunction &&    ((m_index < 0) || (newKey->key() != m_historyList.at(m_index)->property(ActionText).toString()) )) {
-        if (!newKey->key().isEmpty()) {
-            auto * const a = new QAction(newKey->key(), this);
-            a->setProperty(ActionText, newKey->key());
-            m_historyList.insert(++m_index, a);
-        }
-        // \todo history limit?
-        sendChangedSignal();
+    if (m_inHistoryFunction)
+        return;
+    // Add a new entry after the current index if it's not empty and not a
+    // duplicate of the current entry:
+    if (!newKey->key().isEmpty()) {
+        auto entry(entryFor(*newKey));
+        if (m_index >= 0
+            && entry == m_history[static_cast<std::size_t>(m_index)])
+            return;
+        // Unless the oldest entry was dropped to make room:
+        if (!m_history.insert(static_cast<std::size_t>(m_index + 1),
+                              std::move(entry)))
+            ++m_index;
     }
+    sendChangedSignal();
     BT_ASSERT(class_invariant());
 }
 
 void BTHistory::move(QAction* historyItem) {
-    //BT_ASSERT(historyItem);
-    BT_ASSERT(m_historyList.count());
+    BT_ASSERT(historyItem);
+    auto const index = historyItem->data().toInt();
+    if (index >= 0 && static_cast<std::size_t>(index) < m_history.size())
+        moveTo(index);
+}
+
+void BTHistory::moveTo(int const index) {
+    BT_ASSERT(!m_history.empty());
 
     m_inHistoryFunction = true;
-    //find the action in the list
-    m_index = m_historyList.indexOf(historyItem);
     //move to the selected item in the list, it will be the current item
-    Q_EMIT historyMoved(m_historyList.at(m_index)->property(ActionText).toString()); // signal to "outsiders"; key has been changed
+    m_index = index;
+    // signal to "outsiders"; key has been changed:
+    Q_EMIT historyMoved(
+                keyText(m_history[static_cast<std::size_t>(m_index)]));
     sendChangedSignal();
 
     m_inHistoryFunction = false;
@@ -59,50 +141,69 @@ void BTHistory::move(QAction* historyItem) {
 
 void BTHistory::back() {
     if ( m_index >= 1) {
-        move(m_historyList.at(m_index - 1));
+        moveTo(m_index - 1);
     }
     BT_ASSERT(class_invariant());
 }
 
 void BTHistory::fw() {
-    if (m_index < (m_historyList.size() - 1)) {
-        move(m_historyList.at(m_index + 1));
+    if (static_cast<std::size_t>(m_index + 1) < m_history.size()) {
+        moveTo(m_index + 1);
     }
     BT_ASSERT(class_invariant());
 }
 
-QList<QAction*> BTHistory::getBackList() {
+QList<QAction*> BTHistory::actionsFor(QList<int> const & positions) {
+    while (m_actionPool.size() < positions.size())
+        m_actionPool.append(new QAction(this));
 
     QList<QAction*> list;
-    for (int i = m_index - 1; i >= 0; --i) {
-        list.append(m_historyList.at(i));
+    for (qsizetype i = 0; i < positions.size(); ++i) {
+        auto * const action = m_actionPool.at(i);
+        action->setText(
+                keyText(m_history[static_cast<std::size_t>(positions.at(i))]));
+        action->setData(positions.at(i));
+        list.append(action);
     }
+    return list;
+}
+
+QList<QAction*> BTHistory::getBackList() {
+    QList<int> positions;
+    for (int i = m_index - 1; i >= 0; --i)
+        positions.append(i);
 
     BT_ASSERT(class_invariant());
-    return list;
+    return actionsFor(positions);
 }
 
 QList<QAction*> BTHistory::getFwList() {
-    QList<QAction*> list;
-    for (int i = m_index + 1; i < m_historyList.size(); ++i) {
-        list.append(m_historyList.at(i));
-    }
+    QList<int> positions;
+    for (int i = m_index + 1; static_cast<std::size_t>(i) < m_history.size();
+         ++i)
+        positions.append(i);
 
     BT_ASSERT(class_invariant());
-    return list;
+    return actionsFor(positions);
 }
 
 void BTHistory::sendChangedSignal() {
     bool backEnabled = m_index > 0; //there are items in the back list
-    bool fwEnabled = m_historyList.size() > m_index + 1; //there are items in the fw list
+    //there are items in the fw list:
+    bool fwEnabled = m_history.size() > static_cast<std::size_t>(m_index + 1);
     Q_EMIT historyChanged(backEnabled, fwEnabled);
     BT_ASSERT(class_invariant());
 }
 
 bool BTHistory::class_invariant() {
-    for (int i = 0; i < m_historyList.size(); ++i) {
-        if (!m_historyList.at(i) || m_historyList.at(i)->property(ActionText).toString().isEmpty()) return false;
+    for (std::size_t i = 0u; i < m_history.size(); ++i) {
+        auto const & entry = m_history[i];
+        if (entry.versification ? entry.lowerIndex < 0 : entry.key.isEmpty())
+            return false;
     }
-    if (!(m_index >= -1 && m_index < m_historyList.size())) return false;
+    if (m_index < -1
+        || (m_index >= 0
+            && static_cast<std::size_t>(m_index) >= m_history.size()))
+        return false;
     return true;
 }
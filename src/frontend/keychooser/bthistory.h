@@ -14,13 +14,23 @@
 
 #include <QObject>
 
+#include <QByteArray>
 #include <QList>
 #include <QString>
+#include "../../util/btringbuffer.h"
 
 
 class CSwordKey;
 class QAction;
 
+/**
+  \brief The navigation history of a display window.
+
+  The history keeps at most "settings/behaviour/navigationHistorySize" keys in
+  a ring buffer, dropping the oldest ones. Verse keys are kept as indices into
+  their versification instead of as texts, and the actions of the history
+  menus are reused from a pool.
+*/
 class BTHistory: public QObject {
         Q_OBJECT
     public:
@@ -64,12 +74,33 @@ class BTHistory: public QObject {
         */
         void historyMoved(QString newKey);
 
+    private: // types:
+
+        struct Entry {
+
+            friend bool operator==(Entry const &, Entry const &) = default;
+
+            /** The interned Sword name of the versification of verse keys. */
+            char const * versification = nullptr;
+            long lowerIndex = -1;
+            long upperIndex = -1; ///< Of the upper bound of ranges, or -1
+            QByteArray locale; ///< Shared with the previous entries if equal
+            QString key; ///< The text of other keys
+
+        };
+
     private:
 
+        Entry entryFor(CSwordKey const & key) const;
+        static QString keyText(Entry const & entry);
+        QList<QAction*> actionsFor(QList<int> const & positions);
+        void moveTo(int index);
+
         void sendChangedSignal();
         bool class_invariant();
 
-        QList<QAction*> m_historyList;
+        BtRingBuffer<Entry> m_history;
+        QList<QAction*> m_actionPool;
         int m_index = -1; //pointer to the current item; -1==empty, 0==first etc.
         bool m_inHistoryFunction = false; //to prevent recursive behaviour
 };
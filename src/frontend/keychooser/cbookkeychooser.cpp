@@ -63,40 +63,36 @@ void CBookKeyChooser::setKey(CSwordKey * newKey, const bool emitSignal) {
         oldKey = m_key->key();
     }
 
-    auto const oldOffset = m_key->offset();
-
     QStringList siblings; // Split up key
     if (m_key && !oldKey.isEmpty())
         siblings = oldKey.split('/', Qt::SkipEmptyParts);
 
+    auto const & toc = m_modules.first()->tableOfContents();
     int depth = 0;
+    int node = 0; // Start at the root node
 
-    m_key->positionToRoot(); //start iteration at root node
-
-    while (m_key->positionToFirstChild() && (depth < siblings.count())) {
-        QString key = m_key->key();
-        int index = (depth == 0) ? -1 : 0;
-
-        bool found = false;
-
-        do { //look for matching sibling
-            ++index;
-            found = (m_key->getLocalNameUnicode() == siblings[depth]);
-        } while (!found && m_key->positionToNextSibling());
+    while (depth < siblings.count()) {
+        auto const children(toc.children(node));
+        if (children.empty())
+            break;
 
-        if (found) {
-            key = m_key->key(); //found: change key to this level
-        } else {
-            m_key->setKey(key); //not found: restore old key
-        }
+        // Look for the matching sibling, or use the first one if not found:
+        auto it = std::find_if(children.begin(),
+                               children.end(),
+                               [&toc, &name = siblings[depth]](int const child)
+                               { return toc.node(child).name == name; });
+        if (it == children.end())
+            it = children.begin();
+        node = *it;
 
-        setupCombo(key, depth, index);
+        setupCombo(children,
+                   depth,
+                   static_cast<int>(it - children.begin())
+                   + ((depth == 0) ? 0 : 1));
 
         //last iteration: check to see if another box can be filled with child entries
-        if (depth == siblings.count() - 1 && m_key->hasChildren()) {
-            m_key->positionToFirstChild();
-            setupCombo(m_key->key(), ++depth, 0);
-        }
+        if (depth == siblings.count() - 1 && toc.node(node).firstChild >= 0)
+            setupCombo(toc.children(node), ++depth, 0);
 
         depth++;
     }
@@ -108,13 +104,6 @@ void CBookKeyChooser::setKey(CSwordKey * newKey, const bool emitSignal) {
             chooser->reset(0, 0, false);
     }
 
-    if (oldKey.isEmpty()) {
-        m_key->positionToRoot();
-    } else {
-        //m_key->key(oldKey);
-        m_key->setOffset(oldOffset);
-    }
-
     if (emitSignal)
         Q_EMIT keyChanged(m_key);
 }
@@ -213,27 +202,23 @@ void CBookKeyChooser::refreshContent() {
         updateKey(m_key); // Refresh with current key
 }
 
-void CBookKeyChooser::setupCombo(const QString & key,
+void CBookKeyChooser::setupCombo(std::vector<int> const & nodes,
                                  const int depth,
                                  const int currentItem)
 {
     CKeyChooserWidget * const chooserWidget = m_chooserWidgets.at(depth);
+    if (!chooserWidget)
+        return;
 
-    CSwordTreeKey tmpKey(*m_key);
-    tmpKey.setKey(key);
-    tmpKey.positionToParent();
-    tmpKey.positionToFirstChild();
-
+    auto const & toc = m_modules.first()->tableOfContents();
     QStringList items;
+    items.reserve(static_cast<qsizetype>(nodes.size()) + 1);
     if (depth > 0)
         items.append(QString()); // Insert an empty item at the top
+    for (auto const node : nodes)
+        items.append(toc.node(node).name);
 
-    do {
-        items.append(tmpKey.getLocalNameUnicode());
-    } while (tmpKey.positionToNextSibling());
-
-    if (chooserWidget)
-        chooserWidget->reset(items, currentItem, false);
+    chooserWidget->reset(items, currentItem, false);
 }
 
 /** A keychooser changed. Update and emit a signal if necessary. */
@@ -17,6 +17,7 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <vector>
 #include "../../backend/drivers/btmodulelist.h"
 
 
@@ -56,10 +57,10 @@ public Q_SLOTS:
 protected: // methods:
 
     /**
-       Fills the combo given by depth with the items from the key having depth
-       "depth". The parent sibling is given by key.
+       Fills the combo given by depth with the names of the given nodes of the
+       table of contents, i.e. the siblings having depth "depth".
     */
-    void setupCombo(QString const & key,
+    void setupCombo(std::vector<int> const & nodes,
                     int const depth,
                     int const currentItem);
 
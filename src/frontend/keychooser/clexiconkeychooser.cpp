@@ -15,22 +15,69 @@
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <QAbstractListModel>
 #include <QBoxLayout>
 #include <QComboBox>
+#include <QCompleter>
 #include <QHBoxLayout>
 #include <QLayout>
+#include <QModelIndex>
 #include <QStringList>
 #include <Qt>
+#include <QVariant>
 #include <utility>
 #include "../../backend/drivers/btmodulelist.h"
 #include "../../backend/drivers/cswordlexiconmoduleinfo.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
 #include "../../backend/keys/cswordkey.h"
 #include "../../backend/keys/cswordldkey.h"
+#include "../../backend/managers/cswordbackend.h"
 #include "../../util/btconnect.h"
 #include "ckeychooserwidget.h"
 
 
+namespace {
+
+/**
+  \brief Presents the entries of a lexicon ordered case-insensitively, so that
+         QCompleter can find completions by binary search.
+*/
+class SortedEntriesModel final: public QAbstractListModel {
+
+public: // methods:
+
+    SortedEntriesModel(QObject * const parent)
+        : QAbstractListModel(parent)
+    {}
+
+    void setEntries(CSwordLexiconModuleInfo::Entries const * const entries) {
+        beginResetModel();
+        m_entries = entries;
+        endResetModel();
+    }
+
+    int rowCount(QModelIndex const & parent = QModelIndex()) const override {
+        return (parent.isValid() || !m_entries)
+               ? 0
+               : static_cast<int>(m_entries->size());
+    }
+
+    QVariant data(QModelIndex const & index, int const role) const override {
+        if (!m_entries
+            || !index.isValid()
+            || (role != Qt::DisplayRole && role != Qt::EditRole))
+            return {};
+        return m_entries->at(m_entries->sortedIndex(index.row()));
+    }
+
+private: // fields:
+
+    CSwordLexiconModuleInfo::Entries const * m_entries = nullptr;
+
+};
+
+} // anonymous namespace
+
 CLexiconKeyChooser::CLexiconKeyChooser(const BtConstModuleList & modules,
                                        CSwordKey * key,
                                        QWidget * parent)
@@ -53,6 +100,18 @@ CLexiconKeyChooser::CLexiconKeyChooser(const BtConstModuleList & modules,
     //to aid users with smaller screen resolutions
     m_widget->comboBox().setMaximumWidth(200);
 
+    /* For a single module, complete the typed keys using the sorted entries of
+       the module instead of the unsorted items of the combo box: */
+    m_defaultCompleter = m_widget->comboBox().completer();
+    m_entriesCompleter = new QCompleter(new SortedEntriesModel(this), this);
+    m_entriesCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+    m_entriesCompleter->setModelSorting(
+                QCompleter::CaseInsensitivelySortedModel);
+    m_entriesCompleter->setCompletionMode(
+                m_defaultCompleter
+                ? m_defaultCompleter->completionMode()
+                : QCompleter::InlineCompletion);
+
     m_widget->setToolTips(
         tr("Entries of the current work"),
         tr("Next entry"),
@@ -77,6 +136,22 @@ CLexiconKeyChooser::CLexiconKeyChooser(const BtConstModuleList & modules,
     BT_CONNECT(m_widget, &CKeyChooserWidget::changed, activatedSlot);
     BT_CONNECT(m_widget, &CKeyChooserWidget::focusOut, activatedSlot);
 
+    // List all entries of a daily devotional once they are cached:
+    BT_CONNECT(&CSwordBackend::instance(), &CSwordBackend::sigLexiconCacheBuilt,
+               this,
+               [this](QString const & moduleName) {
+                   if (m_seeksDirectly
+                       && m_key
+                       && m_modules.first()->name() == moduleName)
+                   {
+                       // Refreshing selects the first entry, hence restore:
+                       auto key(m_key->key());
+                       refreshContent();
+                       m_key->setKey(std::move(key));
+                       setKey(m_key);
+                   }
+               });
+
     setModules(modules, true);
     setKey(key);
 }
@@ -93,7 +168,16 @@ void CLexiconKeyChooser::updateKey(CSwordKey* key) {
     }
 
     QString newKey = m_key->key();
-    const int index = m_widget->comboBox().findText(newKey);
+    if (m_seeksDirectly) {
+        if (m_widget->comboBox().findText(newKey) < 0)
+            m_widget->reset(QStringList{std::move(newKey)}, 0, false);
+        return;
+    }
+    // The items of a single module are its entries:
+    const int index =
+            (m_modules.count() == 1)
+            ? static_cast<int>(m_modules.first()->entries().nearest(newKey))
+            : m_widget->comboBox().findText(newKey);
     m_widget->comboBox().setCurrentIndex(index);
 }
 
@@ -110,22 +194,49 @@ void CLexiconKeyChooser::setKey(CSwordKey* key) {
 
 /** Reimplementation. */
 void CLexiconKeyChooser::refreshContent() {
-    if (m_modules.count() == 1) {
-        m_widget->reset(&m_modules.first()->entries(), 0, true);
+    auto & comboBox = m_widget->comboBox();
+    auto * const sortedEntries =
+            static_cast<SortedEntriesModel *>(m_entriesCompleter->model());
+    auto const useCompleter =
+            [&comboBox](QCompleter * const completer) {
+                // Avoid needlessly reconnecting the completer:
+                if (comboBox.completer() != completer)
+                    comboBox.setCompleter(completer);
+            };
+    m_seeksDirectly =
+            m_modules.count() == 1 && m_modules.first()->seeksDirectly();
+    if (m_seeksDirectly) {
+        /* Just list the current key instead of reading all entries, which are
+           cached in the background meanwhile: */
+        sortedEntries->setEntries(nullptr);
+        useCompleter(m_defaultCompleter);
+        m_widget->reset(m_key ? QStringList{m_key->key()} : QStringList(),
+                        0,
+                        true);
+        CSwordBackend::instance().buildLexiconCache(m_modules.first()->name());
+    }
+    else if (m_modules.count() == 1) {
+        auto const & entries = m_modules.first()->entries();
+        sortedEntries->setEntries(&entries);
+        useCompleter(m_entriesCompleter);
+        m_widget->reset(entries.toStringList(), 0, true);
         //     qWarning("resetted");
     }
     else {
-        std::multimap<unsigned int, QStringList const *> entryMap;
+        sortedEntries->setEntries(nullptr);
+        useCompleter(m_defaultCompleter);
+
+        std::multimap<unsigned int, QStringList> entryMap;
         for (auto const * const modulePtr : m_modules) {
             auto const & entries = modulePtr->entries();
-            entryMap.emplace(entries.count(), &entries);
+            entryMap.emplace(entries.size(), entries.toStringList());
         }
 
         QStringList goodEntries; //The string list which contains the entries which are available in all modules
 
         auto it(entryMap.begin()); // iterator to go though all selected modules
-        QStringList refEntries = *(it->second); //copy the items for the first time
-        const QStringList *cmpEntries = (++it)->second; //list for comparision, starts with the second module in the map
+        QStringList refEntries = it->second; //copy the items for the first time
+        const QStringList *cmpEntries = &(++it)->second; //list for comparision, starts with the second module in the map
 
         // Testing for refEntries being empty is not needed for the set union
         // of all keys, but is a good idea since it is being updated in the
@@ -137,7 +248,7 @@ void CLexiconKeyChooser::refreshContent() {
                 std::back_inserter(goodEntries) //append valid entries to the end of goodEntries
             );
 
-            cmpEntries = ( ++it )->second; //this is a pointer to the string list of a new module
+            cmpEntries = &( ++it )->second; //this is a pointer to the string list of a new module
 
             /*
             * use the good entries for next comparision,
@@ -24,6 +24,7 @@ class CKeyChooserWidget;
 class CSwordKey;
 class CSwordLDKey;
 class CSwordLexiconModuleInfo;
+class QCompleter;
 class QHBoxLayout;
 class QWidget;
 
@@ -55,6 +56,14 @@ public Q_SLOTS:
 private: // fields:
 
     CKeyChooserWidget * m_widget;
+    QCompleter * m_defaultCompleter;
+    QCompleter * m_entriesCompleter;
+
+    /**
+      Whether the single module is a daily devotional whose entries are not
+      cached yet, so that only the current key is listed until they are.
+    */
+    bool m_seeksDirectly = false;
     CSwordLDKey * m_key;
     QList<CSwordLexiconModuleInfo const *> m_modules;
 
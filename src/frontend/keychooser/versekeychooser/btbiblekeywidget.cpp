@@ -12,12 +12,15 @@
 
 #include "btbiblekeywidget.h"
 
+#include <QAction>
 #include <QApplication>
 #include <QDebug>
 #include <QEvent>
 #include <QFocusEvent>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QLineEdit>
+#include <QList>
 #include <QMenu>
 #include <QMouseEvent>
 #include <QPixmap>
@@ -32,6 +35,47 @@
 #include "btdropdownchooserbutton.h"
 
 
+namespace {
+
+/*
+  The actions of the book, chapter and verse menus are shared by the menus of
+  all key widgets, so opening a menu does not create an action per item. The
+  actions are owned by the application.
+*/
+
+/**
+  \returns the actions for the given books. These are cached by the list of
+           the names, which depends on the versification, the bounds of the
+           module and the locale.
+*/
+QList<QAction *> const & bookActions(QStringList const & books) {
+    static QHash<QString, QList<QAction *>> cache;
+    auto & actions = cache[books.join(QChar('\n'))];
+    if (actions.isEmpty()) {
+        actions.reserve(books.size());
+        for (auto const & bookname : books) {
+            auto * const action = new QAction(bookname, qApp);
+            action->setProperty("bookname", bookname);
+            actions.append(action);
+        }
+    }
+    return actions;
+}
+
+/** \returns the actions for the numbers from 1 to the given count. */
+QList<QAction *> numberActions(int const count) {
+    static QList<QAction *> actions;
+    while (actions.size() < count) {
+        auto const n = static_cast<int>(actions.size()) + 1;
+        auto * const action = new QAction(QString::number(n), qApp);
+        action->setProperty("number", n);
+        actions.append(action);
+    }
+    return actions.mid(0, count);
+}
+
+} // anonymous namespace
+
 class BtLineEdit : public QLineEdit {
     public:
         BtLineEdit(QWidget* parent)
@@ -126,7 +170,7 @@ BtBibleKeyWidget::BtBibleKeyWidget(
     QHBoxLayout *dropDownButtonsLayout(new QHBoxLayout(m_dropDownButtons));
 
     auto * const bookChooser =
-            new BtDropdownChooserButton(&BtBibleKeyWidget::populateBookMenu,
+            new BtDropdownChooserButton(&BtBibleKeyWidget::bookMenuActions,
                                         *this);
     bookChooser->setToolTip(tr("Select book"));
     BT_CONNECT(bookChooser->menu(), &QMenu::triggered,
@@ -143,12 +187,12 @@ BtBibleKeyWidget::BtBibleKeyWidget(
     dropDownButtonsLayout->addWidget(bookChooser, 2);
 
     auto * const chapterChooser =
-            new BtDropdownChooserButton(&BtBibleKeyWidget::populateChapterMenu,
+            new BtDropdownChooserButton(&BtBibleKeyWidget::chapterMenuActions,
                                         *this);
     chapterChooser->setToolTip(tr("Select chapter"));
     BT_CONNECT(chapterChooser->menu(), &QMenu::triggered,
                [this](QAction * const action) {
-                   int const n = action->property("chapter").toInt();
+                   int const n = action->property("number").toInt();
                    if (m_key->chapter() != n) {
                        m_key->setChapter(n);
                        updateText();
@@ -162,12 +206,12 @@ BtBibleKeyWidget::BtBibleKeyWidget(
     dropDownButtonsLayout->addWidget(chapterChooser, 1);
 
     auto * const verseChooser =
-            new BtDropdownChooserButton(&BtBibleKeyWidget::populateVerseMenu,
+            new BtDropdownChooserButton(&BtBibleKeyWidget::verseMenuActions,
                                         *this);
     verseChooser->setToolTip(tr("Select verse"));
     BT_CONNECT(verseChooser->menu(), &QMenu::triggered,
                [this](QAction * const action) {
-                   int const n = action->property("verse").toInt();
+                   int const n = action->property("number").toInt();
                    if (m_key->verse() != n) {
                        m_key->setVerse(n);
                        updateText();
@@ -315,19 +359,16 @@ bool BtBibleKeyWidget::setKey(CSwordVerseKey *key) {
     return true;
 }
 
-void BtBibleKeyWidget::populateBookMenu(QMenu & menu) {
-    for (auto const & bookname : m_module->books())
-        menu.addAction(bookname)->setProperty("bookname", bookname);
-}
+QList<QAction *> BtBibleKeyWidget::bookMenuActions()
+{ return bookActions(m_module->books()); }
 
-void BtBibleKeyWidget::populateChapterMenu(QMenu & menu) {
-    int count = m_module->chapterCount(m_key->bibleBook());
-    for (int i = 1; i <= count; i++)
-        menu.addAction(QString::number(i))->setProperty("chapter", i);
+QList<QAction *> BtBibleKeyWidget::chapterMenuActions() {
+    return numberActions(
+                static_cast<int>(m_module->chapterCount(m_key->bibleBook())));
 }
 
-void BtBibleKeyWidget::populateVerseMenu(QMenu & menu) {
-    int count = m_module->verseCount(m_key->bookName(), m_key->chapter());
-    for (int i = 1; i <= count; i++)
-        menu.addAction(QString::number(i))->setProperty("verse", i);
+QList<QAction *> BtBibleKeyWidget::verseMenuActions() {
+    return numberActions(
+                static_cast<int>(m_module->verseCount(m_key->bookName(),
+                                                      m_key->chapter())));
 }
@@ -14,13 +14,14 @@
 
 #include <QWidget>
 
+#include <QList>
 #include <QTimer>
 #include "../../../backend/drivers/cswordbiblemoduleinfo.h"
 
 
 class CSwordVerseKey;
+class QAction;
 class QLineEdit;
-class QMenu;
 
 class BtBibleKeyWidget : public QWidget  {
         Q_OBJECT
@@ -49,9 +50,10 @@ class BtBibleKeyWidget : public QWidget  {
 
     private: // methods:
 
-        void populateBookMenu(QMenu & menu);
-        void populateChapterMenu(QMenu & menu);
-        void populateVerseMenu(QMenu & menu);
+        /** \returns the shared actions of the items of the book menu. */
+        QList<QAction *> bookMenuActions();
+        QList<QAction *> chapterMenuActions();
+        QList<QAction *> verseMenuActions();
 
     private:
 
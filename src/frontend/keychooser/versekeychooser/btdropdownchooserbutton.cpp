@@ -20,10 +20,10 @@
 const unsigned int ARROW_HEIGHT = 15;
 
 BtDropdownChooserButton::BtDropdownChooserButton(
-        void (BtBibleKeyWidget::*populateMenu)(QMenu &),
+        QList<QAction *> (BtBibleKeyWidget::*menuActions)(),
         BtBibleKeyWidget & parent)
     : QToolButton(&parent)
-    , m_populateMenu(populateMenu)
+    , m_menuActions(menuActions)
     , m_parent(parent)
 {
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
@@ -45,9 +45,12 @@ BtDropdownChooserButton::BtDropdownChooserButton(
 
 
 void BtDropdownChooserButton::mousePressEvent(QMouseEvent* e) {
-    //recreate the menu
-    menu()->clear();
-    (m_parent.*m_populateMenu)(*menu());
+    // Replace the items of the menu with the shared actions, if changed:
+    auto const actions((m_parent.*m_menuActions)());
+    if (menu()->actions() != actions) {
+        menu()->clear();
+        menu()->addActions(actions);
+    }
 
     QToolButton::mousePressEvent(e);
 }
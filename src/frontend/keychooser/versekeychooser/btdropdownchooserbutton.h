@@ -14,8 +14,11 @@
 
 #include <QToolButton>
 
+#include <QList>
+
 
 class BtBibleKeyWidget;
+class QAction;
 
 /**
 * Base class for book/ch/v dropdown list chooser buttons.
@@ -23,10 +26,14 @@ class BtBibleKeyWidget;
 class BtDropdownChooserButton : public QToolButton {
         Q_OBJECT
     public:
-        BtDropdownChooserButton(void (BtBibleKeyWidget::*populateMenu)(QMenu &),
-                                BtBibleKeyWidget & parent);
-
-        /** The item list is constructed here just before the menu is shown.*/
+        BtDropdownChooserButton(
+                QList<QAction *> (BtBibleKeyWidget::*menuActions)(),
+                BtBibleKeyWidget & parent);
+
+        /**
+          The items of the menu are replaced here just before the menu is
+          shown, unless they did not change.
+        */
         void mousePressEvent(QMouseEvent* event) override;
 
     protected: // methods:
@@ -39,7 +46,7 @@ class BtDropdownChooserButton : public QToolButton {
 
     private: // fields:
 
-        void (BtBibleKeyWidget::*m_populateMenu)(QMenu &);
+        QList<QAction *> (BtBibleKeyWidget::*m_menuActions)();
         BtBibleKeyWidget & m_parent;
 
 };
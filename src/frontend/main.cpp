@@ -10,19 +10,22 @@
 *
 **********/
 
+#include <cstring>
 #include <iostream>
+#include <optional>
 #include <QDateTime>
 #include <QLibraryInfo>
 #include <QLocale>
-#include <QQmlEngine>
 #include <QTranslator>
+#include <utility>
 #include "../backend/bookshelfmodel/btbookshelftreemodel.h"
+#include "../backend/btbatchjobs.h"
 #include "../backend/config/btconfig.h"
 #include "../backend/managers/cswordbackend.h"
+#include "../util/btstartupprofile.h"
 #include "../util/directory.h"
 #include "bibletime.h"
 #include "bibletimeapp.h"
-#include "display/modelview/btqmlinterface.h"
 #include "welcome/btwelcomedialog.h"
 
 // Sword includes:
@@ -32,6 +35,25 @@
 
 namespace {
 
+/** The batch jobs requested on the command line. */
+struct BatchJobs {
+    QStringList indexModules;
+    QStringList searchModules;
+    QStringList queries;
+    int threads = 0;
+    BtBatchOutputFormat format = BtBatchOutputFormat::Json;
+
+    bool isEmpty() const noexcept
+    { return indexModules.isEmpty() && queries.isEmpty(); }
+};
+
+/** The scrolling benchmark requested on the command line. */
+struct ScrollBenchmark {
+    QList<QStringList> layouts;
+    QStringList keys;
+    QStringList templates;
+};
+
 /*******************************************************************************
   Printing command-line help.
 *******************************************************************************/
@@ -55,6 +77,59 @@ void printHelp(const QString &executable) {
               << qPrintable(QObject::tr("Open the default Bible with the "
                                         "reference <ref>"))
               << std::endl << std::endl
+              << "    --profile-startup" << std::endl << "        "
+              << qPrintable(QObject::tr("Print the time and heap growth of "
+                                        "every phase of the startup"))
+              << std::endl << std::endl
+              << "    --benchmark-scrolling <module,...>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Measure the frame times of scrolling "
+                                        "a window of the given modules in "
+                                        "parallel and exit, may be given "
+                                        "multiple times"))
+              << std::endl << std::endl
+              << "    --benchmark-key <key>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Scroll the windows of "
+                                        "--benchmark-scrolling from <key>, may "
+                                        "be given multiple times"))
+              << std::endl << std::endl
+              << "    --benchmark-template <template>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Scroll the windows of "
+                                        "--benchmark-scrolling with the "
+                                        "display template <template>, may be "
+                                        "given multiple times"))
+              << std::endl << std::endl
+              << "    --build-index <module>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Build the index of <module> without "
+                                        "user interface and exit, may be given "
+                                        "multiple times"))
+              << std::endl << std::endl
+              << "    --search <query>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Search <query> in the modules given "
+                                        "by --search-module without user "
+                                        "interface and exit, may be given "
+                                        "multiple times"))
+              << std::endl << std::endl
+              << "    --search-module <module>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Search in <module>, may be given "
+                                        "multiple times"))
+              << std::endl << std::endl
+              << "    --cores <n>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Build every index with <n> threads"))
+              << std::endl << std::endl
+              << "    --output-format <json|tsv>" << std::endl
+              << "        "
+              << qPrintable(QObject::tr("Write the results of --build-index "
+                                        "and --search as JSON objects (the "
+                                        "default) or tab-separated values, one "
+                                        "per line"))
+              << std::endl << std::endl
               << qPrintable(QObject::tr("For command-line arguments parsed by the"
                                         " Qt toolkit, see %1.")
                             .arg("http://doc.qt.nokia.com/latest/qapplication.html"))
@@ -68,7 +143,10 @@ void printHelp(const QString &executable) {
 /**
   Parses all command-line arguments.
   \param[out] ignoreSession Whether --ignore-session was specified.
+  \param[out] profileStartup Whether --profile-startup was specified.
   \param[out] openBibleKey Will be set to --open-default-bible if specified.
+  \param[out] scrollBenchmark The options of the scrolling benchmark.
+  \param[out] batchJobs The batch jobs given with --build-index and --search.
   \retval -1 Parsing was successful, the application should exit with
              EXIT_SUCCESS.
   \retval 0 Parsing was successful.
@@ -76,9 +154,24 @@ void printHelp(const QString &executable) {
 */
 int parseCommandLine(bool & showDebugMessages,
                      bool & ignoreSession,
-                     QString & openBibleKey)
+                     bool & profileStartup,
+                     QString & openBibleKey,
+                     ScrollBenchmark & scrollBenchmark,
+                     BatchJobs & batchJobs)
 {
     QStringList args = BibleTimeApp::arguments();
+    auto const nextArgument =
+            [&args](int & i) -> std::optional<QString> {
+                auto const & option = args.at(i);
+                if (++i < args.size())
+                    return args.at(i);
+                std::cerr << qPrintable(
+                                 QObject::tr("Error: %1 expects an argument. "
+                                             "See --help for details.")
+                                 .arg(option))
+                          << std::endl;
+                return {};
+            };
     for (int i = 1; i < args.size(); i++) {
         const QString &arg = args.at(i);
         if (arg == QStringLiteral("--help")
@@ -98,16 +191,69 @@ int parseCommandLine(bool & showDebugMessages,
             showDebugMessages = true;
         } else if (arg == QStringLiteral("--ignore-session")) {
             ignoreSession = true;
+        } else if (arg == QStringLiteral("--profile-startup")) {
+            profileStartup = true;
         } else if (arg == QStringLiteral("--open-default-bible")) {
-            i++;
-            if (i < args.size()) {
-                openBibleKey = args.at(i);
+            auto key = nextArgument(i);
+            if (!key)
+                return 1;
+            openBibleKey = std::move(*key);
+        } else if (arg == QStringLiteral("--benchmark-scrolling")) {
+            auto const modules = nextArgument(i);
+            if (!modules)
+                return 1;
+            scrollBenchmark.layouts.append(
+                        modules->split(u',', Qt::SkipEmptyParts));
+        } else if (arg == QStringLiteral("--benchmark-key")) {
+            auto key = nextArgument(i);
+            if (!key)
+                return 1;
+            scrollBenchmark.keys.append(std::move(*key));
+        } else if (arg == QStringLiteral("--benchmark-template")) {
+            auto templateName = nextArgument(i);
+            if (!templateName)
+                return 1;
+            scrollBenchmark.templates.append(std::move(*templateName));
+        } else if (arg == QStringLiteral("--build-index")) {
+            auto module = nextArgument(i);
+            if (!module)
+                return 1;
+            batchJobs.indexModules.append(std::move(*module));
+        } else if (arg == QStringLiteral("--search")) {
+            auto query = nextArgument(i);
+            if (!query)
+                return 1;
+            batchJobs.queries.append(std::move(*query));
+        } else if (arg == QStringLiteral("--search-module")) {
+            auto module = nextArgument(i);
+            if (!module)
+                return 1;
+            batchJobs.searchModules.append(std::move(*module));
+        } else if (arg == QStringLiteral("--cores")) {
+            auto const threads = nextArgument(i);
+            if (!threads)
+                return 1;
+            bool ok;
+            batchJobs.threads = threads->toInt(&ok);
+            if (!ok || batchJobs.threads < 1) {
+                std::cerr << qPrintable(
+                                 QObject::tr("Error: Invalid number of cores: "
+                                             "%1").arg(*threads))
+                          << std::endl;
+                return 1;
+            }
+        } else if (arg == QStringLiteral("--output-format")) {
+            auto const format = nextArgument(i);
+            if (!format)
+                return 1;
+            if (*format == QStringLiteral("json")) {
+                batchJobs.format = BtBatchOutputFormat::Json;
+            } else if (*format == QStringLiteral("tsv")) {
+                batchJobs.format = BtBatchOutputFormat::Tsv;
             } else {
-                std::cerr
-                        << qPrintable(
-                               QObject::tr("Error: %1 expects an argument. See "
-                                           "--help for details.")
-                               .arg(QStringLiteral("--open-default-bible")))
+                std::cerr << qPrintable(
+                                 QObject::tr("Error: Invalid output format: %1")
+                                 .arg(*format))
                           << std::endl;
                 return 1;
             }
@@ -118,9 +264,30 @@ int parseCommandLine(bool & showDebugMessages,
             return 1;
         }
     }
+    if (!batchJobs.queries.isEmpty() && batchJobs.searchModules.isEmpty()) {
+        std::cerr << qPrintable(
+                         QObject::tr("Error: %1 requires %2. See --help for "
+                                     "details.")
+                         .arg(QStringLiteral("--search"),
+                              QStringLiteral("--search-module")))
+                  << std::endl;
+        return 1;
+    }
     return 0;
 }
 
+/**
+  \returns whether the command-line arguments request batch jobs, which run
+           without any windows.
+*/
+bool hasBatchJobs(int const argc, char * argv[]) {
+    for (int i = 1; i < argc; ++i)
+        if (!std::strcmp(argv[i], "--build-index")
+            || !std::strcmp(argv[i], "--search"))
+            return true;
+    return false;
+}
+
 /*******************************************************************************
   Handle Qt's meta type system.
 *******************************************************************************/
@@ -134,14 +301,6 @@ void registerMetaTypes() {
     qRegisterMetaType<QList<int> >("QList<int>");
     qRegisterMetaType<BtBookshelfTreeModel::Grouping>(
         "BtBookshelfTreeModel::Grouping");
-
-    BtQmlInterface::typeId =
-        qmlRegisterSingletonType<BtQmlInterface>(
-            "BibleTime",
-            1,
-            0,
-            "BtQmlInterface",
-            [](QQmlEngine *, QJSEngine *) { return new BtQmlInterface(); });
 }
 
 } // anonymous namespace
@@ -161,19 +320,32 @@ int main(int argc, char* argv[]) {
 
     registerMetaTypes();
 
+    // Batch jobs also run on servers without any display:
+    if (hasBatchJobs(argc, argv)
+        && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     BibleTimeApp app(argc, argv); //for QApplication
 
     // Parse command line arguments:
     bool ignoreSession = false;
+    bool profileStartup = false;
     QString openBibleKey;
+    ScrollBenchmark scrollBenchmark;
+    BatchJobs batchJobs;
     {
         bool showDebugMessages = false;
         if (int const r = parseCommandLine(showDebugMessages,
                                            ignoreSession,
-                                           openBibleKey))
+                                           profileStartup,
+                                           openBibleKey,
+                                           scrollBenchmark,
+                                           batchJobs))
             return r < 0 ? EXIT_SUCCESS : EXIT_FAILURE;
         app.setDebugMode(showDebugMessages);
     }
+    if (profileStartup)
+        BtStartupProfile::enable();
 
     if (!DU::initDirectoryCache()) {
         qFatal("Error initializing directory cache!");
@@ -181,8 +353,10 @@ int main(int argc, char* argv[]) {
     }
 
     app.startInit();
-    if (!app.initBtConfig()) {
-        return EXIT_FAILURE;
+    {
+        BtStartupProfile::Phase const phase("BibleTimeApp::initBtConfig");
+        if (!app.initBtConfig())
+            return EXIT_FAILURE;
     }
 
     app.initLightDarkPalette();
@@ -213,25 +387,73 @@ int main(int argc, char* argv[]) {
         app.installTranslator(&bibleTimeTranslator);
 
     // Initialize display template manager:
-    if (!app.initDisplayTemplateManager()) {
-        qFatal("Error initializing display template manager!");
-        return EXIT_FAILURE;
+    {
+        BtStartupProfile::Phase const phase(
+                    "BibleTimeApp::initDisplayTemplateManager");
+        if (!app.initDisplayTemplateManager()) {
+            qFatal("Error initializing display template manager!");
+            return EXIT_FAILURE;
+        }
     }
 
-    app.initIcons();
+    if (!batchJobs.isEmpty()) {
+        app.initBackends();
+        bool success = true;
+        if (!batchJobs.indexModules.isEmpty())
+            success = batchBuildIndices(batchJobs.indexModules,
+                                        batchJobs.threads,
+                                        batchJobs.format,
+                                        std::cout);
+        if (!batchJobs.queries.isEmpty())
+            success = batchSearch(batchJobs.searchModules,
+                                  batchJobs.queries,
+                                  batchJobs.format,
+                                  std::cout)
+                      && success;
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    {
+        BtStartupProfile::Phase const phase("BibleTimeApp::initIcons");
+        app.initIcons();
+    }
 
-    auto * const mainWindow = new BibleTime(app);
+    BibleTime * mainWindow;
+    {
+        BtStartupProfile::Phase const phase("BibleTime::BibleTime");
+        mainWindow = new BibleTime(app);
+    }
     mainWindow->setAttribute(Qt::WA_DeleteOnClose);
 
     auto const showWelcome = CSwordBackend::instance().moduleList().empty();
     if (showWelcome && BtWelcomeDialog().exec() == QDialog::Accepted)
         mainWindow->slotBookshelfWizard();
 
-    mainWindow->show();
+    {
+        BtStartupProfile::Phase const phase("BibleTime::show");
+        mainWindow->show();
+    }
+
+    if (!scrollBenchmark.layouts.isEmpty()) {
+        if (scrollBenchmark.keys.isEmpty())
+            scrollBenchmark.keys.append(QString());
+        if (scrollBenchmark.templates.isEmpty())
+            scrollBenchmark.templates.append(QString());
+        bool const success =
+                mainWindow->benchmarkScrolling(scrollBenchmark.layouts,
+                                               scrollBenchmark.keys,
+                                               scrollBenchmark.templates,
+                                               std::cout);
+        mainWindow->close();
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
     // The following must be done after the bibletime window is visible:
     mainWindow->processCommandline(ignoreSession, openBibleKey);
 
+    if (profileStartup)
+        BtStartupProfile::writeReport(std::cout);
+
     if (!showWelcome
         && btConfig().value<bool>(QStringLiteral("GUI/showTipAtStartup"), true))
         mainWindow->slotOpenTipDialog();
@@ -0,0 +1,144 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "profilerwindow.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVBoxLayout>
+#include "../util/btconnect.h"
+#include "../util/bttrace.h"
+#include "messagedialog.h"
+
+
+ProfilerWindow::ProfilerWindow()
+    : QWidget(nullptr)
+    , m_updateTimerId(startTimer(500))
+{
+    setWindowFlags(Qt::Dialog);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    auto * const mainLayout = new QVBoxLayout(this);
+
+    m_statusLabel = new QLabel(this);
+    mainLayout->addWidget(m_statusLabel);
+
+    m_summaryTree = new QTreeWidget(this);
+    m_summaryTree->setRootIsDecorated(false);
+    m_summaryTree->setColumnCount(5);
+    m_summaryTree->setSortingEnabled(true);
+    m_summaryTree->header()->setSectionResizeMode(
+                QHeaderView::ResizeToContents);
+    mainLayout->addWidget(m_summaryTree);
+
+    auto * const buttonLayout = new QHBoxLayout;
+    m_recordButton = new QPushButton(this);
+    m_recordButton->setCheckable(true);
+    m_recordButton->setChecked(true);
+    BT_CONNECT(m_recordButton, &QPushButton::toggled,
+               this, [](bool const checked) { BtTrace::setEnabled(checked); });
+    buttonLayout->addWidget(m_recordButton);
+    m_clearButton = new QPushButton(this);
+    BT_CONNECT(m_clearButton, &QPushButton::clicked,
+               this, [this] {
+                   BtTrace::clear();
+                   updateSummary();
+               });
+    buttonLayout->addWidget(m_clearButton);
+    buttonLayout->addStretch();
+    m_exportButton = new QPushButton(this);
+    BT_CONNECT(m_exportButton, &QPushButton::clicked,
+               this, &ProfilerWindow::exportTrace);
+    buttonLayout->addWidget(m_exportButton);
+    mainLayout->addLayout(buttonLayout);
+
+    retranslateUi();
+    resize(640, 400);
+    BtTrace::setEnabled(true);
+    show();
+}
+
+ProfilerWindow::~ProfilerWindow() { BtTrace::setEnabled(false); }
+
+void ProfilerWindow::retranslateUi() {
+    setWindowTitle(tr("Profiler"));
+    m_summaryTree->setHeaderLabels({tr("Span"),
+                                    tr("Count"),
+                                    tr("Total (ms)"),
+                                    tr("p50 (ms)"),
+                                    tr("p99 (ms)")});
+    m_recordButton->setText(tr("Record"));
+    m_clearButton->setText(tr("Clear"));
+    m_exportButton->setText(tr("Export trace..."));
+    updateSummary();
+}
+
+void ProfilerWindow::timerEvent(QTimerEvent * const event) {
+    if (event->timerId() == m_updateTimerId) {
+        if (BtTrace::enabled())
+            updateSummary();
+    } else {
+        QWidget::timerEvent(event);
+    }
+}
+
+void ProfilerWindow::updateSummary() {
+    #ifdef BUILD_TRACING
+    auto const summary(BtTrace::summary());
+    std::size_t numSpans = 0u;
+    m_summaryTree->setUpdatesEnabled(false);
+    m_summaryTree->clear();
+    for (auto const & span : summary) {
+        numSpans += span.count;
+        auto * const item = new QTreeWidgetItem(m_summaryTree);
+        item->setText(0, span.name);
+        item->setData(1, Qt::DisplayRole, static_cast<qulonglong>(span.count));
+        item->setData(2, Qt::DisplayRole, span.totalMs);
+        item->setData(3, Qt::DisplayRole, span.p50Ms);
+        item->setData(4, Qt::DisplayRole, span.p99Ms);
+        for (int column = 1; column < 5; ++column)
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+    }
+    m_summaryTree->setUpdatesEnabled(true);
+    m_statusLabel->setText(tr("%n span(s) recorded.", nullptr,
+                              static_cast<int>(numSpans)));
+    #else
+    m_statusLabel->setText(tr("BibleTime was built without tracing support."));
+    m_recordButton->setEnabled(false);
+    m_clearButton->setEnabled(false);
+    m_exportButton->setEnabled(false);
+    #endif
+}
+
+void ProfilerWindow::exportTrace() {
+    auto const fileName =
+            QFileDialog::getSaveFileName(
+                this,
+                tr("Export trace"),
+                QStringLiteral("bibletime-trace.json"),
+                tr("Chrome trace files (*.json)"));
+    if (fileName.isEmpty())
+        return;
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(BtTrace::toChromeTraceJson()) < 0)
+        message::showCritical(this,
+                              tr("Export trace"),
+                              tr("Failed to write the trace to %1: %2")
+                                  .arg(fileName, file.errorString()));
+}
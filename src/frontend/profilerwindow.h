@@ -0,0 +1,55 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QWidget>
+
+
+class QLabel;
+class QPushButton;
+class QTreeWidget;
+
+/**
+  \brief Shows the number and latencies of the traced spans of hot paths.
+
+  Spans are recorded while the window is open and recording is not paused.
+  The recorded spans can be exported in the Chrome trace event format.
+*/
+class ProfilerWindow : public QWidget {
+
+    Q_OBJECT
+
+public: // methods:
+
+    ProfilerWindow();
+    ~ProfilerWindow() override;
+
+    void retranslateUi();
+
+    void timerEvent(QTimerEvent * const event) override;
+
+private: // methods:
+
+    void updateSummary();
+    void exportTrace();
+
+private: // fields:
+
+    int const m_updateTimerId;
+    QLabel * m_statusLabel;
+    QTreeWidget * m_summaryTree;
+    QPushButton * m_recordButton;
+    QPushButton * m_clearButton;
+    QPushButton * m_exportButton;
+
+}; // class ProfilerWindow
@@ -15,14 +15,18 @@
 #include <QApplication>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QGraphicsScene>
+#include <QGraphicsView>
 #include <QRect>
 #include <QScreen>
+#include <QTabWidget>
 #include <QtGlobal>
 #include <QVBoxLayout>
 #include <utility>
 #include "../../../backend/cswordmodulesearch.h"
 #include "../../../util/btconnect.h"
 #include "../../messagedialog.h"
+#include "csearchanalysisheatmapitem.h"
 #include "csearchanalysisscene.h"
 #include "csearchanalysisview.h"
 
@@ -42,9 +46,29 @@ CSearchAnalysisDialog::CSearchAnalysisDialog(
 
     m_analysis =
             new CSearchAnalysisScene(std::move(searchedText), results, this);
-    m_analysisView = new CSearchAnalysisView(m_analysis, this);
+    m_tabWidget = new QTabWidget(this);
+    m_analysisView = new CSearchAnalysisView(m_analysis, m_tabWidget);
     ////    m_analysisView->show();
-    vboxLayout->addWidget(m_analysisView);
+    m_tabWidget->addTab(m_analysisView, QString());
+
+    // The chapters of the books clicked in the bar chart are shown in detail:
+    auto * const heatmapScene = new QGraphicsScene(this);
+    heatmapScene->setBackgroundBrush(Qt::white);
+    m_heatmap = new CSearchAnalysisHeatmapItem(m_analysis->heatmapRows(),
+                                               m_analysis->moduleNames());
+    heatmapScene->addItem(m_heatmap);
+    m_heatmapView = new QGraphicsView(heatmapScene, m_tabWidget);
+    m_heatmapView->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    m_tabWidget->addTab(m_heatmapView, QString());
+    vboxLayout->addWidget(m_tabWidget);
+    BT_CONNECT(m_analysis, &CSearchAnalysisScene::bookActivated,
+               this,
+               [this](int const row) {
+                   auto const r = static_cast<std::size_t>(row);
+                   m_heatmap->setHighlightedRow(r);
+                   m_tabWidget->setCurrentWidget(m_heatmapView);
+                   m_heatmapView->ensureVisible(m_heatmap->rowRect(r));
+               });
 
     m_buttonBox = new QDialogButtonBox(
                         QDialogButtonBox::Save | QDialogButtonBox::Close,
@@ -79,7 +103,12 @@ void CSearchAnalysisDialog::showEvent(QShowEvent * const event) {
     resize(qMin(width, desktopWidth), DIALOG_HEIGHT);
 }
 
-void CSearchAnalysisDialog::retranslateUi()
-{ setWindowTitle(tr("Analysis of search results")); }
+void CSearchAnalysisDialog::retranslateUi() {
+    setWindowTitle(tr("Analysis of search results"));
+    m_tabWidget->setTabText(m_tabWidget->indexOf(m_analysisView),
+                            tr("Books"));
+    m_tabWidget->setTabText(m_tabWidget->indexOf(m_heatmapView),
+                            tr("Chapters"));
+}
 
 }
@@ -20,11 +20,14 @@
 
 
 class QDialogButtonBox;
+class QGraphicsView;
 class QResizeEvent;
+class QTabWidget;
 class QWidget;
 
 namespace Search {
 
+class CSearchAnalysisHeatmapItem;
 class CSearchAnalysisView;
 class CSearchAnalysisScene;
 
@@ -47,6 +50,9 @@ class CSearchAnalysisDialog : public QDialog {
     private:
         CSearchAnalysisScene* m_analysis;
         CSearchAnalysisView* m_analysisView;
+        QTabWidget * m_tabWidget;
+        CSearchAnalysisHeatmapItem * m_heatmap;
+        QGraphicsView * m_heatmapView;
         QDialogButtonBox* m_buttonBox;
         bool m_shown = false;
 };
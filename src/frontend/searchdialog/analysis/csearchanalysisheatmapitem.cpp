@@ -0,0 +1,180 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "csearchanalysisheatmapitem.h"
+
+#include <algorithm>
+#include <limits>
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QGraphicsSceneHoverEvent>
+#include <QObject>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <utility>
+#include "csearchanalysisscene.h"
+
+
+namespace Search {
+
+namespace {
+
+const int ITEM_TEXT_SIZE = 8;
+
+const int LABEL_WIDTH = 110;
+const int CELL_WIDTH = 7;
+const int CELL_HEIGHT = 5; // Per module
+const int ROW_SPACING = 3;
+
+} // anonymous namespace
+
+CSearchAnalysisHeatmapItem::CSearchAnalysisHeatmapItem(
+        std::vector<Row> const & rows,
+        QStringList moduleNames)
+    : m_rows(rows)
+    , m_moduleNames(std::move(moduleNames))
+    , m_maxCounts(static_cast<std::size_t>(m_moduleNames.size()), 0u)
+    , m_highlightedRow(std::numeric_limits<std::size_t>::max())
+{
+    for (auto const & row : m_rows) {
+        for (std::size_t i = 0u; i < row.chapterCounts.size(); ++i) {
+            auto const & counts = row.chapterCounts[i];
+            m_maxChapters = std::max(m_maxChapters, counts.size());
+            for (auto const count : counts)
+                m_maxCounts[i] = std::max(m_maxCounts[i], count);
+        }
+    }
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setAcceptHoverEvents(true);
+}
+
+qreal CSearchAnalysisHeatmapItem::rowHeight() const noexcept
+{ return m_moduleNames.size() * CELL_HEIGHT + ROW_SPACING; }
+
+QRectF CSearchAnalysisHeatmapItem::boundingRect() const {
+    return QRectF(0,
+                  0,
+                  LABEL_WIDTH + static_cast<qreal>(m_maxChapters) * CELL_WIDTH,
+                  static_cast<qreal>(m_rows.size()) * rowHeight());
+}
+
+QRectF CSearchAnalysisHeatmapItem::rowRect(std::size_t const row) const {
+    return QRectF(0,
+                  static_cast<qreal>(row) * rowHeight(),
+                  boundingRect().width(),
+                  rowHeight());
+}
+
+void CSearchAnalysisHeatmapItem::setHighlightedRow(std::size_t const row) {
+    m_highlightedRow = row;
+    update();
+}
+
+void CSearchAnalysisHeatmapItem::paint(QPainter * painter,
+                                       QStyleOptionGraphicsItem const * option,
+                                       QWidget *)
+{
+    if (m_rows.empty())
+        return;
+    QFont f = painter->font();
+    f.setPointSize(ITEM_TEXT_SIZE);
+    painter->setFont(f);
+    painter->setPen(Qt::NoPen);
+
+    // Only paint the rows and chapters in the exposed area:
+    auto const & exposed = option->exposedRect;
+    auto const firstRow =
+            static_cast<std::size_t>(std::max(exposed.top() / rowHeight(),
+                                              0.0));
+    auto const endRow =
+            std::min(static_cast<std::size_t>(exposed.bottom() / rowHeight())
+                     + 1u,
+                     m_rows.size());
+    auto const firstChapter =
+            static_cast<std::size_t>(
+                std::max((exposed.left() - LABEL_WIDTH) / CELL_WIDTH, 0.0));
+    auto const endChapter =
+            std::min(static_cast<std::size_t>(
+                         std::max((exposed.right() - LABEL_WIDTH) / CELL_WIDTH,
+                                  0.0)) + 1u,
+                     m_maxChapters);
+
+    QColor const emptyColor(240, 240, 240);
+    for (auto r = firstRow; r < endRow; ++r) {
+        auto const & row = m_rows[r];
+        auto const top = static_cast<qreal>(r) * rowHeight();
+        if (exposed.left() < LABEL_WIDTH) {
+            painter->setPen(Qt::black);
+            painter->drawText(QRectF(0, top, LABEL_WIDTH - 4, rowHeight()),
+                              Qt::AlignRight | Qt::AlignVCenter,
+                              row.bookName);
+            painter->setPen(Qt::NoPen);
+        }
+        for (std::size_t m = 0u; m < row.chapterCounts.size(); ++m) {
+            auto const & counts = row.chapterCounts[m];
+            auto color = CSearchAnalysisScene::getColor(static_cast<int>(m));
+            auto const y = top + static_cast<qreal>(m) * CELL_HEIGHT;
+            for (auto c = firstChapter; c < endChapter && c < counts.size();
+                 ++c)
+            {
+                QRectF const cell(
+                            LABEL_WIDTH + static_cast<qreal>(c) * CELL_WIDTH,
+                            y,
+                            CELL_WIDTH - 1,
+                            CELL_HEIGHT - 1);
+                if (auto const count = counts[c]) {
+                    // The more hits relative to the module, the more opaque:
+                    color.setAlpha(64 + static_cast<int>(
+                                       191u * count / m_maxCounts[m]));
+                    painter->fillRect(cell, color);
+                } else {
+                    painter->fillRect(cell, emptyColor);
+                }
+            }
+        }
+    }
+
+    if (m_highlightedRow >= firstRow && m_highlightedRow < endRow) {
+        painter->setPen(Qt::black);
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(rowRect(m_highlightedRow).adjusted(0, 0, -1, -1));
+    }
+}
+
+void CSearchAnalysisHeatmapItem::hoverMoveEvent(
+        QGraphicsSceneHoverEvent * const event)
+{
+    auto const pos = event->pos();
+    if (pos.x() >= LABEL_WIDTH && pos.y() >= 0) {
+        auto const r = static_cast<std::size_t>(pos.y() / rowHeight());
+        auto const m = static_cast<std::size_t>(
+                (pos.y() - static_cast<qreal>(r) * rowHeight()) / CELL_HEIGHT);
+        auto const c = static_cast<std::size_t>(
+                (pos.x() - LABEL_WIDTH) / CELL_WIDTH);
+        if (r < m_rows.size() && m < m_rows[r].chapterCounts.size()
+            && c < m_rows[r].chapterCounts[m].size())
+        {
+            setToolTip(
+                QObject::tr("%1 %2 in %3: %n hit(s)",
+                            nullptr,
+                            static_cast<int>(m_rows[r].chapterCounts[m][c]))
+                    .arg(m_rows[r].bookName)
+                    .arg(c + 1u)
+                    .arg(m_moduleNames[static_cast<qsizetype>(m)]));
+            return;
+        }
+    }
+    setToolTip({});
+}
+
+}
@@ -0,0 +1,84 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QGraphicsItem>
+
+#include <cstdint>
+#include <QRectF>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+
+class QGraphicsSceneHoverEvent;
+class QPainter;
+class QStyleOptionGraphicsItem;
+class QWidget;
+
+namespace Search {
+
+/**
+  \brief Paints the hits per chapter of every book and module as a grid of
+         cells, one row of cells per module and book.
+
+  The cells are painted directly by this single item, and only those in the
+  exposed area, since a result set covers thousands of chapters.
+*/
+class CSearchAnalysisHeatmapItem : public QGraphicsItem {
+
+public: // types:
+
+    struct Row {
+        QString bookName;
+
+        /** The hits per chapter of every module, indexed by chapter - 1. */
+        std::vector<std::vector<std::uint32_t>> chapterCounts;
+    };
+
+public: // methods:
+
+    /** \param[in] rows The rows to paint, which must outlive this item. */
+    CSearchAnalysisHeatmapItem(std::vector<Row> const & rows,
+                               QStringList moduleNames);
+
+    QRectF boundingRect() const override;
+
+    /** \returns the area of the given row of books. */
+    QRectF rowRect(std::size_t row) const;
+
+    void setHighlightedRow(std::size_t row);
+
+    void paint(QPainter * painter,
+               QStyleOptionGraphicsItem const * option,
+               QWidget * widget) override;
+
+protected: // methods:
+
+    void hoverMoveEvent(QGraphicsSceneHoverEvent * event) override;
+
+private: // methods:
+
+    qreal rowHeight() const noexcept;
+
+private: // fields:
+
+    std::vector<Row> const & m_rows;
+    QStringList const m_moduleNames;
+    std::vector<std::uint32_t> m_maxCounts; ///< Per module
+    std::size_t m_maxChapters = 0u;
+    std::size_t m_highlightedRow;
+
+};
+
+}
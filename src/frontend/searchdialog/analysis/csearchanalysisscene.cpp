@@ -13,13 +13,18 @@
 #include "csearchanalysisscene.h"
 
 #include <algorithm>
-#include <QApplication>
+#include <cstdint>
+#include <memory>
 #include <QFileDialog>
+#include <QGraphicsSceneMouseEvent>
 #include <QMap>
 #include <QTextStream>
 #include <QTextDocument>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include "../../../backend/bttaskscheduler.h"
 #include "../../../backend/drivers/cswordmoduleinfo.h"
 #include "../../../backend/keys/cswordversekey.h"
 #include "../../../util/btassert.h"
@@ -47,6 +52,73 @@ const int LEGEND_INNER_BORDER = 5;
 const int LEGEND_DELTAY = 4;
 const int LEGEND_WIDTH = 85;
 
+namespace {
+
+struct BookHits {
+    std::size_t count;
+    std::uint32_t firstVerseIndex; // To look up the name of the book with
+    std::vector<std::uint32_t> chapterCounts; // Indexed by chapter - 1
+};
+using BookHistogram = std::map<std::tuple<char, char>, BookHits>;
+
+/**
+  \brief Counts the hits per book and chapter of sorted verse based results.
+
+  Instead of materializing a key per hit, the key is only positioned at the
+  first hit of every book and chapter to find the last verse of the book or
+  chapter, and the hits up to that verse are counted by a binary search.
+*/
+BookHistogram countHitsPerBook(
+        CSwordModuleSearch::ModuleResultList const & results)
+{
+    BookHistogram r;
+    auto const & indices = results.verseIndices();
+    if (indices.empty())
+        return r;
+    auto const key = results.keyAt(0u);
+    BT_ASSERT(dynamic_cast<sword::VerseKey *>(key.get()));
+    auto & vk = static_cast<sword::VerseKey &>(*key);
+    for (auto it = indices.begin(); it != indices.end();) {
+        vk.setIndex(*it);
+        auto bookKey = std::tuple(vk.getTestament(), vk.getBook());
+        std::vector<std::uint32_t> chapterCounts(
+                    static_cast<std::size_t>(std::max(vk.getChapterMax(), 0)),
+                    0u);
+        vk.setChapter(vk.getChapterMax());
+        vk.setVerse(vk.getVerseMax());
+        auto end = std::upper_bound(it,
+                                    indices.end(),
+                                    static_cast<std::uint32_t>(vk.getIndex()));
+        if (end == it)
+            ++end;
+        for (auto chapterIt = it; chapterIt != end;) {
+            vk.setIndex(*chapterIt);
+            auto const chapter = vk.getChapter();
+            vk.setVerse(vk.getVerseMax());
+            auto chapterEnd =
+                    std::upper_bound(
+                        chapterIt,
+                        end,
+                        static_cast<std::uint32_t>(vk.getIndex()));
+            if (chapterEnd == chapterIt)
+                ++chapterEnd;
+            if (chapter > 0
+                && static_cast<std::size_t>(chapter) <= chapterCounts.size())
+                chapterCounts[static_cast<std::size_t>(chapter - 1)] =
+                        static_cast<std::uint32_t>(chapterEnd - chapterIt);
+            chapterIt = chapterEnd;
+        }
+        r.emplace(std::move(bookKey),
+                  BookHits{static_cast<std::size_t>(end - it),
+                           *it,
+                           std::move(chapterCounts)});
+        it = end;
+    }
+    return r;
+}
+
+} // anonymous namespace
+
 CSearchAnalysisScene::CSearchAnalysisScene(
         QString searchedText,
         CSwordModuleSearch::Results const & results,
@@ -65,41 +137,84 @@ CSearchAnalysisScene::CSearchAnalysisScene(
     auto const numberOfModules = m_results.size();
     if (!numberOfModules)
         return;
+
+    /* Fetch the remaining hits and count the hits per book and chapter of
+       every module in a separate task, since fetching hits might take a
+       while: */
+    std::vector<BookHistogram> histograms(numberOfModules);
+    {
+        std::vector<std::shared_ptr<BtTaskToken>> tokens;
+        tokens.reserve(numberOfModules);
+        for (std::size_t i = 0u; i < numberOfModules; ++i)
+            tokens.emplace_back(
+                    BtTaskScheduler::instance().submit(
+                        [&results = m_results[i].results,
+                         &histogram = histograms[i]](BtTaskToken &)
+                        {
+                            results = results.complete();
+                            results.sortVerses();
+                            histogram = countHitsPerBook(results);
+                        },
+                        BtTaskScheduler::Priority::Interactive));
+        for (auto const & token : tokens)
+            token->wait();
+    }
+
     m_legend = std::make_unique<CSearchAnalysisLegendItem>(&m_results);
     addItem(m_legend.get());
     m_legend->setRect(LEFT_BORDER, UPPER_BORDER,
                       LEGEND_WIDTH, LEGEND_INNER_BORDER*2 + ITEM_TEXT_SIZE*numberOfModules + LEGEND_DELTAY*(numberOfModules - 1) );
     m_legend->show();
 
-    int moduleIndex = 0;
-    for (auto const & result : m_results) {
-        qApp->processEvents(QEventLoop::AllEvents);
-        for (auto const & moduleresultPtr : result.results) {
-            /* m_results only contains results from Bibles and
-               Commentaries, as filtered above. */
-            BT_ASSERT(dynamic_cast<sword::VerseKey const *>(
-                          moduleresultPtr.get()));
-            auto const * const vk =
-                    static_cast<sword::VerseKey const *>(
-                        moduleresultPtr.get());
-            auto key = std::tuple(vk->getTestament(), vk->getBook());
+    for (std::size_t moduleIndex = 0u;
+         moduleIndex < numberOfModules;
+         ++moduleIndex)
+    {
+        auto const & histogram = histograms[moduleIndex];
+        if (histogram.empty())
+            continue;
+        /* m_results only contains results from Bibles and Commentaries, as
+           filtered above. */
+        auto const key = m_results[moduleIndex].results.keyAt(0u);
+        auto & vk = static_cast<sword::VerseKey &>(*key);
+        for (auto const & [bookKey, hits] : histogram) {
             CSearchAnalysisItem * analysisItem;
-            static_assert(std::is_same_v<decltype(key),
+            static_assert(std::is_same_v<std::decay_t<decltype(bookKey)>,
                                          decltype(m_itemList)::key_type>, "");
-            if (auto const it = m_itemList.find(key); it != m_itemList.end()) {
+            if (auto const it = m_itemList.find(bookKey);
+                it != m_itemList.end())
+            {
                 analysisItem = it->second;
             } else {
+                vk.setIndex(hits.firstVerseIndex);
                 analysisItem =
                         new CSearchAnalysisItem(
-                            QString::fromUtf8(vk->getBookName()),
+                            QString::fromUtf8(vk.getBookName()),
                             m_results.size());
-                m_itemList.emplace(std::move(key), analysisItem);
+                m_itemList.emplace(bookKey, analysisItem);
             }
-            auto const count = ++analysisItem->counts()[moduleIndex];
+            auto const count =
+                    analysisItem->counts()[static_cast<int>(moduleIndex)] +=
+                        hits.count;
             m_maxCount = std::max(m_maxCount, count);
         }
+    }
 
-        ++moduleIndex;
+    // Keep the hits per chapter for the heatmap, in the order of the bars:
+    m_heatmapRows.reserve(m_itemList.size());
+    for (auto const & [bookKey, analysisItem] : m_itemList) {
+        auto & row =
+                m_heatmapRows.emplace_back(
+                    CSearchAnalysisHeatmapItem::Row{analysisItem->bookName(),
+                                                    {}});
+        row.chapterCounts.reserve(numberOfModules);
+        for (auto & histogram : histograms) {
+            auto const it = histogram.find(bookKey);
+            row.chapterCounts.emplace_back(
+                        it != histogram.end()
+                        ? std::move(it->second.chapterCounts)
+                        : std::vector<std::uint32_t>());
+        }
     }
 
     int xPos = static_cast<int>(LEFT_BORDER
@@ -282,6 +397,27 @@ void CSearchAnalysisScene::saveAsHTML(QTextStream & out) const {
         << QStringLiteral("</p></body></html>");
 }
 
+QStringList CSearchAnalysisScene::moduleNames() const {
+    QStringList r;
+    for (auto const & result : m_results)
+        r.append(result.module->name());
+    return r;
+}
+
+void CSearchAnalysisScene::mousePressEvent(
+        QGraphicsSceneMouseEvent * const event)
+{
+    QGraphicsScene::mousePressEvent(event);
+    int row = 0;
+    for (auto const & vp : m_itemList) {
+        if (vp.second->contains(vp.second->mapFromScene(event->scenePos()))) {
+            Q_EMIT bookActivated(row);
+            return;
+        }
+        ++row;
+    }
+}
+
 void CSearchAnalysisScene::resizeHeight(int height) {
     setSceneRect(0, 0, sceneRect().width(), height);
     slotResized();
@@ -18,12 +18,16 @@
 #include <memory>
 #include <map>
 #include <QColor>
+#include <QStringList>
+#include <vector>
 #include "../../../backend/cswordmodulesearch.h"
+#include "csearchanalysisheatmapitem.h"
 #include "csearchanalysisitem.h"
 #include "csearchanalysislegenditem.h"
 
 
 class CSwordModuleInfo;
+class QGraphicsSceneMouseEvent;
 class QTextStream;
 
 namespace Search {
@@ -48,6 +52,23 @@ class CSearchAnalysisScene : public QGraphicsScene {
 
         void saveAsHTML() const;
 
+        /**
+          \returns the hits per chapter of every book and module, in the order
+                   of the bars of the books.
+        */
+        auto const & heatmapRows() const noexcept { return m_heatmapRows; }
+
+        QStringList moduleNames() const;
+
+    Q_SIGNALS:
+
+        /** Emitted when the bar of the book in the given row is clicked. */
+        void bookActivated(int row);
+
+    protected: // methods:
+
+        void mousePressEvent(QGraphicsSceneMouseEvent * event) override;
+
     protected Q_SLOTS:
         /**
         * No descriptions
@@ -64,6 +85,7 @@ class CSearchAnalysisScene : public QGraphicsScene {
         CSwordModuleSearch::Results m_results;
         std::map<std::tuple<char, char>, CSearchAnalysisItem *> m_itemList;
         std::size_t m_maxCount = 0;
+        std::vector<CSearchAnalysisHeatmapItem::Row> m_heatmapRows;
         std::unique_ptr<CSearchAnalysisLegendItem> m_legend;
 };
 
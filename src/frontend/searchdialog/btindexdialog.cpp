@@ -12,17 +12,23 @@
 
 #include "btindexdialog.h"
 
+#include <exception>
+#include <QApplication>
 #include <QCheckBox>
 #include <QHBoxLayout>
 #include <QFlags>
 #include <QList>
+#include <QMetaObject>
 #include <QPushButton>
 #include <QSizePolicy>
 #include <QSpacerItem>
 #include <QStringList>
+#include <QThread>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QVBoxLayout>
+#include <utility>
+#include <vector>
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
 #include "../../backend/managers/cswordbackend.h"
@@ -30,6 +36,7 @@
 #include "../../util/cresmgr.h"
 #include "../../util/tool.h"
 #include "../btmoduleindexdialog.h"
+#include "../messagedialog.h"
 
 
 BtIndexDialog::BtIndexDialog(QWidget * parent, Qt::WindowFlags f)
@@ -43,6 +50,9 @@ BtIndexDialog::BtIndexDialog(QWidget * parent, Qt::WindowFlags f)
     m_autoDeleteOrphanedIndicesBox = new QCheckBox(this);
     vboxLayout->addWidget(m_autoDeleteOrphanedIndicesBox);
 
+    m_indexAfterInstallBox = new QCheckBox(this);
+    vboxLayout->addWidget(m_indexAfterInstallBox);
+
     m_moduleList = new QTreeWidget(this);
     vboxLayout->addWidget(m_moduleList);
 
@@ -58,6 +68,10 @@ BtIndexDialog::BtIndexDialog(QWidget * parent, Qt::WindowFlags f)
     m_createButton->setIcon(CResMgr::bookshelfmgr::indexpage::icon_create());
     hboxLayout->addWidget(m_createButton);
 
+    m_combineButton = new QPushButton(this);
+    m_combineButton->setIcon(CResMgr::bookshelfmgr::indexpage::icon_create());
+    hboxLayout->addWidget(m_combineButton);
+
     m_closeButton = new QPushButton(this);
     m_closeButton->setIcon(CResMgr::searchdialog::icon_close());
     hboxLayout->addWidget(m_closeButton);
@@ -74,24 +88,46 @@ BtIndexDialog::BtIndexDialog(QWidget * parent, Qt::WindowFlags f)
                     QStringLiteral(
                         "settings/behaviour/autoDeleteOrphanedIndices"),
                     true));
+    m_indexAfterInstallBox->setChecked(
+                btConfig().value<bool>(
+                    QStringLiteral("settings/behaviour/indexAfterInstall"),
+                    false));
 
     // connect our signals/slots
     BT_CONNECT(m_createButton, &QPushButton::clicked,
                this,           &BtIndexDialog::createIndices);
     BT_CONNECT(m_deleteButton, &QPushButton::clicked,
                this,           &BtIndexDialog::deleteIndices);
+    BT_CONNECT(m_combineButton, &QPushButton::clicked,
+               this,            &BtIndexDialog::combineIndices);
     BT_CONNECT(m_closeButton, &QPushButton::clicked,
                this,          &BtIndexDialog::close);
     BT_CONNECT(&CSwordBackend::instance(), &CSwordBackend::sigSwordSetupChanged,
                this,  &BtIndexDialog::slotSwordSetupChanged);
     BT_CONNECT(m_autoDeleteOrphanedIndicesBox, &QCheckBox::checkStateChanged,
                this, &BtIndexDialog::autoDeleteOrphanedIndicesChanged);
+    BT_CONNECT(m_indexAfterInstallBox, &QCheckBox::checkStateChanged,
+               this, &BtIndexDialog::indexAfterInstallChanged);
 
     retranslateUi(); // also calls populateModuleList();
 }
 
+BtIndexDialog::~BtIndexDialog() { stopComputingIndexSizes(); }
+
+void BtIndexDialog::stopComputingIndexSizes() {
+    if (!m_indexSizeThread)
+        return;
+    m_stopComputingIndexSizes = true;
+    m_indexSizeThread->wait();
+    m_indexSizeThread.reset();
+    m_stopComputingIndexSizes = false;
+}
+
 /** Populates the module list with installed modules and orphaned indices */
 void BtIndexDialog::populateModuleList() {
+    // The items of the previous population are about to be deleted:
+    stopComputingIndexSizes();
+    auto const generation = ++m_populateGeneration;
     m_moduleList->clear();
 
     // populate installed modules
@@ -109,11 +145,19 @@ void BtIndexDialog::populateModuleList() {
                                    | Qt::ItemIsAutoTristate);
     m_modsWithoutIndices->setExpanded(true);
 
+    std::vector<std::pair<QTreeWidgetItem *, QString>> unknownSizes;
     for (auto const & modulePtr : CSwordBackend::instance().moduleList()) {
         if (modulePtr->hasIndex()) {
             auto item = new QTreeWidgetItem(m_modsWithIndices);
             item->setText(0, modulePtr->name());
-            item->setText(1, tr("%1 KiB").arg(modulePtr->indexSize() / 1024));
+            if (auto const size = modulePtr->recordedIndexSize()) {
+                item->setText(1, tr("%1 KiB").arg(*size / 1024));
+            } else {
+                item->setText(1, tr("Calculating..."));
+                unknownSizes.emplace_back(
+                            item,
+                            modulePtr->getModuleBaseIndexLocation());
+            }
             item->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
             item->setCheckState(0, Qt::Unchecked);
         } else {
@@ -124,6 +168,29 @@ void BtIndexDialog::populateModuleList() {
             item->setCheckState(0, Qt::Checked);
         }
     }
+
+    // Fill in the index sizes not recorded as they are computed:
+    if (unknownSizes.empty())
+        return;
+    m_indexSizeThread.reset(
+        QThread::create(
+            [this, generation, unknownSizes = std::move(unknownSizes)] {
+                for (auto const & [item, location] : unknownSizes) {
+                    if (m_stopComputingIndexSizes)
+                        return;
+                    auto const size =
+                            CSwordModuleInfo::computeIndexSize(location);
+                    QMetaObject::invokeMethod(
+                        this,
+                        [this, generation, item = item, size] {
+                            if (generation == m_populateGeneration)
+                                item->setText(1,
+                                              tr("%1 KiB").arg(size / 1024));
+                        },
+                        Qt::QueuedConnection);
+                }
+            }));
+    m_indexSizeThread->start(QThread::LowPriority);
 }
 
 void BtIndexDialog::retranslateUi() {
@@ -136,9 +203,20 @@ void BtIndexDialog::retranslateUi() {
                 tr("Automatically delete orphaned indexes when BibleTime "
                    "starts"));
 
+    m_indexAfterInstallBox->setToolTip(
+                tr("If selected, works are indexed in the background right "
+                   "after they have been installed"));
+    m_indexAfterInstallBox->setText(
+                tr("Automatically create indexes for newly installed works"));
+
     m_deleteButton->setToolTip(tr("Delete the selected indexes"));
     m_deleteButton->setText(tr("Delete"));
 
+    m_combineButton->setToolTip(
+                tr("Combine the indexes of the selected works, so that they "
+                   "are searched together in a single pass"));
+    m_combineButton->setText(tr("Combine"));
+
     m_closeButton->setText(tr("&Close"));
 
     m_createButton->setToolTip(tr("Create new indexes for the selected works"));
@@ -155,6 +233,11 @@ void BtIndexDialog::autoDeleteOrphanedIndicesChanged(int newState) {
                 newState == Qt::Checked);
 }
 
+void BtIndexDialog::indexAfterInstallChanged(int newState) {
+    btConfig().setValue(QStringLiteral("settings/behaviour/indexAfterInstall"),
+                        newState == Qt::Checked);
+}
+
 /** Creates indices for selected modules if no index currently exists */
 void BtIndexDialog::createIndices() {
     QList<CSwordModuleInfo *> moduleList;
@@ -195,4 +278,42 @@ void BtIndexDialog::deleteIndices() {
         populateModuleList();
 }
 
+/** Combines the indices of the selected modules into a single index */
+void BtIndexDialog::combineIndices() {
+    BtConstModuleList moduleList;
+
+    auto & backend = CSwordBackend::instance();
+    for (int i = 0; i < m_modsWithIndices->childCount(); ++i) {
+        if (m_modsWithIndices->child(i)->checkState(0) == Qt::Checked) {
+            if (auto * module = backend.findModuleByName(
+                                m_modsWithIndices->child(i)->text(0).toUtf8()))
+                moduleList.append(module);
+        }
+    }
+
+    // Combining fewer than two indices only removes the combined index:
+    if (moduleList.size() < 2) {
+        CSwordModuleInfo::deleteCombinedIndex();
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    try {
+        CSwordModuleInfo::buildCombinedIndex(moduleList);
+        QApplication::restoreOverrideCursor();
+    } catch (std::exception const & e) {
+        QApplication::restoreOverrideCursor();
+        message::showCritical(
+                    this,
+                    tr("Error"),
+                    tr("The indexes could not be combined: %1")
+                    .arg(QString::fromLocal8Bit(e.what())));
+    } catch (...) {
+        QApplication::restoreOverrideCursor();
+        message::showCritical(this,
+                              tr("Error"),
+                              tr("The indexes could not be combined."));
+    }
+}
+
 void BtIndexDialog::slotSwordSetupChanged() { populateModuleList(); }
@@ -14,6 +14,9 @@
 
 #include <QDialog>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <QObject>
 #include <QString>
 #include <Qt>
@@ -21,6 +24,7 @@
 
 class QCheckBox;
 class QPushButton;
+class QThread;
 class QTreeWidget;
 class QTreeWidgetItem;
 class QWidget;
@@ -38,28 +42,41 @@ public: // methods:
 
     BtIndexDialog(QWidget * parent = nullptr,
                   Qt::WindowFlags f = Qt::WindowFlags());
+    ~BtIndexDialog() override;
 
 private: // methods:
 
     void populateModuleList();
+
+    /** Stops computing the index sizes not recorded in the background. */
+    void stopComputingIndexSizes();
+
     void retranslateUi();
 
 private Q_SLOTS:
 
     void autoDeleteOrphanedIndicesChanged(int newState);
+    void indexAfterInstallChanged(int newState);
     void slotSwordSetupChanged();
     void createIndices();
     void deleteIndices();
+    void combineIndices();
 
 private: // fields:
 
     QCheckBox * m_autoDeleteOrphanedIndicesBox;
+    QCheckBox * m_indexAfterInstallBox;
     QTreeWidget * m_moduleList;
     QPushButton * m_deleteButton;
     QPushButton * m_createButton;
+    QPushButton * m_combineButton;
     QPushButton * m_closeButton;
 
     QTreeWidgetItem * m_modsWithIndices;
     QTreeWidgetItem * m_modsWithoutIndices;
 
+    std::unique_ptr<QThread> m_indexSizeThread;
+    std::atomic<bool> m_stopComputingIndexSizes{false};
+    std::uint64_t m_populateGeneration = 0u;
+
 };
@@ -12,6 +12,8 @@
 
 #include "btsearchoptionsarea.h"
 
+#include <algorithm>
+#include <QCheckBox>
 #include <QDebug>
 #include <QEvent>
 #include <QGridLayout>
@@ -19,8 +21,11 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPersistentModelIndex>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QVariant>
+#include "../../backend/btbookmarksmodel.h"
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/btconstmoduleset.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
@@ -32,9 +37,19 @@
 #include "btsearchsyntaxhelpdialog.h"
 #include "crangechooserdialog.h"
 
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <listkey.h>
+#include <versekey.h>
+#pragma GCC diagnostic pop
+
 
 namespace {
 auto const SearchTypeKey = QStringLiteral("GUI/SearchDialog/searchType");
+auto const SearchAsYouTypeKey =
+        QStringLiteral("GUI/SearchDialog/searchAsYouType");
 } // anonymous namespace
 
 namespace Search {
@@ -64,6 +79,9 @@ CSwordModuleSearch::SearchType BtSearchOptionsArea::searchType() {
     return CSwordModuleSearch::FullType;
 }
 
+bool BtSearchOptionsArea::searchAsYouType() const
+{ return m_searchAsYouTypeCheck->isChecked(); }
+
 void BtSearchOptionsArea::setSearchText(const QString& text) {
     bool found = false;
     int i = 0;
@@ -149,6 +167,11 @@ void BtSearchOptionsArea::initView() {
     fullButtonLayout->addWidget(m_typeFreeButton);
     fullButtonLayout->addWidget(m_helpLabel);
     typeSelectorLayout->addLayout(fullButtonLayout);
+
+    m_searchAsYouTypeCheck = new QCheckBox(tr("Search as you type"));
+    m_searchAsYouTypeCheck->setToolTip(
+                tr("Show the results while the search text is being typed"));
+    typeSelectorLayout->addWidget(m_searchAsYouTypeCheck);
     gridLayout->addLayout(typeSelectorLayout, 1, 1, 1, -1, Qt::AlignLeft | Qt::AlignTop);
 
     // ************* Label for search range/scope selector *************
@@ -208,6 +231,8 @@ void BtSearchOptionsArea::initConnections() {
     BT_CONNECT(m_searchButton, &QPushButton::clicked, startSearch);
     BT_CONNECT(m_searchTextCombo->lineEdit(), &QLineEdit::returnPressed,
                std::move(startSearch));
+    BT_CONNECT(m_searchTextCombo->lineEdit(), &QLineEdit::textEdited,
+               this, &BtSearchOptionsArea::sigSearchTextEdited);
     BT_CONNECT(m_chooseModulesButton, &QPushButton::clicked,
                this,                  &BtSearchOptionsArea::chooseModules);
     BT_CONNECT(m_chooseRangeButton, &QPushButton::clicked,
@@ -270,19 +295,12 @@ void BtSearchOptionsArea::setModules(const BtConstModuleList &modules) {
     m_modulesCombo->setToolTip(t);
     //Save the list in config here, not when deleting, because the history may be used
     // elsewhere while the dialog is still open
-    QStringList historyList;
-    for (int i = 0; i < m_modulesCombo->count(); ++i) {
-        historyList.append(m_modulesCombo->itemText(i));
-    }
-    btConfig().setValue(QStringLiteral("history/searchModuleHistory"),
-                        historyList);
+    m_moduleHistory.add(t);
 }
 
 QStringList BtSearchOptionsArea::getUniqueWorksList() {
     QSet<QString> moduleSet;
-    for (auto const & value
-         : btConfig().value<QStringList>(
-             QStringLiteral("history/searchModuleHistory")))
+    for (auto const & value : m_moduleHistory.items())
         for (auto const & name : value.split(QStringLiteral(", ")))
             moduleSet.insert(name);
     return moduleSet.values();
@@ -312,8 +330,6 @@ void BtSearchOptionsArea::reset() {
 void BtSearchOptionsArea::saveSettings() {
     btConfig().setValue(QStringLiteral("searchScopeCurrent"),
                         m_rangeChooserCombo->currentText());
-    btConfig().setValue(QStringLiteral("properties/searchTexts"),
-                        m_searchTextCombo->historyItems());
     CSwordModuleSearch::SearchType t = CSwordModuleSearch::FullType;
     if (m_typeAndButton->isChecked()) {
         t = CSwordModuleSearch::AndType;
@@ -322,29 +338,23 @@ void BtSearchOptionsArea::saveSettings() {
         t = CSwordModuleSearch::OrType;
     }
     btConfig().setValue(SearchTypeKey, t);
+    btConfig().setValue(SearchAsYouTypeKey,
+                        m_searchAsYouTypeCheck->isChecked());
 }
 
 void BtSearchOptionsArea::readSettings() {
-    auto const texts =
-            btConfig().value<QStringList>(
-                QStringLiteral("properties/searchTexts"));
     //for some reason the slot was called when setting the upmost item
     #if 0
     disconnect(m_searchTextCombo, &CHistoryComboBox::editTextChanged,
                this,              &BtSearchOptionsArea::slotValidateText);
     #endif
-    for (auto const & text : texts)
-        if (text.size() > 0)
-            m_searchTextCombo->addItem(text);
+    m_searchTextCombo->setHistoryStore(BtHistoryStore::searchTexts());
     #if 0
     BT_CONNECT(m_searchTextCombo, &CHistoryComboBox::editTextChanged,
                this,              &BtSearchOptionsArea::slotValidateText);
     #endif
 
-    m_modulesCombo->insertItems(
-                0,
-                btConfig().value<QStringList>(
-                    QStringLiteral("history/searchModuleHistory")));
+    m_modulesCombo->insertItems(0, m_moduleHistory.items());
     for (int i = 0; i < m_modulesCombo->count(); ++i) {
         m_modulesCombo->setItemData(i, m_modulesCombo->itemText(i), Qt::ToolTipRole);
     }
@@ -360,6 +370,9 @@ void BtSearchOptionsArea::readSettings() {
         default:
             m_typeFreeButton->setChecked(true);
     }
+
+    m_searchAsYouTypeCheck->setChecked(
+                btConfig().value<bool>(SearchAsYouTypeKey, false));
 }
 
 void BtSearchOptionsArea::refreshRanges() {
@@ -372,10 +385,39 @@ void BtSearchOptionsArea::refreshRanges() {
     //insert the user-defined ranges
     QStringList scopeModules = getUniqueWorksList();
     m_rangeChooserCombo->insertItems(1, btConfig().getSearchScopesForCurrentLocale(scopeModules).keys());
+
+    // The bookmark folders can be used as scopes as well:
+    if (auto const * const bookmarks = BtBookmarksModel::defaultModel()) {
+        for (auto const & folder : bookmarks->folders()) {
+            QStringList path;
+            for (auto i = folder; i.isValid(); i = i.parent())
+                path.prepend(i.data().toString());
+            m_rangeChooserCombo->addItem(
+                        tr("Bookmarks: %1").arg(path.join(u'/')),
+                        QVariant::fromValue(QPersistentModelIndex(folder)));
+        }
+    }
 }
 
 sword::ListKey BtSearchOptionsArea::searchScope() {
     QStringList scopeModules = getUniqueWorksList();
+    if (auto const folder =
+                m_rangeChooserCombo->currentData()
+                    .value<QPersistentModelIndex>();
+        folder.isValid())
+    {
+        for (auto const & moduleName : scopeModules) {
+            auto const * const module =
+                    CSwordBackend::instance().findModuleByName(moduleName);
+            if (module
+                && (module->type() == CSwordModuleInfo::Bible
+                    || module->type() == CSwordModuleInfo::Commentary))
+                return BtBookmarksModel::defaultModel()->folderScope(
+                            folder,
+                            sword::VerseKey(module->swordModule().getKey()));
+        }
+        return sword::ListKey();
+    }
     if (m_rangeChooserCombo->currentIndex() > 0) { //is not "no scope"
         QString const scope = btConfig().getSearchScopesForCurrentLocale(scopeModules)[
                                     m_rangeChooserCombo->currentText()];
@@ -385,6 +427,18 @@ sword::ListKey BtSearchOptionsArea::searchScope() {
     return sword::ListKey();
 }
 
+QString BtSearchOptionsArea::searchScopeName() const {
+    return (m_rangeChooserCombo->currentIndex() > 0) //is not "no scope"
+           ? m_rangeChooserCombo->currentText()
+           : QString();
+}
+
+void BtSearchOptionsArea::setSearchScopeName(QString const & name) {
+    auto const index =
+            name.isEmpty() ? -1 : m_rangeChooserCombo->findText(name);
+    m_rangeChooserCombo->setCurrentIndex(std::max(index, 0));
+}
+
 void BtSearchOptionsArea::addToHistory(const QString& text) {
     m_searchTextCombo->addToHistory(text);
 }
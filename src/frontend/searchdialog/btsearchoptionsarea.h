@@ -14,11 +14,13 @@
 
 #include <QWidget>
 
+#include "../../backend/config/bthistorystore.h"
 #include "../../backend/cswordmodulesearch.h"
 #include "../../backend/drivers/btmodulelist.h"
 #include "chistorycombobox.h"
 
 
+class QCheckBox;
 class QComboBox;
 class QEvent;
 class QGridLayout;
@@ -52,6 +54,9 @@ class BtSearchOptionsArea : public QWidget {
 
         CSwordModuleSearch::SearchType searchType();
 
+        /** \returns whether searching while typing is enabled. */
+        bool searchAsYouType() const;
+
         /**
           Returns the list of used modules.
         */
@@ -66,6 +71,12 @@ class BtSearchOptionsArea : public QWidget {
         */
         sword::ListKey searchScope();
 
+        /** \returns the name of the selected search scope, if any. */
+        QString searchScopeName() const;
+
+        /** Selects the search scope of the given name, if it exists. */
+        void setSearchScopeName(QString const & name);
+
         /**
          * Opens the modules chooser dialog.
          */
@@ -112,8 +123,12 @@ class BtSearchOptionsArea : public QWidget {
     Q_SIGNALS:
         void sigStartSearch();
 
+        /** Emitted when the user edited the search text. */
+        void sigSearchTextEdited();
+
     private:
         BtConstModuleList m_modules;
+        BtHistoryStore m_moduleHistory = BtHistoryStore::searchModules();
 
         QHBoxLayout *hboxLayout;
         QGroupBox *searchGroupBox;
@@ -124,6 +139,7 @@ class BtSearchOptionsArea : public QWidget {
         QRadioButton* m_typeAndButton;
         QRadioButton* m_typeOrButton;
         QRadioButton* m_typeFreeButton;
+        QCheckBox* m_searchAsYouTypeCheck;
         QPushButton *m_chooseModulesButton;
         QPushButton *m_chooseRangeButton;
         QLabel *m_searchScopeLabel;
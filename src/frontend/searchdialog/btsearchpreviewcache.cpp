@@ -0,0 +1,247 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#include "btsearchpreviewcache.h"
+
+#include <QThread>
+#include <utility>
+#include "../../backend/drivers/btmodulelist.h"
+#include "../../backend/drivers/cswordmoduleinfo.h"
+#include "../../backend/keys/cswordversekey.h"
+#include "../../backend/managers/colormanager.h"
+#include "../../backend/rendering/btrendercontextpool.h"
+#include "../../backend/rendering/cdisplayrendering.h"
+#include "../../util/btassert.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <swmodule.h>
+#include <versekey.h>
+#pragma GCC diagnostic pop
+
+
+//Maximum number of previews kept in memory
+constexpr static int const BT_MAX_CACHED_SEARCH_PREVIEWS = 64;
+
+namespace Search {
+
+BtSearchPreviewCache::BtSearchPreviewCache(QObject * const parent)
+    : QObject(parent)
+    , m_cache(BT_MAX_CACHED_SEARCH_PREVIEWS)
+{}
+
+BtSearchPreviewCache::~BtSearchPreviewCache() {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+        m_cancellation.cancel();
+    }
+    m_condition.notify_all();
+    if (m_thread)
+        m_thread->wait();
+}
+
+void BtSearchPreviewCache::setSettings(Settings settings) {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_settings = std::move(settings);
+    ++m_generation;
+    cancelRendering();
+    m_queue.clear();
+    m_cache.clear();
+}
+
+void BtSearchPreviewCache::clear() {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_settings.reset();
+    ++m_generation;
+    cancelRendering();
+    m_queue.clear();
+    m_cache.clear();
+}
+
+QString BtSearchPreviewCache::preview(CSwordModuleInfo const & module,
+                                      QString const & key)
+{
+    std::uint64_t generation;
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        BT_ASSERT(m_settings);
+        if (auto const * const cached = m_cache.object(key))
+            return *cached;
+        generation = m_generation;
+    }
+    auto text(renderPreview(module, key, *m_settings));
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (generation == m_generation)
+        m_cache.insert(key, new QString(text));
+    return text;
+}
+
+void BtSearchPreviewCache::prefetch(QStringList keys) {
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (m_stopping || !m_settings)
+            return;
+        keys.removeIf([this](QString const & key)
+                      { return m_cache.contains(key); });
+        m_queue = std::move(keys);
+        if (m_queue.isEmpty())
+            return;
+        if (!m_thread) {
+            m_thread.reset(QThread::create([this]{ work(); }));
+            m_thread->start(QThread::LowPriority);
+        }
+    }
+    m_condition.notify_one();
+}
+
+QString BtSearchPreviewCache::renderPreview(
+        CSwordModuleInfo const & module,
+        QString const & key,
+        Settings const & settings,
+        BtCancellationToken const & cancellation)
+{
+    using namespace Rendering;
+
+    QString text;
+    CDisplayRendering render(settings.displayOptions, settings.filterOptions);
+    render.setDisplayTemplateName(settings.displayTemplateName);
+
+    BtConstModuleList modules;
+    modules.append(&module);
+
+    CTextRendering::KeyTreeItem::Settings keySettings;
+
+    //for bibles render 5 context verses
+    if (module.type() == CSwordModuleInfo::Bible) {
+        CSwordVerseKey vk(&module);
+        vk.setIntros(true);
+        vk.setKey(key);
+
+        // HACK: enable headings for VerseKeys:
+        static_cast<sword::VerseKey *>(module.swordModule().getKey())
+                ->setIntros(true);
+
+        //first go back and then go forward the keys to be in context
+        vk.previous();
+        vk.previous();
+
+        //include Headings in display, they are indexed and searched too
+        if (vk.verse() == 1) {
+            if (vk.chapter() == 1) {
+                vk.setChapter(0);
+            }
+            vk.setVerse(0);
+        }
+
+        auto const startKey = vk;
+
+        vk.setKey(key);
+
+        vk.next();
+        vk.next();
+
+        keySettings.keyRenderingFace = CTextRendering::KeyTreeItem::Settings::CompleteShort;
+        text = render.renderKeyRange(startKey,
+                                     vk,
+                                     modules,
+                                     key,
+                                     keySettings,
+                                     cancellation);
+    }
+    //for commentaries only one verse, but with heading
+    else if (module.type() == CSwordModuleInfo::Commentary) {
+        CSwordVerseKey vk(&module);
+        vk.setIntros(true);
+        vk.setKey(key);
+
+        // HACK: enable headings for VerseKeys:
+        static_cast<sword::VerseKey *>(module.swordModule().getKey())
+                ->setIntros(true);
+
+        //include Headings in display, they are indexed and searched too
+        if (vk.verse() == 1) {
+            if (vk.chapter() == 1) {
+                vk.setChapter(0);
+            }
+            vk.setVerse(0);
+        }
+        auto const startKey = vk;
+
+        vk.setKey(key);
+
+        keySettings.keyRenderingFace = CTextRendering::KeyTreeItem::Settings::NoKey;
+        text = render.renderKeyRange(startKey,
+                                     vk,
+                                     modules,
+                                     key,
+                                     keySettings,
+                                     cancellation);
+    }
+    else {
+        text = render.renderSingleKey(key, modules, keySettings);
+    }
+    if (text.isNull())
+        return text;
+
+    text = settings.highlighter.apply(text);
+    text.replace(QStringLiteral("#CHAPTERTITLE#"), QString());
+    text.replace(QStringLiteral("#TEXT_ALIGN#"), QStringLiteral("left"));
+    return ColorManager::replaceColors(text, settings.displayTemplateName);
+}
+
+void BtSearchPreviewCache::cancelRendering() {
+    m_cancellation.cancel();
+    m_cancellation = BtCancellationToken::create();
+}
+
+void BtSearchPreviewCache::work() {
+    std::optional<Settings> settings;
+    std::uint64_t generation = 0u;
+    BtCancellationToken cancellation;
+    for (;;) {
+        QString key;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock,
+                             [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping)
+                return;
+            key = m_queue.takeFirst();
+            if (m_cache.contains(key))
+                continue;
+            if (!settings || generation != m_generation) {
+                settings = m_settings;
+                generation = m_generation;
+                cancellation = m_cancellation;
+            }
+        }
+
+        auto const context(
+                    Rendering::BtRenderContextPool::instance().acquire());
+        auto const * const module = context->findModule(settings->moduleName);
+        if (!module)
+            continue;
+        auto text(renderPreview(*module, key, *settings, cancellation));
+
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        if (!text.isNull() && generation == m_generation)
+            m_cache.insert(key, new QString(std::move(text)));
+    }
+}
+
+} // namespace Search
@@ -0,0 +1,121 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#pragma once
+
+#include <QObject>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <QCache>
+#include <QString>
+#include <QStringList>
+#include "../../backend/btglobal.h"
+#include "../../util/btcancellationtoken.h"
+#include "../../backend/cswordmodulesearch.h"
+
+
+class CSwordModuleInfo;
+class QThread;
+
+namespace Search {
+
+/**
+  \brief Renders the previews of search results and keeps the most recently
+         used ones in memory.
+
+  The previews of the keys passed to prefetch() are rendered ahead by a
+  background thread, which borrows a backend of its own (see
+  Rendering::BtRenderContextPool), so that moving through the results in the
+  list usually only needs to look up the cache.
+*/
+class BtSearchPreviewCache: public QObject {
+
+    Q_OBJECT
+
+public: // types:
+
+    struct Settings {
+        QString moduleName;
+        CSwordModuleSearch::Highlighter highlighter;
+        DisplayOptions displayOptions;
+        FilterOptions filterOptions;
+        QString displayTemplateName;
+    };
+
+public: // methods:
+
+    BtSearchPreviewCache(QObject * parent = nullptr);
+    ~BtSearchPreviewCache() override;
+
+    /** \returns the settings the previews are rendered with, if any. */
+    std::optional<Settings> const & settings() const noexcept
+    { return m_settings; }
+
+    /**
+      \brief Sets the settings to render subsequent previews with and drops all
+             cached and queued previews.
+    */
+    void setSettings(Settings settings);
+
+    /** \brief Drops the settings and all cached and queued previews. */
+    void clear();
+
+    /**
+      \returns the preview of the given key, which is rendered now by the
+               calling thread unless cached.
+      \param[in] module The module of settings() to render the preview from.
+    */
+    QString preview(CSwordModuleInfo const & module, QString const & key);
+
+    /**
+      \brief Replaces the queued keys with the given ones, whose previews are
+             rendered by the background thread unless cached.
+    */
+    void prefetch(QStringList keys);
+
+    /**
+      \returns the preview of the given key as shown in the search dialog, or
+               a null string if the given token was cancelled.
+    */
+    static QString renderPreview(
+            CSwordModuleInfo const & module,
+            QString const & key,
+            Settings const & settings,
+            BtCancellationToken const & cancellation = {});
+
+private: // methods:
+
+    /** \brief Cancels the previews being rendered with the old settings. */
+    void cancelRendering();
+
+    void work();
+
+private: // fields:
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::optional<Settings> m_settings;
+    std::uint64_t m_generation = 0u;
+    BtCancellationToken m_cancellation{BtCancellationToken::create()};
+    QStringList m_queue;
+    QCache<QString, QString> m_cache;
+    std::unique_ptr<QThread> m_thread;
+    bool m_stopping = false;
+
+}; /* class BtSearchPreviewCache */
+
+} // namespace Search
@@ -12,6 +12,7 @@
 
 #include "btsearchresultarea.h"
 
+#include <algorithm>
 #include <QApplication>
 #include <QFrame>
 #include <QMenu>
@@ -23,22 +24,17 @@
 #include <QWidget>
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
-#include "../../backend/managers/colormanager.h"
-#include "../../backend/keys/cswordversekey.h"
+#include "../../backend/managers/cdisplaytemplatemgr.h"
 #include "../../backend/rendering/cdisplayrendering.h"
 #include "../../util/btconnect.h"
 #include "../../util/tool.h"
+#include "btsearchpreviewcache.h"
 #include "cmoduleresultview.h"
 #include "csearchresultview.h"
 
-// Sword includes:
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wextra-semi"
-#pragma GCC diagnostic ignored "-Wsuggest-override"
-#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
-#include <swmodule.h>
-#pragma GCC diagnostic pop
 
+//Number of results after the selected one whose previews are rendered ahead
+constexpr static int const BT_PREFETCHED_SEARCH_PREVIEWS = 8;
 
 namespace {
 auto const MainSplitterSizesKey =
@@ -52,6 +48,7 @@ namespace Search {
 
 BtSearchResultArea::BtSearchResultArea(QWidget * parent)
     : QWidget(parent)
+    , m_previewCache(new BtSearchPreviewCache(this))
 {
     QVBoxLayout *mainLayout;
     QWidget *resultListsWidget;
@@ -133,17 +130,55 @@ void BtSearchResultArea::setSearchResult(QString searchedText,
 
     m_searchedText = std::move(searchedText);
     m_results = std::move(results);
+    CSwordModuleSearch::retainResults(m_results);
 
     // Populate listbox:
-    m_moduleListBox->setupTree(m_results, searchedText);
+    m_moduleListBox->setupTree(m_results, m_searchedText);
 
     // Pre-select the first module in the list:
     m_moduleListBox->setCurrentItem(m_moduleListBox->topLevelItem(0), 0);
 }
 
+void BtSearchResultArea::startSearchResult(QString searchedText,
+                                           BtConstModuleList const & modules)
+{
+    reset(); //clear current modules
+
+    m_searchedText = std::move(searchedText);
+    m_results.clear();
+    m_results.reserve(static_cast<std::size_t>(modules.size()));
+    for (auto const * const m : modules)
+        m_results.emplace_back(CSwordModuleSearch::ModuleSearchResult{m, {}});
+    m_moduleListBox->setupTree({}, m_searchedText);
+}
+
+void BtSearchResultArea::addModuleResult(
+        int const moduleIndex,
+        CSwordModuleSearch::ModuleResultList results)
+{
+    auto & result = m_results.at(static_cast<std::size_t>(moduleIndex));
+    result.results = std::move(results);
+    CSwordModuleSearch::retainResults(
+                m_results,
+                static_cast<std::size_t>(moduleIndex));
+    m_moduleListBox->addModuleResult(result, m_searchedText);
+
+    // Pre-select the first module in the list:
+    if (!m_moduleListBox->currentItem())
+        m_moduleListBox->setCurrentItem(m_moduleListBox->topLevelItem(0), 0);
+}
+
+bool BtSearchResultArea::hasResults() const {
+    return std::any_of(m_results.begin(),
+                       m_results.end(),
+                       [](CSwordModuleSearch::ModuleSearchResult const & r)
+                       { return !r.results.empty(); });
+}
+
 void BtSearchResultArea::reset() {
     m_moduleListBox->clear();
     m_resultListBox->clear();
+    m_previewCache->clear(); // The searched text might change
     clearPreview();
 }
 
@@ -153,91 +188,39 @@ void BtSearchResultArea::clearPreview() {
 }
 
 void BtSearchResultArea::updatePreview(const QString& key) {
-    using namespace Rendering;
-
     CSwordModuleInfo* module = m_moduleListBox->activeModule();
     if ( module ) {
-        QString text;
-        CDisplayRendering render;
-
-        BtConstModuleList modules;
-        modules.append(module);
-
-        CTextRendering::KeyTreeItem::Settings settings;
-
-        //for bibles render 5 context verses
-        if (module->type() == CSwordModuleInfo::Bible) {
-            CSwordVerseKey vk(module);
-            vk.setIntros(true);
-            vk.setKey(key);
-
-            // HACK: enable headings for VerseKeys:
-            static_cast<sword::VerseKey *>(module->swordModule().getKey())
-                    ->setIntros(true);
-
-            //first go back and then go forward the keys to be in context
-            vk.previous();
-            vk.previous();
-
-            //include Headings in display, they are indexed and searched too
-            if (vk.verse() == 1) {
-                if (vk.chapter() == 1) {
-                    vk.setChapter(0);
-                }
-                vk.setVerse(0);
-            }
-
-            auto const startKey = vk;
-
-            vk.setKey(key);
-
-            vk.next();
-            vk.next();
-
-            settings.keyRenderingFace = CTextRendering::KeyTreeItem::Settings::CompleteShort;
-            text = render.renderKeyRange(startKey, vk, modules, key, settings);
-        }
-        //for commentaries only one verse, but with heading
-        else if (module->type() == CSwordModuleInfo::Commentary) {
-            CSwordVerseKey vk(module);
-            vk.setIntros(true);
-            vk.setKey(key);
-
-            // HACK: enable headings for VerseKeys:
-            static_cast<sword::VerseKey *>(module->swordModule().getKey())
-                    ->setIntros(true);
-
-            //include Headings in display, they are indexed and searched too
-            if (vk.verse() == 1) {
-                if (vk.chapter() == 1) {
-                    vk.setChapter(0);
-                }
-                vk.setVerse(0);
-            }
-            auto const startKey = vk;
-
-            vk.setKey(key);
-
-            settings.keyRenderingFace = CTextRendering::KeyTreeItem::Settings::NoKey;
-            text = render.renderKeyRange(startKey, vk, modules, key, settings);
-        }
-        else {
-            text = render.renderSingleKey(key, modules, settings);
-        }
-
-        if (modules.count() > 0)
-            setBrowserFont(modules.at(0));
-
-        QString text2 =
-                CSwordModuleSearch::highlightSearchedText(text, m_searchedText);
-        text2.replace(QStringLiteral("#CHAPTERTITLE#"), QString());
-        text2.replace(QStringLiteral("#TEXT_ALIGN#"), QStringLiteral("left"));
-        text2 = ColorManager::replaceColors(text2);
-        m_previewDisplay->setText(text2);
-        m_previewDisplay->scrollToAnchor( CDisplayRendering::keyToHTMLAnchor(key) );
+        auto const & previewSettings = m_previewCache->settings();
+        if (!previewSettings || previewSettings->moduleName != module->name())
+            m_previewCache->setSettings(
+                        {module->name(),
+                         highlighter(*module),
+                         btConfig().getDisplayOptions(),
+                         btConfig().getFilterOptions(),
+                         CDisplayTemplateMgr::activeTemplateName()});
+
+        setBrowserFont(module);
+        m_previewDisplay->setText(m_previewCache->preview(*module, key));
+        m_previewDisplay->scrollToAnchor(
+                    Rendering::CDisplayRendering::keyToHTMLAnchor(key));
+
+        // Render the previews of the next results ahead:
+        m_previewCache->prefetch(
+                    m_resultListBox->keyTextsAfterCurrent(
+                        BT_PREFETCHED_SEARCH_PREVIEWS));
     }
 }
 
+CSwordModuleSearch::Highlighter
+BtSearchResultArea::highlighter(CSwordModuleInfo const & module) const {
+    for (auto const & result : m_results)
+        if (result.module == &module)
+            return CSwordModuleSearch::Highlighter(
+                        m_searchedText,
+                        result.results.queryTerms());
+    return CSwordModuleSearch::Highlighter(m_searchedText);
+}
+
 void BtSearchResultArea::setBrowserFont(const CSwordModuleInfo* const module) {
     if (module) {
             auto const lang = module->language();
@@ -22,6 +22,7 @@
 
 
 namespace Search {
+class BtSearchPreviewCache;
 class CModuleResultView;
 class CSearchResultView;
 }
@@ -87,6 +88,29 @@ class BtSearchResultArea : public QWidget {
         void setSearchResult(QString searchedText,
                              CSwordModuleSearch::Results results);
 
+        /**
+        * Prepares for the results of a search in the given modules, which are
+        * added by addModuleResult() as they become available.
+        */
+        void startSearchResult(QString searchedText,
+                               BtConstModuleList const & modules);
+
+        /**
+        * Adds the result of the module at the given index of the search.
+        */
+        void addModuleResult(int moduleIndex,
+                             CSwordModuleSearch::ModuleResultList results);
+
+        /** \returns whether any of the searched modules has a result. */
+        bool hasResults() const;
+
+        CSwordModuleSearch::Results const & results() const noexcept
+        { return m_results; }
+
+        /** \returns the search text of the results. */
+        QString const & searchedText() const noexcept
+        { return m_searchedText; }
+
         QSize sizeHint() const override {
             return baseSize();
         }
@@ -119,6 +143,13 @@ class BtSearchResultArea : public QWidget {
 
         void setBrowserFont(const CSwordModuleInfo* const module);
 
+        /**
+          \returns a highlighter of the terms matched in the given module by
+                   the searched text.
+        */
+        CSwordModuleSearch::Highlighter highlighter(
+                CSwordModuleInfo const & module) const;
+
     protected Q_SLOTS:
         /**
         * Update the preview of the selected key.
@@ -140,6 +171,7 @@ class BtSearchResultArea : public QWidget {
     private: // fields:
         QString m_searchedText;
         CSwordModuleSearch::Results m_results;
+        BtSearchPreviewCache * m_previewCache;
 
         CModuleResultView* m_moduleListBox;
         CSearchResultView* m_resultListBox;
@@ -0,0 +1,133 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#include "btsearchresultmodel.h"
+
+#include <utility>
+#include "../../backend/drivers/cswordmoduleinfo.h"
+#include "../../util/btassert.h"
+#include "../BtMimeData.h"
+
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <swkey.h>
+#pragma GCC diagnostic pop
+
+
+namespace Search {
+
+BtSearchResultModel::BtSearchResultModel(QObject * const parent)
+    : QAbstractListModel(parent)
+{}
+
+void BtSearchResultModel::setResults(
+        CSwordModuleInfo const * const module,
+        CSwordModuleSearch::ModuleResultList results)
+{
+    beginResetModel();
+    m_module = module;
+    m_results = std::move(results);
+    m_keyTexts.clear();
+    endResetModel();
+}
+
+void BtSearchResultModel::setKeyTexts(CSwordModuleInfo const * const module,
+                                      QStringList keyTexts)
+{
+    beginResetModel();
+    m_module = module;
+    m_results = CSwordModuleSearch::ModuleResultList();
+    m_keyTexts = std::move(keyTexts);
+    endResetModel();
+}
+
+void BtSearchResultModel::clear() {
+    beginResetModel();
+    m_module = nullptr;
+    m_results = CSwordModuleSearch::ModuleResultList();
+    m_keyTexts.clear();
+    endResetModel();
+}
+
+QString BtSearchResultModel::keyText(int const row) const {
+    BT_ASSERT(row >= 0 && row < rowCount());
+    if (!m_keyTexts.isEmpty())
+        return m_keyTexts.at(row);
+    return m_results.keyText(static_cast<std::size_t>(row));
+}
+
+int BtSearchResultModel::rowCount(QModelIndex const & parent) const {
+    if (parent.isValid())
+        return 0;
+    return m_keyTexts.isEmpty()
+           ? static_cast<int>(m_results.size())
+           : static_cast<int>(m_keyTexts.size());
+}
+
+QVariant BtSearchResultModel::data(QModelIndex const & index, int const role)
+        const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return {};
+    if (role == Qt::DisplayRole)
+        return keyText(index.row());
+    return {};
+}
+
+QVariant BtSearchResultModel::headerData(int const section,
+                                         Qt::Orientation const orientation,
+                                         int const role) const
+{
+    if (section == 0
+        && orientation == Qt::Horizontal
+        && role == Qt::DisplayRole)
+        return tr("Results");
+    return {};
+}
+
+Qt::ItemFlags BtSearchResultModel::flags(QModelIndex const & index) const {
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsDragEnabled;
+}
+
+bool BtSearchResultModel::canFetchMore(QModelIndex const & parent) const
+{ return !parent.isValid() && m_keyTexts.isEmpty() && m_results.hasMore(); }
+
+void BtSearchResultModel::fetchMore(QModelIndex const & parent) {
+    if (!canFetchMore(parent))
+        return;
+    auto const first = static_cast<int>(m_results.size());
+    auto const count = static_cast<int>(m_results.nextPageSize());
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    m_results.fetchMore();
+    endInsertRows();
+}
+
+QMimeData *
+BtSearchResultModel::mimeData(QModelIndexList const & indexes) const {
+    if (indexes.empty() || !m_module)
+        return nullptr;
+    BTMimeData::ItemList bookmarks;
+    for (auto const & index : indexes)
+        bookmarks.append({m_module->name(), keyText(index.row()), {}});
+    return new BTMimeData(std::move(bookmarks));
+}
+
+QStringList BtSearchResultModel::mimeTypes() const
+{ return QStringList(QStringLiteral("BibleTime/Bookmark")); }
+
+} // namespace Search
@@ -0,0 +1,78 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+
+#pragma once
+
+#include <QAbstractListModel>
+
+#include <QModelIndex>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include "../../backend/cswordmodulesearch.h"
+
+
+class CSwordModuleInfo;
+class QMimeData;
+
+namespace Search {
+
+/**
+  \brief A list model of the keys of search results.
+
+  The texts of the keys are only formatted when requested by the view, i.e.
+  for the visible rows, instead of for all results in advance. Results which
+  have not been fetched yet are fetched page by page as the view scrolls to
+  the end of the list.
+*/
+class BtSearchResultModel: public QAbstractListModel {
+
+    Q_OBJECT
+
+public: // methods:
+
+    BtSearchResultModel(QObject * parent = nullptr);
+
+    /** \brief Sets the results of the given module to list. */
+    void setResults(CSwordModuleInfo const * module,
+                    CSwordModuleSearch::ModuleResultList results);
+
+    /** \brief Sets the given key texts of the given module to list. */
+    void setKeyTexts(CSwordModuleInfo const * module, QStringList keyTexts);
+
+    /** \brief Removes all rows. */
+    void clear();
+
+    /** \returns the text of the key in the given row. */
+    QString keyText(int row) const;
+
+    int rowCount(QModelIndex const & parent = QModelIndex()) const override;
+    QVariant data(QModelIndex const & index, int role) const override;
+    QVariant headerData(int section,
+                        Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(QModelIndex const & index) const override;
+    bool canFetchMore(QModelIndex const & parent) const override;
+    void fetchMore(QModelIndex const & parent) override;
+    QMimeData * mimeData(QModelIndexList const & indexes) const override;
+    QStringList mimeTypes() const override;
+
+private: // fields:
+
+    CSwordModuleInfo const * m_module = nullptr;
+    CSwordModuleSearch::ModuleResultList m_results;
+    QStringList m_keyTexts;
+
+}; /* class BtSearchResultModel */
+
+} // namespace Search
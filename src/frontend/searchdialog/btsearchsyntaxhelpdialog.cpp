@@ -132,19 +132,20 @@ void BtSearchSyntaxHelpDialog::retranslateUi() {
                         "<tr><td><code>footnote:</code></td><td>%46</td></tr>"
                         "<tr><td><code>strong:</code></td><td>%47</td></tr>"
                         "<tr><td><code>morph:</code></td><td>%48</td></tr>"
+                        "<tr><td><code>unaccented:</code></td><td>%49</td></tr>"
                     "</table>"
                 "</p>"
                 "<p>"
-                    "%49<br/>"
+                    "%50<br/>"
                     "<table>"
-                        "<tr><td><code>%50</code></td><td>%51</td></tr>"
-                        "<tr><td><code>%52</code></td><td>%53</td></tr>"
-                        "<tr><td><code>%54</code></td><td>%55</td></tr>"
-                        "<tr><td><code>%56</code></td><td>%57</td></tr>"
+                        "<tr><td><code>%51</code></td><td>%52</td></tr>"
+                        "<tr><td><code>%53</code></td><td>%54</td></tr>"
+                        "<tr><td><code>%55</code></td><td>%56</td></tr>"
+                        "<tr><td><code>%57</code></td><td>%58</td></tr>"
                     "</table>"
                 "</p>"
-                "<h1><a name='lucene'>%58</a></h1>"
-                "<p>%59</p>"
+                "<h1><a name='lucene'>%59</a></h1>"
+                "<p>%60</p>"
             "</body></html>"
             )
         .arg(theTitle,
@@ -212,17 +213,18 @@ void BtSearchSyntaxHelpDialog::retranslateUi() {
              tr("Searches footnotes"),
              tr("Searches Strong's numbers"),
              tr("Searches morphology codes"),
-             tr("Examples:"),
-             tr("heading:Jesus", "Do not translate \"heading:\"."), // %50
+             tr("Searches the text ignoring accents and vowel points"),
+             tr("Examples:"), // %50
+             tr("heading:Jesus", "Do not translate \"heading:\"."),
              tr("Finds headings with 'Jesus'"),
              tr("footnote:Jesus AND footnote:said",
                 "Do not translate \"footnote:\" or \"AND\"."),
              tr("Finds footnotes with 'Jesus' and 'said'"),
-             tr("strong:G846", "Do not translate \"strong:\"."),
-             tr("Finds verses with Strong's Greek number 846"), // %55
+             tr("strong:G846", "Do not translate \"strong:\"."), // %55
+             tr("Finds verses with Strong's Greek number 846"),
              tr("morph:\"N-NSF\"", "Do not translate \"morph:\"."),
              tr("Finds verses with morphology code 'N-NSF'"),
-             tr("Other syntax features"),
+             tr("Other syntax features"), // %60
              tr("BibleTime uses the CLucene search engine. You can read more "
                 "on the <a href=\"%1\">lucene syntax web page</a> (in external "
                 "browser).")
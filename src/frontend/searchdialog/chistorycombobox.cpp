@@ -14,6 +14,7 @@
 
 #include <QCompleter>
 #include <QString>
+#include <utility>
 
 
 namespace Search {
@@ -33,6 +34,11 @@ void CHistoryComboBox::addToHistory(const QString& text) {
         removeItem(index);
     insertItem(1, text);
     setCurrentIndex(1);
+    if (m_store) {
+        m_store->add(text);
+        while (static_cast<std::size_t>(count()) > m_store->capacity() + 1u)
+            removeItem(count() - 1);
+    }
 }
 
 QStringList CHistoryComboBox::historyItems() const {
@@ -44,5 +50,13 @@ QStringList CHistoryComboBox::historyItems() const {
     }
     return items;
 }
+
+void CHistoryComboBox::setHistoryStore(BtHistoryStore store) {
+    m_store.emplace(std::move(store));
+    clear();
+    for (auto const & text : m_store->items())
+        addItem(text);
+}
+
 } //end of namespace Search
 
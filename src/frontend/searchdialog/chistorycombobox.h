@@ -14,9 +14,11 @@
 
 #include <QComboBox>
 
+#include <optional>
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include "../../backend/config/bthistorystore.h"
 
 
 class QWidget;
@@ -31,9 +33,16 @@ class CHistoryComboBox : public QComboBox {
         void addToHistory(const QString& item);
         QStringList historyItems() const;
 
+        /**
+          \brief Replaces the items with those of the given history, to which
+                 the items added to the history are saved from now on.
+        */
+        void setHistoryStore(BtHistoryStore store);
+
     protected:
 
     private:
+        std::optional<BtHistoryStore> m_store;
 };
 
 } //end of namespace Search
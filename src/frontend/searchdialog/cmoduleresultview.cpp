@@ -12,20 +12,30 @@
 
 #include "cmoduleresultview.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
 #include <QAction>
 #include <QContextMenuEvent>
+#include <QEventLoop>
+#include <QHash>
 #include <QMenu>
 #include <QProgressDialog>
 #include <QStringList>
+#include <QMetaObject>
 #include <QtAlgorithms>
+#include <QTimer>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
+#include <vector>
+#include "../../backend/btlemmaindex.h"
+#include "../../backend/bttaskscheduler.h"
+#include "../../backend/btversehitset.h"
 #include "../../backend/config/btconfig.h"
 #include "../../backend/cswordmodulesearch.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
 #include "../../backend/managers/cswordbackend.h"
-#include "../../backend/rendering/cdisplayrendering.h"
-#include "../../backend/rendering/ctextrendering.h"
 #include "../../util/btassert.h"
 #include "../../util/btconnect.h"
 #include "../../util/cresmgr.h"
@@ -33,45 +43,145 @@
 #include "../cexportmanager.h"
 #include "btsearchresultarea.h"
 
+// Sword includes:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wextra-semi"
+#pragma GCC diagnostic ignored "-Wsuggest-override"
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+#include <swbuf.h>
+#include <swmodule.h>
+#include <versekey.h>
+#pragma GCC diagnostic pop
+
 
 namespace Search {
 namespace {
 
-QString getStrongsNumberText(QString const & verseContent,
-                             int & startIndex,
-                             QString const & lemmaText)
+/**
+  Groups the keys of the results by the word texts containing them, in the
+  order of their first occurrence.
+  \param[in] wordTexts The word texts with the sorted entry indices of the
+                       entries they occur in.
+  \param[in] entryIndices The entry indices of the results in the order of
+                          the results.
+*/
+void groupStrongsResults(
+    QList<StrongsResult> & list,
+    QHash<QString, BtLemmaIndex::Postings> const & wordTexts,
+    CSwordModuleSearch::ModuleResultList const & result,
+    std::vector<std::uint32_t> const & entryIndices)
 {
-    static constexpr Qt::CaseSensitivity const cs = Qt::CaseInsensitive;
+    QHash<QString, qsizetype> listIndices;
+    listIndices.reserve(wordTexts.size());
+    std::size_t i = 0u;
+    for (auto const & swKey : result) {
+        auto const entryIndex = entryIndices[i++];
+        QString key;
+        for (auto it = wordTexts.cbegin(); it != wordTexts.cend(); ++it) {
+            if (!std::binary_search(it->begin(), it->end(), entryIndex))
+                continue;
+            if (key.isNull())
+                key = QString::fromUtf8(swKey.getText());
+            if (auto const listIt = listIndices.constFind(it.key());
+                listIt != listIndices.cend())
+            {
+                list[*listIt].addKeyName(key);
+            } else {
+                listIndices.insert(it.key(), list.size());
+                list.append(StrongsResult(it.key(), key));
+            }
+        }
+    }
+}
 
-    int index;
-    if (startIndex == 0) {
-        index = verseContent.indexOf(QStringLiteral("<body"));
-    } else {
-        index = startIndex;
+/**
+  Populates the list from the word texts in the lemma index of the module.
+  \returns whether the lemma index knew the word texts of the Strong's number.
+*/
+bool populateStrongsResultListFromIndex(
+    QList<StrongsResult> & list,
+    CSwordModuleInfo const * module,
+    CSwordModuleSearch::ModuleResultList const & result,
+    QString const & strongsNumber)
+{
+    auto const lemmaIndex(module->lemmaIndex());
+    if (!lemmaIndex)
+        return false;
+    auto const wordTexts(lemmaIndex->wordTexts(strongsNumber));
+    if (wordTexts.isEmpty())
+        return false;
+
+    std::vector<std::uint32_t> verseIndices;
+    verseIndices.reserve(result.size());
+    for (auto const & swKey : result) {
+        auto const * const vk = dynamic_cast<sword::VerseKey const *>(&swKey);
+        if (!vk)
+            return false;
+        verseIndices.emplace_back(static_cast<std::uint32_t>(vk->getIndex()));
     }
+    groupStrongsResults(list, wordTexts, result, verseIndices);
+    return true;
+}
 
-    // find all the "lemma=" inside the the content
-    while ((index = verseContent.indexOf(QStringLiteral("lemma="), index, cs))
-           != -1)
-    {
-        // get the strongs number after the lemma and compare it with the
-        // strongs number we are looking for
-        auto const idx1 = verseContent.indexOf('"', index) + 1;
-        auto idx2 = verseContent.indexOf('"', idx1 + 1);
-        auto const sNumber = verseContent.mid(idx1, idx2 - idx1);
-        if (sNumber == lemmaText) {
-            // strongs number is found now we need to get the text of this node
-            // search right until the '>' is found.  Get the text from here to
-            // the next '<'.
-            index = verseContent.indexOf('>', index, cs) + 1;
-            idx2  = verseContent.indexOf('<', index, cs);
-            startIndex = idx2;
-            return verseContent.mid(index, idx2 - index);
-        } else {
-            index += 6; // 6 is the length of "lemma="
+/**
+  Collects the word texts of the Strong's number from the entry attributes of
+  the results like indexing does, i.e. without rendering the entries. The
+  entries are read by the calling thread from a backend of its own.
+  \param[out] progress The number of results read so far.
+  \returns the word texts with the positions of the results containing them.
+*/
+QHash<QString, BtLemmaIndex::Postings> collectStrongsWordTexts(
+    QString const & moduleName,
+    CSwordModuleSearch::ModuleResultList const & result,
+    QString const & strongsNumber,
+    BtTaskToken & token)
+{
+    auto const backend(CSwordBackend::createWorkerInstance());
+    auto * const module = backend->findModuleByName(moduleName);
+    if (!module)
+        return {};
+    backend->setOption(CSwordModuleInfo::strongNumbers, 1);
+    auto & swordModule = module->swordModule();
+    swordModule.setProcessEntryAttributes(true);
+
+    BtLemmaIndex lemmaIndex;
+    std::uint32_t position = 0u;
+    for (auto const & swKey : result) {
+        swordModule.setKey(swKey);
+        swordModule.getEntryAttributes().clear();
+        {
+            auto const lock(CSwordBackend::lockSwordFiles());
+            swordModule.stripText();
         }
+        for (auto const & vp : swordModule.getEntryAttributes()["Word"]) {
+            auto const & attrs = vp.second;
+            auto const textIter(attrs.find("Text"));
+            if (textIter == attrs.end())
+                continue;
+            auto const wordText(
+                        QString::fromUtf8(textIter->second.c_str())
+                        .simplified());
+            auto const partCountIter(attrs.find("PartCount"));
+            int const partCount = (partCountIter != attrs.end())
+                                  ? QString(partCountIter->second).toInt()
+                                  : 0;
+            for (int i = 0; i < partCount; ++i) {
+                sword::SWBuf lemmaKey = "Lemma";
+                if (partCount > 1)
+                    lemmaKey.appendFormatted(".%d", i + 1);
+                auto const lemmaIter(attrs.find(lemmaKey));
+                if (lemmaIter != attrs.end())
+                    lemmaIndex.add(
+                                BtLemmaIndex::Kind::Lemma,
+                                QString::fromUtf8(lemmaIter->second.c_str()),
+                                position,
+                                wordText);
+            }
+        }
+        token.setProgress(++position, result.size());
     }
-    return {};
+    lemmaIndex.finish();
+    return lemmaIndex.wordTexts(strongsNumber);
 }
 
 void populateStrongsResultList(
@@ -80,49 +190,51 @@ void populateStrongsResultList(
     CSwordModuleSearch::ModuleResultList const & result,
     QString const & strongsNumber)
 {
-    using namespace Rendering;
+    // The lemma index usually answers this without reading any verses:
+    if (populateStrongsResultListFromIndex(list, module, result, strongsNumber))
+        return;
+    list.clear();
 
     auto const count = result.size();
     if (!count)
         return;
 
-    CTextRendering::KeyTreeItem::Settings settings;
-    BtConstModuleList modules;
-    modules.append(module);
-
-           // for whatever reason the text "Parsing...translations." does not appear.
-           // this is not critical but the text is necessary to get the dialog box
-           // to be wide enough.
-    QProgressDialog progress(QObject::tr("Parsing Strong's Numbers"), nullptr, 0, count);
-    //0, "progressDialog", tr("Parsing Strong's Numbers"), tr("Parsing Strong's numbers for translations."), true);
-    //progress->setAllowCancel(false);
-    //progress->setMinimumDuration(0);
-    progress.show();
-    progress.raise();
-
-    qApp->processEvents(QEventLoop::AllEvents, 1); //1 ms only
-
-    int index = 0;
-    for (auto const & keyPtr : result) {
-        progress.setValue(index++);
-        qApp->processEvents(QEventLoop::AllEvents, 1); //1 ms only
-
-        QString key = QString::fromUtf8(keyPtr->getText());
-        QString text = CDisplayRendering().renderSingleKey(key, modules, settings);
-        for (int sIndex = 0;;) {
-        continueloop:
-            QString rText = getStrongsNumberText(text, sIndex, strongsNumber);
-            if (rText.isEmpty()) break;
-
-            for (auto & result : list) {
-                if (result.keyText() == rText) {
-                    result.addKeyName(key);
-                    goto continueloop; // break, then continue
-                }
-            }
-            list.append(StrongsResult(rText, key));
-        }
-    }
+    QProgressDialog progress(QObject::tr("Parsing Strong's Numbers"),
+                             nullptr,
+                             0,
+                             static_cast<int>(count));
+    progress.setWindowModality(Qt::ApplicationModal);
+    progress.setMinimumDuration(0);
+
+    // Read the entries in a worker thread to keep the user interface alive:
+    QHash<QString, BtLemmaIndex::Postings> wordTexts;
+    QEventLoop eventLoop;
+    auto const token(
+            BtTaskScheduler::instance().submit(
+                [&wordTexts, &eventLoop, &result, &strongsNumber,
+                 moduleName = module->name()](BtTaskToken & token)
+                {
+                    wordTexts = collectStrongsWordTexts(moduleName,
+                                                        result,
+                                                        strongsNumber,
+                                                        token);
+                    QMetaObject::invokeMethod(&eventLoop,
+                                              &QEventLoop::quit,
+                                              Qt::QueuedConnection);
+                },
+                BtTaskScheduler::Priority::Interactive));
+    QTimer progressTimer;
+    BT_CONNECT(&progressTimer, &QTimer::timeout,
+               &progress,
+               [&progress, &token]
+               { progress.setValue(static_cast<int>(token->done())); });
+    progressTimer.start(100);
+    eventLoop.exec();
+    token->wait();
+
+    std::vector<std::uint32_t> positions(count);
+    std::iota(positions.begin(), positions.end(), 0u);
+    groupStrongsResults(list, wordTexts, result, positions);
 }
 
 } // anonymous namespace
@@ -164,7 +276,7 @@ void CModuleResultView::initView() {
                [this]{
                    if (auto * const m = activeModule())
                        CExportManager(true, tr("Copying search result"))
-                               .copyKeyList(m_results[m],
+                               .copyKeyList(m_results[m].complete(),
                                             m,
                                             CExportManager::Text,
                                             false);
@@ -175,7 +287,7 @@ void CModuleResultView::initView() {
                [this]{
                    if (auto * const m = activeModule())
                        CExportManager(true, tr("Copying search result"))
-                               .copyKeyList(m_results[m],
+                               .copyKeyList(m_results[m].complete(),
                                             m,
                                             CExportManager::Text,
                                             true);
@@ -190,7 +302,7 @@ void CModuleResultView::initView() {
                [this]{
                    if (auto * const m = activeModule())
                        CExportManager(true, tr("Saving search result"))
-                               .saveKeyList(m_results[m],
+                               .saveKeyList(m_results[m].complete(),
                                             m,
                                             CExportManager::Text,
                                             false);
@@ -201,7 +313,7 @@ void CModuleResultView::initView() {
                [this]{
                    if (auto * const m = activeModule())
                        CExportManager(true, tr("Saving search result"))
-                               .saveKeyList(m_results[m],
+                               .saveKeyList(m_results[m].complete(),
                                             m,
                                             CExportManager::Text,
                                             true);
@@ -216,13 +328,125 @@ void CModuleResultView::initView() {
                [this]{
                    if (auto * const m = activeModule())
                        CExportManager(true, tr("Printing search result"))
-                               .printKeyList(m_results[m],
+                               .printKeyList(m_results[m].complete(),
                                              m,
                                              btConfig().getDisplayOptions(),
                                              btConfig().getFilterOptions());
                });
     m_actions.printMenu->addAction(m_actions.print.result);
     m_popup->addMenu(m_actions.printMenu);
+
+    m_actions.compareMenu = new QMenu(tr("Compare..."), m_popup);
+    m_actions.compareMenu->setToolTip(
+                tr("Compare the hits of the work with those of other works"));
+    m_popup->addMenu(m_actions.compareMenu);
+}
+
+void CModuleResultView::updateCompareMenu() {
+    auto * const menu = m_actions.compareMenu;
+    menu->clear();
+
+    // Only the hits of verse based works can be compared:
+    auto const isVerseBased =
+            [this](CSwordModuleInfo const * const m) {
+                auto const it = m_results.constFind(m);
+                return it != m_results.cend() && !it->versification().isNull();
+            };
+    auto const * const module = currentItem() ? activeModule() : nullptr;
+    BtConstModuleList modules;
+    if (module && isVerseBased(module)) {
+        for (int i = 0; i < topLevelItemCount(); ++i) {
+            auto const * const m =
+                    CSwordBackend::instance().findModuleByName(
+                        topLevelItem(i)->text(0));
+            if (m && m != module && isVerseBased(m))
+                modules.append(m);
+        }
+    }
+    menu->setEnabled(!modules.isEmpty());
+    if (modules.isEmpty())
+        return;
+
+    auto const addComparisons =
+            [this, menu, module, &modules](QString const & title,
+                                           Comparison const comparison)
+            {
+                auto * const subMenu = menu->addMenu(title);
+                auto const addAction =
+                        [this, subMenu, module, comparison](
+                                QString const & text,
+                                BtConstModuleList compared)
+                        {
+                            BT_CONNECT(subMenu->addAction(text),
+                                       &QAction::triggered,
+                                       [this, module, comparison,
+                                        compared = std::move(compared)]
+                                       {
+                                           addComparison(module,
+                                                         comparison,
+                                                         compared);
+                                       });
+                        };
+                if (modules.size() > 1)
+                    addAction(tr("All other works"), modules);
+                for (auto const * const m : modules)
+                    addAction(m->name(), {m});
+            };
+    addComparisons(tr("Hits also in"), Comparison::Intersection);
+    addComparisons(tr("Hits not in"), Comparison::Difference);
+    addComparisons(tr("Hits here or in"), Comparison::Union);
+}
+
+void CModuleResultView::addComparison(CSwordModuleInfo const * const module,
+                                      Comparison const comparison,
+                                      BtConstModuleList const & modules)
+{
+    auto const & results = m_results[module];
+    auto const versification(results.versification());
+    auto hits(BtVerseHitSet::fromResults(results, versification));
+    BT_ASSERT(hits);
+
+    // Compare in the versification system of the module:
+    BtVerseHitSet otherHits(versification);
+    for (auto const * const m : modules) {
+        auto const moduleHits(BtVerseHitSet::fromResults(m_results[m],
+                                                         versification));
+        BT_ASSERT(moduleHits);
+        if (comparison == Comparison::Intersection) {
+            *hits &= *moduleHits;
+        } else {
+            otherHits |= *moduleHits;
+        }
+    }
+    if (comparison == Comparison::Difference) {
+        *hits -= otherHits;
+    } else if (comparison == Comparison::Union) {
+        *hits |= otherHits;
+    }
+
+    QStringList moduleNames;
+    for (auto const * const m : modules)
+        moduleNames.append(m->name());
+    auto const names(moduleNames.join(QStringLiteral(", ")));
+    QString text;
+    switch (comparison) {
+    case Comparison::Intersection: text = tr("Also in %1").arg(names); break;
+    case Comparison::Difference: text = tr("Not in %1").arg(names); break;
+    case Comparison::Union: text = tr("Or in %1").arg(names); break;
+    }
+
+    auto compared(results.withVerseIndices(hits->verseIndices()));
+    auto * moduleItem = currentItem();
+    while (moduleItem->parent())
+        moduleItem = moduleItem->parent();
+    auto * const item =
+            new QTreeWidgetItem(moduleItem,
+                                QStringList{text,
+                                            QString::number(compared.size())});
+    m_comparisons.insert(item, std::move(compared));
+    setRootIsDecorated(true);
+    moduleItem->setExpanded(true);
+    setCurrentItem(item);
 }
 
 /** Initializes the connections of this widget, */
@@ -240,56 +464,62 @@ void CModuleResultView::setupTree(const CSwordModuleSearch::Results & results,
     clear();
     m_results.clear();
     m_strongsResults.clear();
+    m_comparisons.clear();
+    setRootIsDecorated(false);
 
-    bool strongsAvailable = false;
-
-    for (auto const & result : results) {
-        auto const * const m = result.module;
-        BT_ASSERT(!m_results.contains(m));
-        m_results.insert(m, result.results);
-        QTreeWidgetItem * const item =
-                new QTreeWidgetItem(this,
-                                    QStringList(m->name())
-                                    << QString::number(result.results.size()));
+    for (auto const & result : results)
+        addModuleResult(result, searchedText);
+}
 
-        item->setIcon(0, m->moduleIcon());
+void CModuleResultView::addModuleResult(
+        CSwordModuleSearch::ModuleSearchResult const & result,
+        QString const & searchedText)
+{
+    auto const * const m = result.module;
+    BT_ASSERT(!m_results.contains(m));
+    m_results.insert(m, result.results);
+    QTreeWidgetItem * const item =
+            new QTreeWidgetItem(this,
+                                QStringList(m->name())
+                                << QString::number(
+                                       result.results.totalSize()));
+
+    item->setIcon(0, m->moduleIcon());
+    /*
+      We need to make a decision here.  Either don't show any Strong's
+      number translations, or show the first one in the search text, or
+      figure out how to show them all. I choose option number 2 at this time.
+    */
+
+    // strong search text index for finding "strong:"
+    int sstIndex = searchedText.indexOf(QStringLiteral("strong:"), 0);
+    if (sstIndex != -1) {
         /*
-          We need to make a decision here.  Either don't show any Strong's
-          number translations, or show the first one in the search text, or
-          figure out how to show them all. I choose option number 2 at this time.
+          Get the strongs number from the search text. First find the first
+          space after "strong:". This should indicate a change in search
+          token
         */
-
-        // strong search text index for finding "strong:"
-        int sstIndex = searchedText.indexOf(QStringLiteral("strong:"), 0);
-        if (sstIndex != -1) {
-            /*
-              Get the strongs number from the search text. First find the first
-              space after "strong:". This should indicate a change in search
-              token
-            */
-            sstIndex += 7;
-            const int sTokenIndex = searchedText.indexOf(' ', sstIndex);
-            const QString sNumber(searchedText.mid(sstIndex, sTokenIndex - sstIndex));
-
-            QList<StrongsResult> strongResultList;
-            populateStrongsResultList(strongResultList,
-                                      m,
-                                      result.results,
-                                      sNumber);
-            for (auto const & strongResult : strongResultList)
-                new QTreeWidgetItem(
-                    item,
-                    QStringList{strongResult.keyText(),
-                                QString::number(strongResult.keyCount())});
-            m_strongsResults[m] = std::move(strongResultList);
-
-            /// \todo item->setOpen(true);
-            strongsAvailable = true;
-        }
+        sstIndex += 7;
+        const int sTokenIndex = searchedText.indexOf(' ', sstIndex);
+        const QString sNumber(searchedText.mid(sstIndex, sTokenIndex - sstIndex));
+
+        QList<StrongsResult> strongResultList;
+        populateStrongsResultList(strongResultList,
+                                  m,
+                                  result.results.complete(),
+                                  sNumber);
+        for (auto const & strongResult : strongResultList)
+            new QTreeWidgetItem(
+                item,
+                QStringList{strongResult.keyText(),
+                            QString::number(strongResult.keyCount())});
+        m_strongsResults[m] = std::move(strongResultList);
+
+        /// \todo item->setOpen(true);
+
+        // Allow to hide the module strongs if there are any available
+        setRootIsDecorated(true);
     }
-
-    // Allow to hide the module strongs if there are any available
-    setRootIsDecorated( strongsAvailable );
 }
 
 /// \todo
@@ -301,6 +531,14 @@ void CModuleResultView::executed( QTreeWidgetItem* i, QTreeWidgetItem*) {
         return;
     }
 
+    if (auto const it = m_comparisons.constFind(i);
+        it != m_comparisons.cend())
+    {
+        Q_EMIT moduleChanged();
+        Q_EMIT moduleSelected(activeModule(), *it);
+        return;
+    }
+
     auto const & itemText = i->text(0);
     if (auto * const m = CSwordBackend::instance().findModuleByName(itemText)) {
         Q_EMIT moduleChanged();
@@ -335,6 +573,7 @@ CSwordModuleInfo* CModuleResultView::activeModule() {
 /** Reimplementation from QWidget. */
 void CModuleResultView::contextMenuEvent( QContextMenuEvent * event ) {
     //make sure that all entries have the correct status
+    updateCompareMenu();
     m_popup->exec(event->globalPos());
 }
 
@@ -45,6 +45,13 @@ class CModuleResultView : public QTreeWidget {
         void setupTree(const CSwordModuleSearch::Results &results,
                        const QString &searchedText);
 
+        /**
+        * Adds the results of a single module to the tree.
+        */
+        void addModuleResult(
+                CSwordModuleSearch::ModuleSearchResult const & result,
+                QString const & searchedText);
+
         /**
         * Returns the currently active module.
         */
@@ -59,6 +66,12 @@ class CModuleResultView : public QTreeWidget {
         * Initializes this widget.
         */
         void initView();
+
+        /**
+        * Fills the compare menu with the works the active module can be
+        * compared with.
+        */
+        void updateCompareMenu();
         /**
         * Initializes the connections of this widget
         */
@@ -80,6 +93,18 @@ class CModuleResultView : public QTreeWidget {
         void moduleChanged();
         void strongsSelected(CSwordModuleInfo*, const QStringList&);
 
+    private: // types:
+        enum class Comparison { Intersection, Difference, Union };
+
+    private: // methods:
+        /**
+        * Adds the hits of the given module compared to those of the given
+        * modules as a child item of the module.
+        */
+        void addComparison(CSwordModuleInfo const * module,
+                           Comparison comparison,
+                           BtConstModuleList const & modules);
+
     private:
         struct {
             QMenu* saveMenu;
@@ -102,6 +127,8 @@ class CModuleResultView : public QTreeWidget {
             }
             copy;
 
+            QMenu* compareMenu;
+
         } m_actions;
 
         QMenu* m_popup;
@@ -109,6 +136,8 @@ class CModuleResultView : public QTreeWidget {
         QHash<CSwordModuleInfo const *, CSwordModuleSearch::ModuleResultList>
                 m_results;
         QHash<CSwordModuleInfo const *, QList<StrongsResult>> m_strongsResults;
+        QHash<QTreeWidgetItem const *, CSwordModuleSearch::ModuleResultList>
+                m_comparisons;
         QSize m_size;
 };
 
@@ -13,21 +13,28 @@
 #include "csearchdialog.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QFileDialog>
 #include <QLabel>
+#include <QLocale>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QSizePolicy>
 #include <QString>
 #include <QRegularExpression>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 #include <utility>
+#include "../../backend/btindexingscheduler.h"
+#include "../../backend/btsearchresultset.h"
+#include "../../backend/btsearchthread.h"
 #include "../../backend/config/btconfig.h"
 #include "../../backend/cswordmodulesearch.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
+#include "../../backend/managers/cswordbackend.h"
 #include "../../util/btconnect.h"
 #include "../../util/cresmgr.h"
-#include "../btmoduleindexdialog.h"
 #include "../messagedialog.h"
 #include "btindexdialog.h"
 #include "btsearchoptionsarea.h"
@@ -36,6 +43,9 @@
 
 namespace {
 const QString GeometryKey = "GUI/SearchDialog/geometry";
+
+/** Milliseconds to wait for further keystrokes before searching as you type */
+constexpr int const IncrementalSearchDelay = 300;
 } // anonymous namespace
 
 namespace Search {
@@ -66,10 +76,26 @@ CSearchDialog::CSearchDialog(QWidget * const parent)
     QSpacerItem* spacerItem = new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Minimum);
     horizontalLayout->addItem(spacerItem);
 
+    m_stopButton = new QPushButton(tr("&Stop search"), this);
+    m_stopButton->setToolTip(tr("Stop the running search"));
+    m_stopButton->setEnabled(false);
+    horizontalLayout->addWidget(m_stopButton);
+
     m_analyseButton = new QPushButton(tr("&Analyze results..."), this);
     m_analyseButton->setToolTip(tr("Show a graphical analysis of the search result"));
     horizontalLayout->addWidget(m_analyseButton);
 
+    m_saveResultsButton = new QPushButton(tr("Sa&ve results..."), this);
+    m_saveResultsButton->setToolTip(
+                tr("Save the search result to a file to open it again later"));
+    m_saveResultsButton->setEnabled(false);
+    horizontalLayout->addWidget(m_saveResultsButton);
+
+    m_openResultsButton = new QPushButton(tr("&Open results..."), this);
+    m_openResultsButton->setToolTip(
+                tr("Show a search result saved before without searching"));
+    horizontalLayout->addWidget(m_openResultsButton);
+
     m_manageIndexes = new QPushButton(tr("&Manage Indexes..."), this);
     m_manageIndexes->setToolTip(tr("Recreate search indexes"));
     horizontalLayout->addWidget(m_manageIndexes);
@@ -81,6 +107,10 @@ CSearchDialog::CSearchDialog(QWidget * const parent)
 
     verticalLayout->addLayout(horizontalLayout);
 
+    m_incrementalSearchTimer = new QTimer(this);
+    m_incrementalSearchTimer->setSingleShot(true);
+    m_incrementalSearchTimer->setInterval(IncrementalSearchDelay);
+
     // Load dialog settings:
     restoreGeometry(btConfig().value<QByteArray>(GeometryKey, QByteArray()));
 
@@ -88,31 +118,57 @@ CSearchDialog::CSearchDialog(QWidget * const parent)
     // Return/Enter is pressed in the search text field
     BT_CONNECT(m_searchOptionsArea, &BtSearchOptionsArea::sigStartSearch,
                this,                &CSearchDialog::startSearch);
+    // The search text is edited while searching as you type
+    BT_CONNECT(m_searchOptionsArea, &BtSearchOptionsArea::sigSearchTextEdited,
+               [this] {
+                   if (m_searchOptionsArea->searchAsYouType())
+                       m_incrementalSearchTimer->start(); // Restarts
+               });
+    BT_CONNECT(m_incrementalSearchTimer, &QTimer::timeout,
+               this, &CSearchDialog::startIncrementalSearch);
     BT_CONNECT(m_closeButton, &QPushButton::clicked,
                this, &CSearchDialog::close);
+    BT_CONNECT(m_stopButton, &QPushButton::clicked,
+               this, &CSearchDialog::stopSearch);
 
     BT_CONNECT(m_analyseButton, &QPushButton::clicked,
                m_searchResultArea, &BtSearchResultArea::showAnalysis);
+    BT_CONNECT(m_saveResultsButton, &QPushButton::clicked,
+               this, &CSearchDialog::saveResults);
+    BT_CONNECT(m_openResultsButton, &QPushButton::clicked,
+               this, &CSearchDialog::openResults);
 
     BT_CONNECT(m_manageIndexes, &QPushButton::clicked,
                [this] { BtIndexDialog(this).exec(); });
 }
 
-CSearchDialog::~CSearchDialog() // Save dialog settings:
-{ btConfig().setValue(GeometryKey, saveGeometry()); }
+CSearchDialog::~CSearchDialog() {
+    // Save dialog settings:
+    btConfig().setValue(GeometryKey, saveGeometry());
+
+    // Wait for any stopped searches still running in the background:
+    for (auto * const thread : findChildren<BtSearchThread *>()) {
+        thread->stopSearch();
+        thread->wait();
+    }
+}
+
+bool CSearchDialog::isSearchable(QString const & searchText) {
+    QString TestString(searchText);
+    static QRegularExpression const ReservedWords(
+                QStringLiteral("heading:|footnote:|morph:|strong:"
+                               "|unaccented:"));
+    return !TestString.replace(ReservedWords, QString()).simplified().isEmpty();
+}
 
 void CSearchDialog::startSearch() {
+    m_incrementalSearchTimer->stop();
+    stopSearch();
     QString originalSearchText(m_searchOptionsArea->searchText());
 
     // first check the search string for errors
-    {
-        QString TestString(originalSearchText);
-        static QRegularExpression const ReservedWords(
-                    QStringLiteral("heading:|footnote:|morph:|strong:"));
-        if (TestString.replace(ReservedWords, QString()).simplified().isEmpty()) {
-            return;
-        }
-    }
+    if (!isSearchable(originalSearchText))
+        return;
     QString searchText = CSwordModuleSearch::prepareSearchText(originalSearchText, m_searchOptionsArea->searchType());
 
     // Insert search text into history list of combobox
@@ -144,67 +200,149 @@ void CSearchDialog::startSearch() {
                             "they can be searched in:"),
                          moduleNameList.join(QStringLiteral(", ")),
                          tr("Indexing could take a long time. Click \"Yes\" to "
-                            "index the modules and start the search, or \"No\" "
-                            "to cancel the search.")),
-                    QMessageBox::Yes | QMessageBox::No,
+                            "index the modules and start the search, "
+                            "\"Ignore\" to search the modules without an "
+                            "index, which is slower and matches only the words "
+                            "as written or a full syntax search as a regular "
+                            "expression, or \"No\" to cancel the search.")),
+                    QMessageBox::Yes | QMessageBox::Ignore | QMessageBox::No,
                     QMessageBox::Yes);
 
-        // User didn't press "Yes":
-        if ((result & (QMessageBox::Yes | QMessageBox::Default)) == 0x0) {
+        if (result == QMessageBox::Ignore) {
+            CSwordModuleSearch::ScanQuery scanQuery(
+                        originalSearchText,
+                        m_searchOptionsArea->searchType());
+            if (!scanQuery.isValid()) {
+                message::showWarning(
+                            this,
+                            tr("Invalid search"),
+                            tr("The search text can not be matched without "
+                               "an index."));
+                return;
+            }
+            runSearch(searchText, false, std::move(scanQuery));
             return;
         }
 
-        // Show indexing dialog, and index the modules:
-        if (!BtModuleIndexDialog::indexAllModules(unindexedModules)) {
-            // Failed or user cancelled.
+        // User didn't press "Yes":
+        if ((result & (QMessageBox::Yes | QMessageBox::Default)) == 0x0) {
             return;
         }
+
+        /* The modules are indexed in the background, the search waits only for
+           the index of the module it is about to search in: */
+        for (auto * const m : unindexedModules)
+            BtIndexingScheduler::instance().enqueue(
+                        m,
+                        BtIndexingScheduler::Priority::Search);
     }
 
-    // Disable the dialog:
-    setEnabled(false);
-    setCursor(Qt::WaitCursor);
-
-    // Execute search:
-    CSwordModuleSearch::Results searchResult;
-    try {
-        searchResult =
-                CSwordModuleSearch::search(searchText,
-                                           searchModules,
-                                           m_searchOptionsArea->searchScope());
-    } catch (...) {
-        QString msg;
-        try {
-            throw;
-        } catch (std::exception const & e) {
-            msg = e.what();
-        } catch (...) {
-            msg = tr("<UNKNOWN EXCEPTION>");
-        }
+    runSearch(searchText, false);
+}
+
+void CSearchDialog::startIncrementalSearch() {
+    // A query superseded by further typing is of no use any more:
+    stopSearch();
+    auto const originalSearchText(m_searchOptionsArea->searchText());
+    if (!isSearchable(originalSearchText))
+        return;
 
-        message::showWarning(this,
-                             tr("Search aborted"),
-                             tr("An internal error occurred while executing "
-                                "your search:<br/><br/>%1").arg(msg));
-        // Re-enable the dialog:
-        setEnabled(true);
-        setCursor(Qt::ArrowCursor);
+    // Don't interrupt typing by asking about missing indices:
+    auto const & searchModules = m_searchOptionsArea->modules();
+    if (searchModules.isEmpty())
         return;
+    for (auto const * const m : searchModules)
+        if (!m->hasIndex())
+            return;
+
+    /* Results of the previous searches are cached by the backend, which also
+       answers queries which only narrow a previous one from its results: */
+    runSearch(CSwordModuleSearch::prepareSearchText(
+                  originalSearchText,
+                  m_searchOptionsArea->searchType()),
+              true);
+}
+
+void CSearchDialog::runSearch(
+        QString const & searchText,
+        bool const incremental,
+        std::optional<CSwordModuleSearch::ScanQuery> scanQuery)
+{
+    auto const & searchModules = m_searchOptionsArea->modules();
+
+    /* The filter options of the main backend are global state, so set them
+       here instead of in the search thread: */
+    CSwordBackend::instance().setFilterOptions(btConfig().getFilterOptions());
+
+    // Disable the search options while searching, unless typing goes on:
+    m_incrementalSearch = incremental;
+    if (!incremental) {
+        m_searchOptionsArea->setEnabled(false);
+        setCursor(Qt::BusyCursor);
     }
+    m_analyseButton->setEnabled(false);
+    m_saveResultsButton->setEnabled(false);
+    m_openResultsButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+
+    // Execute the search in the background, showing results as they arrive:
+    m_searchedScopeName = m_searchOptionsArea->searchScopeName();
+    m_searchResultArea->startSearchResult(m_searchOptionsArea->searchText(),
+                                          searchModules);
+    m_searchThread = new BtSearchThread(searchText,
+                                        searchModules,
+                                        m_searchOptionsArea->searchScope(),
+                                        this);
+    if (scanQuery)
+        m_searchThread->setScanQuery(std::move(*scanQuery));
+    BT_CONNECT(m_searchThread, &BtSearchThread::moduleSearched,
+               m_searchResultArea, &BtSearchResultArea::addModuleResult);
+    BT_CONNECT(m_searchThread, &BtSearchThread::searchFailed,
+               this,
+               [this, incremental](QString const & msg) {
+                   if (incremental) // Likely an incomplete query being typed
+                       return;
+                   message::showWarning(
+                               this,
+                               tr("Search aborted"),
+                               tr("An internal error occurred while executing "
+                                  "your search:<br/><br/>%1").arg(msg));
+               });
+    BT_CONNECT(m_searchThread, &BtSearchThread::finished,
+               this, &CSearchDialog::searchFinished);
+    BT_CONNECT(m_searchThread, &BtSearchThread::finished,
+               m_searchThread, &BtSearchThread::deleteLater);
+    m_searchThread->start();
+}
+
+void CSearchDialog::stopSearch() {
+    if (!m_searchThread)
+        return;
+
+    /* The thread might still be busy with a single module for a while, so
+       stop waiting for it and let it finish in the background: */
+    m_searchThread->stopSearch();
+    disconnect(m_searchThread, nullptr, m_searchResultArea, nullptr);
+    // Also drops the searchFailed handler, which was connected with this:
+    disconnect(m_searchThread, nullptr, this, nullptr);
+    searchFinished();
+}
+
+void CSearchDialog::searchFinished() {
+    m_searchThread = nullptr;
 
     // Display the search results:
-    if (!searchResult.empty()) {
-        m_searchResultArea->setSearchResult(m_searchOptionsArea->searchText(),
-                                            std::move(searchResult));
-        m_analyseButton->setEnabled(true);
-    } else {
-        m_searchResultArea->reset();
+    m_analyseButton->setEnabled(m_searchResultArea->hasResults());
+    m_saveResultsButton->setEnabled(m_searchResultArea->hasResults());
+    m_openResultsButton->setEnabled(true);
+    if (!m_incrementalSearch) {
+        raise();
+        activateWindow();
     }
-    raise();
-    activateWindow();
 
     // Re-enable the dialog:
-    setEnabled(true);
+    m_stopButton->setEnabled(false);
+    m_searchOptionsArea->setEnabled(true);
     setCursor(Qt::ArrowCursor);
 }
 
@@ -213,6 +351,7 @@ void CSearchDialog::reset(BtConstModuleList modules, QString const & searchText)
     m_searchOptionsArea->reset();
     m_searchResultArea->reset();
     m_analyseButton->setEnabled(false);
+    m_saveResultsButton->setEnabled(false);
 
     auto const haveModules = !modules.isEmpty();
     if (haveModules) {
@@ -234,4 +373,76 @@ void CSearchDialog::reset(BtConstModuleList modules, QString const & searchText)
     activateWindow();
 }
 
+void CSearchDialog::saveResults() {
+    auto const directory(BtSearchResultSet::defaultDirectory());
+    QDir().mkpath(directory);
+    auto fileName =
+            QFileDialog::getSaveFileName(this,
+                                         tr("Save Search Results"),
+                                         directory,
+                                         tr("Search results (*.btsearch)"));
+    if (fileName.isEmpty())
+        return;
+    if (!fileName.endsWith(QStringLiteral(".btsearch")))
+        fileName.append(QStringLiteral(".btsearch"));
+
+    BtSearchResultSet const resultSet(m_searchResultArea->searchedText(),
+                                      m_searchedScopeName,
+                                      m_searchResultArea->results());
+    if (!resultSet.save(fileName))
+        message::showCritical(
+                    this,
+                    tr("Error"),
+                    tr("The search results could not be saved to %1.")
+                    .arg(fileName));
+}
+
+void CSearchDialog::openResults() {
+    auto const fileName =
+            QFileDialog::getOpenFileName(this,
+                                         tr("Open Search Results"),
+                                         BtSearchResultSet::defaultDirectory(),
+                                         tr("Search results (*.btsearch)"));
+    if (fileName.isEmpty())
+        return;
+
+    auto const resultSet(BtSearchResultSet::load(fileName));
+    if (!resultSet) {
+        message::showCritical(
+                    this,
+                    tr("Error"),
+                    tr("The search results could not be loaded from %1.")
+                    .arg(fileName));
+        return;
+    }
+
+    auto results(resultSet->results());
+    BtConstModuleList modules;
+    for (auto const & result : results)
+        modules.append(result.module);
+    if (!modules.isEmpty())
+        m_searchOptionsArea->setModules(modules);
+    m_searchOptionsArea->setSearchText(resultSet->searchText());
+    m_searchOptionsArea->setSearchScopeName(resultSet->scopeName());
+    m_searchedScopeName = resultSet->scopeName();
+    m_searchResultArea->setSearchResult(resultSet->searchText(),
+                                        std::move(results));
+    m_analyseButton->setEnabled(m_searchResultArea->hasResults());
+    m_saveResultsButton->setEnabled(m_searchResultArea->hasResults());
+
+    if (resultSet->isStale())
+        message::showWarning(
+                    this,
+                    tr("Outdated search results"),
+                    tr("Some of the works were removed or indexed again since "
+                       "these results were found on %1, so the results might "
+                       "be outdated. Start the search again to update them.")
+                    .arg(QLocale().toString(
+                             resultSet->searchTime().toLocalTime(),
+                             QLocale::ShortFormat)));
+}
+
+CSwordModuleSearch::Results const & CSearchDialog::results() const noexcept
+{ return m_searchResultArea->results(); }
+
 } //end of namespace Search
@@ -14,13 +14,16 @@
 
 #include <QDialog>
 
+#include <optional>
 #include <QString>
 #include "btsearchoptionsarea.h"
 
 namespace Search {
 class BtSearchResultArea;
 }
+class BtSearchThread;
 class QPushButton;
+class QTimer;
 class QWidget;
 
 namespace Search {
@@ -40,18 +43,55 @@ class CSearchDialog final: public QDialog {
         */
         void reset(BtConstModuleList modules, QString const & searchText);
 
+        /** \returns the results of the last search. */
+        CSwordModuleSearch::Results const & results() const noexcept;
+
     private Q_SLOTS:
         /**
           Starts the search with the set modules and the set search text.
         */
         void startSearch();
 
+        /**
+          Starts the search of the text being typed, unless the search can not
+          be started without asking the user.
+        */
+        void startIncrementalSearch();
+
+        /**
+          Stops the running search, keeping the results found so far.
+        */
+        void stopSearch();
+
+        /** Saves the results of the last search to a file chosen by the user. */
+        void saveResults();
+
+        /** Shows the search results loaded from a file chosen by the user. */
+        void openResults();
+
+    private:
+        /** \returns whether the search text has anything to search for. */
+        static bool isSearchable(QString const & searchText);
+
+        void runSearch(QString const & searchText,
+                       bool incremental,
+                       std::optional<CSwordModuleSearch::ScanQuery> scanQuery
+                           = {});
+        void searchFinished();
+
     private:
+        BtSearchThread* m_searchThread = nullptr;
+        bool m_incrementalSearch = false;
+        QTimer* m_incrementalSearchTimer;
+        QPushButton* m_stopButton;
         QPushButton* m_analyseButton;
+        QPushButton* m_saveResultsButton;
+        QPushButton* m_openResultsButton;
         QPushButton* m_manageIndexes;
         QPushButton* m_closeButton;
         BtSearchResultArea* m_searchResultArea;
         BtSearchOptionsArea* m_searchOptionsArea;
+        QString m_searchedScopeName;
 };
 
 
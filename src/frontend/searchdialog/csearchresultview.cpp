@@ -12,26 +12,28 @@
 
 #include "csearchresultview.h"
 
+#include <algorithm>
 #include <QContextMenuEvent>
+#include <QItemSelectionModel>
 #include <QList>
 #include <QMenu>
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QModelIndex>
 #include <QWidget>
 #include "../../backend/config/btconfig.h"
 #include "../../backend/drivers/cswordmoduleinfo.h"
 #include "../../backend/keys/cswordkey.h"
 #include "../../util/btconnect.h"
 #include "../../util/cresmgr.h"
-#include "../BtMimeData.h"
 #include "../cexportmanager.h"
+#include "btsearchresultmodel.h"
 
 
 namespace Search {
 
 CSearchResultView::CSearchResultView(QWidget* parent)
-        : QTreeWidget(parent),
-        m_module(nullptr) {
+        : QTreeView(parent),
+        m_module(nullptr),
+        m_model(new BtSearchResultModel(this)) {
     initView();
     initConnections();
 }
@@ -39,7 +41,8 @@ CSearchResultView::CSearchResultView(QWidget* parent)
 /** Initializes the view of this widget. */
 void CSearchResultView::initView() {
     setToolTip(tr("Search result of the selected work"));
-    setHeaderLabel(tr("Results"));
+    setModel(m_model);
+    setUniformRowHeights(true); // Only the visible rows need to be laid out
     setDragEnabled(true);
     setRootIsDecorated( false );
     setSelectionMode(QAbstractItemView::ExtendedSelection);
@@ -53,12 +56,12 @@ void CSearchResultView::initView() {
     struct SelectedKeysList : QList<CSwordKey *> {
         SelectedKeysList(CSearchResultView & self) {
             auto const * const m = self.m_module;
-            auto const selectedItems(self.selectedItems());
-            reserve(selectedItems.size());
+            auto const keyTexts(self.selectedKeyTexts());
+            reserve(keyTexts.size());
             try {
-                for (auto const * const i : self.selectedItems()) {
+                for (auto const & keyText : keyTexts) {
                     append(m->createKey());
-                    last()->setKey(i->text(0));
+                    last()->setKey(keyText);
                 }
             } catch (...) {
                 qDeleteAll(*this);
@@ -116,11 +119,8 @@ void CSearchResultView::initView() {
     m_actions.print.result = new QAction(tr("Reference with text"), this);
     BT_CONNECT(m_actions.print.result, &QAction::triggered,
                [this]{
-                   QStringList list;
-                   for (auto const * const k : selectedItems())
-                       list.append(k->text(0));
                    CExportManager(true, tr("Printing search result"))
-                           .printKeyList(list,
+                           .printKeyList(selectedKeyTexts(),
                                          m_module,
                                          btConfig().getDisplayOptions(),
                                          btConfig().getFilterOptions());
@@ -131,12 +131,12 @@ void CSearchResultView::initView() {
 
 /** No descriptions */
 void CSearchResultView::initConnections() {
-    /// \todo are these right after porting?
-    //items: current, previous
-    BT_CONNECT(this, &CSearchResultView::currentItemChanged,
-               [this](QTreeWidgetItem * const current, QTreeWidgetItem *) {
-                   if (current) {
-                       Q_EMIT keySelected(current->text(0));
+    /* More results are fetched by the view through BtSearchResultModel::
+       fetchMore() when scrolling close to the end of the list. */
+    BT_CONNECT(selectionModel(), &QItemSelectionModel::currentChanged,
+               [this](QModelIndex const & current) {
+                   if (current.isValid()) {
+                       Q_EMIT keySelected(m_model->keyText(current.row()));
                    } else {
                        Q_EMIT keyDeselected();
                    }
@@ -148,55 +148,59 @@ void CSearchResultView::setupTree(
         CSwordModuleInfo const * m,
         CSwordModuleSearch::ModuleResultList const & result)
 {
-    clear();
-
-    if (!m) return;
-
-    m_module = m;
-    if (result.empty())
+    if (!m) {
+        clear();
         return;
-
-    setUpdatesEnabled(false);
-
-    QTreeWidgetItem* oldItem = nullptr;
-    QTreeWidgetItem* item = nullptr;
-    for (auto const & keyPtr : result) {
-        item = new QTreeWidgetItem(this, oldItem);
-        item->setText(0, QString::fromUtf8(keyPtr->getText()));
-        oldItem = item;
     }
 
-    setUpdatesEnabled(true);
+    m_module = m;
+    m_model->setResults(m, result);
+
     //pre-select the first item
-    this->setCurrentItem(this->topLevelItem(0), 0);
+    if (m_model->rowCount())
+        setCurrentIndex(m_model->index(0));
 }
 
 void CSearchResultView::setupStrongsTree(CSwordModuleInfo* m, const QStringList &vList) {
-    clear();
-    if (!m) return;
-
-    m_module = m;
-
-    if (vList.empty()) return;
-
-    setUpdatesEnabled(false);
-
-    QTreeWidgetItem* oldItem = nullptr;
-    QTreeWidgetItem* item = nullptr;
-
-    for (auto const & s : vList) {
-        item = new QTreeWidgetItem(this, oldItem);
-        item->setText(0, (s));
-        oldItem = item;
+    if (!m) {
+        clear();
+        return;
     }
 
-    setUpdatesEnabled(true);
+    m_module = m;
+    m_model->setKeyTexts(m, vList);
 
     /// \todo select the first item
     //setSelected(firstChild(), true);
     //executed(currentItem());
 }
 
+void CSearchResultView::clear() { m_model->clear(); }
+
+QStringList CSearchResultView::keyTextsAfterCurrent(int const count) const {
+    QStringList r;
+    auto const current = currentIndex();
+    if (!current.isValid())
+        return r;
+    auto const end = std::min(current.row() + 1 + count, m_model->rowCount());
+    for (int row = current.row() + 1; row < end; ++row)
+        r.append(m_model->keyText(row));
+    return r;
+}
+
+QStringList CSearchResultView::selectedKeyTexts() const {
+    auto rows(selectionModel()->selectedRows());
+    std::sort(rows.begin(),
+              rows.end(),
+              [](QModelIndex const & a, QModelIndex const & b)
+              { return a.row() < b.row(); });
+    QStringList r;
+    r.reserve(rows.size());
+    for (auto const & row : rows)
+        r.append(m_model->keyText(row.row()));
+    return r;
+}
+
 /// \todo another function?
 /** Reimplementation to show the popup menu. */
 void CSearchResultView::contextMenuEvent(QContextMenuEvent* event) {
@@ -221,18 +225,5 @@ void CSearchResultView::contextMenuEvent(QContextMenuEvent* event) {
 // }
 
 
-QMimeData *
-CSearchResultView::mimeData(QList<QTreeWidgetItem *> const & items) const {
-    if (items.empty())
-        return nullptr;
-    BTMimeData::ItemList bookmarks;
-    for (auto const * const i : items)
-        bookmarks.append({m_module->name(), i->text(0), {}});
-    return new BTMimeData(std::move(bookmarks));
-}
-
-QStringList CSearchResultView::mimeTypes() const
-{ return QStringList(QStringLiteral("BibleTime/Bookmark")); }
-
 } //end of namespace
 
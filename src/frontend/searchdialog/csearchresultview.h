@@ -12,8 +12,9 @@
 
 #pragma once
 
-#include <QTreeWidget>
+#include <QTreeView>
 
+#include <QStringList>
 #include "../../backend/cswordmodulesearch.h"
 
 
@@ -24,7 +25,9 @@ class QMenu;
 
 namespace Search {
 
-class CSearchResultView  : public QTreeWidget {
+class BtSearchResultModel;
+
+class CSearchResultView  : public QTreeView {
         Q_OBJECT
     public:
         CSearchResultView(QWidget* parent);
@@ -34,6 +37,12 @@ class CSearchResultView  : public QTreeWidget {
         */
         CSwordModuleInfo const * module() const { return m_module; }
 
+        /**
+          \returns the key texts of up to the given number of rows after the
+                   current one.
+        */
+        QStringList keyTextsAfterCurrent(int count) const;
+
     protected: // methods:
         /**
         * Initializes the view of this widget.
@@ -41,11 +50,6 @@ class CSearchResultView  : public QTreeWidget {
         void initView();
         void initConnections();
 
-        //from QTreeWidget
-        QMimeData * mimeData(QList<QTreeWidgetItem *> const & items)
-                const override;
-        QStringList mimeTypes () const override;
-
     public Q_SLOTS:
 
         /**
@@ -56,8 +60,16 @@ class CSearchResultView  : public QTreeWidget {
 
         void setupStrongsTree(CSwordModuleInfo*, const QStringList&);
 
+        /** Removes all results from the list. */
+        void clear();
+
         void contextMenuEvent(QContextMenuEvent* event) override;
 
+    private: // methods:
+
+        /** \returns the key texts of the selected rows in list order. */
+        QStringList selectedKeyTexts() const;
+
     private:
         struct {
             QMenu* saveMenu;
@@ -84,6 +96,7 @@ class CSearchResultView  : public QTreeWidget {
 
         QMenu* m_popup;
         const CSwordModuleInfo *m_module;
+        BtSearchResultModel * m_model;
 
     Q_SIGNALS:
         void keySelected(const QString&);
@@ -0,0 +1,336 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btperformancesettings.h"
+
+#include <QCheckBox>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QLocale>
+#include <QSpinBox>
+#include <QThread>
+#include <QTimer>
+#include <QVBoxLayout>
+#include "../../backend/btrawentrycache.h"
+#include "../../backend/config/btconfig.h"
+#include "../../backend/cswordmodulesearch.h"
+#include "../../backend/drivers/cswordmoduleinfo.h"
+#include "../../backend/models/btchapterrendercache.h"
+#include "../../backend/models/btmoduletextmodel.h"
+#include "../../util/btconnect.h"
+#include "../../util/cresmgr.h"
+#include "cconfigurationdialog.h"
+
+
+//Interval of updating the statistics of the caches
+constexpr static int const BT_STATISTICS_UPDATE_INTERVAL_MS = 1000;
+
+namespace {
+
+QSpinBox * newSpinBox(QWidget * const parent,
+                      int const maximum,
+                      QString const & key,
+                      int const defaultValue,
+                      int const minimum = 0)
+{
+    auto * const spinBox = new QSpinBox(parent);
+    spinBox->setRange(minimum, maximum);
+    spinBox->setValue(btConfig().value<int>(key, defaultValue));
+    return spinBox;
+}
+
+QCheckBox * newCheckBox(QWidget * const parent,
+                        QString const & key,
+                        bool const defaultValue)
+{
+    auto * const checkBox = new QCheckBox(parent);
+    checkBox->setChecked(btConfig().value<bool>(key, defaultValue));
+    return checkBox;
+}
+
+/**
+  \brief Stores the given value unless it is the current one, so that the
+         defaults of settings left alone are not pinned in the configuration.
+*/
+template <typename T>
+void saveIfChanged(QString const & key,
+                   T const & value,
+                   T const & defaultValue)
+{
+    if (btConfig().value<T>(key, defaultValue) != value)
+        btConfig().setValue(key, value);
+}
+
+} // anonymous namespace
+
+BtPerformanceSettingsPage::BtPerformanceSettingsPage(
+        CConfigurationDialog * const parent)
+    : BtConfigDialog::Page(CResMgr::settings::performance::icon(), parent)
+{
+    auto * const mainLayout = new QVBoxLayout(this);
+
+    m_threadsGroupBox = new QGroupBox(this);
+    auto * const threadsLayout = new QFormLayout(m_threadsGroupBox);
+    m_searchThreadsLabel = new QLabel(m_threadsGroupBox);
+    m_searchThreadsSpinBox =
+            newSpinBox(m_threadsGroupBox,
+                       256,
+                       QStringLiteral("settings/behaviour/searchThreads"),
+                       QThread::idealThreadCount(),
+                       1);
+    threadsLayout->addRow(m_searchThreadsLabel, m_searchThreadsSpinBox);
+    m_indexShardsLabel = new QLabel(m_threadsGroupBox);
+    m_indexShardsSpinBox =
+            newSpinBox(m_threadsGroupBox,
+                       64,
+                       QStringLiteral("settings/behaviour/indexShards"),
+                       1,
+                       1);
+    threadsLayout->addRow(m_indexShardsLabel, m_indexShardsSpinBox);
+    mainLayout->addWidget(m_threadsGroupBox);
+
+    m_cachesGroupBox = new QGroupBox(this);
+    auto * const cachesLayout = new QFormLayout(m_cachesGroupBox);
+    m_rawEntryCacheLabel = new QLabel(m_cachesGroupBox);
+    m_rawEntryCacheSpinBox =
+            newSpinBox(m_cachesGroupBox,
+                       4 * 1024 * 1024,
+                       QStringLiteral("settings/behaviour/rawEntryCacheSize"),
+                       BtRawEntryCache::defaultSizeInKiB);
+    m_rawEntryCacheSpinBox->setSingleStep(1024);
+    cachesLayout->addRow(m_rawEntryCacheLabel, m_rawEntryCacheSpinBox);
+    m_searchResultsBudgetLabel = new QLabel(m_cachesGroupBox);
+    m_searchResultsBudgetSpinBox =
+            newSpinBox(
+                m_cachesGroupBox,
+                64 * 1024 * 1024,
+                QStringLiteral("settings/behaviour/searchResultsMemoryBudget"),
+                0);
+    m_searchResultsBudgetSpinBox->setSingleStep(1024);
+    cachesLayout->addRow(m_searchResultsBudgetLabel,
+                         m_searchResultsBudgetSpinBox);
+    m_cacheRenderedChaptersCheckBox =
+            newCheckBox(m_cachesGroupBox,
+                        QStringLiteral("GUI/cacheRenderedChapters"),
+                        true);
+    cachesLayout->addRow(m_cacheRenderedChaptersCheckBox);
+    mainLayout->addWidget(m_cachesGroupBox);
+
+    m_prefetchGroupBox = new QGroupBox(this);
+    auto * const prefetchLayout = new QFormLayout(m_prefetchGroupBox);
+    m_prefetchAheadLabel = new QLabel(m_prefetchGroupBox);
+    m_prefetchAheadSpinBox =
+            newSpinBox(m_prefetchGroupBox,
+                       1000,
+                       QStringLiteral("settings/behaviour/prefetchRowsAhead"),
+                       BtModuleTextModel::defaultPrefetchRowsAhead);
+    prefetchLayout->addRow(m_prefetchAheadLabel, m_prefetchAheadSpinBox);
+    m_prefetchBehindLabel = new QLabel(m_prefetchGroupBox);
+    m_prefetchBehindSpinBox =
+            newSpinBox(m_prefetchGroupBox,
+                       1000,
+                       QStringLiteral("settings/behaviour/prefetchRowsBehind"),
+                       BtModuleTextModel::defaultPrefetchRowsBehind);
+    prefetchLayout->addRow(m_prefetchBehindLabel, m_prefetchBehindSpinBox);
+    mainLayout->addWidget(m_prefetchGroupBox);
+
+    m_indexingGroupBox = new QGroupBox(this);
+    auto * const indexingLayout = new QFormLayout(m_indexingGroupBox);
+    m_indexingMemoryLabel = new QLabel(m_indexingGroupBox);
+    m_indexingMemorySpinBox =
+            newSpinBox(
+                m_indexingGroupBox,
+                1024 * 1024,
+                QStringLiteral("settings/behaviour/indexingMemoryBudget"),
+                0);
+    m_indexingMemorySpinBox->setSingleStep(64);
+    indexingLayout->addRow(m_indexingMemoryLabel, m_indexingMemorySpinBox);
+    m_indexAfterInstallCheckBox =
+            newCheckBox(m_indexingGroupBox,
+                        QStringLiteral("settings/behaviour/indexAfterInstall"),
+                        false);
+    indexingLayout->addRow(m_indexAfterInstallCheckBox);
+    m_fastIndexBuildCheckBox = new QCheckBox(m_indexingGroupBox);
+    m_fastIndexBuildCheckBox->setChecked(
+                CSwordModuleInfo::fastIndexBuildsEnabled());
+    indexingLayout->addRow(m_fastIndexBuildCheckBox);
+    m_incrementalIndexUpdatesCheckBox = new QCheckBox(m_indexingGroupBox);
+    m_incrementalIndexUpdatesCheckBox->setChecked(
+                CSwordModuleInfo::incrementalIndexUpdatesEnabled());
+    indexingLayout->addRow(m_incrementalIndexUpdatesCheckBox);
+    m_prewarmIndicesCheckBox =
+            newCheckBox(m_indexingGroupBox,
+                        QStringLiteral("settings/behaviour/prewarmIndices"),
+                        false);
+    indexingLayout->addRow(m_prewarmIndicesCheckBox);
+    mainLayout->addWidget(m_indexingGroupBox);
+
+    m_statisticsGroupBox = new QGroupBox(this);
+    auto * const statisticsLayout = new QFormLayout(m_statisticsGroupBox);
+    m_rawEntryCacheStatisticsLabel = new QLabel(m_statisticsGroupBox);
+    m_rawEntryCacheStatistics = new QLabel(m_statisticsGroupBox);
+    statisticsLayout->addRow(m_rawEntryCacheStatisticsLabel,
+                             m_rawEntryCacheStatistics);
+    m_renderCacheStatisticsLabel = new QLabel(m_statisticsGroupBox);
+    m_renderCacheStatistics = new QLabel(m_statisticsGroupBox);
+    statisticsLayout->addRow(m_renderCacheStatisticsLabel,
+                             m_renderCacheStatistics);
+    m_searchCacheStatisticsLabel = new QLabel(m_statisticsGroupBox);
+    m_searchCacheStatistics = new QLabel(m_statisticsGroupBox);
+    statisticsLayout->addRow(m_searchCacheStatisticsLabel,
+                             m_searchCacheStatistics);
+    m_renderedChaptersStatisticsLabel = new QLabel(m_statisticsGroupBox);
+    m_renderedChaptersStatistics = new QLabel(m_statisticsGroupBox);
+    statisticsLayout->addRow(m_renderedChaptersStatisticsLabel,
+                             m_renderedChaptersStatistics);
+    mainLayout->addWidget(m_statisticsGroupBox);
+
+    m_restartLabel = new QLabel(this);
+    m_restartLabel->setWordWrap(true);
+    mainLayout->addWidget(m_restartLabel);
+    mainLayout->addStretch();
+
+    retranslateUi(); // also calls updateStatistics()
+
+    auto * const statisticsTimer = new QTimer(this);
+    BT_CONNECT(statisticsTimer, &QTimer::timeout,
+               this, &BtPerformanceSettingsPage::updateStatistics);
+    statisticsTimer->start(BT_STATISTICS_UPDATE_INTERVAL_MS);
+}
+
+void BtPerformanceSettingsPage::retranslateUi() {
+    setHeaderText(tr("Performance"));
+
+    m_threadsGroupBox->setTitle(tr("Threads"));
+    m_searchThreadsLabel->setText(tr("Threads per search:"));
+    m_indexShardsLabel->setText(tr("Threads indexing a module:"));
+    m_indexShardsLabel->setToolTip(
+                tr("Large modules are indexed in this many parts at once."));
+
+    m_cachesGroupBox->setTitle(tr("Caches"));
+    m_rawEntryCacheLabel->setText(tr("Entry cache size:"));
+    m_rawEntryCacheLabel->setToolTip(
+                tr("The memory for the decompressed entries of modules, which "
+                   "are shared by all windows. Zero disables the cache."));
+    m_rawEntryCacheSpinBox->setSuffix(tr(" KiB"));
+    m_rawEntryCacheSpinBox->setSpecialValueText(tr("Disabled"));
+    m_searchResultsBudgetLabel->setText(tr("Search results memory:"));
+    m_searchResultsBudgetLabel->setToolTip(
+                tr("Results of searches exceeding this memory are moved to "
+                   "temporary files until they are shown."));
+    m_searchResultsBudgetSpinBox->setSuffix(tr(" KiB"));
+    m_searchResultsBudgetSpinBox->setSpecialValueText(tr("Unlimited"));
+    m_cacheRenderedChaptersCheckBox->setText(
+                tr("Keep rendered chapters for later sessions"));
+
+    m_prefetchGroupBox->setTitle(tr("Prefetching"));
+    m_prefetchAheadLabel->setText(tr("Entries rendered ahead of scrolling:"));
+    m_prefetchBehindLabel->setText(tr("Entries rendered behind scrolling:"));
+
+    m_indexingGroupBox->setTitle(tr("Search indices"));
+    m_indexingMemoryLabel->setText(tr("Memory for indexing:"));
+    m_indexingMemoryLabel->setToolTip(
+                tr("The memory shared by all indices being built at once, "
+                   "which also limits how many are built at once."));
+    m_indexingMemorySpinBox->setSuffix(tr(" MiB"));
+    m_indexingMemorySpinBox->setSpecialValueText(tr("Automatic"));
+    m_indexAfterInstallCheckBox->setText(
+                tr("Index works in the background after installing them"));
+    m_fastIndexBuildCheckBox->setText(
+                tr("Build indices fast and optimize them later"));
+    m_incrementalIndexUpdatesCheckBox->setText(
+                tr("Update indices of updated works instead of rebuilding "
+                   "them"));
+    m_prewarmIndicesCheckBox->setText(
+                tr("Load the indices of open works in the background"));
+
+    m_statisticsGroupBox->setTitle(tr("Cache statistics"));
+    m_rawEntryCacheStatisticsLabel->setText(tr("Entry cache:"));
+    m_renderCacheStatisticsLabel->setText(tr("Rendered entries:"));
+    m_searchCacheStatisticsLabel->setText(tr("Search results:"));
+    m_renderedChaptersStatisticsLabel->setText(tr("Rendered chapters:"));
+
+    m_restartLabel->setText(
+                tr("Changes of the entry cache size and of the memory for "
+                   "indexing take effect after restarting BibleTime. Changes "
+                   "of prefetching take effect in windows opened afterwards."));
+
+    updateStatistics();
+}
+
+QString BtPerformanceSettingsPage::hitRateText(std::uint64_t const hits,
+                                               std::uint64_t const misses)
+{
+    auto const lookups = hits + misses;
+    return tr("%1% of %2 lookups found")
+            .arg(lookups ? static_cast<int>((100u * hits) / lookups) : 0)
+            .arg(lookups);
+}
+
+void BtPerformanceSettingsPage::updateStatistics() {
+    auto const & rawEntryCache = BtRawEntryCache::instance();
+    m_rawEntryCacheStatistics->setText(
+                hitRateText(rawEntryCache.hits(), rawEntryCache.misses()));
+    m_renderCacheStatistics->setText(
+                hitRateText(BtModuleTextModel::renderCacheHits(),
+                            BtModuleTextModel::renderCacheMisses()));
+    m_searchCacheStatistics->setText(
+                hitRateText(CSwordModuleSearch::resultCacheHits(),
+                            CSwordModuleSearch::resultCacheMisses()));
+    m_renderedChaptersStatistics->setText(
+                tr("%1 in memory")
+                .arg(QLocale().formattedDataSize(
+                         static_cast<qint64>(
+                             BtChapterRenderCache::memoryUsage()))));
+}
+
+void BtPerformanceSettingsPage::save() const {
+    saveIfChanged(QStringLiteral("settings/behaviour/searchThreads"),
+                  m_searchThreadsSpinBox->value(),
+                  QThread::idealThreadCount());
+    saveIfChanged(QStringLiteral("settings/behaviour/indexShards"),
+                  m_indexShardsSpinBox->value(),
+                  1);
+    saveIfChanged(QStringLiteral("settings/behaviour/rawEntryCacheSize"),
+                  m_rawEntryCacheSpinBox->value(),
+                  BtRawEntryCache::defaultSizeInKiB);
+    saveIfChanged(
+                QStringLiteral("settings/behaviour/searchResultsMemoryBudget"),
+                m_searchResultsBudgetSpinBox->value(),
+                0);
+    saveIfChanged(QStringLiteral("GUI/cacheRenderedChapters"),
+                  m_cacheRenderedChaptersCheckBox->isChecked(),
+                  true);
+    saveIfChanged(QStringLiteral("settings/behaviour/prefetchRowsAhead"),
+                  m_prefetchAheadSpinBox->value(),
+                  BtModuleTextModel::defaultPrefetchRowsAhead);
+    saveIfChanged(QStringLiteral("settings/behaviour/prefetchRowsBehind"),
+                  m_prefetchBehindSpinBox->value(),
+                  BtModuleTextModel::defaultPrefetchRowsBehind);
+    saveIfChanged(QStringLiteral("settings/behaviour/indexingMemoryBudget"),
+                  m_indexingMemorySpinBox->value(),
+                  0);
+    saveIfChanged(QStringLiteral("settings/behaviour/indexAfterInstall"),
+                  m_indexAfterInstallCheckBox->isChecked(),
+                  false);
+    saveIfChanged(QStringLiteral("settings/behaviour/fastIndexBuild"),
+                  m_fastIndexBuildCheckBox->isChecked(),
+                  CSwordModuleInfo::fastIndexBuildsEnabled());
+    saveIfChanged(
+                QStringLiteral("settings/behaviour/incrementalIndexUpdates"),
+                m_incrementalIndexUpdatesCheckBox->isChecked(),
+                CSwordModuleInfo::incrementalIndexUpdatesEnabled());
+    saveIfChanged(QStringLiteral("settings/behaviour/prewarmIndices"),
+                  m_prewarmIndicesCheckBox->isChecked(),
+                  false);
+}
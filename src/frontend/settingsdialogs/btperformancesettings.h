@@ -0,0 +1,94 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include "btconfigdialog.h"
+
+#include <cstdint>
+#include <QObject>
+#include <QString>
+
+
+class CConfigurationDialog;
+class QCheckBox;
+class QGroupBox;
+class QLabel;
+class QSpinBox;
+
+/**
+  \brief The settings of the caches, threads and prefetching, so that they can
+         be tuned to the hardware, with the hit rates of the caches updated
+         live while the page is shown.
+*/
+class BtPerformanceSettingsPage: public BtConfigDialog::Page {
+
+        Q_OBJECT
+
+    public: // methods:
+
+        BtPerformanceSettingsPage(CConfigurationDialog * parent = nullptr);
+
+        void save() const final override;
+
+    private: // methods:
+
+        void retranslateUi();
+
+        /** \returns the hit rate of a cache for display. */
+        static QString hitRateText(std::uint64_t hits, std::uint64_t misses);
+
+        /** Shows the current statistics of the caches. */
+        void updateStatistics();
+
+    private: // fields:
+
+        QGroupBox * m_threadsGroupBox;
+        QLabel * m_searchThreadsLabel;
+        QSpinBox * m_searchThreadsSpinBox;
+        QLabel * m_indexShardsLabel;
+        QSpinBox * m_indexShardsSpinBox;
+
+        QGroupBox * m_cachesGroupBox;
+        QLabel * m_rawEntryCacheLabel;
+        QSpinBox * m_rawEntryCacheSpinBox;
+        QLabel * m_searchResultsBudgetLabel;
+        QSpinBox * m_searchResultsBudgetSpinBox;
+        QCheckBox * m_cacheRenderedChaptersCheckBox;
+
+        QGroupBox * m_prefetchGroupBox;
+        QLabel * m_prefetchAheadLabel;
+        QSpinBox * m_prefetchAheadSpinBox;
+        QLabel * m_prefetchBehindLabel;
+        QSpinBox * m_prefetchBehindSpinBox;
+
+        QGroupBox * m_indexingGroupBox;
+        QLabel * m_indexingMemoryLabel;
+        QSpinBox * m_indexingMemorySpinBox;
+        QCheckBox * m_indexAfterInstallCheckBox;
+        QCheckBox * m_fastIndexBuildCheckBox;
+        QCheckBox * m_incrementalIndexUpdatesCheckBox;
+        QCheckBox * m_prewarmIndicesCheckBox;
+
+        QGroupBox * m_statisticsGroupBox;
+        QLabel * m_rawEntryCacheStatisticsLabel;
+        QLabel * m_rawEntryCacheStatistics;
+        QLabel * m_renderCacheStatisticsLabel;
+        QLabel * m_renderCacheStatistics;
+        QLabel * m_searchCacheStatisticsLabel;
+        QLabel * m_searchCacheStatistics;
+        QLabel * m_renderedChaptersStatisticsLabel;
+        QLabel * m_renderedChaptersStatistics;
+
+        QLabel * m_restartLabel;
+
+};
@@ -70,6 +70,7 @@ void BtTextFiltersTab::save() {
     TEXT_FILTERS_TAB_SAVE(greekAccents);
     TEXT_FILTERS_TAB_SAVE(textualVariants);
     TEXT_FILTERS_TAB_SAVE(scriptureReferences);
+    btConfig().resetOptionsSnapshot();
 }
 
 
@@ -15,6 +15,7 @@
 #include <QByteArray>
 #include "../../backend/config/btconfig.h"
 #include "btfontsettings.h"
+#include "btperformancesettings.h"
 #include "bttexttospeechsettings.h"
 #include "cacceleratorsettings.h"
 #include "cdisplaysettings.h"
@@ -33,6 +34,7 @@ CConfigurationDialog::CConfigurationDialog(QWidget * const parent,
     setAttribute(Qt::WA_DeleteOnClose);
 
     addPage(new CDisplaySettingsPage(this));
+    addPage(new BtPerformanceSettingsPage(this));
     addPage(new CSwordSettingsPage(this));
     addPage(new BtFontSettingsPage(this));
     addPage(new CAcceleratorSettingsPage(this));
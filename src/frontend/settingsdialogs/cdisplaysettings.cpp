@@ -18,10 +18,12 @@
 #include <QLabel>
 #include <QLocale>
 #include <QMap>
+#include <QMetaObject>
 #include <QNonConstOverload>
 #include <QPalette>
 #include <QSizePolicy>
 #include <Qt>
+#include <QThread>
 #include <QVBoxLayout>
 #include <QFormLayout>
 #include <utility>
@@ -222,16 +224,12 @@ void CDisplaySettingsPage::initSwordLocaleCombo() {
 }
 
 
-void CDisplaySettingsPage::updateStylePreview() {
-    //update the style preview widget
-    using namespace Rendering;
-
-    const QString styleName = m_styleChooserCombo->currentText();
-    CTextRendering::KeyTree tree;
-
-    CTextRendering::KeyTreeItem::Settings settings;
-    settings.highlight = false;
+CDisplaySettingsPage::~CDisplaySettingsPage() {
+    if (m_stylePreviewThread)
+        m_stylePreviewThread->wait();
+}
 
+void CDisplaySettingsPage::updateStylePreview() {
     auto const previewText =
             tr(R"====(<div class="sectiontitle">CHAPTER 3</div>
 
@@ -337,6 +335,73 @@ void CDisplaySettingsPage::updateStylePreview() {
                "serve the intended purpose. At runtime, the translated text is "
                "automatically split into multiple verses when empty lines (two "
                "consecutive newline characters) are encountered.");
+    if (previewText != m_stylePreviewText) { // E.g. after retranslation
+        m_stylePreviews.clear();
+        m_stylePreviewText = previewText;
+    }
+
+    auto const styleName = m_styleChooserCombo->currentText();
+
+    // The neighbouring styles are likely previewed next:
+    auto const styleIndex = m_styleChooserCombo->currentIndex();
+    for (auto const i : {styleIndex - 1, styleIndex + 1})
+        if (i >= 0 && i < m_styleChooserCombo->count())
+            CDisplayTemplateMgr::instance()->prefetchTemplate(
+                        m_styleChooserCombo->itemText(i));
+
+    if (auto const it = m_stylePreviews.constFind(styleName);
+        it != m_stylePreviews.cend())
+    {
+        // Update colors:
+        QPalette p = m_stylePreviewViewer->palette();
+        p.setColor(QPalette::Window,
+                   ColorManager::getBackgroundColor(styleName));
+        p.setColor(QPalette::WindowText,
+                   ColorManager::getForegroundColor(styleName));
+        m_stylePreviewViewer->setPalette(p);
+
+        m_stylePreviewViewer->setText(*it);
+        return;
+    }
+
+    /* Render the preview in the background, while the previous one is still
+       shown. If a preview is being rendered, the preview of the current style
+       is rendered when that one is finished: */
+    if (m_stylePreviewThread)
+        return;
+    m_stylePreviewThread.reset(
+        QThread::create(
+            [this, styleName, previewText] {
+                auto preview(renderStylePreview(styleName, previewText));
+                QMetaObject::invokeMethod(
+                    this,
+                    [this,
+                     styleName,
+                     previewText,
+                     preview = std::move(preview)]() mutable
+                    {
+                        m_stylePreviewThread->wait();
+                        m_stylePreviewThread.reset();
+                        if (previewText == m_stylePreviewText)
+                            m_stylePreviews.insert(styleName,
+                                                   std::move(preview));
+                        updateStylePreview();
+                    },
+                    Qt::QueuedConnection);
+            }));
+    m_stylePreviewThread->start(QThread::LowPriority);
+}
+
+QString CDisplaySettingsPage::renderStylePreview(QString const & styleName,
+                                                 QString const & previewText)
+{
+    using namespace Rendering;
+
+    CTextRendering::KeyTree tree;
+
+    CTextRendering::KeyTreeItem::Settings settings;
+    settings.highlight = false;
+
     for (auto const & verse
          : previewText.split(QStringLiteral("\n\n"), Qt::SkipEmptyParts))
         tree.emplace_back(verse, settings);
@@ -345,16 +410,7 @@ void CDisplaySettingsPage::updateStylePreview() {
     render.setDisplayTemplateName(styleName);
     QString text = render.renderKeyTree(tree);
     text.replace(QStringLiteral("#CHAPTERTITLE#"), QString());
-
-    // Update colors:
-    QPalette p = m_stylePreviewViewer->palette();
-    p.setColor(QPalette::Window, ColorManager::getBackgroundColor(styleName));
-    p.setColor(QPalette::WindowText,
-               ColorManager::getForegroundColor(styleName));
-    m_stylePreviewViewer->setPalette(p);
-
-    text = ColorManager::replaceColors(text, styleName);
-    m_stylePreviewViewer->setText(text);
+    return ColorManager::replaceColors(std::move(text), styleName);
 }
 
 void CDisplaySettingsPage::save() const {
@@ -14,6 +14,8 @@
 
 #include "btconfigdialog.h"
 
+#include <memory>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QString>
@@ -23,6 +25,7 @@ class CConfigurationDialog;
 class QCheckBox;
 class QComboBox;
 class QLabel;
+class QThread;
 
 class CDisplaySettingsPage: public BtConfigDialog::Page {
 
@@ -31,6 +34,7 @@ class CDisplaySettingsPage: public BtConfigDialog::Page {
     public: // methods:
 
         CDisplaySettingsPage(CConfigurationDialog *parent = nullptr);
+        ~CDisplaySettingsPage() override;
 
         void save() const final override;
 
@@ -41,12 +45,20 @@ class CDisplaySettingsPage: public BtConfigDialog::Page {
         void retranslateUi();
 
     private Q_SLOTS:
-        /** Update the style preview widget. */
+        /**
+          Update the style preview widget with the cached preview of the
+          current style, or start rendering it in the background.
+        */
         void updateStylePreview();
 
     private: // methods:
 
         static QList<QString> bookNameAbbreviationsTryVector();
+
+        /** \returns the given preview text rendered with the given style. */
+        static QString renderStylePreview(QString const & styleName,
+                                          QString const & previewText);
+
         void initSwordLocaleCombo();
 
     private: // fields:
@@ -63,4 +75,8 @@ class CDisplaySettingsPage: public BtConfigDialog::Page {
         QLabel* m_stylePreviewViewer;
         QLabel *m_previewLabel;
 
+        QString m_stylePreviewText; ///< The text of the cached previews
+        QHash<QString, QString> m_stylePreviews; ///< By style name
+        std::unique_ptr<QThread> m_stylePreviewThread;
+
 };
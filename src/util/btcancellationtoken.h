@@ -0,0 +1,57 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+
+/**
+  \brief A flag by which a long running operation is asked to stop.
+
+  Copies of a token share their flag, so that the requester of an operation
+  can keep a copy to cancel the operation while other threads poll theirs. A
+  default constructed token is never cancelled and costs nothing to poll.
+*/
+class BtCancellationToken {
+
+public: // methods:
+
+    BtCancellationToken() noexcept = default;
+
+    /** \returns a new token which can be cancelled. */
+    static BtCancellationToken create()
+    { return BtCancellationToken(std::make_shared<std::atomic<bool>>(false)); }
+
+    /** \brief Asks the operations polling this token to stop. */
+    void cancel() const noexcept {
+        if (m_cancelled)
+            m_cancelled->store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const noexcept
+    { return m_cancelled && m_cancelled->load(std::memory_order_relaxed); }
+
+private: // methods:
+
+    explicit BtCancellationToken(std::shared_ptr<std::atomic<bool>> cancelled)
+            noexcept
+        : m_cancelled(std::move(cancelled))
+    {}
+
+private: // fields:
+
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+}; /* class BtCancellationToken */
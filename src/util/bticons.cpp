@@ -12,25 +12,159 @@
 
 #include "bticons.h"
 
+#include <algorithm>
 #include <QBrush>
 #include <QBuffer>
 #include <QByteArray>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QIconEngine>
 #include <QImage>
 #include <QPainter>
 #include <QPixmap>
+#include <QPixmapCache>
 #include <QPoint>
 #include <QRect>
+#include <QSize>
 #include <Qt>
 #include <QtGui>
+#include <iterator>
+#include <optional>
+#include <utility>
 #include "directory.h"
 
 
-class QSize;
+//Extents of the icons whose pixmaps are cached on disk
+constexpr static int const BT_CACHED_ICON_EXTENTS[] = {16, 22, 24, 32, 48, 64};
 
 namespace {
 
+/**
+  \brief An icon engine reading its icon file only when first painted.
+
+  The pixmaps of the usual icon sizes are also cached in the user cache
+  directory, so that the SVG files need not be rasterized on every start.
+*/
+class BtLazyIconEngine: public QIconEngine {
+
+public: // methods:
+
+    BtLazyIconEngine(QString fileName)
+        : m_fileName(std::move(fileName))
+    {}
+
+    QIconEngine * clone() const override
+    { return new BtLazyIconEngine(*this); }
+
+    QString key() const override
+    { return QStringLiteral("BtLazyIconEngine"); }
+
+    void paint(QPainter * painter,
+               QRect const & rect,
+               QIcon::Mode mode,
+               QIcon::State state) override
+    {
+        auto const scale = painter->device()->devicePixelRatio();
+        painter->drawPixmap(rect,
+                            scaledPixmap(rect.size(), mode, state, scale));
+    }
+
+    QSize actualSize(QSize const & size,
+                     QIcon::Mode mode,
+                     QIcon::State state) override
+    {
+        // Our SVG icons are square and scale to any size:
+        if (size.width() == size.height()
+            && m_fileName.endsWith(QStringLiteral(".svg")))
+            return size;
+        return icon().actualSize(size, mode, state);
+    }
+
+    QPixmap pixmap(QSize const & size,
+                   QIcon::Mode mode,
+                   QIcon::State state) override
+    { return scaledPixmap(size, mode, state, 1.0); }
+
+    QPixmap scaledPixmap(QSize const & size,
+                         QIcon::Mode mode,
+                         QIcon::State state,
+                         qreal scale) override
+    {
+        auto const cacheFile = cacheFileName(size, mode, state, scale);
+        if (cacheFile.isEmpty())
+            return icon().pixmap(size, scale, mode, state);
+
+        QPixmap pm;
+        if (QPixmapCache::find(cacheFile, &pm))
+            return pm;
+        if (!pm.load(cacheFile, "PNG")) {
+            pm = icon().pixmap(size, scale, mode, state);
+            if (pm.isNull())
+                return pm;
+            QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+            pm.save(cacheFile, "PNG");
+        }
+        pm.setDevicePixelRatio(scale);
+        QPixmapCache::insert(cacheFile, pm);
+        return pm;
+    }
+
+private: // methods:
+
+    QIcon const & icon() const {
+        if (!m_icon)
+            m_icon.emplace(m_fileName);
+        return *m_icon;
+    }
+
+    /**
+      \returns the name of the file caching the pixmap of the given size, or
+               an empty string if the pixmap is not cached on disk.
+    */
+    QString cacheFileName(QSize const & size,
+                          QIcon::Mode const mode,
+                          QIcon::State const state,
+                          qreal const scale) const
+    {
+        if (mode != QIcon::Normal
+            || state != QIcon::Off
+            || size.width() != size.height()
+            || std::find(std::begin(BT_CACHED_ICON_EXTENTS),
+                         std::end(BT_CACHED_ICON_EXTENTS),
+                         size.width()) == std::end(BT_CACHED_ICON_EXTENTS))
+            return {};
+        if (!m_cacheFilePrefix) {
+            QFileInfo const info(m_fileName);
+            if (info.exists()) {
+                // Icons changed by updates have another modification time:
+                m_cacheFilePrefix.emplace(
+                            QStringLiteral("%1/icons/%2-%3-").arg(
+                                util::directory::getUserCacheDir()
+                                    .absolutePath(),
+                                info.completeBaseName(),
+                                QString::number(
+                                    info.lastModified().toMSecsSinceEpoch(),
+                                    16)));
+            } else {
+                m_cacheFilePrefix.emplace();
+            }
+        }
+        if (m_cacheFilePrefix->isEmpty())
+            return {};
+        return QStringLiteral("%1%2@%3.png").arg(*m_cacheFilePrefix,
+                                                 QString::number(size.width()),
+                                                 QString::number(scale));
+    }
+
+private: // fields:
+
+    QString const m_fileName;
+    mutable std::optional<QIcon> m_icon;
+    mutable std::optional<QString> m_cacheFilePrefix;
+
+};
+
 class BtOverlayIconEngine: public QIconEngine {
 
 public: // methods:
@@ -88,7 +222,7 @@ private: // fields:
 } // anonymous namespace
 
 BtIcons::RegularIcon::RegularIcon(QString const & name)
-    : QIcon(util::directory::getIconDir().filePath(name))
+    : QIcon(new BtLazyIconEngine(util::directory::getIconDir().filePath(name)))
 {}
 
 BtIcons::OverlayedIcon::OverlayedIcon(QIcon const & icon,
@@ -0,0 +1,101 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "btassert.h"
+
+
+/**
+  \brief A sequence of a fixed capacity, which drops its first element when an
+         element is added while it is full.
+
+  The elements are stored in a circular buffer allocated once, so that adding
+  elements at either end never moves the other elements.
+*/
+template <typename T>
+class BtRingBuffer {
+
+public: // methods:
+
+    explicit BtRingBuffer(std::size_t const capacity)
+        : m_elements(capacity)
+    { BT_ASSERT(capacity > 0u); }
+
+    std::size_t capacity() const noexcept { return m_elements.size(); }
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0u; }
+    bool full() const noexcept { return m_size == capacity(); }
+
+    T & operator[](std::size_t const i) noexcept
+    { return m_elements[physical(i)]; }
+
+    T const & operator[](std::size_t const i) const noexcept
+    { return m_elements[physical(i)]; }
+
+    void clear() noexcept {
+        for (std::size_t i = 0u; i < m_size; ++i)
+            m_elements[physical(i)] = T();
+        m_first = 0u;
+        m_size = 0u;
+    }
+
+    /** \brief Removes the first element. */
+    void popFront() {
+        BT_ASSERT(!empty());
+        m_elements[m_first] = T();
+        m_first = (m_first + 1u) % capacity();
+        --m_size;
+    }
+
+    /**
+      \brief Inserts the given element before the element at the given
+             position, dropping the first element if full.
+      \returns whether the first element was dropped, which moves the positions
+               of all remaining elements by one.
+    */
+    bool insert(std::size_t pos, T value) {
+        BT_ASSERT(pos <= m_size);
+        bool const dropped = full();
+        if (dropped) {
+            if (pos == 0u) // The new element would be dropped right away
+                return true;
+            popFront();
+            --pos;
+        }
+        ++m_size;
+        for (auto i = m_size - 1u; i > pos; --i)
+            m_elements[physical(i)] = std::move(m_elements[physical(i - 1u)]);
+        m_elements[physical(pos)] = std::move(value);
+        return dropped;
+    }
+
+    /** \brief Appends the given element, dropping the first one if full. */
+    bool pushBack(T value) { return insert(m_size, std::move(value)); }
+
+private: // methods:
+
+    std::size_t physical(std::size_t const i) const noexcept {
+        BT_ASSERT(i < capacity());
+        return (m_first + i) % capacity();
+    }
+
+private: // fields:
+
+    std::vector<T> m_elements;
+    std::size_t m_first = 0u;
+    std::size_t m_size = 0u;
+
+}; /* class BtRingBuffer */
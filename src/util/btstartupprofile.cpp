@@ -0,0 +1,143 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "btstartupprofile.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+#if __GLIBC_PREREQ(2, 33)
+#include <malloc.h>
+#define BT_HAVE_MALLINFO2
+#endif
+#endif
+
+
+namespace BtStartupProfile {
+namespace {
+
+struct Record {
+    char const * name;
+    int depth;
+    std::int64_t durationNs;
+    std::optional<std::int64_t> heapBytes;
+};
+
+std::atomic<bool> profileEnabled(false);
+std::mutex recordsMutex;
+std::vector<Record> records; // In the order the phases were started
+std::int64_t profileStartNs = 0;
+thread_local int currentDepth = 0;
+
+std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** \returns the number of bytes allocated on the heap, if known. */
+std::optional<std::int64_t> heapInUse() noexcept {
+    #ifdef BT_HAVE_MALLINFO2
+    auto const info = ::mallinfo2();
+    return static_cast<std::int64_t>(info.uordblks + info.hblkhd);
+    #else
+    return {};
+    #endif
+}
+
+} // anonymous namespace
+
+bool enabled() noexcept
+{ return profileEnabled.load(std::memory_order_relaxed); }
+
+void enable() {
+    std::lock_guard<std::mutex> const guard(recordsMutex);
+    records.clear();
+    profileStartNs = now();
+    profileEnabled.store(true, std::memory_order_relaxed);
+}
+
+void writeReport(std::ostream & out) {
+    profileEnabled.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> const guard(recordsMutex);
+    auto const totalNs = now() - profileStartNs;
+    auto const toMs =
+            [](std::int64_t const ns) noexcept
+            { return static_cast<double>(ns) / 1e6; };
+
+    out << "Startup profile:" << std::endl
+        << std::left << std::setw(40) << "Phase"
+        << std::right << std::setw(12) << "Time (ms)"
+        << std::setw(8) << "Share"
+        << std::setw(20) << "Heap growth (KiB)" << std::endl;
+    auto const flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    for (auto const & record : records) {
+        out << std::left << std::setw(40)
+            << (std::string(static_cast<std::size_t>(record.depth) * 2u, ' ')
+                + record.name)
+            << std::right << std::setw(12) << toMs(record.durationNs)
+            << std::setw(7)
+            << (totalNs > 0
+                ? 100.0 * static_cast<double>(record.durationNs)
+                  / static_cast<double>(totalNs)
+                : 0.0)
+            << '%' << std::setw(20);
+        if (record.heapBytes) {
+            out << static_cast<double>(*record.heapBytes) / 1024.0;
+        } else {
+            out << '-';
+        }
+        out << std::endl;
+    }
+    out << std::left << std::setw(40) << "Total"
+        << std::right << std::setw(12) << toMs(totalNs) << std::endl;
+    out.flags(flags);
+    records.clear();
+}
+
+Phase::Phase(char const * const name)
+    : m_name(enabled() ? name : nullptr)
+{
+    if (!m_name)
+        return;
+    {
+        std::lock_guard<std::mutex> const guard(recordsMutex);
+        m_index = records.size();
+        records.emplace_back(Record{m_name, currentDepth, 0, {}});
+    }
+    ++currentDepth;
+    m_startHeapBytes = heapInUse();
+    m_startNs = now();
+}
+
+Phase::~Phase() {
+    if (!m_name)
+        return;
+    auto const durationNs = now() - m_startNs;
+    auto const heapBytes = heapInUse();
+    --currentDepth;
+    std::lock_guard<std::mutex> const guard(recordsMutex);
+    if (m_index >= records.size() || records[m_index].name != m_name)
+        return; // The report has already been written
+    auto & record = records[m_index];
+    record.durationNs = durationNs;
+    if (heapBytes && m_startHeapBytes)
+        record.heapBytes = *heapBytes - *m_startHeapBytes;
+}
+
+} // namespace BtStartupProfile
@@ -0,0 +1,66 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+
+
+/**
+  \file btstartupprofile.h
+  \brief Measures the phases of the startup for --profile-startup.
+
+  Every phase records its wall time and, where the C library supports it, the
+  growth of the heap. Phases may be nested, e.g. CSwordBackend::initModules()
+  within BibleTimeApp::initBackends(). Nothing is recorded unless enabled().
+*/
+
+namespace BtStartupProfile {
+
+/** \returns whether the phases of the startup are recorded. */
+bool enabled() noexcept;
+
+/** \brief Starts recording the phases of the startup. */
+void enable();
+
+/**
+  \brief Writes a report of the recorded phases and stops recording.
+  \param[out] out The stream to write the report to.
+*/
+void writeReport(std::ostream & out);
+
+/** \brief Records the time from its construction until its destruction. */
+class Phase {
+
+public: // methods:
+
+    /** \param[in] name The name of the phase, needs to be a string literal. */
+    explicit Phase(char const * name);
+
+    Phase(Phase const &) = delete;
+    Phase & operator=(Phase const &) = delete;
+
+    ~Phase();
+
+private: // fields:
+
+    char const * const m_name;
+    std::int64_t m_startNs = 0;
+    std::optional<std::int64_t> m_startHeapBytes;
+    std::size_t m_index = 0u;
+
+};
+
+} // namespace BtStartupProfile
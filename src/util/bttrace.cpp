@@ -0,0 +1,148 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "bttrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+
+//Maximum number of recorded spans, the oldest ones are overwritten
+constexpr static std::size_t const BT_TRACE_MAX_EVENTS = 1u << 18u;
+
+namespace BtTrace {
+namespace detail {
+std::atomic<bool> enabled(false);
+} // namespace detail
+
+namespace {
+
+std::mutex eventsMutex;
+std::vector<Event> recordedEvents; // A ring buffer once full
+std::size_t nextEvent = 0u;
+
+std::uint32_t currentThreadId() noexcept {
+    static std::atomic<std::uint32_t> nextThreadId(1u);
+    thread_local std::uint32_t const threadId =
+            nextThreadId.fetch_add(1u, std::memory_order_relaxed);
+    return threadId;
+}
+
+double percentile(std::vector<std::int64_t> const & sortedDurations,
+                  std::size_t const percent) noexcept
+{
+    auto const i = (sortedDurations.size() - 1u) * percent / 100u;
+    return static_cast<double>(sortedDurations[i]) / 1e6;
+}
+
+} // anonymous namespace
+
+void setEnabled(bool const enable) noexcept
+{ detail::enabled.store(enable, std::memory_order_relaxed); }
+
+void clear() {
+    std::lock_guard<std::mutex> const guard(eventsMutex);
+    recordedEvents.clear();
+    nextEvent = 0u;
+}
+
+std::vector<Event> events() {
+    std::lock_guard<std::mutex> const guard(eventsMutex);
+    std::vector<Event> r;
+    r.reserve(recordedEvents.size());
+    r.insert(r.end(),
+             recordedEvents.begin() + static_cast<std::ptrdiff_t>(nextEvent),
+             recordedEvents.end());
+    r.insert(r.end(),
+             recordedEvents.begin(),
+             recordedEvents.begin() + static_cast<std::ptrdiff_t>(nextEvent));
+    return r;
+}
+
+std::vector<SpanSummary> summary() {
+    std::map<std::string_view, std::vector<std::int64_t>> durations;
+    for (auto const & event : events())
+        durations[event.name].push_back(event.durationNs);
+
+    std::vector<SpanSummary> r;
+    r.reserve(durations.size());
+    for (auto & [name, spanDurations] : durations) {
+        std::sort(spanDurations.begin(), spanDurations.end());
+        std::int64_t totalNs = 0;
+        for (auto const duration : spanDurations)
+            totalNs += duration;
+        r.emplace_back(
+                    SpanSummary{
+                        QString::fromLatin1(name.data(),
+                                            static_cast<qsizetype>(
+                                                name.size())),
+                        spanDurations.size(),
+                        static_cast<double>(totalNs) / 1e6,
+                        percentile(spanDurations, 50u),
+                        percentile(spanDurations, 99u)});
+    }
+    std::sort(r.begin(),
+              r.end(),
+              [](SpanSummary const & a, SpanSummary const & b)
+              { return a.totalMs > b.totalMs; });
+    return r;
+}
+
+QByteArray toChromeTraceJson() {
+    auto const recorded(events());
+    QByteArray r;
+    r.reserve(static_cast<qsizetype>(recorded.size()) * 96 + 64);
+    r.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (auto const & event : recorded) {
+        if (!first)
+            r.append(',');
+        first = false;
+        r.append("\n{\"name\":\"").append(event.name)
+         .append("\",\"cat\":\"bibletime\",\"ph\":\"X\",\"pid\":1,\"tid\":")
+         .append(QByteArray::number(event.threadId))
+         .append(",\"ts\":")
+         .append(QByteArray::number(static_cast<double>(event.startNs) / 1e3,
+                                    'f',
+                                    3))
+         .append(",\"dur\":")
+         .append(QByteArray::number(static_cast<double>(event.durationNs)
+                                    / 1e3,
+                                    'f',
+                                    3))
+         .append('}');
+    }
+    r.append("\n]}\n");
+    return r;
+}
+
+std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(char const * const name, std::int64_t const startNs) {
+    Event const event{name, startNs, now() - startNs, currentThreadId()};
+    std::lock_guard<std::mutex> const guard(eventsMutex);
+    if (recordedEvents.size() < BT_TRACE_MAX_EVENTS) {
+        recordedEvents.push_back(event);
+    } else {
+        recordedEvents[nextEvent] = event;
+        nextEvent = (nextEvent + 1u) % BT_TRACE_MAX_EVENTS;
+    }
+}
+
+} // namespace BtTrace
@@ -0,0 +1,123 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+
+/**
+  \file bttrace.h
+  \brief Lightweight tracing of the spans of hot paths.
+
+  A span is declared with BT_TRACE_SPAN("name") and lasts until the end of the
+  enclosing scope. Spans are only recorded while tracing is enabled, e.g. by
+  the profiler window, otherwise they only check an atomic flag. Without
+  BUILD_TRACING the spans are removed at compile time.
+*/
+
+namespace BtTrace {
+
+struct Event {
+    char const * name;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+    std::uint32_t threadId;
+};
+
+struct SpanSummary {
+    QString name;
+    std::size_t count;
+    double totalMs;
+    double p50Ms;
+    double p99Ms;
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+} // namespace detail
+
+/** \returns whether spans are recorded. */
+inline bool enabled() noexcept
+{ return detail::enabled.load(std::memory_order_relaxed); }
+
+/** \brief Starts or stops recording spans. */
+void setEnabled(bool enable) noexcept;
+
+/** \brief Discards all recorded spans. */
+void clear();
+
+/** \returns the recorded spans, oldest first. */
+std::vector<Event> events();
+
+/**
+  \returns the number of recorded spans and their latencies per span name,
+           sorted by the total time spent in the spans.
+*/
+std::vector<SpanSummary> summary();
+
+/**
+  \returns the recorded spans in the Chrome trace event format, which can be
+           opened in Perfetto or chrome://tracing.
+*/
+QByteArray toChromeTraceJson();
+
+/** \returns the current time of the trace clock in nanoseconds. */
+std::int64_t now() noexcept;
+
+/** \brief Records a span which started at the given time and ends now. */
+void record(char const * name, std::int64_t startNs);
+
+/**
+  \brief Records the time from its construction until its destruction, if
+         tracing is enabled at its construction.
+  \note The name needs to be a string literal which needs no JSON escaping.
+*/
+class Span {
+
+public: // methods:
+
+    explicit Span(char const * const name) noexcept
+        : m_name(enabled() ? name : nullptr)
+        , m_startNs(m_name ? now() : 0)
+    {}
+
+    Span(Span const &) = delete;
+    Span & operator=(Span const &) = delete;
+
+    ~Span() {
+        if (m_name)
+            record(m_name, m_startNs);
+    }
+
+private: // fields:
+
+    char const * const m_name;
+    std::int64_t const m_startNs;
+
+};
+
+} // namespace BtTrace
+
+#ifdef BUILD_TRACING
+#define BT_TRACE_CONCAT_(a, b) a ## b
+#define BT_TRACE_CONCAT(a, b) BT_TRACE_CONCAT_(a, b)
+#define BT_TRACE_SPAN(name) \
+    BtTrace::Span const BT_TRACE_CONCAT(btTraceSpan, __LINE__)(name)
+#else
+#define BT_TRACE_SPAN(name) static_cast<void>(0)
+#endif
@@ -12,27 +12,75 @@
 
 #include "cp1252.h"
 
-#include <QStringDecoder>
-#include <QStringEncoder>
-#include "btassert.h"
+#include <cstdint>
+#include <cstring>
 
 
+namespace {
+
+/** The characters of the bytes 0x80 to 0x9F in Windows-1252. */
+constexpr char16_t const c1Characters[32] = {
+    0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+    0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+    0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+    0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178
+};
+
+constexpr bool isC1(unsigned const c) noexcept { return c - 0x80u < 0x20u; }
+
+bool isAscii(QByteArrayView const data) noexcept {
+    auto const * p = data.data();
+    auto size = data.size();
+    // Check eight bytes at a time while possible:
+    for (; size >= 8; p += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        if (word & 0x8080808080808080u)
+            return false;
+    }
+    for (; size > 0; ++p, --size)
+        if (static_cast<unsigned char>(*p) >= 0x80u)
+            return false;
+    return true;
+}
+
+} // anonymous namespace
+
 namespace util {
 namespace cp1252 {
 
-QString toUnicode(QByteArray const & data) {
-    QStringDecoder decoder("Windows-1252", QStringDecoder::Flag::Stateless);
-    // Do not use auto here due to QTBUG-117705/QTBUG-117902:
-    QString result = decoder(data);
-    BT_ASSERT(!decoder.hasError());
+QString toUnicode(QByteArrayView const data) {
+    auto result(QString::fromLatin1(data));
+    for (auto & c : result)
+        if (isC1(c.unicode()))
+            c = QChar(c1Characters[c.unicode() - 0x80u]);
     return result;
 }
 
+QByteArray toUtf8(QByteArrayView const data) {
+    if (isAscii(data))
+        return data.toByteArray();
+    return toUnicode(data).toUtf8();
+}
+
 QByteArray fromUnicode(QString const & str) {
-    QStringEncoder encoder("Windows-1252", QStringEncoder::Flag::Stateless);
-    // Do not use auto here due to QTBUG-117705/QTBUG-117902:
-    QByteArray result = encoder(str);
-    BT_ASSERT(!encoder.hasError());
+    QByteArray result(str.size(), Qt::Uninitialized);
+    auto * out = result.data();
+    for (auto const c : str) {
+        auto const u = c.unicode();
+        if (u < 0x100u && !isC1(u)) {
+            *out = static_cast<char>(u);
+        } else {
+            *out = '?';
+            for (unsigned i = 0u; i < 32u; ++i) {
+                if (c1Characters[i] == u) {
+                    *out = static_cast<char>(0x80u + i);
+                    break;
+                }
+            }
+        }
+        ++out;
+    }
     return result;
 }
 
@@ -13,13 +13,34 @@
 #pragma once
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 
 
 namespace util {
 namespace cp1252 {
 
-QString toUnicode(QByteArray const & data);
+/**
+  \brief Decodes Windows-1252 text.
+
+  The text is decoded as Latin-1, which Qt does for whole buffers at a time,
+  and only the characters 0x80 to 0x9F are then looked up in a table. The
+  bytes undefined in Windows-1252 are mapped to the respective C1 controls.
+*/
+QString toUnicode(QByteArrayView data);
+
+/**
+  \brief Converts Windows-1252 text directly to UTF-8.
+
+  Text consisting of ASCII only, like most keys, is returned unchanged.
+*/
+QByteArray toUtf8(QByteArrayView data);
+
+/**
+  \brief Encodes text as Windows-1252.
+
+  Characters not representable in Windows-1252 are replaced by '?'.
+*/
 QByteArray fromUnicode(QString const & str);
 
 } /* namespace cp1252 { */
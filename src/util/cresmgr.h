@@ -327,6 +327,7 @@ namespace fonts { BT_GETICON(fonts) }
 namespace profiles { BT_GETICON(view_profile) }
 namespace sword { BT_GETICON(swordconfig) }
 namespace keys { BT_GETICON(key_bindings) }
+namespace performance { BT_GETICON(configure) }
 }
 
 namespace mainIndex { //configuration for the main index and the view->search menu
@@ -26,6 +26,7 @@
 #include <QLocale>
 #include <QStringList>
 #include <QtGlobal>
+#include <utility>
 
 
 namespace util {
@@ -43,6 +44,8 @@ std::optional<QDir> cachedUserHomeDir;
 std::optional<QDir> cachedUserHomeSwordDir;
 std::optional<QDir> cachedUserCacheDir;
 std::optional<QDir> cachedUserIndexDir;
+std::optional<QDir> cachedSharedIndexDir;
+std::optional<QDir> cachedSharedCacheDir;
 #ifdef Q_OS_WIN
 // Only Windows installs the sword directory which contains locales.d:
 std::optional<QDir> cachedApplicationSwordDir;
@@ -104,6 +107,18 @@ bool initDirectoryCache() {
         return false;
     }
 
+    { // The shared index directory is optional:
+        QDir sharedIndexDir(wDir);
+        if (sharedIndexDir.cd(QStringLiteral("share/bibletime/indices")))
+            cachedSharedIndexDir.emplace(std::move(sharedIndexDir));
+    }
+
+    { // The shared cache directory is optional as well:
+        QDir sharedCacheDir(wDir);
+        if (sharedCacheDir.cd(QStringLiteral("share/bibletime/cache")))
+            cachedSharedCacheDir.emplace(std::move(sharedCacheDir));
+    }
+
     cachedDisplayTemplatesDir.emplace(wDir); //display templates dir
     if (!cachedDisplayTemplatesDir->cd(
             QStringLiteral("share/bibletime/display-templates/")))
@@ -318,6 +333,14 @@ const QDir &getUserIndexDir() {
     return *cachedUserIndexDir;
 }
 
+std::optional<QDir> const & getSharedIndexDir() {
+    return cachedSharedIndexDir;
+}
+
+std::optional<QDir> const & getSharedCacheDir() {
+    return cachedSharedCacheDir;
+}
+
 const QDir &getUserDisplayTemplatesDir() {
     return *cachedUserDisplayTemplatesDir;
 }
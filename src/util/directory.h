@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <QtGlobal>
 #include <QString>
 
@@ -84,6 +85,24 @@ const QDir &getUserCacheDir();
 /** Return the path to the user's indices directory.*/
 const QDir &getUserIndexDir();
 
+/**
+  \returns the system-wide directory of prebuilt search indices, i.e.
+           share/bibletime/indices in the installation prefix, if it exists.
+  \note The directory is read-only for BibleTime, administrators can copy the
+        indices built by BibleTime there to share them with every user.
+*/
+std::optional<QDir> const & getSharedIndexDir();
+
+/**
+  \returns the system-wide directory of prebuilt caches, i.e.
+           share/bibletime/cache in the installation prefix, if it exists.
+  \note The directory is read-only for BibleTime, administrators can copy the
+        memory-mapped caches from the user's cache directory there, e.g. the
+        lexicon keys and the headword index. The processes of all users then
+        map the same pages of these files instead of building their own.
+*/
+std::optional<QDir> const & getSharedCacheDir();
+
 /** Return the path to the user's custom display templates directory.*/
 const QDir &getUserDisplayTemplatesDir();
 
@@ -0,0 +1,181 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "utf8.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace {
+
+constexpr char32_t const replacementCharacter = 0xfffdu;
+
+constexpr bool isContinuation(unsigned char const c) noexcept
+{ return (c & 0xc0u) == 0x80u; }
+
+/**
+  \brief Decodes the non-ASCII UTF-8 sequence at the given position.
+  \returns the code point and advances the position, to the next byte only if
+           the sequence is invalid.
+*/
+char32_t decode(unsigned char const * & p,
+                unsigned char const * const end) noexcept
+{
+    auto const c = *p;
+    std::size_t length;
+    char32_t cp;
+    char32_t min;
+    if (c >= 0xc2u && c < 0xe0u) {
+        length = 2u;
+        cp = c & 0x1fu;
+        min = 0x80u;
+    } else if (c >= 0xe0u && c < 0xf0u) {
+        length = 3u;
+        cp = c & 0x0fu;
+        min = 0x800u;
+    } else if (c >= 0xf0u && c < 0xf5u) {
+        length = 4u;
+        cp = c & 0x07u;
+        min = 0x10000u;
+    } else {
+        ++p;
+        return replacementCharacter;
+    }
+    if (static_cast<std::size_t>(end - p) < length) {
+        ++p;
+        return replacementCharacter;
+    }
+    for (std::size_t i = 1u; i < length; ++i) {
+        if (!isContinuation(p[i])) {
+            ++p;
+            return replacementCharacter;
+        }
+        cp = (cp << 6u) | (p[i] & 0x3fu);
+    }
+    if (cp < min || cp > 0x10ffffu || (cp >= 0xd800u && cp < 0xe000u)) {
+        ++p;
+        return replacementCharacter;
+    }
+    p += length;
+    return cp;
+}
+
+} // anonymous namespace
+
+namespace util {
+namespace utf8 {
+
+std::size_t toWide(wchar_t * const out,
+                   std::size_t const maxLength,
+                   char const * const in,
+                   std::size_t const size) noexcept
+{
+    auto const * p = reinterpret_cast<unsigned char const *>(in);
+    auto const * const end = p + size;
+    std::size_t n = 0u;
+    while (p < end && n < maxLength) {
+        // Convert ASCII eight bytes at a time while possible:
+        while (end - p >= 8 && maxLength - n >= 8u) {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if (word & 0x8080808080808080u)
+                break;
+            for (std::size_t i = 0u; i < 8u; ++i)
+                out[n + i] = static_cast<wchar_t>(p[i]);
+            p += 8;
+            n += 8u;
+        }
+        if (p >= end || n >= maxLength)
+            break;
+
+        if (*p < 0x80u) {
+            out[n++] = static_cast<wchar_t>(*p++);
+            continue;
+        }
+        auto const * const start = p;
+        auto const cp = decode(p, end);
+        if constexpr (sizeof(wchar_t) == 2u) {
+            if (cp >= 0x10000u) {
+                if (maxLength - n < 2u) {
+                    p = start;
+                    break;
+                }
+                out[n++] = static_cast<wchar_t>(0xd800u
+                                                + ((cp - 0x10000u) >> 10u));
+                out[n++] = static_cast<wchar_t>(0xdc00u
+                                                + ((cp - 0x10000u) & 0x3ffu));
+                continue;
+            }
+        }
+        out[n++] = static_cast<wchar_t>(cp);
+    }
+    out[n] = L'\0';
+    return n;
+}
+
+std::size_t toWide(wchar_t * const out,
+                   std::size_t const maxLength,
+                   char const * const in) noexcept
+{ return toWide(out, maxLength, in, std::strlen(in)); }
+
+std::size_t fromWide(char * const out,
+                     std::size_t const maxSize,
+                     wchar_t const * in) noexcept
+{
+    std::size_t n = 0u;
+    for (; *in; ++in) {
+        auto cp = static_cast<char32_t>(*in);
+        if (cp < 0x80u) {
+            if (n >= maxSize)
+                break;
+            out[n++] = static_cast<char>(cp);
+            continue;
+        }
+        if constexpr (sizeof(wchar_t) == 2u) {
+            if (cp >= 0xd800u && cp < 0xdc00u
+                && in[1] >= 0xdc00u && in[1] < 0xe000u)
+            {
+                ++in;
+                cp = 0x10000u + ((cp - 0xd800u) << 10u)
+                     + (static_cast<char32_t>(*in) - 0xdc00u);
+            }
+        }
+        if (cp > 0x10ffffu || (cp >= 0xd800u && cp < 0xe000u))
+            cp = replacementCharacter;
+
+        unsigned char bytes[4];
+        std::size_t length;
+        if (cp < 0x800u) {
+            bytes[0] = static_cast<unsigned char>(0xc0u | (cp >> 6u));
+            length = 2u;
+        } else if (cp < 0x10000u) {
+            bytes[0] = static_cast<unsigned char>(0xe0u | (cp >> 12u));
+            length = 3u;
+        } else {
+            bytes[0] = static_cast<unsigned char>(0xf0u | (cp >> 18u));
+            length = 4u;
+        }
+        for (std::size_t i = 1u; i < length; ++i)
+            bytes[i] = static_cast<unsigned char>(
+                           0x80u | ((cp >> (6u * (length - 1u - i))) & 0x3fu));
+        if (maxSize - n < length)
+            break;
+        std::memcpy(out + n, bytes, length);
+        n += length;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+} /* namespace utf8 { */
+} /* namespace util { */
@@ -0,0 +1,62 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <cstddef>
+
+
+namespace util {
+namespace utf8 {
+
+/**
+  \brief Converts UTF-8 text to a NUL-terminated wide string, e.g. for CLucene.
+
+  ASCII text, which most of the indexed text consists of, is converted eight
+  bytes at a time. Invalid UTF-8 sequences are replaced with U+FFFD. If
+  wchar_t is 16 bits wide, characters outside of the BMP are converted to
+  surrogate pairs.
+
+  \param[out] out the buffer, which must have room for maxLength + 1 wide
+                  characters.
+  \param[in] maxLength the maximum number of wide characters to write,
+                       excluding the terminating NUL.
+  \param[in] in the UTF-8 text.
+  \param[in] size the size of the UTF-8 text in bytes.
+  \returns the number of wide characters written, excluding the terminating
+           NUL.
+*/
+std::size_t toWide(wchar_t * out,
+                   std::size_t maxLength,
+                   char const * in,
+                   std::size_t size) noexcept;
+
+/** \brief Like toWide(), but for NUL-terminated UTF-8 text. */
+std::size_t toWide(wchar_t * out,
+                   std::size_t maxLength,
+                   char const * in) noexcept;
+
+/**
+  \brief Converts a NUL-terminated wide string to NUL-terminated UTF-8 text.
+  \param[out] out the buffer, which must have room for maxSize + 1 bytes.
+  \param[in] maxSize the maximum number of bytes to write, excluding the
+                     terminating NUL. Characters which do not fit completely
+                     are not written.
+  \param[in] in the wide string.
+  \returns the number of bytes written, excluding the terminating NUL.
+*/
+std::size_t fromWide(char * out,
+                     std::size_t maxSize,
+                     wchar_t const * in) noexcept;
+
+} /* namespace utf8 { */
+} /* namespace util { */
@@ -0,0 +1,203 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#include "zip.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <QByteArray>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QSaveFile>
+#include <zlib.h>
+
+
+namespace {
+
+constexpr std::uint32_t const localHeaderSignature = 0x04034b50u;
+constexpr std::uint32_t const centralHeaderSignature = 0x02014b50u;
+constexpr std::uint32_t const endOfCentralDirSignature = 0x06054b50u;
+constexpr qsizetype const localHeaderSize = 30;
+constexpr qsizetype const centralHeaderSize = 46;
+constexpr qsizetype const endOfCentralDirSize = 22;
+
+class Reader {
+
+public: // methods:
+
+    Reader(QByteArray const & data) noexcept : m_data(data) {}
+
+    bool has(qsizetype const offset, qsizetype const size) const noexcept
+    { return offset >= 0 && size >= 0 && size <= m_data.size() - offset; }
+
+    std::uint16_t u16(qsizetype const offset) const noexcept {
+        return static_cast<std::uint16_t>(byte(offset)
+                                          | (byte(offset + 1) << 8u));
+    }
+
+    std::uint32_t u32(qsizetype const offset) const noexcept {
+        return u16(offset)
+               | (static_cast<std::uint32_t>(u16(offset + 2)) << 16u);
+    }
+
+    char const * data(qsizetype const offset) const noexcept
+    { return m_data.constData() + offset; }
+
+private: // methods:
+
+    unsigned byte(qsizetype const offset) const noexcept
+    { return static_cast<unsigned char>(m_data[offset]); }
+
+private: // fields:
+
+    QByteArray const & m_data;
+
+};
+
+bool inflateRaw(char const * const data,
+                std::uint32_t const size,
+                QByteArray & out)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+    stream.next_in =
+            reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = size;
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    auto const r = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    return r == Z_STREAM_END && stream.avail_out == 0u;
+}
+
+/** \returns the path of an entry relative to the destination, if it is safe. */
+QString entryPath(QString const & name) {
+    auto path(QDir::cleanPath(name));
+    if (path.isEmpty()
+        || QDir::isAbsolutePath(path)
+        || path.contains(':')
+        || path == QStringLiteral("..")
+        || path.startsWith(QStringLiteral("../")))
+        return {};
+    return path;
+}
+
+} // anonymous namespace
+
+namespace util {
+namespace zip {
+
+bool extract(QString const & zipFileName, QString const & destination) {
+    QFile file(zipFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    auto const archive(file.readAll());
+    file.close();
+    Reader const r(archive);
+
+    // Find the end of central directory record, which might have a comment:
+    qsizetype end = archive.size() - endOfCentralDirSize;
+    auto const first = std::max(end - 0xffff, qsizetype(0));
+    for (; end >= first; --end)
+        if (r.u32(end) == endOfCentralDirSignature)
+            break;
+    if (end < first) {
+        qWarning() << "Not a zip archive:" << zipFileName;
+        return false;
+    }
+
+    QDir const destinationDir(destination);
+    auto const numEntries = r.u16(end + 10);
+    qsizetype offset = r.u32(end + 16);
+    for (std::uint16_t i = 0u; i < numEntries; ++i) {
+        if (!r.has(offset, centralHeaderSize)
+            || r.u32(offset) != centralHeaderSignature)
+            return false;
+        auto const method = r.u16(offset + 10);
+        auto const crc = r.u32(offset + 16);
+        auto const compressedSize = r.u32(offset + 20);
+        auto const size = r.u32(offset + 24);
+        auto const nameSize = r.u16(offset + 28);
+        auto const extraSize = r.u16(offset + 30);
+        auto const commentSize = r.u16(offset + 32);
+        qsizetype const localOffset = r.u32(offset + 42);
+        if (!r.has(offset + centralHeaderSize, nameSize))
+            return false;
+        auto const name(QString::fromUtf8(r.data(offset + centralHeaderSize),
+                                          nameSize));
+        offset += centralHeaderSize + nameSize + extraSize + commentSize;
+
+        auto const path(entryPath(name));
+        if (path.isEmpty()) {
+            qWarning() << "Invalid entry" << name << "in" << zipFileName;
+            return false;
+        }
+        if (name.endsWith('/')) {
+            if (!destinationDir.mkpath(path))
+                return false;
+            continue;
+        }
+
+        // ZIP64 archives and encrypted entries are not supported:
+        if (compressedSize == 0xffffffffu || size == 0xffffffffu
+            || !r.has(localOffset, localHeaderSize)
+            || r.u32(localOffset) != localHeaderSignature
+            || (r.u16(localOffset + 6) & 1u))
+            return false;
+        auto const dataOffset = localOffset + localHeaderSize
+                                + r.u16(localOffset + 26)
+                                + r.u16(localOffset + 28);
+        if (!r.has(dataOffset, compressedSize))
+            return false;
+
+        QByteArray content;
+        if (method == 0u) {
+            if (compressedSize != size)
+                return false;
+            content = QByteArray(r.data(dataOffset), size);
+        } else if (method == 8u) {
+            content.resize(size);
+            if (size > 0u
+                && !inflateRaw(r.data(dataOffset), compressedSize, content))
+                return false;
+        } else {
+            return false;
+        }
+        if (crc32(0u,
+                  reinterpret_cast<Bytef const *>(content.constData()),
+                  static_cast<uInt>(content.size())) != crc)
+        {
+            qWarning() << "Corrupt entry" << name << "in" << zipFileName;
+            return false;
+        }
+
+        auto const filePath(destinationDir.filePath(path));
+        if (!destinationDir.mkpath(QFileInfo(path).path()))
+            return false;
+        QSaveFile outFile(filePath);
+        if (!outFile.open(QIODevice::WriteOnly)
+            || outFile.write(content) != content.size()
+            || !outFile.commit())
+        {
+            qWarning() << "Failed to write" << filePath;
+            return false;
+        }
+    }
+    return true;
+}
+
+} /* namespace zip { */
+} /* namespace util { */
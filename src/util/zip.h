@@ -0,0 +1,34 @@
+/*********
+*
+* In the name of the Father, and of the Son, and of the Holy Spirit.
+*
+* This file is part of BibleTime's source code, https://bibletime.info/
+*
+* Copyright 1999-2025 by the BibleTime developers.
+* The BibleTime source code is licensed under the GNU General Public License
+* version 2.0.
+*
+**********/
+
+#pragma once
+
+#include <QString>
+
+
+namespace util {
+namespace zip {
+
+/**
+  \brief Extracts a zip archive, e.g. a module package of a remote source.
+
+  Only stored and deflated entries are supported. Entries with absolute paths
+  or paths leading outside of the destination are rejected.
+
+  \param[in] zipFileName the name of the zip archive.
+  \param[in] destination the directory to extract the archive to.
+  \returns whether all entries were extracted successfully.
+*/
+bool extract(QString const & zipFileName, QString const & destination);
+
+} /* namespace zip { */
+} /* namespace util { */